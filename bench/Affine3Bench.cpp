@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Affine3.hpp"
+
+/*
+ * Cost of scene node transforms held as Affine3 rather than Matrix4:
+ * composing each local transform with its parent's world transform, and
+ * transforming points.
+ */
+
+namespace {
+	const std::size_t Count = 1 << 12;
+	const int Passes = 256;
+	
+	template <typename Transform, typename S>
+	void Kernel(const std::vector<Transform> &locals, const Transform &parent,
+							const std::vector<geom::Point3<S>> &in,
+							std::vector<geom::Point3<S>> &out,
+							double &compose, double &transform)
+	{
+		std::vector<Transform> world(Count);
+		compose = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						world[i] = parent * locals[i];
+					}
+					bench::DoNotOptimize(world[0]);
+				}
+			});
+		transform = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						out[i] = world[i & 63] * in[i];
+					}
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+	}
+	
+	template <typename S>
+	void Run(const char *type) {
+		std::mt19937 gen(42);
+		std::uniform_real_distribution<S> dist(-1, 1);
+		std::vector<geom::Affine3<S>> alocals(Count);
+		std::vector<geom::Matrix4<S>> mlocals(Count);
+		std::vector<geom::Point3<S>> in(Count), out(Count);
+		geom::Affine3<S> aparent;
+		for(int k = 0; k < 12; ++k) {
+			aparent.values[k] = dist(gen);
+		}
+		for(std::size_t i = 0; i < Count; ++i) {
+			for(int k = 0; k < 12; ++k) {
+				alocals[i].values[k] = dist(gen);
+			}
+			mlocals[i] = alocals[i].toMatrix4();
+			in[i] = geom::Point3<S>(dist(gen), dist(gen), dist(gen));
+		}
+		
+		double mcompose, mtransform, acompose, atransform;
+		Kernel(mlocals, aparent.toMatrix4(), in, out, mcompose, mtransform);
+		Kernel(alocals, aparent, in, out, acompose, atransform);
+		const std::size_t items = Count * Passes;
+		std::printf("%s: %u bytes as Matrix4, %u bytes as Affine3\n", type,
+								unsigned(sizeof(geom::Matrix4<S>)),
+								unsigned(sizeof(geom::Affine3<S>)));
+		bench::Report("  Matrix4 * Matrix4", mcompose, items);
+		bench::Report("  Affine3 * Affine3", acompose, items);
+		bench::Report("  Matrix4 * Point3", mtransform, items);
+		bench::Report("  Affine3 * Point3", atransform, items);
+		bench::Speedup("  compose, Affine3 vs Matrix4", mcompose, acompose);
+		bench::Speedup("  transform, Affine3 vs Matrix4", mtransform,
+									 atransform);
+	}
+}
+
+int main() {
+	Run<float>("float");
+	Run<double>("double");
+	return 0;
+}
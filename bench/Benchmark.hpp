@@ -0,0 +1,53 @@
+
+#ifndef GEOM_BENCH_BENCHMARK_HPP
+#define GEOM_BENCH_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace bench {
+	/**
+	 * \brief Keep the compiler from optimizing away the computation of value.
+	 */
+	template <typename T>
+	inline void DoNotOptimize(const T &value) {
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+	
+	/**
+	 * \brief Run f the given number of times and return the fastest run in
+	 * seconds.
+	 */
+	template <typename F>
+	double Time(F f, int repetitions = 5) {
+		double best = 1e300;
+		for(int i = 0; i < repetitions; ++i) {
+			const auto start = std::chrono::steady_clock::now();
+			f();
+			const auto stop = std::chrono::steady_clock::now();
+			best = std::min(best,
+											std::chrono::duration<double>(stop - start).count());
+		}
+		return best;
+	}
+	
+	/**
+	 * \brief Print a result line of the form
+	 *   name                               12.34 ns/item   81.03 Mitems/s
+	 */
+	inline void Report(const char *name, double seconds, std::size_t items) {
+		std::printf("%-44s %9.3f ns/item %10.2f Mitems/s\n", name,
+								seconds * 1e9 / items, items / seconds / 1e6);
+	}
+	
+	/**
+	 * \brief Print the ratio between a baseline and an optimized time.
+	 */
+	inline void Speedup(const char *name, double baseline, double optimized) {
+		std::printf("%-44s %9.2fx\n", name, baseline / optimized);
+	}
+}
+
+#endif
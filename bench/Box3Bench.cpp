@@ -0,0 +1,137 @@
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Box3.hpp"
+
+/*
+ * Throughput of ray-box slab tests as a bounding volume hierarchy traversal
+ * performs them: a scalar slab test with early exits, the common form in
+ * ray tracers, against the batch kernels testing one ray against the 8
+ * children of a node held as corner arrays, and a packet of 64 rays against
+ * one box. About a tenth of the pairs hit.
+ */
+
+namespace {
+	const std::size_t Boxes = 1 << 12;
+	const std::size_t Rays = 64;
+	const int Passes = 16;
+
+	/* The ray with the inverses of its direction computed once */
+	template <typename S>
+	struct NaiveRay {
+		S o[3], inv[3];
+	};
+
+	template <typename S>
+	bool NaiveIntersect(const NaiveRay<S> &ray, const geom::Box3<S> &box,
+											S tMax, S &t)
+	{
+		const S lo[3] = { box.min.x, box.min.y, box.min.z };
+		const S hi[3] = { box.max.x, box.max.y, box.max.z };
+		S enter = 0, exit = tMax;
+		for(int k = 0; k < 3; ++k) {
+			S t0 = (lo[k] - ray.o[k]) * ray.inv[k];
+			S t1 = (hi[k] - ray.o[k]) * ray.inv[k];
+			if(t0 > t1) {
+				std::swap(t0, t1);
+			}
+			enter = t0 > enter ? t0 : enter;
+			exit = t1 < exit ? t1 : exit;
+			if(enter > exit) {
+				return false;
+			}
+		}
+		t = enter;
+		return true;
+	}
+
+	template <typename S>
+	void Run(const char *name) {
+		std::mt19937 gen(5);
+		std::uniform_real_distribution<S> position(-10, 10), size(0, 8);
+		std::vector<geom::Box3<S>> boxes(Boxes);
+		geom::Point3SoA<S> mins, maxs;
+		for(std::size_t i = 0; i < Boxes; ++i) {
+			const geom::Point3<S> o(position(gen) / 2 - 4, position(gen) / 2 - 4,
+															position(gen));
+			boxes[i] = geom::Box3<S>(
+				o, geom::Dimensions3<S>(size(gen), size(gen), size(gen)));
+			mins.push_back(boxes[i].min);
+			maxs.push_back(boxes[i].max);
+		}
+		std::vector<geom::Ray3<S>> rays(Rays);
+		std::vector<NaiveRay<S>> naiveRays(Rays);
+		geom::Point3SoA<S> origins;
+		geom::Vector3SoA<S> directions;
+		for(std::size_t i = 0; i < Rays; ++i) {
+			rays[i] = geom::Ray3<S>(
+				geom::Point3<S>(position(gen) / 2, position(gen) / 2, -20),
+				geom::Vector3<S>(position(gen) / 100, position(gen) / 100, 1));
+			const NaiveRay<S> n = {
+				{ rays[i].origin.x, rays[i].origin.y, rays[i].origin.z },
+				{ 1 / rays[i].direction.x, 1 / rays[i].direction.y,
+					1 / rays[i].direction.z }
+			};
+			naiveRays[i] = n;
+			origins.push_back(rays[i].origin);
+			directions.push_back(rays[i].direction);
+		}
+		const S tMax = 100;
+		const std::vector<S> tMaxs(Rays, tMax);
+		std::vector<S> t(Boxes);
+		std::vector<std::uint32_t> hits(Boxes / 32);
+
+		std::size_t hitCount = 0;
+		const double naive = bench::Time([&]() {
+				hitCount = 0;
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t r = 0; r < Rays; ++r) {
+						for(std::size_t i = 0; i < Boxes; ++i) {
+							hitCount += NaiveIntersect(naiveRays[r], boxes[i], tMax, t[i]);
+						}
+					}
+					bench::DoNotOptimize(t[0]);
+				}
+			});
+		const double nodes = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t r = 0; r < Rays; ++r) {
+						for(std::size_t i = 0; i < Boxes; i += 8) {
+							intersect(rays[r], mins.span().subspan(i, 8),
+												maxs.span().subspan(i, 8), tMax, &t[i],
+												&hits[i / 32]);
+						}
+					}
+					bench::DoNotOptimize(hits[0]);
+				}
+			});
+		const double packets = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Boxes; ++i) {
+						intersect(origins.span(), directions.span(), boxes[i],
+											tMaxs.data(), &t[0], &hits[0]);
+					}
+					bench::DoNotOptimize(hits[0]);
+				}
+			});
+		const std::size_t pairs = Boxes * Rays * Passes;
+		std::printf("%s (%.0f%% hit)\n", name,
+								100.0 * hitCount / (Boxes * Rays * Passes));
+		bench::Report("  scalar slab", naive, pairs);
+		bench::Report("  ray vs 8 boxes", nodes, pairs);
+		bench::Report("  64 rays vs box", packets, pairs);
+		bench::Speedup("  node speedup", naive, nodes);
+		bench::Speedup("  packet speedup", naive, packets);
+	}
+}
+
+int main() {
+	Run<float>("float");
+	Run<double>("double");
+	return 0;
+}
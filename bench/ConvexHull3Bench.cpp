@@ -0,0 +1,87 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/ConvexHull3.hpp"
+
+/*
+ * Convex hulls of a million random points in a cube and in a ball, whose
+ * hulls have a few hundred and a few thousand vertices, against the target
+ * of 100 ms on one core, and of a collision mesh: 300k vertices of a
+ * bumpy closed surface, most of which are near the hull. Each is timed
+ * serial, on every hardware thread and simplified to 64 vertices.
+ */
+
+namespace {
+	const std::size_t Points = 1000000;
+	const std::size_t Mesh = 300000;
+	
+	template <typename S>
+	void Run(const char *name, const std::vector<geom::Point3<S>> &points) {
+		geom::ConvexHull3<S> hull;
+		const double serial = bench::Time([&]() {
+				geom::convexHull(points.data(), points.size(), hull);
+				bench::DoNotOptimize(hull.edges[0]);
+			});
+		const std::size_t vertices = hull.vertices.size();
+		const double parallel = bench::Time([&]() {
+				geom::convexHull(points.data(), points.size(), hull, 0,
+												 geom::Parallel());
+				bench::DoNotOptimize(hull.edges[0]);
+			});
+		const double simplified = bench::Time([&]() {
+				geom::convexHull(points.data(), points.size(), hull, 64);
+				bench::DoNotOptimize(hull.edges[0]);
+			});
+		std::printf("%s (%zu vertices): %.1f ms serial\n", name, vertices,
+								serial * 1e3);
+		bench::Report("  convexHull", serial, points.size());
+		bench::Report("  convexHull, all threads", parallel, points.size());
+		bench::Report("  convexHull, 64 vertices", simplified, points.size());
+	}
+	
+	template <typename S>
+	std::vector<geom::Point3<S>> Random(std::size_t count, bool ball,
+																			unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<double> dist(-1, 1);
+		std::vector<geom::Point3<S>> points;
+		while(points.size() < count) {
+			const double x = dist(gen), y = dist(gen), z = dist(gen);
+			if(!ball || x * x + y * y + z * z <= 1) {
+				points.push_back(geom::Point3<S>(S(x), S(y), S(z)));
+			}
+		}
+		return points;
+	}
+	
+	/* Vertices of an ellipsoid with bumps, as a scanned part might have */
+	std::vector<geom::Point3f> Surface(std::size_t count) {
+		std::mt19937 gen(7);
+		std::normal_distribution<double> normal(0, 1);
+		std::vector<geom::Point3f> points;
+		while(points.size() < count) {
+			const double x = normal(gen), y = normal(gen), z = normal(gen);
+			const double r = std::sqrt(x * x + y * y + z * z);
+			const double bump = 1 + 0.05 * std::sin(7 * x / r) * std::cos(5 * y / r);
+			points.push_back(geom::Point3f(float(2 * bump * x / r),
+																		 float(bump * y / r),
+																		 float(0.5 * bump * z / r)));
+		}
+		return points;
+	}
+}
+
+int main() {
+	std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+	Run("cube, float", Random<float>(Points, false, 1));
+	Run("cube, double", Random<double>(Points, false, 2));
+	Run("ball, float", Random<float>(Points, true, 3));
+	Run("ball, double", Random<double>(Points, true, 4));
+	Run("mesh, float", Surface(Mesh));
+	return 0;
+}
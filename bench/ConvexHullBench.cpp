@@ -0,0 +1,124 @@
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/ConvexHull.hpp"
+
+/*
+ * Convex hulls of a tile of GPS fixes, ten million points clustered along
+ * tracks, as degrees in double and as the fixed point 1e-7 degree integers
+ * GPS devices report: the textbook monotone chain, sorting every point and
+ * using the naive floating point orientation, against convexHull, whose
+ * filter leaves few points to sort, serial and on every hardware thread.
+ * Points near a circle, most of which the filter must keep, are the worst
+ * case.
+ */
+
+namespace {
+	const std::size_t Fixes = 10000000;
+	const std::size_t Ring = 1000000;
+
+	template <typename S>
+	void NaiveHull(std::vector<geom::Point2<S>> points,
+								 std::vector<geom::Point2<S>> &hull)
+	{
+		std::sort(points.begin(), points.end(),
+							geom::detail::lexicographicLess<S>);
+		const std::size_t n = points.size();
+		hull.resize(2 * n);
+		std::size_t k = 0;
+		const auto turn = [](const geom::Point2<S> &a, const geom::Point2<S> &b,
+												 const geom::Point2<S> &c) {
+			return (double(b.x) - a.x) * (double(c.y) - a.y) -
+				(double(b.y) - a.y) * (double(c.x) - a.x);
+		};
+		for(std::size_t i = 0; i < n; ++i) {
+			while(k >= 2 && turn(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+				--k;
+			}
+			hull[k++] = points[i];
+		}
+		for(std::size_t i = n - 1, lower = k + 1; i-- > 0;) {
+			while(k >= lower && turn(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+				--k;
+			}
+			hull[k++] = points[i];
+		}
+		hull.resize(k - 1);
+	}
+
+	/* Fixes scattered around random tracks crossing a tile of 0.1 degrees */
+	std::vector<geom::Point2d> Tracks(std::size_t count) {
+		std::mt19937 gen(11);
+		std::uniform_real_distribution<double> uniform(0, 1);
+		std::normal_distribution<double> noise(0, 2e-5);
+		std::vector<geom::Point2d> points;
+		while(points.size() < count) {
+			const double x0 = uniform(gen), y0 = uniform(gen);
+			const double x1 = uniform(gen), y1 = uniform(gen);
+			for(int i = 0; i < 10000 && points.size() < count; ++i) {
+				const double t = uniform(gen);
+				points.push_back(geom::Point2d(
+					-97.7 + 0.1 * (x0 + t * (x1 - x0)) + noise(gen),
+					30.2 + 0.1 * (y0 + t * (y1 - y0)) + noise(gen)));
+			}
+		}
+		return points;
+	}
+
+	template <typename S>
+	void Run(const char *name, const std::vector<geom::Point2<S>> &points) {
+		std::vector<geom::Point2<S>> hull;
+		const double naive = bench::Time([&]() {
+				NaiveHull(points, hull);
+				bench::DoNotOptimize(hull[0]);
+			}, 3);
+		const std::size_t naiveSize = hull.size();
+		const double serial = bench::Time([&]() {
+				geom::convexHull(points.data(), points.size(), hull);
+				bench::DoNotOptimize(hull[0]);
+			});
+		const double parallel = bench::Time([&]() {
+				geom::convexHull(points.data(), points.size(), hull,
+												 geom::Parallel());
+				bench::DoNotOptimize(hull[0]);
+			});
+		std::printf("%s (%zu vertices, naive %zu)\n", name, hull.size(),
+								naiveSize);
+		bench::Report("  naive monotone chain", naive, points.size());
+		bench::Report("  convexHull", serial, points.size());
+		bench::Report("  convexHull, all threads", parallel, points.size());
+		bench::Speedup("  serial speedup", naive, serial);
+		bench::Speedup("  parallel speedup", naive, parallel);
+	}
+}
+
+int main() {
+	std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+	const std::vector<geom::Point2d> tracks = Tracks(Fixes);
+	Run("tracks, degrees", tracks);
+	std::vector<geom::Point2i> fixed;
+	for(std::size_t i = 0; i < tracks.size(); ++i) {
+		const long x = std::lround(tracks[i].x * 1e7);
+		const long y = std::lround(tracks[i].y * 1e7);
+		fixed.push_back(geom::Point2i(std::int32_t(x), std::int32_t(y)));
+	}
+	Run("tracks, 1e-7 degrees", fixed);
+	
+	std::mt19937 gen(12);
+	std::uniform_real_distribution<double> angle(0, 6.283185307179586);
+	std::uniform_real_distribution<double> radius(0.999, 1);
+	std::vector<geom::Point2d> ring;
+	for(std::size_t i = 0; i < Ring; ++i) {
+		const double a = angle(gen), r = radius(gen);
+		ring.push_back(geom::Point2d(r * std::cos(a), r * std::sin(a)));
+	}
+	Run("ring", ring);
+	return 0;
+}
@@ -0,0 +1,90 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Delaunay.hpp"
+
+/*
+ * Delaunay triangulations of a million random points and of a million
+ * terrain samples, a jittered grid in scanline order as a survey gives them,
+ * and of an exact grid, whose cocircular cells all reach the exact
+ * predicates, against the target of several million points per second on
+ * one core.
+ * The baseline inserts the points in input order, without the biased
+ * randomized order along a Hilbert curve, which makes each walk long.
+ */
+
+namespace {
+	const std::size_t Points = 1000000;
+	
+	void Run(const char *name, const std::vector<geom::Point2d> &points) {
+		geom::Triangulation2 t;
+		const double ordered = bench::Time([&]() {
+				geom::delaunay(points.data(), points.size(), t);
+				bench::DoNotOptimize(t.halfedges[0]);
+			});
+		std::printf("%s (%zu triangles): %.1f ms\n", name,
+								t.triangles.size() / 3, ordered * 1e3);
+		bench::Report("  delaunay", ordered, points.size());
+		
+		/* The baseline on a tenth of the points, or it takes minutes */
+		const std::size_t n = points.size() / 10;
+		std::vector<std::uint32_t> order(n);
+		for(std::size_t i = 0; i < n; ++i) {
+			order[i] = std::uint32_t(i);
+		}
+		const double input = bench::Time([&]() {
+				geom::detail::DelaunayBuilder<double> builder(points.data(),
+																											order.data(), n);
+				builder.build();
+				builder.output(t);
+				bench::DoNotOptimize(t.halfedges[0]);
+			});
+		bench::Report("  input order, a tenth", input, n);
+	}
+	
+	std::vector<geom::Point2d> Random(std::size_t count) {
+		std::mt19937 gen(1);
+		std::uniform_real_distribution<double> dist(0, 1);
+		std::vector<geom::Point2d> points;
+		for(std::size_t i = 0; i < count; ++i) {
+			const double x = dist(gen);
+			points.push_back(geom::Point2d(x, dist(gen)));
+		}
+		return points;
+	}
+	
+	std::vector<geom::Point2d> Terrain(std::size_t count) {
+		std::mt19937 gen(2);
+		std::uniform_real_distribution<double> jitter(-0.3, 0.3);
+		const std::size_t side = std::size_t(std::sqrt(double(count)));
+		std::vector<geom::Point2d> points;
+		for(std::size_t y = 0; y < side; ++y) {
+			for(std::size_t x = 0; x < side; ++x) {
+				const double dx = jitter(gen);
+				points.push_back(geom::Point2d(x + dx, y + jitter(gen)));
+			}
+		}
+		return points;
+	}
+	
+	std::vector<geom::Point2d> Grid(std::size_t count) {
+		const std::size_t side = std::size_t(std::sqrt(double(count)));
+		std::vector<geom::Point2d> points;
+		for(std::size_t y = 0; y < side; ++y) {
+			for(std::size_t x = 0; x < side; ++x) {
+				points.push_back(geom::Point2d(double(x), double(y)));
+			}
+		}
+		return points;
+	}
+}
+
+int main() {
+	Run("random", Random(Points));
+	Run("terrain", Terrain(Points));
+	Run("grid", Grid(Points));
+	return 0;
+}
@@ -0,0 +1,132 @@
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Frustum.hpp"
+
+/*
+ * Throughput of culling 512K bounding volumes against a frustum: a scalar
+ * loop testing one volume at a time against an array of planes with an early
+ * exit, as renderers commonly do, against the batch kernels on boxes given as
+ * corners and dimensions or as arrays of centers and half extents, and on
+ * spheres. About half of the volumes are visible.
+ */
+
+namespace {
+	const std::size_t Count = 1 << 19;
+	const int Passes = 4;
+
+	template <typename S>
+	geom::Frustum<S> Camera() {
+		const S n = 1, f = 100;
+		const geom::Matrix4<S> projection(1, 0, 0, 0,
+																			0, 1, 0, 0,
+																			0, 0, -(f + n) / (f - n),
+																			-2 * f * n / (f - n),
+																			0, 0, -1, 0);
+		return geom::Frustum<S>(projection);
+	}
+
+	template <typename S>
+	bool NaiveVisible(const geom::Vector4<S> *planes, const geom::Point3<S> &o,
+										const geom::Dimensions3<S> &d)
+	{
+		for(int i = 0; i < 6; ++i) {
+			const geom::Vector4<S> &p = planes[i];
+			/* The corner furthest along the normal */
+			const S x = p.x >= 0 ? o.x + d.width : o.x;
+			const S y = p.y >= 0 ? o.y + d.height : o.y;
+			const S z = p.z >= 0 ? o.z + d.depth : o.z;
+			if(p.x * x + p.y * y + p.z * z + p.w < 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template <typename S>
+	void Run(const char *name) {
+		std::mt19937 gen(3);
+		std::uniform_real_distribution<S> position(-100, 100);
+		std::uniform_real_distribution<S> size(0, 4);
+		const geom::Frustum<S> f = Camera<S>();
+		geom::Vector4<S> planes[6];
+		for(int i = 0; i < 6; ++i) {
+			planes[i] = f.plane(i);
+		}
+		std::vector<geom::Point3<S>> origins(Count);
+		std::vector<geom::Dimensions3<S>> dims(Count);
+		std::vector<S> radii(Count);
+		geom::Point3SoA<S> centers;
+		geom::Vector3SoA<S> extents;
+		for(std::size_t i = 0; i < Count; ++i) {
+			origins[i] = geom::Point3<S>(position(gen) / 2, position(gen) / 2,
+																	 position(gen) / 2 - 50);
+			dims[i] = geom::Dimensions3<S>(size(gen), size(gen), size(gen));
+			const geom::Vector3<S> e(dims[i].width / 2, dims[i].height / 2,
+															 dims[i].depth / 2);
+			centers.push_back(geom::Point3<S>(origins[i].x + e.x,
+																				origins[i].y + e.y,
+																				origins[i].z + e.z));
+			extents.push_back(e);
+			radii[i] = length(e);
+		}
+		std::vector<std::uint32_t> visible(Count / 32);
+
+		const double naive = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t w = 0; w < Count / 32; ++w) {
+						std::uint32_t bits = 0;
+						for(std::size_t k = 0; k < 32; ++k) {
+							const std::size_t i = w * 32 + k;
+							bits |= std::uint32_t(NaiveVisible(planes, origins[i],
+																								 dims[i])) << k;
+						}
+						visible[w] = bits;
+					}
+					bench::DoNotOptimize(visible[0]);
+				}
+			});
+		std::size_t seen = 0;
+		for(std::size_t w = 0; w < Count / 32; ++w) {
+			seen += __builtin_popcount(visible[w]);
+		}
+		const double boxes = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					cullBoxes(f, origins.data(), dims.data(), Count, visible.data());
+					bench::DoNotOptimize(visible[0]);
+				}
+			});
+		const double boxSpans = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					cullBoxes(f, centers.span(), extents.span(), visible.data());
+					bench::DoNotOptimize(visible[0]);
+				}
+			});
+		const double spheres = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					cullSpheres(f, centers.span(), radii.data(), visible.data());
+					bench::DoNotOptimize(visible[0]);
+				}
+			});
+
+		std::printf("%s, %.0f%% visible\n", name, 100.0 * seen / Count);
+		bench::Report("  scalar boxes, early exit", naive, Count * Passes);
+		bench::Report("  cullBoxes, corners and dimensions", boxes,
+									Count * Passes);
+		bench::Report("  cullBoxes, centers and extents", boxSpans,
+									Count * Passes);
+		bench::Report("  cullSpheres, centers and radii", spheres,
+									Count * Passes);
+		bench::Speedup("  corners and dimensions speedup", naive, boxes);
+		bench::Speedup("  centers and extents speedup", naive, boxSpans);
+	}
+}
+
+int main() {
+	Run<float>("float");
+	Run<double>("double");
+	return 0;
+}
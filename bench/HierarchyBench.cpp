@@ -0,0 +1,118 @@
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Hierarchy.hpp"
+
+/*
+ * Throughput of flattening a scene graph of 64K nodes into world transforms:
+ * walking from every node up to its root, as a scene graph without cached
+ * world transforms does, against the one pass flattening and the level by
+ * level flattening on one and on all hardware threads. The nodes are
+ * numbered tree by tree, where each level is scattered over the arrays, and
+ * in breadth first order, where each level is contiguous.
+ */
+
+namespace {
+	const std::size_t Count = 1 << 16;
+	const int Passes = 8;
+
+	/*
+	 * Random recursive trees of 1024 nodes, each node a child of any earlier
+	 * node of its tree, which are wide and about 8 levels deep.
+	 */
+	std::vector<std::int32_t> Parents() {
+		std::mt19937 gen(5);
+		std::vector<std::int32_t> parents(Count);
+		for(std::size_t i = 0; i < Count; ++i) {
+			const std::size_t root = i & ~std::size_t(1023);
+			if(i == root) {
+				parents[i] = -1;
+			} else {
+				std::uniform_int_distribution<std::size_t> dist(root, i - 1);
+				parents[i] = static_cast<std::int32_t>(dist(gen));
+			}
+		}
+		return parents;
+	}
+
+	/* The same trees numbered in breadth first order, one level after another */
+	std::vector<std::int32_t> BreadthFirst(const std::vector<std::int32_t> &p) {
+		const geom::HierarchyLevels levels(p.data(), p.size());
+		std::vector<std::int32_t> number(p.size()), parents(p.size());
+		for(std::size_t k = 0; k < p.size(); ++k) {
+			number[levels.nodes[k]] = static_cast<std::int32_t>(k);
+		}
+		for(std::size_t k = 0; k < p.size(); ++k) {
+			parents[k] = levels.parents[k] < 0 ? -1 : number[levels.parents[k]];
+		}
+		return parents;
+	}
+
+	template <typename S>
+	void Run(const char *name, const std::vector<std::int32_t> &parents) {
+		std::mt19937 gen(6);
+		std::uniform_real_distribution<S> dist(-1, 1);
+		std::vector<geom::Matrix4<S>> local(Count), world(Count);
+		for(std::size_t i = 0; i < Count; ++i) {
+			local[i] = geom::Matrix4<S>::translate(
+				geom::Vector3<S>(dist(gen), dist(gen), dist(gen))) *
+				geom::Matrix4<S>::rotate(dist(gen), geom::Vector3<S>(0, 0, 1));
+		}
+		const geom::HierarchyLevels levels(parents.data(), Count);
+
+		const double walk = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						geom::Matrix4<S> m = local[i];
+						for(std::int32_t p = parents[i]; p >= 0; p = parents[p]) {
+							m = local[p] * m;
+						}
+						world[i] = m;
+					}
+					bench::DoNotOptimize(world[0]);
+				}
+			});
+		const double onePass = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					geom::flattenHierarchy(parents.data(), local.data(), Count,
+																 world.data());
+					bench::DoNotOptimize(world[0]);
+				}
+			});
+		const double serial = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					geom::flattenHierarchy(levels, local.data(), world.data(),
+																 geom::Parallel::serial());
+					bench::DoNotOptimize(world[0]);
+				}
+			});
+		const double threaded = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					geom::flattenHierarchy(levels, local.data(), world.data(),
+																 geom::Parallel(0, 4096));
+					bench::DoNotOptimize(world[0]);
+				}
+			});
+
+		std::printf("%s, %u levels\n", name, unsigned(levels.levels()));
+		bench::Report("  walk to root", walk, Count * Passes);
+		bench::Report("  one pass", onePass, Count * Passes);
+		bench::Report("  by level", serial, Count * Passes);
+		bench::Report("  by level, all threads", threaded, Count * Passes);
+		bench::Speedup("  one pass speedup", walk, onePass);
+		bench::Speedup("  all threads speedup", onePass, threaded);
+	}
+}
+
+int main() {
+	const std::vector<std::int32_t> depthFirst = Parents();
+	const std::vector<std::int32_t> breadthFirst = BreadthFirst(depthFirst);
+	Run<float>("Matrix4f, trees one after another", depthFirst);
+	Run<double>("Matrix4d, trees one after another", depthFirst);
+	Run<float>("Matrix4f, breadth first", breadthFirst);
+	Run<double>("Matrix4d, breadth first", breadthFirst);
+	return 0;
+}
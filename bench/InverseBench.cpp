@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/BatchTransform.hpp"
+
+/*
+ * Cost of inverting the bone matrices of a skeleton: the scalar and SSE
+ * general inverses of Matrix4f against the affine and rigid paths, and the
+ * cost of classifying a matrix first.
+ */
+
+namespace {
+	const std::size_t Count = 1 << 10;
+	const int Passes = 1024;
+}
+
+int main() {
+	std::mt19937 gen(42);
+	std::uniform_real_distribution<float> dist(-1, 1);
+	std::vector<geom::Matrix4f> bones(Count), out(Count);
+	for(std::size_t i = 0; i < Count; ++i) {
+		bones[i] = geom::Matrix4f::translate(geom::Vec3f(dist(gen), dist(gen),
+																										 dist(gen))) *
+			geom::Matrix4f::rotate(3 * dist(gen),
+														 geom::Vec3f(dist(gen), dist(gen), 1));
+	}
+	
+	const double scalar = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				for(std::size_t i = 0; i < Count; ++i) {
+					geom::detail::inverse44<float>(bones[i], out[i]);
+				}
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	const double general = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				geom::inverse(bones.data(), Count, out.data());
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	const double affine = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				geom::inverse(bones.data(), Count, out.data(),
+											geom::MatrixKind::Affine);
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	const double rigid = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				geom::inverse(bones.data(), Count, out.data(),
+											geom::MatrixKind::Rigid);
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	const double detected = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				for(std::size_t i = 0; i < Count; ++i) {
+					out[i] = geom::inverse(bones[i], geom::classify(bones[i]));
+				}
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	
+	const std::size_t items = Count * Passes;
+	bench::Report("scalar general inverse", scalar, items);
+	bench::Report("inverse", general, items);
+	bench::Report("inverseAffine", affine, items);
+	bench::Report("inverseRigid", rigid, items);
+	bench::Report("classify + inverse", detected, items);
+	bench::Speedup("SSE vs scalar general", scalar, general);
+	bench::Speedup("rigid vs SSE general", general, rigid);
+	bench::Speedup("classify + inverse vs SSE general", general, detected);
+	return 0;
+}
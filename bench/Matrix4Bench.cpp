@@ -0,0 +1,111 @@
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Matrix4.hpp"
+
+/*
+ * Throughput of the SIMD Matrix4f/Matrix4d products against the same
+ * products written element by element, as a per-frame transform pipeline
+ * uses them: composing a model matrix with a view-projection matrix and
+ * transforming vertices.
+ */
+
+namespace {
+	template <typename S>
+	struct ScalarMatrix4 {
+		S values[16];
+	};
+	
+	template <typename S>
+	ScalarMatrix4<S> operator*(const ScalarMatrix4<S> &a,
+														 const ScalarMatrix4<S> &b)
+	{
+		ScalarMatrix4<S> r;
+		for(int j = 0; j < 4; ++j) {
+			for(int i = 0; i < 4; ++i) {
+				r.values[j * 4 + i] = a.values[i] * b.values[j * 4] +
+					a.values[4 + i] * b.values[j * 4 + 1] +
+					a.values[8 + i] * b.values[j * 4 + 2] +
+					a.values[12 + i] * b.values[j * 4 + 3];
+			}
+		}
+		return r;
+	}
+	template <typename S>
+	geom::Vector4<S> operator*(const ScalarMatrix4<S> &a,
+														 const geom::Vector4<S> &v)
+	{
+		const S *m = a.values;
+		return geom::Vector4<S>(m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
+														m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
+														m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w,
+														m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w);
+	}
+	
+	const std::size_t Count = 1 << 12;
+	const int Passes = 256;
+	
+	template <typename Matrix, typename S>
+	void Kernel(const std::vector<Matrix> &models, const Matrix &viewProj,
+							const std::vector<geom::Vector4<S>> &in,
+							std::vector<geom::Vector4<S>> &out,
+							double &compose, double &transform)
+	{
+		std::vector<Matrix> mvp(Count);
+		compose = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						mvp[i] = viewProj * models[i];
+					}
+					bench::DoNotOptimize(mvp[0]);
+				}
+			});
+		transform = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						out[i] = mvp[i & 63] * in[i];
+					}
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+	}
+	
+	template <typename S>
+	void Run(const char *type) {
+		std::mt19937 gen(42);
+		std::uniform_real_distribution<S> dist(-1, 1);
+		std::vector<ScalarMatrix4<S>> smodels(Count);
+		std::vector<geom::Matrix4<S>> models(Count);
+		std::vector<geom::Vector4<S>> in(Count), out(Count);
+		ScalarMatrix4<S> sviewProj;
+		geom::Matrix4<S> viewProj;
+		for(int k = 0; k < 16; ++k) {
+			sviewProj.values[k] = viewProj.values[k] = dist(gen);
+		}
+		for(std::size_t i = 0; i < Count; ++i) {
+			for(int k = 0; k < 16; ++k) {
+				smodels[i].values[k] = models[i].values[k] = dist(gen);
+			}
+			in[i] = geom::Vector4<S>(dist(gen), dist(gen), dist(gen), 1);
+		}
+		
+		double scalarCompose, scalarTransform, simdCompose, simdTransform;
+		Kernel(smodels, sviewProj, in, out, scalarCompose, scalarTransform);
+		Kernel(models, viewProj, in, out, simdCompose, simdTransform);
+		std::printf("%s\n", type);
+		bench::Report("  scalar matrix * matrix", scalarCompose, Count * Passes);
+		bench::Report("  geom matrix * matrix", simdCompose, Count * Passes);
+		bench::Report("  scalar matrix * vector", scalarTransform, Count * Passes);
+		bench::Report("  geom matrix * vector", simdTransform, Count * Passes);
+		bench::Speedup("  matrix * matrix speedup", scalarCompose, simdCompose);
+		bench::Speedup("  matrix * vector speedup", scalarTransform,
+									 simdTransform);
+	}
+}
+
+int main() {
+	Run<float>("Matrix4f");
+	Run<double>("Matrix4d");
+	return 0;
+}
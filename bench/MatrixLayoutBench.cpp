@@ -0,0 +1,84 @@
+
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Matrix.hpp"
+
+/*
+ * Throughput of products with a transposed operand, A * transpose(B), which
+ * copies B into its transpose first, against A * transposeView(B), which
+ * reads B in place in row major order. The products of row major matrices
+ * are measured against those of column major ones too.
+ */
+
+namespace {
+	const std::size_t Count = 1 << 9;
+	const int Passes = 2048;
+
+	template <std::size_t N, typename S>
+	std::vector<geom::Matrix<N, N, S>> Random(unsigned seed) {
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<S> dist(-1, 1);
+		std::vector<geom::Matrix<N, N, S>> m(Count);
+		for(std::size_t i = 0; i < Count; ++i) {
+			for(std::size_t k = 0; k < N * N; ++k) {
+				m[i].values[k] = dist(gen);
+			}
+		}
+		return m;
+	}
+
+	template <typename Left, typename Right, typename Out, typename Op>
+	double Product(const std::vector<Left> &a, const std::vector<Right> &b,
+								 std::vector<Out> &out, Op op)
+	{
+		return bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						out[i] = op(a[i], b[i]);
+					}
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+	}
+
+	template <std::size_t N, typename S>
+	void Run(const char *name) {
+		typedef geom::Matrix<N, N, S> Matrix;
+		typedef geom::Matrix<N, N, S, geom::RowMajor> RowMatrix;
+		const std::vector<Matrix> a = Random<N, S>(1), b = Random<N, S>(2);
+		std::vector<Matrix> out(Count);
+		const double copy = Product(a, b, out,
+				[](const Matrix &l, const Matrix &r) { return l * transpose(r); });
+		const double view = Product(a, b, out,
+				[](const Matrix &l, const Matrix &r) {
+					return l * transposeView(r);
+				});
+
+		const std::vector<RowMatrix> ra(a.begin(), a.end());
+		const std::vector<RowMatrix> rb(b.begin(), b.end());
+		std::vector<RowMatrix> rout(Count);
+		const double column = Product(a, b, out,
+				[](const Matrix &l, const Matrix &r) { return l * r; });
+		const double row = Product(ra, rb, rout,
+				[](const RowMatrix &l, const RowMatrix &r) { return l * r; });
+
+		std::printf("%s\n", name);
+		bench::Report("  A * transpose(B)", copy, Count * Passes);
+		bench::Report("  A * transposeView(B)", view, Count * Passes);
+		bench::Report("  column major A * B", column, Count * Passes);
+		bench::Report("  row major A * B", row, Count * Passes);
+		bench::Speedup("  view speedup", copy, view);
+		bench::Speedup("  row major speedup", column, row);
+	}
+}
+
+int main() {
+	Run<4, float>("Matrix4f");
+	Run<4, double>("Matrix4d");
+	Run<3, float>("Matrix3f");
+	Run<3, double>("Matrix3d");
+	Run<2, float>("Matrix2f");
+	return 0;
+}
@@ -0,0 +1,164 @@
+
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Matrix.hpp"
+
+/*
+ * Throughput of the unrolled products and transforms of geom::Matrix against
+ * the same operations written as loops over the rows and columns, as the
+ * Matrix2 and Matrix3 operators were, for square and non-square sizes.
+ */
+
+namespace {
+	template <std::size_t R, std::size_t C, typename S>
+	struct LoopMatrix {
+		S values[R * C];
+	};
+
+	template <std::size_t R, std::size_t K, std::size_t C, typename S>
+	LoopMatrix<R, C, S> operator*(const LoopMatrix<R, K, S> &a,
+																const LoopMatrix<K, C, S> &b)
+	{
+		LoopMatrix<R, C, S> r;
+		for(std::size_t j = 0; j < C; ++j) {
+			for(std::size_t i = 0; i < R; ++i) {
+				S sum = a.values[i] * b.values[j * K];
+				for(std::size_t k = 1; k < K; ++k) {
+					sum += a.values[k * R + i] * b.values[j * K + k];
+				}
+				r.values[j * R + i] = sum;
+			}
+		}
+		return r;
+	}
+	template <std::size_t R, std::size_t C, typename S>
+	LoopMatrix<C, R, S> transpose(const LoopMatrix<R, C, S> &m) {
+		LoopMatrix<C, R, S> r;
+		for(std::size_t j = 0; j < C; ++j) {
+			for(std::size_t i = 0; i < R; ++i) {
+				r.values[i * C + j] = m.values[j * R + i];
+			}
+		}
+		return r;
+	}
+
+	const std::size_t Count = 1 << 12;
+	const int Passes = 256;
+
+	template <typename Left, typename Right, typename Out>
+	double Product(const std::vector<Left> &a, const Right &b,
+								 std::vector<Out> &out)
+	{
+		return bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						out[i] = a[i] * b;
+					}
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+	}
+	template <typename Matrix, typename Out>
+	double Transpose(const std::vector<Matrix> &a, std::vector<Out> &out) {
+		return bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						out[i] = transpose(a[i]);
+					}
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+	}
+
+	template <std::size_t R, std::size_t K, std::size_t C, typename S>
+	void Run(const char *name) {
+		std::mt19937 gen(42);
+		std::uniform_real_distribution<S> dist(-1, 1);
+		std::vector<LoopMatrix<R, K, S>> la(Count);
+		std::vector<geom::Matrix<R, K, S>> ga(Count);
+		LoopMatrix<K, C, S> lb;
+		geom::Matrix<K, C, S> gb;
+		for(std::size_t i = 0; i < Count; ++i) {
+			for(std::size_t k = 0; k < R * K; ++k) {
+				la[i].values[k] = ga[i].values[k] = dist(gen);
+			}
+		}
+		for(std::size_t k = 0; k < K * C; ++k) {
+			lb.values[k] = gb.values[k] = dist(gen);
+		}
+
+		std::vector<LoopMatrix<R, C, S>> lout(Count);
+		std::vector<geom::Matrix<R, C, S>> gout(Count);
+		std::vector<LoopMatrix<K, R, S>> ltout(Count);
+		std::vector<geom::Matrix<K, R, S>> gtout(Count);
+		const double loopProduct = Product(la, lb, lout);
+		const double unrolledProduct = Product(ga, gb, gout);
+		const double loopTranspose = Transpose(la, ltout);
+		const double unrolledTranspose = Transpose(ga, gtout);
+		std::printf("%s\n", name);
+		bench::Report("  loop product", loopProduct, Count * Passes);
+		bench::Report("  unrolled product", unrolledProduct, Count * Passes);
+		bench::Report("  loop transpose", loopTranspose, Count * Passes);
+		bench::Report("  unrolled transpose", unrolledTranspose, Count * Passes);
+		bench::Speedup("  product speedup", loopProduct, unrolledProduct);
+		bench::Speedup("  transpose speedup", loopTranspose, unrolledTranspose);
+	}
+
+	/* Affine transformation of points by a 3x4 matrix */
+	template <typename S>
+	void RunTransform(const char *name) {
+		std::mt19937 gen(7);
+		std::uniform_real_distribution<S> dist(-1, 1);
+		LoopMatrix<3, 4, S> lm;
+		geom::Matrix3x4<S> gm;
+		for(std::size_t k = 0; k < 12; ++k) {
+			lm.values[k] = gm.values[k] = dist(gen);
+		}
+		std::vector<geom::Point3<S>> in(Count), out(Count);
+		for(std::size_t i = 0; i < Count; ++i) {
+			in[i] = geom::Point3<S>(dist(gen), dist(gen), dist(gen));
+		}
+		const double loop = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						const S p[4] = { in[i].x, in[i].y, in[i].z, 1 };
+						S r[3];
+						for(std::size_t j = 0; j < 3; ++j) {
+							r[j] = lm.values[j] * p[0];
+							for(std::size_t k = 1; k < 4; ++k) {
+								r[j] += lm.values[k * 3 + j] * p[k];
+							}
+						}
+						out[i] = geom::Point3<S>(r[0], r[1], r[2]);
+					}
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+		const double unrolled = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						out[i] = gm * in[i];
+					}
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+		std::printf("%s\n", name);
+		bench::Report("  loop transform", loop, Count * Passes);
+		bench::Report("  unrolled transform", unrolled, Count * Passes);
+		bench::Speedup("  transform speedup", loop, unrolled);
+	}
+}
+
+int main() {
+	Run<2, 2, 2, float>("Matrix2f * Matrix2f");
+	Run<3, 3, 3, float>("Matrix3f * Matrix3f");
+	Run<3, 3, 3, double>("Matrix3d * Matrix3d");
+	Run<2, 3, 3, float>("Matrix2x3f * Matrix3f");
+	Run<3, 4, 4, float>("Matrix3x4f * Matrix4f");
+	Run<4, 3, 4, double>("Matrix4x3d * Matrix3x4d");
+	RunTransform<float>("Matrix3x4f * Point3f");
+	RunTransform<double>("Matrix3x4d * Point3d");
+	return 0;
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Vector3SoA.hpp"
+
+/*
+ * Throughput of the exact and the reciprocal square root normalize for Vec3f,
+ * one vector at a time and as SoA batches, along with the worst component
+ * error of the fast path against the exact one.
+ */
+
+namespace {
+	typedef geom::Vec3f V;
+	
+	const std::size_t Count = 1 << 14;
+	const int Passes = 256;
+}
+
+int main() {
+	std::mt19937 gen(42);
+	std::uniform_real_distribution<float> dist(-10, 10);
+	std::vector<V> in(Count), out(Count);
+	for(std::size_t i = 0; i < Count; ++i) {
+		in[i] = V(dist(gen), dist(gen), dist(gen));
+	}
+	geom::Vec3SoAf sin(in.data(), Count), sout(Count);
+	
+	const double exact = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				for(std::size_t i = 0; i < Count; ++i) {
+					out[i] = geom::normalize(in[i]);
+				}
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	const double fast = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				for(std::size_t i = 0; i < Count; ++i) {
+					out[i] = geom::normalizeFast(in[i]);
+				}
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	const double batchExact = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				geom::normalize(sin.span(), sout.span());
+				bench::DoNotOptimize(sout.x[0]);
+			}
+		});
+	const double batchFast = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				geom::normalizeFast(sin.span(), sout.span());
+				bench::DoNotOptimize(sout.x[0]);
+			}
+		});
+	
+	float worst = 0;
+	for(std::size_t i = 0; i < Count; ++i) {
+		const V e = geom::normalize(in[i]);
+		worst = std::max(worst, std::fabs(sout.x[i] - e.x));
+		worst = std::max(worst, std::fabs(sout.y[i] - e.y));
+		worst = std::max(worst, std::fabs(sout.z[i] - e.z));
+	}
+	
+	const std::size_t items = Count * Passes;
+	bench::Report("normalize", exact, items);
+	bench::Report("normalizeFast", fast, items);
+	bench::Report("normalize, SoA batch", batchExact, items);
+	bench::Report("normalizeFast, SoA batch", batchFast, items);
+	bench::Speedup("normalizeFast vs normalize", exact, fast);
+	bench::Speedup("SoA batch fast vs normalize", exact, batchFast);
+	std::printf("worst component error %g\n", worst);
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Polygon2.hpp"
+
+/*
+ * Triangulations of a million building footprints of 4 to 16 vertices,
+ * by the ear clipper and by the monotone decomposition, and their areas;
+ * then of a large outline of 100k vertices with a hundred holes, which
+ * only the monotone decomposition takes.
+ */
+
+namespace {
+	const std::size_t Footprints = 1000000;
+	const std::size_t Outline = 100000;
+	
+	/* A star-shaped outline around (x, y), counterclockwise */
+	void Star(std::mt19937 &gen, std::size_t count, double x, double y,
+						double radius, std::vector<geom::Point2d> &points)
+	{
+		std::uniform_real_distribution<double> dist(0.5, 1);
+		for(std::size_t i = 0; i < count; ++i) {
+			const double a = 2 * M_PI * double(i) / double(count);
+			const double r = radius * dist(gen);
+			points.push_back(geom::Point2d(x + r * std::cos(a),
+																		 y + r * std::sin(a)));
+		}
+	}
+	
+	void Footprint() {
+		std::mt19937 gen(1);
+		std::uniform_int_distribution<std::uint32_t> size(4, 16);
+		std::vector<geom::Point2d> points;
+		std::vector<std::uint32_t> offsets(1, 0);
+		for(std::size_t i = 0; i < Footprints; ++i) {
+			Star(gen, size(gen), double(i % 1000) * 30, double(i / 1000) * 30, 10,
+					 points);
+			offsets.push_back(std::uint32_t(points.size()));
+		}
+		
+		std::vector<std::uint32_t> triangles;
+		std::size_t count = 0;
+		const double ear = bench::Time([&]() {
+				count = 0;
+				for(std::size_t i = 0; i < Footprints; ++i) {
+					geom::triangulate(&points[offsets[i]], offsets[i + 1] - offsets[i],
+														triangles);
+					count += triangles.size() / 3;
+				}
+				bench::DoNotOptimize(count);
+			});
+		std::printf("footprints (%zu triangles): %.1f ms\n", count, ear * 1e3);
+		bench::Report("  triangulate", ear, Footprints);
+		
+		const double monotone = bench::Time([&]() {
+				count = 0;
+				for(std::size_t i = 0; i < Footprints; ++i) {
+					const std::uint32_t ring[] = { 0, offsets[i + 1] - offsets[i] };
+					geom::detail::MonotoneTriangulator<double> t(&points[offsets[i]],
+																											 ring, 1);
+					triangles.clear();
+					t.run(triangles);
+					count += triangles.size() / 3;
+				}
+				bench::DoNotOptimize(count);
+			});
+		bench::Report("  monotone decomposition", monotone, Footprints);
+		
+		double total = 0;
+		const double area = bench::Time([&]() {
+				total = 0;
+				for(std::size_t i = 0; i < Footprints; ++i) {
+					total += geom::detail::ringArea(&points[offsets[i]],
+																					offsets[i + 1] - offsets[i]);
+				}
+				bench::DoNotOptimize(total);
+			});
+		bench::Report("  area", area, Footprints);
+	}
+	
+	void Large() {
+		std::mt19937 gen(2);
+		std::vector<geom::Point2d> points;
+		Star(gen, Outline, 0, 0, 1000, points);
+		geom::Polygon2d polygon(points.data(), points.size());
+		for(int i = 0; i < 100; ++i) {
+			points.clear();
+			Star(gen, 100, (i % 10 - 4.5) * 60, (i / 10 - 4.5) * 60, 20, points);
+			std::reverse(points.begin(), points.end());
+			polygon.addHole(points.data(), points.size());
+		}
+		std::vector<std::uint32_t> triangles;
+		const double seconds = bench::Time([&]() {
+				geom::triangulate(polygon, triangles);
+				bench::DoNotOptimize(triangles[0]);
+			});
+		std::printf("outline with holes (%zu triangles): %.1f ms\n",
+								triangles.size() / 3, seconds * 1e3);
+		bench::Report("  triangulate", seconds, polygon.vertices.size());
+	}
+}
+
+int main() {
+	Footprint();
+	Large();
+	return 0;
+}
@@ -0,0 +1,161 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/PolygonGrid2.hpp"
+#include "geom/Voronoi.hpp"
+
+/*
+ * Point location in a map of a thousand regions, the Voronoi cells of
+ * random sites with each side cut into 50 edges and the plane warped so
+ * that the boundaries wind like administrative ones, 300k edges in all.
+ * A million random points are located by the grid, one at a time and as
+ * a batch, and by the naive crossing-number test of every polygon, with
+ * and without a check of the bounds of each polygon first.
+ */
+
+namespace {
+	const std::size_t Regions = 1000;
+	const std::size_t Pieces = 50;
+	const std::size_t Points = 1000000;
+	const double Side = 1000;
+	
+	geom::Point2d Warp(double x, double y) {
+		return geom::Point2d(x + 2 * std::sin(0.3 * y + std::sin(0.2 * x)),
+												 y + 2 * std::sin(0.25 * x + std::sin(0.3 * y)));
+	}
+	
+	std::vector<geom::Polygon2d> Map() {
+		std::mt19937 gen(1);
+		std::uniform_real_distribution<double> dist(0, Side);
+		std::vector<geom::Point2d> sites;
+		for(std::size_t i = 0; i < Regions; ++i) {
+			const double x = dist(gen);
+			sites.push_back(geom::Point2d(x, dist(gen)));
+		}
+		geom::Voronoi2<double> v;
+		geom::voronoi(sites.data(), sites.size(),
+									geom::Rectangle2d(0, 0, Side, Side), v);
+		
+		/* Cut each side from its lesser end, so that neighbours agree */
+		std::vector<geom::Polygon2d> map(Regions);
+		std::vector<geom::Point2d> ring;
+		for(std::size_t i = 0; i < Regions; ++i) {
+			ring.clear();
+			const std::uint32_t first = v.offsets[i], last = v.offsets[i + 1];
+			for(std::uint32_t k = first; k < last; ++k) {
+				geom::Point2d a = v.vertices[k];
+				geom::Point2d b = v.vertices[k + 1 < last ? k + 1 : first];
+				const bool flip = b.x < a.x || (b.x == a.x && b.y < a.y);
+				if(flip) {
+					std::swap(a, b);
+				}
+				for(std::size_t j = 0; j < Pieces; ++j) {
+					const double t = double(flip ? Pieces - j : j) / Pieces;
+					ring.push_back(Warp(a.x + t * (b.x - a.x),
+															a.y + t * (b.y - a.y)));
+				}
+			}
+			map[i].assign(ring.data(), ring.size());
+		}
+		return map;
+	}
+	
+	std::uint32_t Naive(const std::vector<geom::Polygon2d> &map,
+											const geom::Point2d &p)
+	{
+		for(std::size_t i = 0; i < map.size(); ++i) {
+			if(geom::contains(map[i], p)) {
+				return std::uint32_t(i);
+			}
+		}
+		return geom::PolygonGrid2d::None;
+	}
+}
+
+int main() {
+	const std::vector<geom::Polygon2d> map = Map();
+	std::size_t edges = 0;
+	for(std::size_t i = 0; i < map.size(); ++i) {
+		edges += map[i].vertices.size();
+	}
+	std::mt19937 gen(2);
+	std::uniform_real_distribution<double> dist(0, Side);
+	std::vector<geom::Point2d> points;
+	for(std::size_t i = 0; i < Points; ++i) {
+		const double x = dist(gen);
+		points.push_back(geom::Point2d(x, dist(gen)));
+	}
+	std::vector<std::uint32_t> ids(Points);
+	std::printf("%zu regions, %zu edges, %u hardware threads\n", map.size(),
+							edges, std::thread::hardware_concurrency());
+	
+	geom::PolygonGrid2d grid;
+	const std::size_t sizes[] = { edges / 4, edges, edges * 4 };
+	for(std::size_t s = 0; s < 3; ++s) {
+		const double build = bench::Time([&]() {
+				geom::polygonGrid(map.data(), map.size(), grid, sizes[s]);
+				bench::DoNotOptimize(grid.cells[0]);
+			});
+		std::printf("%u x %u cells, %.2f edges per cell: %.1f ms to build\n",
+								grid.columns, grid.rows,
+								double(grid.edges.size()) / (grid.cells.size() - 1),
+								build * 1e3);
+		const double single = bench::Time([&]() {
+				for(std::size_t i = 0; i < Points; ++i) {
+					ids[i] = geom::locate(grid, points[i]);
+				}
+				bench::DoNotOptimize(ids[0]);
+			});
+		bench::Report("  locate", single, Points);
+		const double batch = bench::Time([&]() {
+				geom::locate(grid, points.data(), Points, ids.data(),
+										 geom::Parallel());
+				bench::DoNotOptimize(ids[0]);
+			});
+		bench::Report("  locate batch, all threads", batch, Points);
+	}
+	
+	/* The naive tests on fewer points, or they take minutes */
+	const std::size_t n = Points / 1000;
+	const double naive = bench::Time([&]() {
+			for(std::size_t i = 0; i < n; ++i) {
+				ids[i] = Naive(map, points[i]);
+			}
+			bench::DoNotOptimize(ids[0]);
+		});
+	bench::Report("naive crossing number, a thousandth", naive, n);
+	
+	std::vector<geom::Point2d> lower(map.size()), upper(map.size());
+	for(std::size_t i = 0; i < map.size(); ++i) {
+		lower[i] = upper[i] = map[i].vertices[0];
+		for(std::size_t k = 0; k < map[i].vertices.size(); ++k) {
+			const geom::Point2d &p = map[i].vertices[k];
+			lower[i].x = std::min(lower[i].x, p.x);
+			lower[i].y = std::min(lower[i].y, p.y);
+			upper[i].x = std::max(upper[i].x, p.x);
+			upper[i].y = std::max(upper[i].y, p.y);
+		}
+	}
+	const std::size_t m = Points / 10;
+	const double bounded = bench::Time([&]() {
+			for(std::size_t i = 0; i < m; ++i) {
+				const geom::Point2d &p = points[i];
+				ids[i] = geom::PolygonGrid2d::None;
+				for(std::size_t k = 0; k < map.size(); ++k) {
+					if(p.x >= lower[k].x && p.x < upper[k].x && p.y >= lower[k].y &&
+						 p.y < upper[k].y && geom::contains(map[k], p))
+					{
+						ids[i] = std::uint32_t(k);
+						break;
+					}
+				}
+			}
+			bench::DoNotOptimize(ids[0]);
+		});
+	bench::Report("naive with bounds first, a tenth", bounded, m);
+	return 0;
+}
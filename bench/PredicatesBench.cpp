@@ -0,0 +1,189 @@
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Predicates.hpp"
+
+/*
+ * Cost of the adaptive predicates against the naive determinants they
+ * guard, on random points where the filter always succeeds, and on nearly
+ * degenerate points where it fails and the exact evaluation runs: points
+ * rounded onto a line, a plane, a circle and a sphere.
+ */
+
+namespace {
+	const std::size_t Count = 1 << 14;
+	const int Passes = 64;
+
+	double NaiveOrient2d(const geom::Point2d &a, const geom::Point2d &b,
+											 const geom::Point2d &c)
+	{
+		return (a.x - c.x) * (b.y - c.y) - (a.y - c.y) * (b.x - c.x);
+	}
+	double NaiveOrient3d(const geom::Point3d &a, const geom::Point3d &b,
+											 const geom::Point3d &c, const geom::Point3d &d)
+	{
+		const double adx = a.x - d.x, ady = a.y - d.y, adz = a.z - d.z;
+		const double bdx = b.x - d.x, bdy = b.y - d.y, bdz = b.z - d.z;
+		const double cdx = c.x - d.x, cdy = c.y - d.y, cdz = c.z - d.z;
+		return adz * (bdx * cdy - cdx * bdy) + bdz * (cdx * ady - adx * cdy) +
+			cdz * (adx * bdy - bdx * ady);
+	}
+	double NaiveIncircle(const geom::Point2d &a, const geom::Point2d &b,
+											 const geom::Point2d &c, const geom::Point2d &d)
+	{
+		const double adx = a.x - d.x, ady = a.y - d.y;
+		const double bdx = b.x - d.x, bdy = b.y - d.y;
+		const double cdx = c.x - d.x, cdy = c.y - d.y;
+		return (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy) +
+			(bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy) +
+			(cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+	}
+	double NaiveInsphere(const geom::Point3d &a, const geom::Point3d &b,
+											 const geom::Point3d &c, const geom::Point3d &d,
+											 const geom::Point3d &e)
+	{
+		const double aex = a.x - e.x, aey = a.y - e.y, aez = a.z - e.z;
+		const double bex = b.x - e.x, bey = b.y - e.y, bez = b.z - e.z;
+		const double cex = c.x - e.x, cey = c.y - e.y, cez = c.z - e.z;
+		const double dex = d.x - e.x, dey = d.y - e.y, dez = d.z - e.z;
+		const double ab = aex * bey - bex * aey, bc = bex * cey - cex * bey;
+		const double cd = cex * dey - dex * cey, da = dex * aey - aex * dey;
+		const double ac = aex * cey - cex * aey, bd = bex * dey - dex * bey;
+		const double abc = aez * bc - bez * ac + cez * ab;
+		const double bcd = bez * cd - cez * bd + dez * bc;
+		const double cda = cez * da + dez * ac + aez * cd;
+		const double dab = dez * ab + aez * bd + bez * da;
+		return ((dex * dex + dey * dey + dez * dez) * abc -
+						(cex * cex + cey * cey + cez * cez) * dab) +
+			((bex * bex + bey * bey + bez * bez) * cda -
+			 (aex * aex + aey * aey + aez * aez) * bcd);
+	}
+
+	/*
+	 * Time the naive and adaptive determinants over the point sets, and
+	 * count the naive results with the wrong sign.
+	 */
+	template <typename F, typename G>
+	void Compare(F naive, G adaptive) {
+		std::vector<double> out(Count);
+		const double n = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						out[i] = naive(i);
+					}
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+		const double a = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						out[i] = adaptive(i);
+					}
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+		std::size_t wrong = 0;
+		for(std::size_t i = 0; i < Count; ++i) {
+			const double x = naive(i), y = adaptive(i);
+			wrong += (x > 0) != (y > 0) || (x < 0) != (y < 0);
+		}
+		std::printf("  naive sign wrong for %zu of %zu\n", wrong, Count);
+		bench::Report("  naive", n, Count * Passes);
+		bench::Report("  adaptive", a, Count * Passes);
+		bench::Speedup("  relative cost", a, n);
+	}
+
+	typedef std::vector<geom::Point2d> Points2;
+	typedef std::vector<geom::Point3d> Points3;
+
+	/* Random points, and points within an ulp of a line or plane */
+	void Orient(bool degenerate) {
+		std::mt19937_64 gen(5);
+		std::uniform_real_distribution<double> dist(0, 1);
+		Points2 a(Count), b(Count), c(Count);
+		Points3 p(Count), q(Count), r(Count), s(Count);
+		for(std::size_t i = 0; i < Count; ++i) {
+			a[i] = geom::Point2d(dist(gen), dist(gen));
+			b[i] = geom::Point2d(dist(gen), dist(gen));
+			const double t = dist(gen);
+			c[i] = degenerate ?
+				geom::Point2d(a[i].x + t * (b[i].x - a[i].x),
+											a[i].y + t * (b[i].y - a[i].y)) :
+				geom::Point2d(dist(gen), dist(gen));
+			p[i] = geom::Point3d(dist(gen), dist(gen), dist(gen));
+			q[i] = geom::Point3d(dist(gen), dist(gen), dist(gen));
+			r[i] = geom::Point3d(dist(gen), dist(gen), dist(gen));
+			const double u = dist(gen), v = dist(gen);
+			s[i] = degenerate ?
+				geom::Point3d(p[i].x + u * (q[i].x - p[i].x) + v * (r[i].x - p[i].x),
+											p[i].y + u * (q[i].y - p[i].y) + v * (r[i].y - p[i].y),
+											p[i].z + u * (q[i].z - p[i].z) + v * (r[i].z - p[i].z)) :
+				geom::Point3d(dist(gen), dist(gen), dist(gen));
+		}
+		const char *suffix = degenerate ? ", nearly degenerate" : ", random";
+		std::printf("orient2d%s\n", suffix);
+		Compare([&](std::size_t i) { return NaiveOrient2d(a[i], b[i], c[i]); },
+						[&](std::size_t i) { return orient2d(a[i], b[i], c[i]); });
+		std::printf("orient3d%s\n", suffix);
+		Compare([&](std::size_t i) {
+				return NaiveOrient3d(p[i], q[i], r[i], s[i]);
+			}, [&](std::size_t i) { return orient3d(p[i], q[i], r[i], s[i]); });
+	}
+
+	/* Random points, and points rounded onto a circle or sphere */
+	void Incircle(bool degenerate) {
+		std::mt19937_64 gen(6);
+		std::uniform_real_distribution<double> dist(0, 1), angle(0, 6.28);
+		Points2 a(Count), b(Count), c(Count), d(Count);
+		Points3 p(Count), q(Count), r(Count), s(Count), t(Count);
+		const auto circle = [&]() {
+			const double phi = angle(gen);
+			return geom::Point2d(0.5 + 0.3 * std::cos(phi),
+													 0.5 + 0.3 * std::sin(phi));
+		};
+		const auto sphere = [&]() {
+			const double phi = angle(gen), z = 2 * dist(gen) - 1;
+			const double rho = std::sqrt(1 - z * z);
+			return geom::Point3d(0.5 + 0.3 * rho * std::cos(phi),
+													 0.5 + 0.3 * rho * std::sin(phi), 0.5 + 0.3 * z);
+		};
+		const auto random2 = [&]() { return geom::Point2d(dist(gen), dist(gen)); };
+		const auto random3 = [&]() {
+			return geom::Point3d(dist(gen), dist(gen), dist(gen));
+		};
+		for(std::size_t i = 0; i < Count; ++i) {
+			a[i] = circle();
+			b[i] = circle();
+			c[i] = circle();
+			d[i] = degenerate ? circle() : random2();
+			p[i] = sphere();
+			q[i] = sphere();
+			r[i] = sphere();
+			s[i] = sphere();
+			t[i] = degenerate ? sphere() : random3();
+		}
+		const char *suffix = degenerate ? ", nearly degenerate" : ", random";
+		std::printf("incircle%s\n", suffix);
+		Compare([&](std::size_t i) {
+				return NaiveIncircle(a[i], b[i], c[i], d[i]);
+			}, [&](std::size_t i) { return incircle(a[i], b[i], c[i], d[i]); });
+		std::printf("insphere%s\n", suffix);
+		Compare([&](std::size_t i) {
+				return NaiveInsphere(p[i], q[i], r[i], s[i], t[i]);
+			}, [&](std::size_t i) {
+				return insphere(p[i], q[i], r[i], s[i], t[i]);
+			});
+	}
+}
+
+int main() {
+	Orient(false);
+	Incircle(false);
+	Orient(true);
+	Incircle(true);
+	return 0;
+}
@@ -0,0 +1,101 @@
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Rectangle2SoA.hpp"
+
+/*
+ * Throughput of testing 64K rectangles against a tile and against a point,
+ * as a compositor bins layers into tiles and hit tests them: a scalar loop
+ * over an array of Rectangle2 objects collecting indices, against the batch
+ * kernels writing bitmasks and index lists. About 1% of the rectangles
+ * overlap each tile and fewer contain each point.
+ */
+
+namespace {
+	const std::size_t Count = 1 << 16;
+	const std::size_t Probes = 64;
+
+	template <typename S>
+	void Run(const char *name) {
+		std::mt19937 gen(9);
+		std::uniform_int_distribution<int> position(0, 1920), size(1, 256);
+		std::vector<geom::Rectangle2<S>> aos(Count);
+		for(std::size_t i = 0; i < Count; ++i) {
+			aos[i] = geom::Rectangle2<S>(S(position(gen)), S(position(gen)),
+																	 S(size(gen)), S(size(gen)));
+		}
+		const geom::Rectangle2SoA<S> rects(aos.data(), Count);
+		std::vector<geom::Rectangle2<S>> tiles(Probes);
+		std::vector<geom::Point2<S>> points(Probes);
+		for(std::size_t i = 0; i < Probes; ++i) {
+			tiles[i] = geom::Rectangle2<S>(S(position(gen)), S(position(gen)),
+																		 64, 64);
+			points[i] = geom::Point2<S>(S(position(gen)), S(position(gen)));
+		}
+		std::vector<std::uint32_t> indices(Count), mask(Count / 32);
+
+		std::size_t found = 0;
+		const double naiveTiles = bench::Time([&]() {
+				found = 0;
+				for(std::size_t t = 0; t < Probes; ++t) {
+					std::size_t n = 0;
+					for(std::size_t i = 0; i < Count; ++i) {
+						if(overlaps(tiles[t], aos[i])) {
+							indices[n++] = std::uint32_t(i);
+						}
+					}
+					found += n;
+					bench::DoNotOptimize(indices[0]);
+				}
+			});
+		const double maskTiles = bench::Time([&]() {
+				for(std::size_t t = 0; t < Probes; ++t) {
+					overlaps(tiles[t], rects.span(), mask.data());
+					bench::DoNotOptimize(mask[0]);
+				}
+			});
+		const double indexTiles = bench::Time([&]() {
+				for(std::size_t t = 0; t < Probes; ++t) {
+					bench::DoNotOptimize(
+						overlapping(tiles[t], rects.span(), indices.data()));
+				}
+			});
+		const double naivePoints = bench::Time([&]() {
+				for(std::size_t t = 0; t < Probes; ++t) {
+					std::size_t n = 0;
+					for(std::size_t i = 0; i < Count; ++i) {
+						if(contains(aos[i], points[t])) {
+							indices[n++] = std::uint32_t(i);
+						}
+					}
+					bench::DoNotOptimize(n);
+				}
+			});
+		const double indexPoints = bench::Time([&]() {
+				for(std::size_t t = 0; t < Probes; ++t) {
+					bench::DoNotOptimize(
+						containing(rects.span(), points[t], indices.data()));
+				}
+			});
+		std::printf("%s (%.1f%% overlap)\n", name,
+								100.0 * found / (Count * Probes));
+		bench::Report("  scalar tile", naiveTiles, Count * Probes);
+		bench::Report("  tile bitmask", maskTiles, Count * Probes);
+		bench::Report("  tile indices", indexTiles, Count * Probes);
+		bench::Report("  scalar point", naivePoints, Count * Probes);
+		bench::Report("  point indices", indexPoints, Count * Probes);
+		bench::Speedup("  bitmask speedup", naiveTiles, maskTiles);
+		bench::Speedup("  tile index speedup", naiveTiles, indexTiles);
+		bench::Speedup("  point index speedup", naivePoints, indexPoints);
+	}
+}
+
+int main() {
+	Run<std::int32_t>("int32");
+	Run<float>("float");
+	Run<double>("double");
+	return 0;
+}
@@ -0,0 +1,142 @@
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/SegmentIntersection.hpp"
+
+/*
+ * Time to find every intersecting pair in sets of segments, as in cleaning
+ * up map data: testing every pair whose bounding boxes overlap, against the
+ * sweep. Random segments are short enough that each crosses about two
+ * others. The adversarial sets are a grid and a star, where every pair
+ * intersects and no algorithm can beat the output size, and slivers, long
+ * nearly parallel segments whose bounding boxes all overlap but of which
+ * each crosses only its neighbors.
+ */
+
+namespace {
+	template <typename S>
+	std::size_t BruteForce(const std::vector<geom::Line2<S>> &segments,
+												 std::vector<geom::SegmentIntersection<S>> &out)
+	{
+		typedef typename geom::IntersectionScalar<S>::type R;
+		out.clear();
+		const std::size_t n = segments.size();
+		std::vector<S> x0(n), y0(n), x1(n), y1(n);
+		for(std::size_t i = 0; i < n; ++i) {
+			const geom::Line2<S> &l = segments[i];
+			x0[i] = std::min(l.p1.x, l.p2.x);
+			y0[i] = std::min(l.p1.y, l.p2.y);
+			x1[i] = std::max(l.p1.x, l.p2.x);
+			y1[i] = std::max(l.p1.y, l.p2.y);
+		}
+		for(std::uint32_t i = 0; i < n; ++i) {
+			for(std::uint32_t j = i + 1; j < n; ++j) {
+				if(x0[j] > x1[i] || x0[i] > x1[j] || y0[j] > y1[i] || y0[i] > y1[j]) {
+					continue;
+				}
+				geom::Point2<R> p;
+				if(intersect(segments[i], segments[j], p)) {
+					geom::SegmentIntersection<S> r = { i, j, p };
+					out.push_back(r);
+				}
+			}
+		}
+		return out.size();
+	}
+
+	template <typename S>
+	void Run(const char *name, const std::vector<geom::Line2<S>> &segments,
+					 bool brute)
+	{
+		std::vector<geom::SegmentIntersection<S>> out;
+		const double sweep = bench::Time([&]() {
+				segmentIntersections(segments.data(), segments.size(), out);
+				bench::DoNotOptimize(out.data());
+			}, 3);
+		std::printf("%s: %zu segments, %zu intersections\n", name,
+								segments.size(), out.size());
+		bench::Report("  sweep", sweep, segments.size());
+		if(brute) {
+			std::vector<geom::SegmentIntersection<S>> pairs;
+			const double naive = bench::Time([&]() {
+					BruteForce(segments, pairs);
+					bench::DoNotOptimize(pairs.data());
+				}, 1);
+			if(pairs.size() != out.size()) {
+				std::printf("  mismatch: %zu brute force intersections\n",
+										pairs.size());
+			}
+			bench::Report("  brute force", naive, segments.size());
+			bench::Speedup("  speedup", naive, sweep);
+		}
+	}
+
+	/* Segments of length about sqrt(2 pi / n) of the extent cross two others */
+	template <typename S>
+	std::vector<geom::Line2<S>> Random(std::size_t count, double extent) {
+		std::mt19937 gen(17);
+		std::uniform_real_distribution<double> position(0, extent), angle(0, 6.3);
+		const double length = extent * std::sqrt(2 * 3.14159 / count);
+		std::vector<geom::Line2<S>> segments;
+		for(std::size_t i = 0; i < count; ++i) {
+			const double x = position(gen), y = position(gen), a = angle(gen);
+			segments.push_back(geom::Line2<S>(S(x), S(y),
+																				S(x + length * std::cos(a)),
+																				S(y + length * std::sin(a))));
+		}
+		return segments;
+	}
+
+	template <typename S>
+	std::vector<geom::Line2<S>> Grid(int count) {
+		std::vector<geom::Line2<S>> segments;
+		for(int i = 0; i < count / 2; ++i) {
+			segments.push_back(geom::Line2<S>(0, S(i), S(count), S(i)));
+			segments.push_back(geom::Line2<S>(S(i), 0, S(i), S(count)));
+		}
+		return segments;
+	}
+
+	template <typename S>
+	std::vector<geom::Line2<S>> Star(int count) {
+		std::vector<geom::Line2<S>> segments;
+		for(int i = 0; i < count; ++i) {
+			segments.push_back(geom::Line2<S>(S(-count), S(2 * i - count),
+																				S(count), S(count - 2 * i)));
+		}
+		return segments;
+	}
+
+	/* Long segments in a thin band, each crossing its neighbors */
+	template <typename S>
+	std::vector<geom::Line2<S>> Slivers(int count) {
+		std::vector<geom::Line2<S>> segments;
+		for(int i = 0; i < count; ++i) {
+			segments.push_back(geom::Line2<S>(0, S(4 * i), S(1 << 20),
+																				S(4 * i + (i % 3 ? -1 : 9))));
+		}
+		return segments;
+	}
+}
+
+int main() {
+	const double extent = 1 << 20;
+	Run("random Line2i", Random<std::int32_t>(1 << 12, extent), true);
+	Run("random Line2i", Random<std::int32_t>(1 << 14, extent), true);
+	Run("random Line2i", Random<std::int32_t>(100000, extent), false);
+	Run("random Line2d", Random<double>(1 << 12, 1), true);
+	Run("random Line2d", Random<double>(1 << 14, 1), true);
+	Run("random Line2d", Random<double>(100000, 1), false);
+	Run("random Line2l", Random<std::int64_t>(100000, 1e18), false);
+	Run("grid Line2i", Grid<std::int32_t>(2048), true);
+	Run("star Line2i", Star<std::int32_t>(1024), true);
+	Run("slivers Line2i", Slivers<std::int32_t>(1 << 14), true);
+	Run("slivers Line2d", Slivers<double>(1 << 14), true);
+	return 0;
+}
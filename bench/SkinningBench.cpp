@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/DualQuaternion.hpp"
+
+/*
+ * Skinning a 100k vertex mesh with 4 influences per vertex and a palette of
+ * 64 joints: linear blending of a Matrix4 palette, dual quaternion blending
+ * one vertex at a time, and the batch dual quaternion kernel over SoA
+ * vertices.
+ */
+
+namespace {
+	const std::size_t Count = 100000;
+	const std::uint32_t Joints = 64;
+	const int Passes = 20;
+	
+	template <typename S>
+	void Run(const char *type) {
+		using namespace geom;
+		std::mt19937 gen(42);
+		std::uniform_real_distribution<S> dist(-1, 1);
+		std::vector<DualQuaternion<S>> palette;
+		std::vector<Matrix4<S>> matrices;
+		for(std::uint32_t j = 0; j < Joints; ++j) {
+			const Quaternion<S> r(normalize(Quaternion<S>(dist(gen), dist(gen),
+																										dist(gen), dist(gen))));
+			palette.push_back(DualQuaternion<S>(r, Vector3<S>(dist(gen), dist(gen),
+																												dist(gen))));
+			matrices.push_back(palette.back().toMatrix4());
+		}
+		std::vector<Vec4u> joints;
+		std::vector<Vector4<S>> weights;
+		Point3SoA<S> positions;
+		Vector3SoA<S> normals;
+		for(std::size_t i = 0; i < Count; ++i) {
+			/* Neighbouring vertices share joints as in a real mesh */
+			const std::uint32_t base = std::uint32_t(i / 2048) % (Joints - 3);
+			joints.push_back(Vec4u(base, base + 1 + gen() % 3, base + gen() % 4,
+														 base + 3));
+			const S a = (dist(gen) + 1) / 2, b = (1 - a) / 2;
+			weights.push_back(Vector4<S>(a, b, b / 2, b / 2));
+			positions.push_back(Point3<S>(dist(gen), dist(gen), dist(gen)));
+			normals.push_back(normalize(Vector3<S>(dist(gen), dist(gen), 1)));
+		}
+		Point3SoA<S> out(Count);
+		Vector3SoA<S> outNormals(Count);
+		
+		const double matrix = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						const Matrix4<S> m = matrices[joints[i].x] * weights[i].x +
+							matrices[joints[i].y] * weights[i].y +
+							matrices[joints[i].z] * weights[i].z +
+							matrices[joints[i].w] * weights[i].w;
+						const Point3<S> p = m * positions[i];
+						const Vector3<S> n = m * normals[i];
+						out.x[i] = p.x;
+						out.y[i] = p.y;
+						out.z[i] = p.z;
+						outNormals.x[i] = n.x;
+						outNormals.y[i] = n.y;
+						outNormals.z[i] = n.z;
+					}
+					bench::DoNotOptimize(out.x[0]);
+				}
+			});
+		const double single = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						const DualQuaternion<S> q = blend(palette.data(), joints[i],
+																							weights[i]);
+						const Point3<S> p = q * positions[i];
+						const Vector3<S> n = q * normals[i];
+						out.x[i] = p.x;
+						out.y[i] = p.y;
+						out.z[i] = p.z;
+						outNormals.x[i] = n.x;
+						outNormals.y[i] = n.y;
+						outNormals.z[i] = n.z;
+					}
+					bench::DoNotOptimize(out.x[0]);
+				}
+			});
+		const double batch = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					skin(palette.data(), joints.data(), weights.data(),
+							 positions.span(), normals.span(), out.span(),
+							 outNormals.span());
+					bench::DoNotOptimize(out.x[0]);
+				}
+			});
+		const std::size_t items = Count * Passes;
+		std::printf("%s: %u bytes per joint as Matrix4, %u as DualQuaternion\n",
+								type, unsigned(sizeof(Matrix4<S>)),
+								unsigned(sizeof(DualQuaternion<S>)));
+		bench::Report("  Matrix4 palette loop", matrix, items);
+		bench::Report("  DualQuaternion loop", single, items);
+		bench::Report("  DualQuaternion batch", batch, items);
+		bench::Speedup("  batch vs Matrix4 palette", matrix, batch);
+		bench::Speedup("  batch vs DualQuaternion loop", single, batch);
+	}
+}
+
+int main() {
+	Run<float>("float");
+	Run<double>("double");
+	return 0;
+}
@@ -0,0 +1,76 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Quaternion.hpp"
+
+/*
+ * Blending two animation poses of joint rotations: exact slerp per joint,
+ * the polynomial slerpFast per joint and over the whole pose, and the batch
+ * nlerp.
+ */
+
+namespace {
+	const std::size_t Count = 1 << 12;
+	const int Passes = 256;
+	
+	template <typename S>
+	void Run(const char *type) {
+		typedef geom::Quaternion<S> Quaternion;
+		std::mt19937 gen(42);
+		std::uniform_real_distribution<S> dist(-1, 1);
+		std::vector<Quaternion> a(Count), b(Count), out(Count);
+		std::vector<S> t(Count);
+		for(std::size_t i = 0; i < Count; ++i) {
+			a[i] = normalize(Quaternion(dist(gen), dist(gen), dist(gen),
+																	dist(gen)));
+			b[i] = normalize(Quaternion(dist(gen), dist(gen), dist(gen),
+																	dist(gen)));
+			t[i] = (dist(gen) + 1) / 2;
+		}
+		
+		const double exact = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						out[i] = slerp(a[i], b[i], t[i]);
+					}
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+		const double fast = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					for(std::size_t i = 0; i < Count; ++i) {
+						out[i] = slerpFast(a[i], b[i], t[i]);
+					}
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+		const double batch = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					slerpFast(a.data(), b.data(), t.data(), Count, out.data());
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+		const double blend = bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					nlerp(a.data(), b.data(), t.data(), Count, out.data());
+					bench::DoNotOptimize(out[0]);
+				}
+			});
+		const std::size_t items = Count * Passes;
+		std::printf("%s:\n", type);
+		bench::Report("  slerp loop", exact, items);
+		bench::Report("  slerpFast loop", fast, items);
+		bench::Report("  slerpFast batch", batch, items);
+		bench::Report("  nlerp batch", blend, items);
+		bench::Speedup("  slerpFast loop vs slerp", exact, fast);
+		bench::Speedup("  slerpFast batch vs slerp", exact, batch);
+	}
+}
+
+int main() {
+	Run<float>("float");
+	Run<double>("double");
+	return 0;
+}
@@ -0,0 +1,70 @@
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/BatchTransform.hpp"
+
+/*
+ * Throughput of transforming a LiDAR sized frame of points by one Matrix4f:
+ * a loop over the scalar operator, the AoS and SoA batch kernels, and the SoA
+ * kernel split over every hardware thread.
+ */
+
+namespace {
+	const std::size_t Count = 1 << 20;
+	const int Passes = 16;
+}
+
+int main() {
+	std::mt19937 gen(42);
+	std::uniform_real_distribution<float> dist(-100, 100);
+	std::vector<geom::Point3f> in(Count), out(Count);
+	for(std::size_t i = 0; i < Count; ++i) {
+		in[i] = geom::Point3f(dist(gen), dist(gen), dist(gen));
+	}
+	geom::Point3SoAf sin(in.data(), Count), sout(Count);
+	const geom::Matrix4f m =
+		geom::Matrix4f::translate(geom::Vec3f(1, 2, 3)) *
+		geom::Matrix4f::rotate(0.5f, geom::Vec3f(1, 1, 0));
+	const geom::Parallel parallel;
+	
+	const double loop = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				for(std::size_t i = 0; i < Count; ++i) {
+					out[i] = m * in[i];
+				}
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	const double aos = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				geom::transformPoints(m, in.data(), Count, out.data());
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	const double soa = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				geom::transformPoints(m, sin.span(), sout.span());
+				bench::DoNotOptimize(sout.x[0]);
+			}
+		});
+	const double threaded = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				geom::transformPoints(m, sin.span(), sout.span(), parallel);
+				bench::DoNotOptimize(sout.x[0]);
+			}
+		});
+	
+	const std::size_t items = Count * Passes;
+	bench::Report("m * p loop", loop, items);
+	bench::Report("transformPoints, AoS", aos, items);
+	bench::Report("transformPoints, SoA", soa, items);
+	bench::Report("transformPoints, SoA parallel", threaded, items);
+	bench::Speedup("AoS batch vs loop", loop, aos);
+	bench::Speedup("SoA batch vs loop", loop, soa);
+	bench::Speedup("SoA parallel vs SoA", soa, threaded);
+	std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+	return 0;
+}
@@ -0,0 +1,146 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Triangle3.hpp"
+
+/*
+ * Nearest hit queries of single rays against a soup of a million small
+ * triangles, as picking or baking without an acceleration structure does:
+ * a scalar Moller-Trumbore loop with early exits, the common form in ray
+ * tracers, against the batch kernel over an array of Triangle3 objects and
+ * over vertex coordinate arrays. With AVX-512 the arrays are also tested
+ * with the 8 or 4 lanes of AVX, to show the gain of the 16 lanes. A soup
+ * of a million triangles does not fit in the caches and the arrays are
+ * tested at the speed of memory, so the soup of a leaf of an acceleration
+ * structure, which does fit, is timed too.
+ */
+
+namespace {
+	const std::size_t Soup = 1 << 20;
+	const std::size_t Leaf = 1 << 12;
+	const std::size_t Pairs = 1 << 24;
+
+	template <typename S>
+	bool NaiveIntersect(const geom::Ray3<S> &ray, const geom::Triangle3<S> &tri,
+											S tMax, S &t, S &u, S &v)
+	{
+		const S e1[3] = { tri.b.x - tri.a.x, tri.b.y - tri.a.y,
+											tri.b.z - tri.a.z };
+		const S e2[3] = { tri.c.x - tri.a.x, tri.c.y - tri.a.y,
+											tri.c.z - tri.a.z };
+		const S *d = &ray.direction.x;
+		const S p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2],
+										 d[0] * e2[1] - d[1] * e2[0] };
+		const S det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+		if(det == 0) {
+			return false;
+		}
+		const S inverse = 1 / det;
+		const S s[3] = { ray.origin.x - tri.a.x, ray.origin.y - tri.a.y,
+										 ray.origin.z - tri.a.z };
+		u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse;
+		if(u < 0 || u > 1) {
+			return false;
+		}
+		const S q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2],
+										 s[0] * e1[1] - s[1] * e1[0] };
+		v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inverse;
+		if(v < 0 || u + v > 1) {
+			return false;
+		}
+		t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverse;
+		return t >= 0 && t < tMax;
+	}
+
+	template <typename S>
+	void Run(const char *name, std::size_t Triangles) {
+		const std::size_t Rays = Pairs / Triangles;
+		std::mt19937 gen(7);
+		std::uniform_real_distribution<S> center(-100, 100), offset(-0.5, 0.5);
+		std::vector<geom::Triangle3<S>> triangles;
+		for(std::size_t i = 0; i < Triangles; ++i) {
+			const S x = center(gen), y = center(gen), z = center(gen);
+			triangles.push_back(geom::Triangle3<S>(
+				geom::Point3<S>(x + offset(gen), y + offset(gen), z + offset(gen)),
+				geom::Point3<S>(x + offset(gen), y + offset(gen), z + offset(gen)),
+				geom::Point3<S>(x + offset(gen), y + offset(gen), z + offset(gen))));
+		}
+		const geom::Triangle3SoA<S> soa(triangles.data(), triangles.size());
+		std::vector<geom::Ray3<S>> rays;
+		for(std::size_t i = 0; i < Rays; ++i) {
+			rays.push_back(geom::Ray3<S>(
+				geom::Point3<S>(center(gen), center(gen), -200),
+				geom::Vector3<S>(center(gen) / 400, center(gen) / 400, 1)));
+		}
+		const S tMax = 1000;
+		std::vector<geom::TriangleHit<S>> hits(Rays);
+
+		std::size_t hitCount = 0;
+		const double naive = bench::Time([&]() {
+				hitCount = 0;
+				for(std::size_t r = 0; r < Rays; ++r) {
+					geom::TriangleHit<S> &h = hits[r];
+					h.t = tMax;
+					for(std::size_t i = 0; i < Triangles; ++i) {
+						S t, u, v;
+						if(NaiveIntersect(rays[r], triangles[i], h.t, t, u, v)) {
+							h.t = t;
+							h.u = u;
+							h.v = v;
+							h.index = i;
+						}
+					}
+					hitCount += h.t < tMax;
+				}
+				bench::DoNotOptimize(hits[0]);
+			});
+		const double objects = bench::Time([&]() {
+				for(std::size_t r = 0; r < Rays; ++r) {
+					intersect(rays[r], triangles.data(), Triangles, tMax, hits[r]);
+				}
+				bench::DoNotOptimize(hits[0]);
+			});
+		const double arrays = bench::Time([&]() {
+				for(std::size_t r = 0; r < Rays; ++r) {
+					intersect(rays[r], soa, tMax, hits[r]);
+				}
+				bench::DoNotOptimize(hits[0]);
+			});
+		const std::size_t pairs = Triangles * Rays;
+		std::printf("%s, %zu triangles (%zu of %zu rays hit)\n", name,
+								Triangles, hitCount, Rays);
+		bench::Report("  scalar", naive, pairs);
+		bench::Report("  batch Triangle3", objects, pairs);
+		bench::Report("  batch arrays", arrays, pairs);
+#if defined(GEOM_AVX512)
+		const geom::detail::RayTriangleArrays<S> spans = {
+			rays[0], soa.a.span(), soa.b.span(), soa.c.span()
+		};
+		const double narrow = bench::Time([&]() {
+				for(std::size_t r = 0; r < Rays; ++r) {
+					geom::TriangleHit<S> &h = hits[r];
+					h.t = tMax;
+					geom::detail::RayTriangleArrays<S> s = spans;
+					s.ray = rays[r];
+					geom::detail::nearestPacked<typename geom::simd::Pack<S>::type>(
+						s, 0, Triangles, h);
+				}
+				bench::DoNotOptimize(hits[0]);
+			});
+		bench::Report("  batch arrays, AVX", narrow, pairs);
+		bench::Speedup("  AVX-512 over AVX", narrow, arrays);
+#endif
+		bench::Speedup("  Triangle3 speedup", naive, objects);
+		bench::Speedup("  arrays speedup", naive, arrays);
+	}
+}
+
+int main() {
+	Run<float>("float", Soup);
+	Run<double>("double", Soup);
+	Run<float>("float", Leaf);
+	Run<double>("double", Leaf);
+	return 0;
+}
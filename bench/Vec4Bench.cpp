@@ -0,0 +1,108 @@
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Vector4.hpp"
+
+/*
+ * Throughput of the SIMD Vec4f/Vec4d arithmetic against the plain
+ * component-by-component struct the library used to provide.
+ */
+
+namespace {
+	template <typename Scalar>
+	struct ScalarVector4 {
+		ScalarVector4() : x(0), y(0), z(0), w(0) { }
+		ScalarVector4(Scalar x, Scalar y, Scalar z, Scalar w) :
+			x(x), y(y), z(z), w(w)
+		{ }
+		Scalar x, y, z, w;
+	};
+	
+	template <typename S>
+	ScalarVector4<S> operator+(const ScalarVector4<S> &a,
+														 const ScalarVector4<S> &b)
+	{
+		return ScalarVector4<S>(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+	}
+	template <typename S>
+	ScalarVector4<S> operator-(const ScalarVector4<S> &a,
+														 const ScalarVector4<S> &b)
+	{
+		return ScalarVector4<S>(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+	}
+	template <typename S>
+	ScalarVector4<S> operator*(const ScalarVector4<S> &a, S s) {
+		return ScalarVector4<S>(a.x * s, a.y * s, a.z * s, a.w * s);
+	}
+	template <typename S>
+	ScalarVector4<S> operator/(const ScalarVector4<S> &a, S s) {
+		return ScalarVector4<S>(a.x / s, a.y / s, a.z / s, a.w / s);
+	}
+	template <typename S>
+	S dot(const ScalarVector4<S> &a, const ScalarVector4<S> &b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	}
+	template <typename S>
+	ScalarVector4<S> normalize(const ScalarVector4<S> &a) {
+		return a / std::sqrt(dot(a, a));
+	}
+	template <typename S>
+	ScalarVector4<S> min(const ScalarVector4<S> &a, const ScalarVector4<S> &b) {
+		return ScalarVector4<S>(a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y,
+														a.z < b.z ? a.z : b.z, a.w < b.w ? a.w : b.w);
+	}
+	
+	const std::size_t Count = 1 << 16;
+	const int Passes = 64;
+	
+	/* out = normalize(min(a * s + b, c) - b), then accumulate dot(out, a) */
+	template <typename Vec, typename S>
+	double Kernel(const std::vector<Vec> &a, const std::vector<Vec> &b,
+								const std::vector<Vec> &c, std::vector<Vec> &out)
+	{
+		return bench::Time([&]() {
+				for(int pass = 0; pass < Passes; ++pass) {
+					S sum = 0;
+					for(std::size_t i = 0; i < Count; ++i) {
+						out[i] = normalize(min(a[i] * S(1.5) + b[i], c[i]) - b[i]);
+						sum += dot(out[i], a[i]);
+					}
+					bench::DoNotOptimize(sum);
+				}
+			});
+	}
+	
+	template <typename S>
+	void Run(const char *scalarName, const char *simdName, const char *ratio) {
+		std::mt19937 gen(42);
+		std::uniform_real_distribution<S> dist(1, 10);
+		std::vector<ScalarVector4<S>> sa(Count), sb(Count), sc(Count), sout(Count);
+		std::vector<geom::Vector4<S>> va(Count), vb(Count), vc(Count), vout(Count);
+		for(std::size_t i = 0; i < Count; ++i) {
+			const S v[12] = { dist(gen), dist(gen), dist(gen), dist(gen),
+												dist(gen), dist(gen), dist(gen), dist(gen),
+												dist(gen), dist(gen), dist(gen), dist(gen) };
+			sa[i] = ScalarVector4<S>(v[0], v[1], v[2], v[3]);
+			sb[i] = ScalarVector4<S>(v[4], v[5], v[6], v[7]);
+			sc[i] = ScalarVector4<S>(v[8], v[9], v[10], v[11]);
+			va[i] = geom::Vector4<S>(v[0], v[1], v[2], v[3]);
+			vb[i] = geom::Vector4<S>(v[4], v[5], v[6], v[7]);
+			vc[i] = geom::Vector4<S>(v[8], v[9], v[10], v[11]);
+		}
+		
+		const double scalar = Kernel<ScalarVector4<S>, S>(sa, sb, sc, sout);
+		const double simd = Kernel<geom::Vector4<S>, S>(va, vb, vc, vout);
+		bench::Report(scalarName, scalar, Count * Passes);
+		bench::Report(simdName, simd, Count * Passes);
+		bench::Speedup(ratio, scalar, simd);
+	}
+}
+
+int main() {
+	Run<float>("scalar struct float", "geom::Vec4f", "Vec4f speedup");
+	Run<double>("scalar struct double", "geom::Vec4d", "Vec4d speedup");
+	return 0;
+}
@@ -0,0 +1,105 @@
+
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/VectorExpr.hpp"
+
+/*
+ * A damped spring particle update,
+ *   p' = p + v * dt + a * (dt^2 / 2) - (p - anchor) * k
+ * evaluated
+ *  - with the eager Vector3 operators one particle at a time,
+ *  - with the eager operators one whole array at a time, storing every
+ *    intermediate array as a temporary,
+ *  - fused by the expression templates over arrays of Vector3,
+ *  - fused by the expression templates over component arrays.
+ */
+
+namespace {
+	typedef geom::Vec3f V;
+	
+	const std::size_t Count = 10000;
+	const int Passes = 500;
+	const float dt = 0.016f;
+	const float half = 0.5f * dt * dt;
+	const float k = 0.01f;
+	
+	template <typename Op>
+	std::vector<V> ArrayOp(const std::vector<V> &a, Op op) {
+		std::vector<V> r(a.size());
+		for(std::size_t i = 0; i < a.size(); ++i) {
+			r[i] = op(i);
+		}
+		return r;
+	}
+}
+
+int main() {
+	std::mt19937 gen(7);
+	std::uniform_real_distribution<float> dist(-100, 100);
+	std::vector<V> p(Count), v(Count), a(Count);
+	for(std::size_t i = 0; i < Count; ++i) {
+		p[i] = V(dist(gen), dist(gen), dist(gen));
+		v[i] = V(dist(gen), dist(gen), dist(gen));
+		a[i] = V(dist(gen), dist(gen), dist(gen));
+	}
+	const V anchor(1, 2, 3);
+	geom::Vec3SoAf sp(p.data(), Count), sv(v.data(), Count), sa(a.data(), Count);
+	std::vector<V> out(Count);
+	geom::Vec3SoAf sout(Count);
+	
+	const double eager = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				for(std::size_t i = 0; i < Count; ++i) {
+					out[i] = p[i] + v[i] * dt + a[i] * half - (p[i] - anchor) * k;
+				}
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	
+	const double arrays = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				std::vector<V> t1 = ArrayOp(p, [&](std::size_t i) {
+						return v[i] * dt; });
+				std::vector<V> t2 = ArrayOp(p, [&](std::size_t i) {
+						return p[i] + t1[i]; });
+				std::vector<V> t3 = ArrayOp(p, [&](std::size_t i) {
+						return a[i] * half; });
+				std::vector<V> t4 = ArrayOp(p, [&](std::size_t i) {
+						return t2[i] + t3[i]; });
+				std::vector<V> t5 = ArrayOp(p, [&](std::size_t i) {
+						return (p[i] - anchor); });
+				std::vector<V> t6 = ArrayOp(p, [&](std::size_t i) {
+						return t5[i] * k; });
+				out = ArrayOp(p, [&](std::size_t i) { return t4[i] - t6[i]; });
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	
+	using geom::expr::lazy;
+	const double fusedAoS = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				geom::expr::assign(out.data(), lazy(p) + lazy(v) * dt +
+													 lazy(a) * half - (lazy(p) - lazy(anchor)) * k);
+				bench::DoNotOptimize(out[0]);
+			}
+		});
+	
+	const double fusedSoA = bench::Time([&]() {
+			for(int pass = 0; pass < Passes; ++pass) {
+				geom::expr::assign(sout.span(), lazy(sp) + lazy(sv) * dt +
+													 lazy(sa) * half - (lazy(sp) - lazy(anchor)) * k);
+				bench::DoNotOptimize(sout.x[0]);
+			}
+		});
+	
+	const std::size_t items = Count * Passes;
+	bench::Report("eager, per particle", eager, items);
+	bench::Report("eager, array temporaries", arrays, items);
+	bench::Report("expr, Vector3 arrays", fusedAoS, items);
+	bench::Report("expr, component arrays", fusedSoA, items);
+	bench::Speedup("expr AoS vs array temporaries", arrays, fusedAoS);
+	bench::Speedup("expr AoS vs eager per particle", eager, fusedAoS);
+	return 0;
+}
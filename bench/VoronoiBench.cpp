@@ -0,0 +1,50 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "geom/Voronoi.hpp"
+
+/*
+ * Voronoi cells of a million random sites clipped to their square, built
+ * from a triangulation made beforehand and with the triangulation, and of
+ * the same sites clipped to a quarter of the square, where many cells are
+ * cut or empty.
+ */
+
+namespace {
+	const std::size_t Sites = 1000000;
+}
+
+int main() {
+	std::mt19937 gen(1);
+	std::uniform_real_distribution<double> dist(0, 1);
+	std::vector<geom::Point2d> sites;
+	for(std::size_t i = 0; i < Sites; ++i) {
+		const double x = dist(gen);
+		sites.push_back(geom::Point2d(x, dist(gen)));
+	}
+	geom::Triangulation2 t;
+	geom::delaunay(sites.data(), sites.size(), t);
+	
+	geom::Voronoi2<double> v;
+	const geom::Rectangle2d square(0, 0, 1, 1), quarter(0.25, 0.25, 0.5, 0.5);
+	const double cells = bench::Time([&]() {
+			geom::voronoi(sites.data(), sites.size(), t, square, v);
+			bench::DoNotOptimize(v.vertices[0]);
+		});
+	const double clipped = bench::Time([&]() {
+			geom::voronoi(sites.data(), sites.size(), t, quarter, v);
+			bench::DoNotOptimize(v.vertices[0]);
+		});
+	const double total = bench::Time([&]() {
+			geom::voronoi(sites.data(), sites.size(), square, v);
+			bench::DoNotOptimize(v.vertices[0]);
+		});
+	std::printf("%zu sites, %zu vertices in their square\n", sites.size(),
+							v.vertices.size());
+	bench::Report("voronoi from triangulation", cells, sites.size());
+	bench::Report("voronoi, quarter square", clipped, sites.size());
+	bench::Report("voronoi with delaunay", total, sites.size());
+	return 0;
+}
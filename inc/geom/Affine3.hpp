@@ -0,0 +1,489 @@
+/**
+ * \file Affine3.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief A compact matrix for affine transformations of 3 dimensional geometry
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_AFFINE_3_HPP
+#define GEOM_AFFINE_3_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <type_traits>
+
+#include "Matrix3.hpp"
+#include "Matrix4.hpp"
+#include "Point3.hpp"
+#include "Vector3.hpp"
+#include "VectorTraits.hpp"
+
+namespace geom {
+	/**
+	 * \brief A 3x4 matrix holding an affine transformation of 3 dimensional
+	 * geometry.
+	 * 
+	 * An \c Affine3 is a \c Matrix4 without the constant bottom row 0 0 0 1:
+	 * a linear part, the first three columns, followed by a translation. It
+	 * takes 12 values rather than 16 and its products skip the work on the
+	 * constant row.
+	 * 
+	 * As with \c Matrix4 the values are stored in column major order, points
+	 * and vectors are column vectors multiplied on the right and \c A*B
+	 * applies \c B first. Every operation gives the same result as the
+	 * matching \c Matrix4 operation on \c toMatrix4() of its operands.
+	 */
+	template <typename Scalar>
+	struct Affine3 {
+		typedef Scalar type;
+		
+		/**
+		 * \brief Construct a null \c Affine3 object
+		 * 
+		 * This transformation maps every point to the origin.
+		 */
+		Affine3() :
+			values{0,0,0,0,0,0,0,0,0,0,0,0}
+		{ }
+		/**
+		 * \brief Construct an \c Affine3 object with the given values.
+		 * 
+		 * As with \c Matrix4 the values are expected in row-major order and are
+		 * shuffled into column-major order.
+		 */
+		Affine3(Scalar r1c1, Scalar r1c2, Scalar r1c3, Scalar r1c4,
+						Scalar r2c1, Scalar r2c2, Scalar r2c3, Scalar r2c4,
+						Scalar r3c1, Scalar r3c2, Scalar r3c3, Scalar r3c4) :
+			values{r1c1, r2c1, r3c1, r1c2, r2c2, r3c2,
+				r1c3, r2c3, r3c3, r1c4, r2c4, r3c4}
+		{ }
+		/**
+		 * \brief Construct an \c Affine3 object from its linear part and
+		 * translation.
+		 * \arg \c linear The linear transformation, applied first
+		 * \arg \c translation The offset added after the linear transformation
+		 */
+		Affine3(const Matrix3<Scalar> &linear,
+						const Vector3<Scalar> &translation) :
+			values{linear.values[0], linear.values[1], linear.values[2],
+				linear.values[3], linear.values[4], linear.values[5],
+				linear.values[6], linear.values[7], linear.values[8],
+				translation.x, translation.y, translation.z}
+		{ }
+		/**
+		 * \brief Construct an \c Affine3 object from the top three rows of a
+		 * \c Matrix4 object.
+		 * 
+		 * The bottom row of the matrix is discarded, so this is only a faithful
+		 * conversion for matrices whose bottom row is 0 0 0 1.
+		 * 
+		 * \arg \c source The \c Matrix4 object to convert
+		 */
+		explicit Affine3(const Matrix4<Scalar> &source) :
+			values{source.values[0], source.values[1], source.values[2],
+				source.values[4], source.values[5], source.values[6],
+				source.values[8], source.values[9], source.values[10],
+				source.values[12], source.values[13], source.values[14]}
+		{ }
+		/**
+		 * \brief Construct an \c Affine3 object which is a copy of the given
+		 * \c Affine3 object.
+		 * \arg \c source The \c Affine3 object to copy
+		 */
+		Affine3(const Affine3<Scalar> &source) = default;
+		/**
+		 * \brief Construct an \c Affine3 object which is a conversion of the
+		 * given \c Affine3 object.
+		 * \arg \c source The \c Affine3 object to convert
+		 */
+		template <typename Other>
+		Affine3(const Affine3<Other> &source) {
+			for(std::size_t i = 0; i < 12; ++i) {
+				values[i] = static_cast<Scalar>(source.values[i]);
+			}
+		}
+		
+		~Affine3() = default;
+		
+		/**
+		 * \brief Assign values from the given \c Affine3 object.
+		 * \arg \c source The \c Affine3 to assign values from
+		 * \return A reference to the \c Affine3 object being assigned to
+		 */
+		Affine3<Scalar> & operator=(const Affine3<Scalar> &source) = default;
+		/**
+		 * \brief Assign converted values from the given \c Affine3 object.
+		 * \arg \c source The \c Affine3 to assign converted values from
+		 * \return A reference to the \c Affine3 object being assigned to
+		 */
+		template <typename Other>
+		Affine3<Scalar> & operator=(const Affine3<Other> &source) {
+			for(std::size_t i = 0; i < 12; ++i) {
+				values[i] = static_cast<Scalar>(source.values[i]);
+			}
+			return *this;
+		}
+		
+		/**
+		 * \brief Assign the result of multiplying this transformation by
+		 * another.
+		 * \arg \c rhs The transformation on the right side of the product
+		 * \return A reference to the \c Affine3 object being assigned to
+		 */
+		template <typename Other>
+		Affine3<Scalar> & operator*=(const Affine3<Other> &rhs) {
+			return *this = *this * rhs;
+		}
+		
+		/**
+		 * \brief Access the value at the given row and column.
+		 * \arg \c row The zero based row of the value, at most 2
+		 * \arg \c column The zero based column of the value, at most 3
+		 * \return A reference to the value
+		 */
+		Scalar & operator()(std::size_t row, std::size_t column) {
+			return values[column * 3 + row];
+		}
+		const Scalar & operator()(std::size_t row, std::size_t column) const {
+			return values[column * 3 + row];
+		}
+		
+		/**
+		 * \brief Get the linear part of the transformation.
+		 */
+		Matrix3<Scalar> linear() const {
+			return Matrix3<Scalar>(values[0], values[3], values[6],
+														 values[1], values[4], values[7],
+														 values[2], values[5], values[8]);
+		}
+		/**
+		 * \brief Get the translation of the transformation.
+		 */
+		Vector3<Scalar> translation() const {
+			return Vector3<Scalar>(values[9], values[10], values[11]);
+		}
+		/**
+		 * \brief Convert to a \c Matrix4 object with a bottom row of 0 0 0 1.
+		 */
+		Matrix4<Scalar> toMatrix4() const {
+			return Matrix4<Scalar>(values[0], values[3], values[6], values[9],
+														 values[1], values[4], values[7], values[10],
+														 values[2], values[5], values[8], values[11],
+														 0, 0, 0, 1);
+		}
+		
+		/**
+		 * \brief Construct an identity \c Affine3 object.
+		 */
+		static Affine3<Scalar> identity() {
+			return Affine3<Scalar>(1, 0, 0, 0,
+														 0, 1, 0, 0,
+														 0, 0, 1, 0);
+		}
+		/**
+		 * \brief Construct an \c Affine3 object which translates by the given
+		 * offset.
+		 * \arg \c offset The translation applied to points
+		 */
+		static Affine3<Scalar> translate(const Vector3<Scalar> &offset) {
+			return Affine3<Scalar>(1, 0, 0, offset.x,
+														 0, 1, 0, offset.y,
+														 0, 0, 1, offset.z);
+		}
+		/**
+		 * \brief Construct an \c Affine3 object which scales each axis by the
+		 * matching component of the given vector.
+		 * \arg \c factors The scale factors along x, y and z
+		 */
+		static Affine3<Scalar> scale(const Vector3<Scalar> &factors) {
+			return Affine3<Scalar>(factors.x, 0, 0, 0,
+														 0, factors.y, 0, 0,
+														 0, 0, factors.z, 0);
+		}
+		/**
+		 * \brief Construct an \c Affine3 object which scales uniformly.
+		 * \arg \c factor The scale factor along every axis
+		 */
+		static Affine3<Scalar> scale(Scalar factor) {
+			return scale(Vector3<Scalar>(factor, factor, factor));
+		}
+		/**
+		 * \brief Construct an \c Affine3 object which rotates about the given
+		 * axis, see \c Matrix4::rotate.
+		 * \arg \c angle The angle of rotation in radians
+		 * \arg \c axis The axis to rotate about
+		 */
+		static Affine3<Scalar> rotate(Scalar angle, const Vector3<Scalar> &axis) {
+			return Affine3<Scalar>(Matrix4<Scalar>::rotate(angle, axis));
+		}
+		
+		/**
+		 * \brief The array of values stored in the matrix.
+		 * 
+		 * The three columns of the linear part are followed by the translation,
+		 * so the value at row i and column j is at index \f$j*3+i\f$.
+		 */
+		Scalar values[12];
+	};
+	
+	typedef Affine3<std::int32_t> Affine3i;
+	typedef Affine3<std::uint32_t> Affine3u;
+	typedef Affine3<std::int64_t> Affine3l;
+	typedef Affine3<std::uint64_t> Affine3ul;
+	typedef Affine3<float> Affine3f;
+	typedef Affine3<double> Affine3d;
+	
+	namespace detail {
+		/*
+		 * As with Matrix4, the products are computed on transformations of a
+		 * single type and types with a Vector4Register hold each column in a
+		 * SIMD register; the fourth lane of those registers is unused. Both
+		 * versions sum every element in the same order as the Matrix4 product.
+		 *
+		 * Operands of the result type are passed through for the reason given
+		 * for convert4 in Matrix4.hpp.
+		 */
+		template <typename Result>
+		const Affine3<Result> & convertAffine(const Affine3<Result> &a) {
+			return a;
+		}
+		template <typename Result, typename Other>
+		typename std::enable_if<!std::is_same<Result,Other>::value,
+														Affine3<Result>>::type
+		convertAffine(const Affine3<Other> &a) {
+			return Affine3<Result>(a);
+		}
+		
+		template <typename S>
+		Scalar4<S,Affine3<S>> mulAffine(const Affine3<S> &a, const Affine3<S> &b)
+		{
+			const S *m = a.values, *c = b.values;
+			return Affine3<S>(
+				m[0] * c[0] + m[3] * c[1] + m[6] * c[2],
+				m[0] * c[3] + m[3] * c[4] + m[6] * c[5],
+				m[0] * c[6] + m[3] * c[7] + m[6] * c[8],
+				m[0] * c[9] + m[3] * c[10] + m[6] * c[11] + m[9],
+				m[1] * c[0] + m[4] * c[1] + m[7] * c[2],
+				m[1] * c[3] + m[4] * c[4] + m[7] * c[5],
+				m[1] * c[6] + m[4] * c[7] + m[7] * c[8],
+				m[1] * c[9] + m[4] * c[10] + m[7] * c[11] + m[10],
+				m[2] * c[0] + m[5] * c[1] + m[8] * c[2],
+				m[2] * c[3] + m[5] * c[4] + m[8] * c[5],
+				m[2] * c[6] + m[5] * c[7] + m[8] * c[8],
+				m[2] * c[9] + m[5] * c[10] + m[8] * c[11] + m[11]);
+		}
+		
+		template <typename S>
+		Scalar4<S,Point3<S>> mulAffinePoint(const Affine3<S> &a,
+																				const Point3<S> &p)
+		{
+			const S *m = a.values;
+			return Point3<S>(m[0] * p.x + m[3] * p.y + m[6] * p.z + m[9],
+											 m[1] * p.x + m[4] * p.y + m[7] * p.z + m[10],
+											 m[2] * p.x + m[5] * p.y + m[8] * p.z + m[11]);
+		}
+		
+#if defined(GEOM_SSE2)
+		template <typename S>
+		Packed4<S,Point3<S>> mulAffinePoint(const Affine3<S> &a,
+																				const Point3<S> &p)
+		{
+			typedef typename Vector4Register<S>::type Register;
+			const S *m = a.values;
+			Vector4<S> r;
+			store4(loadColumn4(m) * Register::set1(p.x) +
+						 loadColumn4(m + 3) * Register::set1(p.y) +
+						 loadColumn4(m + 6) * Register::set1(p.z), r);
+			return Point3<S>(r.x + m[9], r.y + m[10], r.z + m[11]);
+		}
+		
+		template <typename S>
+		Packed4<S,Affine3<S>> mulAffine(const Affine3<S> &a, const Affine3<S> &b)
+		{
+			typedef typename Vector4Register<S>::type Register;
+			const S *m = a.values, *c = b.values;
+			/* Reading four values from the third column stays within the array */
+			const Register l0 = loadColumn4(m);
+			const Register l1 = loadColumn4(m + 3);
+			const Register l2 = loadColumn4(m + 6);
+			alignas(32) S r[16];
+			for(std::size_t j = 0; j < 4; ++j) {
+				storeColumn4(l0 * Register::set1(c[j * 3]) +
+										 l1 * Register::set1(c[j * 3 + 1]) +
+										 l2 * Register::set1(c[j * 3 + 2]), r + j * 4);
+			}
+			return Affine3<S>(r[0], r[4], r[8], r[12] + m[9],
+												r[1], r[5], r[9], r[13] + m[10],
+												r[2], r[6], r[10], r[14] + m[11]);
+		}
+		
+		/*
+		 * For floats the twelve values fit three registers exactly, so the
+		 * columns are packed together with shuffles instead of going through
+		 * memory.
+		 */
+		inline Affine3<float> mulAffine(const Affine3<float> &a,
+																		const Affine3<float> &b)
+		{
+			typedef simd::Float4 F;
+			const float *m = a.values, *c = b.values;
+			const F l0 = F::load(m), l1 = F::load(m + 3), l2 = F::load(m + 6);
+			const F t = F::load(m + 8);
+			const F c0 = l0 * F::set1(c[0]) + l1 * F::set1(c[1]) +
+				l2 * F::set1(c[2]);
+			const F c1 = l0 * F::set1(c[3]) + l1 * F::set1(c[4]) +
+				l2 * F::set1(c[5]);
+			const F c2 = l0 * F::set1(c[6]) + l1 * F::set1(c[7]) +
+				l2 * F::set1(c[8]);
+			const F c3 = l0 * F::set1(c[9]) + l1 * F::set1(c[10]) +
+				l2 * F::set1(c[11]) + F(_mm_shuffle_ps(t.v, t.v, 0xF9));
+			/* [c0.x c0.y c0.z c1.x] [c1.y c1.z c2.x c2.y] [c2.z c3.x c3.y c3.z] */
+			const __m128 lo = _mm_shuffle_ps(c0.v, c1.v, 0x0A);
+			const __m128 hi = _mm_shuffle_ps(c2.v, c3.v, 0x0A);
+			Affine3<float> r;
+			_mm_storeu_ps(r.values, _mm_shuffle_ps(c0.v, lo, 0x84));
+			_mm_storeu_ps(r.values + 4, _mm_shuffle_ps(c1.v, c2.v, 0x49));
+			_mm_storeu_ps(r.values + 8, _mm_shuffle_ps(hi, c3.v, 0x98));
+			return r;
+		}
+#endif
+	}
+	
+	/**
+	 * \brief Test transformations element-wise for equality.
+	 * \arg \c lhs The transformation on the left of the equality operator.
+	 * \arg \c rhs The transformation on the right of the equality operator.
+	 * \return True if all elements are equal, false otherwise.
+	 */
+	template <typename LType, typename RType>
+	bool operator==(const Affine3<LType> &lhs, const Affine3<RType> &rhs) {
+		for(std::size_t i = 0; i < 12; ++i) {
+			if(!(lhs.values[i] == rhs.values[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+	
+	/**
+	 * \brief Test if two transformations are not equal.
+	 * \arg \c lhs The transformation on the left of the inequality operator.
+	 * \arg \c rhs The transformation on the right of the inequality operator.
+	 * \return True if any element is different, False otherwise.
+	 */
+	template <typename LType, typename RType>
+	bool operator!=(const Affine3<LType> &lhs, const Affine3<RType> &rhs) {
+		return !(lhs == rhs);
+	}
+	
+	/**
+	 * \brief Compose two \c Affine3 objects.
+	 * 
+	 * Each element is summed in the same order as the \c Matrix4 product, so
+	 * the results agree with it; only the products with the constant bottom
+	 * row are skipped.
+	 * 
+	 * \arg \c lhs The transformation on the left side of the product
+	 * \arg \c rhs The transformation on the right side of the product, which
+	 * is applied first
+	 * \return A new \c Affine3 object holding the composition
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Affine3<Result> operator*(const Affine3<LType> &lhs,
+														const Affine3<RType> &rhs)
+	{
+		return detail::mulAffine(detail::convertAffine<Result>(lhs),
+														 detail::convertAffine<Result>(rhs));
+	}
+	
+	/**
+	 * \brief Transform a \c Point3 object by an \c Affine3 object.
+	 * \arg \c lhs The transformation
+	 * \arg \c rhs The point to transform
+	 * \return A new \c Point3 object holding the transformed point
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Point3<Result> operator*(const Affine3<LType> &lhs, const Point3<RType> &rhs)
+	{
+		return detail::mulAffinePoint(detail::convertAffine<Result>(lhs),
+																	Point3<Result>(rhs));
+	}
+	
+	/**
+	 * \brief Transform a \c Vector3 object by an \c Affine3 object.
+	 * 
+	 * Only the linear part of the transformation affects vectors.
+	 * 
+	 * \arg \c lhs The transformation
+	 * \arg \c rhs The vector to transform
+	 * \return A new \c Vector3 object holding the transformed vector
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Vector3<Result> operator*(const Affine3<LType> &lhs,
+														const Vector3<RType> &rhs)
+	{
+		const LType *m = lhs.values;
+		return Vector3<Result>(m[0] * rhs.x + m[3] * rhs.y + m[6] * rhs.z,
+													 m[1] * rhs.x + m[4] * rhs.y + m[7] * rhs.z,
+													 m[2] * rhs.x + m[5] * rhs.y + m[8] * rhs.z);
+	}
+	
+	/**
+	 * \brief Invert an \c Affine3 object.
+	 * 
+	 * The linear part is inverted through its adjugate and the inverse
+	 * translation follows from it, which is far cheaper than inverting the
+	 * equivalent \c Matrix4. The linear part must not be singular; for
+	 * rotations and translations alone \c inverseRigid is cheaper still.
+	 * 
+	 * \arg \c a The transformation to invert, of a floating point type
+	 * \return A new \c Affine3 object undoing \c a
+	 */
+	template <typename Scalar>
+	Affine3<Scalar> inverse(const Affine3<Scalar> &a) {
+		const Matrix3<Scalar> l(inverse(a.linear()));
+		return Affine3<Scalar>(l, -(l * a.translation()));
+	}
+	
+	/**
+	 * \brief Invert an \c Affine3 object made only of rotations and
+	 * translations.
+	 * 
+	 * The inverse of a rotation is its transpose, so no division is needed.
+	 * The result is meaningless if \c a scales or shears.
+	 * 
+	 * \arg \c a The rigid transformation to invert
+	 * \return A new \c Affine3 object undoing \c a
+	 */
+	template <typename Scalar>
+	Affine3<Scalar> inverseRigid(const Affine3<Scalar> &a) {
+		const Matrix3<Scalar> r(transpose(a.linear()));
+		return Affine3<Scalar>(r, -(r * a.translation()));
+	}
+}
+
+#endif
@@ -0,0 +1,488 @@
+/**
+ * \file BatchTransform.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Transformation of arrays of points and vectors by one matrix
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_BATCH_TRANSFORM_HPP
+#define GEOM_BATCH_TRANSFORM_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include "Affine3.hpp"
+#include "Matrix3.hpp"
+#include "Matrix4.hpp"
+#include "Parallel.hpp"
+#include "Point3.hpp"
+#include "Point3SoA.hpp"
+#include "Simd.hpp"
+#include "Vector3.hpp"
+#include "Vector3SoA.hpp"
+#include "Vector4.hpp"
+
+namespace geom {
+	namespace detail {
+		/*
+		 * Array of structures kernels.
+		 *
+		 * Types with a Vector4Register keep the columns of the matrix in
+		 * registers and transform one element per iteration by scaling the
+		 * columns by its components; everything else applies the scalar
+		 * operator to each element. Both sum the columns in the order of the
+		 * scalar operators, so they produce identical results.
+		 */
+		template <typename S>
+		Scalar4<S,void> transformPoints4(const Matrix4<S> &m, const Point3<S> *in,
+																		 std::size_t n, Point3<S> *out)
+		{
+			for(std::size_t i = 0; i < n; ++i) {
+				out[i] = m * in[i];
+			}
+		}
+		template <typename S>
+		Scalar4<S,void> transformVectors4(const Matrix4<S> &m,
+																			const Vector4<S> *in, std::size_t n,
+																			Vector4<S> *out)
+		{
+			for(std::size_t i = 0; i < n; ++i) {
+				out[i] = m * in[i];
+			}
+		}
+		template <typename S>
+		Scalar4<S,void> transformVectors3(const Matrix3<S> &m,
+																			const Vector3<S> *in, std::size_t n,
+																			Vector3<S> *out)
+		{
+			for(std::size_t i = 0; i < n; ++i) {
+				out[i] = m * in[i];
+			}
+		}
+		
+#if defined(GEOM_SSE2)
+		template <typename S>
+		Packed4<S,void> transformPoints4(const Matrix4<S> &m, const Point3<S> *in,
+																		 std::size_t n, Point3<S> *out)
+		{
+			typedef typename Vector4Register<S>::type Register;
+			const Register c0 = loadColumn4(m.values);
+			const Register c1 = loadColumn4(m.values + 4);
+			const Register c2 = loadColumn4(m.values + 8);
+			const Register c3 = loadColumn4(m.values + 12);
+			Vector4<S> r;
+			for(std::size_t i = 0; i < n; ++i) {
+				const Point3<S> p = in[i];
+				store4(c0 * Register::set1(p.x) + c1 * Register::set1(p.y) +
+							 c2 * Register::set1(p.z) + c3, r);
+				out[i] = Point3<S>(r.x, r.y, r.z);
+			}
+		}
+		template <typename S>
+		Packed4<S,void> transformVectors4(const Matrix4<S> &m,
+																			const Vector4<S> *in, std::size_t n,
+																			Vector4<S> *out)
+		{
+			typedef typename Vector4Register<S>::type Register;
+			const Register c0 = loadColumn4(m.values);
+			const Register c1 = loadColumn4(m.values + 4);
+			const Register c2 = loadColumn4(m.values + 8);
+			const Register c3 = loadColumn4(m.values + 12);
+			Vector4<S> r;
+			for(std::size_t i = 0; i < n; ++i) {
+				const Vector4<S> v = in[i];
+				store4(c0 * Register::set1(v.x) + c1 * Register::set1(v.y) +
+							 c2 * Register::set1(v.z) + c3 * Register::set1(v.w), r);
+				out[i] = r;
+			}
+		}
+		template <typename S>
+		Packed4<S,void> transformVectors3(const Matrix3<S> &m,
+																			const Vector3<S> *in, std::size_t n,
+																			Vector3<S> *out)
+		{
+			typedef typename Vector4Register<S>::type Register;
+			/* Pad the columns so that whole registers can be loaded */
+			const S *v = m.values;
+			const S columns[12] = { v[0], v[1], v[2], 0, v[3], v[4], v[5], 0,
+															v[6], v[7], v[8], 0 };
+			const Register c0 = loadColumn4(columns);
+			const Register c1 = loadColumn4(columns + 4);
+			const Register c2 = loadColumn4(columns + 8);
+			Vector4<S> r;
+			for(std::size_t i = 0; i < n; ++i) {
+				const Vector3<S> p = in[i];
+				store4(c0 * Register::set1(p.x) + c1 * Register::set1(p.y) +
+							 c2 * Register::set1(p.z), r);
+				out[i] = Vector3<S>(r.x, r.y, r.z);
+			}
+		}
+#endif
+		
+		/*
+		 * Structure of arrays kernels.
+		 *
+		 * As with the kernels of Vector3SoA.hpp these return the number of
+		 * elements handled and the caller finishes the remainder with the
+		 * scalar operators. The matrix is broadcast into one register per
+		 * element, leaving the coordinates to stream through.
+		 */
+		template <typename S>
+		std::size_t transformPoints3(const Matrix4<S> &, const S *, const S *,
+																 const S *, std::size_t, S *, S *, S *)
+		{
+			return 0;
+		}
+		template <typename S>
+		std::size_t transformPoints3(const Affine3<S> &, const S *, const S *,
+																 const S *, std::size_t, S *, S *, S *)
+		{
+			return 0;
+		}
+		template <typename S>
+		std::size_t transformVectors3(const Matrix3<S> &, const S *, const S *,
+																	const S *, std::size_t, S *, S *, S *)
+		{
+			return 0;
+		}
+		
+#if defined(GEOM_SSE2)
+		/* Stride is the distance between columns, Translate adds the 4th one */
+		template <typename Pack, std::size_t Stride, bool Translate, typename S>
+		std::size_t packedTransform3(const S *m, const S *x, const S *y,
+																 const S *z, std::size_t n,
+																 S *ox, S *oy, S *oz)
+		{
+			const Pack m00 = Pack::set1(m[0]), m10 = Pack::set1(m[1]);
+			const Pack m20 = Pack::set1(m[2]);
+			const Pack m01 = Pack::set1(m[Stride]), m11 = Pack::set1(m[Stride + 1]);
+			const Pack m21 = Pack::set1(m[Stride + 2]);
+			const Pack m02 = Pack::set1(m[2 * Stride]);
+			const Pack m12 = Pack::set1(m[2 * Stride + 1]);
+			const Pack m22 = Pack::set1(m[2 * Stride + 2]);
+			const Pack t0 = Translate ? Pack::set1(m[3 * Stride]) : Pack::zero();
+			const Pack t1 = Translate ? Pack::set1(m[3 * Stride + 1]) : Pack::zero();
+			const Pack t2 = Translate ? Pack::set1(m[3 * Stride + 2]) : Pack::zero();
+			std::size_t i = 0;
+			for(; i + Pack::width <= n; i += Pack::width) {
+				const Pack vx = Pack::load(x + i);
+				const Pack vy = Pack::load(y + i);
+				const Pack vz = Pack::load(z + i);
+				Pack rx = m00 * vx + m01 * vy + m02 * vz;
+				Pack ry = m10 * vx + m11 * vy + m12 * vz;
+				Pack rz = m20 * vx + m21 * vy + m22 * vz;
+				if(Translate) {
+					rx = rx + t0;
+					ry = ry + t1;
+					rz = rz + t2;
+				}
+				rx.store(ox + i);
+				ry.store(oy + i);
+				rz.store(oz + i);
+			}
+			return i;
+		}
+		
+		inline std::size_t transformPoints3(const Matrix4<float> &m,
+																				const float *x, const float *y,
+																				const float *z, std::size_t n,
+																				float *ox, float *oy, float *oz)
+		{
+			return packedTransform3<simd::Pack<float>::type, 4, true>(
+				m.values, x, y, z, n, ox, oy, oz);
+		}
+		inline std::size_t transformPoints3(const Matrix4<double> &m,
+																				const double *x, const double *y,
+																				const double *z, std::size_t n,
+																				double *ox, double *oy, double *oz)
+		{
+			return packedTransform3<simd::Pack<double>::type, 4, true>(
+				m.values, x, y, z, n, ox, oy, oz);
+		}
+		inline std::size_t transformPoints3(const Affine3<float> &m,
+																				const float *x, const float *y,
+																				const float *z, std::size_t n,
+																				float *ox, float *oy, float *oz)
+		{
+			return packedTransform3<simd::Pack<float>::type, 3, true>(
+				m.values, x, y, z, n, ox, oy, oz);
+		}
+		inline std::size_t transformPoints3(const Affine3<double> &m,
+																				const double *x, const double *y,
+																				const double *z, std::size_t n,
+																				double *ox, double *oy, double *oz)
+		{
+			return packedTransform3<simd::Pack<double>::type, 3, true>(
+				m.values, x, y, z, n, ox, oy, oz);
+		}
+		inline std::size_t transformVectors3(const Matrix3<float> &m,
+																				 const float *x, const float *y,
+																				 const float *z, std::size_t n,
+																				 float *ox, float *oy, float *oz)
+		{
+			return packedTransform3<simd::Pack<float>::type, 3, false>(
+				m.values, x, y, z, n, ox, oy, oz);
+		}
+		inline std::size_t transformVectors3(const Matrix3<double> &m,
+																				 const double *x, const double *y,
+																				 const double *z, std::size_t n,
+																				 double *ox, double *oy, double *oz)
+		{
+			return packedTransform3<simd::Pack<double>::type, 3, false>(
+				m.values, x, y, z, n, ox, oy, oz);
+		}
+#endif
+	}
+	
+	/*
+	 * Batch transformations.
+	 *
+	 * Each kernel applies one matrix to every element of its input, giving
+	 * the same results as the scalar operators of Matrix3.hpp, Matrix4.hpp and
+	 * Affine3.hpp applied one element at a time. The output must hold at
+	 * least as many elements as the input. Transforming in place is done by
+	 * passing the same array or view as input and output; inputs and outputs
+	 * must not otherwise overlap.
+	 *
+	 * The optional \c Parallel argument splits arrays over its threshold
+	 * between several threads, see Parallel.hpp.
+	 */
+	
+	/**
+	 * \brief Transform an array of points by a \c Matrix4.
+	 *
+	 * As with the product of a \c Matrix4 and a \c Point3, the points are
+	 * extended with a w coordinate of 1 and the w coordinate of the results is
+	 * discarded.
+	 *
+	 * \arg \c m The transformation matrix.
+	 * \arg \c in The points to transform.
+	 * \arg \c count The number of points.
+	 * \arg \c out The array receiving the transformed points.
+	 * \arg \c parallel Options for running on several threads.
+	 */
+	template <typename Scalar>
+	void transformPoints(const Matrix4<Scalar> &m, const Point3<Scalar> *in,
+											 std::size_t count, Point3<Scalar> *out,
+											 const Parallel &parallel = Parallel::serial())
+	{
+		detail::parallelFor(count, parallel,
+												[&](std::size_t first, std::size_t n) {
+													detail::transformPoints4(m, in + first, n,
+																									 out + first);
+												});
+	}
+	
+	/**
+	 * \brief Transform a view of points by a \c Matrix4.
+	 * \arg \c m The transformation matrix.
+	 * \arg \c in The points to transform.
+	 * \arg \c out The view receiving the transformed points.
+	 * \arg \c parallel Options for running on several threads.
+	 */
+	template <typename Scalar, typename InScalar>
+	void transformPoints(const Matrix4<Scalar> &m, Point3Span<InScalar> in,
+											 Point3Span<Scalar> out,
+											 const Parallel &parallel = Parallel::serial())
+	{
+		static_assert(std::is_same<typename Point3Span<InScalar>::type,
+															 Scalar>::value,
+									"The points must have the scalar type of the matrix");
+		detail::parallelFor(in.count, parallel,
+												[&](std::size_t first, std::size_t n) {
+			const Point3Span<InScalar> s = in.subspan(first, n);
+			const Point3Span<Scalar> o = out.subspan(first, n);
+			std::size_t i = detail::transformPoints3(m, s.x, s.y, s.z, n,
+																							 o.x, o.y, o.z);
+			for(; i < n; ++i) {
+				const Point3<Scalar> r(m * Point3<Scalar>(s.x[i], s.y[i], s.z[i]));
+				o.x[i] = r.x;
+				o.y[i] = r.y;
+				o.z[i] = r.z;
+			}
+		});
+	}
+	
+	/**
+	 * \brief Transform an array of points by an \c Affine3.
+	 * \arg \c m The transformation.
+	 * \arg \c in The points to transform.
+	 * \arg \c count The number of points.
+	 * \arg \c out The array receiving the transformed points.
+	 * \arg \c parallel Options for running on several threads.
+	 */
+	template <typename Scalar>
+	void transformPoints(const Affine3<Scalar> &m, const Point3<Scalar> *in,
+											 std::size_t count, Point3<Scalar> *out,
+											 const Parallel &parallel = Parallel::serial())
+	{
+		detail::parallelFor(count, parallel,
+												[&](std::size_t first, std::size_t n) {
+													for(std::size_t i = first; i < first + n; ++i) {
+														out[i] = m * in[i];
+													}
+												});
+	}
+	
+	/**
+	 * \brief Transform a view of points by an \c Affine3.
+	 * \arg \c m The transformation.
+	 * \arg \c in The points to transform.
+	 * \arg \c out The view receiving the transformed points.
+	 * \arg \c parallel Options for running on several threads.
+	 */
+	template <typename Scalar, typename InScalar>
+	void transformPoints(const Affine3<Scalar> &m, Point3Span<InScalar> in,
+											 Point3Span<Scalar> out,
+											 const Parallel &parallel = Parallel::serial())
+	{
+		static_assert(std::is_same<typename Point3Span<InScalar>::type,
+															 Scalar>::value,
+									"The points must have the scalar type of the matrix");
+		detail::parallelFor(in.count, parallel,
+												[&](std::size_t first, std::size_t n) {
+			const Point3Span<InScalar> s = in.subspan(first, n);
+			const Point3Span<Scalar> o = out.subspan(first, n);
+			std::size_t i = detail::transformPoints3(m, s.x, s.y, s.z, n,
+																							 o.x, o.y, o.z);
+			for(; i < n; ++i) {
+				const Point3<Scalar> r(m * Point3<Scalar>(s.x[i], s.y[i], s.z[i]));
+				o.x[i] = r.x;
+				o.y[i] = r.y;
+				o.z[i] = r.z;
+			}
+		});
+	}
+	
+	/**
+	 * \brief Transform an array of \c Vector4 objects by a \c Matrix4.
+	 * \arg \c m The transformation matrix.
+	 * \arg \c in The vectors to transform.
+	 * \arg \c count The number of vectors.
+	 * \arg \c out The array receiving the transformed vectors.
+	 * \arg \c parallel Options for running on several threads.
+	 */
+	template <typename Scalar>
+	void transformVectors(const Matrix4<Scalar> &m, const Vector4<Scalar> *in,
+												std::size_t count, Vector4<Scalar> *out,
+												const Parallel &parallel = Parallel::serial())
+	{
+		detail::parallelFor(count, parallel,
+												[&](std::size_t first, std::size_t n) {
+													detail::transformVectors4(m, in + first, n,
+																										out + first);
+												});
+	}
+	
+	/**
+	 * \brief Transform an array of \c Vector3 objects by a \c Matrix3.
+	 * \arg \c m The transformation matrix.
+	 * \arg \c in The vectors to transform.
+	 * \arg \c count The number of vectors.
+	 * \arg \c out The array receiving the transformed vectors.
+	 * \arg \c parallel Options for running on several threads.
+	 */
+	template <typename Scalar>
+	void transformVectors(const Matrix3<Scalar> &m, const Vector3<Scalar> *in,
+												std::size_t count, Vector3<Scalar> *out,
+												const Parallel &parallel = Parallel::serial())
+	{
+		detail::parallelFor(count, parallel,
+												[&](std::size_t first, std::size_t n) {
+													detail::transformVectors3(m, in + first, n,
+																										out + first);
+												});
+	}
+	
+	/**
+	 * \brief Transform a view of vectors by a \c Matrix3.
+	 * \arg \c m The transformation matrix.
+	 * \arg \c in The vectors to transform.
+	 * \arg \c out The view receiving the transformed vectors.
+	 * \arg \c parallel Options for running on several threads.
+	 */
+	template <typename Scalar, typename InScalar>
+	void transformVectors(const Matrix3<Scalar> &m, Vector3Span<InScalar> in,
+												Vector3Span<Scalar> out,
+												const Parallel &parallel = Parallel::serial())
+	{
+		static_assert(std::is_same<typename Vector3Span<InScalar>::type,
+															 Scalar>::value,
+									"The vectors must have the scalar type of the matrix");
+		detail::parallelFor(in.count, parallel,
+												[&](std::size_t first, std::size_t n) {
+			const Vector3Span<InScalar> s = in.subspan(first, n);
+			const Vector3Span<Scalar> o = out.subspan(first, n);
+			std::size_t i = detail::transformVectors3(m, s.x, s.y, s.z, n,
+																								o.x, o.y, o.z);
+			for(; i < n; ++i) {
+				const Vector3<Scalar> r(m * Vector3<Scalar>(s.x[i], s.y[i], s.z[i]));
+				o.x[i] = r.x;
+				o.y[i] = r.y;
+				o.z[i] = r.z;
+			}
+		});
+	}
+	
+	/**
+	 * \brief Invert an array of \c Matrix4 objects of the same kind.
+	 * 
+	 * Each matrix is inverted as by \c inverse(m, kind). Inverting in place
+	 * is allowed.
+	 * 
+	 * \arg \c in The matrices to invert.
+	 * \arg \c count The number of matrices.
+	 * \arg \c out The array receiving the inverses.
+	 * \arg \c kind The kind shared by every matrix, see \c classify.
+	 * \arg \c parallel Options for running on several threads.
+	 */
+	template <typename Scalar>
+	void inverse(const Matrix4<Scalar> *in, std::size_t count,
+							 Matrix4<Scalar> *out, MatrixKind kind = MatrixKind::General,
+							 const Parallel &parallel = Parallel::serial())
+	{
+		detail::parallelFor(count, parallel,
+												[&](std::size_t first, std::size_t n) {
+			/* Branch once per range rather than once per matrix */
+			switch(kind) {
+			case MatrixKind::Rigid:
+				for(std::size_t i = first; i < first + n; ++i) {
+					detail::inverseRigid44(in[i], out[i]);
+				}
+				break;
+			case MatrixKind::Affine:
+				for(std::size_t i = first; i < first + n; ++i) {
+					detail::inverseAffine44(in[i], out[i]);
+				}
+				break;
+			default:
+				for(std::size_t i = first; i < first + n; ++i) {
+					detail::inverse44(in[i], out[i]);
+				}
+				break;
+			}
+		});
+	}
+}
+
+#endif
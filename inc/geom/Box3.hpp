@@ -0,0 +1,529 @@
+/**
+ * \file Box3.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Axis-aligned boxes and batch ray-box slab tests
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_BOX_3_HPP
+#define GEOM_BOX_3_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "Dimensions3.hpp"
+#include "Point3.hpp"
+#include "Point3SoA.hpp"
+#include "Ray3.hpp"
+#include "Simd.hpp"
+#include "Vector3SoA.hpp"
+
+namespace geom {
+	/**
+	 * \brief An axis-aligned box in 3 dimensional space, given by its minimum
+	 * and maximum corners.
+	 *
+	 * The box is closed, containing the points on its faces. A box whose
+	 * minimum exceeds its maximum along any axis is empty; the default box is
+	 * empty in a way that joining any point or box to it gives that point or
+	 * box, so bounds can be accumulated starting from it.
+	 */
+	template <typename Scalar>
+	struct Box3 {
+		/**
+		 * \brief Construct an empty \c Box3 object.
+		 */
+		constexpr Box3() :
+			min(std::numeric_limits<Scalar>::max(),
+					std::numeric_limits<Scalar>::max(),
+					std::numeric_limits<Scalar>::max()),
+			max(std::numeric_limits<Scalar>::lowest(),
+					std::numeric_limits<Scalar>::lowest(),
+					std::numeric_limits<Scalar>::lowest())
+		{ }
+		/**
+		 * \brief Construct a \c Box3 object from its corners.
+		 * \arg \c min The minimum corner
+		 * \arg \c max The maximum corner
+		 */
+		constexpr Box3(const Point3<Scalar> &min, const Point3<Scalar> &max) :
+			min(min), max(max)
+		{ }
+		/**
+		 * \brief Construct a \c Box3 object from its minimum corner and
+		 * dimensions, as the boxes culled in Frustum.hpp.
+		 * \arg \c origin The minimum corner
+		 * \arg \c dim The dimensions along x, y and z
+		 */
+		constexpr Box3(const Point3<Scalar> &origin,
+									 const Dimensions3<Scalar> &dim) :
+			min(origin),
+			max(origin.x + dim.width, origin.y + dim.height, origin.z + dim.depth)
+		{ }
+		/**
+		 * \brief Construct a \c Box3 object which is a conversion of the given
+		 * \c Box3 object.
+		 * \arg \c source The \c Box3 object to convert
+		 */
+		template <typename Other>
+		constexpr Box3(const Box3<Other> &source) :
+			min(source.min), max(source.max)
+		{ }
+		
+		Point3<Scalar> min; /**< The minimum corner */
+		Point3<Scalar> max; /**< The maximum corner */
+	};
+	
+	typedef Box3<std::int32_t> Box3i;
+	typedef Box3<std::uint32_t> Box3u;
+	typedef Box3<std::int64_t> Box3l;
+	typedef Box3<std::uint64_t> Box3ul;
+	typedef Box3<float> Box3f;
+	typedef Box3<double> Box3d;
+	
+	/**
+	 * \brief Compare two boxes for equality of their corners.
+	 */
+	template <typename LType, typename RType>
+	bool operator==(const Box3<LType> &lhs, const Box3<RType> &rhs) {
+		return lhs.min.x == rhs.min.x && lhs.min.y == rhs.min.y &&
+			lhs.min.z == rhs.min.z && lhs.max.x == rhs.max.x &&
+			lhs.max.y == rhs.max.y && lhs.max.z == rhs.max.z;
+	}
+	/**
+	 * \brief Compare two boxes for inequality of their corners.
+	 */
+	template <typename LType, typename RType>
+	bool operator!=(const Box3<LType> &lhs, const Box3<RType> &rhs) {
+		return !(lhs == rhs);
+	}
+	
+	/**
+	 * \brief Test whether a box contains no points.
+	 * \arg \c box The box to test
+	 * \return True if the minimum exceeds the maximum along any axis
+	 */
+	template <typename Scalar>
+	bool empty(const Box3<Scalar> &box) {
+		return box.min.x > box.max.x || box.min.y > box.max.y ||
+			box.min.z > box.max.z;
+	}
+	
+	/**
+	 * \brief Get the smallest box containing two boxes, their union.
+	 * \arg \c a The first box
+	 * \arg \c b The second box
+	 * \return The box bounding both a and b
+	 */
+	template <typename Scalar>
+	Box3<Scalar> join(const Box3<Scalar> &a, const Box3<Scalar> &b) {
+		return Box3<Scalar>(
+			Point3<Scalar>(a.min.x < b.min.x ? a.min.x : b.min.x,
+										 a.min.y < b.min.y ? a.min.y : b.min.y,
+										 a.min.z < b.min.z ? a.min.z : b.min.z),
+			Point3<Scalar>(a.max.x > b.max.x ? a.max.x : b.max.x,
+										 a.max.y > b.max.y ? a.max.y : b.max.y,
+										 a.max.z > b.max.z ? a.max.z : b.max.z));
+	}
+	/**
+	 * \brief Get the smallest box containing a box and a point.
+	 * \arg \c box The box
+	 * \arg \c p The point
+	 * \return The box bounding both box and p
+	 */
+	template <typename Scalar>
+	Box3<Scalar> join(const Box3<Scalar> &box, const Point3<Scalar> &p) {
+		return join(box, Box3<Scalar>(p, p));
+	}
+	
+	/**
+	 * \brief Get the intersection of two boxes.
+	 * \arg \c a The first box
+	 * \arg \c b The second box
+	 * \return The box of the points in both a and b, which is empty if they
+	 * do not overlap
+	 */
+	template <typename Scalar>
+	Box3<Scalar> intersection(const Box3<Scalar> &a, const Box3<Scalar> &b) {
+		return Box3<Scalar>(
+			Point3<Scalar>(a.min.x > b.min.x ? a.min.x : b.min.x,
+										 a.min.y > b.min.y ? a.min.y : b.min.y,
+										 a.min.z > b.min.z ? a.min.z : b.min.z),
+			Point3<Scalar>(a.max.x < b.max.x ? a.max.x : b.max.x,
+										 a.max.y < b.max.y ? a.max.y : b.max.y,
+										 a.max.z < b.max.z ? a.max.z : b.max.z));
+	}
+	/**
+	 * \brief Test whether two boxes have a point in common.
+	 * \arg \c a The first box
+	 * \arg \c b The second box
+	 * \return True if the intersection of a and b is not empty
+	 */
+	template <typename Scalar>
+	bool overlaps(const Box3<Scalar> &a, const Box3<Scalar> &b) {
+		return !empty(intersection(a, b));
+	}
+	
+	/**
+	 * \brief Test whether a point lies in a box or on its faces.
+	 */
+	template <typename Scalar>
+	bool contains(const Box3<Scalar> &box, const Point3<Scalar> &p) {
+		return box.min.x <= p.x && p.x <= box.max.x &&
+			box.min.y <= p.y && p.y <= box.max.y &&
+			box.min.z <= p.z && p.z <= box.max.z;
+	}
+	/**
+	 * \brief Test whether a box lies within another, which holds for any
+	 * empty inner box.
+	 * \arg \c box The outer box
+	 * \arg \c inner The box to test
+	 */
+	template <typename Scalar>
+	bool contains(const Box3<Scalar> &box, const Box3<Scalar> &inner) {
+		return empty(inner) || (contains(box, inner.min) &&
+														contains(box, inner.max));
+	}
+	
+	/**
+	 * \brief Get the size of a box along each axis.
+	 * \arg \c box A box which is not empty
+	 */
+	template <typename Scalar>
+	Dimensions3<Scalar> dimensions(const Box3<Scalar> &box) {
+		return Dimensions3<Scalar>(box.max.x - box.min.x, box.max.y - box.min.y,
+															 box.max.z - box.min.z);
+	}
+	/**
+	 * \brief Get the surface area of a box, as used by the surface area
+	 * heuristic of bounding volume hierarchies.
+	 * \return The area of the six faces, zero for an empty box
+	 */
+	template <typename Scalar>
+	Scalar surfaceArea(const Box3<Scalar> &box) {
+		if(empty(box)) {
+			return Scalar(0);
+		}
+		const Dimensions3<Scalar> d = dimensions(box);
+		return 2 * (d.width * d.height + d.height * d.depth +
+								d.depth * d.width);
+	}
+	/**
+	 * \brief Get the volume of a box.
+	 * \return The volume, zero for an empty box
+	 */
+	template <typename Scalar>
+	Scalar volume(const Box3<Scalar> &box) {
+		if(empty(box)) {
+			return Scalar(0);
+		}
+		const Dimensions3<Scalar> d = dimensions(box);
+		return d.width * d.height * d.depth;
+	}
+	
+	namespace detail {
+		/*
+		 * The slab test of P::width rays against P::width boxes. The ray
+		 * enters the box at the last of its entries into the x, y and z slabs
+		 * and leaves at the first exit. A zero direction component has an
+		 * infinite inverse, giving infinite slab distances of the right signs
+		 * unless the origin lies on a face plane, where 0 * inf is NaN. The
+		 * operand order of min and max makes such NaN distances drop out in
+		 * both the packed and Single versions, see Simd.hpp.
+		 */
+		template <typename P>
+		auto slab(P ox, P oy, P oz, P ix, P iy, P iz, P minx, P miny, P minz,
+							P maxx, P maxy, P maxz, P tMax, P &t) -> decltype(P() <= P())
+		{
+			using simd::min;
+			using simd::max;
+			const P x0 = (minx - ox) * ix, x1 = (maxx - ox) * ix;
+			const P y0 = (miny - oy) * iy, y1 = (maxy - oy) * iy;
+			const P z0 = (minz - oz) * iz, z1 = (maxz - oz) * iz;
+			P enter = max(min(x0, x1), P::zero());
+			enter = max(min(y0, y1), enter);
+			enter = max(min(z0, z1), enter);
+			P exit = min(max(x0, x1), tMax);
+			exit = min(max(y0, y1), exit);
+			exit = min(max(z0, z1), exit);
+			typedef typename P::type S;
+			const P miss = P::set1(std::numeric_limits<S>::infinity());
+			const auto hit = enter <= exit;
+			t = simd::select(hit, enter, miss);
+			return hit;
+		}
+		
+		/*
+		 * A ray with the inverses of its direction components, which are
+		 * broadcast to every lane.
+		 */
+		template <typename S>
+		struct InverseRay {
+			InverseRay(const Ray3<S> &ray, S tMax) :
+				ox(ray.origin.x), oy(ray.origin.y), oz(ray.origin.z),
+				ix(S(1) / ray.direction.x), iy(S(1) / ray.direction.y),
+				iz(S(1) / ray.direction.z), tMax(tMax)
+			{ }
+			
+			S ox, oy, oz, ix, iy, iz, tMax;
+		};
+		
+		/*
+		 * The sources of ray-box pairs below test the P::width pairs from
+		 * index i, setting their entry distances and returning a hit mask.
+		 */
+		template <typename S>
+		struct RayBoxArrays {
+			InverseRay<S> r;
+			const S *minx, *miny, *minz, *maxx, *maxy, *maxz;
+			
+			template <typename P>
+			auto hit(std::size_t i, P &t) const -> decltype(P() <= P()) {
+				return slab(P::set1(r.ox), P::set1(r.oy), P::set1(r.oz),
+										P::set1(r.ix), P::set1(r.iy), P::set1(r.iz),
+										P::load(minx + i), P::load(miny + i), P::load(minz + i),
+										P::load(maxx + i), P::load(maxy + i), P::load(maxz + i),
+										P::set1(r.tMax), t);
+			}
+		};
+		/*
+		 * Box3 objects are loaded one corner coordinate of P::width
+		 * consecutive boxes per register.
+		 */
+		template <typename S>
+		struct RayBoxObjects {
+			InverseRay<S> r;
+			const Box3<S> *boxes;
+			
+			template <typename P>
+			auto hit(std::size_t i, P &t) const -> decltype(P() <= P()) {
+				const std::size_t b = sizeof(Box3<S>) / sizeof(S);
+				const Box3<S> &box = boxes[i];
+				return slab(P::set1(r.ox), P::set1(r.oy), P::set1(r.oz),
+										P::set1(r.ix), P::set1(r.iy), P::set1(r.iz),
+										P::load(&box.min.x, b), P::load(&box.min.y, b),
+										P::load(&box.min.z, b), P::load(&box.max.x, b),
+										P::load(&box.max.y, b), P::load(&box.max.z, b),
+										P::set1(r.tMax), t);
+			}
+		};
+		/*
+		 * A packet of rays against one box, tested P::width rays from index i
+		 * at a time.
+		 */
+		template <typename S>
+		struct RayPacket {
+			const S *ox, *oy, *oz, *dx, *dy, *dz, *tMax;
+			S minx, miny, minz, maxx, maxy, maxz;
+			
+			template <typename P>
+			auto hit(std::size_t i, P &t) const -> decltype(P() <= P()) {
+				const P one = P::set1(S(1));
+				return slab(P::load(ox + i), P::load(oy + i), P::load(oz + i),
+										one / P::load(dx + i), one / P::load(dy + i),
+										one / P::load(dz + i), P::set1(minx), P::set1(miny),
+										P::set1(minz), P::set1(maxx), P::set1(maxy),
+										P::set1(maxz), P::load(tMax + i), t);
+			}
+		};
+		
+		/*
+		 * Test the pairs [first, n) of a whole pack at a time, returning the
+		 * index of the first pair not handled. The bits are set as by
+		 * cullPacked in Frustum.hpp: bit i % 32 of word i / 32, with each word
+		 * cleared by its first pair.
+		 */
+		template <typename P, typename Pairs, typename S>
+		std::size_t slabPacked(const Pairs &pairs, std::size_t first,
+													 std::size_t n, S *t, std::uint32_t *hits)
+		{
+			std::size_t i = first;
+			for(; i + P::width <= n; i += P::width) {
+				P d;
+				const std::uint32_t bits = simd::movemask(
+					pairs.template hit<P>(i, d));
+				d.store(t + i);
+				if(i % 32 == 0) {
+					hits[i / 32] = bits;
+				} else {
+					hits[i / 32] |= bits << (i % 32);
+				}
+			}
+			return i;
+		}
+		
+		template <typename Pairs, typename S>
+		std::size_t slabBatch(const Pairs &, std::size_t, S *, std::uint32_t *)
+		{
+			return 0;
+		}
+#if defined(GEOM_SSE2)
+		template <typename Pairs>
+		std::size_t slabBatch(const Pairs &pairs, std::size_t n, float *t,
+													std::uint32_t *hits)
+		{
+			return slabPacked<simd::Pack<float>::type>(pairs, 0, n, t, hits);
+		}
+		template <typename Pairs>
+		std::size_t slabBatch(const Pairs &pairs, std::size_t n, double *t,
+													std::uint32_t *hits)
+		{
+			return slabPacked<simd::Pack<double>::type>(pairs, 0, n, t, hits);
+		}
+#endif
+		
+		template <typename S, typename Pairs>
+		void slabs(const Pairs &pairs, std::size_t n, S *t, std::uint32_t *hits) {
+			const std::size_t i = slabBatch(pairs, n, t, hits);
+			slabPacked<simd::Single<S>>(pairs, i, n, t, hits);
+		}
+	}
+	
+	/**
+	 * \brief Intersect a ray with a box by the slab test.
+	 *
+	 * A ray whose origin lies in the box hits it at distance zero. Rays lying
+	 * exactly in the plane of a face, with a zero direction component, may be
+	 * reported either way.
+	 *
+	 * \arg \c ray The ray
+	 * \arg \c box The box
+	 * \arg \c t Receives the distance along the ray at which it enters the
+	 * box, or infinity if it misses
+	 * \arg \c tMax The distance beyond which hits are ignored
+	 * \return True if the ray enters the box between 0 and tMax
+	 */
+	template <typename Scalar>
+	bool intersect(const Ray3<Scalar> &ray, const Box3<Scalar> &box,
+								 Scalar &t,
+								 Scalar tMax = std::numeric_limits<Scalar>::infinity())
+	{
+		static_assert(std::is_floating_point<Scalar>::value,
+									"The slab test needs a floating point type");
+		const detail::RayBoxObjects<Scalar> pair = {
+			detail::InverseRay<Scalar>(ray, tMax), &box
+		};
+		simd::Single<Scalar> d;
+		const bool hit = pair.template hit<simd::Single<Scalar>>(0, d);
+		t = d.v;
+		return hit;
+	}
+	
+	/*
+	 * Batch slab tests.
+	 *
+	 * Each kernel tests the pairs of a ray and a box of its input as by the
+	 * single \c intersect, writing the entry distance of pair i to t[i] and
+	 * a hit bitmask: bit i % 32 of word i / 32 is set when the ray hits the
+	 * box. The mask must hold (count + 31) / 32 words; unused bits of the
+	 * last word are cleared. Float and double pairs are tested 4 or 8 at a
+	 * time with SSE/AVX instructions, see Simd.hpp, so testing the children
+	 * of a 4 or 8 wide bounding volume hierarchy node is a single step.
+	 */
+	
+	/**
+	 * \brief Intersect one ray with an array of boxes.
+	 * \arg \c ray The ray
+	 * \arg \c boxes The boxes
+	 * \arg \c count The number of boxes
+	 * \arg \c tMax The distance beyond which hits are ignored
+	 * \arg \c t Receives the entry distance into each box
+	 * \arg \c hits The bitmask receiving whether the ray hits each box
+	 */
+	template <typename Scalar>
+	void intersect(const Ray3<Scalar> &ray, const Box3<Scalar> *boxes,
+								 std::size_t count, Scalar tMax, Scalar *t,
+								 std::uint32_t *hits)
+	{
+		static_assert(std::is_floating_point<Scalar>::value,
+									"The slab test needs a floating point type");
+		const detail::RayBoxObjects<Scalar> pairs = {
+			detail::InverseRay<Scalar>(ray, tMax), boxes
+		};
+		detail::slabs(pairs, count, t, hits);
+	}
+	
+	/**
+	 * \brief Intersect one ray with boxes held as arrays of corner
+	 * coordinates, which is the fastest form to test.
+	 * \arg \c ray The ray
+	 * \arg \c mins The minimum corner of each box
+	 * \arg \c maxs The maximum corner of each box, at least as many as there
+	 * are minimum corners
+	 * \arg \c tMax The distance beyond which hits are ignored
+	 * \arg \c t Receives the entry distance into each box
+	 * \arg \c hits The bitmask receiving whether the ray hits each box
+	 */
+	template <typename Scalar, typename MinScalar, typename MaxScalar>
+	void intersect(const Ray3<Scalar> &ray, Point3Span<MinScalar> mins,
+								 Point3Span<MaxScalar> maxs, Scalar tMax, Scalar *t,
+								 std::uint32_t *hits)
+	{
+		static_assert(std::is_floating_point<Scalar>::value,
+									"The slab test needs a floating point type");
+		static_assert(std::is_same<typename Point3Span<MinScalar>::type,
+															 Scalar>::value &&
+									std::is_same<typename Point3Span<MaxScalar>::type,
+															 Scalar>::value,
+									"The boxes must have the scalar type of the ray");
+		const detail::RayBoxArrays<Scalar> pairs = {
+			detail::InverseRay<Scalar>(ray, tMax), mins.x, mins.y, mins.z,
+			maxs.x, maxs.y, maxs.z
+		};
+		detail::slabs(pairs, mins.count, t, hits);
+	}
+	
+	/**
+	 * \brief Intersect a packet of rays with one box.
+	 * \arg \c origins The origin of each ray
+	 * \arg \c directions The direction of each ray, at least as many as
+	 * there are origins
+	 * \arg \c box The box
+	 * \arg \c tMax The distance beyond which hits of each ray are ignored
+	 * \arg \c t Receives the entry distance of each ray into the box
+	 * \arg \c hits The bitmask receiving whether each ray hits the box
+	 */
+	template <typename Scalar, typename OScalar, typename DScalar>
+	void intersect(Point3Span<OScalar> origins, Vector3Span<DScalar> directions,
+								 const Box3<Scalar> &box, const Scalar *tMax, Scalar *t,
+								 std::uint32_t *hits)
+	{
+		static_assert(std::is_floating_point<Scalar>::value,
+									"The slab test needs a floating point type");
+		static_assert(std::is_same<typename Point3Span<OScalar>::type,
+															 Scalar>::value &&
+									std::is_same<typename Vector3Span<DScalar>::type,
+															 Scalar>::value,
+									"The rays must have the scalar type of the box");
+		const detail::RayPacket<Scalar> pairs = {
+			origins.x, origins.y, origins.z, directions.x, directions.y,
+			directions.z, tMax, box.min.x, box.min.y, box.min.z, box.max.x,
+			box.max.y, box.max.z
+		};
+		detail::slabs(pairs, origins.count, t, hits);
+	}
+}
+
+#endif
@@ -0,0 +1,365 @@
+/**
+ * \file ConvexHull.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Convex hulls of sets of points in the plane
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_CONVEX_HULL_HPP
+#define GEOM_CONVEX_HULL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "Parallel.hpp"
+#include "Point2.hpp"
+#include "Predicates.hpp"
+#include "Simd.hpp"
+
+namespace geom {
+	namespace detail {
+		/* The order of points by x then y */
+		template <typename S>
+		bool lexicographicLess(const Point2<S> &a, const Point2<S> &b) {
+			return a.x < b.x || (a.x == b.x && a.y < b.y);
+		}
+		template <typename S>
+		bool samePoint(const Point2<S> &a, const Point2<S> &b) {
+			return a.x == b.x && a.y == b.y;
+		}
+		
+		/*
+		 * Andrew's monotone chain: the lower hull is built from the points
+		 * sorted by x then y and the upper hull from the points in reverse,
+		 * popping the last hull vertex while it does not make a strict left
+		 * turn. The points are sorted in place.
+		 */
+		template <typename S>
+		void monotoneChain(std::vector<Point2<S>> &points,
+											 std::vector<Point2<S>> &hull)
+		{
+			std::sort(points.begin(), points.end(), lexicographicLess<S>);
+			points.erase(std::unique(points.begin(), points.end(), samePoint<S>),
+									 points.end());
+			const std::size_t n = points.size();
+			if(n < 3) {
+				hull = points;
+				return;
+			}
+			hull.resize(2 * n);
+			std::size_t k = 0;
+			for(std::size_t i = 0; i < n; ++i) {
+				while(k >= 2 && orient2d(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+					--k;
+				}
+				hull[k++] = points[i];
+			}
+			for(std::size_t i = n - 1, lower = k + 1; i-- > 0;) {
+				while(k >= lower &&
+							orient2d(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+					--k;
+				}
+				hull[k++] = points[i];
+			}
+			/* The last point is the first one again */
+			hull.resize(k - 1);
+		}
+		
+		/*
+		 * The input points extreme in the eight directions at multiples of 45
+		 * degrees, in counterclockwise order of the directions starting from
+		 * -x, found by minimizing a key per direction. The keys are evaluated
+		 * in double precision, so the points may not be exactly extreme,
+		 * which the filter below does not need.
+		 */
+		template <typename S>
+		struct HullExtremes {
+			HullExtremes() {
+				std::fill(key, key + 8, std::numeric_limits<double>::infinity());
+			}
+			
+			void add(const Point2<S> &p) {
+				const double x = double(p.x), y = double(p.y);
+				const double k[8] = { x, x + y, y, y - x, -x, -x - y, -y, x - y };
+				for(int i = 0; i < 8; ++i) {
+					if(k[i] < key[i]) {
+						key[i] = k[i];
+						point[i] = p;
+					}
+				}
+			}
+			void add(const HullExtremes &e) {
+				for(int i = 0; i < 8; ++i) {
+					if(e.key[i] < key[i]) {
+						key[i] = e.key[i];
+						point[i] = e.point[i];
+					}
+				}
+			}
+			
+			double key[8];
+			Point2<S> point[8];
+		};
+		
+		/*
+		 * The polygon of the extreme points without repeated vertices, which
+		 * is empty if it has fewer than 3.
+		 */
+		template <typename S>
+		struct HullPolygon {
+			explicit HullPolygon(const HullExtremes<S> &e) :
+				n(0)
+			{
+				for(int i = 0; i < 8; ++i) {
+					if(e.key[i] == std::numeric_limits<double>::infinity()) {
+						break;
+					}
+					if(n == 0 || !samePoint(v[n - 1], e.point[i])) {
+						v[n++] = e.point[i];
+					}
+				}
+				while(n > 1 && samePoint(v[n - 1], v[0])) {
+					--n;
+				}
+				if(n < 3) {
+					n = 0;
+				}
+			}
+			
+			Point2<S> v[8];
+			std::size_t n;
+		};
+		
+		/*
+		 * The Akl-Toussaint filter: a point strictly to the left of every edge
+		 * of the polygon is inside the convex hull of its vertices, which are
+		 * input points, so it is not a hull vertex. Even if rounding of the
+		 * keys makes the polygon not convex, such a point has a positive
+		 * winding number about it, so the test stays valid.
+		 *
+		 * Coordinates of at most 53 bits are tested in the arithmetic of the
+		 * filter type below with the error bound of the fast path of
+		 * orient2d, recomputed for its precision, so only points which are
+		 * certainly inside are discarded. Float points are tested in float
+		 * to fill twice the lanes of double.
+		 */
+		template <typename S>
+		struct HullScalar {
+			typedef typename std::conditional<std::is_floating_point<S>::value,
+																				S, double>::type type;
+		};
+		
+		template <typename P>
+		auto leftOf(P ax, P ay, P bx, P by, P bound) -> decltype(P() < P()) {
+			const P zero = P::zero();
+			const P l = ax * by, r = ay * bx;
+			const P permanent = simd::max(l, zero - l) + simd::max(r, zero - r);
+			return l - r > bound * permanent;
+		}
+		
+		template <typename P, typename S>
+		auto inside(const HullPolygon<S> &polygon, P x, P y)
+			-> decltype(P() < P())
+		{
+			typedef typename P::type T;
+			const T e = std::numeric_limits<T>::epsilon() / 2;
+			const P bound = P::set1((3 + 16 * e) * e);
+			const std::size_t n = polygon.n;
+			P dx[8], dy[8];
+			for(std::size_t i = 0; i < n; ++i) {
+				dx[i] = P::set1(T(polygon.v[i].x)) - x;
+				dy[i] = P::set1(T(polygon.v[i].y)) - y;
+			}
+			auto in = leftOf(dx[n - 1], dy[n - 1], dx[0], dy[0], bound);
+			for(std::size_t i = 0; i + 1 < n; ++i) {
+				in = in & leftOf(dx[i], dy[i], dx[i + 1], dy[i + 1], bound);
+			}
+			return in;
+		}
+		
+		/*
+		 * Set the bits of outside for the points [first, n) of a block, a
+		 * whole pack at a time, which are not inside the polygon, returning
+		 * the index of the first point not tested.
+		 */
+		template <typename P, typename S>
+		std::size_t filterPacked(const HullPolygon<S> &polygon,
+														 const typename P::type *x,
+														 const typename P::type *y, std::size_t first,
+														 std::size_t n, std::uint64_t &outside)
+		{
+			std::size_t i = first;
+			for(; i + P::width <= n; i += P::width) {
+				const int in = simd::movemask(
+					inside(polygon, P::load(x + i), P::load(y + i)));
+				outside |= std::uint64_t(~in & ((1 << P::width) - 1)) << i;
+			}
+			return i;
+		}
+		
+		template <typename S, typename T>
+		std::size_t filterBatch(const HullPolygon<S> &, const T *, const T *,
+														std::size_t, std::uint64_t &)
+		{
+			return 0;
+		}
+#if defined(GEOM_SSE2)
+		template <typename S>
+		std::size_t filterBatch(const HullPolygon<S> &polygon, const float *x,
+														const float *y, std::size_t n,
+														std::uint64_t &outside)
+		{
+			return filterPacked<simd::Pack<float>::type>(polygon, x, y, 0, n,
+																									 outside);
+		}
+		template <typename S>
+		std::size_t filterBatch(const HullPolygon<S> &polygon, const double *x,
+														const double *y, std::size_t n,
+														std::uint64_t &outside)
+		{
+			return filterPacked<simd::Pack<double>::type>(polygon, x, y, 0, n,
+																										outside);
+		}
+#endif
+		
+		/*
+		 * Append the points not inside the polygon to out, converting blocks
+		 * of 64 points to coordinate arrays of the filter type to test.
+		 */
+		template <typename S>
+		typename std::enable_if<std::numeric_limits<S>::digits <= 53>::type
+		filter(const HullPolygon<S> &polygon, const Point2<S> *points,
+					 std::size_t n, std::vector<Point2<S>> &out)
+		{
+			typedef typename HullScalar<S>::type T;
+			T x[64], y[64];
+			for(std::size_t first = 0; first < n; first += 64) {
+				const std::size_t m = n - first < 64 ? n - first : 64;
+				for(std::size_t i = 0; i < m; ++i) {
+					x[i] = T(points[first + i].x);
+					y[i] = T(points[first + i].y);
+				}
+				std::uint64_t outside = 0;
+				const std::size_t i = filterBatch(polygon, x, y, m, outside);
+				filterPacked<simd::Single<T>>(polygon, x, y, i, m, outside);
+				for(std::size_t j = 0; outside != 0; ++j, outside >>= 1) {
+					if(outside & 1) {
+						out.push_back(points[first + j]);
+					}
+				}
+			}
+		}
+		/* Wider integers are tested with the exact orientation */
+		template <typename S>
+		typename std::enable_if<(std::numeric_limits<S>::digits > 53)>::type
+		filter(const HullPolygon<S> &polygon, const Point2<S> *points,
+					 std::size_t n, std::vector<Point2<S>> &out)
+		{
+			for(std::size_t i = 0; i < n; ++i) {
+				bool in = orient2d(polygon.v[polygon.n - 1], polygon.v[0],
+													 points[i]) > 0;
+				for(std::size_t k = 0; in && k + 1 < polygon.n; ++k) {
+					in = orient2d(polygon.v[k], polygon.v[k + 1], points[i]) > 0;
+				}
+				if(!in) {
+					out.push_back(points[i]);
+				}
+			}
+		}
+	}
+	
+	/**
+	 * \brief Compute the convex hull of a set of points.
+	 *
+	 * Points inside the polygon of the points extreme along the axes and
+	 * diagonals are discarded first (the Akl-Toussaint heuristic), which for
+	 * most inputs leaves few points for Andrew's monotone chain. All hull
+	 * decisions use the exact orientation predicate of Predicates.hpp, so
+	 * the hull is exact for any float, double or integer coordinates,
+	 * barring overflow and underflow, and duplicate and collinear points
+	 * are handled.
+	 *
+	 * With several threads the points are split into one range per thread
+	 * which is filtered and reduced to its hull, and the hulls of the ranges
+	 * are merged by computing the hull of their vertices.
+	 *
+	 * \arg \c points The points, whose coordinates must be finite
+	 * \arg \c count The number of points
+	 * \arg \c hull Receives the vertices of the hull in counterclockwise
+	 * order, starting from the least by x then y, without points on its
+	 * edges. For collinear points these are the two end points, for equal
+	 * points the single point.
+	 * \arg \c parallel The threads to use
+	 */
+	template <typename Scalar>
+	void convexHull(const Point2<Scalar> *points, std::size_t count,
+									std::vector<Point2<Scalar>> &hull,
+									const Parallel &parallel = Parallel::serial())
+	{
+		std::mutex mutex;
+		detail::HullExtremes<Scalar> extremes;
+		detail::parallelFor(count, parallel,
+												[&](std::size_t first, std::size_t n) {
+			detail::HullExtremes<Scalar> e;
+			for(std::size_t i = first; i < first + n; ++i) {
+				e.add(points[i]);
+			}
+			std::lock_guard<std::mutex> lock(mutex);
+			extremes.add(e);
+		});
+		
+		/* The threads may not throw, so allocation failures are passed on */
+		const detail::HullPolygon<Scalar> polygon(extremes);
+		std::vector<Point2<Scalar>> vertices;
+		bool failed = false;
+		detail::parallelFor(count, parallel,
+												[&](std::size_t first, std::size_t n) {
+			try {
+				std::vector<Point2<Scalar>> candidates, part;
+				if(polygon.n == 0) {
+					candidates.assign(points + first, points + first + n);
+				} else {
+					detail::filter(polygon, points + first, n, candidates);
+				}
+				detail::monotoneChain(candidates, part);
+				std::lock_guard<std::mutex> lock(mutex);
+				vertices.insert(vertices.end(), part.begin(), part.end());
+			} catch(const std::bad_alloc &) {
+				std::lock_guard<std::mutex> lock(mutex);
+				failed = true;
+			}
+		});
+		if(failed) {
+			throw std::bad_alloc();
+		}
+		detail::monotoneChain(vertices, hull);
+	}
+}
+
+#endif
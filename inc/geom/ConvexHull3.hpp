@@ -0,0 +1,808 @@
+/**
+ * \file ConvexHull3.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Convex hulls of sets of points in space
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_CONVEX_HULL_3_HPP
+#define GEOM_CONVEX_HULL_3_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "Parallel.hpp"
+#include "Point2.hpp"
+#include "Point3.hpp"
+#include "Predicates.hpp"
+#include "Simd.hpp"
+
+namespace geom {
+	/**
+	 * \brief A half-edge of the boundary of a ConvexHull3.
+	 */
+	struct HalfEdge {
+		std::uint32_t vertex; /**< The vertex the half-edge starts from */
+		std::uint32_t twin; /**< The half-edge in the opposite direction */
+		std::uint32_t next; /**< The next half-edge around the same face */
+		std::uint32_t face; /**< The face the half-edge bounds */
+	};
+	
+	/**
+	 * \brief The boundary of a convex polyhedron as a half-edge mesh.
+	 *
+	 * Faces are triangles whose half-edges follow each other
+	 * counterclockwise seen from outside; edges[faces[f]] is a half-edge of
+	 * face f.
+	 */
+	template <typename Scalar>
+	struct ConvexHull3 {
+		void clear() {
+			vertices.clear();
+			indices.clear();
+			edges.clear();
+			faces.clear();
+		}
+		
+		std::vector<Point3<Scalar>> vertices; /**< The vertices */
+		std::vector<std::uint32_t> indices; /**< The input index of each vertex */
+		std::vector<HalfEdge> edges; /**< The half-edges */
+		std::vector<std::uint32_t> faces; /**< A half-edge of each face */
+	};
+	
+	namespace detail {
+		/*
+		 * Set the bits of above for the points [first, count) of a block, a
+		 * whole pack at a time, which are certainly above the plane through
+		 * a with normal n and permanent terms m, as kept by Quickhull below,
+		 * and of uncertain for those too close to it to tell, storing their
+		 * distances above it times the length of the normal. Returns the
+		 * index of the first point not tested.
+		 */
+		template <typename P>
+		std::size_t abovePacked(const double *a, const double *n,
+														const double *m, const double *x,
+														const double *y, const double *z,
+														std::size_t first, std::size_t count,
+														double *distance, std::uint64_t &above,
+														std::uint64_t &uncertain)
+		{
+			const P ax = P::set1(a[0]), ay = P::set1(a[1]), az = P::set1(a[2]);
+			const P nx = P::set1(n[0]), ny = P::set1(n[1]), nz = P::set1(n[2]);
+			const P mx = P::set1(m[0]), my = P::set1(m[1]), mz = P::set1(m[2]);
+			const P bound = P::set1(predicates::Orient3dBound);
+			const P zero = P::zero();
+			std::size_t i = first;
+			for(; i + P::width <= count; i += P::width) {
+				const P wx = P::load(x + i) - ax, wy = P::load(y + i) - ay;
+				const P wz = P::load(z + i) - az;
+				const P d = wx * nx + wy * ny + wz * nz;
+				const P permanent = simd::max(wx, zero - wx) * mx +
+					simd::max(wy, zero - wy) * my + simd::max(wz, zero - wz) * mz;
+				const P e = bound * permanent;
+				d.store(distance + i);
+				const int up = simd::movemask(d > e);
+				const int down = simd::movemask(zero - d > e);
+				above |= std::uint64_t(up) << i;
+				uncertain |= std::uint64_t(~(up | down) & ((1 << P::width) - 1)) << i;
+			}
+			return i;
+		}
+		
+#if defined(GEOM_SSE2)
+		inline std::size_t aboveBatch(const double *a, const double *n,
+																	const double *m, const double *x,
+																	const double *y, const double *z,
+																	std::size_t count, double *distance,
+																	std::uint64_t &above,
+																	std::uint64_t &uncertain)
+		{
+			return abovePacked<simd::Wide<double>::type>(a, n, m, x, y, z, 0, count,
+																									 distance, above, uncertain);
+		}
+#else
+		inline std::size_t aboveBatch(const double *, const double *,
+																	const double *, const double *,
+																	const double *, const double *, std::size_t,
+																	double *, std::uint64_t &, std::uint64_t &)
+		{
+			return 0;
+		}
+#endif
+		
+		/*
+		 * Quickhull (Barber, Dobkin and Huhdanpaa): each point outside the
+		 * current hull is kept in the conflict list of one face it lies
+		 * above, and the point farthest above a face is added until no
+		 * conflicts remain. Adding a point removes the faces it sees, found by
+		 * a depth-first search which meets the horizon edges in order around
+		 * the hole, closes the hole with a cone of new faces to the point and
+		 * moves the conflicts of the removed faces to the new faces.
+		 *
+		 * A point is above a face when the orient3d of the face and the
+		 * point is negative. The determinant is expanded about the first
+		 * vertex of the face, whose cross product and permanent terms are
+		 * computed once per face, which leaves the computation and error
+		 * bound of the fast path of orient3d; points within the bound are
+		 * decided by orient3d itself. So every decision is exact, and each
+		 * face of the result has all the points on or below its plane. Points
+		 * on the plane of a face are not above it, so points on the hull are
+		 * not added, but adjacent faces may be coplanar.
+		 *
+		 * With a vertex budget the faces are instead taken from a max-heap
+		 * keyed on the distance of their farthest point, so each vertex
+		 * added is the point farthest outside the hull so far.
+		 */
+		template <typename S>
+		class Quickhull {
+		public:
+			explicit Quickhull(const Point3<S> *points) :
+				points(points), count(0), mark(0), serials(0)
+			{ }
+			
+			/*
+			 * Build the hull of the points with the given input indices,
+			 * adding points only while it has fewer than maxVertices vertices
+			 * if that is not 0. Returns false if the points are coplanar.
+			 */
+			bool build(const std::uint32_t *indices, std::size_t n,
+								 std::size_t maxVertices)
+			{
+				std::uint32_t v[4];
+				if(!simplex(indices, n, v)) {
+					return false;
+				}
+				for(int i = 0; i < 4; ++i) {
+					vertexIndex.push_back(v[i]);
+					degree.push_back(0);
+				}
+				const std::uint32_t f[4] = {
+					addFace(0, 1, 2), addFace(0, 3, 1), addFace(1, 3, 2),
+					addFace(2, 3, 0)
+				};
+				for(int i = 0; i < 4; ++i) {
+					for(int j = 0; j < 4; ++j) {
+						for(int e = 0; e < 3; ++e) {
+							for(int k = 0; k < 3; ++k) {
+								if(faces[f[i]].v[e] == faces[f[j]].v[(k + 1) % 3] &&
+									 faces[f[i]].v[(e + 1) % 3] == faces[f[j]].v[k]) {
+									link(f[i], e, f[j], k);
+								}
+							}
+						}
+					}
+				}
+				distribute(indices, n, f, 4, None);
+				
+				if(maxVertices != 0) {
+					buildFarthest(maxVertices);
+					return true;
+				}
+				while(!pending.empty()) {
+					const std::uint32_t p = pending.back();
+					pending.pop_back();
+					if(!faces[p].alive || faces[p].list == None) {
+						continue;
+					}
+					add(p);
+				}
+				return true;
+			}
+			
+			/* Append the input indices of the vertices to out */
+			void vertices(std::vector<std::uint32_t> &out) const {
+				for(std::size_t i = 0; i < vertexIndex.size(); ++i) {
+					if(degree[i] != 0) {
+						out.push_back(vertexIndex[i]);
+					}
+				}
+			}
+			
+			void output(ConvexHull3<S> &hull) const {
+				hull.clear();
+				std::vector<std::uint32_t> vertexId(vertexIndex.size(), None);
+				std::vector<std::uint32_t> faceId(faces.size(), None);
+				std::uint32_t n = 0;
+				for(std::size_t f = 0; f < faces.size(); ++f) {
+					if(faces[f].alive) {
+						faceId[f] = n++;
+					}
+				}
+				hull.edges.reserve(3 * n);
+				hull.faces.reserve(n);
+				for(std::size_t f = 0; f < faces.size(); ++f) {
+					const Face &face = faces[f];
+					if(!face.alive) {
+						continue;
+					}
+					const std::uint32_t id = faceId[f];
+					hull.faces.push_back(3 * id);
+					for(int i = 0; i < 3; ++i) {
+						const std::uint32_t v = face.v[i];
+						if(vertexId[v] == None) {
+							vertexId[v] = std::uint32_t(hull.vertices.size());
+							hull.vertices.push_back(point(v));
+							hull.indices.push_back(vertexIndex[v]);
+						}
+						HalfEdge e;
+						e.vertex = vertexId[v];
+						e.twin = 3 * faceId[face.adj[i]] + face.twin[i];
+						e.next = 3 * id + (i + 1) % 3;
+						e.face = id;
+						hull.edges.push_back(e);
+					}
+				}
+			}
+		
+		private:
+			static const std::uint32_t None = 0xffffffff;
+			
+			/*
+			 * A face with local vertices v counterclockwise from outside, and
+			 * across its edge from v[i] to v[i + 1] the face adj[i], in which
+			 * the edge has index twin[i]. Points above the face are in
+			 * lists[list] unless that is None, farthest is the farthest of
+			 * them. The plane is kept as the first vertex a, the cross product
+			 * n of the edges from it and the sums m of the absolute values of
+			 * the products in n.
+			 */
+			struct Face {
+				std::uint32_t v[3];
+				std::uint32_t adj[3];
+				std::uint8_t twin[3];
+				bool alive;
+				std::uint32_t mark;
+				std::uint32_t serial;
+				std::uint32_t list;
+				std::uint32_t farthest;
+				double distance;
+				double a[3], n[3], m[3];
+			};
+			
+			/*
+			 * A face waiting in the heap of buildFarthest, with the distance
+			 * of its farthest point and its serial when pushed, which tells
+			 * whether the slot has since been reused.
+			 */
+			struct Candidate {
+				double distance;
+				std::uint32_t face;
+				std::uint32_t serial;
+				
+				bool operator<(const Candidate &c) const {
+					return distance < c.distance;
+				}
+			};
+			
+			/* The next edge of the depth-first search at a visible face */
+			struct Frame {
+				std::uint32_t face;
+				int edge;
+				int left;
+			};
+			struct Edge {
+				std::uint32_t face;
+				int edge;
+			};
+			
+			const Point3<S> &point(std::uint32_t v) const {
+				return points[vertexIndex[v]];
+			}
+			
+			static Point2<S> xy(const Point3<S> &p) { return Point2<S>(p.x, p.y); }
+			static Point2<S> yz(const Point3<S> &p) { return Point2<S>(p.y, p.z); }
+			static Point2<S> zx(const Point3<S> &p) { return Point2<S>(p.z, p.x); }
+			
+			static bool collinear(const Point3<S> &a, const Point3<S> &b,
+														const Point3<S> &c)
+			{
+				return orient2d(xy(a), xy(b), xy(c)) == 0 &&
+					orient2d(yz(a), yz(b), yz(c)) == 0 &&
+					orient2d(zx(a), zx(b), zx(c)) == 0;
+			}
+			
+			/*
+			 * Find four points spanning a tetrahedron with a positive
+			 * orient3d: the farthest apart of the points extreme along the
+			 * axes, the point farthest from the line through them and the
+			 * point farthest from the plane through all three, measured
+			 * approximately. Exact tests catch the approximation erring on
+			 * nearly degenerate points.
+			 */
+			bool simplex(const std::uint32_t *indices, std::size_t n,
+									 std::uint32_t v[4]) const
+			{
+				if(n < 4) {
+					return false;
+				}
+				std::uint32_t e[6];
+				for(int k = 0; k < 6; ++k) {
+					e[k] = indices[0];
+				}
+				for(std::size_t i = 1; i < n; ++i) {
+					const Point3<S> &p = points[indices[i]];
+					if(p.x < points[e[0]].x) e[0] = indices[i];
+					if(p.x > points[e[1]].x) e[1] = indices[i];
+					if(p.y < points[e[2]].y) e[2] = indices[i];
+					if(p.y > points[e[3]].y) e[3] = indices[i];
+					if(p.z < points[e[4]].z) e[4] = indices[i];
+					if(p.z > points[e[5]].z) e[5] = indices[i];
+				}
+				double best = 0;
+				for(int i = 0; i < 6; ++i) {
+					for(int j = i + 1; j < 6; ++j) {
+						const Point3<S> &p = points[e[i]], &q = points[e[j]];
+						const double dx = double(q.x) - p.x, dy = double(q.y) - p.y;
+						const double dz = double(q.z) - p.z;
+						const double d = dx * dx + dy * dy + dz * dz;
+						if(d > best) {
+							best = d;
+							v[0] = e[i];
+							v[1] = e[j];
+						}
+					}
+				}
+				if(best == 0) {
+					return false;
+				}
+				
+				const Point3<S> &a = points[v[0]], &b = points[v[1]];
+				const double ux = double(b.x) - a.x, uy = double(b.y) - a.y;
+				const double uz = double(b.z) - a.z;
+				best = -1;
+				for(std::size_t i = 0; i < n; ++i) {
+					const Point3<S> &p = points[indices[i]];
+					const double wx = double(p.x) - a.x, wy = double(p.y) - a.y;
+					const double wz = double(p.z) - a.z;
+					const double cx = uy * wz - uz * wy, cy = uz * wx - ux * wz;
+					const double cz = ux * wy - uy * wx;
+					const double d = cx * cx + cy * cy + cz * cz;
+					if(d > best) {
+						best = d;
+						v[2] = indices[i];
+					}
+				}
+				for(std::size_t i = 0; collinear(a, b, points[v[2]]); ++i) {
+					if(i == n) {
+						return false;
+					}
+					v[2] = indices[i];
+				}
+				
+				const Point3<S> &c = points[v[2]];
+				const double vx = double(c.x) - a.x, vy = double(c.y) - a.y;
+				const double vz = double(c.z) - a.z;
+				const double nx = uy * vz - uz * vy, ny = uz * vx - ux * vz;
+				const double nz = ux * vy - uy * vx;
+				best = -1;
+				for(std::size_t i = 0; i < n; ++i) {
+					const Point3<S> &p = points[indices[i]];
+					const double d = std::fabs((double(p.x) - a.x) * nx +
+																		 (double(p.y) - a.y) * ny +
+																		 (double(p.z) - a.z) * nz);
+					if(d > best) {
+						best = d;
+						v[3] = indices[i];
+					}
+				}
+				double o = orient3d(a, b, c, points[v[3]]);
+				for(std::size_t i = 0; o == 0; ++i) {
+					if(i == n) {
+						return false;
+					}
+					v[3] = indices[i];
+					o = orient3d(a, b, c, points[v[3]]);
+				}
+				if(o < 0) {
+					std::swap(v[0], v[1]);
+				}
+				return true;
+			}
+			
+			/* Add a face and compute its plane */
+			std::uint32_t addFace(std::uint32_t v0, std::uint32_t v1,
+												 std::uint32_t v2)
+			{
+				std::uint32_t f;
+				if(freeFaces.empty()) {
+					f = std::uint32_t(faces.size());
+					faces.push_back(Face());
+				} else {
+					f = freeFaces.back();
+					freeFaces.pop_back();
+				}
+				Face &face = faces[f];
+				face.v[0] = v0;
+				face.v[1] = v1;
+				face.v[2] = v2;
+				face.alive = true;
+				face.mark = 0;
+				face.serial = serials++;
+				face.list = None;
+				face.farthest = None;
+				face.distance = -std::numeric_limits<double>::infinity();
+				for(int i = 0; i < 3; ++i) {
+					if(degree[face.v[i]]++ == 0) {
+						++count;
+					}
+				}
+				
+				const Point3<S> &a = point(v0), &b = point(v1), &c = point(v2);
+				face.a[0] = a.x;
+				face.a[1] = a.y;
+				face.a[2] = a.z;
+				const double ux = double(b.x) - a.x, uy = double(b.y) - a.y;
+				const double uz = double(b.z) - a.z;
+				const double vx = double(c.x) - a.x, vy = double(c.y) - a.y;
+				const double vz = double(c.z) - a.z;
+				const double uyvz = uy * vz, uzvy = uz * vy;
+				const double uzvx = uz * vx, uxvz = ux * vz;
+				const double uxvy = ux * vy, uyvx = uy * vx;
+				face.n[0] = uyvz - uzvy;
+				face.n[1] = uzvx - uxvz;
+				face.n[2] = uxvy - uyvx;
+				face.m[0] = std::fabs(uyvz) + std::fabs(uzvy);
+				face.m[1] = std::fabs(uzvx) + std::fabs(uxvz);
+				face.m[2] = std::fabs(uxvy) + std::fabs(uyvx);
+				return f;
+			}
+			
+			void removeFace(std::uint32_t f) {
+				Face &face = faces[f];
+				face.alive = false;
+				for(int i = 0; i < 3; ++i) {
+					if(--degree[face.v[i]] == 0) {
+						--count;
+					}
+				}
+				if(face.list != None) {
+					lists[face.list].clear();
+					freeLists.push_back(face.list);
+				}
+				freeFaces.push_back(f);
+			}
+			
+			void link(std::uint32_t f, int e, std::uint32_t g, int k) {
+				faces[f].adj[e] = g;
+				faces[f].twin[e] = std::uint8_t(k);
+				faces[g].adj[k] = f;
+				faces[g].twin[k] = std::uint8_t(e);
+			}
+			
+			/*
+			 * Whether input point i is above face f, and its distance above
+			 * the plane times the length of the normal.
+			 */
+			bool above(const Face &f, std::uint32_t i, double &distance) const {
+				using namespace detail::predicates;
+				const Point3<S> &p = points[i];
+				const double wx = double(p.x) - f.a[0], wy = double(p.y) - f.a[1];
+				const double wz = double(p.z) - f.a[2];
+				distance = wx * f.n[0] + wy * f.n[1] + wz * f.n[2];
+				const double permanent = std::fabs(wx) * f.m[0] +
+					std::fabs(wy) * f.m[1] + std::fabs(wz) * f.m[2];
+				if(std::fabs(distance) > Orient3dBound * permanent) {
+					return distance > 0;
+				}
+				return orient3d(point(f.v[0]), point(f.v[1]), point(f.v[2]), p) < 0;
+			}
+			
+			/*
+			 * Put each input point of indices other than skip in the list of
+			 * the first face of cone it is above. Blocks of 64 points are
+			 * converted to coordinate arrays and tested against one face at a
+			 * time by the kernels above, leaving orient3d the points too close
+			 * to the plane to tell.
+			 */
+			void distribute(const std::uint32_t *indices, std::size_t n,
+											const std::uint32_t *cone, std::size_t m,
+											std::uint32_t skip)
+			{
+				double x[64], y[64], z[64], distance[64];
+				for(std::size_t first = 0; first < n; first += 64) {
+					const std::size_t count = n - first < 64 ? n - first : 64;
+					const std::uint32_t *block = indices + first;
+					std::uint64_t left = 0;
+					for(std::size_t i = 0; i < count; ++i) {
+						const Point3<S> &p = points[block[i]];
+						x[i] = double(p.x);
+						y[i] = double(p.y);
+						z[i] = double(p.z);
+						left |= std::uint64_t(block[i] != skip) << i;
+					}
+					for(std::size_t k = 0; k < m && left != 0; ++k) {
+						const Face &f = faces[cone[k]];
+						std::uint64_t above = 0, uncertain = 0;
+						const std::size_t i = aboveBatch(f.a, f.n, f.m, x, y, z, count,
+																						 distance, above, uncertain);
+						abovePacked<simd::Single<double>>(f.a, f.n, f.m, x, y, z, i,
+																							count, distance, above,
+																							uncertain);
+						uncertain &= left;
+						for(; uncertain != 0; uncertain &= uncertain - 1) {
+							const int j = simd::lowestBit(uncertain);
+							if(orient3d(point(f.v[0]), point(f.v[1]), point(f.v[2]),
+													points[block[j]]) < 0) {
+								above |= std::uint64_t(1) << j;
+							}
+						}
+						above &= left;
+						left &= ~above;
+						for(; above != 0; above &= above - 1) {
+							const int j = simd::lowestBit(above);
+							push(cone[k], block[j], distance[j]);
+						}
+					}
+				}
+			}
+			
+			void push(std::uint32_t f, std::uint32_t i, double distance) {
+				Face &face = faces[f];
+				if(face.list == None) {
+					if(freeLists.empty()) {
+						face.list = std::uint32_t(lists.size());
+						lists.push_back(std::vector<std::uint32_t>());
+					} else {
+						face.list = freeLists.back();
+						freeLists.pop_back();
+					}
+					pending.push_back(f);
+				}
+				lists[face.list].push_back(i);
+				if(distance > face.distance) {
+					face.distance = distance;
+					face.farthest = i;
+				}
+			}
+			
+			/*
+			 * Add points until there are none outside or the hull has
+			 * maxVertices vertices, always the one farthest from the plane of
+			 * its face. Lists are only filled as their faces are made, so the
+			 * faces pending after each step have their final farthest points.
+			 */
+			void buildFarthest(std::size_t maxVertices) {
+				for(;;) {
+					for(std::size_t k = 0; k < pending.size(); ++k) {
+						const Face &face = faces[pending[k]];
+						if(!face.alive || face.list == None) {
+							continue;
+						}
+						const double length = std::sqrt(face.n[0] * face.n[0] +
+																						face.n[1] * face.n[1] +
+																						face.n[2] * face.n[2]);
+						const Candidate c = {
+							face.distance / length, pending[k], face.serial
+						};
+						heap.push_back(c);
+						std::push_heap(heap.begin(), heap.end());
+					}
+					pending.clear();
+					
+					std::uint32_t f = None;
+					while(!heap.empty() && f == None) {
+						const Candidate c = heap.front();
+						std::pop_heap(heap.begin(), heap.end());
+						heap.pop_back();
+						const Face &face = faces[c.face];
+						if(face.alive && face.serial == c.serial && face.list != None) {
+							f = c.face;
+						}
+					}
+					if(f == None || count >= maxVertices) {
+						return;
+					}
+					add(f);
+				}
+			}
+			
+			/* Add the farthest point above face f */
+			void add(std::uint32_t f) {
+				const std::uint32_t eye = faces[f].farthest;
+				mark += 2;
+				const std::uint32_t visibleMark = mark, hiddenMark = mark + 1;
+				visible.clear();
+				horizon.clear();
+				faces[f].mark = visibleMark;
+				visible.push_back(f);
+				Frame root = { f, 0, 3 };
+				stack.push_back(root);
+				while(!stack.empty()) {
+					Frame &top = stack.back();
+					if(top.left == 0) {
+						stack.pop_back();
+						continue;
+					}
+					const Face &face = faces[top.face];
+					const int e = top.edge;
+					const std::uint32_t g = face.adj[e];
+					top.edge = (e + 1) % 3;
+					--top.left;
+					if(faces[g].mark == visibleMark) {
+						continue;
+					}
+					double distance;
+					if(faces[g].mark != hiddenMark && above(faces[g], eye, distance)) {
+						faces[g].mark = visibleMark;
+						visible.push_back(g);
+						const Frame next = { g, (face.twin[e] + 1) % 3, 2 };
+						stack.push_back(next);
+					} else {
+						faces[g].mark = hiddenMark;
+						const Edge edge = { top.face, e };
+						horizon.push_back(edge);
+					}
+				}
+				
+				/* The horizon edges join up in order, so the cone closes */
+				const std::uint32_t v = std::uint32_t(vertexIndex.size());
+				vertexIndex.push_back(eye);
+				degree.push_back(0);
+				cone.clear();
+				for(std::size_t k = 0; k < horizon.size(); ++k) {
+					const Edge &h = horizon[k];
+					const std::uint32_t u = faces[h.face].v[h.edge];
+					const std::uint32_t w = faces[h.face].v[(h.edge + 1) % 3];
+					const std::uint32_t c = addFace(u, w, v);
+					cone.push_back(c);
+					link(c, 0, faces[h.face].adj[h.edge], faces[h.face].twin[h.edge]);
+				}
+				for(std::size_t k = 0; k < cone.size(); ++k) {
+					link(cone[k], 1, cone[(k + 1) % cone.size()], 2);
+				}
+				
+				for(std::size_t k = 0; k < visible.size(); ++k) {
+					const std::uint32_t list = faces[visible[k]].list;
+					if(list == None) {
+						continue;
+					}
+					moving.swap(lists[list]);
+					distribute(moving.data(), moving.size(), cone.data(), cone.size(),
+										 eye);
+					moving.swap(lists[list]);
+				}
+				for(std::size_t k = 0; k < visible.size(); ++k) {
+					removeFace(visible[k]);
+				}
+			}
+			
+			const Point3<S> *points;
+			std::vector<std::uint32_t> vertexIndex, degree;
+			std::size_t count;
+			std::vector<Face> faces;
+			std::vector<std::uint32_t> freeFaces;
+			std::vector<std::vector<std::uint32_t>> lists;
+			std::vector<std::uint32_t> freeLists, pending;
+			std::uint32_t mark, serials;
+			std::vector<Candidate> heap;
+			std::vector<Frame> stack;
+			std::vector<std::uint32_t> visible, cone, moving;
+			std::vector<Edge> horizon;
+		};
+		template <typename S>
+		const std::uint32_t Quickhull<S>::None;
+	}
+	
+	/**
+	 * \brief Compute the convex hull of a set of points in space.
+	 *
+	 * The hull is built by quickhull, which starts from a tetrahedron of
+	 * extreme points and repeatedly adds the point farthest outside a face.
+	 * Its decisions use the exact orient3d predicate of Predicates.hpp, so
+	 * the hull is exact for any float, double or 32 bit integer
+	 * coordinates, barring overflow and underflow: every input point is on
+	 * or inside each face. Duplicate points give a single vertex. Adjacent
+	 * faces may be coplanar, and among coplanar input points a vertex may
+	 * lie on an edge or inside a face of the hull.
+	 *
+	 * Giving \c maxVertices gives a simplified hull for collision proxies:
+	 * the hull is rebuilt from the vertices of the full hull, stopping once
+	 * it has that many vertices. Each vertex added is the one farthest
+	 * outside the hull so far, so the few vertices kept give the overall
+	 * shape; the simplified hull lies inside the full one.
+	 *
+	 * With several threads the points are split into one range per thread
+	 * which is reduced to the vertices of its hull, and the hull of those
+	 * vertices is computed. Without, the hull of all points is computed
+	 * directly.
+	 *
+	 * \arg \c points The points, whose coordinates must be finite
+	 * \arg \c count The number of points, fewer than 2^32
+	 * \arg \c hull Receives the hull, or is cleared if the points are
+	 * coplanar
+	 * \arg \c maxVertices The most vertices to add, or 0 for the full hull;
+	 * the hull always has at least 4
+	 * \arg \c parallel The threads to use
+	 * \return Whether the points span a volume, so that the hull exists
+	 */
+	template <typename Scalar>
+	bool convexHull(const Point3<Scalar> *points, std::size_t count,
+									ConvexHull3<Scalar> &hull, std::size_t maxVertices = 0,
+									const Parallel &parallel = Parallel::serial())
+	{
+		/* The threads may not throw, so allocation failures are passed on */
+		std::mutex mutex;
+		std::vector<std::uint32_t> candidates;
+		bool failed = false, split = false;
+		detail::parallelFor(count, parallel,
+												[&](std::size_t first, std::size_t n) {
+			if(n == count) {
+				return;
+			}
+			try {
+				std::vector<std::uint32_t> indices(n), part;
+				for(std::size_t i = 0; i < n; ++i) {
+					indices[i] = std::uint32_t(first + i);
+				}
+				detail::Quickhull<Scalar> quickhull(points);
+				if(quickhull.build(indices.data(), n, 0)) {
+					quickhull.vertices(part);
+				} else {
+					part.swap(indices);
+				}
+				std::lock_guard<std::mutex> lock(mutex);
+				candidates.insert(candidates.end(), part.begin(), part.end());
+				split = true;
+			} catch(const std::bad_alloc &) {
+				std::lock_guard<std::mutex> lock(mutex);
+				failed = true;
+			}
+		});
+		if(failed) {
+			throw std::bad_alloc();
+		}
+		if(!split) {
+			candidates.resize(count);
+			for(std::size_t i = 0; i < count; ++i) {
+				candidates[i] = std::uint32_t(i);
+			}
+		}
+		
+		detail::Quickhull<Scalar> quickhull(points);
+		if(!quickhull.build(candidates.data(), candidates.size(), 0)) {
+			hull.clear();
+			return false;
+		}
+		if(maxVertices == 0) {
+			quickhull.output(hull);
+			return true;
+		}
+		
+		/* Points farthest above a face are vertices only among vertices */
+		candidates.clear();
+		quickhull.vertices(candidates);
+		detail::Quickhull<Scalar> simplified(points);
+		simplified.build(candidates.data(), candidates.size(), maxVertices);
+		simplified.output(hull);
+		return true;
+	}
+}
+
+#endif
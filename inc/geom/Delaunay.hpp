@@ -0,0 +1,569 @@
+/**
+ * \file Delaunay.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Delaunay triangulations of sets of points in the plane
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_DELAUNAY_HPP
+#define GEOM_DELAUNAY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Point2.hpp"
+#include "Predicates.hpp"
+#include "Simd.hpp"
+
+namespace geom {
+	/**
+	 * \brief A triangulation of points in the plane in compact form.
+	 *
+	 * Triangle t has the half-edges 3t, 3t + 1 and 3t + 2, counterclockwise;
+	 * half-edge e runs from vertex triangles[e] to the vertex of the next
+	 * half-edge of its triangle. halfedges[e] is the half-edge along the
+	 * same edge in the adjacent triangle, which runs the other way, or \c
+	 * None for an edge on the convex hull, so that the triangle adjacent to
+	 * t across its edge e is halfedges[e] / 3.
+	 */
+	struct Triangulation2 {
+		enum : std::uint32_t { None = 0xffffffff };
+		
+		void clear() {
+			triangles.clear();
+			halfedges.clear();
+			hull.clear();
+		}
+		
+		/** The input index of the vertex each half-edge starts from */
+		std::vector<std::uint32_t> triangles;
+		/** The opposite half-edge of each half-edge, or \c None */
+		std::vector<std::uint32_t> halfedges;
+		/** The input indices of the convex hull vertices, counterclockwise */
+		std::vector<std::uint32_t> hull;
+	};
+	
+	namespace detail {
+		/* The bits of x in the even positions, for x below 2^16 */
+		inline std::uint32_t spreadBits(std::uint32_t x) {
+			x = (x | (x << 8)) & 0x00ff00ff;
+			x = (x | (x << 4)) & 0x0f0f0f0f;
+			x = (x | (x << 2)) & 0x33333333;
+			x = (x | (x << 1)) & 0x55555555;
+			return x;
+		}
+		
+		/*
+		 * The index of cell (x, y) of a 2^order grid along the Hilbert curve,
+		 * for order at most 16. Rather than following the curve down one bit
+		 * at a time, the orientation of every level is found at once by a
+		 * parallel prefix scan over the bits of x and y, after F. Giesen's
+		 * bit-twiddling Hilbert curve (rawrunprotected blog). The state is
+		 * kept as two bit masks a and b for the reflections and c and d for
+		 * the transpositions, composed over 1, 2, 4 and 8 levels.
+		 */
+		inline std::uint32_t hilbertIndex(std::uint32_t x, std::uint32_t y,
+																			int order)
+		{
+			x <<= 16 - order;
+			y <<= 16 - order;
+			std::uint32_t a = x ^ y, b = 0xffff ^ a, c = 0xffff ^ (x | y);
+			std::uint32_t d = x & (y ^ 0xffff);
+			std::uint32_t A = a | (b >> 1), B = (a >> 1) ^ a;
+			std::uint32_t C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+			std::uint32_t D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+			for(int shift = 2; shift <= 8; shift *= 2) {
+				a = A;
+				b = B;
+				c = C;
+				d = D;
+				A = (a & (a >> shift)) ^ (b & (b >> shift));
+				B = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+				C ^= (a & (c >> shift)) ^ (b & (d >> shift));
+				D ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+			}
+			a = C ^ (C >> 1);
+			b = D ^ (D >> 1);
+			const std::uint32_t i0 = x ^ y, i1 = b | (0xffff ^ (i0 | a));
+			return ((spreadBits(i1) << 1) | spreadBits(i0)) >> (32 - 2 * order);
+		}
+		
+		/* A hash of an index, the finalizer of SplitMix64 */
+		inline std::uint64_t mixIndex(std::uint64_t i) {
+			i += 0x9e3779b97f4a7c15ull;
+			i = (i ^ (i >> 30)) * 0xbf58476d1ce4e5b9ull;
+			i = (i ^ (i >> 27)) * 0x94d049bb133111ebull;
+			return i ^ (i >> 31);
+		}
+		
+		/*
+		 * Sort entries by the 30 bits above their low 32 bits by least
+		 * significant digit radix sort, in three passes of 10 bits whose
+		 * counts are all taken in one pass over the entries.
+		 */
+		inline void radixSort(std::vector<std::uint64_t> &entries) {
+			const std::size_t n = entries.size();
+			std::vector<std::uint64_t> sorted(n);
+			std::vector<std::uint32_t> offsets(3 * 1024);
+			for(std::size_t i = 0; i < n; ++i) {
+				const std::uint32_t key = std::uint32_t(entries[i] >> 32);
+				++offsets[key & 1023];
+				++offsets[1024 + ((key >> 10) & 1023)];
+				++offsets[2048 + ((key >> 20) & 1023)];
+			}
+			for(int pass = 0; pass < 3; ++pass) {
+				std::uint32_t *offset = &offsets[1024 * pass];
+				for(std::uint32_t b = 0, sum = 0; b < 1024; ++b) {
+					const std::uint32_t c = offset[b];
+					offset[b] = sum;
+					sum += c;
+				}
+				const int shift = 32 + 10 * pass;
+				for(std::size_t i = 0; i < n; ++i) {
+					sorted[offset[(entries[i] >> shift) & 1023]++] = entries[i];
+				}
+				entries.swap(sorted);
+			}
+		}
+		
+		/*
+		 * The order of insertion of biased randomized insertion (BRIO, Amenta,
+		 * Choi and Rote): each point goes to round r with probability
+		 * 2^-(r + 1), by a hash of its index, so that every round is a random
+		 * sample of about half of the points inserted by its end, which keeps
+		 * the expected cost of randomized insertion. Within a round the
+		 * points follow a Hilbert curve through their bounding box, so that
+		 * consecutive points are close and the walk to each is short.
+		 */
+		template <typename S>
+		void insertionOrder(const Point2<S> *points, std::size_t count,
+												std::vector<std::uint32_t> &order)
+		{
+			const int bits = 12;
+			order.resize(count);
+			if(count == 0) {
+				return;
+			}
+			double minX = points[0].x, maxX = minX, minY = points[0].y;
+			double maxY = minY;
+			for(std::size_t i = 1; i < count; ++i) {
+				minX = std::min(minX, double(points[i].x));
+				maxX = std::max(maxX, double(points[i].x));
+				minY = std::min(minY, double(points[i].y));
+				maxY = std::max(maxY, double(points[i].y));
+			}
+			const double size = std::max(maxX - minX, maxY - minY);
+			const double scale = size > 0 ? ((1 << bits) - 1) / size : 0;
+			/* The key of each point above its index */
+			std::vector<std::uint64_t> entries(count);
+			for(std::size_t i = 0; i < count; ++i) {
+				const std::uint32_t x = std::uint32_t((points[i].x - minX) * scale);
+				const std::uint32_t y = std::uint32_t((points[i].y - minY) * scale);
+				const int round =
+					simd::lowestBit(mixIndex(i) | (std::uint64_t(1) << 40));
+				const std::uint32_t key = std::uint32_t(63 - round) << (2 * bits) |
+					hilbertIndex(x, y, bits);
+				entries[i] = std::uint64_t(key) << 32 | i;
+			}
+			radixSort(entries);
+			for(std::size_t i = 0; i < count; ++i) {
+				order[i] = std::uint32_t(entries[i]);
+			}
+		}
+		
+		/*
+		 * Incremental Delaunay triangulation by the Bowyer-Watson algorithm.
+		 * The triangles whose circumcircles contain a new point, its
+		 * conflicts, form a star-shaped cavity around it, found by a
+		 * depth-first search from the triangle containing it which meets the
+		 * boundary edges in order; the cavity is replaced by a fan of
+		 * triangles to the point. No vertex is inside the cavity, so its
+		 * triangles form a tree across their edges and the search needs no
+		 * marks. The containing triangle is found by a walk from the last
+		 * triangle made.
+		 *
+		 * Every convex hull edge has a ghost triangle on its outer side whose
+		 * third vertex is a vertex at infinity, so that points outside the
+		 * hull are inserted the same way: a ghost triangle is in conflict
+		 * with the points strictly outside its edge, and those strictly
+		 * inside the edge itself. All tests are exact orient2d and incircle
+		 * predicates, so the result is a Delaunay triangulation for any input;
+		 * among cocircular points ties are kept as inserted.
+		 */
+		template <typename S>
+		class DelaunayBuilder {
+		public:
+			/*
+			 * The points are copied in the order of insertion, so that the
+			 * points of nearby triangles are nearby in memory.
+			 */
+			DelaunayBuilder(const Point2<S> *input, const std::uint32_t *order,
+											std::size_t n) :
+				order(order), size(0), finite(0), last(0), ghost(0)
+			{
+				points.reserve(n);
+				for(std::size_t i = 0; i < n; ++i) {
+					points.push_back(input[order[i]]);
+				}
+			}
+			
+			/* Insert the points in order, returning false if they are collinear */
+			bool build() {
+				const std::uint32_t n = std::uint32_t(points.size());
+				std::uint32_t a = 0, b = 1, c = 0;
+				if(n == 0) {
+					return false;
+				}
+				for(; b < n && same(points[a], points[b]); ++b) { }
+				if(b == n) {
+					return false;
+				}
+				double o = 0;
+				for(c = b + 1; c < n; ++c) {
+					o = orient2d(points[a], points[b], points[c]);
+					if(o != 0) {
+						break;
+					}
+				}
+				if(c == n) {
+					return false;
+				}
+				const std::uint32_t second = b, third = c;
+				if(o < 0) {
+					std::swap(b, c);
+				}
+				
+				/* Each point after the first three adds two triangles */
+				vertex.resize(6 * std::size_t(n));
+				twin.resize(6 * std::size_t(n));
+				const std::uint32_t t = triangle(a, b, c);
+				const std::uint32_t gab = triangle(b, a, Ghost);
+				const std::uint32_t gbc = triangle(c, b, Ghost);
+				const std::uint32_t gca = triangle(a, c, Ghost);
+				link(3 * t, 3 * gab);
+				link(3 * t + 1, 3 * gbc);
+				link(3 * t + 2, 3 * gca);
+				link(3 * gab + 1, 3 * gca + 2);
+				link(3 * gab + 2, 3 * gbc + 1);
+				link(3 * gbc + 2, 3 * gca + 1);
+				last = t;
+				ghost = gab;
+				
+				for(std::uint32_t i = second + 1; i < n; ++i) {
+					if(i != third) {
+						insert(i);
+					}
+				}
+				compact();
+				return true;
+			}
+			
+			/* Output the triangulation, once compacted */
+			void output(Triangulation2 &out) const {
+				out.clear();
+				const std::size_t n = 3 * std::size_t(finite);
+				out.triangles.resize(n);
+				out.halfedges.resize(n);
+				std::uint32_t *triangles = out.triangles.data();
+				std::uint32_t *halfedges = out.halfedges.data();
+				for(std::size_t e = 0; e < n; ++e) {
+					triangles[e] = order[vertex[e]];
+					halfedges[e] = twin[e] < n ? twin[e] : None;
+				}
+				
+				/*
+				 * The finite edges of the ghost triangles run clockwise around
+				 * the hull; the next ghost shares the edge to the ghost vertex.
+				 */
+				std::uint32_t g = finite;
+				do {
+					out.hull.push_back(order[vertex[3 * g + (ghostIndex(g) + 1) % 3]]);
+					g = nextGhost(g);
+				} while(g != finite);
+				std::reverse(out.hull.begin(), out.hull.end());
+			}
+			
+		private:
+			static const std::uint32_t None = 0xffffffff;
+			static const std::uint32_t Ghost = 0xfffffffe;
+			
+			/* An edge on the boundary of the cavity and its outer half-edge */
+			struct Boundary {
+				std::uint32_t from, to, outer;
+			};
+			
+			static bool same(const Point2<S> &a, const Point2<S> &b) {
+				return a.x == b.x && a.y == b.y;
+			}
+			
+			static std::uint32_t next(std::uint32_t e) {
+				return e % 3 == 2 ? e - 2 : e + 1;
+			}
+			
+			/* Whether triangle t has the ghost vertex, the largest index */
+			bool isGhost(std::uint32_t t) const {
+				const std::uint32_t *v = &vertex[3 * t];
+				return std::max(v[0], std::max(v[1], v[2])) == Ghost;
+			}
+			
+			/* The next ghost triangle clockwise around the hull from ghost g */
+			std::uint32_t nextGhost(std::uint32_t g) const {
+				return twin[3 * g + (ghostIndex(g) + 2) % 3] / 3;
+			}
+			
+			/* The index of the ghost vertex in triangle t, or -1 */
+			int ghostIndex(std::uint32_t t) const {
+				const std::uint32_t *v = &vertex[3 * t];
+				return v[0] == Ghost ? 0 :
+					(v[1] == Ghost ? 1 : (v[2] == Ghost ? 2 : -1));
+			}
+			
+			std::uint32_t triangle(std::uint32_t a, std::uint32_t b,
+														 std::uint32_t c)
+			{
+				const std::uint32_t t = size++;
+				vertex[3 * t] = a;
+				vertex[3 * t + 1] = b;
+				vertex[3 * t + 2] = c;
+				return t;
+			}
+			
+			void link(std::uint32_t e, std::uint32_t f) {
+				twin[e] = f;
+				twin[f] = e;
+			}
+			
+			/*
+			 * Move the ghost triangles, found around the hull from the one
+			 * last made, after the finite ones by swapping each ghost in front
+			 * with a finite triangle from the back, so that the finite
+			 * triangles can be output as they are.
+			 */
+			void compact() {
+				ghosts.clear();
+				std::uint32_t g = ghost;
+				do {
+					ghosts.push_back(g);
+					g = nextGhost(g);
+				} while(g != ghost);
+				finite = size - std::uint32_t(ghosts.size());
+				std::uint32_t back = size;
+				for(std::size_t k = 0; k < ghosts.size(); ++k) {
+					if(ghosts[k] >= finite) {
+						continue;
+					}
+					do {
+						--back;
+					} while(isGhost(back));
+					swapSlots(ghosts[k], back);
+				}
+			}
+			
+			/* Swap the slots of triangles t and u, keeping their links */
+			void swapSlots(std::uint32_t t, std::uint32_t u) {
+				const std::uint32_t edges[6] = {
+					3 * t, 3 * t + 1, 3 * t + 2, 3 * u, 3 * u + 1, 3 * u + 2
+				};
+				for(int k = 0; k < 3; ++k) {
+					std::swap(vertex[edges[k]], vertex[edges[k + 3]]);
+					std::swap(twin[edges[k]], twin[edges[k + 3]]);
+				}
+				for(int k = 0; k < 6; ++k) {
+					const std::uint32_t o = twin[edges[k]];
+					twin[edges[k]] = o / 3 == t ? 3 * u + o % 3 :
+						(o / 3 == u ? 3 * t + o % 3 : o);
+				}
+				for(int k = 0; k < 6; ++k) {
+					twin[twin[edges[k]]] = edges[k];
+				}
+			}
+			
+			/* Whether the circumcircle of triangle t contains point p */
+			bool conflict(std::uint32_t t, const Point2<S> &p) const {
+				const std::uint32_t *v = &vertex[3 * t];
+				if(!isGhost(t)) {
+					return incircle(points[v[0]], points[v[1]], points[v[2]], p) > 0;
+				}
+				const int k = ghostIndex(t);
+				const Point2<S> &a = points[v[(k + 1) % 3]];
+				const Point2<S> &b = points[v[(k + 2) % 3]];
+				const double o = orient2d(a, b, p);
+				if(o != 0) {
+					return o > 0;
+				}
+				return a.x != b.x ? (a.x < p.x) == (p.x < b.x) && p.x != a.x &&
+					p.x != b.x : (a.y < p.y) == (p.y < b.y) && p.y != a.y &&
+					p.y != b.y;
+			}
+			
+			/*
+			 * Walk from the last triangle made towards p, crossing an edge
+			 * which has p strictly on its outer side until none does, or the
+			 * walk leaves the hull into a ghost triangle. Returns a triangle
+			 * in conflict with p, or None if p is a vertex already.
+			 */
+			std::uint32_t locate(const Point2<S> &p) const {
+				std::uint32_t t = last, from = None;
+				for(;;) {
+					if(isGhost(t)) {
+						return t;
+					}
+					const std::uint32_t *v = &vertex[3 * t];
+					const Point2<S> &a = points[v[0]], &b = points[v[1]];
+					const Point2<S> &c = points[v[2]];
+					std::uint32_t e = 3 * t;
+					if(e == from || orient2d(a, b, p) >= 0) {
+						++e;
+						if(e == from || orient2d(b, c, p) >= 0) {
+							++e;
+							if(e == from || orient2d(c, a, p) >= 0) {
+								return same(a, p) || same(b, p) || same(c, p) ? None : t;
+							}
+						}
+					}
+					from = twin[e];
+					t = from / 3;
+				}
+			}
+			
+			void insert(std::uint32_t i) {
+				const Point2<S> &p = points[i];
+				const std::uint32_t start = locate(p);
+				if(start == None) {
+					return;
+				}
+				
+				/* The edge crossed next is kept out of the stack */
+				cavity.clear();
+				boundary.clear();
+				cavity.push_back(start);
+				stack.push_back(3 * start + 2);
+				stack.push_back(3 * start + 1);
+				std::uint32_t e = 3 * start;
+				for(;;) {
+					const std::uint32_t o = twin[e], u = o / 3;
+					if(conflict(u, p)) {
+						cavity.push_back(u);
+						stack.push_back(next(next(o)));
+						e = next(o);
+						continue;
+					}
+					const Boundary b = { vertex[e], vertex[next(e)], o };
+					boundary.push_back(b);
+					if(stack.empty()) {
+						break;
+					}
+					e = stack.back();
+					stack.pop_back();
+				}
+				
+				/*
+				 * The cavity is a disk without inner vertices, so its boundary
+				 * has two edges more than it has triangles: the fan reuses the
+				 * slots of the cavity and takes two new ones.
+				 */
+				const std::size_t m = boundary.size();
+				cavity.push_back(size);
+				cavity.push_back(size + 1);
+				size += 2;
+				/*
+				 * The next walk starts from the finite triangle of the fan
+				 * whose outer edge has its midpoint nearest the next point.
+				 */
+				const Point2<S> &q = points[i + 1 < points.size() ? i + 1 : i];
+				const double qx = 2 * double(q.x), qy = 2 * double(q.y);
+				double nearest = std::numeric_limits<double>::infinity();
+				std::uint32_t previous = cavity[m - 1];
+				for(std::size_t k = 0; k < m; ++k) {
+					const std::uint32_t t = cavity[k];
+					const Boundary &b = boundary[k];
+					vertex[3 * t] = b.from;
+					vertex[3 * t + 1] = b.to;
+					vertex[3 * t + 2] = i;
+					link(3 * t, b.outer);
+					link(3 * t + 2, 3 * previous + 1);
+					previous = t;
+					if(b.from == Ghost || b.to == Ghost) {
+						ghost = t;
+					} else {
+						const Point2<S> &u = points[b.from], &v = points[b.to];
+						const double dx = double(u.x) + double(v.x) - qx;
+						const double dy = double(u.y) + double(v.y) - qy;
+						const double d = dx * dx + dy * dy;
+						last = d < nearest ? t : last;
+						nearest = d < nearest ? d : nearest;
+					}
+				}
+			}
+			
+			std::vector<Point2<S>> points;
+			const std::uint32_t *order;
+			std::vector<std::uint32_t> vertex, twin;
+			std::uint32_t size, finite, last, ghost;
+			std::vector<std::uint32_t> stack, cavity, ghosts;
+			std::vector<Boundary> boundary;
+		};
+		template <typename S>
+		const std::uint32_t DelaunayBuilder<S>::None;
+		template <typename S>
+		const std::uint32_t DelaunayBuilder<S>::Ghost;
+	}
+	
+	/**
+	 * \brief Compute the Delaunay triangulation of a set of points.
+	 *
+	 * Points are inserted one at a time in biased randomized order along a
+	 * Hilbert curve, each replacing the triangles whose circumcircles
+	 * contain it. All decisions use the exact orient2d and incircle
+	 * predicates of Predicates.hpp, so the triangulation is exact for any
+	 * float, double or 32 bit integer coordinates, barring overflow and
+	 * underflow: no vertex lies strictly inside the circumcircle of a
+	 * triangle. Of duplicate points only one is a vertex; points on the
+	 * convex hull edges are vertices.
+	 *
+	 * \arg \c points The points, whose coordinates must be finite
+	 * \arg \c count The number of points, fewer than 2^32 - 1
+	 * \arg \c out Receives the triangulation, whose vertices are indices
+	 * into points, or is cleared if the points are collinear
+	 * \return Whether the points span an area, so that there are triangles
+	 */
+	template <typename Scalar>
+	bool delaunay(const Point2<Scalar> *points, std::size_t count,
+								Triangulation2 &out)
+	{
+		std::vector<std::uint32_t> order;
+		detail::insertionOrder(points, count, order);
+		detail::DelaunayBuilder<Scalar> builder(points, order.data(), count);
+		if(!builder.build()) {
+			out.clear();
+			return false;
+		}
+		builder.output(out);
+		return true;
+	}
+}
+
+#endif
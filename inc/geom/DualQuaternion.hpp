@@ -0,0 +1,558 @@
+/**
+ * \file DualQuaternion.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Dual quaternions representing rigid transformations and skinning
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_DUALQUATERNION_HPP
+#define GEOM_DUALQUATERNION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Affine3.hpp"
+#include "Matrix4.hpp"
+#include "Parallel.hpp"
+#include "Point3.hpp"
+#include "Point3SoA.hpp"
+#include "Quaternion.hpp"
+#include "Simd.hpp"
+#include "Vector3.hpp"
+#include "Vector3SoA.hpp"
+#include "Vector4.hpp"
+
+namespace geom {
+	/**
+	 * \brief A dual quaternion real + dual*e, with e*e = 0.
+	 * 
+	 * Unit dual quaternions represent rigid transformations, a rotation
+	 * followed by a translation, in 8 values. Unlike matrices they can be
+	 * blended without shearing or shrinking the geometry, which makes them
+	 * the usual choice for the joint palettes of skinned meshes.
+	 * 
+	 * The real part is the rotation and the dual part is half the
+	 * translation times the rotation. The 8 components are stored
+	 * contiguously, real part first.
+	 */
+	template <typename Scalar>
+	struct DualQuaternion {
+		typedef Scalar type;
+		
+		/**
+		 * \brief Construct a \c DualQuaternion object with all components 0
+		 * 
+		 * This is not a transformation, see \c identity.
+		 */
+		DualQuaternion() { }
+		/**
+		 * \brief Construct a \c DualQuaternion object from its real and dual
+		 * parts
+		 * \arg \c real The real part
+		 * \arg \c dual The dual part
+		 */
+		DualQuaternion(const Quaternion<Scalar> &real,
+									 const Quaternion<Scalar> &dual) :
+			real(real), dual(dual)
+		{ }
+		/**
+		 * \brief Construct the \c DualQuaternion object of a rotation followed
+		 * by a translation.
+		 * \arg \c rotation The rotation, which must be of unit length
+		 * \arg \c translation The translation applied after the rotation
+		 */
+		DualQuaternion(const Quaternion<Scalar> &rotation,
+									 const Vector3<Scalar> &translation) :
+			real(rotation),
+			dual(Quaternion<Scalar>(translation, 0) * rotation * Scalar(0.5))
+		{ }
+		/**
+		 * \brief Construct a \c DualQuaternion object which is a conversion of
+		 * the given \c DualQuaternion object.
+		 * \arg \c source The \c DualQuaternion to convert
+		 */
+		template <typename Other>
+		DualQuaternion(const DualQuaternion<Other> &source) :
+			real(source.real), dual(source.dual)
+		{ }
+		/**
+		 * \brief Construct the \c DualQuaternion object of a rigid
+		 * transformation.
+		 * \arg \c m The transformation, whose linear part must be a rotation
+		 */
+		explicit DualQuaternion(const Affine3<Scalar> &m) :
+			DualQuaternion(Quaternion<Scalar>(m.linear()), m.translation())
+		{ }
+		/**
+		 * \brief Construct the \c DualQuaternion object of a rigid
+		 * transformation.
+		 * \arg \c m The transformation, whose upper left 3x3 block must be a
+		 * rotation and whose last row must be 0, 0, 0, 1
+		 */
+		explicit DualQuaternion(const Matrix4<Scalar> &m) :
+			DualQuaternion(Quaternion<Scalar>(m),
+										 Vector3<Scalar>(m.values[12], m.values[13],
+																		 m.values[14]))
+		{ }
+		
+		/**
+		 * \brief Get the rotation of a unit dual quaternion, its real part.
+		 */
+		Quaternion<Scalar> rotation() const {
+			return real;
+		}
+		/**
+		 * \brief Get the translation of a unit dual quaternion.
+		 */
+		Vector3<Scalar> translation() const {
+			return (dual * conjugate(real) * Scalar(2)).vector();
+		}
+		
+		/**
+		 * \brief Convert a unit dual quaternion to the matching \c Affine3.
+		 */
+		Affine3<Scalar> toAffine3() const {
+			return Affine3<Scalar>(real.toMatrix3(), translation());
+		}
+		/**
+		 * \brief Convert a unit dual quaternion to the matching \c Matrix4.
+		 */
+		Matrix4<Scalar> toMatrix4() const {
+			return toAffine3().toMatrix4();
+		}
+		
+		/**
+		 * \brief Construct the identity transformation.
+		 */
+		static DualQuaternion<Scalar> identity() {
+			return DualQuaternion<Scalar>(Quaternion<Scalar>::identity(),
+																		Quaternion<Scalar>());
+		}
+		
+		Quaternion<Scalar> real; /**< The real part, the rotation */
+		Quaternion<Scalar> dual; /**< The dual part */
+	};
+	
+	typedef DualQuaternion<float> DualQuaternionf;
+	typedef DualQuaternion<double> DualQuaterniond;
+	
+	namespace detail {
+		/*
+		 * Transformation kernels written once over a pack type P, either a SIMD
+		 * pack or simd::Single, and over dual quaternions held as 8 component
+		 * values q. Single dual quaternion operations and the scalar remainder
+		 * of the batch kernels use simd::Single so that every lane computes
+		 * exactly the same operations.
+		 */
+		
+		/* Rotate (x, y, z) by the unit quaternion (rx, ry, rz, rw) */
+		template <typename P>
+		void rotateComponents(P rx, P ry, P rz, P rw, P &x, P &y, P &z) {
+			P tx = ry * z - rz * y, ty = rz * x - rx * z, tz = rx * y - ry * x;
+			tx = tx + tx;
+			ty = ty + ty;
+			tz = tz + tz;
+			x = x + rw * tx + (ry * tz - rz * ty);
+			y = y + rw * ty + (rz * tx - rx * tz);
+			z = z + rw * tz + (rx * ty - ry * tx);
+		}
+		
+		/* Transform the point (x, y, z) by the unit dual quaternion q */
+		template <typename P>
+		void transformComponents(const P *q, P &x, P &y, P &z) {
+			/* The translation 2 * dual * conjugate(real) expanded */
+			P tx = q[3] * q[4] - q[7] * q[0] + (q[1] * q[6] - q[2] * q[5]);
+			P ty = q[3] * q[5] - q[7] * q[1] + (q[2] * q[4] - q[0] * q[6]);
+			P tz = q[3] * q[6] - q[7] * q[2] + (q[0] * q[5] - q[1] * q[4]);
+			rotateComponents(q[0], q[1], q[2], q[3], x, y, z);
+			x = x + (tx + tx);
+			y = y + (ty + ty);
+			z = z + (tz + tz);
+		}
+		
+		/*
+		 * Gather the palette entries of influence k of P::width consecutive
+		 * vertices into one register per component.
+		 */
+		template <typename P, typename S>
+		void gatherInfluence(const DualQuaternion<S> *palette,
+												 const Vector4<std::uint32_t> *joints, int k, P *q)
+		{
+			typedef Vector4<std::uint32_t> Joints;
+			static std::uint32_t Joints::* const members[4] = {
+				&Joints::x, &Joints::y, &Joints::z, &Joints::w
+			};
+			const S *real[P::width], *dual[P::width];
+			for(std::size_t l = 0; l < P::width; ++l) {
+				const DualQuaternion<S> &e = palette[joints[l].*members[k]];
+				real[l] = &e.real.x;
+				dual[l] = &e.dual.x;
+			}
+			gatherQuaternions(real, q[0], q[1], q[2], q[3]);
+			gatherQuaternions(dual, q[4], q[5], q[6], q[7]);
+		}
+		
+		/*
+		 * Blend the palette entries of P::width consecutive vertices into one
+		 * register per component, normalized. Influences whose real part is in
+		 * the opposite hemisphere to that of the first are negated, so that the
+		 * blend follows the shortest path.
+		 */
+		template <typename P, typename S>
+		void blendInfluences(const DualQuaternion<S> *palette,
+												 const Vector4<std::uint32_t> *joints,
+												 const Vector4<S> *weights, P *b)
+		{
+			using simd::select;
+			using simd::sqrt;
+			
+			const P zero = P::zero();
+			P w[4], first[8];
+			loadQuaternions(&weights->x, w[0], w[1], w[2], w[3]);
+			gatherInfluence(palette, joints, 0, first);
+			for(int c = 0; c < 8; ++c) {
+				b[c] = first[c] * w[0];
+			}
+			for(int k = 1; k < 4; ++k) {
+				P q[8];
+				gatherInfluence(palette, joints, k, q);
+				const P d = first[0] * q[0] + first[1] * q[1] + first[2] * q[2] +
+					first[3] * q[3];
+				const P wk = select(d < zero, zero - w[k], w[k]);
+				for(int c = 0; c < 8; ++c) {
+					b[c] = b[c] + q[c] * wk;
+				}
+			}
+			const P s = P::set1(1) /
+				sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2] + b[3] * b[3]);
+			for(int c = 0; c < 8; ++c) {
+				b[c] = b[c] * s;
+			}
+		}
+		
+		/*
+		 * Skin vertices [0, n) a whole pack at a time, returning the number of
+		 * vertices handled. The normal pointers are ignored when Normals is
+		 * false.
+		 */
+		template <typename P, bool Normals, typename S>
+		std::size_t skinVertices(const DualQuaternion<S> *palette,
+														 const Vector4<std::uint32_t> *joints,
+														 const Vector4<S> *weights, const S *px,
+														 const S *py, const S *pz, const S *nx,
+														 const S *ny, const S *nz, std::size_t n,
+														 S *opx, S *opy, S *opz, S *onx, S *ony,
+														 S *onz)
+		{
+			std::size_t i = 0;
+			for(; i + P::width <= n; i += P::width) {
+				P b[8];
+				blendInfluences(palette, joints + i, weights + i, b);
+				P x = P::load(px + i), y = P::load(py + i), z = P::load(pz + i);
+				transformComponents(b, x, y, z);
+				x.store(opx + i);
+				y.store(opy + i);
+				z.store(opz + i);
+				if(Normals) {
+					x = P::load(nx + i);
+					y = P::load(ny + i);
+					z = P::load(nz + i);
+					rotateComponents(b[0], b[1], b[2], b[3], x, y, z);
+					x.store(onx + i);
+					y.store(ony + i);
+					z.store(onz + i);
+				}
+			}
+			return i;
+		}
+		
+		template <bool Normals, typename S>
+		std::size_t skinBatch(const DualQuaternion<S> *,
+													const Vector4<std::uint32_t> *, const Vector4<S> *,
+													const S *, const S *, const S *, const S *,
+													const S *, const S *, std::size_t, S *, S *, S *,
+													S *, S *, S *)
+		{
+			return 0;
+		}
+		
+#if defined(GEOM_SSE2)
+		template <bool Normals>
+		std::size_t skinBatch(const DualQuaternion<float> *palette,
+													const Vector4<std::uint32_t> *joints,
+													const Vector4<float> *weights, const float *px,
+													const float *py, const float *pz, const float *nx,
+													const float *ny, const float *nz, std::size_t n,
+													float *opx, float *opy, float *opz, float *onx,
+													float *ony, float *onz)
+		{
+			return skinVertices<simd::Pack<float>::type, Normals>(
+				palette, joints, weights, px, py, pz, nx, ny, nz, n, opx, opy, opz,
+				onx, ony, onz);
+		}
+		template <bool Normals>
+		std::size_t skinBatch(const DualQuaternion<double> *palette,
+													const Vector4<std::uint32_t> *joints,
+													const Vector4<double> *weights, const double *px,
+													const double *py, const double *pz,
+													const double *nx, const double *ny,
+													const double *nz, std::size_t n, double *opx,
+													double *opy, double *opz, double *onx,
+													double *ony, double *onz)
+		{
+			return skinVertices<simd::Pack<double>::type, Normals>(
+				palette, joints, weights, px, py, pz, nx, ny, nz, n, opx, opy, opz,
+				onx, ony, onz);
+		}
+#endif
+		
+		template <bool Normals, typename S>
+		void skin(const DualQuaternion<S> *palette,
+							const Vector4<std::uint32_t> *joints, const Vector4<S> *weights,
+							const S *px, const S *py, const S *pz, const S *nx,
+							const S *ny, const S *nz, std::size_t n, S *opx, S *opy,
+							S *opz, S *onx, S *ony, S *onz)
+		{
+			const std::size_t i = skinBatch<Normals>(palette, joints, weights, px,
+																							 py, pz, nx, ny, nz, n, opx,
+																							 opy, opz, onx, ony, onz);
+			skinVertices<simd::Single<S>, Normals>(
+				palette, joints + i, weights + i, px + i, py + i, pz + i, nx + i,
+				ny + i, nz + i, n - i, opx + i, opy + i, opz + i, onx + i, ony + i,
+				onz + i);
+		}
+	}
+	
+	/**
+	 * \brief Test dual quaternions component-wise for equality.
+	 * \arg \c lhs The dual quaternion on the left of the equality operator.
+	 * \arg \c rhs The dual quaternion on the right of the equality operator.
+	 * \return True if all components are equal, false otherwise.
+	 */
+	template <typename LType, typename RType>
+	bool operator==(const DualQuaternion<LType> &lhs,
+									const DualQuaternion<RType> &rhs)
+	{
+		return lhs.real == rhs.real && lhs.dual == rhs.dual;
+	}
+	
+	/**
+	 * \brief Test if two dual quaternions are not equal.
+	 * \arg \c lhs The dual quaternion on the left of the inequality operator.
+	 * \arg \c rhs The dual quaternion on the right of the inequality operator.
+	 * \return True if any component is different, False otherwise.
+	 */
+	template <typename LType, typename RType>
+	bool operator!=(const DualQuaternion<LType> &lhs,
+									const DualQuaternion<RType> &rhs)
+	{
+		return !(lhs == rhs);
+	}
+	
+	/**
+	 * \brief Multiply two \c DualQuaternion objects.
+	 * 
+	 * For unit dual quaternions the product is the composition of the
+	 * transformations, with the one on the right applied first.
+	 * 
+	 * \arg \c lhs The dual quaternion on the left side of the product
+	 * \arg \c rhs The dual quaternion on the right side of the product
+	 * \return A new \c DualQuaternion object holding the product
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	DualQuaternion<Result> operator*(const DualQuaternion<LType> &lhs,
+																	 const DualQuaternion<RType> &rhs)
+	{
+		return DualQuaternion<Result>(lhs.real * rhs.real,
+																	lhs.real * rhs.dual + lhs.dual * rhs.real);
+	}
+	
+	/**
+	 * \brief Transform a \c Point3 object by a unit \c DualQuaternion object.
+	 * \arg \c lhs The transformation
+	 * \arg \c rhs The point to transform
+	 * \return A new \c Point3 object holding the rotated and translated point
+	 */
+	template <typename Scalar>
+	Point3<Scalar> operator*(const DualQuaternion<Scalar> &lhs,
+													 const Point3<Scalar> &rhs)
+	{
+		typedef simd::Single<Scalar> P;
+		const P q[8] = {
+			lhs.real.x, lhs.real.y, lhs.real.z, lhs.real.w,
+			lhs.dual.x, lhs.dual.y, lhs.dual.z, lhs.dual.w
+		};
+		P x = rhs.x, y = rhs.y, z = rhs.z;
+		detail::transformComponents(q, x, y, z);
+		return Point3<Scalar>(x.v, y.v, z.v);
+	}
+	
+	/**
+	 * \brief Rotate a \c Vector3 object by a unit \c DualQuaternion object,
+	 * ignoring the translation.
+	 * \arg \c lhs The transformation
+	 * \arg \c rhs The vector to rotate
+	 * \return A new \c Vector3 object holding the rotated vector
+	 */
+	template <typename Scalar>
+	Vector3<Scalar> operator*(const DualQuaternion<Scalar> &lhs,
+														const Vector3<Scalar> &rhs)
+	{
+		typedef simd::Single<Scalar> P;
+		P x = rhs.x, y = rhs.y, z = rhs.z;
+		detail::rotateComponents<P>(lhs.real.x, lhs.real.y, lhs.real.z,
+																lhs.real.w, x, y, z);
+		return Vector3<Scalar>(x.v, y.v, z.v);
+	}
+	
+	/**
+	 * \brief Conjugate a \c DualQuaternion object, which for unit dual
+	 * quaternions is the inverse transformation.
+	 * \arg \c q The dual quaternion to conjugate
+	 * \return A new \c DualQuaternion object with both parts conjugated
+	 */
+	template <typename Scalar>
+	DualQuaternion<Scalar> conjugate(const DualQuaternion<Scalar> &q) {
+		return DualQuaternion<Scalar>(conjugate(q.real), conjugate(q.dual));
+	}
+	
+	/**
+	 * \brief Scale a \c DualQuaternion object so that its real part is of
+	 * unit length.
+	 * \arg \c q The dual quaternion to normalize, whose real part must not be
+	 * zero
+	 * \return A new \c DualQuaternion object
+	 */
+	template <typename Scalar>
+	DualQuaternion<Scalar> normalize(const DualQuaternion<Scalar> &q) {
+		const Scalar s = Scalar(1) / length(q.real);
+		return DualQuaternion<Scalar>(q.real * s, q.dual * s);
+	}
+	
+	/**
+	 * \brief Blend up to 4 entries of a palette of unit dual quaternions, as
+	 * for one vertex of a skinned mesh.
+	 * 
+	 * This is dual quaternion linear blending: the weighted sum of the entries,
+	 * each negated if needed to lie in the hemisphere of the first, normalized.
+	 * Unused influences have a weight of 0 and any valid joint index.
+	 * 
+	 * \arg \c palette The transformations of the joints
+	 * \arg \c joints The palette indices of the influences
+	 * \arg \c weights The weights of the influences, summing to 1
+	 * \return A new unit \c DualQuaternion object
+	 */
+	template <typename Scalar>
+	DualQuaternion<Scalar> blend(const DualQuaternion<Scalar> *palette,
+															 const Vector4<std::uint32_t> &joints,
+															 const Vector4<Scalar> &weights)
+	{
+		simd::Single<Scalar> b[8];
+		detail::blendInfluences(palette, &joints, &weights, b);
+		return DualQuaternion<Scalar>(
+			Quaternion<Scalar>(b[0].v, b[1].v, b[2].v, b[3].v),
+			Quaternion<Scalar>(b[4].v, b[5].v, b[6].v, b[7].v));
+	}
+	
+	/*
+	 * Skinning.
+	 *
+	 * These deform the vertices of a mesh by a palette of joint
+	 * transformations, each vertex being transformed by the blend of up to 4
+	 * entries. The rest pose positions and normals are held as SoA spans, the
+	 * joint indices and weights of each vertex as one Vector4 each. Each
+	 * vertex gives the same result as transforming it by \c blend.
+	 *
+	 * Compared with blending a palette of Matrix4 these read half as many
+	 * bytes per influence and keep the skinned shape rigid near joints.
+	 */
+	
+	/**
+	 * \brief Skin the positions and normals of a mesh.
+	 * \arg \c palette The transformations of the joints
+	 * \arg \c joints The palette indices of the influences of each vertex
+	 * \arg \c weights The weights of the influences of each vertex
+	 * \arg \c positions The rest pose positions
+	 * \arg \c normals The rest pose normals
+	 * \arg \c outPositions The span receiving the skinned positions
+	 * \arg \c outNormals The span receiving the skinned normals
+	 * \arg \c parallel Options for running on several threads.
+	 */
+	template <typename Scalar, typename PScalar, typename NScalar>
+	void skin(const DualQuaternion<Scalar> *palette,
+						const Vector4<std::uint32_t> *joints,
+						const Vector4<Scalar> *weights, Point3Span<PScalar> positions,
+						Vector3Span<NScalar> normals, Point3Span<Scalar> outPositions,
+						Vector3Span<Scalar> outNormals,
+						const Parallel &parallel = Parallel::serial())
+	{
+		static_assert(std::is_same<typename Point3Span<PScalar>::type,
+															 Scalar>::value &&
+									std::is_same<typename Vector3Span<NScalar>::type,
+															 Scalar>::value,
+									"The vertices must have the scalar type of the palette");
+		detail::parallelFor(positions.count, parallel,
+												[&](std::size_t first, std::size_t n) {
+			const Point3Span<PScalar> p = positions.subspan(first, n);
+			const Vector3Span<NScalar> v = normals.subspan(first, n);
+			const Point3Span<Scalar> op = outPositions.subspan(first, n);
+			const Vector3Span<Scalar> ov = outNormals.subspan(first, n);
+			detail::skin<true>(palette, joints + first, weights + first, p.x, p.y,
+												 p.z, v.x, v.y, v.z, n, op.x, op.y, op.z, ov.x, ov.y,
+												 ov.z);
+		});
+	}
+	
+	/**
+	 * \brief Skin the positions of a mesh.
+	 * \arg \c palette The transformations of the joints
+	 * \arg \c joints The palette indices of the influences of each vertex
+	 * \arg \c weights The weights of the influences of each vertex
+	 * \arg \c positions The rest pose positions
+	 * \arg \c outPositions The span receiving the skinned positions
+	 * \arg \c parallel Options for running on several threads.
+	 */
+	template <typename Scalar, typename InScalar>
+	void skin(const DualQuaternion<Scalar> *palette,
+						const Vector4<std::uint32_t> *joints,
+						const Vector4<Scalar> *weights, Point3Span<InScalar> positions,
+						Point3Span<Scalar> outPositions,
+						const Parallel &parallel = Parallel::serial())
+	{
+		static_assert(std::is_same<typename Point3Span<InScalar>::type,
+															 Scalar>::value,
+									"The vertices must have the scalar type of the palette");
+		detail::parallelFor(positions.count, parallel,
+												[&](std::size_t first, std::size_t n) {
+			const Point3Span<InScalar> p = positions.subspan(first, n);
+			const Point3Span<Scalar> op = outPositions.subspan(first, n);
+			detail::skin<false>(palette, joints + first, weights + first, p.x,
+													p.y, p.z, p.x, p.y, p.z, n, op.x, op.y, op.z,
+													op.x, op.y, op.z);
+		});
+	}
+}
+
+#endif
@@ -0,0 +1,318 @@
+/**
+ * \file Exact.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Exact floating point arithmetic for robust geometric predicates
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_EXACT_HPP
+#define GEOM_EXACT_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace geom {
+	namespace detail {
+		/*
+		 * Arbitrary precision arithmetic on floating point expansions, after
+		 * J. R. Shewchuk, "Adaptive Precision Floating-Point Arithmetic and
+		 * Fast Robust Geometric Predicates" (1997).
+		 *
+		 * An expansion is a sum of doubles ordered by increasing magnitude
+		 * whose significant bits do not overlap, so that its sign is the sign
+		 * of its last term. Sums and products of expansions are exact, barring
+		 * overflow and underflow, which makes the signs of polynomials in the
+		 * input coordinates exact.
+		 *
+		 * The exact arithmetic is slow, so predicates first evaluate their
+		 * polynomial on Approx values carrying a bound on their absolute
+		 * error, and only fall back to expansions when the bound does not
+		 * decide the sign. Round to nearest double arithmetic without
+		 * contraction into fused multiply-adds is assumed, see Simd.hpp.
+		 */
+		namespace exact {
+			/** \brief Half the distance from 1 to the next double, \f$2^{-53}\f$ */
+			const double Epsilon = std::numeric_limits<double>::epsilon() / 2;
+			
+			/* x + y = a + b exactly, with x = fl(a + b) */
+			inline void twoSum(double a, double b, double &x, double &y) {
+				x = a + b;
+				const double bv = x - a;
+				const double av = x - bv;
+				y = (a - av) + (b - bv);
+			}
+			/* As twoSum when |a| >= |b| */
+			inline void fastTwoSum(double a, double b, double &x, double &y) {
+				x = a + b;
+				y = b - (x - a);
+			}
+			/* hi + lo = a with each half holding 26 significant bits */
+			inline void split(double a, double &hi, double &lo) {
+				const double c = 134217729.0 * a;
+				const double big = c - a;
+				hi = c - big;
+				lo = a - hi;
+			}
+			/* x + y = a * b exactly, with x = fl(a * b) */
+			inline void twoProduct(double a, double b, double &x, double &y) {
+				x = a * b;
+#if defined(FP_FAST_FMA)
+				y = std::fma(a, b, -x);
+#else
+				double ahi, alo, bhi, blo;
+				split(a, ahi, alo);
+				split(b, bhi, blo);
+				const double err1 = x - ahi * bhi;
+				const double err2 = err1 - alo * bhi;
+				const double err3 = err2 - ahi * blo;
+				y = alo * blo - err3;
+#endif
+			}
+			
+			/*
+			 * h = e + f, merging the terms by magnitude, where h has room for
+			 * elen + flen terms. Returns the number of terms of h, with zeros
+			 * eliminated, so that a zero sum has none.
+			 */
+			inline int sum(int elen, const double *e, int flen, const double *f,
+										 double *h)
+			{
+				if(elen == 0 || flen == 0) {
+					const double *g = elen == 0 ? f : e;
+					const int glen = elen == 0 ? flen : elen;
+					for(int i = 0; i < glen; ++i) {
+						h[i] = g[i];
+					}
+					return glen;
+				}
+				/* Take the smaller of the next terms of e and f */
+				int i = 0, j = 0, n = 0;
+				double q, x, y;
+				if(std::fabs(e[0]) < std::fabs(f[0])) {
+					q = e[i++];
+				} else {
+					q = f[j++];
+				}
+				bool first = true;
+				while(i < elen && j < flen) {
+					const double t = std::fabs(e[i]) < std::fabs(f[j]) ? e[i++] : f[j++];
+					if(first) {
+						fastTwoSum(t, q, x, y);
+						first = false;
+					} else {
+						twoSum(q, t, x, y);
+					}
+					q = x;
+					if(y != 0) {
+						h[n++] = y;
+					}
+				}
+				for(; i < elen; ++i) {
+					twoSum(q, e[i], x, y);
+					q = x;
+					if(y != 0) {
+						h[n++] = y;
+					}
+				}
+				for(; j < flen; ++j) {
+					twoSum(q, f[j], x, y);
+					q = x;
+					if(y != 0) {
+						h[n++] = y;
+					}
+				}
+				if(q != 0) {
+					h[n++] = q;
+				}
+				return n;
+			}
+			/* h = b e, where h has room for 2 elen terms */
+			inline int scale(int elen, const double *e, double b, double *h) {
+				int n = 0;
+				if(elen == 0 || b == 0) {
+					return n;
+				}
+				double q, err;
+				twoProduct(e[0], b, q, err);
+				if(err != 0) {
+					h[n++] = err;
+				}
+				for(int i = 1; i < elen; ++i) {
+					double hi, lo, sum;
+					twoProduct(e[i], b, hi, lo);
+					twoSum(q, lo, sum, err);
+					if(err != 0) {
+						h[n++] = err;
+					}
+					fastTwoSum(hi, sum, q, err);
+					if(err != 0) {
+						h[n++] = err;
+					}
+				}
+				if(q != 0) {
+					h[n++] = q;
+				}
+				return n;
+			}
+			/* a - b as an expansion of up to two terms */
+			inline int difference(double a, double b, double *h) {
+				double x, y;
+				int n = 0;
+				twoSum(a, -b, x, y);
+				if(y != 0) {
+					h[n++] = y;
+				}
+				if(x != 0) {
+					h[n++] = x;
+				}
+				return n;
+			}
+			/* The nearest double to an expansion, with its sign */
+			inline double estimate(int elen, const double *e) {
+				double sum = 0;
+				for(int i = 0; i < elen; ++i) {
+					sum += e[i];
+				}
+				return sum;
+			}
+			
+			/* An expansion of any length on the heap */
+			typedef std::vector<double> Expansion;
+			
+			inline Expansion add(const Expansion &e, const Expansion &f) {
+				Expansion h(e.size() + f.size());
+				h.resize(sum(int(e.size()), e.data(), int(f.size()), f.data(),
+										 h.data()));
+				return h;
+			}
+			inline Expansion negate(Expansion e) {
+				for(std::size_t i = 0; i < e.size(); ++i) {
+					e[i] = -e[i];
+				}
+				return e;
+			}
+			inline Expansion sub(const Expansion &e, const Expansion &f) {
+				return add(e, negate(f));
+			}
+			inline Expansion scale(const Expansion &e, double b) {
+				Expansion h(2 * e.size());
+				h.resize(scale(int(e.size()), e.data(), b, h.data()));
+				return h;
+			}
+			inline Expansion mul(const Expansion &e, const Expansion &f) {
+				Expansion h;
+				for(std::size_t i = 0; i < f.size(); ++i) {
+					h = add(h, scale(e, f[i]));
+				}
+				return h;
+			}
+			inline int sign(const Expansion &e) {
+				return e.empty() ? 0 : (e.back() > 0 ? 1 : -1);
+			}
+			
+			/*
+			 * An input coordinate as an expansion. Integers wider than the 53
+			 * bit significand of a double are split into two exact halves.
+			 */
+			template <typename Scalar>
+			typename std::enable_if<std::is_integral<Scalar>::value &&
+															(std::numeric_limits<Scalar>::digits > 53),
+															Expansion>::type
+			expansion(Scalar v) {
+				const double lo = double(v & Scalar(0xffffffff));
+				const double hi = double(Scalar(v >> 32)) * 4294967296.0;
+				Expansion e;
+				if(lo != 0) {
+					e.push_back(lo);
+				}
+				if(hi != 0) {
+					e.push_back(hi);
+				}
+				return e;
+			}
+			template <typename Scalar>
+			typename std::enable_if<!(std::is_integral<Scalar>::value &&
+																(std::numeric_limits<Scalar>::digits > 53)),
+															Expansion>::type
+			expansion(Scalar v) {
+				return v == 0 ? Expansion() : Expansion(1, double(v));
+			}
+			
+			/*
+			 * A double approximation v of a value x with |x - v| <= e. The
+			 * bounds of sums and products add the exact rounding error of the
+			 * operation, so arithmetic which happens to be exact, as on small
+			 * integers, keeps a zero bound; they are inflated to cover the
+			 * rounding of the bound itself.
+			 */
+			struct Approx {
+				double v, e;
+			};
+			const double Inflate = 1 + 8 * Epsilon;
+			
+			template <typename Scalar>
+			Approx approx(Scalar v) {
+				const double d = double(v);
+				const bool wide = std::numeric_limits<Scalar>::digits > 53;
+				const Approx a = { d, wide ? Epsilon * std::fabs(d) : 0.0 };
+				return a;
+			}
+			inline Approx operator+(const Approx &a, const Approx &b) {
+				double v, y;
+				twoSum(a.v, b.v, v, y);
+				const Approx r = { v, (a.e + b.e + std::fabs(y)) * Inflate };
+				return r;
+			}
+			inline Approx operator-(const Approx &a, const Approx &b) {
+				double v, y;
+				twoSum(a.v, -b.v, v, y);
+				const Approx r = { v, (a.e + b.e + std::fabs(y)) * Inflate };
+				return r;
+			}
+			inline Approx operator*(const Approx &a, const Approx &b) {
+				double v, y;
+				twoProduct(a.v, b.v, v, y);
+				const Approx r = {
+					v, (std::fabs(a.v) * b.e + std::fabs(b.v) * a.e + a.e * b.e +
+							std::fabs(y)) * Inflate
+				};
+				return r;
+			}
+			/* Returned by sign when the error bound does not decide the sign */
+			const int Uncertain = 2;
+			inline int sign(const Approx &a) {
+				if(a.v > a.e) {
+					return 1;
+				} else if(-a.v > a.e) {
+					return -1;
+				}
+				return a.v == 0 && a.e == 0 ? 0 : Uncertain;
+			}
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,506 @@
+/**
+ * \file Frustum.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief View frustum planes and batch culling of bounding volumes
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_FRUSTUM_HPP
+#define GEOM_FRUSTUM_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Dimensions3.hpp"
+#include "Matrix4.hpp"
+#include "Parallel.hpp"
+#include "Point3.hpp"
+#include "Point3SoA.hpp"
+#include "Simd.hpp"
+#include "Vector3SoA.hpp"
+#include "Vector4.hpp"
+
+namespace geom {
+	/**
+	 * \brief The range of depths a projection matrix maps the frustum to.
+	 */
+	enum class ClipDepth {
+		NegativeOneToOne, /**< -w <= z <= w, as OpenGL */
+		ZeroToOne /**< 0 <= z <= w, as Direct3D and Vulkan */
+	};
+	
+	/**
+	 * \brief The six planes bounding a view frustum.
+	 *
+	 * Each plane is stored as \f$(x, y, z, w)\f$ with a unit normal
+	 * \f$(x, y, z)\f$ pointing into the frustum, so that the signed distance
+	 * of a point \f$p\f$ from the plane is \f$x p_x + y p_y + z p_z + w\f$ and
+	 * points inside the frustum have non-negative distances from all six
+	 * planes.
+	 *
+	 * The planes are stored as one array per component, which the batch
+	 * culling kernels broadcast into SIMD registers one plane at a time while
+	 * testing several volumes in the lanes.
+	 */
+	template <typename Scalar>
+	struct Frustum {
+		static_assert(std::is_floating_point<Scalar>::value,
+									"Frustum needs a floating point type");
+		
+		/** \brief The index of each plane */
+		enum Side { Left, Right, Bottom, Top, Near, Far, Sides };
+		
+		/**
+		 * \brief Construct a \c Frustum object whose planes all have a zero
+		 * normal and distance, which contains every point.
+		 */
+		Frustum() :
+			x{}, y{}, z{}, w{}
+		{ }
+		/**
+		 * \brief Extract the planes of the frustum of a projection matrix.
+		 *
+		 * The planes are those of the clip volume \f$-w \le x, y \le w\f$ and
+		 * the depth range of \c depth, transformed back by the matrix. For the
+		 * product of a projection and a view matrix they are in world space,
+		 * for a projection matrix alone in view space. A plane with a zero
+		 * normal, such as the far plane of an infinite projection, is stored
+		 * as \f$(0, 0, 0, 1)\f$ and contains every point.
+		 *
+		 * \arg \c m The projection matrix, usually a projection-view product
+		 * \arg \c depth The range of clip depths the matrix maps to
+		 */
+		explicit Frustum(const Matrix4<Scalar> &m,
+										 ClipDepth depth = ClipDepth::NegativeOneToOne)
+		{
+			for(int k = 0; k < 4; ++k) {
+				const Scalar r3 = m(3, k);
+				set(Left, k, r3 + m(0, k));
+				set(Right, k, r3 - m(0, k));
+				set(Bottom, k, r3 + m(1, k));
+				set(Top, k, r3 - m(1, k));
+				set(Near, k, depth == ClipDepth::ZeroToOne ? m(2, k) : r3 + m(2, k));
+				set(Far, k, r3 - m(2, k));
+			}
+			for(int i = 0; i < Sides; ++i) {
+				const Scalar length = std::sqrt(x[i] * x[i] + y[i] * y[i] +
+																				z[i] * z[i]);
+				/* The far plane of an infinite projection is at infinity */
+				if(length == 0) {
+					x[i] = y[i] = z[i] = 0;
+					w[i] = 1;
+					continue;
+				}
+				const Scalar s = 1 / length;
+				x[i] *= s;
+				y[i] *= s;
+				z[i] *= s;
+				w[i] *= s;
+			}
+		}
+		
+		/**
+		 * \brief Get one plane of the frustum.
+		 * \arg \c side The index of the plane, a \c Side
+		 * \return The plane as \f$(x, y, z, w)\f$
+		 */
+		Vector4<Scalar> plane(int side) const {
+			return Vector4<Scalar>(x[side], y[side], z[side], w[side]);
+		}
+		
+		Scalar x[Sides]; /**< The x component of each plane normal */
+		Scalar y[Sides]; /**< The y component of each plane normal */
+		Scalar z[Sides]; /**< The z component of each plane normal */
+		Scalar w[Sides]; /**< The distance of each plane from the origin */
+		
+	private:
+		void set(int side, int k, Scalar v) {
+			Scalar *const c[4] = { x, y, z, w };
+			c[k][side] = v;
+		}
+	};
+	
+	typedef Frustum<float> Frustumf;
+	typedef Frustum<double> Frustumd;
+	
+	namespace detail {
+		/*
+		 * Culling kernels written once over a pack type P, either a SIMD pack
+		 * or simd::Single, which test P::width volumes at a time against the
+		 * planes of a frustum broadcast one at a time.
+		 *
+		 * A box of center c and half extents e is outside a plane of normal n
+		 * when the corner furthest along n is, that is when
+		 * n.c + w + |n|.e < 0, and a sphere of radius r when n.c + w + r < 0.
+		 * A volume is visible when it is not outside any plane; like every
+		 * plane test this is conservative, and volumes near an edge of the
+		 * frustum may be reported visible although they are outside it.
+		 */
+		template <typename S>
+		struct CullPlanes {
+			explicit CullPlanes(const Frustum<S> &f) {
+				for(int i = 0; i < Frustum<S>::Sides; ++i) {
+					x[i] = f.x[i];
+					y[i] = f.y[i];
+					z[i] = f.z[i];
+					w[i] = f.w[i];
+					ax[i] = std::abs(f.x[i]);
+					ay[i] = std::abs(f.y[i]);
+					az[i] = std::abs(f.z[i]);
+				}
+			}
+			
+			/* The smallest signed distance of the points from the planes */
+			template <typename P>
+			P distance(P cx, P cy, P cz) const {
+				P d = plane(0, cx, cy, cz);
+				for(int i = 1; i < Frustum<S>::Sides; ++i) {
+					d = simd::min(d, plane(i, cx, cy, cz));
+				}
+				return d;
+			}
+			/* The smallest distance of the furthest corners of boxes */
+			template <typename P>
+			P distance(P cx, P cy, P cz, P ex, P ey, P ez) const {
+				P d = plane(0, cx, cy, cz) + extent(0, ex, ey, ez);
+				for(int i = 1; i < Frustum<S>::Sides; ++i) {
+					d = simd::min(d, plane(i, cx, cy, cz) + extent(i, ex, ey, ez));
+				}
+				return d;
+			}
+			
+			S x[Frustum<S>::Sides], y[Frustum<S>::Sides], z[Frustum<S>::Sides];
+			S w[Frustum<S>::Sides];
+			S ax[Frustum<S>::Sides], ay[Frustum<S>::Sides], az[Frustum<S>::Sides];
+			
+		private:
+			template <typename P>
+			P plane(int i, P cx, P cy, P cz) const {
+				return P::set1(x[i]) * cx + P::set1(y[i]) * cy + P::set1(z[i]) * cz +
+					P::set1(w[i]);
+			}
+			template <typename P>
+			P extent(int i, P ex, P ey, P ez) const {
+				return P::set1(ax[i]) * ex + P::set1(ay[i]) * ey +
+					P::set1(az[i]) * ez;
+			}
+		};
+		
+		/*
+		 * The sources of volumes below test the P::width volumes from index i
+		 * and return a visibility mask.
+		 */
+		template <typename S>
+		struct BoxArrays {
+			const S *cx, *cy, *cz, *ex, *ey, *ez;
+			
+			template <typename P>
+			auto visible(const CullPlanes<S> &p, std::size_t i) const
+				-> decltype(P() >= P())
+			{
+				return p.distance(P::load(cx + i), P::load(cy + i), P::load(cz + i),
+													P::load(ex + i), P::load(ey + i), P::load(ez + i)) >=
+					P::zero();
+			}
+		};
+		/*
+		 * Boxes given by their minimum corner and dimensions are loaded one
+		 * member of P::width consecutive objects per register.
+		 */
+		template <typename S>
+		struct BoxObjects {
+			const Point3<S> *origins;
+			const Dimensions3<S> *dims;
+			
+			template <typename P>
+			auto visible(const CullPlanes<S> &p, std::size_t i) const
+				-> decltype(P() >= P())
+			{
+				const std::size_t o = sizeof(Point3<S>) / sizeof(S);
+				const std::size_t d = sizeof(Dimensions3<S>) / sizeof(S);
+				const P half = P::set1(S(0.5));
+				const P ex = P::load(&dims[i].width, d) * half;
+				const P ey = P::load(&dims[i].height, d) * half;
+				const P ez = P::load(&dims[i].depth, d) * half;
+				return p.distance(P::load(&origins[i].x, o) + ex,
+													P::load(&origins[i].y, o) + ey,
+													P::load(&origins[i].z, o) + ez, ex, ey, ez) >=
+					P::zero();
+			}
+		};
+		template <typename S>
+		struct SphereArrays {
+			const S *cx, *cy, *cz, *r;
+			
+			template <typename P>
+			auto visible(const CullPlanes<S> &p, std::size_t i) const
+				-> decltype(P() >= P())
+			{
+				return p.distance(P::load(cx + i), P::load(cy + i),
+													P::load(cz + i)) + P::load(r + i) >= P::zero();
+			}
+		};
+		template <typename S>
+		struct SphereObjects {
+			const Point3<S> *centers;
+			const S *r;
+			
+			template <typename P>
+			auto visible(const CullPlanes<S> &p, std::size_t i) const
+				-> decltype(P() >= P())
+			{
+				const std::size_t c = sizeof(Point3<S>) / sizeof(S);
+				return p.distance(P::load(&centers[i].x, c),
+													P::load(&centers[i].y, c),
+													P::load(&centers[i].z, c)) + P::load(r + i) >=
+					P::zero();
+			}
+		};
+		
+		/*
+		 * Set the visibility bits of volumes [first, n) a whole pack at a time,
+		 * returning the index of the first volume not handled. Bit i % 32 of
+		 * word i / 32 is set for a visible volume i; each word is cleared by
+		 * its first volume, which must be included in the range, so unused bits
+		 * of the last word are zero.
+		 */
+		template <typename P, typename Volumes, typename S>
+		std::size_t cullPacked(const CullPlanes<S> &planes, const Volumes &v,
+													 std::size_t first, std::size_t n,
+													 std::uint32_t *visible)
+		{
+			std::size_t i = first;
+			for(; i + P::width <= n; i += P::width) {
+				const std::uint32_t bits = simd::movemask(
+					v.template visible<P>(planes, i));
+				if(i % 32 == 0) {
+					visible[i / 32] = bits;
+				} else {
+					visible[i / 32] |= bits << (i % 32);
+				}
+			}
+			return i;
+		}
+		
+		template <typename Volumes, typename S>
+		std::size_t cullBatch(const CullPlanes<S> &, const Volumes &, std::size_t,
+													std::uint32_t *)
+		{
+			return 0;
+		}
+#if defined(GEOM_SSE2)
+		template <typename Volumes>
+		std::size_t cullBatch(const CullPlanes<float> &planes, const Volumes &v,
+													std::size_t n, std::uint32_t *visible)
+		{
+			return cullPacked<simd::Pack<float>::type>(planes, v, 0, n, visible);
+		}
+		template <typename Volumes>
+		std::size_t cullBatch(const CullPlanes<double> &planes, const Volumes &v,
+													std::size_t n, std::uint32_t *visible)
+		{
+			return cullPacked<simd::Pack<double>::type>(planes, v, 0, n, visible);
+		}
+#endif
+		
+		/*
+		 * Cull volumes [0, count) of v, which is offset by the first volume of
+		 * each thread's range. The ranges of parallelFor start at multiples of
+		 * 64 volumes, so threads write whole words of the mask.
+		 */
+		template <typename S, typename Volumes, typename Offset>
+		void cull(const Frustum<S> &f, std::size_t count, std::uint32_t *visible,
+							const Parallel &parallel, Offset offset)
+		{
+			const CullPlanes<S> planes(f);
+			parallelFor(count, parallel, [&](std::size_t first, std::size_t n) {
+				const Volumes v = offset(first);
+				std::uint32_t *out = visible + first / 32;
+				const std::size_t i = cullBatch(planes, v, n, out);
+				cullPacked<simd::Single<S>>(planes, v, i, n, out);
+			});
+		}
+	}
+	
+	/*
+	 * Single volume tests, which give the same results as the batch kernels.
+	 */
+	
+	/**
+	 * \brief Test whether an axis-aligned box may be visible in a frustum.
+	 * \arg \c f The frustum
+	 * \arg \c origin The minimum corner of the box
+	 * \arg \c dim The dimensions of the box along x, y and z
+	 * \return False if the box is outside a plane of the frustum, true
+	 * otherwise
+	 */
+	template <typename Scalar>
+	bool visible(const Frustum<Scalar> &f, const Point3<Scalar> &origin,
+							 const Dimensions3<Scalar> &dim)
+	{
+		const detail::BoxObjects<Scalar> v = { &origin, &dim };
+		return v.template visible<simd::Single<Scalar>>(
+			detail::CullPlanes<Scalar>(f), 0);
+	}
+	
+	/**
+	 * \brief Test whether a sphere may be visible in a frustum.
+	 * \arg \c f The frustum
+	 * \arg \c center The center of the sphere
+	 * \arg \c radius The radius of the sphere
+	 * \return False if the sphere is outside a plane of the frustum, true
+	 * otherwise
+	 */
+	template <typename Scalar>
+	bool visible(const Frustum<Scalar> &f, const Point3<Scalar> &center,
+							 Scalar radius)
+	{
+		const detail::SphereObjects<Scalar> v = { &center, &radius };
+		return v.template visible<simd::Single<Scalar>>(
+			detail::CullPlanes<Scalar>(f), 0);
+	}
+	
+	/*
+	 * Batch culling.
+	 *
+	 * Each kernel tests every volume of its input against a frustum and
+	 * writes a visibility bitmask: bit i % 32 of word i / 32 is set when
+	 * volume i may be visible, as by the single volume \c visible. The mask
+	 * must hold (count + 31) / 32 words; unused bits of the last word are
+	 * cleared. Float and double volumes are tested 4 or 8 at a time with
+	 * SSE/AVX instructions, see Simd.hpp.
+	 *
+	 * The optional \c Parallel argument splits arrays over its threshold
+	 * between several threads, see Parallel.hpp.
+	 */
+	
+	/**
+	 * \brief Cull an array of axis-aligned boxes.
+	 * \arg \c f The frustum
+	 * \arg \c origins The minimum corner of each box
+	 * \arg \c dims The dimensions of each box along x, y and z
+	 * \arg \c count The number of boxes
+	 * \arg \c visible The bitmask receiving the visibility of each box
+	 * \arg \c parallel Options for running on several threads
+	 */
+	template <typename Scalar>
+	void cullBoxes(const Frustum<Scalar> &f, const Point3<Scalar> *origins,
+								 const Dimensions3<Scalar> *dims, std::size_t count,
+								 std::uint32_t *visible,
+								 const Parallel &parallel = Parallel::serial())
+	{
+		typedef detail::BoxObjects<Scalar> Volumes;
+		detail::cull<Scalar, Volumes>(f, count, visible, parallel,
+																	[&](std::size_t i) {
+																		const Volumes v = { origins + i, dims + i };
+																		return v;
+																	});
+	}
+	
+	/**
+	 * \brief Cull axis-aligned boxes held as arrays of centers and half
+	 * extents, which is the fastest form to test.
+	 * \arg \c f The frustum
+	 * \arg \c centers The center of each box
+	 * \arg \c extents Half the size of each box along x, y and z, at least
+	 * as many as there are centers
+	 * \arg \c visible The bitmask receiving the visibility of each box
+	 * \arg \c parallel Options for running on several threads
+	 */
+	template <typename Scalar, typename CScalar, typename EScalar>
+	void cullBoxes(const Frustum<Scalar> &f, Point3Span<CScalar> centers,
+								 Vector3Span<EScalar> extents, std::uint32_t *visible,
+								 const Parallel &parallel = Parallel::serial())
+	{
+		static_assert(std::is_same<typename Point3Span<CScalar>::type,
+															 Scalar>::value &&
+									std::is_same<typename Vector3Span<EScalar>::type,
+															 Scalar>::value,
+									"The boxes must have the scalar type of the frustum");
+		typedef detail::BoxArrays<Scalar> Volumes;
+		detail::cull<Scalar, Volumes>(f, centers.count, visible, parallel,
+																	[&](std::size_t i) {
+																		const Volumes v = {
+																			centers.x + i, centers.y + i,
+																			centers.z + i, extents.x + i,
+																			extents.y + i, extents.z + i
+																		};
+																		return v;
+																	});
+	}
+	
+	/**
+	 * \brief Cull an array of spheres.
+	 * \arg \c f The frustum
+	 * \arg \c centers The center of each sphere
+	 * \arg \c radii The radius of each sphere
+	 * \arg \c count The number of spheres
+	 * \arg \c visible The bitmask receiving the visibility of each sphere
+	 * \arg \c parallel Options for running on several threads
+	 */
+	template <typename Scalar>
+	void cullSpheres(const Frustum<Scalar> &f, const Point3<Scalar> *centers,
+									 const Scalar *radii, std::size_t count,
+									 std::uint32_t *visible,
+									 const Parallel &parallel = Parallel::serial())
+	{
+		typedef detail::SphereObjects<Scalar> Volumes;
+		detail::cull<Scalar, Volumes>(f, count, visible, parallel,
+																	[&](std::size_t i) {
+																		const Volumes v = { centers + i, radii + i };
+																		return v;
+																	});
+	}
+	
+	/**
+	 * \brief Cull spheres held as arrays of centers and radii.
+	 * \arg \c f The frustum
+	 * \arg \c centers The center of each sphere
+	 * \arg \c radii The radius of each sphere, at least as many as there are
+	 * centers
+	 * \arg \c visible The bitmask receiving the visibility of each sphere
+	 * \arg \c parallel Options for running on several threads
+	 */
+	template <typename Scalar, typename CScalar>
+	void cullSpheres(const Frustum<Scalar> &f, Point3Span<CScalar> centers,
+									 const Scalar *radii, std::uint32_t *visible,
+									 const Parallel &parallel = Parallel::serial())
+	{
+		static_assert(std::is_same<typename Point3Span<CScalar>::type,
+															 Scalar>::value,
+									"The spheres must have the scalar type of the frustum");
+		typedef detail::SphereArrays<Scalar> Volumes;
+		detail::cull<Scalar, Volumes>(f, centers.count, visible, parallel,
+																	[&](std::size_t i) {
+																		const Volumes v = {
+																			centers.x + i, centers.y + i,
+																			centers.z + i, radii + i
+																		};
+																		return v;
+																	});
+	}
+}
+
+#endif
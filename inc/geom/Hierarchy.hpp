@@ -0,0 +1,180 @@
+/**
+ * \file Hierarchy.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Flattening of transform hierarchies into world transforms
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_HIERARCHY_HPP
+#define GEOM_HIERARCHY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Matrix4.hpp"
+#include "Parallel.hpp"
+
+namespace geom {
+	/*
+	 * Transform hierarchies.
+	 *
+	 * A hierarchy of count nodes is described by an array of parent indices,
+	 * with a negative index for the roots, and an array of local transforms
+	 * relative to the parent of each node. The nodes must be sorted parents
+	 * first, so that parents[i] < i, as in the flattened form of a scene
+	 * graph. The world transform of a node is the product of the world
+	 * transform of its parent and its local transform, or its local transform
+	 * for a root.
+	 *
+	 * The products are those of Matrix4.hpp, which use SIMD instructions for
+	 * Matrix4f and Matrix4d, so every way of flattening a hierarchy gives
+	 * identical results.
+	 */
+	
+	/**
+	 * \brief Compute the world transforms of a hierarchy in one pass.
+	 * \arg \c parents The index of the parent of each node, or a negative
+	 * index for a root. Parents must come before their children.
+	 * \arg \c local The transform of each node relative to its parent.
+	 * \arg \c count The number of nodes.
+	 * \arg \c world The array receiving the world transform of each node,
+	 * which must not overlap \c local.
+	 */
+	template <typename Scalar>
+	void flattenHierarchy(const std::int32_t *parents,
+												const Matrix4<Scalar> *local, std::size_t count,
+												Matrix4<Scalar> *world)
+	{
+		for(std::size_t i = 0; i < count; ++i) {
+			const std::int32_t p = parents[i];
+			if(p < 0) {
+				world[i] = local[i];
+			} else {
+				world[i] = world[p] * local[i];
+			}
+		}
+	}
+	
+	/**
+	 * \brief The nodes of a hierarchy grouped by depth.
+	 *
+	 * The world transforms of the nodes at one depth only depend on those of
+	 * the depth above, so each level can be flattened on several threads.
+	 * The levels are built once for the structure of a hierarchy and reused
+	 * for as long as its parent indices do not change.
+	 *
+	 * Flattening by level reads the transforms of each level from wherever
+	 * its nodes are, so it is only as fast as the one pass flattening when
+	 * the nodes are numbered in breadth first order, which keeps every level
+	 * contiguous.
+	 */
+	struct HierarchyLevels {
+		/**
+		 * \brief Construct an empty \c HierarchyLevels object.
+		 */
+		HierarchyLevels() :
+			offsets(1, 0)
+		{ }
+		/**
+		 * \brief Group the nodes of a hierarchy by depth.
+		 * \arg \c parents The index of the parent of each node, or a negative
+		 * index for a root. Parents must come before their children.
+		 * \arg \c count The number of nodes.
+		 */
+		HierarchyLevels(const std::int32_t *parents, std::size_t count) :
+			nodes(count), parents(count), offsets(1, 0)
+		{
+			std::vector<std::uint32_t> depth(count);
+			for(std::size_t i = 0; i < count; ++i) {
+				depth[i] = parents[i] < 0 ? 0 : depth[parents[i]] + 1;
+				if(depth[i] + 2 > offsets.size()) {
+					offsets.resize(depth[i] + 2, 0);
+				}
+				++offsets[depth[i] + 1];
+			}
+			for(std::size_t l = 1; l < offsets.size(); ++l) {
+				offsets[l] += offsets[l - 1];
+			}
+			/* A stable counting sort keeps the nodes of a level in order */
+			std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+			for(std::size_t i = 0; i < count; ++i) {
+				const std::size_t k = next[depth[i]]++;
+				nodes[k] = static_cast<std::uint32_t>(i);
+				this->parents[k] = parents[i];
+			}
+		}
+		
+		/**
+		 * \brief Get the number of levels, the depth of the deepest node plus
+		 * one.
+		 */
+		std::size_t levels() const {
+			return offsets.size() - 1;
+		}
+		
+		/** The index of every node, by level */
+		std::vector<std::uint32_t> nodes;
+		/** The index of the parent of each entry of \c nodes */
+		std::vector<std::int32_t> parents;
+		/** The first entry of each level in \c nodes, and the number of nodes */
+		std::vector<std::size_t> offsets;
+	};
+	
+	/**
+	 * \brief Compute the world transforms of a hierarchy one level at a time.
+	 *
+	 * Levels larger than the threshold of \c parallel are split between
+	 * several threads, see Parallel.hpp; the others, and by default all of
+	 * them, are flattened on the calling thread.
+	 *
+	 * \arg \c levels The nodes of the hierarchy grouped by depth.
+	 * \arg \c local The transform of each node relative to its parent.
+	 * \arg \c world The array receiving the world transform of each node,
+	 * which must not overlap \c local.
+	 * \arg \c parallel Options for running on several threads.
+	 */
+	template <typename Scalar>
+	void flattenHierarchy(const HierarchyLevels &levels,
+												const Matrix4<Scalar> *local, Matrix4<Scalar> *world,
+												const Parallel &parallel = Parallel::serial())
+	{
+		const std::uint32_t *nodes = levels.nodes.data();
+		const std::int32_t *parents = levels.parents.data();
+		const std::size_t roots = levels.offsets[levels.levels() > 0 ? 1 : 0];
+		for(std::size_t k = 0; k < roots; ++k) {
+			world[nodes[k]] = local[nodes[k]];
+		}
+		for(std::size_t l = 1; l < levels.levels(); ++l) {
+			const std::size_t first = levels.offsets[l];
+			detail::parallelFor(levels.offsets[l + 1] - first, parallel,
+													[&](std::size_t begin, std::size_t n) {
+				for(std::size_t k = first + begin; k < first + begin + n; ++k) {
+					world[nodes[k]] = world[parents[k]] * local[nodes[k]];
+				}
+			});
+		}
+	}
+}
+
+#endif
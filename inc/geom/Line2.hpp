@@ -26,8 +26,8 @@
  * IN THE SOFTWARE.
  */
 
-#ifndef GEOM_LINE_3_HPP
-#define GEOM_LINE_3_HPP
+#ifndef GEOM_LINE_2_HPP
+#define GEOM_LINE_2_HPP
 
 #include <cstdint>
 #include "Point2.hpp"
@@ -62,6 +62,7 @@ namespace geom {
 		Line2<Scalar> & operator=(const Line2<Other> &source) {
 			p1 = source.p1;
 			p2 = source.p2;
+			return *this;
 		}
 		
 		Point2<Scalar> p1, p2;
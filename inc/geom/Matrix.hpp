@@ -30,6 +30,8 @@
 #ifndef GEOM_MATRIX_HPP
 #define GEOM_MATRIX_HPP
 
+#include "Affine3.hpp"
+#include "MatrixN.hpp"
 #include "Matrix2.hpp"
 #include "Matrix3.hpp"
 #include "Matrix4.hpp"
@@ -26,98 +26,22 @@
  * IN THE SOFTWARE.
  */
 
-#ifndef GEOM_MATRIX_3_HPP
-#define GEOM_MATRIX_3_HPP
+#ifndef GEOM_MATRIX_2_HPP
+#define GEOM_MATRIX_2_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+#include "MatrixN.hpp"
 
 namespace geom {
   /**
    * \brief A Matrix used to manipulate 2 dimensional geometry.
    * 
-   * The values of the matrix are stored in column major order to match the
-   * format that OpenGL stores matricies in.
+   * This is the 2x2 \c Matrix, see MatrixN.hpp for its operations.
    */
   template <typename Scalar>
-  struct Matrix2 {
-    /**
-     * \brief Construct a null \c Matrix2 object
-     * 
-     * This matrix will zero any other matrix multiplied by it. That is,
-     * given \c Matrix2 A and \c Matrix2 B where A is null, A*B = [0...]
-     */
-    Matrix2() :
-      values{0,0,0,0}
-    { }
-    /**
-     * \brief Construct a \c Matrix2 object with the given values.
-     * 
-     * The values passed into this constructor are expected in
-     * row-major order and are then shuffled into column-major order in the
-     * initializer list. This is done because matrices are more intuitively
-     * described in row-major order, yet the internal ordering is column major.
-     */
-    Matrix2(Scalar r1c1, Scalar r1c2, Scalar r2c1, Scalar r2c2) :
-			values{r1c1, r2c1, r1c2, r2c2}
-    { }
-    /**
-     * \brief Construct a \c Matrix2 object which is a copy of the given
-     * \c Matrix2 object.
-     * \arg \c source The \c Matrix2 object to copy
-     */
-    Matrix2(const Matrix2<Scalar> &source) :
-      values{source.values[0], source.values[1], source.values[2],
-				source.values[3]}
-    { }
-    
-    /**
-     * \brief Construct a \c Matrix2 object which is a conversion of the given
-     * \c Matrix2 object.
-     * \arg \c source The \c Matrix2 object to copy
-     */
-    template <typename Other>
-    Matrix2(const Matrix2<Other> &source) :
-      values{static_cast<Scalar>(source.values[0]),
-				static_cast<Scalar>(source.values[1]),
-				static_cast<Scalar>(source.values[2]),
-				static_cast<Scalar>(source.values[3])}
-    { }
-    
-    ~Matrix2() = default;
-    
-    /**
-     * \brief Assign values from the given \c Matrix2 object.
-     * \arg \c source The \c Matrix2 to assign values from
-     * \return A reference to the \c Matrix2 object being assigned to
-     */
-    Matrix2<Scalar> & operator=(const Matrix2<Scalar> &source) {
-      values[0] = source.values[0];
-      values[1] = source.values[1];
-      values[2] = source.values[2];
-      values[3] = source.values[3];
-      return *this;
-    }
-    /**
-     * \brief Assign converted values from the given \c Matrix2 object.
-     * \arg \c source The \c Matrix2 to assign converted values from
-     * \return A reference to the \c Matrix2 object being assigned to
-     */
-    template <typename Other>
-    Matrix2<Scalar> & operator=(const Matrix2<Other> &source) {
-      values[0] = static_cast<Scalar>(source.values[0]);
-      values[1] = static_cast<Scalar>(source.values[1]);
-      values[2] = static_cast<Scalar>(source.values[2]);
-      values[3] = static_cast<Scalar>(source.values[3]);
-      return *this;
-    }
-    
-    /**
-     * \brief The array of values stored in the matrix.
-     * 
-     * The values are stored in column-major value inside the array. To index
-     * a value in the matrix of the form [i][j] the index would be
-     * \f$i*2+j\f$.
-     */
-    Scalar values[4];
-  };
+  using Matrix2 = Matrix<2, 2, Scalar>;
   
   typedef Matrix2<std::int32_t> Matrix2i;
   typedef Matrix2<std::uint32_t> Matrix2u;
@@ -125,6 +49,32 @@ namespace geom {
   typedef Matrix2<std::uint64_t> Matrix2ul;
   typedef Matrix2<float> Matrix2f;
   typedef Matrix2<double> Matrix2d;
+	
+	/**
+	 * \brief Calculate the determinant of a \c Matrix2 object.
+	 * \arg \c m The matrix
+	 * \return The determinant of \c m
+	 */
+	template <typename Scalar>
+	Scalar determinant(const Matrix2<Scalar> &m) {
+		return m.values[0] * m.values[3] - m.values[2] * m.values[1];
+	}
+	
+	/**
+	 * \brief Invert a \c Matrix2 object.
+	 * \arg \c m The matrix to invert, of a floating point type. It must not
+	 * be singular, which can be checked with \c determinant.
+	 * \return A new \c Matrix2 object such that m * inverse(m) is the
+	 * identity
+	 */
+	template <typename Scalar>
+	Matrix2<Scalar> inverse(const Matrix2<Scalar> &m) {
+		static_assert(std::is_floating_point<Scalar>::value,
+									"The inverse needs a floating point type");
+		const Scalar s = Scalar(1) / determinant(m);
+		return Matrix2<Scalar>(m.values[3] * s, -m.values[2] * s,
+													 -m.values[1] * s, m.values[0] * s);
+	}
 }
 
 #endif
@@ -29,113 +29,21 @@
 #ifndef GEOM_MATRIX_3_HPP
 #define GEOM_MATRIX_3_HPP
 
+#include <cstdint>
+#include <type_traits>
+
+#include "MatrixN.hpp"
+
 namespace geom {
   /**
    * \brief A Matrix used to manipulate 2 dimensional geometry.
    * 
-   * The values of the matrix are stored in column major order to match the
-   * format that OpenGL stores matricies in.
+   * This is the 3x3 \c Matrix, see MatrixN.hpp for its operations. It
+   * transforms \c Vector3 objects, and \c Point2 and \c Vector2 objects in
+   * homogeneous coordinates.
    */
   template <typename Scalar>
-  struct Matrix3 {
-    /**
-     * \brief Construct a null \c Matrix3 object
-     * 
-     * This matrix will zero any other matrix multiplied by it. That is,
-     * given \c Matrix3 A and \c Matrix3 B where A is null, A*B = [0...]
-     */
-    Matrix3() :
-      values{0,0,0,0,0,0,0,0,0}
-    { }
-    /**
-     * \brief Construct a \c Matrix3 object with the given values.
-     * 
-     * The values passed into this constructor are expected in
-     * row-major order and are then shuffled into column-major order in the
-     * initializer list. This is done because matrices are more intuitively
-     * described in row-major order, yet the internal ordering is column major.
-     */
-    Matrix3(Scalar r1c1, Scalar r1c2, Scalar r1c3,
-	    Scalar r2c1, Scalar r2c2, Scalar r2c3,
-	    Scalar r3c1, Scalar r3c2, Scalar r3c3) :
-      values{r1c1, r2c1, r3c1, r1c2, r2c2, r3c2, r1c3, r2c3, r3c3}
-    { }
-    /**
-     * \brief Construct a \c Matrix3 object which is a copy of the given
-     * \c Matrix3 object.
-     * \arg \c source The \c Matrix3 object to copy
-     */
-    Matrix3(const Matrix3<Scalar> &source) :
-      values{source.values[0], source.values[1], source.values[2],
-	source.values[3], source.values[4], source.values[5],
-	source.values[6], source.values[7], source.values[8]}
-    { }
-    
-    /**
-     * \brief Construct a \c Matrix3 object which is a conversion of the given
-     * \c Matrix3 object.
-     * \arg \c source The \c Matrix3 object to copy
-     */
-    template <typename Other>
-    Matrix3(const Matrix3<Other> &source) :
-      values{static_cast<Scalar>(source.values[0]),
-	static_cast<Scalar>(source.values[1]),
-	static_cast<Scalar>(source.values[2]),
-	static_cast<Scalar>(source.values[3]),
-	static_cast<Scalar>(source.values[4]),
-	static_cast<Scalar>(source.values[5]),
-	static_cast<Scalar>(source.values[6]),
-	static_cast<Scalar>(source.values[7]),
-	static_cast<Scalar>(source.values[8])}
-    { }
-    
-    ~Matrix3() = default;
-    
-    /**
-     * \brief Assign values from the given \c Matrix3 object.
-     * \arg \c source The \c Matrix3 to assign values from
-     * \return A reference to the \c Matrix3 object being assigned to
-     */
-    Matrix3<Scalar> & operator=(const Matrix3<Scalar> &source) {
-      values[0] = source.values[0];
-      values[1] = source.values[1];
-      values[2] = source.values[2];
-      values[3] = source.values[3];
-      values[4] = source.values[4];
-      values[5] = source.values[5];
-      values[6] = source.values[6];
-      values[7] = source.values[7];
-      values[8] = source.values[8];
-      return *this;
-    }
-    /**
-     * \brief Assign converted values from the given \c Matrix3 object.
-     * \arg \c source The \c Matrix3 to assign converted values from
-     * \return A reference to the \c Matrix3 object being assigned to
-     */
-    template <typename Other>
-    Matrix3<Scalar> & operator=(const Matrix3<Other> &source) {
-      values[0] = static_cast<Scalar>(source.values[0]);
-      values[1] = static_cast<Scalar>(source.values[1]);
-      values[2] = static_cast<Scalar>(source.values[2]);
-      values[3] = static_cast<Scalar>(source.values[3]);
-      values[4] = static_cast<Scalar>(source.values[4]);
-      values[5] = static_cast<Scalar>(source.values[5]);
-      values[6] = static_cast<Scalar>(source.values[6]);
-      values[7] = static_cast<Scalar>(source.values[7]);
-      values[8] = static_cast<Scalar>(source.values[8]);
-      return *this;
-    }
-    
-    /**
-     * \brief The array of values stored in the matrix.
-     * 
-     * The values are stored in column-major value inside the array. To index
-     * a value in the matrix of the form [i][j] the index would be
-     * \f$i*3+j\f$.
-     */
-    Scalar values[9];
-  };
+  using Matrix3 = Matrix<3, 3, Scalar>;
   
   typedef Matrix3<std::int32_t> Matrix3i;
   typedef Matrix3<std::uint32_t> Matrix3u;
@@ -143,6 +51,51 @@ namespace geom {
   typedef Matrix3<std::uint64_t> Matrix3ul;
   typedef Matrix3<float> Matrix3f;
   typedef Matrix3<double> Matrix3d;
+	
+	/**
+	 * \brief Calculate the determinant of a \c Matrix3 object.
+	 * \arg \c m The matrix
+	 * \return The determinant of \c m
+	 */
+	template <typename Scalar>
+	Scalar determinant(const Matrix3<Scalar> &m) {
+		const Scalar *v = m.values;
+		return v[0] * (v[4] * v[8] - v[7] * v[5]) +
+			v[3] * (v[7] * v[2] - v[1] * v[8]) +
+			v[6] * (v[1] * v[5] - v[4] * v[2]);
+	}
+	
+	/**
+	 * \brief Invert a \c Matrix3 object through its adjugate.
+	 * \arg \c m The matrix to invert, of a floating point type. It must not
+	 * be singular, which can be checked with \c determinant.
+	 * \return A new \c Matrix3 object such that m * inverse(m) is the
+	 * identity
+	 */
+	template <typename Scalar>
+	Matrix3<Scalar> inverse(const Matrix3<Scalar> &m) {
+		static_assert(std::is_floating_point<Scalar>::value,
+									"The inverse needs a floating point type");
+		const Scalar *v = m.values;
+		/* The cofactors of the first column give the determinant */
+		const Scalar c0 = v[4] * v[8] - v[7] * v[5];
+		const Scalar c1 = v[7] * v[2] - v[1] * v[8];
+		const Scalar c2 = v[1] * v[5] - v[4] * v[2];
+		const Scalar s = Scalar(1) / (v[0] * c0 + v[3] * c1 + v[6] * c2);
+		/* The cofactors are the columns of the inverse, in storage order */
+		Matrix3<Scalar> r;
+		Scalar *o = r.values;
+		o[0] = c0 * s;
+		o[1] = c1 * s;
+		o[2] = c2 * s;
+		o[3] = (v[6] * v[5] - v[3] * v[8]) * s;
+		o[4] = (v[0] * v[8] - v[6] * v[2]) * s;
+		o[5] = (v[3] * v[2] - v[0] * v[5]) * s;
+		o[6] = (v[3] * v[7] - v[6] * v[4]) * s;
+		o[7] = (v[6] * v[1] - v[0] * v[7]) * s;
+		o[8] = (v[0] * v[4] - v[3] * v[1]) * s;
+		return r;
+	}
 }
 
 #endif
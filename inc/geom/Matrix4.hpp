@@ -26,141 +26,37 @@
  * IN THE SOFTWARE.
  */
 
-#ifndef GEOM_MATRIX_3_HPP
-#define GEOM_MATRIX_3_HPP
+#ifndef GEOM_MATRIX_4_HPP
+#define GEOM_MATRIX_4_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "Matrix3.hpp"
+#include "MatrixN.hpp"
+#include "Point3.hpp"
+#include "Simd.hpp"
+#include "Vector3.hpp"
+#include "Vector4.hpp"
+#include "VectorTraits.hpp"
 
 namespace geom {
   /**
-   * \brief A Matrix used to manipulate 2 dimensional geometry.
+   * \brief A Matrix used to manipulate 3 dimensional geometry in homogeneous
+   * coordinates.
    * 
-   * The values of the matrix are stored in column major order to match the
-   * format that OpenGL stores matricies in.
+   * This is the 4x4 \c Matrix, see MatrixN.hpp for its operations and for
+   * the \c translate, \c scale and \c rotate builders.
+   *
+   * Like \c Vector4, matrices of 4 byte components are 16 byte aligned and
+   * the products of \c Matrix4f and \c Matrix4d are implemented with SSE/AVX
+   * instructions when those are available, see Simd.hpp.
    */
   template <typename Scalar>
-  struct Matrix4 {
-    /**
-     * \brief Construct a null \c Matrix4 object
-     * 
-     * This matrix will zero any other matrix multiplied by it. That is,
-     * given \c Matrix4 A and \c Matrix4 B where A is null, A*B = [0...]
-     */
-    Matrix4() :
-      values{0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}
-    { }
-    /**
-     * \brief Construct a \c Matrix4 object with the given values.
-     * 
-     * The values passed into this constructor are expected in
-     * row-major order and are then shuffled into column-major order in the
-     * initializer list. This is done because matrices are more intuitively
-     * described in row-major order, yet the internal ordering is column major.
-     */
-    Matrix4(Scalar r1c1, Scalar r1c2, Scalar r1c3, Scalar r1c4,
-						Scalar r2c1, Scalar r2c2, Scalar r2c3, Scalar r2c4,
-						Scalar r3c1, Scalar r3c2, Scalar r3c3, Scalar r3c4,
-						Scalar r4c1, Scalar r4c2, Scalar r4c3, Scalar r4c4,) :
-			values{r1c1, r2c1, r3c1, r4c1, r2c1, r2c2, r2c3, r2c4,
-				r3c1, r3c2, r3c3, r3c4, r4c1, r4c2, r4c3, r4c4}
-    { }
-    /**
-     * \brief Construct a \c Matrix4 object which is a copy of the given
-     * \c Matrix4 object.
-     * \arg \c source The \c Matrix4 object to copy
-     */
-    Matrix4(const Matrix4<Scalar> &source) :
-      values{source.values[0], source.values[1], source.values[2],
-				source.values[3], source.values[4], source.values[5],	source.values[6],
-				source.values[7], source.values[8], source.values[9],
-				source.values[10], souce.values[11], source.values[12],
-				source.values[13], source.values[14], source.values[15]}
-    { }
-    
-    /**
-     * \brief Construct a \c Matrix4 object which is a conversion of the given
-     * \c Matrix4 object.
-     * \arg \c source The \c Matrix4 object to copy
-     */
-    template <typename Other>
-    Matrix4(const Matrix4<Other> &source) :
-      values{static_cast<Scalar>(source.values[0]),
-				static_cast<Scalar>(source.values[1]),
-				static_cast<Scalar>(source.values[2]),
-				static_cast<Scalar>(source.values[3]),
-				static_cast<Scalar>(source.values[4]),
-				static_cast<Scalar>(source.values[5]),
-				static_cast<Scalar>(source.values[6]),
-				static_cast<Scalar>(source.values[7]),
-				static_cast<Scalar>(source.values[8]),
-				static_cast<Scalar>(source.values[9]),
-				static_cast<Scalar>(source.values[10]),
-				static_cast<Scalar>(source.values[11]),
-				static_cast<Scalar>(source.values[12]),
-				static_cast<Scalar>(source.values[13]),
-				static_cast<Scalar>(source.values[14]),
-				static_cast<Scalar>(source.values[15])}
-    { }
-    
-    ~Matrix4() = default;
-    
-    /**
-     * \brief Assign values from the given \c Matrix4 object.
-     * \arg \c source The \c Matrix4 to assign values from
-     * \return A reference to the \c Matrix4 object being assigned to
-     */
-    Matrix4<Scalar> & operator=(const Matrix4<Scalar> &source) {
-      values[0]  = source.values[0];
-      values[1]  = source.values[1];
-      values[2]  = source.values[2];
-      values[3]  = source.values[3];
-      values[4]  = source.values[4];
-      values[5]  = source.values[5];
-      values[6]  = source.values[6];
-      values[7]  = source.values[7];
-      values[8]  = source.values[8];
-      values[9]  = source.values[9];
-      values[10] = source.values[10];
-      values[11] = source.values[11];
-      values[12] = source.values[12];
-      values[13] = source.values[13];
-      values[14] = source.values[14];
-      values[15] = source.values[15];
-      return *this;
-    }
-    /**
-     * \brief Assign converted values from the given \c Matrix4 object.
-     * \arg \c source The \c Matrix4 to assign converted values from
-     * \return A reference to the \c Matrix4 object being assigned to
-     */
-    template <typename Other>
-    Matrix4<Scalar> & operator=(const Matrix4<Other> &source) {
-      values[0]  = static_cast<Scalar>(source.values[0]);
-      values[1]  = static_cast<Scalar>(source.values[1]);
-      values[2]  = static_cast<Scalar>(source.values[2]);
-      values[3]  = static_cast<Scalar>(source.values[3]);
-      values[4]  = static_cast<Scalar>(source.values[4]);
-      values[5]  = static_cast<Scalar>(source.values[5]);
-      values[6]  = static_cast<Scalar>(source.values[6]);
-      values[7]  = static_cast<Scalar>(source.values[7]);
-      values[8]  = static_cast<Scalar>(source.values[8]);
-      values[9]  = static_cast<Scalar>(source.values[9]);
-      values[10] = static_cast<Scalar>(source.values[10]);
-      values[11] = static_cast<Scalar>(source.values[11]);
-      values[12] = static_cast<Scalar>(source.values[12]);
-      values[13] = static_cast<Scalar>(source.values[13]);
-      values[14] = static_cast<Scalar>(source.values[14]);
-      values[15] = static_cast<Scalar>(source.values[15]);
-      return *this;
-    }
-    
-    /**
-     * \brief The array of values stored in the matrix.
-     * 
-     * The values are stored in column-major value inside the array. To index
-     * a value in the matrix of the form [i][j] the index would be
-     * \f$i*4+j\f$.
-     */
-    Scalar values[16];
-  };
+  using Matrix4 = Matrix<4, 4, Scalar>;
   
   typedef Matrix4<std::int32_t> Matrix4i;
   typedef Matrix4<std::uint32_t> Matrix4u;
@@ -168,6 +64,688 @@ namespace geom {
   typedef Matrix4<std::uint64_t> Matrix4ul;
   typedef Matrix4<float> Matrix4f;
   typedef Matrix4<double> Matrix4d;
+	
+	namespace detail {
+		/*
+		 * The products of Matrix4f and Matrix4d are computed by the functions
+		 * below on matrices of a single type, in the same way as the Vector4
+		 * operators, with each column of the matrix in a SIMD register. Other
+		 * types use the unrolled products of MatrixN.hpp.
+		 *
+		 * Every element of a product is summed in the same order,
+		 * ((c0 + c1) + c2) + c3 over the columns of the left operand, by both
+		 * the unrolled and the packed code so that they give identical results,
+		 * unless the compiler contracts them into fused multiply-adds, see
+		 * Simd.hpp.
+		 */
+		/*
+		 * Operands already of the result type are passed through rather than
+		 * copied; an element-wise copy read back with vector loads stalls on
+		 * store forwarding.
+		 */
+		template <typename Result>
+		const Matrix4<Result> & convert4(const Matrix4<Result> &m) {
+			return m;
+		}
+		template <typename Result, typename Other>
+		typename std::enable_if<!std::is_same<Result,Other>::value,
+														Matrix4<Result>>::type
+		convert4(const Matrix4<Other> &m) {
+			return Matrix4<Result>(m);
+		}
+		
+#if defined(GEOM_SSE2)
+		inline simd::Float4 loadColumn4(const float *p) {
+			return simd::Float4::load(p);
+		}
+		inline void storeColumn4(const simd::Float4 &r, float *p) {
+			r.store(p);
+		}
+#  if defined(GEOM_AVX)
+		inline Double4Register loadColumn4(const double *p) {
+			return Double4Register::load(p);
+		}
+		inline void storeColumn4(const Double4Register &r, double *p) {
+			r.store(p);
+		}
+#  else
+		inline Double4Register loadColumn4(const double *p) {
+			return Double4Register(simd::Double2::load(p),
+														 simd::Double2::load(p + 2));
+		}
+		inline void storeColumn4(const Double4Register &r, double *p) {
+			r.lo.store(p);
+			r.hi.store(p + 2);
+		}
+#  endif
+		
+		/*
+		 * The kernels take the column major values of their operands and of
+		 * the result.
+		 */
+		template <typename S>
+		Packed4<S,void> mul44(const S *a, const S *c, S *r) {
+			typedef typename Vector4Register<S>::type Register;
+			const Register c0 = loadColumn4(a);
+			const Register c1 = loadColumn4(a + 4);
+			const Register c2 = loadColumn4(a + 8);
+			const Register c3 = loadColumn4(a + 12);
+			/*
+			 * Unrolled so that the compiler sees every element of r written and
+			 * drops the zeroing of its constructor.
+			 */
+			storeColumn4(c0 * Register::set1(c[0]) + c1 * Register::set1(c[1]) +
+									 c2 * Register::set1(c[2]) + c3 * Register::set1(c[3]),
+									 r);
+			storeColumn4(c0 * Register::set1(c[4]) + c1 * Register::set1(c[5]) +
+									 c2 * Register::set1(c[6]) + c3 * Register::set1(c[7]),
+									 r + 4);
+			storeColumn4(c0 * Register::set1(c[8]) + c1 * Register::set1(c[9]) +
+									 c2 * Register::set1(c[10]) + c3 * Register::set1(c[11]),
+									 r + 8);
+			storeColumn4(c0 * Register::set1(c[12]) + c1 * Register::set1(c[13]) +
+									 c2 * Register::set1(c[14]) + c3 * Register::set1(c[15]),
+									 r + 12);
+		}
+		/*
+		 * The product of a and the transpose of b, which reads the elements of
+		 * each column of b^T from a row of b. The elements are summed in the
+		 * same order as by mul44.
+		 */
+		template <typename S>
+		Packed4<S,void> mul44t(const S *a, const S *c, S *r) {
+			typedef typename Vector4Register<S>::type Register;
+			const Register c0 = loadColumn4(a);
+			const Register c1 = loadColumn4(a + 4);
+			const Register c2 = loadColumn4(a + 8);
+			const Register c3 = loadColumn4(a + 12);
+			storeColumn4(c0 * Register::set1(c[0]) + c1 * Register::set1(c[4]) +
+									 c2 * Register::set1(c[8]) + c3 * Register::set1(c[12]),
+									 r);
+			storeColumn4(c0 * Register::set1(c[1]) + c1 * Register::set1(c[5]) +
+									 c2 * Register::set1(c[9]) + c3 * Register::set1(c[13]),
+									 r + 4);
+			storeColumn4(c0 * Register::set1(c[2]) + c1 * Register::set1(c[6]) +
+									 c2 * Register::set1(c[10]) + c3 * Register::set1(c[14]),
+									 r + 8);
+			storeColumn4(c0 * Register::set1(c[3]) + c1 * Register::set1(c[7]) +
+									 c2 * Register::set1(c[11]) + c3 * Register::set1(c[15]),
+									 r + 12);
+		}
+		template <typename S>
+		Packed4<S> mul4v(const Matrix4<S> &a, const Vector4<S> &v) {
+			typedef typename Vector4Register<S>::type Register;
+			Vector4<S> r;
+			store4(loadColumn4(a.values) * Register::set1(v.x) +
+						 loadColumn4(a.values + 4) * Register::set1(v.y) +
+						 loadColumn4(a.values + 8) * Register::set1(v.z) +
+						 loadColumn4(a.values + 12) * Register::set1(v.w), r);
+			return r;
+		}
+#  if defined(GEOM_AVX512)
+		/*
+		 * With AVX-512 a whole Matrix4f fits in one register: each column of the
+		 * left operand is repeated in all four quarters and multiplied by the
+		 * matching elements of every column of the right operand. Matrix4d
+		 * products work the same way on two columns per register.
+		 *
+		 * The zero-masked forms of the intrinsics are used with full masks
+		 * because the unmasked ones trip -Wmaybe-uninitialized in GCC.
+		 */
+		inline __m512 repeat4(const float *p) {
+			return _mm512_maskz_broadcast_f32x4(0xFFFF, _mm_loadu_ps(p));
+		}
+		inline __m512d repeat4(const double *p) {
+			return _mm512_maskz_broadcast_f64x4(0xFF, _mm256_loadu_pd(p));
+		}
+		
+		/* The product of m and the matrix whose column major values are c */
+		inline __m512 mulColumns4(const float *m, __m512 c) {
+			__m512 p = _mm512_mul_ps(repeat4(m), _mm512_shuffle_ps(c, c, 0x00));
+			p = _mm512_add_ps(p, _mm512_mul_ps(repeat4(m + 4),
+																				 _mm512_shuffle_ps(c, c, 0x55)));
+			p = _mm512_add_ps(p, _mm512_mul_ps(repeat4(m + 8),
+																				 _mm512_shuffle_ps(c, c, 0xAA)));
+			return _mm512_add_ps(p, _mm512_mul_ps(repeat4(m + 12),
+																						_mm512_shuffle_ps(c, c, 0xFF)));
+		}
+		inline void mul44(const float *m, const float *b, float *r) {
+			_mm512_storeu_ps(r, mulColumns4(m, _mm512_loadu_ps(b)));
+		}
+		/*
+		 * The transpose of b is a single permute away, which is cheaper than
+		 * broadcasting its elements one by one as the generic kernel does.
+		 */
+		inline void mul44t(const float *m, const float *b, float *r) {
+			const __m512i t = _mm512_set_epi32(15, 11, 7, 3, 14, 10, 6, 2,
+																				 13, 9, 5, 1, 12, 8, 4, 0);
+			const __m512 c = _mm512_maskz_permutexvar_ps(0xFFFF, t,
+																									 _mm512_loadu_ps(b));
+			_mm512_storeu_ps(r, mulColumns4(m, c));
+		}
+		/* Two columns of a Matrix4d product, from two columns c of b */
+		inline __m512d mulColumns2(__m512d c0, __m512d c1, __m512d c2,
+															 __m512d c3, __m512d c)
+		{
+			__m512d p = _mm512_mul_pd(c0, _mm512_maskz_permutex_pd(0xFF, c, 0x00));
+			p = _mm512_add_pd(p, _mm512_mul_pd(
+													c1, _mm512_maskz_permutex_pd(0xFF, c, 0x55)));
+			p = _mm512_add_pd(p, _mm512_mul_pd(
+													c2, _mm512_maskz_permutex_pd(0xFF, c, 0xAA)));
+			return _mm512_add_pd(p, _mm512_mul_pd(
+															 c3, _mm512_maskz_permutex_pd(0xFF, c, 0xFF)));
+		}
+		inline void mul44(const double *m, const double *b, double *r) {
+			const __m512d c0 = repeat4(m), c1 = repeat4(m + 4);
+			const __m512d c2 = repeat4(m + 8), c3 = repeat4(m + 12);
+			_mm512_storeu_pd(r, mulColumns2(c0, c1, c2, c3, _mm512_loadu_pd(b)));
+			_mm512_storeu_pd(r + 8, mulColumns2(c0, c1, c2, c3,
+																					_mm512_loadu_pd(b + 8)));
+		}
+		inline void mul44t(const double *m, const double *b, double *r) {
+			const __m512d c0 = repeat4(m), c1 = repeat4(m + 4);
+			const __m512d c2 = repeat4(m + 8), c3 = repeat4(m + 12);
+			const __m512d lo = _mm512_loadu_pd(b), hi = _mm512_loadu_pd(b + 8);
+			const __m512i t01 = _mm512_set_epi64(13, 9, 5, 1, 12, 8, 4, 0);
+			const __m512i t23 = _mm512_set_epi64(15, 11, 7, 3, 14, 10, 6, 2);
+			_mm512_storeu_pd(r, mulColumns2(c0, c1, c2, c3,
+																			_mm512_permutex2var_pd(lo, t01, hi)));
+			_mm512_storeu_pd(r + 8, mulColumns2(c0, c1, c2, c3,
+																					_mm512_permutex2var_pd(lo, t23, hi)));
+		}
+#  elif defined(GEOM_AVX)
+		/*
+		 * With AVX two columns of a Matrix4f product are computed at once: each
+		 * column of the left operand is repeated in both halves of a register
+		 * and multiplied by the matching elements of two columns of the right
+		 * operand.
+		 */
+		inline simd::Float8 mulColumns2(const simd::Float8 &c0,
+																		const simd::Float8 &c1,
+																		const simd::Float8 &c2,
+																		const simd::Float8 &c3, const float *b)
+		{
+			typedef simd::Float8 Register;
+			const __m256 c = _mm256_loadu_ps(b);
+			return c0 * Register(_mm256_shuffle_ps(c, c, 0x00)) +
+				c1 * Register(_mm256_shuffle_ps(c, c, 0x55)) +
+				c2 * Register(_mm256_shuffle_ps(c, c, 0xAA)) +
+				c3 * Register(_mm256_shuffle_ps(c, c, 0xFF));
+		}
+		inline void mul44(const float *m, const float *b, float *r) {
+			typedef simd::Float8 Register;
+			const Register c0 = _mm256_broadcast_ps((const __m128 *)m);
+			const Register c1 = _mm256_broadcast_ps((const __m128 *)(m + 4));
+			const Register c2 = _mm256_broadcast_ps((const __m128 *)(m + 8));
+			const Register c3 = _mm256_broadcast_ps((const __m128 *)(m + 12));
+			mulColumns2(c0, c1, c2, c3, b).store(r);
+			mulColumns2(c0, c1, c2, c3, b + 8).store(r + 8);
+		}
+#  endif
+#endif
+	}
+	
+#if defined(GEOM_SSE2)
+	/**
+	 * \brief Multiply two \c Matrix4 objects of a floating point type with
+	 * SIMD instructions.
+	 * 
+	 * The products of \c Matrix4f and \c Matrix4d are not constant
+	 * expressions when SSE is available; the unrolled product of MatrixN.hpp
+	 * gives the same result and is used for every other type.
+	 * 
+	 * \arg \c lhs The matrix on the left side of the product
+	 * \arg \c rhs The matrix on the right side of the product, which is the
+	 * transformation applied first
+	 * \return A new \c Matrix4 object holding the product
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	detail::Packed4<Result, Matrix4<Result>>
+	operator*(const Matrix4<LType> &lhs, const Matrix4<RType> &rhs) {
+		Matrix4<Result> r;
+		detail::mul44(detail::convert4<Result>(lhs).values,
+									detail::convert4<Result>(rhs).values, r.values);
+		return r;
+	}
+	/**
+	 * \brief Multiply two row major 4x4 \c Matrix objects of a floating point
+	 * type with SIMD instructions.
+	 * 
+	 * The row major values of a product are the column major values of its
+	 * transpose, \f$(AB)^T = B^T A^T\f$, so this is the column major product
+	 * of the operands swapped.
+	 */
+	template <typename Scalar>
+	detail::Packed4<Scalar, Matrix<4, 4, Scalar, RowMajor>>
+	operator*(const Matrix<4, 4, Scalar, RowMajor> &lhs,
+						const Matrix<4, 4, Scalar, RowMajor> &rhs)
+	{
+		Matrix<4, 4, Scalar, RowMajor> r;
+		detail::mul44(rhs.values, lhs.values, r.values);
+		return r;
+	}
+	/**
+	 * \brief Multiply a \c Matrix4 object by the transpose of another of the
+	 * same floating point type, viewed with \c transposeView, with SIMD
+	 * instructions.
+	 * 
+	 * The elements of the transpose are broadcast from the rows of the viewed
+	 * matrix, so \c A*transposeView(B) is as fast as \c A*B and faster than
+	 * \c A*transpose(B), which makes a transposed copy first.
+	 * 
+	 * \arg \c lhs The matrix on the left side of the product
+	 * \arg \c rhs The transposed view on the right side of the product
+	 * \return A new \c Matrix4 object holding the product
+	 */
+	template <typename Scalar>
+	detail::Packed4<Scalar, Matrix4<Scalar>>
+	operator*(const Matrix4<Scalar> &lhs,
+						const MatrixView<4, 4, Scalar, RowMajor> &rhs)
+	{
+		Matrix4<Scalar> r;
+		detail::mul44t(lhs.values, rhs.values, r.values);
+		return r;
+	}
+	
+	/**
+	 * \brief Transform a \c Vector4 object by a \c Matrix4 object of a
+	 * floating point type with SIMD instructions.
+	 * \arg \c lhs The transformation matrix
+	 * \arg \c rhs The column vector to transform
+	 * \return A new \c Vector4 object holding the transformed vector
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	detail::Packed4<Result>
+	operator*(const Matrix4<LType> &lhs, const Vector4<RType> &rhs) {
+		return detail::mul4v(detail::convert4<Result>(lhs), Vector4<Result>(rhs));
+	}
+#endif
+	
+#if defined(GEOM_AVX)
+	/**
+	 * \brief Transpose a \c Matrix4d object with AVX instructions.
+	 * 
+	 * Other types, including \c Matrix4f whose unrolled transpose is faster
+	 * than shuffles, use the \c transpose of MatrixN.hpp.
+	 * 
+	 * \arg \c m The matrix to transpose
+	 * \return A new \c Matrix4d object whose rows are the columns of \c m
+	 */
+	inline Matrix4<double> transpose(const Matrix4<double> &m) {
+		const __m256d c0 = _mm256_loadu_pd(m.values);
+		const __m256d c1 = _mm256_loadu_pd(m.values + 4);
+		const __m256d c2 = _mm256_loadu_pd(m.values + 8);
+		const __m256d c3 = _mm256_loadu_pd(m.values + 12);
+		const __m256d e01 = _mm256_unpacklo_pd(c0, c1);
+		const __m256d o01 = _mm256_unpackhi_pd(c0, c1);
+		const __m256d e23 = _mm256_unpacklo_pd(c2, c3);
+		const __m256d o23 = _mm256_unpackhi_pd(c2, c3);
+		Matrix4<double> r;
+		_mm256_storeu_pd(r.values, _mm256_permute2f128_pd(e01, e23, 0x20));
+		_mm256_storeu_pd(r.values + 4, _mm256_permute2f128_pd(o01, o23, 0x20));
+		_mm256_storeu_pd(r.values + 8, _mm256_permute2f128_pd(e01, e23, 0x31));
+		_mm256_storeu_pd(r.values + 12, _mm256_permute2f128_pd(o01, o23, 0x31));
+		return r;
+	}
+#endif
+	
+	/**
+	 * \brief Transform a \c Point3 object by a projective \c Matrix4 object.
+	 * 
+	 * As the product with a \c Point3, followed by the division of the result
+	 * by its w coordinate.
+	 * 
+	 * \arg \c m The transformation matrix
+	 * \arg \c p The point to transform
+	 * \return A new \c Point3 object holding the projected point
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Point3<Result> project(const Matrix4<LType> &m, const Point3<RType> &p) {
+		const Vector4<Result> r(m * Vector4<Result>(p.x, p.y, p.z, 1));
+		return Point3<Result>(r.x / r.w, r.y / r.w, r.z / r.w);
+	}
+	
+	namespace detail {
+		/*
+		 * The general inverse is the adjugate divided by the determinant, both
+		 * built from the 2x2 determinants of the top and bottom two rows.
+		 *
+		 * The code reads the column-major values as if they were row-major,
+		 * that is it inverts the transpose; since the inverse of the transpose
+		 * is the transpose of the inverse, writing the result back the same
+		 * way gives the inverse in column-major order.
+		 */
+		template <typename S>
+		S determinant44(const Matrix4<S> &m) {
+			const S *a = m.values;
+			const S s0 = a[0] * a[5] - a[4] * a[1];
+			const S s1 = a[0] * a[6] - a[4] * a[2];
+			const S s2 = a[0] * a[7] - a[4] * a[3];
+			const S s3 = a[1] * a[6] - a[5] * a[2];
+			const S s4 = a[1] * a[7] - a[5] * a[3];
+			const S s5 = a[2] * a[7] - a[6] * a[3];
+			const S c5 = a[10] * a[15] - a[14] * a[11];
+			const S c4 = a[9] * a[15] - a[13] * a[11];
+			const S c3 = a[9] * a[14] - a[13] * a[10];
+			const S c2 = a[8] * a[15] - a[12] * a[11];
+			const S c1 = a[8] * a[14] - a[12] * a[10];
+			const S c0 = a[8] * a[13] - a[12] * a[9];
+			return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+		}
+		
+		template <typename S>
+		void inverse44(const Matrix4<S> &m, Matrix4<S> &r) {
+			const S *a = m.values;
+			const S s0 = a[0] * a[5] - a[4] * a[1];
+			const S s1 = a[0] * a[6] - a[4] * a[2];
+			const S s2 = a[0] * a[7] - a[4] * a[3];
+			const S s3 = a[1] * a[6] - a[5] * a[2];
+			const S s4 = a[1] * a[7] - a[5] * a[3];
+			const S s5 = a[2] * a[7] - a[6] * a[3];
+			const S c5 = a[10] * a[15] - a[14] * a[11];
+			const S c4 = a[9] * a[15] - a[13] * a[11];
+			const S c3 = a[9] * a[14] - a[13] * a[10];
+			const S c2 = a[8] * a[15] - a[12] * a[11];
+			const S c1 = a[8] * a[14] - a[12] * a[10];
+			const S c0 = a[8] * a[13] - a[12] * a[9];
+			const S d = S(1) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 +
+													s5 * c0);
+			/* Finish reading m before writing, r may be the same matrix */
+			Matrix4<S> t;
+			S *b = t.values;
+			b[0] = (a[5] * c5 - a[6] * c4 + a[7] * c3) * d;
+			b[1] = (-a[1] * c5 + a[2] * c4 - a[3] * c3) * d;
+			b[2] = (a[13] * s5 - a[14] * s4 + a[15] * s3) * d;
+			b[3] = (-a[9] * s5 + a[10] * s4 - a[11] * s3) * d;
+			b[4] = (-a[4] * c5 + a[6] * c2 - a[7] * c1) * d;
+			b[5] = (a[0] * c5 - a[2] * c2 + a[3] * c1) * d;
+			b[6] = (-a[12] * s5 + a[14] * s2 - a[15] * s1) * d;
+			b[7] = (a[8] * s5 - a[10] * s2 + a[11] * s1) * d;
+			b[8] = (a[4] * c4 - a[5] * c2 + a[7] * c0) * d;
+			b[9] = (-a[0] * c4 + a[1] * c2 - a[3] * c0) * d;
+			b[10] = (a[12] * s4 - a[13] * s2 + a[15] * s0) * d;
+			b[11] = (-a[8] * s4 + a[9] * s2 - a[11] * s0) * d;
+			b[12] = (-a[4] * c3 + a[5] * c1 - a[6] * c0) * d;
+			b[13] = (a[0] * c3 - a[1] * c1 + a[2] * c0) * d;
+			b[14] = (-a[12] * s3 + a[13] * s1 - a[14] * s0) * d;
+			b[15] = (a[8] * s3 - a[9] * s1 + a[10] * s0) * d;
+			r = t;
+		}
+		
+#if defined(GEOM_SSE2)
+		/*
+		 * The float inverse works on the four 2x2 blocks of the matrix,
+		 *   M = | A B |   M^-1 = 1/|M| | X Y |
+		 *       | C D |                | Z W |
+		 * each held in one register in row-major order, and applies Cramer's
+		 * rule to the blocks with shuffles:
+		 *   X# = |D|A - B(D#C), Y# = |B|C - D(A#B)#,
+		 *   Z# = |C|B - A(D#C)#, W# = |A|D - C(A#B),
+		 *   |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+		 * where # is the adjugate. Rounding differs from the scalar version.
+		 */
+		inline __m128 mul22(__m128 a, __m128 b) {
+			return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, 0xCC)),
+												_mm_mul_ps(_mm_shuffle_ps(a, a, 0xB1),
+																	 _mm_shuffle_ps(b, b, 0x66)));
+		}
+		/* A# * B */
+		inline __m128 adjMul22(__m128 a, __m128 b) {
+			return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, 0x0F), b),
+												_mm_mul_ps(_mm_shuffle_ps(a, a, 0xA5),
+																	 _mm_shuffle_ps(b, b, 0x4E)));
+		}
+		/* A * B# */
+		inline __m128 mulAdj22(__m128 a, __m128 b) {
+			return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, 0x33)),
+												_mm_mul_ps(_mm_shuffle_ps(a, a, 0xB1),
+																	 _mm_shuffle_ps(b, b, 0x66)));
+		}
+		
+		inline void inverse44(const Matrix4<float> &m, Matrix4<float> &r) {
+			const __m128 r0 = _mm_loadu_ps(m.values);
+			const __m128 r1 = _mm_loadu_ps(m.values + 4);
+			const __m128 r2 = _mm_loadu_ps(m.values + 8);
+			const __m128 r3 = _mm_loadu_ps(m.values + 12);
+			const __m128 a = _mm_movelh_ps(r0, r1);
+			const __m128 b = _mm_movehl_ps(r1, r0);
+			const __m128 c = _mm_movelh_ps(r2, r3);
+			const __m128 d = _mm_movehl_ps(r3, r2);
+			
+			/* The determinants of the blocks, |A| |B| |C| |D| */
+			const __m128 dets =
+				_mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(r0, r2, 0x88),
+															_mm_shuffle_ps(r1, r3, 0xDD)),
+									 _mm_mul_ps(_mm_shuffle_ps(r0, r2, 0xDD),
+															_mm_shuffle_ps(r1, r3, 0x88)));
+			const __m128 detA = _mm_shuffle_ps(dets, dets, 0x00);
+			const __m128 detB = _mm_shuffle_ps(dets, dets, 0x55);
+			const __m128 detC = _mm_shuffle_ps(dets, dets, 0xAA);
+			const __m128 detD = _mm_shuffle_ps(dets, dets, 0xFF);
+			
+			const __m128 dc = adjMul22(d, c);
+			const __m128 ab = adjMul22(a, b);
+			__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), mul22(b, dc));
+			__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), mul22(c, ab));
+			__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), mulAdj22(d, ab));
+			__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), mulAdj22(a, dc));
+			
+			__m128 tr = _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, 0xD8));
+			tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+			tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, 0x55));
+			tr = _mm_shuffle_ps(tr, tr, 0x00);
+			const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD),
+																							 _mm_mul_ps(detB, detC)), tr);
+			const __m128 scale = _mm_div_ps(_mm_setr_ps(1, -1, -1, 1), det);
+			x = _mm_mul_ps(x, scale);
+			y = _mm_mul_ps(y, scale);
+			z = _mm_mul_ps(z, scale);
+			w = _mm_mul_ps(w, scale);
+			
+			/* Apply the adjugate to each block while putting them in place */
+			_mm_storeu_ps(r.values, _mm_shuffle_ps(x, y, 0x77));
+			_mm_storeu_ps(r.values + 4, _mm_shuffle_ps(x, y, 0x22));
+			_mm_storeu_ps(r.values + 8, _mm_shuffle_ps(z, w, 0x77));
+			_mm_storeu_ps(r.values + 12, _mm_shuffle_ps(z, w, 0x22));
+		}
+#endif
+		
+		/*
+		 * Affine inverses, given the inverse of the upper left 3x3 block. The
+		 * translation of the inverse is that inverse applied to the negated
+		 * translation of m.
+		 */
+		template <typename S>
+		void inverseLinear44(const Matrix4<S> &m, const Matrix3<S> &l,
+												 Matrix4<S> &r)
+		{
+			const S *t = m.values + 12;
+			const S *v = l.values;
+			const S x = -(v[0] * t[0] + v[3] * t[1] + v[6] * t[2]);
+			const S y = -(v[1] * t[0] + v[4] * t[1] + v[7] * t[2]);
+			const S z = -(v[2] * t[0] + v[5] * t[1] + v[8] * t[2]);
+			r = Matrix4<S>(v[0], v[3], v[6], x,
+										 v[1], v[4], v[7], y,
+										 v[2], v[5], v[8], z,
+										 0, 0, 0, 1);
+		}
+		
+		template <typename S>
+		void inverseAffine44(const Matrix4<S> &m, Matrix4<S> &r) {
+			const S *v = m.values;
+			inverseLinear44(m, inverse(Matrix3<S>(v[0], v[4], v[8],
+																						v[1], v[5], v[9],
+																						v[2], v[6], v[10])), r);
+		}
+		
+		template <typename S>
+		void inverseRigid44(const Matrix4<S> &m, Matrix4<S> &r) {
+			const S *v = m.values;
+			inverseLinear44(m, Matrix3<S>(v[0], v[1], v[2],
+																		v[4], v[5], v[6],
+																		v[8], v[9], v[10]), r);
+		}
+		
+#if defined(GEOM_SSE2)
+		/*
+		 * The rows of a rigid Matrix4f hold the columns of its inverse, with
+		 * the translation in the last lane of each, so a transpose gives all of
+		 * the inverse but its translation.
+		 */
+		inline void inverseRigid44(const Matrix4<float> &m, Matrix4<float> &r) {
+			__m128 x = _mm_loadu_ps(m.values);
+			__m128 y = _mm_loadu_ps(m.values + 4);
+			__m128 z = _mm_loadu_ps(m.values + 8);
+			__m128 w = _mm_loadu_ps(m.values + 12);
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			const __m128 t =
+				_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_shuffle_ps(x, x, 0xFF)),
+															_mm_mul_ps(y, _mm_shuffle_ps(y, y, 0xFF))),
+									 _mm_mul_ps(z, _mm_shuffle_ps(z, z, 0xFF)));
+			const __m128 xyz = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+			_mm_storeu_ps(r.values, _mm_and_ps(x, xyz));
+			_mm_storeu_ps(r.values + 4, _mm_and_ps(y, xyz));
+			_mm_storeu_ps(r.values + 8, _mm_and_ps(z, xyz));
+			_mm_storeu_ps(r.values + 12,
+										_mm_sub_ps(_mm_setr_ps(0, 0, 0, 1), _mm_and_ps(t, xyz)));
+		}
+#endif
+	}
+	
+	/**
+	 * \brief Calculate the determinant of a \c Matrix4 object.
+	 * \arg \c m The matrix
+	 * \return The determinant of \c m
+	 */
+	template <typename Scalar>
+	Scalar determinant(const Matrix4<Scalar> &m) {
+		return detail::determinant44(m);
+	}
+	
+	/**
+	 * \brief Invert a \c Matrix4 object.
+	 * 
+	 * This is the general inverse, valid for any invertible matrix including
+	 * projections. \c Matrix4f is inverted with SSE instructions when they
+	 * are available, so its result may differ from the scalar version in the
+	 * last bits. Use \c inverseAffine or \c inverseRigid when the matrix is
+	 * known to have that structure.
+	 * 
+	 * \arg \c m The matrix to invert, of a floating point type. It must not
+	 * be singular, which can be checked with \c determinant.
+	 * \return A new \c Matrix4 object such that m * inverse(m) is the
+	 * identity
+	 */
+	template <typename Scalar>
+	Matrix4<Scalar> inverse(const Matrix4<Scalar> &m) {
+		static_assert(std::is_floating_point<Scalar>::value,
+									"The inverse needs a floating point type");
+		Matrix4<Scalar> r;
+		detail::inverse44(m, r);
+		return r;
+	}
+	
+	/**
+	 * \brief Invert an affine \c Matrix4 object.
+	 * 
+	 * Only the upper left 3x3 block needs a general inverse; the translation
+	 * follows from it. The bottom row of \c m is assumed to be 0 0 0 1 and is
+	 * not read.
+	 * 
+	 * \arg \c m The affine matrix to invert, of a floating point type
+	 * \return A new \c Matrix4 object undoing \c m
+	 */
+	template <typename Scalar>
+	Matrix4<Scalar> inverseAffine(const Matrix4<Scalar> &m) {
+		static_assert(std::is_floating_point<Scalar>::value,
+									"The inverse needs a floating point type");
+		Matrix4<Scalar> r;
+		detail::inverseAffine44(m, r);
+		return r;
+	}
+	
+	/**
+	 * \brief Invert a rigid \c Matrix4 object.
+	 * 
+	 * A matrix whose upper left 3x3 block is orthonormal, that is made only
+	 * of rotations, reflections and translations, is inverted by transposing
+	 * that block, without any division. The bottom row of \c m is assumed to
+	 * be 0 0 0 1 and is not read.
+	 * 
+	 * \arg \c m The rigid matrix to invert
+	 * \return A new \c Matrix4 object undoing \c m
+	 */
+	template <typename Scalar>
+	Matrix4<Scalar> inverseRigid(const Matrix4<Scalar> &m) {
+		Matrix4<Scalar> r;
+		detail::inverseRigid44(m, r);
+		return r;
+	}
+	
+	/**
+	 * \brief The kinds of matrix with a cheaper inverse than the general one.
+	 */
+	enum class MatrixKind {
+		General, /**< Any invertible matrix, see \c inverse */
+		Affine, /**< A bottom row of 0 0 0 1, see \c inverseAffine */
+		Rigid /**< Affine with an orthonormal 3x3 block, see \c inverseRigid */
+	};
+	
+	/**
+	 * \brief Find the cheapest way to invert a \c Matrix4 object.
+	 * 
+	 * The matrix is affine if its bottom row is exactly 0 0 0 1, and rigid if
+	 * in addition the columns of its upper left 3x3 block have unit length
+	 * and are perpendicular to within the given tolerance. The error of
+	 * \c inverseRigid grows with the tolerance.
+	 * 
+	 * \arg \c m The matrix to classify
+	 * \arg \c tolerance The largest accepted difference between the products
+	 * of the columns and those of an orthonormal basis
+	 * \return The kind of the matrix
+	 */
+	template <typename Scalar>
+	MatrixKind classify(const Matrix4<Scalar> &m,
+											Scalar tolerance =
+											64 * std::numeric_limits<Scalar>::epsilon())
+	{
+		const Scalar *v = m.values;
+		if(!(v[3] == 0 && v[7] == 0 && v[11] == 0 && v[15] == 1)) {
+			return MatrixKind::General;
+		}
+		const Vector3<Scalar> x(v[0], v[1], v[2]);
+		const Vector3<Scalar> y(v[4], v[5], v[6]);
+		const Vector3<Scalar> z(v[8], v[9], v[10]);
+		const bool orthonormal =
+			std::fabs(dot(x, x) - 1) <= tolerance &&
+			std::fabs(dot(y, y) - 1) <= tolerance &&
+			std::fabs(dot(z, z) - 1) <= tolerance &&
+			std::fabs(dot(x, y)) <= tolerance &&
+			std::fabs(dot(x, z)) <= tolerance &&
+			std::fabs(dot(y, z)) <= tolerance;
+		return orthonormal ? MatrixKind::Rigid : MatrixKind::Affine;
+	}
+	
+	/**
+	 * \brief Invert a \c Matrix4 object of a known kind.
+	 * \arg \c m The matrix to invert
+	 * \arg \c kind The kind of \c m, given by the caller or by \c classify
+	 * \return A new \c Matrix4 object undoing \c m
+	 */
+	template <typename Scalar>
+	Matrix4<Scalar> inverse(const Matrix4<Scalar> &m, MatrixKind kind) {
+		switch(kind) {
+		case MatrixKind::Rigid:
+			return inverseRigid(m);
+		case MatrixKind::Affine:
+			return inverseAffine(m);
+		default:
+			return inverse(m);
+		}
+	}
 }
 
 #endif
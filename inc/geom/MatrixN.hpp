@@ -0,0 +1,917 @@
+/**
+ * \file MatrixN.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief A matrix of any size whose operations are unrolled at compile time
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_MATRIX_N_HPP
+#define GEOM_MATRIX_N_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "Point2.hpp"
+#include "Point3.hpp"
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+#include "Vector4.hpp"
+#include "VectorTraits.hpp"
+
+namespace geom {
+	struct RowMajor;
+	template <std::size_t Rows, std::size_t Columns, typename Scalar,
+						typename Order>
+	struct MatrixView;
+	
+	/**
+	 * \brief The storage order of a \c Matrix with the values of each column
+	 * next to each other, which is the format OpenGL expects. This is the
+	 * default.
+	 */
+	struct ColumnMajor {
+		/** The storage order of the transpose of a matrix in this order */
+		typedef RowMajor Transposed;
+		
+		/**
+		 * \brief The index in the values of a \c Matrix of the given size of
+		 * the value at the given row and column.
+		 */
+		static constexpr std::size_t index(std::size_t rows, std::size_t,
+																			 std::size_t row, std::size_t column)
+		{
+			return column * rows + row;
+		}
+		/** \brief The row of the value at the given index */
+		static constexpr std::size_t row(std::size_t rows, std::size_t,
+																		 std::size_t index)
+		{
+			return index % rows;
+		}
+		/** \brief The column of the value at the given index */
+		static constexpr std::size_t column(std::size_t rows, std::size_t,
+																				std::size_t index)
+		{
+			return index / rows;
+		}
+		/** \brief The number of values stored next to each other */
+		static constexpr std::size_t line(std::size_t rows, std::size_t) {
+			return rows;
+		}
+	};
+	
+	/**
+	 * \brief The storage order of a \c Matrix with the values of each row
+	 * next to each other, as in C arrays.
+	 */
+	struct RowMajor {
+		typedef ColumnMajor Transposed;
+		
+		static constexpr std::size_t index(std::size_t, std::size_t columns,
+																			 std::size_t row, std::size_t column)
+		{
+			return row * columns + column;
+		}
+		static constexpr std::size_t row(std::size_t, std::size_t columns,
+																		 std::size_t index)
+		{
+			return index / columns;
+		}
+		static constexpr std::size_t column(std::size_t, std::size_t columns,
+																				std::size_t index)
+		{
+			return index % columns;
+		}
+		static constexpr std::size_t line(std::size_t, std::size_t columns) {
+			return columns;
+		}
+	};
+	
+	namespace detail {
+		/*
+		 * Every operation on a Matrix is a single constant expression over a
+		 * pack of element indices, so that it is fully unrolled at any
+		 * optimization level that inlines and can be evaluated at compile time.
+		 */
+		template <std::size_t... I>
+		struct Indices { };
+		template <std::size_t N, std::size_t... I>
+		struct MakeIndices : MakeIndices<N - 1, N - 1, I...> { };
+		template <std::size_t... I>
+		struct MakeIndices<0, I...> {
+			typedef Indices<I...> type;
+		};
+		
+		/* Selects the constructor taking the values in storage order */
+		struct StorageTag { };
+		/* Selects the constructor converting from a matrix or a view */
+		struct ConvertTag { };
+		
+		template <typename S, std::size_t N>
+		struct MatrixValues {
+			S v[N];
+		};
+		
+		/*
+		 * The index in matrices of order From of the value stored at index i
+		 * of a matrix of order To, both of R rows and C columns.
+		 */
+		template <typename To, typename From>
+		constexpr std::size_t sameElement(std::size_t r, std::size_t c,
+																			std::size_t i)
+		{
+			return From::index(r, c, To::row(r, c, i), To::column(r, c, i));
+		}
+	}
+	
+	/**
+	 * \brief A matrix of \c Rows rows and \c Columns columns.
+	 * 
+	 * The values of the matrix are stored in column major order by default to
+	 * match the format that OpenGL stores matricies in, or in row major order
+	 * when \c Order is \c RowMajor. Matrices of either order can be mixed in
+	 * every operation and converted into each other. Points and vectors are
+	 * column vectors multiplied on the right, so \c A*B applies \c B first.
+	 * 
+	 * Every operation is written as one expression over the elements, so
+	 * products, transposes and transforms are unrolled for each size and all
+	 * of them are \c constexpr. \c Matrix2, \c Matrix3 and \c Matrix4 are
+	 * the square sizes; \c Matrix2x3, \c Matrix3x4 and \c Matrix4x3 hold 2D
+	 * and 3D affine transformations and their transposes.
+	 * 
+	 * Matrices whose columns, or rows in row major order, are 16 bytes long
+	 * are 16 byte aligned, like \c Vector4.
+	 */
+	template <std::size_t Rows, std::size_t Columns, typename Scalar,
+						typename Order = ColumnMajor>
+	struct alignas(sizeof(Scalar) * Order::line(Rows, Columns) == 16 ?
+								 16 : alignof(Scalar)) Matrix {
+		static_assert(Rows > 0 && Columns > 0, "A Matrix can not be empty");
+		
+		typedef Scalar type;
+		typedef Order order;
+		
+		/**
+		 * \brief Construct a null \c Matrix object
+		 * 
+		 * This matrix will zero any other matrix multiplied by it. That is,
+		 * given \c Matrix A and \c Matrix B where A is null, A*B = [0...]
+		 */
+		constexpr Matrix() :
+			values{}
+		{ }
+		/**
+		 * \brief Construct a \c Matrix object with the given values.
+		 * 
+		 * The \c Rows * \c Columns values passed into this constructor are
+		 * expected in row-major order, whatever the storage order, because
+		 * matrices are more intuitively described in row-major order.
+		 */
+		template <typename... Values,
+							typename = typename std::enable_if<
+								sizeof...(Values) == Rows * Columns &&
+								(sizeof...(Values) > 1)>::type>
+		constexpr Matrix(Values... rowMajor) :
+			Matrix(typename detail::MakeIndices<Rows * Columns>::type(),
+						 detail::MatrixValues<Scalar, Rows * Columns>{
+							 {static_cast<Scalar>(rowMajor)...}})
+		{ }
+		/**
+		 * \brief Construct a \c Matrix object from values given in the order
+		 * they are stored in.
+		 */
+		template <typename... Values>
+		constexpr Matrix(detail::StorageTag, Values... stored) :
+			values{static_cast<Scalar>(stored)...}
+		{ }
+		/**
+		 * \brief Construct a \c Matrix object which is a conversion of the
+		 * given \c Matrix object, possibly of another storage order.
+		 * \arg \c source The \c Matrix object to copy
+		 */
+		template <typename Other, typename OtherOrder>
+		constexpr Matrix(const Matrix<Rows, Columns, Other, OtherOrder> &source) :
+			Matrix(detail::ConvertTag(),
+						 typename detail::MakeIndices<Rows * Columns>::type(),
+						 source.values, OtherOrder())
+		{ }
+		/**
+		 * \brief Construct a \c Matrix object holding a copy of the values seen
+		 * through the given view.
+		 * \arg \c source The \c MatrixView object to copy
+		 */
+		template <typename Other, typename OtherOrder>
+		explicit constexpr Matrix(
+			const MatrixView<Rows, Columns, Other, OtherOrder> &source) :
+			Matrix(detail::ConvertTag(),
+						 typename detail::MakeIndices<Rows * Columns>::type(),
+						 source.values, OtherOrder())
+		{ }
+		
+		/**
+		 * \brief Assign converted values from the given \c Matrix object.
+		 * \arg \c source The \c Matrix to assign converted values from
+		 * \return A reference to the \c Matrix object being assigned to
+		 */
+		template <typename Other, typename OtherOrder>
+		Matrix & operator=(const Matrix<Rows, Columns, Other, OtherOrder> &source)
+		{
+			for(std::size_t i = 0; i < Rows * Columns; ++i) {
+				values[i] = static_cast<Scalar>(
+					source.values[detail::sameElement<Order, OtherOrder>(Rows, Columns,
+																															 i)]);
+			}
+			return *this;
+		}
+		
+		/**
+		 * \brief Assign the result of multiplying this matrix by another.
+		 * \arg \c rhs The square matrix on the right side of the product
+		 * \return A reference to the \c Matrix object being assigned to
+		 */
+		template <typename Other, typename OtherOrder>
+		Matrix & operator*=(const Matrix<Columns, Columns, Other, OtherOrder> &rhs)
+		{
+			return *this = *this * rhs;
+		}
+		
+		/**
+		 * \brief Access the value at the given row and column.
+		 * \arg \c row The zero based row of the value
+		 * \arg \c column The zero based column of the value
+		 * \return A reference to the value
+		 */
+		Scalar & operator()(std::size_t row, std::size_t column) {
+			return values[Order::index(Rows, Columns, row, column)];
+		}
+		constexpr const Scalar & operator()(std::size_t row,
+																				std::size_t column) const
+		{
+			return values[Order::index(Rows, Columns, row, column)];
+		}
+		
+		/**
+		 * \brief Construct an identity \c Matrix object, for square sizes.
+		 */
+		template <std::size_t N = Rows,
+							typename = typename std::enable_if<N == Columns>::type>
+		static constexpr Matrix identity() {
+			return identity(typename detail::MakeIndices<Rows * Columns>::type());
+		}
+		/**
+		 * \brief Construct a 4x4 \c Matrix object which translates by the given
+		 * offset.
+		 * \arg \c offset The translation applied to points
+		 */
+		template <std::size_t N = Rows,
+							typename = typename std::enable_if<
+								N == 4 && Columns == 4>::type>
+		static constexpr Matrix translate(const Vector3<Scalar> &offset) {
+			return Matrix(1, 0, 0, offset.x,
+										0, 1, 0, offset.y,
+										0, 0, 1, offset.z,
+										0, 0, 0, 1);
+		}
+		/**
+		 * \brief Construct a 4x4 \c Matrix object which scales each axis by the
+		 * matching component of the given vector.
+		 * \arg \c factors The scale factors along x, y and z
+		 */
+		template <std::size_t N = Rows,
+							typename = typename std::enable_if<
+								N == 4 && Columns == 4>::type>
+		static constexpr Matrix scale(const Vector3<Scalar> &factors) {
+			return Matrix(factors.x, 0, 0, 0,
+										0, factors.y, 0, 0,
+										0, 0, factors.z, 0,
+										0, 0, 0, 1);
+		}
+		/**
+		 * \brief Construct a 4x4 \c Matrix object which scales uniformly.
+		 * \arg \c factor The scale factor along every axis
+		 */
+		template <std::size_t N = Rows,
+							typename = typename std::enable_if<
+								N == 4 && Columns == 4>::type>
+		static constexpr Matrix scale(Scalar factor) {
+			return scale(Vector3<Scalar>(factor, factor, factor));
+		}
+		/**
+		 * \brief Construct a 4x4 \c Matrix object which rotates about the given
+		 * axis.
+		 * 
+		 * The rotation is counterclockwise when looking down the axis towards
+		 * the origin, as with \c glRotate. The axis does not need to be
+		 * normalized but must not be the zero vector.
+		 * 
+		 * \arg \c angle The angle of rotation in radians
+		 * \arg \c axis The axis to rotate about
+		 */
+		template <std::size_t N = Rows,
+							typename = typename std::enable_if<
+								N == 4 && Columns == 4>::type>
+		static Matrix rotate(Scalar angle, const Vector3<Scalar> &axis) {
+			const Vector3<Scalar> a(normalize(axis));
+			const Scalar c = std::cos(angle), s = std::sin(angle), t = 1 - c;
+			return Matrix(t * a.x * a.x + c, t * a.x * a.y - s * a.z,
+										t * a.x * a.z + s * a.y, 0,
+										t * a.x * a.y + s * a.z, t * a.y * a.y + c,
+										t * a.y * a.z - s * a.x, 0,
+										t * a.x * a.z - s * a.y, t * a.y * a.z + s * a.x,
+										t * a.z * a.z + c, 0,
+										0, 0, 0, 1);
+		}
+		
+		/**
+		 * \brief The array of values stored in the matrix.
+		 * 
+		 * The value at a given row and column has the index
+		 * \f$column*Rows+row\f$ in column major order and \f$row*Columns+column\f$
+		 * in row major order, see \c Order::index.
+		 */
+		Scalar values[Rows * Columns];
+		
+	private:
+		template <std::size_t... I>
+		constexpr Matrix(
+			detail::Indices<I...>,
+			const detail::MatrixValues<Scalar, Rows * Columns> &rows) :
+			values{rows.v[detail::sameElement<Order, RowMajor>(Rows, Columns, I)]...}
+		{ }
+		template <typename Other, typename OtherOrder, std::size_t... I>
+		constexpr Matrix(detail::ConvertTag, detail::Indices<I...>,
+										 const Other *source, OtherOrder) :
+			values{static_cast<Scalar>(
+					source[detail::sameElement<Order, OtherOrder>(Rows, Columns, I)])...}
+		{ }
+		template <std::size_t... I>
+		static constexpr Matrix identity(detail::Indices<I...>) {
+			return Matrix(detail::StorageTag(),
+										(Order::row(Rows, Columns, I) ==
+										 Order::column(Rows, Columns, I) ? 1 : 0)...);
+		}
+	};
+	
+	/**
+	 * \brief A read only view of the values of a \c Matrix object as a matrix
+	 * of \c Rows rows and \c Columns columns stored in \c Order.
+	 * 
+	 * A view is made by \c transposeView, so that products with the transpose
+	 * of a matrix read its values in the right order rather than copying them
+	 * into a transposed matrix first. It holds a pointer to the values and
+	 * must not outlive the matrix it views.
+	 */
+	template <std::size_t Rows, std::size_t Columns, typename Scalar,
+						typename Order>
+	struct MatrixView {
+		typedef Scalar type;
+		typedef Order order;
+		
+		/**
+		 * \brief Construct a \c MatrixView object over the given values.
+		 * \arg \c values The \c Rows * \c Columns values in \c Order
+		 */
+		explicit constexpr MatrixView(const Scalar *values) :
+			values(values)
+		{ }
+		
+		/**
+		 * \brief Access the value at the given row and column.
+		 * \arg \c row The zero based row of the value
+		 * \arg \c column The zero based column of the value
+		 * \return A reference to the value
+		 */
+		constexpr const Scalar & operator()(std::size_t row,
+																				std::size_t column) const
+		{
+			return values[Order::index(Rows, Columns, row, column)];
+		}
+		
+		/**
+		 * \brief The values seen through the view.
+		 */
+		const Scalar *values;
+	};
+	
+	template <typename Scalar>
+	using Matrix2x3 = Matrix<2, 3, Scalar>;
+	template <typename Scalar>
+	using Matrix3x4 = Matrix<3, 4, Scalar>;
+	template <typename Scalar>
+	using Matrix4x3 = Matrix<4, 3, Scalar>;
+	
+	typedef Matrix2x3<float> Matrix2x3f;
+	typedef Matrix2x3<double> Matrix2x3d;
+	typedef Matrix3x4<float> Matrix3x4f;
+	typedef Matrix3x4<double> Matrix3x4d;
+	typedef Matrix4x3<float> Matrix4x3f;
+	typedef Matrix4x3<double> Matrix4x3d;
+	
+	namespace detail {
+		template <std::size_t N>
+		struct MatrixEqual {
+			template <typename LOrder, typename ROrder, std::size_t R,
+								std::size_t C, typename L, typename Rt>
+			static constexpr bool apply(const L *a, const Rt *b) {
+				return
+					MatrixEqual<N - 1>::template apply<LOrder, ROrder, R, C>(a, b) &&
+					a[N - 1] == b[sameElement<LOrder, ROrder>(R, C, N - 1)];
+			}
+		};
+		template <>
+		struct MatrixEqual<0> {
+			template <typename LOrder, typename ROrder, std::size_t R,
+								std::size_t C, typename L, typename Rt>
+			static constexpr bool apply(const L *, const Rt *) {
+				return true;
+			}
+		};
+		
+		template <typename Result, std::size_t R, std::size_t C, typename L,
+							typename Rt, typename LOrder, typename ROrder, std::size_t... I>
+		constexpr Matrix<R, C, Result, LOrder>
+		addMatrix(const Matrix<R, C, L, LOrder> &a,
+							const Matrix<R, C, Rt, ROrder> &b, Indices<I...>)
+		{
+			return Matrix<R, C, Result, LOrder>(
+				StorageTag(),
+				(a.values[I] + b.values[sameElement<LOrder, ROrder>(R, C, I)])...);
+		}
+		template <typename Result, std::size_t R, std::size_t C, typename L,
+							typename Rt, typename LOrder, typename ROrder, std::size_t... I>
+		constexpr Matrix<R, C, Result, LOrder>
+		subMatrix(const Matrix<R, C, L, LOrder> &a,
+							const Matrix<R, C, Rt, ROrder> &b, Indices<I...>)
+		{
+			return Matrix<R, C, Result, LOrder>(
+				StorageTag(),
+				(a.values[I] - b.values[sameElement<LOrder, ROrder>(R, C, I)])...);
+		}
+		template <typename Result, std::size_t R, std::size_t C, typename L,
+							typename Rt, typename Order, std::size_t... I>
+		constexpr Matrix<R, C, Result, Order>
+		scaleMatrix(const Matrix<R, C, L, Order> &a, const Rt &s, Indices<I...>) {
+			return Matrix<R, C, Result, Order>(StorageTag(), (a.values[I] * s)...);
+		}
+		
+		/*
+		 * The element of a product at row i and column j, summed as
+		 * ((a0 b0 + a1 b1) + a2 b2) + ... over the columns of the left operand
+		 * like the SIMD products of Matrix4.hpp, so that they give identical
+		 * results. The operands are read in their own storage order.
+		 */
+		template <std::size_t N>
+		struct MatrixDot {
+			template <typename Result, std::size_t R, std::size_t K, std::size_t C,
+								typename LOrder, typename ROrder, typename L, typename Rt>
+			static constexpr Result apply(const L *a, const Rt *b,
+																		std::size_t i, std::size_t j)
+			{
+				return MatrixDot<N - 1>::template apply<Result, R, K, C,
+																								LOrder, ROrder>(a, b, i, j) +
+					a[LOrder::index(R, K, i, N - 1)] * b[ROrder::index(K, C, N - 1, j)];
+			}
+		};
+		template <>
+		struct MatrixDot<1> {
+			template <typename Result, std::size_t R, std::size_t K, std::size_t C,
+								typename LOrder, typename ROrder, typename L, typename Rt>
+			static constexpr Result apply(const L *a, const Rt *b,
+																		std::size_t i, std::size_t j)
+			{
+				return a[LOrder::index(R, K, i, 0)] * b[ROrder::index(K, C, 0, j)];
+			}
+		};
+		
+		template <typename Result, typename Order, std::size_t R, std::size_t K,
+							std::size_t C, typename LOrder, typename ROrder, typename L,
+							typename Rt, std::size_t... I>
+		constexpr Matrix<R, C, Result, Order> mulMatrix(const L *a, const Rt *b,
+																										Indices<I...>)
+		{
+			return Matrix<R, C, Result, Order>(
+				StorageTag(),
+				MatrixDot<K>::template apply<Result, R, K, C, LOrder, ROrder>(
+					a, b, Order::row(R, C, I), Order::column(R, C, I))...);
+		}
+		
+		template <std::size_t R, std::size_t C, typename S, typename Order,
+							std::size_t... I>
+		constexpr Matrix<C, R, S, Order>
+		transposeMatrix(const Matrix<R, C, S, Order> &m, Indices<I...>) {
+			return Matrix<C, R, S, Order>(
+				StorageTag(),
+				m.values[Order::index(R, C, Order::column(C, R, I),
+															Order::row(C, R, I))]...);
+		}
+		
+		/*
+		 * Vectors and points are transformed as single column matrices, which
+		 * are stored the same way in either order; a point gains a homogeneous
+		 * coordinate of 1 and a vector one of 0 when the matrix has one more
+		 * column than they have components.
+		 */
+		template <typename S, typename T>
+		constexpr Matrix<2, 1, S> column(const Vector2<T> &v) {
+			return Matrix<2, 1, S>(StorageTag(), v.x, v.y);
+		}
+		template <typename S, typename T>
+		constexpr Matrix<3, 1, S> column(const Vector3<T> &v) {
+			return Matrix<3, 1, S>(StorageTag(), v.x, v.y, v.z);
+		}
+		template <typename S, typename T>
+		constexpr Matrix<4, 1, S> column(const Vector4<T> &v) {
+			return Matrix<4, 1, S>(StorageTag(), v.x, v.y, v.z, v.w);
+		}
+		template <typename S, typename T>
+		constexpr Matrix<3, 1, S> column(const Vector2<T> &v, S w) {
+			return Matrix<3, 1, S>(StorageTag(), v.x, v.y, w);
+		}
+		template <typename S, typename T>
+		constexpr Matrix<4, 1, S> column(const Vector3<T> &v, S w) {
+			return Matrix<4, 1, S>(StorageTag(), v.x, v.y, v.z, w);
+		}
+		template <typename S, typename T>
+		constexpr Matrix<3, 1, S> column(const Point2<T> &p, S w) {
+			return Matrix<3, 1, S>(StorageTag(), p.x, p.y, w);
+		}
+		template <typename S, typename T>
+		constexpr Matrix<4, 1, S> column(const Point3<T> &p, S w) {
+			return Matrix<4, 1, S>(StorageTag(), p.x, p.y, p.z, w);
+		}
+		
+		/* The vector and point types of N components, made from a column */
+		template <std::size_t N>
+		struct ColumnTypes { };
+		template <>
+		struct ColumnTypes<2> {
+			template <typename S>
+			using Vector = Vector2<S>;
+			template <typename S>
+			using Point = Point2<S>;
+			
+			template <std::size_t R, typename S, typename O>
+			static constexpr Vector2<S> vector(const Matrix<R, 1, S, O> &c) {
+				return Vector2<S>(c.values[0], c.values[1]);
+			}
+			template <std::size_t R, typename S, typename O>
+			static constexpr Point2<S> point(const Matrix<R, 1, S, O> &c) {
+				return Point2<S>(c.values[0], c.values[1]);
+			}
+		};
+		template <>
+		struct ColumnTypes<3> {
+			template <typename S>
+			using Vector = Vector3<S>;
+			template <typename S>
+			using Point = Point3<S>;
+			
+			template <std::size_t R, typename S, typename O>
+			static constexpr Vector3<S> vector(const Matrix<R, 1, S, O> &c) {
+				return Vector3<S>(c.values[0], c.values[1], c.values[2]);
+			}
+			template <std::size_t R, typename S, typename O>
+			static constexpr Point3<S> point(const Matrix<R, 1, S, O> &c) {
+				return Point3<S>(c.values[0], c.values[1], c.values[2]);
+			}
+		};
+		template <>
+		struct ColumnTypes<4> {
+			template <typename S>
+			using Vector = Vector4<S>;
+			
+			template <std::size_t R, typename S, typename O>
+			static constexpr Vector4<S> vector(const Matrix<R, 1, S, O> &c) {
+				return Vector4<S>(c.values[0], c.values[1], c.values[2],
+													c.values[3]);
+			}
+		};
+		
+		/* Whether a Matrix of R rows transforms N component points */
+		template <std::size_t R, std::size_t N, typename Result>
+		using Homogeneous =
+			typename std::enable_if<R == N || R == N + 1, Result>::type;
+	}
+	
+	/**
+	 * \brief Test matrices element-wise for equality.
+	 * \arg \c lhs The matrix on the left of the equality operator.
+	 * \arg \c rhs The matrix on the right of the equality operator.
+	 * \return True if all elements are equal, false otherwise.
+	 */
+	template <std::size_t R, std::size_t C, typename LType, typename RType,
+						typename LOrder, typename ROrder>
+	constexpr bool operator==(const Matrix<R, C, LType, LOrder> &lhs,
+														const Matrix<R, C, RType, ROrder> &rhs)
+	{
+		return detail::MatrixEqual<R * C>::template apply<LOrder, ROrder, R, C>(
+			lhs.values, rhs.values);
+	}
+	
+	/**
+	 * \brief Test if two matrices are not equal.
+	 * \arg \c lhs The matrix on the left of the inequality operator.
+	 * \arg \c rhs The matrix on the right of the inequality operator.
+	 * \return True if any element is different, False otherwise.
+	 */
+	template <std::size_t R, std::size_t C, typename LType, typename RType,
+						typename LOrder, typename ROrder>
+	constexpr bool operator!=(const Matrix<R, C, LType, LOrder> &lhs,
+														const Matrix<R, C, RType, ROrder> &rhs)
+	{
+		return !(lhs == rhs);
+	}
+	
+	/**
+	 * \brief Add two \c Matrix objects element-wise.
+	 * \arg \c lhs The operand on the left hand side of the expression
+	 * \arg \c rhs The operand on the right hand side of the expression
+	 * \return A new \c Matrix object in the order of \c lhs holding the sum
+	 */
+	template <std::size_t R, std::size_t C, typename RType, typename LType,
+						typename LOrder, typename ROrder,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr Matrix<R, C, Result, LOrder>
+	operator+(const Matrix<R, C, LType, LOrder> &lhs,
+						const Matrix<R, C, RType, ROrder> &rhs)
+	{
+		return detail::addMatrix<Result>(
+			lhs, rhs, typename detail::MakeIndices<R * C>::type());
+	}
+	
+	/**
+	 * \brief Subtract two \c Matrix objects element-wise.
+	 * \arg \c lhs The operand on the left hand side of the expression
+	 * \arg \c rhs The operand on the right hand side of the expression
+	 * \return A new \c Matrix object in the order of \c lhs holding the
+	 * difference
+	 */
+	template <std::size_t R, std::size_t C, typename RType, typename LType,
+						typename LOrder, typename ROrder,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr Matrix<R, C, Result, LOrder>
+	operator-(const Matrix<R, C, LType, LOrder> &lhs,
+						const Matrix<R, C, RType, ROrder> &rhs)
+	{
+		return detail::subMatrix<Result>(
+			lhs, rhs, typename detail::MakeIndices<R * C>::type());
+	}
+	
+	/**
+	 * \brief Multiply every element of a \c Matrix object by a scalar.
+	 * \arg \c lhs The \c Matrix object to multiply
+	 * \arg \c rhs The scalar to multiply the \c Matrix object by
+	 * \return A new \c Matrix object holding the scaled matrix
+	 */
+	template <std::size_t R, std::size_t C, typename RType, typename LType,
+						typename Order,
+						typename = typename std::enable_if<
+							std::is_arithmetic<RType>::value>::type,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr Matrix<R, C, Result, Order>
+	operator*(const Matrix<R, C, LType, Order> &lhs, const RType &rhs) {
+		return detail::scaleMatrix<Result>(
+			lhs, rhs, typename detail::MakeIndices<R * C>::type());
+	}
+	template <std::size_t R, std::size_t C, typename RType, typename LType,
+						typename Order,
+						typename = typename std::enable_if<
+							std::is_arithmetic<LType>::value>::type,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr Matrix<R, C, Result, Order>
+	operator*(const LType &lhs, const Matrix<R, C, RType, Order> &rhs) {
+		return rhs * lhs;
+	}
+	
+	/**
+	 * \brief Multiply two \c Matrix objects.
+	 * \arg \c lhs The matrix on the left side of the product
+	 * \arg \c rhs The matrix on the right side of the product, which is the
+	 * transformation applied first. It must have as many rows as \c lhs has
+	 * columns.
+	 * \return A new \c Matrix object in the order of \c lhs, with its rows
+	 * and the columns of \c rhs, holding the product
+	 */
+	template <std::size_t R, std::size_t K, std::size_t C, typename RType,
+						typename LType, typename LOrder, typename ROrder,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr Matrix<R, C, Result, LOrder>
+	operator*(const Matrix<R, K, LType, LOrder> &lhs,
+						const Matrix<K, C, RType, ROrder> &rhs)
+	{
+		return detail::mulMatrix<Result, LOrder, R, K, C, LOrder, ROrder>(
+			lhs.values, rhs.values, typename detail::MakeIndices<R * C>::type());
+	}
+	/**
+	 * \brief Multiply a \c Matrix object by a view of another, usually made
+	 * by \c transposeView.
+	 * 
+	 * The values of the view are read in its order, so no transposed copy is
+	 * made; the product has the order of the \c Matrix operand.
+	 */
+	template <std::size_t R, std::size_t K, std::size_t C, typename RType,
+						typename LType, typename LOrder, typename ROrder,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr Matrix<R, C, Result, LOrder>
+	operator*(const Matrix<R, K, LType, LOrder> &lhs,
+						const MatrixView<K, C, RType, ROrder> &rhs)
+	{
+		return detail::mulMatrix<Result, LOrder, R, K, C, LOrder, ROrder>(
+			lhs.values, rhs.values, typename detail::MakeIndices<R * C>::type());
+	}
+	template <std::size_t R, std::size_t K, std::size_t C, typename RType,
+						typename LType, typename LOrder, typename ROrder,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr Matrix<R, C, Result, ROrder>
+	operator*(const MatrixView<R, K, LType, LOrder> &lhs,
+						const Matrix<K, C, RType, ROrder> &rhs)
+	{
+		return detail::mulMatrix<Result, ROrder, R, K, C, LOrder, ROrder>(
+			lhs.values, rhs.values, typename detail::MakeIndices<R * C>::type());
+	}
+	template <std::size_t R, std::size_t K, std::size_t C, typename RType,
+						typename LType, typename LOrder, typename ROrder,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr Matrix<R, C, Result>
+	operator*(const MatrixView<R, K, LType, LOrder> &lhs,
+						const MatrixView<K, C, RType, ROrder> &rhs)
+	{
+		return detail::mulMatrix<Result, ColumnMajor, R, K, C, LOrder, ROrder>(
+			lhs.values, rhs.values, typename detail::MakeIndices<R * C>::type());
+	}
+	
+	/**
+	 * \brief Transpose a \c Matrix object.
+	 * \arg \c m The matrix to transpose
+	 * \return A new \c Matrix object of the same order whose rows are the
+	 * columns of \c m
+	 */
+	template <std::size_t R, std::size_t C, typename Scalar, typename Order>
+	constexpr Matrix<C, R, Scalar, Order>
+	transpose(const Matrix<R, C, Scalar, Order> &m) {
+		return detail::transposeMatrix(
+			m, typename detail::MakeIndices<R * C>::type());
+	}
+	
+	/**
+	 * \brief View a \c Matrix object as its transpose without copying it.
+	 * 
+	 * The transpose of a matrix stored in one order has the same values
+	 * stored in the other order, so the view reads the values of \c m in
+	 * place.
+	 * 
+	 * \arg \c m The matrix to view, which must outlive the view
+	 * \return A \c MatrixView object whose rows are the columns of \c m
+	 */
+	template <std::size_t R, std::size_t C, typename Scalar, typename Order>
+	constexpr MatrixView<C, R, Scalar, typename Order::Transposed>
+	transposeView(const Matrix<R, C, Scalar, Order> &m) {
+		return MatrixView<C, R, Scalar, typename Order::Transposed>(m.values);
+	}
+	template <std::size_t R, std::size_t C, typename Scalar, typename Order>
+	constexpr MatrixView<C, R, Scalar, typename Order::Transposed>
+	transposeView(const MatrixView<R, C, Scalar, Order> &m) {
+		return MatrixView<C, R, Scalar, typename Order::Transposed>(m.values);
+	}
+	template <std::size_t R, std::size_t C, typename Scalar, typename Order>
+	void transposeView(const Matrix<R, C, Scalar, Order> &&) = delete;
+
+	/**
+	 * \brief Transform a \c Vector2 object by a \c Matrix object of 2
+	 * columns.
+	 * \arg \c lhs The transformation matrix
+	 * \arg \c rhs The column vector to transform
+	 * \return A new vector with as many components as \c lhs has rows
+	 */
+	template <std::size_t R, typename RType, typename LType, typename Order,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr typename detail::ColumnTypes<R>::template Vector<Result>
+	operator*(const Matrix<R, 2, LType, Order> &lhs, const Vector2<RType> &rhs) {
+		return detail::ColumnTypes<R>::vector(lhs * detail::column<Result>(rhs));
+	}
+	/**
+	 * \brief Transform a \c Vector3 object by a \c Matrix object of 3
+	 * columns.
+	 * \arg \c lhs The transformation matrix
+	 * \arg \c rhs The column vector to transform
+	 * \return A new vector with as many components as \c lhs has rows
+	 */
+	template <std::size_t R, typename RType, typename LType, typename Order,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr typename detail::ColumnTypes<R>::template Vector<Result>
+	operator*(const Matrix<R, 3, LType, Order> &lhs, const Vector3<RType> &rhs) {
+		return detail::ColumnTypes<R>::vector(lhs * detail::column<Result>(rhs));
+	}
+	/**
+	 * \brief Transform a \c Vector4 object by a \c Matrix object of 4
+	 * columns.
+	 * \arg \c lhs The transformation matrix
+	 * \arg \c rhs The column vector to transform
+	 * \return A new vector with as many components as \c lhs has rows
+	 */
+	template <std::size_t R, typename RType, typename LType, typename Order,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr typename detail::ColumnTypes<R>::template Vector<Result>
+	operator*(const Matrix<R, 4, LType, Order> &lhs, const Vector4<RType> &rhs) {
+		return detail::ColumnTypes<R>::vector(lhs * detail::column<Result>(rhs));
+	}
+	
+	/**
+	 * \brief Transform a \c Vector2 object by a 2D homogeneous \c Matrix
+	 * object, that is a 2x3 or 3x3 one.
+	 * 
+	 * The vector is extended with a w coordinate of 0, so only the linear part
+	 * of the matrix affects it.
+	 * 
+	 * \arg \c lhs The transformation matrix
+	 * \arg \c rhs The vector to transform
+	 * \return A new \c Vector2 object holding the transformed vector
+	 */
+	template <std::size_t R, typename RType, typename LType, typename Order,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr detail::Homogeneous<R, 2, Vector2<Result>>
+	operator*(const Matrix<R, 3, LType, Order> &lhs, const Vector2<RType> &rhs) {
+		return detail::ColumnTypes<2>::vector(
+			lhs * detail::column(rhs, Result(0)));
+	}
+	/**
+	 * \brief Transform a \c Vector3 object by a 3D homogeneous \c Matrix
+	 * object, that is a 3x4 or 4x4 one.
+	 * 
+	 * The vector is extended with a w coordinate of 0, so only the linear part
+	 * of the matrix affects it.
+	 * 
+	 * \arg \c lhs The transformation matrix
+	 * \arg \c rhs The vector to transform
+	 * \return A new \c Vector3 object holding the transformed vector
+	 */
+	template <std::size_t R, typename RType, typename LType, typename Order,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr detail::Homogeneous<R, 3, Vector3<Result>>
+	operator*(const Matrix<R, 4, LType, Order> &lhs, const Vector3<RType> &rhs) {
+		return detail::ColumnTypes<3>::vector(
+			lhs * detail::column(rhs, Result(0)));
+	}
+	/**
+	 * \brief Transform a \c Point2 object by a 2D homogeneous \c Matrix
+	 * object, that is a 2x3 or 3x3 one.
+	 * 
+	 * The point is extended with a w coordinate of 1, so it is affected by the
+	 * translation of the matrix. The w coordinate of the result is discarded,
+	 * which is correct for affine transformations.
+	 * 
+	 * \arg \c lhs The transformation matrix
+	 * \arg \c rhs The point to transform
+	 * \return A new \c Point2 object holding the transformed point
+	 */
+	template <std::size_t R, typename RType, typename LType, typename Order,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr detail::Homogeneous<R, 2, Point2<Result>>
+	operator*(const Matrix<R, 3, LType, Order> &lhs, const Point2<RType> &rhs) {
+		return detail::ColumnTypes<2>::point(
+			lhs * detail::column(rhs, Result(1)));
+	}
+	/**
+	 * \brief Transform a \c Point3 object by a 3D homogeneous \c Matrix
+	 * object, that is a 3x4 or 4x4 one.
+	 * 
+	 * The point is extended with a w coordinate of 1, so it is affected by the
+	 * translation of the matrix. The w coordinate of the result is discarded,
+	 * which is correct for affine transformations; use \c project for
+	 * projective ones.
+	 * 
+	 * \arg \c lhs The transformation matrix
+	 * \arg \c rhs The point to transform
+	 * \return A new \c Point3 object holding the transformed point
+	 */
+	template <std::size_t R, typename RType, typename LType, typename Order,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	constexpr detail::Homogeneous<R, 3, Point3<Result>>
+	operator*(const Matrix<R, 4, LType, Order> &lhs, const Point3<RType> &rhs) {
+		return detail::ColumnTypes<3>::point(
+			lhs * detail::column(rhs, Result(1)));
+	}
+}
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * \file Parallel.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Optional multithreading of the batch kernels
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_PARALLEL_HPP
+#define GEOM_PARALLEL_HPP
+
+#include <cstddef>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace geom {
+	/**
+	 * \brief Options for running a batch kernel on several threads.
+	 *
+	 * Kernels accepting a \c Parallel argument split their input into one
+	 * contiguous range per thread. Arrays shorter than \c threshold are
+	 * processed on the calling thread, where starting threads would cost more
+	 * than it saves.
+	 *
+	 * Programs using the multithreaded paths must be linked with -pthread.
+	 */
+	struct Parallel {
+		/**
+		 * \brief Construct \c Parallel options
+		 * \arg \c threads The number of threads to use, or 0 for one per
+		 * hardware thread
+		 * \arg \c threshold The smallest array processed on several threads
+		 */
+		explicit Parallel(unsigned threads = 0,
+											std::size_t threshold = std::size_t(1) << 16) :
+			threads(threads), threshold(threshold)
+		{ }
+		
+		/**
+		 * \brief Options which run kernels on the calling thread only.
+		 */
+		static Parallel serial() {
+			return Parallel(1);
+		}
+		
+		unsigned threads; /**< The number of threads, 0 for all */
+		std::size_t threshold; /**< The smallest array run on several threads */
+	};
+	
+	namespace detail {
+		/*
+		 * Call f(first, count) over consecutive ranges covering [0, count),
+		 * one range per thread. Ranges start at multiples of 64 elements so
+		 * that each thread keeps whole SIMD packs and threads do not write to
+		 * the same cache lines. The first range runs on the calling thread; if
+		 * a thread cannot be started its range runs there too. f must not
+		 * throw.
+		 */
+		template <typename Function>
+		void parallelFor(std::size_t count, const Parallel &parallel, Function f)
+		{
+			std::size_t threads = parallel.threads;
+			if(threads == 0) {
+				threads = std::thread::hardware_concurrency();
+			}
+			if(threads <= 1 || count < parallel.threshold || count < 128) {
+				f(std::size_t(0), count);
+				return;
+			}
+			
+			std::size_t chunk = (count + threads - 1) / threads;
+			chunk = (chunk + 63) & ~std::size_t(63);
+			std::vector<std::thread> workers;
+			workers.reserve(threads - 1);
+			for(std::size_t first = chunk; first < count; first += chunk) {
+				const std::size_t n = count - first < chunk ? count - first : chunk;
+				try {
+					workers.push_back(std::thread(f, first, n));
+				} catch(const std::system_error &) {
+					f(first, n);
+				}
+			}
+			f(std::size_t(0), chunk < count ? chunk : count);
+			for(std::size_t i = 0; i < workers.size(); ++i) {
+				workers[i].join();
+			}
+		}
+	}
+}
+
+#endif
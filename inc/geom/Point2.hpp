@@ -41,7 +41,7 @@ namespace geom {
     /**
      * \brief Construct a point at the origin
      */
-    Point2() :
+    constexpr Point2() :
       x(0), y(0)
     { }
     /**
@@ -49,7 +49,7 @@ namespace geom {
      * \arg \c x The x coordinate of the \c Point2
      * \arg \c y The y coordinate of the \c Point2
      */
-    Point2(Scalar x, Scalar y) :
+    constexpr Point2(Scalar x, Scalar y) :
       x(x), y(y)
     { }
     /**
@@ -57,7 +57,7 @@ namespace geom {
      * object.
      * \arg \c source The \c Point2 to copy
      */
-    Point2(const Point2<Scalar> &source) :
+    constexpr Point2(const Point2<Scalar> &source) :
       x(source.x), y(source.y)
     { }
     /**
@@ -66,7 +66,7 @@ namespace geom {
      * \arg \c source The \c Point2 object to convert from
      */
     template <typename Other>
-    Point2(const Point2<Other> &source) :
+    constexpr Point2(const Point2<Other> &source) :
       x(source.x), y(source.y)
     { }
     ~Point2() = default;
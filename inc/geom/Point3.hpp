@@ -40,7 +40,7 @@ namespace geom {
     /**
      * \brief Construct a \c Point3 at the origin (0,0,0)
      */
-    Point3() :
+    constexpr Point3() :
       x(0), y(0), z(0)
     { }
     /**
@@ -49,7 +49,7 @@ namespace geom {
      * \arg \c y The y coordinate of the \c Point3 object
      * \arg \c z The z coordinate of the \c Point3 object
      */
-    Point3(Scalar x, Scalar y, Scalar z) :
+    constexpr Point3(Scalar x, Scalar y, Scalar z) :
       x(x), y(y), z(z)
     { }
     /**
@@ -57,7 +57,7 @@ namespace geom {
      * \c Point3.
      * /arg \c source The \c Point3 to copy the location from
      */
-    Point3(const Point3<Scalar> &source) :
+    constexpr Point3(const Point3<Scalar> &source) :
       x(source.x), y(source.y), z(source.z)
     { }
     /**
@@ -66,7 +66,7 @@ namespace geom {
      * \arg \c source The \c Point3 to convert the location from
      */
     template <typename Other>
-    Point3(const Point3<Other> &source) :
+    constexpr Point3(const Point3<Other> &source) :
       x(source.x), y(source.y), z(source.z)
     { }
     ~Point3() = default;
@@ -0,0 +1,227 @@
+/**
+ * \file Point3SoA.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Structure-of-arrays storage for Point3
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_POINT_3_SOA_HPP
+#define GEOM_POINT_3_SOA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "Point3.hpp"
+
+namespace geom {
+	/**
+	 * \brief A non-owning view of \c Point3 values stored as three separate
+	 * coordinate arrays.
+	 *
+	 * Batch kernels operate on views rather than on \c Point3SoA directly so
+	 * that they can be run over any x/y/z arrays, including sub ranges of a
+	 * larger container. A view of \c const coordinates is used for read-only
+	 * access.
+	 */
+	template <typename Scalar>
+	struct Point3Span {
+		typedef typename std::remove_const<Scalar>::type type;
+
+		/**
+		 * \brief Construct an empty \c Point3Span
+		 */
+		Point3Span() :
+			x(nullptr), y(nullptr), z(nullptr), count(0)
+		{ }
+		/**
+		 * \brief Construct a \c Point3Span over the given coordinate arrays
+		 * \arg \c x The array of x coordinates
+		 * \arg \c y The array of y coordinates
+		 * \arg \c z The array of z coordinates
+		 * \arg \c count The number of points in each array
+		 */
+		Point3Span(Scalar *x, Scalar *y, Scalar *z, std::size_t count) :
+			x(x), y(y), z(z), count(count)
+		{ }
+		/**
+		 * \brief Construct a \c Point3Span viewing the same arrays as the given
+		 * \c Point3Span, used to convert a mutable view to a \c const one.
+		 * \arg \c source The \c Point3Span to view
+		 */
+		template <typename Other>
+		Point3Span(const Point3Span<Other> &source) :
+			x(source.x), y(source.y), z(source.z), count(source.count)
+		{ }
+
+		/**
+		 * \brief Gather the point at the given index
+		 * \arg \c i The index of the point
+		 * \return A \c Point3 object holding the coordinates at index i
+		 */
+		Point3<type> operator[](std::size_t i) const {
+			return Point3<type>(x[i], y[i], z[i]);
+		}
+
+		/**
+		 * \brief Get a view of a sub range of this view
+		 * \arg \c first The index of the first point in the sub range
+		 * \arg \c n The number of points in the sub range
+		 * \return A \c Point3Span of the n points starting at first
+		 */
+		Point3Span<Scalar> subspan(std::size_t first, std::size_t n) const {
+			return Point3Span<Scalar>(x + first, y + first, z + first, n);
+		}
+
+		Scalar *x; /**< The array of x coordinates */
+		Scalar *y; /**< The array of y coordinates */
+		Scalar *z; /**< The array of z coordinates */
+		std::size_t count; /**< The number of points viewed */
+	};
+
+	/**
+	 * \brief A container of \c Point3 values stored as three separate
+	 * coordinate arrays.
+	 *
+	 * Keeping each coordinate contiguous lets batch kernels process several
+	 * points per instruction, which is not possible over an array of
+	 * \c Point3 objects.
+	 */
+	template <typename Scalar>
+	struct Point3SoA {
+		/**
+		 * \brief Construct an empty \c Point3SoA
+		 */
+		Point3SoA() { }
+		/**
+		 * \brief Construct a \c Point3SoA holding count points at the origin
+		 * \arg \c count The number of points to hold
+		 */
+		explicit Point3SoA(std::size_t count) :
+			x(count), y(count), z(count)
+		{ }
+		/**
+		 * \brief Construct a \c Point3SoA from an array of \c Point3 objects.
+		 * \arg \c source The array of points to convert from
+		 * \arg \c count The number of points in source
+		 */
+		template <typename Other>
+		Point3SoA(const Point3<Other> *source, std::size_t count) :
+			x(count), y(count), z(count)
+		{
+			for(std::size_t i = 0; i < count; ++i) {
+				set(i, source[i]);
+			}
+		}
+
+		/**
+		 * \brief Get the number of points held
+		 */
+		std::size_t size() const {
+			return x.size();
+		}
+		/**
+		 * \brief Change the number of points held, new points are at the origin
+		 * \arg \c count The new number of points
+		 */
+		void resize(std::size_t count) {
+			x.resize(count);
+			y.resize(count);
+			z.resize(count);
+		}
+		/**
+		 * \brief Reserve storage for the given number of points
+		 * \arg \c count The number of points to reserve storage for
+		 */
+		void reserve(std::size_t count) {
+			x.reserve(count);
+			y.reserve(count);
+			z.reserve(count);
+		}
+		/**
+		 * \brief Remove all points
+		 */
+		void clear() {
+			x.clear();
+			y.clear();
+			z.clear();
+		}
+		/**
+		 * \brief Append a point to the end of the container
+		 * \arg \c v The point to append
+		 */
+		template <typename Other>
+		void push_back(const Point3<Other> &v) {
+			x.push_back(v.x);
+			y.push_back(v.y);
+			z.push_back(v.z);
+		}
+
+		/**
+		 * \brief Gather the point at the given index
+		 * \arg \c i The index of the point
+		 * \return A \c Point3 object holding the coordinates at index i
+		 */
+		Point3<Scalar> operator[](std::size_t i) const {
+			return Point3<Scalar>(x[i], y[i], z[i]);
+		}
+		/**
+		 * \brief Scatter a point into the given index
+		 * \arg \c i The index to store the point at
+		 * \arg \c v The point to store
+		 */
+		template <typename Other>
+		void set(std::size_t i, const Point3<Other> &v) {
+			x[i] = v.x;
+			y[i] = v.y;
+			z[i] = v.z;
+		}
+
+		/**
+		 * \brief Get a mutable view of all points held
+		 */
+		Point3Span<Scalar> span() {
+			return Point3Span<Scalar>(x.data(), y.data(), z.data(), size());
+		}
+		/**
+		 * \brief Get a read-only view of all points held
+		 */
+		Point3Span<const Scalar> span() const {
+			return Point3Span<const Scalar>(x.data(), y.data(), z.data(), size());
+		}
+
+		std::vector<Scalar> x; /**< The x coordinates of the points */
+		std::vector<Scalar> y; /**< The y coordinates of the points */
+		std::vector<Scalar> z; /**< The z coordinates of the points */
+	};
+
+	typedef Point3SoA<std::int32_t> Point3SoAi;
+	typedef Point3SoA<std::uint32_t> Point3SoAu;
+	typedef Point3SoA<std::int64_t> Point3SoAl;
+	typedef Point3SoA<std::uint64_t> Point3SoAul;
+	typedef Point3SoA<float> Point3SoAf;
+	typedef Point3SoA<double> Point3SoAd;
+}
+
+#endif
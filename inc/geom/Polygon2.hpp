@@ -0,0 +1,792 @@
+/**
+ * \file Polygon2.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Polygons with holes, their area, centroid and triangulation
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_POLYGON2_HPP
+#define GEOM_POLYGON2_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include "ConvexHull.hpp"
+#include "Point2.hpp"
+#include "Predicates.hpp"
+#include "Simd.hpp"
+
+namespace geom {
+	/**
+	 * \brief A polygon with optional holes, its rings stored one after
+	 * another in a single vertex array.
+	 *
+	 * Ring 0 is the outer boundary and every further ring a hole; each ring
+	 * is closed implicitly and may run either way around. The rings must be
+	 * simple and must neither cross nor touch one another. Assigning a new
+	 * outline to a polygon keeps its storage, so a polygon reused for many
+	 * outlines only allocates as it grows.
+	 */
+	template <typename Scalar>
+	struct Polygon2 {
+		/**
+		 * \brief Construct an empty polygon.
+		 */
+		Polygon2() :
+			offsets(1, 0)
+		{ }
+		/**
+		 * \brief Construct a polygon without holes.
+		 * \arg \c outer The vertices of the outer boundary.
+		 * \arg \c count The number of vertices.
+		 */
+		Polygon2(const Point2<Scalar> *outer, std::size_t count) :
+			offsets(1, 0)
+		{
+			assign(outer, count);
+		}
+		
+		/**
+		 * \brief Replace the polygon by one without holes.
+		 * \arg \c outer The vertices of the outer boundary.
+		 * \arg \c count The number of vertices.
+		 */
+		void assign(const Point2<Scalar> *outer, std::size_t count) {
+			vertices.assign(outer, outer + count);
+			offsets.resize(2);
+			offsets[0] = 0;
+			offsets[1] = std::uint32_t(count);
+		}
+		/**
+		 * \brief Add a hole to the polygon.
+		 * \arg \c hole The vertices of the hole.
+		 * \arg \c count The number of vertices.
+		 */
+		void addHole(const Point2<Scalar> *hole, std::size_t count) {
+			vertices.insert(vertices.end(), hole, hole + count);
+			offsets.push_back(std::uint32_t(vertices.size()));
+		}
+		
+		/**
+		 * \brief Get the number of rings, the outer boundary and the holes.
+		 */
+		std::size_t rings() const {
+			return offsets.size() - 1;
+		}
+		/**
+		 * \brief Get the number of holes.
+		 */
+		std::size_t holes() const {
+			return offsets.size() > 2 ? offsets.size() - 2 : 0;
+		}
+		
+		/** The vertices of every ring, the outer boundary first */
+		std::vector<Point2<Scalar>> vertices;
+		/** The first vertex of each ring, and the number of vertices */
+		std::vector<std::uint32_t> offsets;
+	};
+	
+	typedef Polygon2<float> Polygon2f;
+	typedef Polygon2<double> Polygon2d;
+	typedef Polygon2<std::int32_t> Polygon2i;
+	typedef Polygon2<std::int64_t> Polygon2l;
+	
+	namespace detail {
+		/*
+		 * The signed area of a ring and its first moments, twice and six
+		 * times over, relative to the point o, which keeps the products
+		 * small for coordinates far from the origin.
+		 */
+		template <typename S>
+		void ringMoments(const Point2<S> *p, std::size_t count,
+										 const Point2<S> &o, double &area, double &mx, double &my)
+		{
+			area = mx = my = 0;
+			for(std::size_t i = 0, j = count - 1; i < count; j = i++) {
+				const double x0 = double(p[j].x) - double(o.x);
+				const double y0 = double(p[j].y) - double(o.y);
+				const double x1 = double(p[i].x) - double(o.x);
+				const double y1 = double(p[i].y) - double(o.y);
+				const double cross = x0 * y1 - x1 * y0;
+				area += cross;
+				mx += (x0 + x1) * cross;
+				my += (y0 + y1) * cross;
+			}
+		}
+		
+		template <typename S>
+		double ringArea(const Point2<S> *p, std::size_t count) {
+			double area = 0, mx, my;
+			if(count >= 3) {
+				ringMoments(p, count, p[0], area, mx, my);
+			}
+			return area / 2;
+		}
+		
+		/*
+		 * The sign orient2d(a, b, c) takes when zero and c is moved by
+		 * (e, e * e) for an infinitesimal e > 0, or 0 if a and b are the
+		 * same point. Moving all points by the same amount leaves no point
+		 * on a line through two others.
+		 */
+		template <typename S>
+		int perturbation(const Point2<S> &a, const Point2<S> &b) {
+			if(a.y != b.y) {
+				return a.y > b.y ? 1 : -1;
+			}
+			return b.x > a.x ? 1 : (b.x < a.x ? -1 : 0);
+		}
+		
+		/* The sign of orient2d(a, b, c) with c moved as in perturbation() */
+		template <typename S>
+		int perturbedOrient(const Point2<S> &a, const Point2<S> &b,
+												const Point2<S> &c)
+		{
+			const double o = orient2d(a, b, c);
+			return o != 0 ? (o > 0 ? 1 : -1) : perturbation(a, b);
+		}
+		
+		/*
+		 * Whether the edge from a to b crosses the ray to the right of p,
+		 * with p moved as in perturbation(), so that no vertex or edge is
+		 * on the ray and the edge crosses it if its ends are on either side
+		 * and it passes right of p.
+		 */
+		template <typename S>
+		bool crossesRight(const Point2<S> &a, const Point2<S> &b,
+											const Point2<S> &p)
+		{
+			return (a.y > p.y) != (b.y > p.y) &&
+				(perturbedOrient(a, b, p) > 0) == (b.y > a.y);
+		}
+		
+		/* The most vertices the ear clipper takes, keeping them on the stack */
+		enum { EarClipLimit = 32 };
+		
+		/*
+		 * Triangulate a ring of at most EarClipLimit vertices by clipping
+		 * ears, appending the triangles counterclockwise. A vertex is an ear
+		 * if it is convex and no other vertex is in or on its triangle, which
+		 * only takes exact orientations; only vertices which are not convex
+		 * can be in it, and those are kept as a mask of bits. A ring where no
+		 * ear is left is straight or folds back at some vertex, which is
+		 * dropped, unless it crosses itself, which fails.
+		 */
+		template <typename S>
+		bool earClip(const Point2<S> *p, std::uint32_t first, std::uint32_t n,
+								 bool ccw, std::vector<std::uint32_t> &triangles)
+		{
+			std::uint32_t prev[EarClipLimit] = { }, next[EarClipLimit] = { };
+			for(std::uint32_t i = 0; i < n; ++i) {
+				next[i] = ccw ? (i + 1) % n : (i + n - 1) % n;
+				prev[i] = ccw ? (i + n - 1) % n : (i + 1) % n;
+			}
+			p += first;
+			std::uint32_t reflex = 0;
+			for(std::uint32_t i = 0; i < n; ++i) {
+				if(orient2d(p[prev[i]], p[i], p[next[i]]) <= 0) {
+					reflex |= std::uint32_t(1) << i;
+				}
+			}
+			std::uint32_t left = n, i = 0, tried = 0;
+			while(left > 3) {
+				const std::uint32_t a = prev[i], c = next[i];
+				bool ear = !(reflex >> i & 1);
+				std::uint32_t inside = reflex & ~(std::uint32_t(1) << a) &
+					~(std::uint32_t(1) << c);
+				for(; ear && inside != 0; inside &= inside - 1) {
+					const Point2<S> &q = p[simd::lowestBit(inside)];
+					ear = samePoint(q, p[a]) || samePoint(q, p[i]) ||
+						samePoint(q, p[c]) || orient2d(p[a], p[i], q) < 0 ||
+						orient2d(p[i], p[c], q) < 0 || orient2d(p[c], p[a], q) < 0;
+				}
+				if(!ear && ++tried < left) {
+					i = c;
+					continue;
+				}
+				if(ear) {
+					triangles.push_back(first + a);
+					triangles.push_back(first + i);
+					triangles.push_back(first + c);
+				} else {
+					/* No ears: drop a vertex where the ring is straight */
+					std::uint32_t k = i, j = 0;
+					for(; j < left && orient2d(p[prev[k]], p[k], p[next[k]]) != 0;
+							++j, k = next[k]) { }
+					if(j == left) {
+						return false;
+					}
+					i = k;
+				}
+				next[prev[i]] = next[i];
+				prev[next[i]] = prev[i];
+				reflex &= ~(std::uint32_t(1) << i);
+				for(std::uint32_t k = prev[i], j = 0; j < 2; k = next[i], ++j) {
+					const std::uint32_t bit = std::uint32_t(1) << k;
+					reflex = orient2d(p[prev[k]], p[k], p[next[k]]) <= 0 ?
+						reflex | bit : reflex & ~bit;
+				}
+				i = prev[i];
+				--left;
+				tried = 0;
+			}
+			if(orient2d(p[prev[i]], p[i], p[next[i]]) > 0) {
+				triangles.push_back(first + prev[i]);
+				triangles.push_back(first + i);
+				triangles.push_back(first + next[i]);
+			}
+			return true;
+		}
+		
+		/*
+		 * Triangulation by decomposition into monotone pieces (Lee and
+		 * Preparata, as in de Berg et al.). A sweep from top to bottom adds a
+		 * diagonal from every split vertex, where the boundary turns down
+		 * into the interior, and to every merge vertex, where it turns up,
+		 * which leaves pieces monotone in y; the pieces are found by walking
+		 * the rings and diagonals, and each triangulated in linear time.
+		 *
+		 * The rings are oriented with the interior on their left, and ties in
+		 * y are broken by x, as if the plane were sheared a little, so that
+		 * every predicate is an exact orientation.
+		 */
+		template <typename S>
+		class MonotoneTriangulator {
+		public:
+			MonotoneTriangulator(const Point2<S> *points,
+													 const std::uint32_t *offsets, std::size_t rings) :
+				points(points), status(StatusLess(*this))
+			{
+				const std::uint32_t n = offsets[rings];
+				next.resize(n, None);
+				prev.resize(n, None);
+				for(std::size_t r = 0; r < rings; ++r) {
+					const std::uint32_t first = offsets[r];
+					const std::uint32_t count = offsets[r + 1] - first;
+					const double area = ringArea(points + first, count);
+					if(area == 0) {
+						continue;
+					}
+					const bool forward = (area > 0) == (r == 0);
+					for(std::uint32_t i = 0; i < count; ++i) {
+						const std::uint32_t v = first + i;
+						const std::uint32_t w = first + (i + 1) % count;
+						next[forward ? v : w] = forward ? w : v;
+						prev[forward ? w : v] = forward ? v : w;
+					}
+					for(std::uint32_t i = 0; i < count; ++i) {
+						order.push_back(first + i);
+					}
+				}
+				std::sort(order.begin(), order.end(),
+									[this](std::uint32_t u, std::uint32_t v) {
+										return above(u, v);
+									});
+			}
+			
+			bool run(std::vector<std::uint32_t> &triangles) {
+				helper.resize(next.size(), None);
+				merge.resize(next.size(), false);
+				handles.resize(next.size(), status.end());
+				for(std::size_t k = 0; k < order.size(); ++k) {
+					if(!sweep(order[k])) {
+						return false;
+					}
+				}
+				pieces(triangles);
+				return true;
+			}
+			
+		private:
+			static const std::uint32_t None = 0xffffffff;
+			/* The current vertex, when it is compared with the status */
+			static const std::uint32_t Probe = 0xfffffffe;
+			
+			/*
+			 * The order of the edges cut by the sweep line from left to right,
+			 * where edge e runs from vertex e to next[e] and Probe stands for
+			 * the current vertex. Edges in the status never cross, so one of
+			 * them has both ends on one side of the line through the other.
+			 */
+			struct StatusLess {
+				explicit StatusLess(const MonotoneTriangulator &t) : t(&t) { }
+				bool operator()(std::uint32_t e, std::uint32_t f) const {
+					if(e == f) {
+						return false;
+					}
+					if(e == Probe || f == Probe) {
+						const double o = f == Probe ? t->side(e, t->current) :
+							-t->side(f, t->current);
+						return o > 0;
+					}
+					const double e0 = t->side(e, f), e1 = t->side(e, t->next[f]);
+					if((e0 > 0 && e1 >= 0) || (e0 >= 0 && e1 > 0)) {
+						return true;
+					} else if((e0 < 0 && e1 <= 0) || (e0 <= 0 && e1 < 0)) {
+						return false;
+					}
+					const double f0 = t->side(f, e), f1 = t->side(f, t->next[e]);
+					if((f0 < 0 && f1 <= 0) || (f0 <= 0 && f1 < 0)) {
+						return true;
+					} else if((f0 > 0 && f1 >= 0) || (f0 >= 0 && f1 > 0)) {
+						return false;
+					}
+					return e < f;
+				}
+				const MonotoneTriangulator *t;
+			};
+			typedef std::set<std::uint32_t, StatusLess> Status;
+			
+			/* Whether vertex u comes before v in the sweep */
+			bool above(std::uint32_t u, std::uint32_t v) const {
+				const Point2<S> &a = points[u], &b = points[v];
+				return a.y > b.y || (a.y == b.y && (a.x < b.x ||
+																						(a.x == b.x && u < v)));
+			}
+			
+			/*
+			 * The side of edge e that vertex v is on, positive to the right
+			 * of the sweep, whichever way the edge runs.
+			 */
+			double side(std::uint32_t e, std::uint32_t v) const {
+				const std::uint32_t f = next[e];
+				return above(e, f) ? orient2d(points[e], points[f], points[v]) :
+					orient2d(points[f], points[e], points[v]);
+			}
+			
+			void diagonal(std::uint32_t u, std::uint32_t v) {
+				diagonals.push_back(u);
+				diagonals.push_back(v);
+			}
+			
+			/* Add a diagonal from v if the helper of edge e is a merge vertex */
+			void fix(std::uint32_t e, std::uint32_t v) {
+				if(helper[e] != None && merge[helper[e]]) {
+					diagonal(v, helper[e]);
+				}
+			}
+			
+			/* The edge of the status directly left of v, or None */
+			std::uint32_t leftOf(std::uint32_t v) {
+				current = v;
+				typename Status::iterator i = status.lower_bound(Probe);
+				return i == status.begin() ? None : *--i;
+			}
+			
+			bool sweep(std::uint32_t v) {
+				const std::uint32_t u = prev[v], w = next[v];
+				const bool convex = orient2d(points[u], points[v], points[w]) > 0;
+				const bool uBelow = above(v, u), wBelow = above(v, w);
+				current = v;
+				if(uBelow && wBelow) {
+					if(!convex) {
+						/* A split vertex */
+						const std::uint32_t e = leftOf(v);
+						if(e == None) {
+							return false;
+						}
+						diagonal(v, helper[e]);
+						helper[e] = v;
+					}
+					handles[v] = status.insert(v).first;
+					helper[v] = v;
+				} else if(!uBelow && !wBelow) {
+					fix(u, v);
+					status.erase(handles[u]);
+					if(!convex) {
+						/* A merge vertex */
+						const std::uint32_t e = leftOf(v);
+						if(e == None) {
+							return false;
+						}
+						fix(e, v);
+						helper[e] = v;
+						merge[v] = true;
+					}
+				} else if(wBelow) {
+					/* On a boundary running down, with the interior to its right */
+					fix(u, v);
+					status.erase(handles[u]);
+					handles[v] = status.insert(v).first;
+					helper[v] = v;
+				} else {
+					const std::uint32_t e = leftOf(v);
+					if(e == None) {
+						return false;
+					}
+					fix(e, v);
+					helper[e] = v;
+				}
+				return true;
+			}
+			
+			/*
+			 * Whether, turning clockwise around v from the direction to u,
+			 * the direction to a comes before that to b.
+			 */
+			bool clockwiseLess(std::uint32_t v, std::uint32_t u, std::uint32_t a,
+												 std::uint32_t b) const
+			{
+				const int ra = turn(v, u, a), rb = turn(v, u, b);
+				if(ra != rb) {
+					return ra < rb;
+				}
+				const double o = orient2d(points[v], points[a], points[b]);
+				return o != 0 ? o < 0 : a < b;
+			}
+			
+			/*
+			 * The half-turn clockwise from the direction v to u that the
+			 * direction to a is in: 0 for the first, 1 opposite, 2 for the
+			 * second and 3 along it.
+			 */
+			int turn(std::uint32_t v, std::uint32_t u, std::uint32_t a) const {
+				const Point2<S> &c = points[v];
+				const double o = orient2d(c, points[u], points[a]);
+				if(o != 0) {
+					return o < 0 ? 0 : 2;
+				}
+				const double dot =
+					(double(points[u].x) - c.x) * (double(points[a].x) - c.x) +
+					(double(points[u].y) - c.y) * (double(points[a].y) - c.y);
+				return dot > 0 ? 3 : 1;
+			}
+			
+			/*
+			 * Split the polygon along the diagonals into monotone pieces and
+			 * triangulate them. Half-edge v < n is the ring edge from v, and
+			 * the diagonals add a pair each; the piece left of a half-edge into
+			 * v continues along the first half-edge out of v clockwise from it.
+			 */
+			void pieces(std::vector<std::uint32_t> &triangles) {
+				const std::uint32_t n = std::uint32_t(next.size());
+				if(diagonals.empty()) {
+					if(!order.empty()) {
+						walk(order[0], triangles);
+					}
+					return;
+				}
+				
+				/* The half-edges out of each vertex, with its ring edge first */
+				const std::uint32_t h = n + std::uint32_t(diagonals.size());
+				std::vector<std::uint32_t> from(h), to(h), start(n + 1, 0);
+				for(std::uint32_t v = 0; v < n; ++v) {
+					from[v] = v;
+					to[v] = next[v];
+					start[v + 1] = next[v] != None;
+				}
+				for(std::uint32_t d = 0; d < diagonals.size(); ++d) {
+					from[n + d] = diagonals[d];
+					to[n + d] = diagonals[d ^ 1];
+					++start[diagonals[d] + 1];
+				}
+				for(std::uint32_t v = 0; v < n; ++v) {
+					start[v + 1] += start[v];
+				}
+				std::vector<std::uint32_t> out(start[n]);
+				std::vector<std::uint32_t> cursor(start.begin(), start.end() - 1);
+				for(std::uint32_t e = 0; e < h; ++e) {
+					if(e >= n || next[e] != None) {
+						out[cursor[from[e]]++] = e;
+					}
+				}
+				
+				succ.assign(h, None);
+				for(std::uint32_t e = 0; e < h; ++e) {
+					if(e < n && next[e] == None) {
+						continue;
+					}
+					const std::uint32_t v = to[e], u = from[e];
+					std::uint32_t best = out[start[v]];
+					for(std::uint32_t k = start[v] + 1; k < start[v + 1]; ++k) {
+						if(clockwiseLess(v, u, to[out[k]], to[best])) {
+							best = out[k];
+						}
+					}
+					succ[e] = best;
+				}
+				
+				std::vector<bool> seen(h, false);
+				for(std::uint32_t e = 0; e < h; ++e) {
+					if(seen[e] || succ[e] == None) {
+						continue;
+					}
+					piece.clear();
+					for(std::uint32_t f = e; !seen[f]; f = succ[f]) {
+						seen[f] = true;
+						piece.push_back(from[f]);
+					}
+					monotone(triangles);
+				}
+			}
+			
+			/* Triangulate the ring through v, which is monotone */
+			void walk(std::uint32_t v, std::vector<std::uint32_t> &triangles) {
+				piece.clear();
+				std::uint32_t u = v;
+				do {
+					piece.push_back(u);
+					u = next[u];
+				} while(u != v);
+				monotone(triangles);
+			}
+			
+			void emit(std::uint32_t a, std::uint32_t b, std::uint32_t c,
+								std::vector<std::uint32_t> &triangles) const
+			{
+				const double o = orient2d(points[a], points[b], points[c]);
+				if(o != 0) {
+					triangles.push_back(a);
+					triangles.push_back(o > 0 ? b : c);
+					triangles.push_back(o > 0 ? c : b);
+				}
+			}
+			
+			/*
+			 * Triangulate the monotone piece, counterclockwise, by the stack
+			 * algorithm: its two chains are merged from the top down, and each
+			 * vertex cuts off the triangles it sees of the chain above it.
+			 */
+			void monotone(std::vector<std::uint32_t> &triangles) {
+				const std::size_t m = piece.size();
+				if(m < 3) {
+					return;
+				}
+				std::size_t top = 0, bottom = 0;
+				for(std::size_t k = 1; k < m; ++k) {
+					top = above(piece[k], piece[top]) ? k : top;
+					bottom = above(piece[bottom], piece[k]) ? k : bottom;
+				}
+				
+				/* The left chain runs counterclockwise from the top */
+				chain.clear();
+				chain.push_back(Vertex(piece[top], true));
+				std::size_t left = (top + 1) % m, right = (top + m - 1) % m;
+				while(chain.size() < m) {
+					if(right == bottom ||
+						 (left != bottom && above(piece[left], piece[right])))
+					{
+						chain.push_back(Vertex(piece[left], true));
+						left = (left + 1) % m;
+					} else {
+						chain.push_back(Vertex(piece[right], false));
+						right = (right + m - 1) % m;
+					}
+				}
+				
+				stack.clear();
+				stack.push_back(chain[0]);
+				stack.push_back(chain[1]);
+				for(std::size_t k = 2; k < m; ++k) {
+					const Vertex &v = chain[k];
+					if(v.left != stack.back().left || k == m - 1) {
+						for(std::size_t j = 1; j < stack.size(); ++j) {
+							emit(v.index, stack[j - 1].index, stack[j].index, triangles);
+						}
+						const Vertex last = stack.back();
+						stack.clear();
+						stack.push_back(last);
+						stack.push_back(v);
+						continue;
+					}
+					Vertex l = stack.back();
+					stack.pop_back();
+					while(!stack.empty()) {
+						const Vertex &s = stack.back();
+						const double o = orient2d(points[v.index], points[l.index],
+																			points[s.index]);
+						if(v.left ? o >= 0 : o <= 0) {
+							break;
+						}
+						emit(v.index, l.index, s.index, triangles);
+						l = s;
+						stack.pop_back();
+					}
+					stack.push_back(l);
+					stack.push_back(v);
+				}
+			}
+			
+			/* A vertex of a monotone piece and its chain */
+			struct Vertex {
+				Vertex(std::uint32_t index, bool left) : index(index), left(left) { }
+				std::uint32_t index;
+				bool left;
+			};
+			
+			const Point2<S> *points;
+			std::vector<std::uint32_t> next, prev, order, helper, diagonals;
+			std::vector<bool> merge;
+			std::uint32_t current;
+			Status status;
+			std::vector<typename Status::iterator> handles;
+			std::vector<std::uint32_t> succ, piece;
+			std::vector<Vertex> chain, stack;
+		};
+		template <typename S>
+		const std::uint32_t MonotoneTriangulator<S>::None;
+		template <typename S>
+		const std::uint32_t MonotoneTriangulator<S>::Probe;
+		
+		template <typename S>
+		bool triangulate(const Point2<S> *points, const std::uint32_t *offsets,
+										 std::size_t rings, std::vector<std::uint32_t> &triangles)
+		{
+			triangles.clear();
+			if(rings == 0) {
+				return true;
+			}
+			const std::uint32_t n = offsets[1] - offsets[0];
+			if(rings == 1 && n <= EarClipLimit) {
+				const double area = ringArea(points + offsets[0], n);
+				return area == 0 ||
+					earClip(points, offsets[0], n, area > 0, triangles);
+			}
+			MonotoneTriangulator<S> t(points, offsets, rings);
+			return t.run(triangles);
+		}
+	}
+	
+	/**
+	 * \brief Get the orientation of the outer boundary of a polygon.
+	 * \return 1 if it runs counterclockwise, -1 if clockwise and 0 if it
+	 * has no area
+	 */
+	template <typename Scalar>
+	int winding(const Polygon2<Scalar> &polygon) {
+		const double area = polygon.rings() == 0 ? 0 :
+			detail::ringArea(polygon.vertices.data(), polygon.offsets[1]);
+		return area > 0 ? 1 : (area < 0 ? -1 : 0);
+	}
+	
+	/**
+	 * \brief Get the area of a polygon, that of its outer boundary less
+	 * those of its holes, whichever way its rings run.
+	 */
+	template <typename Scalar>
+	double area(const Polygon2<Scalar> &polygon) {
+		double total = 0;
+		for(std::size_t r = 0; r < polygon.rings(); ++r) {
+			const std::uint32_t first = polygon.offsets[r];
+			const std::uint32_t count = polygon.offsets[r + 1] - first;
+			const double a =
+				std::fabs(detail::ringArea(&polygon.vertices[first], count));
+			total += r == 0 ? a : -a;
+		}
+		return total;
+	}
+	
+	/**
+	 * \brief Get the centroid of a polygon, the center of mass of its area.
+	 * \return The centroid, or the first vertex if the polygon has no area
+	 */
+	template <typename Scalar>
+	Point2d centroid(const Polygon2<Scalar> &polygon) {
+		if(polygon.vertices.empty()) {
+			return Point2d(0, 0);
+		}
+		const Point2<Scalar> &o = polygon.vertices[0];
+		double area = 0, mx = 0, my = 0;
+		for(std::size_t r = 0; r < polygon.rings(); ++r) {
+			const std::uint32_t first = polygon.offsets[r];
+			const std::uint32_t count = polygon.offsets[r + 1] - first;
+			if(count < 3) {
+				continue;
+			}
+			double a, x, y;
+			detail::ringMoments(&polygon.vertices[first], count, o, a, x, y);
+			const double sign = (a > 0) == (r == 0) ? 1 : -1;
+			area += sign * a;
+			mx += sign * x;
+			my += sign * y;
+		}
+		if(area == 0) {
+			return Point2d(o.x, o.y);
+		}
+		return Point2d(o.x + mx / (3 * area), o.y + my / (3 * area));
+	}
+	
+	/**
+	 * \brief Test whether a point is inside a polygon, by the parity of the
+	 * edges of all its rings crossing the ray to the right of the point.
+	 *
+	 * The test is exact. A point on the boundary is taken as moved right by
+	 * an infinitesimal distance and then up by a smaller one, so that of
+	 * polygons sharing an edge exactly one contains it.
+	 */
+	template <typename Scalar>
+	bool contains(const Polygon2<Scalar> &polygon, const Point2<Scalar> &p) {
+		bool inside = false;
+		for(std::size_t r = 0; r < polygon.rings(); ++r) {
+			const std::uint32_t first = polygon.offsets[r];
+			const std::uint32_t last = polygon.offsets[r + 1];
+			for(std::uint32_t i = first, j = last - 1; i < last; j = i++) {
+				inside ^= detail::crossesRight(polygon.vertices[j],
+																			 polygon.vertices[i], p);
+			}
+		}
+		return inside;
+	}
+	
+	/**
+	 * \brief Triangulate a polygon.
+	 *
+	 * An outline without holes of up to 32 vertices is cut into ears, which
+	 * takes no memory beyond the output; larger polygons and those with
+	 * holes are decomposed into monotone pieces in O(n log n) time. Both use
+	 * exact orientation predicates. The triangles cover the polygon, with
+	 * any triangles of zero area left out, and run counterclockwise.
+	 *
+	 * \arg \c polygon The polygon, which must be simple.
+	 * \arg \c triangles Receives the triangles, as three indices each into
+	 * the vertices of the polygon. Its storage is reused.
+	 * \return False if the polygon was found not to be simple, in which case
+	 * the triangles are incomplete.
+	 */
+	template <typename Scalar>
+	bool triangulate(const Polygon2<Scalar> &polygon,
+									 std::vector<std::uint32_t> &triangles)
+	{
+		return detail::triangulate(polygon.vertices.data(),
+															 polygon.offsets.data(), polygon.rings(),
+															 triangles);
+	}
+	/**
+	 * \brief Triangulate a simple polygon without holes, given as an array of
+	 * points.
+	 * \see triangulate(const Polygon2<Scalar>&, std::vector<std::uint32_t>&)
+	 */
+	template <typename Scalar>
+	bool triangulate(const Point2<Scalar> *points, std::size_t count,
+									 std::vector<std::uint32_t> &triangles)
+	{
+		const std::uint32_t offsets[2] = { 0, std::uint32_t(count) };
+		return detail::triangulate(points, offsets, 1, triangles);
+	}
+}
+
+#endif
@@ -0,0 +1,529 @@
+/**
+ * \file PolygonGrid2.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Point location in fixed sets of polygons by a grid of edge buckets
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_POLYGON_GRID2_HPP
+#define GEOM_POLYGON_GRID2_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "ConvexHull.hpp"
+#include "Parallel.hpp"
+#include "Point2.hpp"
+#include "Polygon2.hpp"
+#include "Predicates.hpp"
+
+namespace geom {
+	/**
+	 * \brief A fixed set of polygons preprocessed for point location.
+	 *
+	 * A uniform grid covers the bounds of the polygons. Each cell keeps a
+	 * copy of every edge touching it, a reference point inside it and the
+	 * ids of the polygons containing that point, so that a query counts
+	 * only the edges of its cell which cross the segment from the
+	 * reference point. The cells away from the boundaries have no edges
+	 * and answer at once. The id of a polygon is its index in the input.
+	 *
+	 * \see polygonGrid
+	 */
+	template <typename Scalar>
+	struct PolygonGrid2 {
+		enum : std::uint32_t { None = 0xffffffff };
+		
+		/** An edge of polygon \c polygon, from \c a to \c b */
+		struct Edge {
+			Point2<Scalar> a, b;
+			std::uint32_t polygon;
+		};
+		
+		/** A cell, whose edges and ids run up to those of the next cell */
+		struct Cell {
+			/** The first edge touching the cell, sorted by polygon */
+			std::uint32_t edges;
+			/** The first id of the polygons containing the reference point */
+			std::uint32_t inside;
+			/** The reference point, in the cell */
+			Point2<Scalar> reference;
+		};
+		
+		PolygonGrid2() :
+			width(0), height(0), xScale(0), yScale(0), columns(0), rows(0)
+		{ }
+		
+		void clear() {
+			lower = upper = Point2<Scalar>();
+			width = height = xScale = yScale = 0;
+			columns = rows = 0;
+			cells.clear();
+			edges.clear();
+			inside.clear();
+		}
+		
+		/** The column of the cell at x, clamped to the grid */
+		std::uint32_t column(double x) const {
+			const double c = (x - double(lower.x)) * xScale;
+			return c <= 0 ? 0 : (c >= columns - 1 ? columns - 1 : std::uint32_t(c));
+		}
+		/** The row of the cell at y, clamped to the grid */
+		std::uint32_t row(double y) const {
+			const double r = (y - double(lower.y)) * yScale;
+			return r <= 0 ? 0 : (r >= rows - 1 ? rows - 1 : std::uint32_t(r));
+		}
+		
+		/**
+		 * The cell of a point, or \c None outside the bounds. Moved right
+		 * and up, a point on their upper sides is outside too.
+		 */
+		std::size_t cell(const Point2<Scalar> &p) const {
+			if(!(p.x >= lower.x && p.x < upper.x && p.y >= lower.y &&
+					 p.y < upper.y))
+			{
+				return None;
+			}
+			return std::size_t(row(p.y)) * columns + column(p.x);
+		}
+		
+		/** The lower corner of the bounds of the polygons */
+		Point2<Scalar> lower;
+		/** The upper corner of the bounds of the polygons */
+		Point2<Scalar> upper;
+		double width; /**< The width of a cell */
+		double height; /**< The height of a cell */
+		double xScale; /**< The inverse of the width */
+		double yScale; /**< The inverse of the height */
+		std::uint32_t columns; /**< The number of columns */
+		std::uint32_t rows; /**< The number of rows */
+		/** The cells by rows from the bottom, and one more after the last */
+		std::vector<Cell> cells;
+		/** The edges of each cell in turn */
+		std::vector<Edge> edges;
+		/** The ids of the polygons containing the reference points, sorted */
+		std::vector<std::uint32_t> inside;
+	};
+	
+	typedef PolygonGrid2<float> PolygonGrid2f;
+	typedef PolygonGrid2<double> PolygonGrid2d;
+	typedef PolygonGrid2<std::int32_t> PolygonGrid2i;
+	typedef PolygonGrid2<std::int64_t> PolygonGrid2l;
+	
+	namespace detail {
+		/*
+		 * Builds a grid in three passes: the bounds and number of edges,
+		 * the edges of each cell, and the polygons containing the reference
+		 * points. Cells are taken as larger by a margin of 1/64, and at least
+		 * the rounding error of S at the coordinates of the grid, so that
+		 * neither the rounding in finding the cell of a point nor that of
+		 * the reference points ever puts one where an edge near it is
+		 * missing.
+		 *
+		 * The reference points of a row share a y, and the polygons which
+		 * contain each are found from those of the one to its right, by the
+		 * edges crossing the segment between them. These all touch one of
+		 * the two cells, whose common side splits the segment.
+		 */
+		template <typename S>
+		class PolygonGridBuilder {
+		public:
+			typedef typename PolygonGrid2<S>::Edge Edge;
+			typedef typename PolygonGrid2<S>::Cell Cell;
+			
+			PolygonGridBuilder(const Polygon2<S> *polygons, std::size_t count,
+												 PolygonGrid2<S> &grid) :
+				polygons(polygons), count(count), grid(grid), total(0)
+			{ }
+			
+			void build(std::size_t cells) {
+				grid.clear();
+				if(!bound()) {
+					return;
+				}
+				layout(cells != 0 ? cells : total);
+				bucket();
+				references();
+			}
+			
+		private:
+			/* Call f(polygon, a, b) for every edge but those of no length */
+			template <typename F>
+			void forEachEdge(F f) const {
+				for(std::size_t i = 0; i < count; ++i) {
+					const Polygon2<S> &polygon = polygons[i];
+					for(std::size_t r = 0; r < polygon.rings(); ++r) {
+						const std::uint32_t first = polygon.offsets[r];
+						const std::uint32_t last = polygon.offsets[r + 1];
+						for(std::uint32_t k = first, j = last - 1; k < last; j = k++) {
+							const Point2<S> &a = polygon.vertices[j];
+							const Point2<S> &b = polygon.vertices[k];
+							if(!samePoint(a, b)) {
+								f(std::uint32_t(i), a, b);
+							}
+						}
+					}
+				}
+			}
+			
+			bool bound() {
+				bool first = true;
+				forEachEdge([&](std::uint32_t, const Point2<S> &a,
+												const Point2<S> &) {
+						if(first) {
+							grid.lower = grid.upper = a;
+							first = false;
+						}
+						grid.lower.x = std::min(grid.lower.x, a.x);
+						grid.lower.y = std::min(grid.lower.y, a.y);
+						grid.upper.x = std::max(grid.upper.x, a.x);
+						grid.upper.y = std::max(grid.upper.y, a.y);
+						++total;
+					});
+				return total != 0;
+			}
+			
+			/* Cells about as square as the bounds allow */
+			void layout(std::size_t cells) {
+				const double w = double(grid.upper.x) - double(grid.lower.x);
+				const double h = double(grid.upper.y) - double(grid.lower.y);
+				const double target = double(cells), most = double(1 << 15);
+				double columns = 1, rows = 1;
+				if(w > 0 && h > 0) {
+					columns = std::ceil(std::sqrt(target * w / h));
+					columns = std::max(1.0, std::min(columns, most));
+					rows = std::max(1.0, std::min(std::ceil(target / columns), most));
+				} else if(w > 0) {
+					columns = std::min(target, most);
+				} else if(h > 0) {
+					rows = std::min(target, most);
+				}
+				double width = w > 0 ? w / columns : 1;
+				double height = h > 0 ? h / rows : 1;
+				if(std::numeric_limits<S>::is_integer) {
+					/* Cell sides of whole units, so that they are exact */
+					width = std::ceil(width);
+					height = std::ceil(height);
+					columns = std::max(1.0, std::ceil(w / width));
+					rows = std::max(1.0, std::ceil(h / height));
+				}
+				grid.width = width;
+				grid.height = height;
+				grid.xScale = 1 / width;
+				grid.yScale = 1 / height;
+				grid.columns = std::uint32_t(columns);
+				grid.rows = std::uint32_t(rows);
+				/*
+				 * The reference points and the ends of the segments between
+				 * them are rounded to S, by up to half an ulp at the
+				 * coordinates of the grid, which may be more than a cell
+				 * when S is float far from the origin.
+				 */
+				const double epsilon = std::numeric_limits<S>::epsilon();
+				const double x = std::max(std::fabs(double(grid.lower.x)),
+																	std::fabs(double(grid.upper.x)));
+				const double y = std::max(std::fabs(double(grid.lower.y)),
+																	std::fabs(double(grid.upper.y)));
+				xMargin = std::max(width / 64, epsilon * x);
+				yMargin = std::max(height / 64, epsilon * y);
+			}
+			
+			/*
+			 * Call f(cell) for every cell the edge from a to b touches, or
+			 * may touch, by the part of the edge in each row.
+			 */
+			template <typename F>
+			void cover(const Point2<S> &a, const Point2<S> &b, F f) const {
+				const double ax = a.x, ay = a.y, bx = b.x, by = b.y;
+				const std::uint32_t last = grid.row(std::max(ay, by) + yMargin);
+				for(std::uint32_t j = grid.row(std::min(ay, by) - yMargin);
+						j <= last; ++j)
+				{
+					double x0 = std::min(ax, bx), x1 = std::max(ax, bx);
+					if(ay != by) {
+						const double y0 = double(grid.lower.y) + j * grid.height;
+						double t0 = (y0 - yMargin - ay) / (by - ay);
+						double t1 = (y0 + grid.height + yMargin - ay) / (by - ay);
+						if(t0 > t1) {
+							std::swap(t0, t1);
+						}
+						t0 = std::max(t0, 0.0);
+						t1 = std::min(t1, 1.0);
+						x0 = std::min(ax + t0 * (bx - ax), ax + t1 * (bx - ax));
+						x1 = std::max(ax + t0 * (bx - ax), ax + t1 * (bx - ax));
+					}
+					const std::size_t row = std::size_t(j) * grid.columns;
+					const std::uint32_t end = grid.column(x1 + xMargin);
+					for(std::uint32_t c = grid.column(x0 - xMargin); c <= end; ++c) {
+						f(row + c);
+					}
+				}
+			}
+			
+			void bucket() {
+				const std::size_t n = std::size_t(grid.columns) * grid.rows;
+				grid.cells.assign(n + 1, Cell());
+				std::vector<std::uint32_t> cursor(n + 1, 0);
+				forEachEdge([&](std::uint32_t, const Point2<S> &a,
+												const Point2<S> &b) {
+						cover(a, b, [&](std::size_t k) { ++cursor[k + 1]; });
+					});
+				for(std::size_t k = 0; k < n; ++k) {
+					cursor[k + 1] += cursor[k];
+					grid.cells[k + 1].edges = cursor[k + 1];
+				}
+				grid.edges.resize(cursor[n]);
+				forEachEdge([&](std::uint32_t polygon, const Point2<S> &a,
+												const Point2<S> &b) {
+						cover(a, b, [&](std::size_t k) {
+								Edge &e = grid.edges[cursor[k]++];
+								e.a = a;
+								e.b = b;
+								e.polygon = polygon;
+							});
+					});
+			}
+			
+			/*
+			 * Flip the polygons of the edges of cell k crossing the segment
+			 * from p to q, which have the same y, in the sorted ids.
+			 */
+			void flip(std::size_t k, const Point2<S> &p, const Point2<S> &q) {
+				const Edge *e = grid.edges.data() + grid.cells[k].edges;
+				const Edge *end = grid.edges.data() + grid.cells[k + 1].edges;
+				for(; e != end; ++e) {
+					if(crossesRight(e->a, e->b, p) != crossesRight(e->a, e->b, q)) {
+						std::vector<std::uint32_t>::iterator i =
+							std::lower_bound(ids.begin(), ids.end(), e->polygon);
+						if(i != ids.end() && *i == e->polygon) {
+							ids.erase(i);
+						} else {
+							ids.insert(i, e->polygon);
+						}
+					}
+				}
+			}
+			
+			void references() {
+				const std::uint32_t columns = grid.columns;
+				std::vector<std::uint32_t> &inside = grid.inside;
+				std::vector<std::uint32_t> row, ends(columns);
+				for(std::uint32_t j = 0; j < grid.rows; ++j) {
+					const S y = S(double(grid.lower.y) + (j + 0.5) * grid.height);
+					const std::size_t first = std::size_t(j) * columns;
+					
+					/* From the right end, which is outside every polygon */
+					Point2<S> m(grid.upper.x, y);
+					ids.clear();
+					row.clear();
+					for(std::uint32_t c = columns; c-- > 0;) {
+						Cell &cell = grid.cells[first + c];
+						cell.reference = Point2<S>(S(double(grid.lower.x) +
+																				 (c + 0.5) * grid.width), y);
+						flip(first + c, m, cell.reference);
+						row.insert(row.end(), ids.begin(), ids.end());
+						ends[c] = std::uint32_t(row.size());
+						m = Point2<S>(S(double(grid.lower.x) + c * grid.width), y);
+						flip(first + c, cell.reference, m);
+					}
+					
+					/* The ids were gathered from right to left */
+					for(std::uint32_t c = 0; c < columns; ++c) {
+						const std::uint32_t begin = c + 1 < columns ? ends[c + 1] : 0;
+						grid.cells[first + c].inside = std::uint32_t(inside.size());
+						inside.insert(inside.end(), row.begin() + begin,
+													row.begin() + ends[c]);
+					}
+				}
+				grid.cells.back().inside = std::uint32_t(inside.size());
+			}
+			
+			const Polygon2<S> *polygons;
+			std::size_t count;
+			PolygonGrid2<S> &grid;
+			std::size_t total;
+			double xMargin, yMargin;
+			std::vector<std::uint32_t> ids;
+		};
+		
+		/* Load the cache line of p ahead of its use, where the compiler can */
+		inline void prefetch(const void *p) {
+#if defined(__GNUC__)
+			__builtin_prefetch(p);
+#else
+			(void)p;
+#endif
+		}
+		
+		/*
+		 * Whether the edge from a to b crosses the segment from r to q, with
+		 * all moved as in perturbation(), which puts no vertex on the line
+		 * through r and q and neither of them on the line through the edge.
+		 */
+		template <typename S>
+		bool crossesSegment(const Point2<S> &a, const Point2<S> &b,
+												const Point2<S> &r, const Point2<S> &q)
+		{
+			const double oa = orient2d(r, q, a), ob = orient2d(r, q, b);
+			const bool above = perturbation(q, r) > 0;
+			if((oa != 0 ? oa > 0 : above) == (ob != 0 ? ob > 0 : above)) {
+				return false;
+			}
+			return (perturbedOrient(a, b, r) > 0) != (perturbedOrient(a, b, q) > 0);
+		}
+		
+		/*
+		 * The lowest id of the polygons containing p in cell k: those
+		 * containing the reference point, flipped by the edges of each
+		 * polygon crossing the segment from there to p.
+		 */
+		template <typename S>
+		std::uint32_t locate(const PolygonGrid2<S> &grid, std::size_t k,
+												 const Point2<S> &p)
+		{
+			typedef typename PolygonGrid2<S>::Edge Edge;
+			const typename PolygonGrid2<S>::Cell &cell = grid.cells[k];
+			const std::uint32_t *in = grid.inside.data() + cell.inside;
+			const std::uint32_t *inEnd =
+				grid.inside.data() + grid.cells[k + 1].inside;
+			const Edge *e = grid.edges.data() + cell.edges;
+			const Edge *end = grid.edges.data() + grid.cells[k + 1].edges;
+			while(e != end) {
+				const std::uint32_t polygon = e->polygon;
+				bool flipped = false;
+				for(; e != end && e->polygon == polygon; ++e) {
+					flipped ^= crossesSegment(e->a, e->b, cell.reference, p);
+				}
+				if(in != inEnd && *in < polygon) {
+					return *in;
+				}
+				const bool reference = in != inEnd && *in == polygon;
+				in += reference;
+				if(reference != flipped) {
+					return polygon;
+				}
+			}
+			return in != inEnd ? *in : std::uint32_t(PolygonGrid2<S>::None);
+		}
+		
+		/*
+		 * Locate points a few at a time, loading the cells of points ahead
+		 * and then their edges and ids, which would otherwise miss cache
+		 * one after the other on scattered points.
+		 */
+		template <typename S>
+		void locate(const PolygonGrid2<S> &grid, const Point2<S> *points,
+								std::size_t count, std::uint32_t *ids)
+		{
+			enum { Ahead = 8 };
+			const std::size_t None = grid.None;
+			std::size_t cells[2 * Ahead];
+			for(std::size_t i = 0; i < count + 2 * Ahead; ++i) {
+				std::size_t &k = cells[i % (2 * Ahead)];
+				if(i >= 2 * Ahead) {
+					const std::size_t j = i - 2 * Ahead;
+					ids[j] = k == None ? std::uint32_t(None) :
+						locate(grid, k, points[j]);
+				}
+				k = i < count ? grid.cell(points[i]) : None;
+				if(k != None) {
+					prefetch(&grid.cells[k]);
+				}
+				const std::size_t h = cells[(i + Ahead) % (2 * Ahead)];
+				if(i >= Ahead && h != None) {
+					prefetch(grid.edges.data() + grid.cells[h].edges);
+					prefetch(grid.inside.data() + grid.cells[h].inside);
+				}
+			}
+		}
+	}
+	
+	/**
+	 * \brief Preprocess a set of polygons for point location.
+	 *
+	 * Building takes time linear in the number of edges and cells, and
+	 * the storage of the edges, once more for each further cell an edge
+	 * touches. By default there are about as many cells as edges, which
+	 * suits boundaries of many short edges.
+	 *
+	 * \arg \c polygons The polygons, whose ids are their indices. They may
+	 * overlap, and their rings may run either way.
+	 * \arg \c count The number of polygons
+	 * \arg \c grid Receives the grid. Its storage is reused.
+	 * \arg \c cells The number of cells to aim for, or 0 for the number of
+	 * edges
+	 * \see locate
+	 */
+	template <typename Scalar>
+	void polygonGrid(const Polygon2<Scalar> *polygons, std::size_t count,
+									 PolygonGrid2<Scalar> &grid, std::size_t cells = 0)
+	{
+		detail::PolygonGridBuilder<Scalar> builder(polygons, count, grid);
+		builder.build(cells);
+	}
+	
+	/**
+	 * \brief Find the polygon containing a point.
+	 *
+	 * The result is exact, and is that of contains(const Polygon2<Scalar>&,
+	 * const Point2<Scalar>&) for every polygon, including points on a
+	 * boundary.
+	 *
+	 * \return The lowest id of the polygons containing \c p, or \c None
+	 */
+	template <typename Scalar>
+	std::uint32_t locate(const PolygonGrid2<Scalar> &grid,
+											 const Point2<Scalar> &p)
+	{
+		const std::size_t k = grid.cell(p);
+		return k == grid.None ? std::uint32_t(grid.None) :
+			detail::locate(grid, k, p);
+	}
+	
+	/**
+	 * \brief Find the polygons containing an array of points.
+	 *
+	 * The optional \c Parallel argument splits arrays over its threshold
+	 * between several threads, see Parallel.hpp.
+	 *
+	 * \arg \c ids Receives the lowest id of the polygons containing each
+	 * point, or \c None
+	 * \see locate(const PolygonGrid2<Scalar>&, const Point2<Scalar>&)
+	 */
+	template <typename Scalar>
+	void locate(const PolygonGrid2<Scalar> &grid, const Point2<Scalar> *points,
+							std::size_t count, std::uint32_t *ids,
+							const Parallel &parallel = Parallel::serial())
+	{
+		detail::parallelFor(count, parallel,
+												[&](std::size_t first, std::size_t n) {
+			detail::locate(grid, points + first, n, ids + first);
+		});
+	}
+}
+
+#endif
@@ -0,0 +1,588 @@
+/**
+ * \file Predicates.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Exact orientation and incircle predicates with adaptive precision
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_PREDICATES_HPP
+#define GEOM_PREDICATES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "Exact.hpp"
+#include "Point2.hpp"
+#include "Point3.hpp"
+
+namespace geom {
+	namespace detail {
+		namespace predicates {
+			using namespace exact;
+			
+			/*
+			 * Bounds on the relative error of the determinants evaluated in
+			 * double precision, as multiples of their permanents, from
+			 * Shewchuk's predicates.c.
+			 */
+			const double Orient2dBound = (3 + 16 * Epsilon) * Epsilon;
+			const double Orient3dBound = (7 + 56 * Epsilon) * Epsilon;
+			const double IncircleBound = (10 + 96 * Epsilon) * Epsilon;
+			const double InsphereBound = (16 + 224 * Epsilon) * Epsilon;
+			
+			/*
+			 * Bounds on the error of the determinants evaluated exactly on the
+			 * rounded differences of the coordinates.
+			 */
+			const double Orient2dBoundB = (2 + 12 * Epsilon) * Epsilon;
+			const double Orient3dBoundB = (3 + 28 * Epsilon) * Epsilon;
+			const double IncircleBoundB = (4 + 48 * Epsilon) * Epsilon;
+			const double InsphereBoundB = (5 + 72 * Epsilon) * Epsilon;
+			
+			template <typename Scalar>
+			void check() {
+				static_assert(std::numeric_limits<Scalar>::digits <= 53,
+											"coordinates must convert to double exactly");
+			}
+			
+			/*
+			 * An expansion of up to N terms on the stack. The operators size
+			 * their results for the worst case, so the exact evaluation of a
+			 * determinant needs no allocation.
+			 */
+			template <int N>
+			struct Terms {
+				double v[N];
+				int n;
+			};
+			
+			template <int N, int M>
+			Terms<N + M> operator+(const Terms<N> &e, const Terms<M> &f) {
+				Terms<N + M> h;
+				h.n = sum(e.n, e.v, f.n, f.v, h.v);
+				return h;
+			}
+			template <int N, int M>
+			Terms<N + M> operator-(const Terms<N> &e, Terms<M> f) {
+				for(int i = 0; i < f.n; ++i) {
+					f.v[i] = -f.v[i];
+				}
+				return e + f;
+			}
+			template <int N, int M>
+			Terms<2 * N * M> operator*(const Terms<N> &e, const Terms<M> &f) {
+				double a[2 * N * M], b[2 * N * M], t[2 * N];
+				double *h = a, *next = b;
+				int n = f.n == 0 ? 0 : scale(e.n, e.v, f.v[0], h);
+				for(int i = 1; i < f.n; ++i) {
+					const int tlen = scale(e.n, e.v, f.v[i], t);
+					n = sum(n, h, tlen, t, next);
+					std::swap(h, next);
+				}
+				Terms<2 * N * M> r;
+				std::copy(h, h + n, r.v);
+				r.n = n;
+				return r;
+			}
+			template <int N>
+			double estimate(const Terms<N> &e) {
+				return exact::estimate(e.n, e.v);
+			}
+			
+			/* An expansion on the heap, for the largest determinants */
+			struct Heap {
+				Expansion e;
+			};
+			
+			inline Heap operator+(const Heap &e, const Heap &f) {
+				const Heap h = { add(e.e, f.e) };
+				return h;
+			}
+			inline Heap operator-(const Heap &e, const Heap &f) {
+				const Heap h = { sub(e.e, f.e) };
+				return h;
+			}
+			inline Heap operator*(const Heap &e, const Heap &f) {
+				const Heap h = { mul(e.e, f.e) };
+				return h;
+			}
+			inline double estimate(const Heap &e) {
+				return exact::estimate(int(e.e.size()), e.e.data());
+			}
+			
+			/*
+			 * A double with the sum of the magnitudes of the rounding errors
+			 * of the operations giving it, from the differences of the
+			 * coordinates on. A determinant evaluated on these is exact when
+			 * no operation rounded, as for small integer coordinates, which
+			 * settles the degenerate cases of such inputs at a fraction of
+			 * the cost of expansions; estimate gives NaN otherwise.
+			 */
+			struct Checked {
+				double v;
+				double error;
+			};
+			
+			inline Checked operator+(const Checked &a, const Checked &b) {
+				Checked h;
+				double y;
+				twoSum(a.v, b.v, h.v, y);
+				h.error = a.error + b.error + std::fabs(y);
+				return h;
+			}
+			inline Checked operator-(const Checked &a, const Checked &b) {
+				const Checked c = { -b.v, b.error };
+				return a + c;
+			}
+			inline Checked operator*(const Checked &a, const Checked &b) {
+				Checked h;
+				double y;
+				twoProduct(a.v, b.v, h.v, y);
+				h.error = a.error + b.error + std::fabs(y);
+				return h;
+			}
+			inline double estimate(const Checked &e) {
+				return e.error == 0 ? e.v : std::numeric_limits<double>::quiet_NaN();
+			}
+			
+			/*
+			 * The differences p - q of n coordinates as expansions of one
+			 * term, rounded, returning whether they are all exact as they are
+			 * for nearby points, or of two terms.
+			 */
+			inline bool differences(const double *p, const double *q, int n,
+															Terms<1> *d)
+			{
+				bool exact = true;
+				for(int i = 0; i < n; ++i) {
+					double y;
+					twoSum(p[i], -q[i], d[i].v[0], y);
+					d[i].n = d[i].v[0] != 0;
+					exact = exact && y == 0;
+				}
+				return exact;
+			}
+			inline void differences(const double *p, const double *q, int n,
+															Checked *d)
+			{
+				for(int i = 0; i < n; ++i) {
+					double y;
+					twoSum(p[i], -q[i], d[i].v, y);
+					d[i].error = std::fabs(y);
+				}
+			}
+			inline void differences(const double *p, const double *q, int n,
+															Terms<2> *d)
+			{
+				for(int i = 0; i < n; ++i) {
+					d[i].n = difference(p[i], q[i], d[i].v);
+				}
+			}
+			inline void differences(const double *p, const double *q, int n,
+															Heap *d)
+			{
+				for(int i = 0; i < n; ++i) {
+					d[i].e.resize(2);
+					d[i].e.resize(difference(p[i], q[i], d[i].e.data()));
+				}
+			}
+			
+			/*
+			 * The determinants on exact differences of the coordinates, in the
+			 * same form as the filtered ones below.
+			 */
+			template <typename T>
+			double orient2dExact(const T ac[2], const T bc[2]) {
+				return estimate(ac[0] * bc[1] - ac[1] * bc[0]);
+			}
+			template <typename T>
+			double orient3dExact(const T ad[3], const T bd[3], const T cd[3]) {
+				return estimate(ad[2] * (bd[0] * cd[1] - cd[0] * bd[1]) +
+												bd[2] * (cd[0] * ad[1] - ad[0] * cd[1]) +
+												cd[2] * (ad[0] * bd[1] - bd[0] * ad[1]));
+			}
+			template <typename T>
+			double incircleExact(const T ad[2], const T bd[2], const T cd[2]) {
+				const auto alift = ad[0] * ad[0] + ad[1] * ad[1];
+				const auto blift = bd[0] * bd[0] + bd[1] * bd[1];
+				const auto clift = cd[0] * cd[0] + cd[1] * cd[1];
+				return estimate(alift * (bd[0] * cd[1] - cd[0] * bd[1]) +
+												blift * (cd[0] * ad[1] - ad[0] * cd[1]) +
+												clift * (ad[0] * bd[1] - bd[0] * ad[1]));
+			}
+			template <typename T>
+			double insphereExact(const T ae[3], const T be[3], const T ce[3],
+													 const T de[3])
+			{
+				const auto ab = ae[0] * be[1] - be[0] * ae[1];
+				const auto bc = be[0] * ce[1] - ce[0] * be[1];
+				const auto cd = ce[0] * de[1] - de[0] * ce[1];
+				const auto da = de[0] * ae[1] - ae[0] * de[1];
+				const auto ac = ae[0] * ce[1] - ce[0] * ae[1];
+				const auto bd = be[0] * de[1] - de[0] * be[1];
+				const auto abc = ae[2] * bc - be[2] * ac + ce[2] * ab;
+				const auto bcd = be[2] * cd - ce[2] * bd + de[2] * bc;
+				const auto cda = ce[2] * da + de[2] * ac + ae[2] * cd;
+				const auto dab = de[2] * ab + ae[2] * bd + be[2] * da;
+				const auto alift = ae[0] * ae[0] + ae[1] * ae[1] + ae[2] * ae[2];
+				const auto blift = be[0] * be[0] + be[1] * be[1] + be[2] * be[2];
+				const auto clift = ce[0] * ce[0] + ce[1] * ce[1] + ce[2] * ce[2];
+				const auto dlift = de[0] * de[0] + de[1] * de[1] + de[2] * de[2];
+				return estimate((dlift * abc - clift * dab) +
+												(blift * cda - alift * bcd));
+			}
+			
+			/*
+			 * The adaptive evaluations behind the filters, given the
+			 * permanent of the determinant. The determinant is first evaluated
+			 * in double precision checking for rounding, which is exact for
+			 * many degenerate inputs, then exactly on the rounded differences,
+			 * which is the exact result when the differences are exact and
+			 * otherwise decides the sign unless it is below a tighter bound.
+			 * Only then are the two term
+			 * differences used, which make the expansions of insphere too
+			 * large for the stack, so it falls back to the heap instead.
+			 */
+			inline double orient2dExact(const double a[2], const double b[2],
+																	const double c[2], double permanent)
+			{
+				Checked ac0[2], bc0[2];
+				differences(a, c, 2, ac0);
+				differences(b, c, 2, bc0);
+				const double checked = orient2dExact(ac0, bc0);
+				if(!std::isnan(checked)) {
+					return checked;
+				}
+				Terms<1> ac[2], bc[2];
+				const bool exact = differences(a, c, 2, ac) &
+					differences(b, c, 2, bc);
+				const double det = orient2dExact(ac, bc);
+				if(exact || std::fabs(det) > Orient2dBoundB * permanent) {
+					return det;
+				}
+				Terms<2> ac2[2], bc2[2];
+				differences(a, c, 2, ac2);
+				differences(b, c, 2, bc2);
+				return orient2dExact(ac2, bc2);
+			}
+			inline double orient3dExact(const double a[3], const double b[3],
+																	const double c[3], const double d[3],
+																	double permanent)
+			{
+				Checked ad0[3], bd0[3], cd0[3];
+				differences(a, d, 3, ad0);
+				differences(b, d, 3, bd0);
+				differences(c, d, 3, cd0);
+				const double checked = orient3dExact(ad0, bd0, cd0);
+				if(!std::isnan(checked)) {
+					return checked;
+				}
+				Terms<1> ad[3], bd[3], cd[3];
+				const bool exact = differences(a, d, 3, ad) &
+					differences(b, d, 3, bd) & differences(c, d, 3, cd);
+				const double det = orient3dExact(ad, bd, cd);
+				if(exact || std::fabs(det) > Orient3dBoundB * permanent) {
+					return det;
+				}
+				Terms<2> ad2[3], bd2[3], cd2[3];
+				differences(a, d, 3, ad2);
+				differences(b, d, 3, bd2);
+				differences(c, d, 3, cd2);
+				return orient3dExact(ad2, bd2, cd2);
+			}
+			inline double incircleExact(const double a[2], const double b[2],
+																	const double c[2], const double d[2],
+																	double permanent)
+			{
+				Checked ad0[2], bd0[2], cd0[2];
+				differences(a, d, 2, ad0);
+				differences(b, d, 2, bd0);
+				differences(c, d, 2, cd0);
+				const double checked = incircleExact(ad0, bd0, cd0);
+				if(!std::isnan(checked)) {
+					return checked;
+				}
+				Terms<1> ad[2], bd[2], cd[2];
+				const bool exact = differences(a, d, 2, ad) &
+					differences(b, d, 2, bd) & differences(c, d, 2, cd);
+				const double det = incircleExact(ad, bd, cd);
+				if(exact || std::fabs(det) > IncircleBoundB * permanent) {
+					return det;
+				}
+				Terms<2> ad2[2], bd2[2], cd2[2];
+				differences(a, d, 2, ad2);
+				differences(b, d, 2, bd2);
+				differences(c, d, 2, cd2);
+				return incircleExact(ad2, bd2, cd2);
+			}
+			inline double insphereExact(const double a[3], const double b[3],
+																	const double c[3], const double d[3],
+																	const double e[3], double permanent)
+			{
+				Checked ae0[3], be0[3], ce0[3], de0[3];
+				differences(a, e, 3, ae0);
+				differences(b, e, 3, be0);
+				differences(c, e, 3, ce0);
+				differences(d, e, 3, de0);
+				const double checked = insphereExact(ae0, be0, ce0, de0);
+				if(!std::isnan(checked)) {
+					return checked;
+				}
+				Terms<1> ae[3], be[3], ce[3], de[3];
+				const bool exact = differences(a, e, 3, ae) &
+					differences(b, e, 3, be) & differences(c, e, 3, ce) &
+					differences(d, e, 3, de);
+				const double det = insphereExact(ae, be, ce, de);
+				if(exact || std::fabs(det) > InsphereBoundB * permanent) {
+					return det;
+				}
+				Heap ae2[3], be2[3], ce2[3], de2[3];
+				differences(a, e, 3, ae2);
+				differences(b, e, 3, be2);
+				differences(c, e, 3, ce2);
+				differences(d, e, 3, de2);
+				return insphereExact(ae2, be2, ce2, de2);
+			}
+		}
+	}
+	
+	/**
+	 * \brief The orientation of three points in the plane.
+	 *
+	 * This and the other predicates follow J. R. Shewchuk, "Adaptive
+	 * Precision Floating-Point Arithmetic and Fast Robust Geometric
+	 * Predicates" (1997). The determinant is evaluated in double precision
+	 * and returned when it is larger than a bound on its rounding error, at
+	 * the cost of a few more operations than the naive determinant; only
+	 * for nearly degenerate inputs is it evaluated exactly with expansion
+	 * arithmetic. The sign of the result is always exact, barring overflow
+	 * and underflow. Coordinates must be exactly representable as doubles,
+	 * which holds for float, double and 32 bit integers; orient2d also has
+	 * an overload for 64 bit integers.
+	 *
+	 * \return A positive value if a, b and c are in counterclockwise order,
+	 * a negative value if they are in clockwise order and zero if they are
+	 * collinear; its magnitude approximates twice the area of the triangle
+	 */
+	template <typename Scalar>
+	typename std::enable_if<std::numeric_limits<Scalar>::digits <= 53,
+													double>::type
+	orient2d(const Point2<Scalar> &a, const Point2<Scalar> &b,
+					 const Point2<Scalar> &c)
+	{
+		using namespace detail::predicates;
+		check<Scalar>();
+		const double ax = a.x, ay = a.y, bx = b.x, by = b.y, cx = c.x, cy = c.y;
+		const double left = (ax - cx) * (by - cy);
+		const double right = (ay - cy) * (bx - cx);
+		const double det = left - right;
+		const double permanent = std::fabs(left) + std::fabs(right);
+		if(std::fabs(det) > Orient2dBound * permanent) {
+			return det;
+		}
+		const double pa[2] = { ax, ay }, pb[2] = { bx, by }, pc[2] = { cx, cy };
+		return orient2dExact(pa, pb, pc, permanent);
+	}
+	/**
+	 * \brief The orientation of three points in the plane with 64 bit integer
+	 * coordinates, which do not all convert to double exactly.
+	 *
+	 * The determinant is evaluated on approximations with a running error
+	 * bound, as in SegmentIntersection.hpp, and with expansions of the split
+	 * coordinates when that does not decide its sign.
+	 *
+	 * \see orient2d
+	 */
+	template <typename Scalar>
+	typename std::enable_if<(std::numeric_limits<Scalar>::digits > 53),
+													double>::type
+	orient2d(const Point2<Scalar> &a, const Point2<Scalar> &b,
+					 const Point2<Scalar> &c)
+	{
+		using namespace detail::exact;
+		const Approx cx = approx(c.x), cy = approx(c.y);
+		const Approx det = (approx(a.x) - cx) * (approx(b.y) - cy) -
+			(approx(a.y) - cy) * (approx(b.x) - cx);
+		if(sign(det) != Uncertain) {
+			return det.v;
+		}
+		const Expansion ex = expansion(c.x), ey = expansion(c.y);
+		const Expansion e = sub(mul(sub(expansion(a.x), ex),
+																sub(expansion(b.y), ey)),
+														mul(sub(expansion(a.y), ey),
+																sub(expansion(b.x), ex)));
+		return estimate(int(e.size()), e.data());
+	}
+	
+	/**
+	 * \brief The orientation of four points in space.
+	 *
+	 * \return A positive value if d lies below the plane through a, b and c,
+	 * where below is the side from which a, b and c appear clockwise, a
+	 * negative value if it lies above and zero if the points are coplanar;
+	 * its magnitude approximates six times the volume of the tetrahedron
+	 * \see orient2d
+	 */
+	template <typename Scalar>
+	double orient3d(const Point3<Scalar> &a, const Point3<Scalar> &b,
+									const Point3<Scalar> &c, const Point3<Scalar> &d)
+	{
+		using namespace detail::predicates;
+		check<Scalar>();
+		const double adx = double(a.x) - d.x, ady = double(a.y) - d.y;
+		const double adz = double(a.z) - d.z;
+		const double bdx = double(b.x) - d.x, bdy = double(b.y) - d.y;
+		const double bdz = double(b.z) - d.z;
+		const double cdx = double(c.x) - d.x, cdy = double(c.y) - d.y;
+		const double cdz = double(c.z) - d.z;
+		const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+		const double cdxady = cdx * ady, adxcdy = adx * cdy;
+		const double adxbdy = adx * bdy, bdxady = bdx * ady;
+		const double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) +
+			cdz * (adxbdy - bdxady);
+		const double permanent =
+			(std::fabs(bdxcdy) + std::fabs(cdxbdy)) * std::fabs(adz) +
+			(std::fabs(cdxady) + std::fabs(adxcdy)) * std::fabs(bdz) +
+			(std::fabs(adxbdy) + std::fabs(bdxady)) * std::fabs(cdz);
+		if(std::fabs(det) > Orient3dBound * permanent) {
+			return det;
+		}
+		const double pa[3] = { double(a.x), double(a.y), double(a.z) };
+		const double pb[3] = { double(b.x), double(b.y), double(b.z) };
+		const double pc[3] = { double(c.x), double(c.y), double(c.z) };
+		const double pd[3] = { double(d.x), double(d.y), double(d.z) };
+		return orient3dExact(pa, pb, pc, pd, permanent);
+	}
+	
+	/**
+	 * \brief Whether a point lies inside the circle through three others.
+	 *
+	 * \return A positive value if d lies inside the circle through a, b and
+	 * c, which must be in counterclockwise order for the sign to be
+	 * meaningful, a negative value if it lies outside and zero if the four
+	 * points are cocircular
+	 * \see orient2d
+	 */
+	template <typename Scalar>
+	double incircle(const Point2<Scalar> &a, const Point2<Scalar> &b,
+									const Point2<Scalar> &c, const Point2<Scalar> &d)
+	{
+		using namespace detail::predicates;
+		check<Scalar>();
+		const double adx = double(a.x) - d.x, ady = double(a.y) - d.y;
+		const double bdx = double(b.x) - d.x, bdy = double(b.y) - d.y;
+		const double cdx = double(c.x) - d.x, cdy = double(c.y) - d.y;
+		const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+		const double cdxady = cdx * ady, adxcdy = adx * cdy;
+		const double adxbdy = adx * bdy, bdxady = bdx * ady;
+		const double alift = adx * adx + ady * ady;
+		const double blift = bdx * bdx + bdy * bdy;
+		const double clift = cdx * cdx + cdy * cdy;
+		const double det = alift * (bdxcdy - cdxbdy) +
+			blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+		const double permanent =
+			(std::fabs(bdxcdy) + std::fabs(cdxbdy)) * alift +
+			(std::fabs(cdxady) + std::fabs(adxcdy)) * blift +
+			(std::fabs(adxbdy) + std::fabs(bdxady)) * clift;
+		if(std::fabs(det) > IncircleBound * permanent) {
+			return det;
+		}
+		const double pa[2] = { double(a.x), double(a.y) };
+		const double pb[2] = { double(b.x), double(b.y) };
+		const double pc[2] = { double(c.x), double(c.y) };
+		const double pd[2] = { double(d.x), double(d.y) };
+		return incircleExact(pa, pb, pc, pd, permanent);
+	}
+	
+	/**
+	 * \brief Whether a point lies inside the sphere through four others.
+	 *
+	 * \return A positive value if e lies inside the sphere through a, b, c
+	 * and d, which must have a positive orient3d for the sign to be
+	 * meaningful, a negative value if it lies outside and zero if the five
+	 * points are cospherical
+	 * \see orient2d
+	 */
+	template <typename Scalar>
+	double insphere(const Point3<Scalar> &a, const Point3<Scalar> &b,
+									const Point3<Scalar> &c, const Point3<Scalar> &d,
+									const Point3<Scalar> &e)
+	{
+		using namespace detail::predicates;
+		check<Scalar>();
+		const double aex = double(a.x) - e.x, aey = double(a.y) - e.y;
+		const double aez = double(a.z) - e.z;
+		const double bex = double(b.x) - e.x, bey = double(b.y) - e.y;
+		const double bez = double(b.z) - e.z;
+		const double cex = double(c.x) - e.x, cey = double(c.y) - e.y;
+		const double cez = double(c.z) - e.z;
+		const double dex = double(d.x) - e.x, dey = double(d.y) - e.y;
+		const double dez = double(d.z) - e.z;
+		const double aexbey = aex * bey, bexaey = bex * aey;
+		const double bexcey = bex * cey, cexbey = cex * bey;
+		const double cexdey = cex * dey, dexcey = dex * cey;
+		const double dexaey = dex * aey, aexdey = aex * dey;
+		const double aexcey = aex * cey, cexaey = cex * aey;
+		const double bexdey = bex * dey, dexbey = dex * bey;
+		const double ab = aexbey - bexaey, bc = bexcey - cexbey;
+		const double cd = cexdey - dexcey, da = dexaey - aexdey;
+		const double ac = aexcey - cexaey, bd = bexdey - dexbey;
+		const double abc = aez * bc - bez * ac + cez * ab;
+		const double bcd = bez * cd - cez * bd + dez * bc;
+		const double cda = cez * da + dez * ac + aez * cd;
+		const double dab = dez * ab + aez * bd + bez * da;
+		const double alift = aex * aex + aey * aey + aez * aez;
+		const double blift = bex * bex + bey * bey + bez * bez;
+		const double clift = cex * cex + cey * cey + cez * cez;
+		const double dlift = dex * dex + dey * dey + dez * dez;
+		const double det = (dlift * abc - clift * dab) +
+			(blift * cda - alift * bcd);
+		
+		const double aezp = std::fabs(aez), bezp = std::fabs(bez);
+		const double cezp = std::fabs(cez), dezp = std::fabs(dez);
+		const double abp = std::fabs(aexbey) + std::fabs(bexaey);
+		const double bcp = std::fabs(bexcey) + std::fabs(cexbey);
+		const double cdp = std::fabs(cexdey) + std::fabs(dexcey);
+		const double dap = std::fabs(dexaey) + std::fabs(aexdey);
+		const double acp = std::fabs(aexcey) + std::fabs(cexaey);
+		const double bdp = std::fabs(bexdey) + std::fabs(dexbey);
+		const double permanent =
+			(cdp * bezp + bdp * cezp + bcp * dezp) * alift +
+			(dap * cezp + acp * dezp + cdp * aezp) * blift +
+			(abp * dezp + bdp * aezp + dap * bezp) * clift +
+			(bcp * aezp + acp * bezp + abp * cezp) * dlift;
+		if(std::fabs(det) > InsphereBound * permanent) {
+			return det;
+		}
+		const double pa[3] = { double(a.x), double(a.y), double(a.z) };
+		const double pb[3] = { double(b.x), double(b.y), double(b.z) };
+		const double pc[3] = { double(c.x), double(c.y), double(c.z) };
+		const double pd[3] = { double(d.x), double(d.y), double(d.z) };
+		const double pe[3] = { double(e.x), double(e.y), double(e.z) };
+		return insphereExact(pa, pb, pc, pd, pe, permanent);
+	}
+}
+
+#endif
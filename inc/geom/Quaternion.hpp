@@ -0,0 +1,922 @@
+/**
+ * \file Quaternion.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Quaternions representing rotations in 3 dimensions
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_QUATERNION_HPP
+#define GEOM_QUATERNION_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "Matrix3.hpp"
+#include "Matrix4.hpp"
+#include "Simd.hpp"
+#include "Vector3.hpp"
+#include "VectorTraits.hpp"
+
+namespace geom {
+	/**
+	 * \brief A quaternion x*i + y*j + z*k + w.
+	 * 
+	 * Quaternions of unit length represent rotations in 3 dimensions with 4
+	 * values instead of the 9 of a \c Matrix3, and compose and interpolate
+	 * more cheaply. The rotations follow the conventions of
+	 * \c Matrix4::rotate, so \c q.toMatrix4() * v == q * v up to rounding.
+	 * 
+	 * As with \c Vector4 the components are stored in x, y, z, w order and
+	 * quaternions of 4 byte components are 16 byte aligned.
+	 */
+	template <typename Scalar>
+	struct alignas(sizeof(Scalar) * 4 == 16 ? 16 : alignof(Scalar)) Quaternion {
+		typedef Scalar type;
+		
+		/**
+		 * \brief Construct a \c Quaternion object with all components 0
+		 * 
+		 * This is not a rotation, see \c identity.
+		 */
+		Quaternion() :
+			x(0), y(0), z(0), w(0)
+		{ }
+		/**
+		 * \brief Construct a \c Quaternion object with the given components
+		 * \arg \c x The coefficient of i
+		 * \arg \c y The coefficient of j
+		 * \arg \c z The coefficient of k
+		 * \arg \c w The real part
+		 */
+		Quaternion(Scalar x, Scalar y, Scalar z, Scalar w) :
+			x(x), y(y), z(z), w(w)
+		{ }
+		/**
+		 * \brief Construct a \c Quaternion object from its vector and real
+		 * parts
+		 * \arg \c v The coefficients of i, j and k
+		 * \arg \c w The real part
+		 */
+		Quaternion(const Vector3<Scalar> &v, Scalar w) :
+			x(v.x), y(v.y), z(v.z), w(w)
+		{ }
+		/**
+		 * \brief Construct a \c Quaternion object which is a conversion of the
+		 * given \c Quaternion object.
+		 * \arg \c source The \c Quaternion to convert
+		 */
+		template <typename Other>
+		Quaternion(const Quaternion<Other> &source) :
+			x(source.x), y(source.y), z(source.z), w(source.w)
+		{ }
+		/**
+		 * \brief Construct the unit \c Quaternion of the rotation held by the
+		 * given matrix.
+		 * 
+		 * The matrix must be a rotation, that is orthonormal with a determinant
+		 * of 1. Of the two quaternions representing it, the one with a non
+		 * negative real part is returned.
+		 * 
+		 * \arg \c m The rotation matrix
+		 */
+		explicit Quaternion(const Matrix3<Scalar> &m) {
+			fromRotation(m.values, 3);
+		}
+		/**
+		 * \brief Construct the unit \c Quaternion of the rotation held by the
+		 * upper left 3x3 block of the given matrix, see the \c Matrix3
+		 * constructor.
+		 * \arg \c m The matrix holding a rotation
+		 */
+		explicit Quaternion(const Matrix4<Scalar> &m) {
+			fromRotation(m.values, 4);
+		}
+		
+		/**
+		 * \brief Get the vector part of the quaternion.
+		 */
+		Vector3<Scalar> vector() const {
+			return Vector3<Scalar>(x, y, z);
+		}
+		
+		/**
+		 * \brief Convert a unit quaternion to the matching rotation matrix.
+		 */
+		Matrix3<Scalar> toMatrix3() const {
+			const Scalar xx = x * x, yy = y * y, zz = z * z;
+			const Scalar xy = x * y, xz = x * z, yz = y * z;
+			const Scalar wx = w * x, wy = w * y, wz = w * z;
+			return Matrix3<Scalar>(1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy),
+														 2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx),
+														 2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy));
+		}
+		/**
+		 * \brief Convert a unit quaternion to the matching rotation matrix.
+		 */
+		Matrix4<Scalar> toMatrix4() const {
+			const Matrix3<Scalar> r(toMatrix3());
+			const Scalar *m = r.values;
+			return Matrix4<Scalar>(m[0], m[3], m[6], 0,
+														 m[1], m[4], m[7], 0,
+														 m[2], m[5], m[8], 0,
+														 0, 0, 0, 1);
+		}
+		
+		/**
+		 * \brief Construct the identity rotation.
+		 */
+		static Quaternion<Scalar> identity() {
+			return Quaternion<Scalar>(0, 0, 0, 1);
+		}
+		/**
+		 * \brief Construct the rotation about the given axis, see
+		 * \c Matrix4::rotate.
+		 * \arg \c angle The angle of rotation in radians
+		 * \arg \c axis The axis to rotate about, which must not be the zero
+		 * vector
+		 */
+		static Quaternion<Scalar> rotate(Scalar angle,
+																		 const Vector3<Scalar> &axis)
+		{
+			const Vector3<Scalar> a(normalize(axis));
+			const Scalar s = std::sin(angle / 2);
+			return Quaternion<Scalar>(a.x * s, a.y * s, a.z * s,
+																std::cos(angle / 2));
+		}
+		
+		Scalar x; /**< The coefficient of i */
+		Scalar y; /**< The coefficient of j */
+		Scalar z; /**< The coefficient of k */
+		Scalar w; /**< The real part */
+		
+	private:
+		/*
+		 * Shepperd's method: the largest of w, x, y and z is found from the
+		 * diagonal and computed with a square root, which keeps the division by
+		 * it well conditioned. The column stride distinguishes 3x3 and 4x4
+		 * matrices.
+		 */
+		void fromRotation(const Scalar *v, std::size_t stride) {
+			const Scalar m00 = v[0], m10 = v[1], m20 = v[2];
+			const Scalar m01 = v[stride], m11 = v[stride + 1];
+			const Scalar m21 = v[stride + 2];
+			const Scalar m02 = v[2 * stride], m12 = v[2 * stride + 1];
+			const Scalar m22 = v[2 * stride + 2];
+			const Scalar trace = m00 + m11 + m22;
+			if(trace > 0) {
+				const Scalar s = std::sqrt(trace + 1) * 2;
+				w = s / 4;
+				x = (m21 - m12) / s;
+				y = (m02 - m20) / s;
+				z = (m10 - m01) / s;
+			} else if(m00 > m11 && m00 > m22) {
+				const Scalar s = std::sqrt(1 + m00 - m11 - m22) * 2;
+				w = (m21 - m12) / s;
+				x = s / 4;
+				y = (m01 + m10) / s;
+				z = (m02 + m20) / s;
+			} else if(m11 > m22) {
+				const Scalar s = std::sqrt(1 + m11 - m00 - m22) * 2;
+				w = (m02 - m20) / s;
+				x = (m01 + m10) / s;
+				y = s / 4;
+				z = (m12 + m21) / s;
+			} else {
+				const Scalar s = std::sqrt(1 + m22 - m00 - m11) * 2;
+				w = (m10 - m01) / s;
+				x = (m02 + m20) / s;
+				y = (m12 + m21) / s;
+				z = s / 4;
+			}
+			if(w < 0) {
+				x = -x;
+				y = -y;
+				z = -z;
+				w = -w;
+			}
+		}
+	};
+	
+	typedef Quaternion<float> Quaternionf;
+	typedef Quaternion<double> Quaterniond;
+	
+	/**
+	 * \brief Test quaternions component-wise for equality.
+	 * \arg \c lhs The quaternion on the left of the equality operator.
+	 * \arg \c rhs The quaternion on the right of the equality operator.
+	 * \return True if all components are equal, false otherwise.
+	 */
+	template <typename LType, typename RType>
+	bool operator==(const Quaternion<LType> &lhs, const Quaternion<RType> &rhs)
+	{
+		return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z &&
+			lhs.w == rhs.w;
+	}
+	
+	/**
+	 * \brief Test if two quaternions are not equal.
+	 * \arg \c lhs The quaternion on the left of the inequality operator.
+	 * \arg \c rhs The quaternion on the right of the inequality operator.
+	 * \return True if any component is different, False otherwise.
+	 */
+	template <typename LType, typename RType>
+	bool operator!=(const Quaternion<LType> &lhs, const Quaternion<RType> &rhs)
+	{
+		return !(lhs == rhs);
+	}
+	
+	/**
+	 * \brief Add two \c Quaternion objects component-wise.
+	 * \arg \c lhs The operand on the left hand side of the expression
+	 * \arg \c rhs The operand on the right hand side of the expression
+	 * \return A new \c Quaternion object holding the sum
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Quaternion<Result> operator+(const Quaternion<LType> &lhs,
+															 const Quaternion<RType> &rhs)
+	{
+		return Quaternion<Result>(lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z,
+															lhs.w + rhs.w);
+	}
+	
+	/**
+	 * \brief Subtract two \c Quaternion objects component-wise.
+	 * \arg \c lhs The operand on the left hand side of the expression
+	 * \arg \c rhs The operand on the right hand side of the expression
+	 * \return A new \c Quaternion object holding the difference
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Quaternion<Result> operator-(const Quaternion<LType> &lhs,
+															 const Quaternion<RType> &rhs)
+	{
+		return Quaternion<Result>(lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z,
+															lhs.w - rhs.w);
+	}
+	
+	/**
+	 * \brief Negate every component of a \c Quaternion object, which
+	 * represents the same rotation.
+	 * \arg \c q The quaternion to negate
+	 * \return A new \c Quaternion object holding the negation
+	 */
+	template <typename Scalar>
+	Quaternion<Scalar> operator-(const Quaternion<Scalar> &q) {
+		return Quaternion<Scalar>(-q.x, -q.y, -q.z, -q.w);
+	}
+	
+	/**
+	 * \brief Scale every component of a \c Quaternion object.
+	 * \arg \c lhs The quaternion to scale
+	 * \arg \c rhs The scale factor
+	 * \return A new \c Quaternion object holding the scaled quaternion
+	 */
+	template <typename RType, typename LType,
+						typename = typename std::enable_if<
+							std::is_arithmetic<RType>::value>::type,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Quaternion<Result> operator*(const Quaternion<LType> &lhs, const RType &rhs)
+	{
+		return Quaternion<Result>(lhs.x * rhs, lhs.y * rhs, lhs.z * rhs,
+															lhs.w * rhs);
+	}
+	template <typename RType, typename LType,
+						typename = typename std::enable_if<
+							std::is_arithmetic<LType>::value>::type,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Quaternion<Result> operator*(const LType &lhs, const Quaternion<RType> &rhs)
+	{
+		return rhs * lhs;
+	}
+	
+	/**
+	 * \brief Multiply two \c Quaternion objects.
+	 * 
+	 * For unit quaternions the product is the composition of the rotations,
+	 * with the one on the right applied first as with matrices.
+	 * 
+	 * \arg \c lhs The quaternion on the left side of the product
+	 * \arg \c rhs The quaternion on the right side of the product
+	 * \return A new \c Quaternion object holding the Hamilton product
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Quaternion<Result> operator*(const Quaternion<LType> &lhs,
+															 const Quaternion<RType> &rhs)
+	{
+		return Quaternion<Result>(
+			lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+			lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
+			lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w,
+			lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z);
+	}
+	
+	/**
+	 * \brief Rotate a \c Vector3 object by a unit \c Quaternion object.
+	 * 
+	 * This computes q * v * conjugate(q) in the form
+	 * v + w*t + u x t with t = 2 * u x v, where u is the vector part of q.
+	 * 
+	 * \arg \c lhs The rotation
+	 * \arg \c rhs The vector to rotate
+	 * \return A new \c Vector3 object holding the rotated vector
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Vector3<Result> operator*(const Quaternion<LType> &lhs,
+														const Vector3<RType> &rhs)
+	{
+		const Vector3<Result> u(lhs.x, lhs.y, lhs.z);
+		const Vector3<Result> v(rhs);
+		const Vector3<Result> t(cross(u, v) * Result(2));
+		return v + t * Result(lhs.w) + cross(u, t);
+	}
+	
+	/**
+	 * \brief Calculate the dot product of two \c Quaternion objects.
+	 * \arg \c lhs The operand on the left hand side
+	 * \arg \c rhs The operand on the right hand side
+	 * \return The sum of the products of the components
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Result dot(const Quaternion<LType> &lhs, const Quaternion<RType> &rhs) {
+		return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z + lhs.w * rhs.w;
+	}
+	
+	/**
+	 * \brief Calculate the length, or norm, of a \c Quaternion object.
+	 * \arg \c q The quaternion
+	 * \return The length of \c q
+	 */
+	template <typename Scalar>
+	Scalar length(const Quaternion<Scalar> &q) {
+		return std::sqrt(dot(q, q));
+	}
+	
+	/**
+	 * \brief Scale a \c Quaternion object to unit length.
+	 * \arg \c q The quaternion to normalize, which must not be zero
+	 * \return A new \c Quaternion object of unit length
+	 */
+	template <typename Scalar>
+	Quaternion<Scalar> normalize(const Quaternion<Scalar> &q) {
+		const Scalar s = Scalar(1) / length(q);
+		return Quaternion<Scalar>(q.x * s, q.y * s, q.z * s, q.w * s);
+	}
+	
+	/**
+	 * \brief Conjugate a \c Quaternion object, which for unit quaternions is
+	 * the inverse rotation.
+	 * \arg \c q The quaternion to conjugate
+	 * \return A new \c Quaternion object with the vector part negated
+	 */
+	template <typename Scalar>
+	Quaternion<Scalar> conjugate(const Quaternion<Scalar> &q) {
+		return Quaternion<Scalar>(-q.x, -q.y, -q.z, q.w);
+	}
+	
+	/**
+	 * \brief Invert a \c Quaternion object of any non zero length.
+	 * \arg \c q The quaternion to invert
+	 * \return A new \c Quaternion object such that q * inverse(q) is the
+	 * identity
+	 */
+	template <typename Scalar>
+	Quaternion<Scalar> inverse(const Quaternion<Scalar> &q) {
+		const Scalar s = Scalar(1) / dot(q, q);
+		return Quaternion<Scalar>(-q.x * s, -q.y * s, -q.z * s, q.w * s);
+	}
+	
+	/**
+	 * \brief Interpolate linearly between two unit quaternions and normalize
+	 * the result.
+	 * 
+	 * The interpolation follows the shorter arc, negating \c b when it is
+	 * more than 90 degrees from \c a. It is cheaper than \c slerp but does not
+	 * move at a constant angular speed.
+	 * 
+	 * \arg \c a The rotation at t = 0
+	 * \arg \c b The rotation at t = 1
+	 * \arg \c t The interpolation parameter in [0, 1]
+	 * \return A new unit \c Quaternion object between \c a and \c b
+	 */
+	template <typename Scalar>
+	Quaternion<Scalar> nlerp(const Quaternion<Scalar> &a,
+													 const Quaternion<Scalar> &b, Scalar t)
+	{
+		const Scalar tb = dot(a, b) < 0 ? -t : t;
+		const Scalar ta = 1 - t;
+		return normalize(Quaternion<Scalar>(a.x * ta + b.x * tb,
+																				a.y * ta + b.y * tb,
+																				a.z * ta + b.z * tb,
+																				a.w * ta + b.w * tb));
+	}
+	
+	/**
+	 * \brief Interpolate between two unit quaternions at a constant angular
+	 * speed.
+	 * 
+	 * The interpolation follows the shorter arc. Nearly equal rotations, where
+	 * the division by the sine of the angle between them loses precision, are
+	 * interpolated with \c nlerp instead.
+	 * 
+	 * \arg \c a The rotation at t = 0
+	 * \arg \c b The rotation at t = 1
+	 * \arg \c t The interpolation parameter in [0, 1]
+	 * \return A new unit \c Quaternion object between \c a and \c b
+	 */
+	template <typename Scalar>
+	Quaternion<Scalar> slerp(const Quaternion<Scalar> &a,
+													 const Quaternion<Scalar> &b, Scalar t)
+	{
+		Scalar d = dot(a, b);
+		const Scalar sign = d < 0 ? -1 : 1;
+		d *= sign;
+		if(d > Scalar(0.9995)) {
+			return nlerp(a, b, t);
+		}
+		const Scalar theta = std::acos(d);
+		const Scalar s = 1 / std::sin(theta);
+		const Scalar ta = std::sin((1 - t) * theta) * s;
+		const Scalar tb = std::sin(t * theta) * s * sign;
+		return Quaternion<Scalar>(a.x * ta + b.x * tb, a.y * ta + b.y * tb,
+															a.z * ta + b.z * tb, a.w * ta + b.w * tb);
+	}
+	
+	namespace detail {
+		/*
+		 * The coefficients of the series of sin(t*a)/sin(a) in powers of
+		 * cos(a) - 1 from D. Eberly, "A Fast and Accurate Algorithm for
+		 * Computing SLERP", truncated after 8 terms. The last pair is scaled to
+		 * absorb the truncated terms; the factor was fitted to minimize the
+		 * largest error over 0 <= cos(a) <= 1 and 0 <= t <= 1, which is
+		 * 1.9e-5.
+		 */
+		template <typename Scalar>
+		struct SlerpSeries {
+			static const int Terms = 8;
+			
+			static constexpr Scalar one() {
+				return 1;
+			}
+			static Scalar u(int i) {
+				return us[i];
+			}
+			static Scalar v(int i) {
+				return vs[i];
+			}
+			
+			static constexpr Scalar us[Terms] = {
+				Scalar(1) / (1 * 3), Scalar(1) / (2 * 5), Scalar(1) / (3 * 7),
+				Scalar(1) / (4 * 9), Scalar(1) / (5 * 11), Scalar(1) / (6 * 13),
+				Scalar(1) / (7 * 15), Scalar(1.853) / (8 * 17)
+			};
+			static constexpr Scalar vs[Terms] = {
+				Scalar(1) / 3, Scalar(2) / 5, Scalar(3) / 7, Scalar(4) / 9,
+				Scalar(5) / 11, Scalar(6) / 13, Scalar(7) / 15,
+				Scalar(1.853) * 8 / 17
+			};
+		};
+		template <typename Scalar>
+		constexpr Scalar SlerpSeries<Scalar>::us[];
+		template <typename Scalar>
+		constexpr Scalar SlerpSeries<Scalar>::vs[];
+		
+		/*
+		 * The same coefficients broadcast into SIMD packs once per batch.
+		 */
+		template <typename Pack, typename Scalar>
+		struct PackedSlerpSeries {
+			static const int Terms = SlerpSeries<Scalar>::Terms;
+			
+			PackedSlerpSeries() {
+				for(int i = 0; i < Terms; ++i) {
+					us[i] = Pack::set1(SlerpSeries<Scalar>::u(i));
+					vs[i] = Pack::set1(SlerpSeries<Scalar>::v(i));
+				}
+			}
+			
+			Pack one() const {
+				return Pack::set1(1);
+			}
+			Pack u(int i) const {
+				return us[i];
+			}
+			Pack v(int i) const {
+				return vs[i];
+			}
+			
+			Pack us[Terms];
+			Pack vs[Terms];
+		};
+		
+		/*
+		 * The weights of both ends of slerpFast for c = cos(angle) >= 0, T
+		 * being either a scalar or a SIMD pack. The same sequence of operations
+		 * is used for both so that the batch kernels match the single
+		 * quaternion version.
+		 */
+		template <typename Series, typename T>
+		void slerpWeights(const Series &series, T c, T t, T &wa, T &wb) {
+			const T one = series.one();
+			const T cm1 = c - one;
+			const T d = one - t;
+			const T t2 = t * t, d2 = d * d;
+			T fa = one, fb = one;
+			for(int i = Series::Terms - 1; i >= 0; --i) {
+				fa = one + (series.u(i) * d2 - series.v(i)) * cm1 * fa;
+				fb = one + (series.u(i) * t2 - series.v(i)) * cm1 * fb;
+			}
+			wa = d * fa;
+			wb = t * fb;
+		}
+	}
+	
+	/**
+	 * \brief Interpolate between two unit quaternions at a nearly constant
+	 * angular speed without trigonometric functions.
+	 * 
+	 * A polynomial approximation of \c slerp which replaces the inverse
+	 * cosine and sines with a few multiplications. Each component is within
+	 * 4e-5 of \c slerp for every pair of unit quaternions and parameter,
+	 * well below what is visible when blending animation poses, but the
+	 * result is not exactly of unit length. This is the function computed by
+	 * the batch \c slerpFast kernels.
+	 * 
+	 * \arg \c a The rotation at t = 0
+	 * \arg \c b The rotation at t = 1
+	 * \arg \c t The interpolation parameter in [0, 1]
+	 * \return A new \c Quaternion object between \c a and \c b
+	 */
+	template <typename Scalar>
+	Quaternion<Scalar> slerpFast(const Quaternion<Scalar> &a,
+															 const Quaternion<Scalar> &b, Scalar t)
+	{
+		const Scalar d = dot(a, b);
+		Scalar ta, tb;
+		detail::slerpWeights(detail::SlerpSeries<Scalar>(), d < 0 ? -d : d, t,
+												 ta, tb);
+		tb = d < 0 ? -tb : tb;
+		return Quaternion<Scalar>(a.x * ta + b.x * tb, a.y * ta + b.y * tb,
+															a.z * ta + b.z * tb, a.w * ta + b.w * tb);
+	}
+	
+	namespace detail {
+		/*
+		 * Batch interpolation kernels.
+		 *
+		 * As in Vector3SoA.hpp these return the number of quaternions handled
+		 * and the caller finishes the rest with the single quaternion version.
+		 * Groups of quaternions are transposed into one register per component
+		 * on loading and back on storing. The parameters are read from t with
+		 * the given stride, 0 to use a single parameter for every pair.
+		 */
+		template <typename S>
+		std::size_t slerpFastBatch(const Quaternion<S> *, const Quaternion<S> *,
+															 const S *, std::size_t, std::size_t,
+															 Quaternion<S> *)
+		{
+			return 0;
+		}
+		template <typename S>
+		std::size_t nlerpBatch(const Quaternion<S> *, const Quaternion<S> *,
+													 const S *, std::size_t, std::size_t,
+													 Quaternion<S> *)
+		{
+			return 0;
+		}
+		
+#if defined(GEOM_SSE2)
+		/*
+		 * Load one quaternion, or any 4 consecutive scalars, from each pointer
+		 * in p into one register per component, and the reverse. The gathering
+		 * form serves lookups through index arrays as in DualQuaternion.hpp.
+		 */
+		inline void gatherQuaternions(const float *const *p, simd::Float4 &x,
+																	simd::Float4 &y, simd::Float4 &z,
+																	simd::Float4 &w)
+		{
+			__m128 a = _mm_loadu_ps(p[0]), b = _mm_loadu_ps(p[1]);
+			__m128 c = _mm_loadu_ps(p[2]), d = _mm_loadu_ps(p[3]);
+			_MM_TRANSPOSE4_PS(a, b, c, d);
+			x = a;
+			y = b;
+			z = c;
+			w = d;
+		}
+		inline void storeQuaternions(float *p, simd::Float4 x, simd::Float4 y,
+																 simd::Float4 z, simd::Float4 w)
+		{
+			_MM_TRANSPOSE4_PS(x.v, y.v, z.v, w.v);
+			_mm_storeu_ps(p, x.v);
+			_mm_storeu_ps(p + 4, y.v);
+			_mm_storeu_ps(p + 8, z.v);
+			_mm_storeu_ps(p + 12, w.v);
+		}
+		inline void gatherQuaternions(const double *const *p, simd::Double2 &x,
+																	simd::Double2 &y, simd::Double2 &z,
+																	simd::Double2 &w)
+		{
+			const __m128d a0 = _mm_loadu_pd(p[0]), a1 = _mm_loadu_pd(p[0] + 2);
+			const __m128d b0 = _mm_loadu_pd(p[1]), b1 = _mm_loadu_pd(p[1] + 2);
+			x = _mm_unpacklo_pd(a0, b0);
+			y = _mm_unpackhi_pd(a0, b0);
+			z = _mm_unpacklo_pd(a1, b1);
+			w = _mm_unpackhi_pd(a1, b1);
+		}
+		inline void storeQuaternions(double *p, simd::Double2 x, simd::Double2 y,
+																 simd::Double2 z, simd::Double2 w)
+		{
+			_mm_storeu_pd(p, _mm_unpacklo_pd(x.v, y.v));
+			_mm_storeu_pd(p + 2, _mm_unpacklo_pd(z.v, w.v));
+			_mm_storeu_pd(p + 4, _mm_unpackhi_pd(x.v, y.v));
+			_mm_storeu_pd(p + 6, _mm_unpackhi_pd(z.v, w.v));
+		}
+#  if defined(GEOM_AVX)
+		/*
+		 * Eight float quaternions are transposed as two groups of four, one in
+		 * each 128 bit lane.
+		 */
+		inline void gatherQuaternions(const float *const *p, simd::Float8 &x,
+																	simd::Float8 &y, simd::Float8 &z,
+																	simd::Float8 &w)
+		{
+			const __m256 a = _mm256_insertf128_ps(
+				_mm256_castps128_ps256(_mm_loadu_ps(p[0])), _mm_loadu_ps(p[4]), 1);
+			const __m256 b = _mm256_insertf128_ps(
+				_mm256_castps128_ps256(_mm_loadu_ps(p[1])), _mm_loadu_ps(p[5]), 1);
+			const __m256 c = _mm256_insertf128_ps(
+				_mm256_castps128_ps256(_mm_loadu_ps(p[2])), _mm_loadu_ps(p[6]), 1);
+			const __m256 d = _mm256_insertf128_ps(
+				_mm256_castps128_ps256(_mm_loadu_ps(p[3])), _mm_loadu_ps(p[7]), 1);
+			const __m256 ab0 = _mm256_unpacklo_ps(a, b);
+			const __m256 ab1 = _mm256_unpackhi_ps(a, b);
+			const __m256 cd0 = _mm256_unpacklo_ps(c, d);
+			const __m256 cd1 = _mm256_unpackhi_ps(c, d);
+			x = _mm256_shuffle_ps(ab0, cd0, 0x44);
+			y = _mm256_shuffle_ps(ab0, cd0, 0xEE);
+			z = _mm256_shuffle_ps(ab1, cd1, 0x44);
+			w = _mm256_shuffle_ps(ab1, cd1, 0xEE);
+		}
+		inline void storeQuaternions(float *p, simd::Float8 x, simd::Float8 y,
+																 simd::Float8 z, simd::Float8 w)
+		{
+			const __m256 xy0 = _mm256_unpacklo_ps(x.v, y.v);
+			const __m256 xy1 = _mm256_unpackhi_ps(x.v, y.v);
+			const __m256 zw0 = _mm256_unpacklo_ps(z.v, w.v);
+			const __m256 zw1 = _mm256_unpackhi_ps(z.v, w.v);
+			const __m256 a = _mm256_shuffle_ps(xy0, zw0, 0x44);
+			const __m256 b = _mm256_shuffle_ps(xy0, zw0, 0xEE);
+			const __m256 c = _mm256_shuffle_ps(xy1, zw1, 0x44);
+			const __m256 d = _mm256_shuffle_ps(xy1, zw1, 0xEE);
+			_mm256_storeu2_m128(p + 16, p, a);
+			_mm256_storeu2_m128(p + 20, p + 4, b);
+			_mm256_storeu2_m128(p + 24, p + 8, c);
+			_mm256_storeu2_m128(p + 28, p + 12, d);
+		}
+		inline void gatherQuaternions(const double *const *p, simd::Double4 &x,
+																	simd::Double4 &y, simd::Double4 &z,
+																	simd::Double4 &w)
+		{
+			/* a holds the x and y of quaternions 0 and 2, and so on */
+			const __m256d a = _mm256_insertf128_pd(
+				_mm256_castpd128_pd256(_mm_loadu_pd(p[0])), _mm_loadu_pd(p[2]), 1);
+			const __m256d b = _mm256_insertf128_pd(
+				_mm256_castpd128_pd256(_mm_loadu_pd(p[1])), _mm_loadu_pd(p[3]), 1);
+			const __m256d c = _mm256_insertf128_pd(
+				_mm256_castpd128_pd256(_mm_loadu_pd(p[0] + 2)),
+				_mm_loadu_pd(p[2] + 2), 1);
+			const __m256d d = _mm256_insertf128_pd(
+				_mm256_castpd128_pd256(_mm_loadu_pd(p[1] + 2)),
+				_mm_loadu_pd(p[3] + 2), 1);
+			/* Each register ends up holding quaternions 0, 1, 2, 3 in order */
+			x = _mm256_unpacklo_pd(a, b);
+			y = _mm256_unpackhi_pd(a, b);
+			z = _mm256_unpacklo_pd(c, d);
+			w = _mm256_unpackhi_pd(c, d);
+		}
+		inline void storeQuaternions(double *p, simd::Double4 x, simd::Double4 y,
+																 simd::Double4 z, simd::Double4 w)
+		{
+			const __m256d a = _mm256_unpacklo_pd(x.v, y.v);
+			const __m256d b = _mm256_unpackhi_pd(x.v, y.v);
+			const __m256d c = _mm256_unpacklo_pd(z.v, w.v);
+			const __m256d d = _mm256_unpackhi_pd(z.v, w.v);
+			_mm256_storeu2_m128d(p + 8, p, a);
+			_mm256_storeu2_m128d(p + 12, p + 4, b);
+			_mm256_storeu2_m128d(p + 10, p + 2, c);
+			_mm256_storeu2_m128d(p + 14, p + 6, d);
+		}
+#  endif
+#endif
+		template <typename S>
+		void gatherQuaternions(const S *const *p, simd::Single<S> &x,
+													 simd::Single<S> &y, simd::Single<S> &z,
+													 simd::Single<S> &w)
+		{
+			x = p[0][0];
+			y = p[0][1];
+			z = p[0][2];
+			w = p[0][3];
+		}
+		
+		template <typename Pack, typename S>
+		void loadQuaternions(const S *p, Pack &x, Pack &y, Pack &z, Pack &w) {
+			const S *q[Pack::width];
+			for(std::size_t k = 0; k < Pack::width; ++k) {
+				q[k] = p + 4 * k;
+			}
+			gatherQuaternions(q, x, y, z, w);
+		}
+		
+#if defined(GEOM_SSE2)
+		
+		template <typename Pack, typename S>
+		std::size_t packedSlerpFast(const Quaternion<S> *a, const Quaternion<S> *b,
+																const S *t, std::size_t stride, std::size_t n,
+																Quaternion<S> *out)
+		{
+			const Pack zero = Pack::zero();
+			const PackedSlerpSeries<Pack, S> series;
+			std::size_t i = 0;
+			for(; i + Pack::width <= n; i += Pack::width) {
+				Pack ax, ay, az, aw, bx, by, bz, bw;
+				loadQuaternions(&a[i].x, ax, ay, az, aw);
+				loadQuaternions(&b[i].x, bx, by, bz, bw);
+				const Pack tt = stride ? Pack::load(t + i) : Pack::set1(*t);
+				const Pack d = ax * bx + ay * by + az * bz + aw * bw;
+				const Pack negative = d < zero;
+				Pack ta, tb;
+				slerpWeights(series, select(negative, zero - d, d), tt, ta, tb);
+				tb = select(negative, zero - tb, tb);
+				storeQuaternions(&out[i].x, ax * ta + bx * tb, ay * ta + by * tb,
+												 az * ta + bz * tb, aw * ta + bw * tb);
+			}
+			return i;
+		}
+		
+		template <typename Pack, typename S>
+		std::size_t packedNlerp(const Quaternion<S> *a, const Quaternion<S> *b,
+														const S *t, std::size_t stride, std::size_t n,
+														Quaternion<S> *out)
+		{
+			const Pack zero = Pack::zero(), one = Pack::set1(1);
+			std::size_t i = 0;
+			for(; i + Pack::width <= n; i += Pack::width) {
+				Pack ax, ay, az, aw, bx, by, bz, bw;
+				loadQuaternions(&a[i].x, ax, ay, az, aw);
+				loadQuaternions(&b[i].x, bx, by, bz, bw);
+				const Pack tt = stride ? Pack::load(t + i) : Pack::set1(*t);
+				const Pack d = ax * bx + ay * by + az * bz + aw * bw;
+				const Pack tb = select(d < zero, zero - tt, tt);
+				const Pack ta = one - tt;
+				const Pack x = ax * ta + bx * tb, y = ay * ta + by * tb;
+				const Pack z = az * ta + bz * tb, w = aw * ta + bw * tb;
+				const Pack s = one / sqrt(x * x + y * y + z * z + w * w);
+				storeQuaternions(&out[i].x, x * s, y * s, z * s, w * s);
+			}
+			return i;
+		}
+		
+		inline std::size_t slerpFastBatch(const Quaternion<float> *a,
+																			const Quaternion<float> *b,
+																			const float *t, std::size_t stride,
+																			std::size_t n, Quaternion<float> *out)
+		{
+			return packedSlerpFast<simd::Pack<float>::type>(a, b, t, stride, n,
+																											out);
+		}
+		inline std::size_t slerpFastBatch(const Quaternion<double> *a,
+																			const Quaternion<double> *b,
+																			const double *t, std::size_t stride,
+																			std::size_t n, Quaternion<double> *out)
+		{
+			return packedSlerpFast<simd::Pack<double>::type>(a, b, t, stride, n,
+																											 out);
+		}
+		inline std::size_t nlerpBatch(const Quaternion<float> *a,
+																	const Quaternion<float> *b, const float *t,
+																	std::size_t stride, std::size_t n,
+																	Quaternion<float> *out)
+		{
+			return packedNlerp<simd::Pack<float>::type>(a, b, t, stride, n, out);
+		}
+		inline std::size_t nlerpBatch(const Quaternion<double> *a,
+																	const Quaternion<double> *b,
+																	const double *t, std::size_t stride,
+																	std::size_t n, Quaternion<double> *out)
+		{
+			return packedNlerp<simd::Pack<double>::type>(a, b, t, stride, n, out);
+		}
+#endif
+	}
+	
+	/*
+	 * Batch interpolation.
+	 *
+	 * These blend arrays of rotations pairwise, as when mixing two animation
+	 * poses, either with one parameter for every pair or with one parameter
+	 * per pair. Each gives the same results as the single quaternion version
+	 * applied to every pair. The output may be either input but must not
+	 * otherwise overlap them.
+	 */
+	
+	/**
+	 * \brief Interpolate arrays of unit quaternions with \c nlerp.
+	 * \arg \c a The rotations at t = 0
+	 * \arg \c b The rotations at t = 1
+	 * \arg \c t The interpolation parameter for every pair
+	 * \arg \c count The number of quaternions in each array
+	 * \arg \c out The array receiving the interpolated rotations
+	 */
+	template <typename Scalar>
+	void nlerp(const Quaternion<Scalar> *a, const Quaternion<Scalar> *b,
+						 Scalar t, std::size_t count, Quaternion<Scalar> *out)
+	{
+		std::size_t i = detail::nlerpBatch(a, b, &t, 0, count, out);
+		for(; i < count; ++i) {
+			out[i] = nlerp(a[i], b[i], t);
+		}
+	}
+	
+	/**
+	 * \brief Interpolate arrays of unit quaternions with \c nlerp, with a
+	 * parameter per pair.
+	 * \arg \c a The rotations at t = 0
+	 * \arg \c b The rotations at t = 1
+	 * \arg \c t The interpolation parameters, one per pair
+	 * \arg \c count The number of quaternions in each array
+	 * \arg \c out The array receiving the interpolated rotations
+	 */
+	template <typename Scalar>
+	void nlerp(const Quaternion<Scalar> *a, const Quaternion<Scalar> *b,
+						 const Scalar *t, std::size_t count, Quaternion<Scalar> *out)
+	{
+		std::size_t i = detail::nlerpBatch(a, b, t, 1, count, out);
+		for(; i < count; ++i) {
+			out[i] = nlerp(a[i], b[i], t[i]);
+		}
+	}
+	
+	/**
+	 * \brief Interpolate arrays of unit quaternions with \c slerpFast.
+	 * \arg \c a The rotations at t = 0
+	 * \arg \c b The rotations at t = 1
+	 * \arg \c t The interpolation parameter for every pair
+	 * \arg \c count The number of quaternions in each array
+	 * \arg \c out The array receiving the interpolated rotations
+	 */
+	template <typename Scalar>
+	void slerpFast(const Quaternion<Scalar> *a, const Quaternion<Scalar> *b,
+								 Scalar t, std::size_t count, Quaternion<Scalar> *out)
+	{
+		std::size_t i = detail::slerpFastBatch(a, b, &t, 0, count, out);
+		for(; i < count; ++i) {
+			out[i] = slerpFast(a[i], b[i], t);
+		}
+	}
+	
+	/**
+	 * \brief Interpolate arrays of unit quaternions with \c slerpFast, with a
+	 * parameter per pair.
+	 * \arg \c a The rotations at t = 0
+	 * \arg \c b The rotations at t = 1
+	 * \arg \c t The interpolation parameters, one per pair
+	 * \arg \c count The number of quaternions in each array
+	 * \arg \c out The array receiving the interpolated rotations
+	 */
+	template <typename Scalar>
+	void slerpFast(const Quaternion<Scalar> *a, const Quaternion<Scalar> *b,
+								 const Scalar *t, std::size_t count, Quaternion<Scalar> *out)
+	{
+		std::size_t i = detail::slerpFastBatch(a, b, t, 1, count, out);
+		for(; i < count; ++i) {
+			out[i] = slerpFast(a[i], b[i], t[i]);
+		}
+	}
+}
+
+#endif
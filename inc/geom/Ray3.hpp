@@ -0,0 +1,92 @@
+/**
+ * \file Ray3.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Definition of the Ray3 structure
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_RAY_3_HPP
+#define GEOM_RAY_3_HPP
+
+#include <cstdint>
+
+#include "Point3.hpp"
+#include "Vector3.hpp"
+
+namespace geom {
+	/**
+	 * \brief A half line in 3 dimensional space, starting at \c origin and
+	 * extending along \c direction.
+	 *
+	 * The points of the ray are \f$origin + t \cdot direction\f$ for
+	 * \f$t \ge 0\f$, so intersection distances are measured in multiples of
+	 * the length of the direction, which does not need to be normalized.
+	 */
+	template <typename Scalar>
+	struct Ray3 {
+		/**
+		 * \brief Construct a \c Ray3 object from the origin along +z.
+		 */
+		constexpr Ray3() :
+			origin(), direction(0, 0, 1)
+		{ }
+		/**
+		 * \brief Construct a \c Ray3 object with the given origin and
+		 * direction.
+		 * \arg \c origin The point the ray starts at
+		 * \arg \c direction The direction of the ray, which must not be zero
+		 */
+		constexpr Ray3(const Point3<Scalar> &origin,
+									 const Vector3<Scalar> &direction) :
+			origin(origin), direction(direction)
+		{ }
+		/**
+		 * \brief Construct a \c Ray3 object which is a conversion of the given
+		 * \c Ray3 object.
+		 * \arg \c source The \c Ray3 object to convert
+		 */
+		template <typename Other>
+		constexpr Ray3(const Ray3<Other> &source) :
+			origin(source.origin), direction(source.direction)
+		{ }
+		
+		/**
+		 * \brief Get the point at the given distance along the ray.
+		 * \arg \c t The distance in multiples of the direction
+		 * \return The point \f$origin + t \cdot direction\f$
+		 */
+		constexpr Point3<Scalar> at(Scalar t) const {
+			return Point3<Scalar>(origin.x + t * direction.x,
+														origin.y + t * direction.y,
+														origin.z + t * direction.z);
+		}
+		
+		Point3<Scalar> origin; /**< The point the ray starts at */
+		Vector3<Scalar> direction; /**< The direction of the ray */
+	};
+	
+	typedef Ray3<float> Ray3f;
+	typedef Ray3<double> Ray3d;
+}
+
+#endif
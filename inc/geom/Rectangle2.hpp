@@ -2,10 +2,21 @@
 #ifndef GEOM_RECTANGLE2_HPP
 #define GEOM_RECTANGLE2_HPP
 
+#include <cstdint>
+
 #include "Point2.hpp"
 #include "Dimensions2.hpp"
+#include "Simd.hpp"
 
 namespace geom {
+	/**
+	 * \brief An axis-aligned rectangle given by its minimum corner and
+	 * dimensions.
+	 *
+	 * The rectangle covers \f$[x, x + width) \times [y, y + height)\f$, so
+	 * rectangles sharing an edge do not overlap, as pixel rectangles tile the
+	 * screen. A rectangle without a positive width and height is empty.
+	 */
 	template <typename Scalar>
 	struct Rectangle2 {
 	public:
@@ -35,6 +46,174 @@ namespace geom {
 	typedef Rectangle2<uint32_t> Rectangle2u;
 	typedef Rectangle2<int64_t> Rectangle2l;
 	typedef Rectangle2<uint64_t> Rectangle2ul;
+	
+	/**
+	 * \brief Compare two rectangles for equality of their origins and
+	 * dimensions.
+	 */
+	template <typename LType, typename RType>
+	bool operator==(const Rectangle2<LType> &lhs, const Rectangle2<RType> &rhs) {
+		return lhs.origin.x == rhs.origin.x && lhs.origin.y == rhs.origin.y &&
+			lhs.dim.width == rhs.dim.width && lhs.dim.height == rhs.dim.height;
+	}
+	/**
+	 * \brief Compare two rectangles for inequality.
+	 */
+	template <typename LType, typename RType>
+	bool operator!=(const Rectangle2<LType> &lhs, const Rectangle2<RType> &rhs) {
+		return !(lhs == rhs);
+	}
+	
+	namespace detail {
+		/*
+		 * The operations on rectangles, written over the pack types of
+		 * Simd.hpp on the edges x0 <= x < x1 and y0 <= y < y1, so that the
+		 * batch kernels and the single rectangle functions share them.
+		 */
+		template <typename P>
+		struct Edges {
+			P x0, y0, x1, y1;
+			
+			static Edges load(const P &x, const P &y, const P &w, const P &h) {
+				const Edges e = { x, y, x + w, y + h };
+				return e;
+			}
+			
+			auto contains(const P &x, const P &y) const
+				-> decltype(P() < P())
+			{
+				return (x0 <= x) & (x < x1) & (y0 <= y) & (y < y1);
+			}
+			auto overlaps(const Edges &b) const -> decltype(P() < P()) {
+				using simd::min;
+				using simd::max;
+				return (max(x0, b.x0) < min(x1, b.x1)) &
+					(max(y0, b.y0) < min(y1, b.y1));
+			}
+			/* The intersection as an origin and dimensions */
+			void clip(const Edges &b, P &x, P &y, P &w, P &h) const {
+				using simd::min;
+				using simd::max;
+				x = max(x0, b.x0);
+				y = max(y0, b.y0);
+				const P cx1 = min(x1, b.x1), cy1 = min(y1, b.y1);
+				w = simd::select(x < cx1, cx1 - x, P::zero());
+				h = simd::select(y < cy1, cy1 - y, P::zero());
+			}
+		};
+		
+		template <typename S>
+		Edges<simd::Single<S>> edges(const Rectangle2<S> &r) {
+			typedef simd::Single<S> P;
+			return Edges<P>::load(P(r.origin.x), P(r.origin.y), P(r.dim.width),
+														P(r.dim.height));
+		}
+	}
+	
+	/**
+	 * \brief Test whether a rectangle covers no points.
+	 * \return True unless the width and height are both positive
+	 */
+	template <typename Scalar>
+	bool empty(const Rectangle2<Scalar> &r) {
+		return !(r.dim.width > 0 && r.dim.height > 0);
+	}
+	/**
+	 * \brief Get the area of a rectangle.
+	 * \return The area, zero for an empty rectangle
+	 */
+	template <typename Scalar>
+	Scalar area(const Rectangle2<Scalar> &r) {
+		return empty(r) ? Scalar(0) : r.dim.width * r.dim.height;
+	}
+	
+	/**
+	 * \brief Get the intersection of two rectangles, as when clipping one to
+	 * the other.
+	 * \arg \c a The first rectangle
+	 * \arg \c b The second rectangle
+	 * \return The rectangle of the points in both a and b, which has a zero
+	 * width or height if they do not overlap
+	 */
+	template <typename Scalar>
+	Rectangle2<Scalar> intersection(const Rectangle2<Scalar> &a,
+																	const Rectangle2<Scalar> &b)
+	{
+		simd::Single<Scalar> x, y, w, h;
+		detail::edges(a).clip(detail::edges(b), x, y, w, h);
+		return Rectangle2<Scalar>(x.v, y.v, w.v, h.v);
+	}
+	/**
+	 * \brief Get the smallest rectangle containing two rectangles, their
+	 * union. Empty rectangles are ignored.
+	 * \arg \c a The first rectangle
+	 * \arg \c b The second rectangle
+	 * \return The rectangle bounding a and b
+	 */
+	template <typename Scalar>
+	Rectangle2<Scalar> join(const Rectangle2<Scalar> &a,
+													const Rectangle2<Scalar> &b)
+	{
+		if(empty(a)) {
+			return b;
+		} else if(empty(b)) {
+			return a;
+		}
+		const Scalar x0 = a.origin.x < b.origin.x ? a.origin.x : b.origin.x;
+		const Scalar y0 = a.origin.y < b.origin.y ? a.origin.y : b.origin.y;
+		const Scalar ax1 = a.origin.x + a.dim.width;
+		const Scalar ay1 = a.origin.y + a.dim.height;
+		const Scalar bx1 = b.origin.x + b.dim.width;
+		const Scalar by1 = b.origin.y + b.dim.height;
+		return Rectangle2<Scalar>(x0, y0, (ax1 > bx1 ? ax1 : bx1) - x0,
+															(ay1 > by1 ? ay1 : by1) - y0);
+	}
+	
+	/**
+	 * \brief Test whether two rectangles have an area in common.
+	 * \arg \c a The first rectangle
+	 * \arg \c b The second rectangle
+	 * \return True if the intersection of a and b is not empty
+	 */
+	template <typename Scalar>
+	bool overlaps(const Rectangle2<Scalar> &a, const Rectangle2<Scalar> &b) {
+		return detail::edges(a).overlaps(detail::edges(b));
+	}
+	/**
+	 * \brief Get the area of the intersection of two rectangles.
+	 */
+	template <typename Scalar>
+	Scalar overlapArea(const Rectangle2<Scalar> &a,
+										 const Rectangle2<Scalar> &b)
+	{
+		return area(intersection(a, b));
+	}
+	
+	/**
+	 * \brief Test whether a point lies in a rectangle. Points on the left and
+	 * top edges are inside, those on the right and bottom edges are not.
+	 */
+	template <typename Scalar>
+	bool contains(const Rectangle2<Scalar> &r, const Point2<Scalar> &p) {
+		typedef simd::Single<Scalar> P;
+		return detail::edges(r).contains(P(p.x), P(p.y));
+	}
+	/**
+	 * \brief Test whether a rectangle lies within another, which holds for
+	 * any empty inner rectangle.
+	 * \arg \c r The outer rectangle
+	 * \arg \c inner The rectangle to test
+	 */
+	template <typename Scalar>
+	bool contains(const Rectangle2<Scalar> &r, const Rectangle2<Scalar> &inner)
+	{
+		return empty(inner) || (r.origin.x <= inner.origin.x &&
+														r.origin.y <= inner.origin.y &&
+														inner.origin.x + inner.dim.width <=
+														r.origin.x + r.dim.width &&
+														inner.origin.y + inner.dim.height <=
+														r.origin.y + r.dim.height);
+	}
 }
 
 #endif
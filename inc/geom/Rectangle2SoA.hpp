@@ -0,0 +1,634 @@
+/**
+ * \file Rectangle2SoA.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Structure of arrays storage and batch operations for Rectangle2
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_RECTANGLE_2_SOA_HPP
+#define GEOM_RECTANGLE_2_SOA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "Rectangle2.hpp"
+#include "Simd.hpp"
+
+namespace geom {
+	/**
+	 * \brief A non-owning view of \c Rectangle2 values stored as separate
+	 * arrays of origins and dimensions.
+	 *
+	 * A view of \c const values is used for read-only access.
+	 */
+	template <typename Scalar>
+	struct Rectangle2Span {
+		typedef typename std::remove_const<Scalar>::type type;
+		
+		/**
+		 * \brief Construct an empty \c Rectangle2Span
+		 */
+		Rectangle2Span() :
+			x(nullptr), y(nullptr), width(nullptr), height(nullptr), count(0)
+		{ }
+		/**
+		 * \brief Construct a \c Rectangle2Span over the given arrays
+		 * \arg \c x The array of origin x coordinates
+		 * \arg \c y The array of origin y coordinates
+		 * \arg \c width The array of widths
+		 * \arg \c height The array of heights
+		 * \arg \c count The number of rectangles in each array
+		 */
+		Rectangle2Span(Scalar *x, Scalar *y, Scalar *width, Scalar *height,
+									 std::size_t count) :
+			x(x), y(y), width(width), height(height), count(count)
+		{ }
+		/**
+		 * \brief Construct a \c Rectangle2Span viewing the same arrays as the
+		 * given \c Rectangle2Span, used to convert a mutable view to a
+		 * \c const one.
+		 * \arg \c source The \c Rectangle2Span to view
+		 */
+		template <typename Other>
+		Rectangle2Span(const Rectangle2Span<Other> &source) :
+			x(source.x), y(source.y), width(source.width),
+			height(source.height), count(source.count)
+		{ }
+		
+		/**
+		 * \brief Gather the rectangle at the given index
+		 */
+		Rectangle2<type> operator[](std::size_t i) const {
+			return Rectangle2<type>(x[i], y[i], width[i], height[i]);
+		}
+		/**
+		 * \brief Get a view of a sub range of the rectangles
+		 * \arg \c first The index of the first rectangle of the sub range
+		 * \arg \c n The number of rectangles in the sub range
+		 */
+		Rectangle2Span<Scalar> subspan(std::size_t first, std::size_t n) const {
+			return Rectangle2Span<Scalar>(x + first, y + first, width + first,
+																		height + first, n);
+		}
+		
+		Scalar *x; /**< The array of origin x coordinates */
+		Scalar *y; /**< The array of origin y coordinates */
+		Scalar *width; /**< The array of widths */
+		Scalar *height; /**< The array of heights */
+		std::size_t count; /**< The number of rectangles viewed */
+	};
+	
+	/**
+	 * \brief A container of \c Rectangle2 values stored as separate arrays of
+	 * origin coordinates and dimensions, for the batch operations below.
+	 */
+	template <typename Scalar>
+	struct Rectangle2SoA {
+		/**
+		 * \brief Construct an empty \c Rectangle2SoA
+		 */
+		Rectangle2SoA() { }
+		/**
+		 * \brief Construct a \c Rectangle2SoA holding count empty rectangles
+		 * \arg \c count The number of rectangles to hold
+		 */
+		explicit Rectangle2SoA(std::size_t count) :
+			x(count), y(count), width(count), height(count)
+		{ }
+		/**
+		 * \brief Construct a \c Rectangle2SoA from an array of \c Rectangle2
+		 * objects.
+		 * \arg \c source The array of rectangles to convert from
+		 * \arg \c count The number of rectangles in source
+		 */
+		template <typename Other>
+		Rectangle2SoA(const Rectangle2<Other> *source, std::size_t count) :
+			x(count), y(count), width(count), height(count)
+		{
+			for(std::size_t i = 0; i < count; ++i) {
+				set(i, source[i]);
+			}
+		}
+		
+		/**
+		 * \brief Get the number of rectangles held
+		 */
+		std::size_t size() const {
+			return x.size();
+		}
+		/**
+		 * \brief Change the number of rectangles held, new rectangles are
+		 * empty
+		 * \arg \c count The new number of rectangles
+		 */
+		void resize(std::size_t count) {
+			x.resize(count);
+			y.resize(count);
+			width.resize(count);
+			height.resize(count);
+		}
+		/**
+		 * \brief Reserve storage for the given number of rectangles
+		 */
+		void reserve(std::size_t count) {
+			x.reserve(count);
+			y.reserve(count);
+			width.reserve(count);
+			height.reserve(count);
+		}
+		/**
+		 * \brief Remove all rectangles
+		 */
+		void clear() {
+			x.clear();
+			y.clear();
+			width.clear();
+			height.clear();
+		}
+		/**
+		 * \brief Append a rectangle to the end of the container
+		 */
+		template <typename Other>
+		void push_back(const Rectangle2<Other> &r) {
+			x.push_back(r.origin.x);
+			y.push_back(r.origin.y);
+			width.push_back(r.dim.width);
+			height.push_back(r.dim.height);
+		}
+		
+		/**
+		 * \brief Gather the rectangle at the given index
+		 */
+		Rectangle2<Scalar> operator[](std::size_t i) const {
+			return Rectangle2<Scalar>(x[i], y[i], width[i], height[i]);
+		}
+		/**
+		 * \brief Scatter a rectangle into the given index
+		 */
+		template <typename Other>
+		void set(std::size_t i, const Rectangle2<Other> &r) {
+			x[i] = r.origin.x;
+			y[i] = r.origin.y;
+			width[i] = r.dim.width;
+			height[i] = r.dim.height;
+		}
+		
+		/**
+		 * \brief Get a mutable view of all rectangles held
+		 */
+		Rectangle2Span<Scalar> span() {
+			return Rectangle2Span<Scalar>(x.data(), y.data(), width.data(),
+																		height.data(), size());
+		}
+		/**
+		 * \brief Get a read-only view of all rectangles held
+		 */
+		Rectangle2Span<const Scalar> span() const {
+			return Rectangle2Span<const Scalar>(x.data(), y.data(), width.data(),
+																					height.data(), size());
+		}
+		
+		std::vector<Scalar> x; /**< The origin x coordinates */
+		std::vector<Scalar> y; /**< The origin y coordinates */
+		std::vector<Scalar> width; /**< The widths */
+		std::vector<Scalar> height; /**< The heights */
+	};
+	
+	typedef Rectangle2SoA<std::int32_t> Rectangle2SoAi;
+	typedef Rectangle2SoA<std::uint32_t> Rectangle2SoAu;
+	typedef Rectangle2SoA<std::int64_t> Rectangle2SoAl;
+	typedef Rectangle2SoA<std::uint64_t> Rectangle2SoAul;
+	typedef Rectangle2SoA<float> Rectangle2SoAf;
+	typedef Rectangle2SoA<double> Rectangle2SoAd;
+	
+	namespace detail {
+		template <typename P, typename S>
+		Edges<P> loadEdges(const Rectangle2Span<const S> &r, std::size_t i) {
+			return Edges<P>::load(P::load(r.x + i), P::load(r.y + i),
+														P::load(r.width + i), P::load(r.height + i));
+		}
+		template <typename P, typename S>
+		Edges<P> broadcastEdges(const Rectangle2<S> &r) {
+			return Edges<P>::load(P::set1(r.origin.x), P::set1(r.origin.y),
+														P::set1(r.dim.width), P::set1(r.dim.height));
+		}
+		
+		/*
+		 * The tests below give the mask of the P::width rectangles from index
+		 * i which overlap a rectangle or contain a point.
+		 */
+		template <typename S>
+		struct OverlapTest {
+			typedef S type;
+			Rectangle2<S> r;
+			Rectangle2Span<const S> rects;
+			
+			template <typename P>
+			auto test(std::size_t i) const -> decltype(P() < P()) {
+				return broadcastEdges<P>(r).overlaps(loadEdges<P>(rects, i));
+			}
+		};
+		template <typename S>
+		struct ContainsTest {
+			typedef S type;
+			Point2<S> p;
+			Rectangle2Span<const S> rects;
+			
+			template <typename P>
+			auto test(std::size_t i) const -> decltype(P() < P()) {
+				return loadEdges<P>(rects, i).contains(P::set1(p.x), P::set1(p.y));
+			}
+		};
+		
+		/*
+		 * Set the bits of tests [first, n) a whole pack at a time, returning
+		 * the index of the first test not made. Bit i % 32 of word i / 32 is
+		 * set by test i; each word is cleared by its first test, which must be
+		 * included in the range.
+		 */
+		template <typename P, typename Test>
+		std::size_t maskPacked(const Test &t, std::size_t first, std::size_t n,
+													 std::uint32_t *mask)
+		{
+			std::size_t i = first;
+			for(; i + P::width <= n; i += P::width) {
+				const std::uint32_t bits = simd::movemask(t.template test<P>(i));
+				if(i % 32 == 0) {
+					mask[i / 32] = bits;
+				} else {
+					mask[i / 32] |= bits << (i % 32);
+				}
+			}
+			return i;
+		}
+		/*
+		 * Append the indices of the passing tests of [first, n) to indices. A
+		 * pack's lanes are all written, advancing the count by the passing
+		 * ones, which avoids a branch per lane; the stores stay below index n
+		 * of the output.
+		 */
+		template <typename P, typename Test>
+		std::size_t indexPacked(const Test &t, std::size_t first, std::size_t n,
+														std::uint32_t *indices, std::size_t &count)
+		{
+			std::size_t i = first;
+			for(; i + P::width <= n; i += P::width) {
+				const std::uint32_t bits = simd::movemask(t.template test<P>(i));
+				if(bits != 0) {
+					for(std::size_t k = 0; k < P::width; ++k) {
+						indices[count] = std::uint32_t(i + k);
+						count += (bits >> k) & 1;
+					}
+				}
+			}
+			return i;
+		}
+		
+		/*
+		 * The packed kernels run over the widest pack of the scalar type, when
+		 * Simd.hpp has one, leaving the remainder to simd::Single.
+		 */
+		template <typename S>
+		using HasPack = std::integral_constant<bool, simd::Pack<S>::enabled>;
+		
+		template <typename Test>
+		std::size_t maskBatch(const Test &, std::size_t, std::uint32_t *,
+													std::false_type)
+		{
+			return 0;
+		}
+		template <typename Test>
+		std::size_t maskBatch(const Test &t, std::size_t n, std::uint32_t *mask,
+													std::true_type)
+		{
+			typedef typename simd::Pack<typename Test::type>::type P;
+			return maskPacked<P>(t, 0, n, mask);
+		}
+		template <typename Test>
+		void mask(const Test &t, std::size_t n, std::uint32_t *mask) {
+			typedef typename Test::type S;
+			const std::size_t i = maskBatch(t, n, mask, HasPack<S>());
+			maskPacked<simd::Single<S>>(t, i, n, mask);
+		}
+		
+		template <typename Test>
+		std::size_t indexBatch(const Test &, std::size_t, std::uint32_t *,
+													 std::size_t &, std::false_type)
+		{
+			return 0;
+		}
+		template <typename Test>
+		std::size_t indexBatch(const Test &t, std::size_t n,
+													 std::uint32_t *indices, std::size_t &count,
+													 std::true_type)
+		{
+			typedef typename simd::Pack<typename Test::type>::type P;
+			return indexPacked<P>(t, 0, n, indices, count);
+		}
+		template <typename Test>
+		std::size_t index(const Test &t, std::size_t n, std::uint32_t *indices) {
+			typedef typename Test::type S;
+			std::size_t count = 0;
+			const std::size_t i = indexBatch(t, n, indices, count, HasPack<S>());
+			indexPacked<simd::Single<S>>(t, i, n, indices, count);
+			return count;
+		}
+		
+		/* Clip rectangles [first, n) to r, returning the first not clipped */
+		template <typename P, typename S>
+		std::size_t clipPacked(const Rectangle2<S> &r,
+													 Rectangle2Span<const S> rects, std::size_t first,
+													 std::size_t n, Rectangle2Span<S> out)
+		{
+			const Edges<P> c = broadcastEdges<P>(r);
+			std::size_t i = first;
+			for(; i + P::width <= n; i += P::width) {
+				P x, y, w, h;
+				c.clip(loadEdges<P>(rects, i), x, y, w, h);
+				x.store(out.x + i);
+				y.store(out.y + i);
+				w.store(out.width + i);
+				h.store(out.height + i);
+			}
+			return i;
+		}
+		/* The areas of the intersections of rectangles [first, n) with r */
+		template <typename P, typename S>
+		std::size_t areaPacked(const Rectangle2<S> &r,
+													 Rectangle2Span<const S> rects, std::size_t first,
+													 std::size_t n, S *areas)
+		{
+			const Edges<P> c = broadcastEdges<P>(r);
+			std::size_t i = first;
+			for(; i + P::width <= n; i += P::width) {
+				P x, y, w, h;
+				c.clip(loadEdges<P>(rects, i), x, y, w, h);
+				(w * h).store(areas + i);
+			}
+			return i;
+		}
+		/*
+		 * Accumulate the edges bounding the non-empty rectangles of [first, n),
+		 * returning the first rectangle not included.
+		 */
+		template <typename P, typename S>
+		std::size_t boundsPacked(Rectangle2Span<const S> rects, std::size_t first,
+														 std::size_t n, Edges<P> &b)
+		{
+			using simd::min;
+			using simd::max;
+			std::size_t i = first;
+			for(; i + P::width <= n; i += P::width) {
+				const P w = P::load(rects.width + i), h = P::load(rects.height + i);
+				const Edges<P> e = Edges<P>::load(P::load(rects.x + i),
+																					P::load(rects.y + i), w, h);
+				const auto used = (w > P::zero()) & (h > P::zero());
+				b.x0 = simd::select(used, min(b.x0, e.x0), b.x0);
+				b.y0 = simd::select(used, min(b.y0, e.y0), b.y0);
+				b.x1 = simd::select(used, max(b.x1, e.x1), b.x1);
+				b.y1 = simd::select(used, max(b.y1, e.y1), b.y1);
+			}
+			return i;
+		}
+		template <typename P>
+		Edges<P> emptyEdges() {
+			typedef typename P::type S;
+			const Edges<P> e = {
+				P::set1(std::numeric_limits<S>::max()),
+				P::set1(std::numeric_limits<S>::max()),
+				P::set1(std::numeric_limits<S>::lowest()),
+				P::set1(std::numeric_limits<S>::lowest())
+			};
+			return e;
+		}
+		
+		template <typename S>
+		std::size_t clipBatch(const Rectangle2<S> &, Rectangle2Span<const S>,
+													Rectangle2Span<S>, std::false_type)
+		{
+			return 0;
+		}
+		template <typename S>
+		std::size_t clipBatch(const Rectangle2<S> &r,
+													Rectangle2Span<const S> rects,
+													Rectangle2Span<S> out, std::true_type)
+		{
+			typedef typename simd::Pack<S>::type P;
+			return clipPacked<P>(r, rects, 0, rects.count, out);
+		}
+		template <typename S>
+		std::size_t areaBatch(const Rectangle2<S> &, Rectangle2Span<const S>,
+													S *, std::false_type)
+		{
+			return 0;
+		}
+		template <typename S>
+		std::size_t areaBatch(const Rectangle2<S> &r,
+													Rectangle2Span<const S> rects, S *areas,
+													std::true_type)
+		{
+			typedef typename simd::Pack<S>::type P;
+			return areaPacked<P>(r, rects, 0, rects.count, areas);
+		}
+		template <typename S>
+		std::size_t boundsBatch(Rectangle2Span<const S>, Edges<simd::Single<S>> &,
+														std::false_type)
+		{
+			return 0;
+		}
+		/* The lanes of the packed bounds are folded into the single ones */
+		template <typename S>
+		std::size_t boundsBatch(Rectangle2Span<const S> rects,
+														Edges<simd::Single<S>> &b, std::true_type)
+		{
+			typedef typename simd::Pack<S>::type P;
+			Edges<P> packed = emptyEdges<P>();
+			const std::size_t n = boundsPacked(rects, 0, rects.count, packed);
+			S x0[P::width], y0[P::width], x1[P::width], y1[P::width];
+			packed.x0.store(x0);
+			packed.y0.store(y0);
+			packed.x1.store(x1);
+			packed.y1.store(y1);
+			for(std::size_t k = 0; k < P::width; ++k) {
+				b.x0 = simd::min(b.x0, simd::Single<S>(x0[k]));
+				b.y0 = simd::min(b.y0, simd::Single<S>(y0[k]));
+				b.x1 = simd::max(b.x1, simd::Single<S>(x1[k]));
+				b.y1 = simd::max(b.y1, simd::Single<S>(y1[k]));
+			}
+			return n;
+		}
+	}
+	
+	/*
+	 * Batch operations.
+	 *
+	 * Each operation applies one rectangle or point to every rectangle of a
+	 * span, with the results of the single rectangle functions above. Tests
+	 * write either a bitmask, where bit i % 32 of word i / 32 is set when
+	 * rectangle i passes and the mask must hold (count + 31) / 32 words with
+	 * unused bits of the last word cleared, or the ascending indices of the
+	 * passing rectangles, for which the index array must hold as many
+	 * entries as there are rectangles. Float, double and 32 bit integer
+	 * rectangles are processed 4 to 8 at a time with SSE/AVX instructions,
+	 * see Simd.hpp.
+	 */
+	
+	/**
+	 * \brief Test which rectangles of an array overlap a rectangle, as in
+	 * binning rectangles into a tile.
+	 * \arg \c r The rectangle to test against
+	 * \arg \c rects The rectangles to test
+	 * \arg \c mask The bitmask receiving whether each rectangle overlaps r
+	 */
+	template <typename Scalar, typename RScalar>
+	void overlaps(const Rectangle2<Scalar> &r, Rectangle2Span<RScalar> rects,
+								std::uint32_t *mask)
+	{
+		static_assert(std::is_same<typename Rectangle2Span<RScalar>::type,
+															 Scalar>::value,
+									"The rectangles must have the same scalar type");
+		const detail::OverlapTest<Scalar> t = { r, rects };
+		detail::mask(t, rects.count, mask);
+	}
+	/**
+	 * \brief Find the rectangles of an array which overlap a rectangle.
+	 * \arg \c r The rectangle to test against
+	 * \arg \c rects The rectangles to test
+	 * \arg \c indices The array receiving the index of each overlapping
+	 * rectangle, in ascending order
+	 * \return The number of overlapping rectangles
+	 */
+	template <typename Scalar, typename RScalar>
+	std::size_t overlapping(const Rectangle2<Scalar> &r,
+													Rectangle2Span<RScalar> rects,
+													std::uint32_t *indices)
+	{
+		static_assert(std::is_same<typename Rectangle2Span<RScalar>::type,
+															 Scalar>::value,
+									"The rectangles must have the same scalar type");
+		const detail::OverlapTest<Scalar> t = { r, rects };
+		return detail::index(t, rects.count, indices);
+	}
+	
+	/**
+	 * \brief Test which rectangles of an array contain a point, as in hit
+	 * testing.
+	 * \arg \c rects The rectangles to test
+	 * \arg \c p The point
+	 * \arg \c mask The bitmask receiving whether each rectangle contains p
+	 */
+	template <typename Scalar, typename RScalar>
+	void contains(Rectangle2Span<RScalar> rects, const Point2<Scalar> &p,
+								std::uint32_t *mask)
+	{
+		static_assert(std::is_same<typename Rectangle2Span<RScalar>::type,
+															 Scalar>::value,
+									"The rectangles must have the scalar type of the point");
+		const detail::ContainsTest<Scalar> t = { p, rects };
+		detail::mask(t, rects.count, mask);
+	}
+	/**
+	 * \brief Find the rectangles of an array which contain a point.
+	 * \arg \c rects The rectangles to test
+	 * \arg \c p The point
+	 * \arg \c indices The array receiving the index of each rectangle
+	 * containing p, in ascending order
+	 * \return The number of rectangles containing p
+	 */
+	template <typename Scalar, typename RScalar>
+	std::size_t containing(Rectangle2Span<RScalar> rects,
+												 const Point2<Scalar> &p, std::uint32_t *indices)
+	{
+		static_assert(std::is_same<typename Rectangle2Span<RScalar>::type,
+															 Scalar>::value,
+									"The rectangles must have the scalar type of the point");
+		const detail::ContainsTest<Scalar> t = { p, rects };
+		return detail::index(t, rects.count, indices);
+	}
+	
+	/**
+	 * \brief Clip an array of rectangles to a rectangle.
+	 * \arg \c r The rectangle to clip to
+	 * \arg \c rects The rectangles to clip
+	 * \arg \c out The span receiving the intersection of each rectangle with
+	 * r, which may be rects itself
+	 */
+	template <typename Scalar, typename RScalar>
+	void intersection(const Rectangle2<Scalar> &r, Rectangle2Span<RScalar> rects,
+										Rectangle2Span<Scalar> out)
+	{
+		static_assert(std::is_same<typename Rectangle2Span<RScalar>::type,
+															 Scalar>::value,
+									"The rectangles must have the same scalar type");
+		const Rectangle2Span<const Scalar> in = rects;
+		const std::size_t i = detail::clipBatch(r, in, out,
+																						detail::HasPack<Scalar>());
+		detail::clipPacked<simd::Single<Scalar>>(r, in, i, in.count, out);
+	}
+	/**
+	 * \brief Calculate the areas of overlap of an array of rectangles with a
+	 * rectangle.
+	 * \arg \c r The rectangle to test against
+	 * \arg \c rects The rectangles to test
+	 * \arg \c areas The array receiving the overlap area of each rectangle
+	 */
+	template <typename Scalar, typename RScalar>
+	void overlapArea(const Rectangle2<Scalar> &r, Rectangle2Span<RScalar> rects,
+									 Scalar *areas)
+	{
+		static_assert(std::is_same<typename Rectangle2Span<RScalar>::type,
+															 Scalar>::value,
+									"The rectangles must have the same scalar type");
+		const Rectangle2Span<const Scalar> in = rects;
+		const std::size_t i = detail::areaBatch(r, in, areas,
+																						detail::HasPack<Scalar>());
+		detail::areaPacked<simd::Single<Scalar>>(r, in, i, in.count, areas);
+	}
+	
+	/**
+	 * \brief Get the smallest rectangle containing every non-empty rectangle
+	 * of an array, their union.
+	 * \arg \c rects The rectangles
+	 * \return The bounding rectangle, or an empty rectangle at the origin if
+	 * every rectangle is empty
+	 */
+	template <typename Scalar>
+	Rectangle2<typename Rectangle2Span<Scalar>::type>
+	join(Rectangle2Span<Scalar> rects) {
+		typedef typename Rectangle2Span<Scalar>::type S;
+		typedef simd::Single<S> P;
+		const Rectangle2Span<const S> in = rects;
+		detail::Edges<P> b = detail::emptyEdges<P>();
+		const std::size_t i = detail::boundsBatch(in, b, detail::HasPack<S>());
+		detail::boundsPacked(in, i, in.count, b);
+		if(!(b.x0 < b.x1)) {
+			return Rectangle2<S>(0, 0, 0, 0);
+		}
+		return Rectangle2<S>(b.x0.v, b.y0.v, b.x1.v - b.x0.v, b.y1.v - b.y0.v);
+	}
+}
+
+#endif
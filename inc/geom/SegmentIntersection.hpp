@@ -0,0 +1,592 @@
+/**
+ * \file SegmentIntersection.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Intersections of sets of line segments by the Bentley-Ottmann sweep
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_SEGMENT_INTERSECTION_HPP
+#define GEOM_SEGMENT_INTERSECTION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+#include "Exact.hpp"
+#include "Line2.hpp"
+#include "Point2.hpp"
+
+namespace geom {
+	/**
+	 * \brief The scalar type of the intersection points of segments with the
+	 * given coordinate type: the coordinate type itself for floating point
+	 * coordinates, double for integer ones.
+	 */
+	template <typename Scalar>
+	struct IntersectionScalar {
+		typedef typename std::conditional<std::is_floating_point<Scalar>::value,
+																			Scalar, double>::type type;
+	};
+	
+	/**
+	 * \brief A pair of intersecting segments and a point they share.
+	 */
+	template <typename Scalar>
+	struct SegmentIntersection {
+		typedef typename IntersectionScalar<Scalar>::type point_type;
+		
+		std::uint32_t first; /**< The index of the first segment */
+		std::uint32_t second; /**< The greater index of the second segment */
+		/**
+		 * The intersection point rounded to point_type, or for collinear
+		 * overlapping segments the first point of the overlap, in the order
+		 * of x then y.
+		 */
+		Point2<point_type> point;
+	};
+	
+	namespace detail {
+		/*
+		 * A segment with its endpoints ordered by x then y, so that its
+		 * direction r = b - a has a positive x component or is vertical and
+		 * upwards, and approximations of its coordinates for the filters.
+		 */
+		template <typename S>
+		struct SweepSegment {
+			SweepSegment(const Line2<S> &l) {
+				const bool swap = l.p2.x < l.p1.x ||
+					(l.p2.x == l.p1.x && l.p2.y < l.p1.y);
+				a = swap ? l.p2 : l.p1;
+				b = swap ? l.p1 : l.p2;
+				ax = exact::approx(a.x);
+				ay = exact::approx(a.y);
+				rx = exact::approx(b.x) - ax;
+				ry = exact::approx(b.y) - ay;
+			}
+			
+			bool degenerate() const {
+				return a.x == b.x && a.y == b.y;
+			}
+			
+			Point2<S> a, b;
+			exact::Approx ax, ay, rx, ry;
+		};
+		
+		/*
+		 * A point of the sweep in homogeneous coordinates (x / w, y / w) with
+		 * w > 0: either endpoint end of segment s, or the crossing of segments
+		 * s and t.
+		 */
+		struct SweepPoint {
+			exact::Approx x, y, w;
+			std::uint32_t s, t;
+			std::uint8_t end;
+			
+			static const std::uint32_t Endpoint = 0xffffffff;
+			
+			bool input() const {
+				return t == Endpoint;
+			}
+		};
+		
+		/*
+		 * The exact predicates of the sweep. Each evaluates a polynomial in
+		 * the input coordinates on approximations first and recomputes it
+		 * with expansions only when the sign is uncertain.
+		 */
+		template <typename S>
+		class SweepKernel {
+		public:
+			typedef exact::Approx Approx;
+			typedef exact::Expansion Expansion;
+			
+			explicit SweepKernel(const SweepSegment<S> *segments) :
+				segments(segments)
+			{ }
+			
+			SweepPoint endpoint(std::uint32_t s, std::uint8_t end) const {
+				const Point2<S> &p = end ? segments[s].b : segments[s].a;
+				const Approx one = { 1, 0 };
+				const SweepPoint r = {
+					exact::approx(p.x), exact::approx(p.y), one, s,
+					SweepPoint::Endpoint, end
+				};
+				return r;
+			}
+			/*
+			 * The crossing of two segments which are not parallel, where
+			 * sign is the sign of cross(r_s, r_t).
+			 */
+			SweepPoint crossing(std::uint32_t s, std::uint32_t t, int sign) const {
+				const SweepSegment<S> &u = segments[s], &v = segments[t];
+				Approx den = u.rx * v.ry - u.ry * v.rx;
+				Approx num = (v.ax - u.ax) * v.ry - (v.ay - u.ay) * v.rx;
+				if(sign < 0) {
+					den.v = -den.v;
+					num.v = -num.v;
+				}
+				const SweepPoint r = {
+					u.ax * den + u.rx * num, u.ay * den + u.ry * num, den, s, t, 0
+				};
+				return r;
+			}
+			
+			/* The sign of cross(r_s, r_t), positive if t turns left from s */
+			int turn(std::uint32_t s, std::uint32_t t) const {
+				const SweepSegment<S> &u = segments[s], &v = segments[t];
+				const int sign = exact::sign(u.rx * v.ry - u.ry * v.rx);
+				if(sign != exact::Uncertain) {
+					return sign;
+				}
+				return exact::sign(exact::sub(exact::mul(rx(u), ry(v)),
+																			exact::mul(ry(u), rx(v))));
+			}
+			/* The side of segment s point p lies on, positive to the left */
+			int orient(std::uint32_t s, const SweepPoint &p) const {
+				if(!p.input() && (p.s == s || p.t == s)) {
+					return 0;
+				}
+				const SweepSegment<S> &u = segments[s];
+				const Approx d = u.rx * (p.y - u.ay * p.w) -
+					u.ry * (p.x - u.ax * p.w);
+				const int sign = exact::sign(d);
+				if(sign != exact::Uncertain) {
+					return sign;
+				}
+				Expansion x, y, w;
+				coordinates(p, x, y, w);
+				const Expansion dx = exact::sub(x, exact::mul(expansion(u.a.x), w));
+				const Expansion dy = exact::sub(y, exact::mul(expansion(u.a.y), w));
+				return exact::sign(exact::sub(exact::mul(rx(u), dy),
+																			exact::mul(ry(u), dx)));
+			}
+			/* The order of two points by x then y */
+			int compare(const SweepPoint &p, const SweepPoint &q) const {
+				if(p.input() && q.input()) {
+					const Point2<S> &a = point(p), &b = point(q);
+					if(a.x != b.x) {
+						return a.x < b.x ? -1 : 1;
+					}
+					return a.y < b.y ? -1 : (b.y < a.y ? 1 : 0);
+				} else if(!p.input() && !q.input() &&
+									std::min(p.s, p.t) == std::min(q.s, q.t) &&
+									std::max(p.s, p.t) == std::max(q.s, q.t)) {
+					return 0;
+				}
+				int sign = exact::sign(p.x * q.w - q.x * p.w);
+				if(sign == 0) {
+					sign = exact::sign(p.y * q.w - q.y * p.w);
+				}
+				if(sign != exact::Uncertain) {
+					return sign;
+				}
+				Expansion px, py, pw, qx, qy, qw;
+				coordinates(p, px, py, pw);
+				coordinates(q, qx, qy, qw);
+				sign = exact::sign(exact::sub(exact::mul(px, qw),
+																			exact::mul(qx, pw)));
+				if(sign == 0) {
+					sign = exact::sign(exact::sub(exact::mul(py, qw),
+																				exact::mul(qy, pw)));
+				}
+				return sign;
+			}
+			
+			/* The intersection point rounded to R */
+			template <typename R>
+			Point2<R> round(const SweepPoint &p) const {
+				if(p.input()) {
+					return Point2<R>(R(point(p).x), R(point(p).y));
+				}
+				return Point2<R>(R(p.x.v / p.w.v), R(p.y.v / p.w.v));
+			}
+			
+			const SweepSegment<S> *segments;
+			
+		private:
+			const Point2<S> & point(const SweepPoint &p) const {
+				return p.end ? segments[p.s].b : segments[p.s].a;
+			}
+			static Expansion expansion(S v) {
+				return exact::expansion(v);
+			}
+			static Expansion rx(const SweepSegment<S> &u) {
+				return exact::sub(expansion(u.b.x), expansion(u.a.x));
+			}
+			static Expansion ry(const SweepSegment<S> &u) {
+				return exact::sub(expansion(u.b.y), expansion(u.a.y));
+			}
+			void coordinates(const SweepPoint &p, Expansion &x, Expansion &y,
+											 Expansion &w) const
+			{
+				if(p.input()) {
+					x = expansion(point(p).x);
+					y = expansion(point(p).y);
+					w = Expansion(1, 1.0);
+					return;
+				}
+				const SweepSegment<S> &u = segments[p.s], &v = segments[p.t];
+				const Expansion urx = rx(u), ury = ry(u), vrx = rx(v), vry = ry(v);
+				w = exact::sub(exact::mul(urx, vry), exact::mul(ury, vrx));
+				Expansion num = exact::sub(
+					exact::mul(exact::sub(expansion(v.a.x), expansion(u.a.x)), vry),
+					exact::mul(exact::sub(expansion(v.a.y), expansion(u.a.y)), vrx));
+				if(exact::sign(w) < 0) {
+					w = exact::negate(w);
+					num = exact::negate(num);
+				}
+				x = exact::add(exact::mul(expansion(u.a.x), w), exact::mul(urx, num));
+				y = exact::add(exact::mul(expansion(u.a.y), w), exact::mul(ury, num));
+			}
+		};
+		
+		/*
+		 * Whether two segments intersect, setting o to the orientations of the
+		 * endpoints of t about s and of s about t.
+		 */
+		template <typename S>
+		bool segmentsIntersect(const SweepKernel<S> &k, std::uint32_t s,
+													 std::uint32_t t, int o[4])
+		{
+			o[0] = k.orient(s, k.endpoint(t, 0));
+			o[1] = k.orient(s, k.endpoint(t, 1));
+			if(o[0] * o[1] > 0) {
+				return false;
+			}
+			o[2] = k.orient(t, k.endpoint(s, 0));
+			o[3] = k.orient(t, k.endpoint(s, 1));
+			if(o[2] * o[3] > 0) {
+				return false;
+			}
+			if(o[0] == 0 && o[1] == 0) {
+				/* Collinear segments intersect if their ranges overlap */
+				const SweepPoint sa = k.endpoint(s, 0), sb = k.endpoint(s, 1);
+				const SweepPoint ta = k.endpoint(t, 0), tb = k.endpoint(t, 1);
+				return k.compare(sa, tb) <= 0 && k.compare(ta, sb) <= 0;
+			}
+			return true;
+		}
+		
+		/*
+		 * The Bentley-Ottmann sweep, after de Berg et al., "Computational
+		 * Geometry: Algorithms and Applications", chapter 2.
+		 *
+		 * A vertical sweep line moves over the events in the order of x then
+		 * y: the endpoints of the segments and the crossings of segments which
+		 * become adjacent. The status holds the segments cut by the sweep line
+		 * from bottom to top. At each event p, the segments containing p are
+		 * found in the status, reported, and put back in the order they have
+		 * just after p; only new neighbors are tested for crossings.
+		 *
+		 * The status is only ever compared against segments through the
+		 * current event p, which makes every comparison an orientation of p
+		 * or of two directions, and keeps all predicates exact.
+		 */
+		template <typename S>
+		class Sweep {
+		public:
+			typedef typename IntersectionScalar<S>::type R;
+			
+			Sweep(const Line2<S> *lines, std::size_t count,
+						std::vector<SegmentIntersection<S>> &out) :
+				kernel(nullptr), status(StatusLess(*this)),
+				crossings(EventLess(*this)), out(out)
+			{
+				segments.reserve(count);
+				for(std::size_t i = 0; i < count; ++i) {
+					segments.push_back(SweepSegment<S>(lines[i]));
+				}
+				kernel.segments = segments.data();
+				handles.resize(count, status.end());
+				flags.resize(count, 0);
+				endpoints.reserve(2 * count);
+				for(std::uint32_t i = 0; i < count; ++i) {
+					endpoints.push_back(kernel.endpoint(i, 0));
+					endpoints.push_back(kernel.endpoint(i, 1));
+				}
+				std::sort(endpoints.begin(), endpoints.end(),
+									[this](const SweepPoint &p, const SweepPoint &q) {
+										return kernel.compare(p, q) < 0;
+									});
+			}
+			
+			void run() {
+				std::size_t next = 0;
+				while(next < endpoints.size() || !crossings.empty()) {
+					if(crossings.empty() || (next < endpoints.size() &&
+																	 kernel.compare(endpoints[next],
+																									*crossings.begin()) <= 0)) {
+						current = endpoints[next];
+					} else {
+						current = *crossings.begin();
+					}
+					starting.clear();
+					for(; next < endpoints.size() &&
+								kernel.compare(endpoints[next], current) == 0; ++next) {
+						const SweepPoint &e = endpoints[next];
+						if(e.end == 0) {
+							starting.push_back(e.s);
+						} else {
+							flags[e.s] |= Ending;
+						}
+					}
+					while(!crossings.empty() &&
+								kernel.compare(*crossings.begin(), current) == 0) {
+						crossings.erase(crossings.begin());
+					}
+					handle();
+				}
+			}
+			
+		private:
+			enum Flag { Ending = 1, Starting = 2, Inserting = 4 };
+			static const std::uint32_t Probe = 0xffffffff;
+			
+			/*
+			 * The order of segments in the status below the sweep line, where
+			 * Probe stands for the current event point.
+			 */
+			struct StatusLess {
+				explicit StatusLess(const Sweep &sweep) : sweep(&sweep) { }
+				bool operator()(std::uint32_t s, std::uint32_t t) const {
+					const SweepKernel<S> &k = sweep->kernel;
+					const SweepPoint &p = sweep->current;
+					if(s == t) {
+						return false;
+					}
+					const bool si = s == Probe || (sweep->flags[s] & Inserting);
+					const bool ti = t == Probe || (sweep->flags[t] & Inserting);
+					if(si && ti) {
+						/* Both pass through p, the lower turns right of the other */
+						const int turn = k.turn(s, t);
+						return turn != 0 ? turn > 0 : s < t;
+					} else if(si) {
+						return k.orient(t, p) < 0;
+					}
+					return k.orient(s, p) > 0;
+				}
+				const Sweep *sweep;
+			};
+			struct EventLess {
+				explicit EventLess(const Sweep &sweep) : sweep(&sweep) { }
+				bool operator()(const SweepPoint &p, const SweepPoint &q) const {
+					return sweep->kernel.compare(p, q) < 0;
+				}
+				const Sweep *sweep;
+			};
+			typedef std::set<std::uint32_t, StatusLess> Status;
+			
+			void handle() {
+				/* The segments through p are contiguous in the status */
+				through.clear();
+				typename Status::iterator i = probe();
+				for(; i != status.end() && kernel.orient(*i, current) == 0; ++i) {
+					through.push_back(*i);
+				}
+				for(std::size_t j = 0; j < starting.size(); ++j) {
+					flags[starting[j]] |= Starting;
+				}
+				report();
+				
+				for(std::size_t j = 0; j < through.size(); ++j) {
+					status.erase(handles[through[j]]);
+					handles[through[j]] = status.end();
+				}
+				inserted.clear();
+				for(std::size_t j = 0; j < through.size(); ++j) {
+					if(!(flags[through[j]] & Ending)) {
+						inserted.push_back(through[j]);
+					}
+				}
+				for(std::size_t j = 0; j < starting.size(); ++j) {
+					if(!segments[starting[j]].degenerate()) {
+						inserted.push_back(starting[j]);
+					}
+				}
+				for(std::size_t j = 0; j < inserted.size(); ++j) {
+					flags[inserted[j]] |= Inserting;
+				}
+				for(std::size_t j = 0; j < inserted.size(); ++j) {
+					handles[inserted[j]] = status.insert(inserted[j]).first;
+				}
+				
+				if(inserted.empty()) {
+					const typename Status::iterator above = probe();
+					if(above != status.end() && above != status.begin()) {
+						findCrossing(*std::prev(above), *above);
+					}
+				} else {
+					for(std::size_t j = 0; j < inserted.size(); ++j) {
+						const typename Status::iterator h = handles[inserted[j]];
+						if(h != status.begin() && !(flags[*std::prev(h)] & Inserting)) {
+							findCrossing(*std::prev(h), *h);
+						}
+						const typename Status::iterator n = std::next(h);
+						if(n != status.end() && !(flags[*n] & Inserting)) {
+							findCrossing(*h, *n);
+						}
+					}
+				}
+				
+				for(std::size_t j = 0; j < through.size(); ++j) {
+					flags[through[j]] = 0;
+				}
+				for(std::size_t j = 0; j < starting.size(); ++j) {
+					flags[starting[j]] = 0;
+				}
+			}
+			
+			/* The first segment of the status not below the event point */
+			typename Status::iterator probe() {
+				return status.lower_bound(std::uint32_t(Probe));
+			}
+			
+			/*
+			 * Report every pair of segments through p, except collinear
+			 * overlapping pairs which were reported where the later of them
+			 * starts.
+			 */
+			void report() {
+				all.assign(through.begin(), through.end());
+				all.insert(all.end(), starting.begin(), starting.end());
+				if(all.size() < 2) {
+					return;
+				}
+				const Point2<R> point = kernel.template round<R>(current);
+				for(std::size_t j = 0; j < all.size(); ++j) {
+					for(std::size_t k = j + 1; k < all.size(); ++k) {
+						const std::uint32_t s = all[j], t = all[k];
+						if(!((flags[s] | flags[t]) & Starting) && kernel.turn(s, t) == 0) {
+							continue;
+						}
+						SegmentIntersection<S> r;
+						r.first = std::min(s, t);
+						r.second = std::max(s, t);
+						r.point = point;
+						out.push_back(r);
+					}
+				}
+			}
+			
+			/*
+			 * Queue the crossing of two neighbors beyond the sweep line. Where
+			 * an endpoint of one lies on the other, the endpoint event finds
+			 * both segments, so only proper crossings are queued.
+			 */
+			void findCrossing(std::uint32_t s, std::uint32_t t) {
+				const int turn = kernel.turn(s, t);
+				if(turn == 0) {
+					return;
+				}
+				int o[4];
+				if(!segmentsIntersect(kernel, s, t, o) || o[0] == 0 || o[1] == 0 ||
+					 o[2] == 0 || o[3] == 0) {
+					return;
+				}
+				const SweepPoint q = kernel.crossing(s, t, turn);
+				if(kernel.compare(q, current) > 0) {
+					crossings.insert(q);
+				}
+			}
+			
+			std::vector<SweepSegment<S>> segments;
+			SweepKernel<S> kernel;
+			Status status;
+			std::set<SweepPoint, EventLess> crossings;
+			std::vector<SweepPoint> endpoints;
+			std::vector<typename Status::iterator> handles;
+			std::vector<std::uint8_t> flags;
+			std::vector<std::uint32_t> starting, through, inserted, all;
+			SweepPoint current;
+			std::vector<SegmentIntersection<S>> &out;
+		};
+	}
+	
+	/**
+	 * \brief Test whether two segments intersect.
+	 *
+	 * The test is exact for integer and floating point coordinates, barring
+	 * overflow and underflow of double precision arithmetic.
+	 *
+	 * \arg \c a The first segment
+	 * \arg \c b The second segment
+	 * \arg \c point Receives a point both segments contain, as by
+	 * \c segmentIntersections, if they intersect
+	 * \return True if the segments have a point in common
+	 */
+	template <typename Scalar>
+	bool intersect(const Line2<Scalar> &a, const Line2<Scalar> &b,
+								 Point2<typename IntersectionScalar<Scalar>::type> &point)
+	{
+		typedef typename IntersectionScalar<Scalar>::type R;
+		const detail::SweepSegment<Scalar> segments[2] = { a, b };
+		const detail::SweepKernel<Scalar> k(segments);
+		int o[4];
+		if(!detail::segmentsIntersect(k, 0, 1, o)) {
+			return false;
+		}
+		if(o[0] == 0 && o[1] == 0) {
+			/* Collinear, the later start is the first common point */
+			const int c = k.compare(k.endpoint(0, 0), k.endpoint(1, 0));
+			point = k.template round<R>(k.endpoint(c < 0 ? 1 : 0, 0));
+		} else if(o[0] == 0 || o[1] == 0) {
+			point = k.template round<R>(k.endpoint(1, o[0] == 0 ? 0 : 1));
+		} else if(o[2] == 0 || o[3] == 0) {
+			point = k.template round<R>(k.endpoint(0, o[2] == 0 ? 0 : 1));
+		} else {
+			point = k.template round<R>(k.crossing(0, 1, k.turn(0, 1)));
+		}
+		return true;
+	}
+	
+	/**
+	 * \brief Find every intersecting pair of a set of segments.
+	 *
+	 * The Bentley-Ottmann sweep takes \f$O((n + k) \log n)\f$ time for n
+	 * segments with k intersecting pairs, against \f$O(n^2)\f$ for testing
+	 * every pair. All decisions are made with exact predicates, so any
+	 * input is handled, including segments sharing endpoints, overlapping
+	 * collinear segments, vertical segments, zero length segments and many
+	 * segments through one point; coordinates wider than 53 bits such as
+	 * those of \c Line2l are handled exactly too.
+	 *
+	 * \arg \c segments The segments
+	 * \arg \c count The number of segments
+	 * \arg \c out Receives one \c SegmentIntersection per intersecting pair,
+	 * in the order of their points by x then y
+	 */
+	template <typename Scalar>
+	void segmentIntersections(const Line2<Scalar> *segments, std::size_t count,
+														std::vector<SegmentIntersection<Scalar>> &out)
+	{
+		out.clear();
+		detail::Sweep<Scalar> sweep(segments, count, out);
+		sweep.run();
+	}
+}
+
+#endif
@@ -0,0 +1,826 @@
+/**
+ * \file Simd.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Instruction set detection for the SIMD code paths of the library
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_SIMD_HPP
+#define GEOM_SIMD_HPP
+
+/*
+ * The SIMD code paths are selected at compile time from the instruction sets
+ * the compiler has been told it may use (-msse4.1, -mavx, -march=native...).
+ * Every SIMD path has a portable scalar fallback, and defining GEOM_NO_SIMD
+ * before including any geom header forces the scalar fallbacks everywhere.
+ *
+ * GEOM_SSE2 - 4 float / 2 double lanes, always present on x86-64.
+ * GEOM_SSE41 - adds blends, rounding and dot product instructions.
+ * GEOM_AVX - 8 float / 4 double lanes.
+ * GEOM_AVX2 - 8 int32 lanes, where SSE2 has 4.
+ * GEOM_AVX512 - 16 float / 8 double lanes. Its pack types are not the
+ *   default \c Pack, since the wider registers lower the clock speed; only
+ *   kernels whose data fills a whole register, such as 4x4 matrix products,
+ *   or with enough arithmetic per element to make up for the lower clock
+ *   use them, through \c Wide.
+ */
+#ifndef GEOM_NO_SIMD
+#  if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define GEOM_SSE2 1
+#    include <emmintrin.h>
+#  endif
+#  if defined(GEOM_SSE2) && defined(__SSE4_1__)
+#    define GEOM_SSE41 1
+#    include <smmintrin.h>
+#  endif
+#  if defined(GEOM_SSE41) && defined(__AVX__)
+#    define GEOM_AVX 1
+#    include <immintrin.h>
+#  endif
+#  if defined(GEOM_AVX) && defined(__AVX2__)
+#    define GEOM_AVX2 1
+#  endif
+#  if defined(GEOM_AVX) && defined(__AVX512F__)
+#    define GEOM_AVX512 1
+#  endif
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+namespace geom {
+	/**
+	 * \brief Thin wrappers around SIMD registers.
+	 *
+	 * Each pack type holds \c width lanes of \c type and provides the
+	 * element-wise arithmetic, comparison and selection operations the batch
+	 * kernels of the library are written in terms of. Kernels are templates
+	 * over the pack type so that a single kernel serves every instruction set.
+	 *
+	 * Comparisons return a pack of the same type whose lanes are either all
+	 * bits set or all bits clear, suitable for \c select and \c movemask.
+	 * The AVX-512 packs return a bitmask instead, which supports the same
+	 * operations.
+	 *
+	 * The packs never fuse a multiply and an add themselves, so a packed
+	 * kernel produces results identical to the same expression evaluated one
+	 * lane at a time, provided the compiler does not contract the scalar
+	 * expression into fused multiply-adds either. GCC does when FMA
+	 * instructions are enabled (-mfma, -march=native), so lane-identical
+	 * results need -ffp-contract=off there, as the Makefile passes.
+	 */
+	namespace simd {
+		/**
+		 * \brief The widest pack available for the given scalar type.
+		 *
+		 * \c enabled is false when no SIMD path exists for the scalar type,
+		 * in which case \c type must not be used.
+		 */
+		template <typename Scalar>
+		struct Pack {
+			static const bool enabled = false;
+			typedef void type;
+		};
+		/**
+		 * \brief The widest pack for the given scalar type including the
+		 * AVX-512 packs, for kernels doing enough work per element to gain
+		 * from them. Without AVX-512 this is \c Pack.
+		 */
+		template <typename Scalar>
+		struct Wide : Pack<Scalar> { };
+		
+		/**
+		 * \brief A pack of a single lane, which is just the scalar.
+		 *
+		 * Instantiating a packed kernel with \c Single gives the scalar
+		 * remainder of a batch the exact sequence of operations of the packed
+		 * lanes, and a reference implementation when no pack type exists.
+		 * Comparisons return \c bool rather than a mask.
+		 */
+		template <typename Scalar>
+		struct Single {
+			typedef Scalar type;
+			static const std::size_t width = 1;
+			
+			Single() { }
+			Single(Scalar v) : v(v) { }
+			
+			static Single load(const Scalar *p) { return *p; }
+			/**
+			 * \brief Load the lanes from every \c stride values starting at
+			 * \c p, such as one member of consecutive structures.
+			 */
+			static Single load(const Scalar *p, std::size_t) { return *p; }
+			static Single set1(Scalar a) { return a; }
+			static Single zero() { return Scalar(0); }
+			void store(Scalar *p) const { *p = v; }
+			
+			Scalar v;
+		};
+		
+		template <typename S>
+		inline Single<S> operator+(Single<S> a, Single<S> b) { return a.v + b.v; }
+		template <typename S>
+		inline Single<S> operator-(Single<S> a, Single<S> b) { return a.v - b.v; }
+		template <typename S>
+		inline Single<S> operator*(Single<S> a, Single<S> b) { return a.v * b.v; }
+		template <typename S>
+		inline Single<S> operator/(Single<S> a, Single<S> b) { return a.v / b.v; }
+		template <typename S>
+		inline bool operator<(Single<S> a, Single<S> b) { return a.v < b.v; }
+		template <typename S>
+		inline bool operator<=(Single<S> a, Single<S> b) { return a.v <= b.v; }
+		template <typename S>
+		inline bool operator>(Single<S> a, Single<S> b) { return a.v > b.v; }
+		template <typename S>
+		inline bool operator>=(Single<S> a, Single<S> b) { return a.v >= b.v; }
+		template <typename S>
+		inline Single<S> sqrt(Single<S> a) { return std::sqrt(a.v); }
+		template <typename S>
+		inline Single<S> min(Single<S> a, Single<S> b) {
+			return a.v < b.v ? a.v : b.v;
+		}
+		template <typename S>
+		inline Single<S> max(Single<S> a, Single<S> b) {
+			return a.v > b.v ? a.v : b.v;
+		}
+		template <typename S>
+		inline Single<S> select(bool mask, Single<S> a, Single<S> b) {
+			return mask ? a : b;
+		}
+		/** \brief The bit of a single lane comparison, like the packed one */
+		inline int movemask(bool mask) { return mask; }
+		/**
+		 * \brief The index of the lowest set bit of a nonzero mask, such as
+		 * the movemasks of several packs shifted together, for visiting only
+		 * the lanes set.
+		 */
+		inline int lowestBit(std::uint64_t mask) {
+#if defined(__GNUC__)
+			return __builtin_ctzll(mask);
+#else
+			int i = 0;
+			for(; (mask & 1) == 0; mask >>= 1) {
+				++i;
+			}
+			return i;
+#endif
+		}
+		/*
+		 * Floating point selections are made on the bits, like the packed
+		 * versions, since the compiler may otherwise emit a branch which
+		 * mispredicts on data dependent masks.
+		 */
+		inline Single<float> select(bool mask, Single<float> a,
+																Single<float> b)
+		{
+			std::uint32_t ai, bi;
+			std::memcpy(&ai, &a.v, sizeof(ai));
+			std::memcpy(&bi, &b.v, sizeof(bi));
+			const std::uint32_t m = 0u - std::uint32_t(mask);
+			const std::uint32_t r = (ai & m) | (bi & ~m);
+			float v;
+			std::memcpy(&v, &r, sizeof(v));
+			return v;
+		}
+		inline Single<double> select(bool mask, Single<double> a,
+																 Single<double> b)
+		{
+			std::uint64_t ai, bi;
+			std::memcpy(&ai, &a.v, sizeof(ai));
+			std::memcpy(&bi, &b.v, sizeof(bi));
+			const std::uint64_t m = 0u - std::uint64_t(mask);
+			const std::uint64_t r = (ai & m) | (bi & ~m);
+			double v;
+			std::memcpy(&v, &r, sizeof(v));
+			return v;
+		}
+		
+#if defined(GEOM_SSE2)
+		struct Float4 {
+			typedef float type;
+			static const std::size_t width = 4;
+			
+			Float4() { }
+			Float4(__m128 v) : v(v) { }
+			
+			static Float4 load(const float *p) { return _mm_loadu_ps(p); }
+			static Float4 load(const float *p, std::size_t stride) {
+				return _mm_set_ps(p[3 * stride], p[2 * stride], p[stride], p[0]);
+			}
+			static Float4 set1(float s) { return _mm_set1_ps(s); }
+			static Float4 zero() { return _mm_setzero_ps(); }
+			void store(float *p) const { _mm_storeu_ps(p, v); }
+			
+			__m128 v;
+		};
+		
+		inline Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v,b.v); }
+		inline Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v,b.v); }
+		inline Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v,b.v); }
+		inline Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.v,b.v); }
+		inline Float4 operator<(Float4 a, Float4 b) {
+			return _mm_cmplt_ps(a.v,b.v);
+		}
+		inline Float4 operator<=(Float4 a, Float4 b) {
+			return _mm_cmple_ps(a.v,b.v);
+		}
+		inline Float4 operator>(Float4 a, Float4 b) {
+			return _mm_cmpgt_ps(a.v,b.v);
+		}
+		inline Float4 operator>=(Float4 a, Float4 b) {
+			return _mm_cmpge_ps(a.v,b.v);
+		}
+		inline Float4 operator==(Float4 a, Float4 b) {
+			return _mm_cmpeq_ps(a.v,b.v);
+		}
+		inline Float4 operator&(Float4 a, Float4 b) { return _mm_and_ps(a.v,b.v); }
+		inline Float4 operator|(Float4 a, Float4 b) { return _mm_or_ps(a.v,b.v); }
+		inline Float4 sqrt(Float4 a) { return _mm_sqrt_ps(a.v); }
+		/**
+		 * \brief Hardware estimate of \f$1/\sqrt{a}\f$
+		 *
+		 * The estimate has a relative error of at most \f$1.5 \cdot 2^{-12}\f$
+		 * and is not bit-reproducible across processor vendors; refine it with a
+		 * Newton-Raphson step where more precision is needed.
+		 */
+		inline Float4 rsqrt(Float4 a) { return _mm_rsqrt_ps(a.v); }
+		inline Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a.v,b.v); }
+		inline Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a.v,b.v); }
+		/** \brief Lanes of \c a where \c mask is set, otherwise of \c b */
+		inline Float4 select(Float4 mask, Float4 a, Float4 b) {
+#  if defined(GEOM_SSE41)
+			return _mm_blendv_ps(b.v, a.v, mask.v);
+#  else
+			return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+#  endif
+		}
+		/** \brief One bit per lane, set where the lane of \c mask is set */
+		inline int movemask(Float4 mask) { return _mm_movemask_ps(mask.v); }
+		
+		struct Double2 {
+			typedef double type;
+			static const std::size_t width = 2;
+			
+			Double2() { }
+			Double2(__m128d v) : v(v) { }
+			
+			static Double2 load(const double *p) { return _mm_loadu_pd(p); }
+			static Double2 load(const double *p, std::size_t stride) {
+				return _mm_set_pd(p[stride], p[0]);
+			}
+			static Double2 set1(double s) { return _mm_set1_pd(s); }
+			static Double2 zero() { return _mm_setzero_pd(); }
+			void store(double *p) const { _mm_storeu_pd(p, v); }
+			
+			__m128d v;
+		};
+		
+		inline Double2 operator+(Double2 a, Double2 b) {
+			return _mm_add_pd(a.v,b.v);
+		}
+		inline Double2 operator-(Double2 a, Double2 b) {
+			return _mm_sub_pd(a.v,b.v);
+		}
+		inline Double2 operator*(Double2 a, Double2 b) {
+			return _mm_mul_pd(a.v,b.v);
+		}
+		inline Double2 operator/(Double2 a, Double2 b) {
+			return _mm_div_pd(a.v,b.v);
+		}
+		inline Double2 operator<(Double2 a, Double2 b) {
+			return _mm_cmplt_pd(a.v,b.v);
+		}
+		inline Double2 operator<=(Double2 a, Double2 b) {
+			return _mm_cmple_pd(a.v,b.v);
+		}
+		inline Double2 operator>(Double2 a, Double2 b) {
+			return _mm_cmpgt_pd(a.v,b.v);
+		}
+		inline Double2 operator>=(Double2 a, Double2 b) {
+			return _mm_cmpge_pd(a.v,b.v);
+		}
+		inline Double2 operator==(Double2 a, Double2 b) {
+			return _mm_cmpeq_pd(a.v,b.v);
+		}
+		inline Double2 operator&(Double2 a, Double2 b) {
+			return _mm_and_pd(a.v,b.v);
+		}
+		inline Double2 operator|(Double2 a, Double2 b) {
+			return _mm_or_pd(a.v,b.v);
+		}
+		inline Double2 sqrt(Double2 a) { return _mm_sqrt_pd(a.v); }
+		inline Double2 min(Double2 a, Double2 b) { return _mm_min_pd(a.v,b.v); }
+		inline Double2 max(Double2 a, Double2 b) { return _mm_max_pd(a.v,b.v); }
+		inline Double2 select(Double2 mask, Double2 a, Double2 b) {
+#  if defined(GEOM_SSE41)
+			return _mm_blendv_pd(b.v, a.v, mask.v);
+#  else
+			return _mm_or_pd(_mm_and_pd(mask.v, a.v), _mm_andnot_pd(mask.v, b.v));
+#  endif
+		}
+		inline int movemask(Double2 mask) { return _mm_movemask_pd(mask.v); }
+		
+		/*
+		 * 32 bit integer lanes, which have no division or square root.
+		 * Products keep the low 32 bits, as scalar unsigned arithmetic does.
+		 */
+		struct Int4 {
+			typedef std::int32_t type;
+			static const std::size_t width = 4;
+			
+			Int4() { }
+			Int4(__m128i v) : v(v) { }
+			
+			static Int4 load(const std::int32_t *p) {
+				return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			}
+			static Int4 load(const std::int32_t *p, std::size_t stride) {
+				return _mm_set_epi32(p[3 * stride], p[2 * stride], p[stride], p[0]);
+			}
+			static Int4 set1(std::int32_t s) { return _mm_set1_epi32(s); }
+			static Int4 zero() { return _mm_setzero_si128(); }
+			void store(std::int32_t *p) const {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+			}
+			
+			__m128i v;
+		};
+		
+		inline Int4 operator+(Int4 a, Int4 b) { return _mm_add_epi32(a.v,b.v); }
+		inline Int4 operator-(Int4 a, Int4 b) { return _mm_sub_epi32(a.v,b.v); }
+		inline Int4 operator*(Int4 a, Int4 b) {
+#  if defined(GEOM_SSE41)
+			return _mm_mullo_epi32(a.v,b.v);
+#  else
+			const __m128i even = _mm_mul_epu32(a.v, b.v);
+			const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a.v, 32),
+																				_mm_srli_epi64(b.v, 32));
+			return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)),
+																_mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0)));
+#  endif
+		}
+		inline Int4 operator<(Int4 a, Int4 b) { return _mm_cmplt_epi32(a.v,b.v); }
+		inline Int4 operator>(Int4 a, Int4 b) { return _mm_cmpgt_epi32(a.v,b.v); }
+		inline Int4 operator<=(Int4 a, Int4 b) {
+			return _mm_xor_si128(_mm_cmpgt_epi32(a.v,b.v), _mm_set1_epi32(-1));
+		}
+		inline Int4 operator>=(Int4 a, Int4 b) {
+			return _mm_xor_si128(_mm_cmplt_epi32(a.v,b.v), _mm_set1_epi32(-1));
+		}
+		inline Int4 operator==(Int4 a, Int4 b) {
+			return _mm_cmpeq_epi32(a.v,b.v);
+		}
+		inline Int4 operator&(Int4 a, Int4 b) { return _mm_and_si128(a.v,b.v); }
+		inline Int4 operator|(Int4 a, Int4 b) { return _mm_or_si128(a.v,b.v); }
+		inline Int4 select(Int4 mask, Int4 a, Int4 b) {
+#  if defined(GEOM_SSE41)
+			return _mm_blendv_epi8(b.v, a.v, mask.v);
+#  else
+			return _mm_or_si128(_mm_and_si128(mask.v, a.v),
+													_mm_andnot_si128(mask.v, b.v));
+#  endif
+		}
+		inline Int4 min(Int4 a, Int4 b) {
+#  if defined(GEOM_SSE41)
+			return _mm_min_epi32(a.v,b.v);
+#  else
+			return select(a < b, a, b);
+#  endif
+		}
+		inline Int4 max(Int4 a, Int4 b) {
+#  if defined(GEOM_SSE41)
+			return _mm_max_epi32(a.v,b.v);
+#  else
+			return select(a > b, a, b);
+#  endif
+		}
+		inline int movemask(Int4 mask) {
+			return _mm_movemask_ps(_mm_castsi128_ps(mask.v));
+		}
+#endif
+		
+#if defined(GEOM_AVX)
+		struct Float8 {
+			typedef float type;
+			static const std::size_t width = 8;
+			
+			Float8() { }
+			Float8(__m256 v) : v(v) { }
+			
+			static Float8 load(const float *p) { return _mm256_loadu_ps(p); }
+			static Float8 load(const float *p, std::size_t stride) {
+				return _mm256_set_ps(p[7 * stride], p[6 * stride], p[5 * stride],
+														 p[4 * stride], p[3 * stride], p[2 * stride],
+														 p[stride], p[0]);
+			}
+			static Float8 set1(float s) { return _mm256_set1_ps(s); }
+			static Float8 zero() { return _mm256_setzero_ps(); }
+			void store(float *p) const { _mm256_storeu_ps(p, v); }
+			
+			__m256 v;
+		};
+		
+		inline Float8 operator+(Float8 a, Float8 b) {
+			return _mm256_add_ps(a.v,b.v);
+		}
+		inline Float8 operator-(Float8 a, Float8 b) {
+			return _mm256_sub_ps(a.v,b.v);
+		}
+		inline Float8 operator*(Float8 a, Float8 b) {
+			return _mm256_mul_ps(a.v,b.v);
+		}
+		inline Float8 operator/(Float8 a, Float8 b) {
+			return _mm256_div_ps(a.v,b.v);
+		}
+		inline Float8 operator<(Float8 a, Float8 b) {
+			return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ);
+		}
+		inline Float8 operator<=(Float8 a, Float8 b) {
+			return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ);
+		}
+		inline Float8 operator>(Float8 a, Float8 b) {
+			return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ);
+		}
+		inline Float8 operator>=(Float8 a, Float8 b) {
+			return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ);
+		}
+		inline Float8 operator==(Float8 a, Float8 b) {
+			return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ);
+		}
+		inline Float8 operator&(Float8 a, Float8 b) {
+			return _mm256_and_ps(a.v,b.v);
+		}
+		inline Float8 operator|(Float8 a, Float8 b) {
+			return _mm256_or_ps(a.v,b.v);
+		}
+		inline Float8 sqrt(Float8 a) { return _mm256_sqrt_ps(a.v); }
+		inline Float8 rsqrt(Float8 a) { return _mm256_rsqrt_ps(a.v); }
+		inline Float8 min(Float8 a, Float8 b) { return _mm256_min_ps(a.v,b.v); }
+		inline Float8 max(Float8 a, Float8 b) { return _mm256_max_ps(a.v,b.v); }
+		inline Float8 select(Float8 mask, Float8 a, Float8 b) {
+			return _mm256_blendv_ps(b.v, a.v, mask.v);
+		}
+		inline int movemask(Float8 mask) { return _mm256_movemask_ps(mask.v); }
+		
+		struct Double4 {
+			typedef double type;
+			static const std::size_t width = 4;
+			
+			Double4() { }
+			Double4(__m256d v) : v(v) { }
+			
+			static Double4 load(const double *p) { return _mm256_loadu_pd(p); }
+			static Double4 load(const double *p, std::size_t stride) {
+				return _mm256_set_pd(p[3 * stride], p[2 * stride], p[stride], p[0]);
+			}
+			static Double4 set1(double s) { return _mm256_set1_pd(s); }
+			static Double4 zero() { return _mm256_setzero_pd(); }
+			void store(double *p) const { _mm256_storeu_pd(p, v); }
+			
+			__m256d v;
+		};
+		
+		inline Double4 operator+(Double4 a, Double4 b) {
+			return _mm256_add_pd(a.v,b.v);
+		}
+		inline Double4 operator-(Double4 a, Double4 b) {
+			return _mm256_sub_pd(a.v,b.v);
+		}
+		inline Double4 operator*(Double4 a, Double4 b) {
+			return _mm256_mul_pd(a.v,b.v);
+		}
+		inline Double4 operator/(Double4 a, Double4 b) {
+			return _mm256_div_pd(a.v,b.v);
+		}
+		inline Double4 operator<(Double4 a, Double4 b) {
+			return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ);
+		}
+		inline Double4 operator<=(Double4 a, Double4 b) {
+			return _mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ);
+		}
+		inline Double4 operator>(Double4 a, Double4 b) {
+			return _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ);
+		}
+		inline Double4 operator>=(Double4 a, Double4 b) {
+			return _mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ);
+		}
+		inline Double4 operator==(Double4 a, Double4 b) {
+			return _mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ);
+		}
+		inline Double4 operator&(Double4 a, Double4 b) {
+			return _mm256_and_pd(a.v,b.v);
+		}
+		inline Double4 operator|(Double4 a, Double4 b) {
+			return _mm256_or_pd(a.v,b.v);
+		}
+		inline Double4 sqrt(Double4 a) { return _mm256_sqrt_pd(a.v); }
+		inline Double4 min(Double4 a, Double4 b) { return _mm256_min_pd(a.v,b.v); }
+		inline Double4 max(Double4 a, Double4 b) { return _mm256_max_pd(a.v,b.v); }
+		inline Double4 select(Double4 mask, Double4 a, Double4 b) {
+			return _mm256_blendv_pd(b.v, a.v, mask.v);
+		}
+		inline int movemask(Double4 mask) { return _mm256_movemask_pd(mask.v); }
+		
+		template <>
+		struct Pack<float> {
+			static const bool enabled = true;
+			typedef Float8 type;
+		};
+		template <>
+		struct Pack<double> {
+			static const bool enabled = true;
+			typedef Double4 type;
+		};
+#elif defined(GEOM_SSE2)
+		template <>
+		struct Pack<float> {
+			static const bool enabled = true;
+			typedef Float4 type;
+		};
+		template <>
+		struct Pack<double> {
+			static const bool enabled = true;
+			typedef Double2 type;
+		};
+#endif
+		
+#if defined(GEOM_AVX512)
+		/** \brief The comparison result of 16 lanes, one bit per lane */
+		struct Mask16 {
+			Mask16(__mmask16 v) : v(v) { }
+			
+			__mmask16 v;
+		};
+		inline Mask16 operator&(Mask16 a, Mask16 b) {
+			return __mmask16(a.v & b.v);
+		}
+		inline Mask16 operator|(Mask16 a, Mask16 b) {
+			return __mmask16(a.v | b.v);
+		}
+		inline int movemask(Mask16 mask) { return mask.v; }
+		
+		/** \brief The comparison result of 8 lanes, one bit per lane */
+		struct Mask8 {
+			Mask8(__mmask8 v) : v(v) { }
+			
+			__mmask8 v;
+		};
+		inline Mask8 operator&(Mask8 a, Mask8 b) { return __mmask8(a.v & b.v); }
+		inline Mask8 operator|(Mask8 a, Mask8 b) { return __mmask8(a.v | b.v); }
+		inline int movemask(Mask8 mask) { return mask.v; }
+		
+		struct Float16 {
+			typedef float type;
+			static const std::size_t width = 16;
+			
+			Float16() { }
+			Float16(__m512 v) : v(v) { }
+			
+			static Float16 load(const float *p) { return _mm512_loadu_ps(p); }
+			static Float16 load(const float *p, std::size_t stride) {
+				const __m512i lanes = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8,
+																							 7, 6, 5, 4, 3, 2, 1, 0);
+				const __m512i offsets =
+					_mm512_mullo_epi32(lanes, _mm512_set1_epi32(int(stride)));
+				/* The masked forms, since the others read undefined registers */
+				return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xffff, offsets,
+																				p, 4);
+			}
+			static Float16 set1(float s) { return _mm512_set1_ps(s); }
+			static Float16 zero() { return _mm512_setzero_ps(); }
+			void store(float *p) const { _mm512_storeu_ps(p, v); }
+			
+			__m512 v;
+		};
+		
+		inline Float16 operator+(Float16 a, Float16 b) {
+			return _mm512_add_ps(a.v,b.v);
+		}
+		inline Float16 operator-(Float16 a, Float16 b) {
+			return _mm512_sub_ps(a.v,b.v);
+		}
+		inline Float16 operator*(Float16 a, Float16 b) {
+			return _mm512_mul_ps(a.v,b.v);
+		}
+		inline Float16 operator/(Float16 a, Float16 b) {
+			return _mm512_div_ps(a.v,b.v);
+		}
+		inline Mask16 operator<(Float16 a, Float16 b) {
+			return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ);
+		}
+		inline Mask16 operator<=(Float16 a, Float16 b) {
+			return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ);
+		}
+		inline Mask16 operator>(Float16 a, Float16 b) {
+			return _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ);
+		}
+		inline Mask16 operator>=(Float16 a, Float16 b) {
+			return _mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ);
+		}
+		inline Mask16 operator==(Float16 a, Float16 b) {
+			return _mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ);
+		}
+		inline Float16 sqrt(Float16 a) { return _mm512_sqrt_ps(a.v); }
+		/* The masked forms, as for the gathers */
+		inline Float16 min(Float16 a, Float16 b) {
+			return _mm512_mask_min_ps(a.v, 0xffff, a.v, b.v);
+		}
+		inline Float16 max(Float16 a, Float16 b) {
+			return _mm512_mask_max_ps(a.v, 0xffff, a.v, b.v);
+		}
+		inline Float16 select(Mask16 mask, Float16 a, Float16 b) {
+			return _mm512_mask_blend_ps(mask.v, b.v, a.v);
+		}
+		
+		struct Double8 {
+			typedef double type;
+			static const std::size_t width = 8;
+			
+			Double8() { }
+			Double8(__m512d v) : v(v) { }
+			
+			static Double8 load(const double *p) { return _mm512_loadu_pd(p); }
+			static Double8 load(const double *p, std::size_t stride) {
+				const __m256i lanes = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+				const __m256i s = _mm256_set1_epi32(int(stride));
+				return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xff,
+																				_mm256_mullo_epi32(lanes, s), p, 8);
+			}
+			static Double8 set1(double s) { return _mm512_set1_pd(s); }
+			static Double8 zero() { return _mm512_setzero_pd(); }
+			void store(double *p) const { _mm512_storeu_pd(p, v); }
+			
+			__m512d v;
+		};
+		
+		inline Double8 operator+(Double8 a, Double8 b) {
+			return _mm512_add_pd(a.v,b.v);
+		}
+		inline Double8 operator-(Double8 a, Double8 b) {
+			return _mm512_sub_pd(a.v,b.v);
+		}
+		inline Double8 operator*(Double8 a, Double8 b) {
+			return _mm512_mul_pd(a.v,b.v);
+		}
+		inline Double8 operator/(Double8 a, Double8 b) {
+			return _mm512_div_pd(a.v,b.v);
+		}
+		inline Mask8 operator<(Double8 a, Double8 b) {
+			return _mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ);
+		}
+		inline Mask8 operator<=(Double8 a, Double8 b) {
+			return _mm512_cmp_pd_mask(a.v, b.v, _CMP_LE_OQ);
+		}
+		inline Mask8 operator>(Double8 a, Double8 b) {
+			return _mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ);
+		}
+		inline Mask8 operator>=(Double8 a, Double8 b) {
+			return _mm512_cmp_pd_mask(a.v, b.v, _CMP_GE_OQ);
+		}
+		inline Mask8 operator==(Double8 a, Double8 b) {
+			return _mm512_cmp_pd_mask(a.v, b.v, _CMP_EQ_OQ);
+		}
+		inline Double8 sqrt(Double8 a) { return _mm512_sqrt_pd(a.v); }
+		inline Double8 min(Double8 a, Double8 b) {
+			return _mm512_mask_min_pd(a.v, 0xff, a.v, b.v);
+		}
+		inline Double8 max(Double8 a, Double8 b) {
+			return _mm512_mask_max_pd(a.v, 0xff, a.v, b.v);
+		}
+		inline Double8 select(Mask8 mask, Double8 a, Double8 b) {
+			return _mm512_mask_blend_pd(mask.v, b.v, a.v);
+		}
+		
+		template <>
+		struct Wide<float> {
+			static const bool enabled = true;
+			typedef Float16 type;
+		};
+		template <>
+		struct Wide<double> {
+			static const bool enabled = true;
+			typedef Double8 type;
+		};
+#endif
+		
+#if defined(GEOM_AVX2)
+		struct Int8 {
+			typedef std::int32_t type;
+			static const std::size_t width = 8;
+			
+			Int8() { }
+			Int8(__m256i v) : v(v) { }
+			
+			static Int8 load(const std::int32_t *p) {
+				return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			}
+			static Int8 load(const std::int32_t *p, std::size_t stride) {
+				return _mm256_set_epi32(p[7 * stride], p[6 * stride], p[5 * stride],
+																p[4 * stride], p[3 * stride], p[2 * stride],
+																p[stride], p[0]);
+			}
+			static Int8 set1(std::int32_t s) { return _mm256_set1_epi32(s); }
+			static Int8 zero() { return _mm256_setzero_si256(); }
+			void store(std::int32_t *p) const {
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+			}
+			
+			__m256i v;
+		};
+		
+		inline Int8 operator+(Int8 a, Int8 b) {
+			return _mm256_add_epi32(a.v,b.v);
+		}
+		inline Int8 operator-(Int8 a, Int8 b) {
+			return _mm256_sub_epi32(a.v,b.v);
+		}
+		inline Int8 operator*(Int8 a, Int8 b) {
+			return _mm256_mullo_epi32(a.v,b.v);
+		}
+		inline Int8 operator<(Int8 a, Int8 b) {
+			return _mm256_cmpgt_epi32(b.v,a.v);
+		}
+		inline Int8 operator>(Int8 a, Int8 b) {
+			return _mm256_cmpgt_epi32(a.v,b.v);
+		}
+		inline Int8 operator<=(Int8 a, Int8 b) {
+			return _mm256_xor_si256(_mm256_cmpgt_epi32(a.v,b.v),
+															_mm256_set1_epi32(-1));
+		}
+		inline Int8 operator>=(Int8 a, Int8 b) {
+			return _mm256_xor_si256(_mm256_cmpgt_epi32(b.v,a.v),
+															_mm256_set1_epi32(-1));
+		}
+		inline Int8 operator==(Int8 a, Int8 b) {
+			return _mm256_cmpeq_epi32(a.v,b.v);
+		}
+		inline Int8 operator&(Int8 a, Int8 b) {
+			return _mm256_and_si256(a.v,b.v);
+		}
+		inline Int8 operator|(Int8 a, Int8 b) {
+			return _mm256_or_si256(a.v,b.v);
+		}
+		inline Int8 min(Int8 a, Int8 b) { return _mm256_min_epi32(a.v,b.v); }
+		inline Int8 max(Int8 a, Int8 b) { return _mm256_max_epi32(a.v,b.v); }
+		inline Int8 select(Int8 mask, Int8 a, Int8 b) {
+			return _mm256_blendv_epi8(b.v, a.v, mask.v);
+		}
+		inline int movemask(Int8 mask) {
+			return _mm256_movemask_ps(_mm256_castsi256_ps(mask.v));
+		}
+		
+		template <>
+		struct Pack<std::int32_t> {
+			static const bool enabled = true;
+			typedef Int8 type;
+		};
+#elif defined(GEOM_SSE2)
+		template <>
+		struct Pack<std::int32_t> {
+			static const bool enabled = true;
+			typedef Int4 type;
+		};
+#endif
+		
+		/**
+		 * \brief Estimate of \f$1/\sqrt{a}\f$ for a single float.
+		 *
+		 * Uses the same instruction as the packed \c rsqrt so that scalar
+		 * remainders of batch kernels match the packed lanes; without SSE the
+		 * exact value is returned.
+		 */
+		inline float rsqrt(float a) {
+#if defined(GEOM_SSE2)
+			return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(a)));
+#else
+			return 1.0f / std::sqrt(a);
+#endif
+		}
+	}
+}
+
+#endif
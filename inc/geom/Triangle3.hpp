@@ -0,0 +1,500 @@
+/**
+ * \file Triangle3.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Definition of the Triangle3 structure and ray-triangle intersection
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_TRIANGLE_3_HPP
+#define GEOM_TRIANGLE_3_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "Point3.hpp"
+#include "Point3SoA.hpp"
+#include "Ray3.hpp"
+#include "Simd.hpp"
+#include "Vector3.hpp"
+
+namespace geom {
+	/**
+	 * \brief A triangle in 3 dimensional space, given by its vertices.
+	 *
+	 * Points of the triangle are written in barycentric coordinates as
+	 * \f$(1 - u - v) \cdot a + u \cdot b + v \cdot c\f$, with \f$u, v \ge 0\f$
+	 * and \f$u + v \le 1\f$. The vertices are counterclockwise when viewed
+	 * from the side its normal points to.
+	 */
+	template <typename Scalar>
+	struct Triangle3 {
+		/**
+		 * \brief Construct a \c Triangle3 object with every vertex at the
+		 * origin.
+		 */
+		constexpr Triangle3() :
+			a(), b(), c()
+		{ }
+		/**
+		 * \brief Construct a \c Triangle3 object from its vertices.
+		 */
+		constexpr Triangle3(const Point3<Scalar> &a, const Point3<Scalar> &b,
+												const Point3<Scalar> &c) :
+			a(a), b(b), c(c)
+		{ }
+		/**
+		 * \brief Construct a \c Triangle3 object which is a conversion of the
+		 * given \c Triangle3 object.
+		 * \arg \c source The \c Triangle3 object to convert
+		 */
+		template <typename Other>
+		constexpr Triangle3(const Triangle3<Other> &source) :
+			a(source.a), b(source.b), c(source.c)
+		{ }
+		
+		Point3<Scalar> a; /**< The first vertex */
+		Point3<Scalar> b; /**< The second vertex */
+		Point3<Scalar> c; /**< The third vertex */
+	};
+	
+	typedef Triangle3<std::int32_t> Triangle3i;
+	typedef Triangle3<std::int64_t> Triangle3l;
+	typedef Triangle3<float> Triangle3f;
+	typedef Triangle3<double> Triangle3d;
+	
+	/**
+	 * \brief Compare two triangles for equality of their vertices in order.
+	 */
+	template <typename LType, typename RType>
+	bool operator==(const Triangle3<LType> &lhs, const Triangle3<RType> &rhs) {
+		return lhs.a.x == rhs.a.x && lhs.a.y == rhs.a.y && lhs.a.z == rhs.a.z &&
+			lhs.b.x == rhs.b.x && lhs.b.y == rhs.b.y && lhs.b.z == rhs.b.z &&
+			lhs.c.x == rhs.c.x && lhs.c.y == rhs.c.y && lhs.c.z == rhs.c.z;
+	}
+	/**
+	 * \brief Compare two triangles for inequality of their vertices.
+	 */
+	template <typename LType, typename RType>
+	bool operator!=(const Triangle3<LType> &lhs, const Triangle3<RType> &rhs) {
+		return !(lhs == rhs);
+	}
+	
+	/**
+	 * \brief Get the normal of a triangle, the cross product of its edges
+	 * from a to b and from a to c.
+	 * \return A vector whose length is twice the area of the triangle
+	 */
+	template <typename Scalar>
+	Vector3<Scalar> normal(const Triangle3<Scalar> &tri) {
+		const Scalar ux = tri.b.x - tri.a.x, uy = tri.b.y - tri.a.y,
+			uz = tri.b.z - tri.a.z;
+		const Scalar vx = tri.c.x - tri.a.x, vy = tri.c.y - tri.a.y,
+			vz = tri.c.z - tri.a.z;
+		return Vector3<Scalar>(uy * vz - uz * vy, uz * vx - ux * vz,
+													 ux * vy - uy * vx);
+	}
+	
+	/**
+	 * \brief A container of \c Triangle3 values stored as separate coordinate
+	 * arrays of each vertex, the fastest form for the batch intersection
+	 * below.
+	 */
+	template <typename Scalar>
+	struct Triangle3SoA {
+		/**
+		 * \brief Construct an empty \c Triangle3SoA
+		 */
+		Triangle3SoA() { }
+		/**
+		 * \brief Construct a \c Triangle3SoA from an array of \c Triangle3
+		 * objects.
+		 * \arg \c source The array of triangles to convert from
+		 * \arg \c count The number of triangles in source
+		 */
+		template <typename Other>
+		Triangle3SoA(const Triangle3<Other> *source, std::size_t count) :
+			a(count), b(count), c(count)
+		{
+			for(std::size_t i = 0; i < count; ++i) {
+				set(i, source[i]);
+			}
+		}
+		
+		/**
+		 * \brief Get the number of triangles held
+		 */
+		std::size_t size() const {
+			return a.size();
+		}
+		/**
+		 * \brief Change the number of triangles held, new triangles have every
+		 * vertex at the origin
+		 * \arg \c count The new number of triangles
+		 */
+		void resize(std::size_t count) {
+			a.resize(count);
+			b.resize(count);
+			c.resize(count);
+		}
+		/**
+		 * \brief Reserve storage for the given number of triangles
+		 */
+		void reserve(std::size_t count) {
+			a.reserve(count);
+			b.reserve(count);
+			c.reserve(count);
+		}
+		/**
+		 * \brief Remove all triangles
+		 */
+		void clear() {
+			a.clear();
+			b.clear();
+			c.clear();
+		}
+		/**
+		 * \brief Append a triangle to the end of the container
+		 */
+		template <typename Other>
+		void push_back(const Triangle3<Other> &tri) {
+			a.push_back(tri.a);
+			b.push_back(tri.b);
+			c.push_back(tri.c);
+		}
+		
+		/**
+		 * \brief Gather the triangle at the given index
+		 */
+		Triangle3<Scalar> operator[](std::size_t i) const {
+			return Triangle3<Scalar>(a[i], b[i], c[i]);
+		}
+		/**
+		 * \brief Scatter a triangle into the given index
+		 */
+		template <typename Other>
+		void set(std::size_t i, const Triangle3<Other> &tri) {
+			a.set(i, tri.a);
+			b.set(i, tri.b);
+			c.set(i, tri.c);
+		}
+		
+		Point3SoA<Scalar> a; /**< The first vertex of each triangle */
+		Point3SoA<Scalar> b; /**< The second vertex of each triangle */
+		Point3SoA<Scalar> c; /**< The third vertex of each triangle */
+	};
+	
+	typedef Triangle3SoA<float> Triangle3SoAf;
+	typedef Triangle3SoA<double> Triangle3SoAd;
+	
+	/**
+	 * \brief The nearest intersection of a ray with an array of triangles.
+	 *
+	 * The point hit is \f$ray.at(t)\f$, which is also
+	 * \f$(1 - u - v) \cdot a + u \cdot b + v \cdot c\f$ of the triangle hit.
+	 */
+	template <typename Scalar>
+	struct TriangleHit {
+		Scalar t; /**< The distance along the ray */
+		Scalar u; /**< The barycentric coordinate of vertex b */
+		Scalar v; /**< The barycentric coordinate of vertex c */
+		std::size_t index; /**< The index of the triangle hit */
+	};
+	
+	namespace detail {
+		/*
+		 * The Moller-Trumbore test of one ray against P::width triangles,
+		 * solving origin + t * direction = a + u * (b - a) + v * (c - a) by
+		 * Cramer's rule. Triangles are hit from either side. The division by
+		 * the determinant would cost more than the rest of the test, so t, u
+		 * and v are compared, and returned, multiplied by its absolute value
+		 * det; only the rare hits are divided. A degenerate triangle, or one
+		 * the ray lies in the plane of, has a zero determinant, which leaves
+		 * no scaled distance in [0, det * tMax), so it is never hit.
+		 */
+		template <typename P>
+		auto mollerTrumbore(P ox, P oy, P oz, P dx, P dy, P dz, P ax, P ay,
+												P az, P bx, P by, P bz, P cx, P cy, P cz, P tMax,
+												P &t, P &u, P &v, P &det) -> decltype(P() <= P())
+		{
+			const P e1x = bx - ax, e1y = by - ay, e1z = bz - az;
+			const P e2x = cx - ax, e2y = cy - ay, e2z = cz - az;
+			const P px = dy * e2z - dz * e2y;
+			const P py = dz * e2x - dx * e2z;
+			const P pz = dx * e2y - dy * e2x;
+			typedef typename P::type S;
+			const P zero = P::zero();
+			const P d = e1x * px + e1y * py + e1z * pz;
+			const P sign = simd::select(d < zero, P::set1(S(-1)), P::set1(S(1)));
+			const P sx = ox - ax, sy = oy - ay, sz = oz - az;
+			const P qx = sy * e1z - sz * e1y;
+			const P qy = sz * e1x - sx * e1z;
+			const P qz = sx * e1y - sy * e1x;
+			det = d * sign;
+			u = (sx * px + sy * py + sz * pz) * sign;
+			v = (dx * qx + dy * qy + dz * qz) * sign;
+			t = (e2x * qx + e2y * qy + e2z * qz) * sign;
+			return (u >= zero) & (v >= zero) & (u + v <= det) & (t >= zero) &
+				(t < tMax * det);
+		}
+		
+		/*
+		 * The sources of triangles below test the P::width triangles from
+		 * index i, setting their scaled distances, barycentric coordinates
+		 * and determinants and returning a hit mask.
+		 */
+		template <typename S>
+		struct RayTriangleArrays {
+			Ray3<S> ray;
+			Point3Span<const S> a, b, c;
+			
+			template <typename P>
+			auto hit(std::size_t i, P tMax, P &t, P &u, P &v, P &det) const
+				-> decltype(P() <= P())
+			{
+				return mollerTrumbore(
+					P::set1(ray.origin.x), P::set1(ray.origin.y),
+					P::set1(ray.origin.z), P::set1(ray.direction.x),
+					P::set1(ray.direction.y), P::set1(ray.direction.z),
+					P::load(a.x + i), P::load(a.y + i), P::load(a.z + i),
+					P::load(b.x + i), P::load(b.y + i), P::load(b.z + i),
+					P::load(c.x + i), P::load(c.y + i), P::load(c.z + i), tMax,
+					t, u, v, det);
+			}
+		};
+		/*
+		 * Triangle3 objects are loaded one vertex coordinate of P::width
+		 * consecutive triangles per register.
+		 */
+		template <typename S>
+		struct RayTriangleObjects {
+			Ray3<S> ray;
+			const Triangle3<S> *triangles;
+			
+			template <typename P>
+			auto hit(std::size_t i, P tMax, P &t, P &u, P &v, P &det) const
+				-> decltype(P() <= P())
+			{
+				const std::size_t s = sizeof(Triangle3<S>) / sizeof(S);
+				const Triangle3<S> &tri = triangles[i];
+				return mollerTrumbore(
+					P::set1(ray.origin.x), P::set1(ray.origin.y),
+					P::set1(ray.origin.z), P::set1(ray.direction.x),
+					P::set1(ray.direction.y), P::set1(ray.direction.z),
+					P::load(&tri.a.x, s), P::load(&tri.a.y, s), P::load(&tri.a.z, s),
+					P::load(&tri.b.x, s), P::load(&tri.b.y, s), P::load(&tri.b.z, s),
+					P::load(&tri.c.x, s), P::load(&tri.c.y, s), P::load(&tri.c.z, s),
+					tMax, t, u, v, det);
+			}
+		};
+		
+		/*
+		 * Test the triangles [first, n) a whole pack at a time, returning the
+		 * index of the first triangle not tested. Hits are rare, so the lanes
+		 * which hit are divided and merged into the nearest hit one at a time,
+		 * in index order so that the first of equally near triangles wins, and
+		 * the distance limit of the lanes is lowered to the nearest hit.
+		 */
+		template <typename P, typename Triangles, typename S>
+		std::size_t nearestPacked(const Triangles &triangles, std::size_t first,
+															std::size_t n, TriangleHit<S> &hit)
+		{
+			std::size_t i = first;
+			P tMax = P::set1(hit.t);
+			for(; i + P::width <= n; i += P::width) {
+				P t, u, v, det;
+				int bits = simd::movemask(
+					triangles.template hit<P>(i, tMax, t, u, v, det));
+				if(bits == 0) {
+					continue;
+				}
+				S ts[P::width], us[P::width], vs[P::width], dets[P::width];
+				t.store(ts);
+				u.store(us);
+				v.store(vs);
+				det.store(dets);
+				for(std::size_t j = 0; bits != 0; ++j, bits >>= 1) {
+					if((bits & 1) == 0) {
+						continue;
+					}
+					const S inverse = S(1) / dets[j];
+					if(ts[j] * inverse < hit.t) {
+						hit.t = ts[j] * inverse;
+						hit.u = us[j] * inverse;
+						hit.v = vs[j] * inverse;
+						hit.index = i + j;
+					}
+				}
+				tMax = P::set1(hit.t);
+			}
+			return i;
+		}
+		
+		/*
+		 * The ray-triangle test does enough arithmetic per triangle to gain
+		 * from the AVX-512 packs where they exist.
+		 */
+		template <typename Triangles, typename S>
+		std::size_t nearestBatch(const Triangles &, std::size_t, TriangleHit<S> &)
+		{
+			return 0;
+		}
+#if defined(GEOM_SSE2)
+		template <typename Triangles>
+		std::size_t nearestBatch(const Triangles &triangles, std::size_t n,
+														 TriangleHit<float> &hit)
+		{
+			return nearestPacked<simd::Wide<float>::type>(triangles, 0, n, hit);
+		}
+		template <typename Triangles>
+		std::size_t nearestBatch(const Triangles &triangles, std::size_t n,
+														 TriangleHit<double> &hit)
+		{
+			return nearestPacked<simd::Wide<double>::type>(triangles, 0, n, hit);
+		}
+#endif
+		
+		template <typename S, typename Triangles>
+		bool nearest(const Triangles &triangles, std::size_t n, S tMax,
+								 TriangleHit<S> &hit)
+		{
+			hit.t = tMax;
+			hit.u = hit.v = S(0);
+			hit.index = n;
+			const std::size_t i = nearestBatch(triangles, n, hit);
+			nearestPacked<simd::Single<S>>(triangles, i, n, hit);
+			return hit.index != n;
+		}
+	}
+	
+	/**
+	 * \brief Intersect a ray with a triangle by the Moller-Trumbore test.
+	 *
+	 * The triangle is hit from either side. Rays lying in the plane of the
+	 * triangle and degenerate triangles are never hit; rays through an edge
+	 * or vertex may be reported either way, depending on rounding.
+	 *
+	 * \arg \c ray The ray
+	 * \arg \c tri The triangle
+	 * \arg \c hit Receives the distance and the barycentric coordinates of
+	 * the point hit, with an index of 0, when the ray hits
+	 * \arg \c tMax The distance from which hits are ignored
+	 * \return True if the ray hits the triangle at a distance in [0, tMax)
+	 */
+	template <typename Scalar>
+	bool intersect(const Ray3<Scalar> &ray, const Triangle3<Scalar> &tri,
+								 TriangleHit<Scalar> &hit,
+								 Scalar tMax = std::numeric_limits<Scalar>::infinity())
+	{
+		static_assert(std::is_floating_point<Scalar>::value,
+									"The ray-triangle test needs a floating point type");
+		const detail::RayTriangleObjects<Scalar> triangles = { ray, &tri };
+		TriangleHit<Scalar> h;
+		if(!detail::nearest(triangles, 1, tMax, h)) {
+			return false;
+		}
+		hit = h;
+		return true;
+	}
+	
+	/*
+	 * Batch ray-triangle tests.
+	 *
+	 * Each kernel finds the nearest triangle of its input hit by a ray, as
+	 * by the single \c intersect, with the lowest index among equally near
+	 * triangles. When no triangle is hit before tMax, the hit receives a
+	 * distance of tMax and an index equal to the number of triangles. Float
+	 * and double triangles are tested 4, 8 or 16 at a time with SSE, AVX or
+	 * AVX-512 instructions, see Simd.hpp, giving results identical to the
+	 * single test.
+	 */
+	
+	/**
+	 * \brief Find the nearest triangle of an array hit by a ray.
+	 * \arg \c ray The ray
+	 * \arg \c triangles The triangles
+	 * \arg \c count The number of triangles
+	 * \arg \c tMax The distance from which hits are ignored
+	 * \arg \c hit Receives the nearest hit
+	 * \return True if any triangle is hit
+	 */
+	template <typename Scalar>
+	bool intersect(const Ray3<Scalar> &ray, const Triangle3<Scalar> *triangles,
+								 std::size_t count, Scalar tMax, TriangleHit<Scalar> &hit)
+	{
+		static_assert(std::is_floating_point<Scalar>::value,
+									"The ray-triangle test needs a floating point type");
+		const detail::RayTriangleObjects<Scalar> tris = { ray, triangles };
+		return detail::nearest(tris, count, tMax, hit);
+	}
+	
+	/**
+	 * \brief Find the nearest triangle hit by a ray, of triangles held as
+	 * arrays of vertex coordinates, which is the fastest form to test.
+	 * \arg \c ray The ray
+	 * \arg \c a The first vertex of each triangle
+	 * \arg \c b The second vertex of each triangle, at least as many as
+	 * there are first vertices
+	 * \arg \c c The third vertex of each triangle, at least as many as there
+	 * are first vertices
+	 * \arg \c tMax The distance from which hits are ignored
+	 * \arg \c hit Receives the nearest hit
+	 * \return True if any triangle is hit
+	 */
+	template <typename Scalar, typename AScalar, typename BScalar,
+						typename CScalar>
+	bool intersect(const Ray3<Scalar> &ray, Point3Span<AScalar> a,
+								 Point3Span<BScalar> b, Point3Span<CScalar> c, Scalar tMax,
+								 TriangleHit<Scalar> &hit)
+	{
+		static_assert(std::is_floating_point<Scalar>::value,
+									"The ray-triangle test needs a floating point type");
+		static_assert(std::is_same<typename Point3Span<AScalar>::type,
+															 Scalar>::value &&
+									std::is_same<typename Point3Span<BScalar>::type,
+															 Scalar>::value &&
+									std::is_same<typename Point3Span<CScalar>::type,
+															 Scalar>::value,
+									"The triangles must have the scalar type of the ray");
+		const detail::RayTriangleArrays<Scalar> tris = { ray, a, b, c };
+		return detail::nearest(tris, a.count, tMax, hit);
+	}
+	
+	/**
+	 * \brief Find the nearest triangle of a \c Triangle3SoA hit by a ray.
+	 * \see intersect(const Ray3<Scalar>&, Point3Span<AScalar>,
+	 * Point3Span<BScalar>, Point3Span<CScalar>, Scalar, TriangleHit<Scalar>&)
+	 */
+	template <typename Scalar>
+	bool intersect(const Ray3<Scalar> &ray,
+								 const Triangle3SoA<Scalar> &triangles, Scalar tMax,
+								 TriangleHit<Scalar> &hit)
+	{
+		return intersect(ray, triangles.a.span(), triangles.b.span(),
+										 triangles.c.span(), tMax, hit);
+	}
+}
+
+#endif
@@ -32,6 +32,7 @@
 #include <cstdint>
 #include <cmath>
 
+#include "Simd.hpp"
 #include "VectorTraits.hpp"
 
 namespace geom {
@@ -423,6 +424,32 @@ namespace geom {
 		return source / length(source);
 	}
 	
+	/**
+	 * \brief Normalize the \c Vector3 object using a reciprocal square root
+	 * estimate.
+	 * 
+	 * The hardware estimate of \f$1/|v|\f$ is refined with one Newton-Raphson
+	 * step and the components are multiplied by it, avoiding the square root
+	 * and the three divisions of \c normalize.
+	 * 
+	 * Precision contract: every component of the result differs from the
+	 * corresponding component of \c normalize(source) by at most 1e-6 (the
+	 * result has unit length to within 1e-6), provided the squared length of
+	 * \c source is a normal float, i.e. its length lies between 1e-18 and
+	 * 1e18. As with \c normalize, the zero vector gives NaN components.
+	 * The exact bits may differ between processor vendors.
+	 * 
+	 * \arg \c source The \c Vector3 object to normalize.
+	 * \return A new \c Vector3 object which is normalized.
+	 */
+	inline Vector3<float> normalizeFast(const Vector3<float> &source) {
+		const float d = source.x * source.x + source.y * source.y +
+			source.z * source.z;
+		const float r = simd::rsqrt(d);
+		const float s = r * (1.5f - 0.5f * d * r * r);
+		return Vector3<float>(source.x * s, source.y * s, source.z * s);
+	}
+	
 	/**
 	 * \brief Calculate refracted vector.
 	 * 
@@ -455,7 +482,7 @@ namespace geom {
 		R dot_ni = dot(n, i);
 		R k = 1.0 - eta * eta * (1.0 - dot_ni * dot_ni);
 		if(k < 0.0) {
-			return Vector3<R>(0.0, 0.0);
+			return Vector3<R>(0.0, 0.0, 0.0);
 		}else {
 			return (eta * i - (eta * dot_ni + std::sqrt(k)) * n);
 		}
@@ -0,0 +1,500 @@
+/**
+ * \file Vector3SoA.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Structure-of-arrays storage for Vector3 and batch vector kernels
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_VECTOR_3_SOA_HPP
+#define GEOM_VECTOR_3_SOA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "Simd.hpp"
+#include "Vector3.hpp"
+
+namespace geom {
+	/**
+	 * \brief A non-owning view of \c Vector3 values stored as three separate
+	 * component arrays.
+	 *
+	 * The batch kernels below operate on views rather than on \c Vector3SoA
+	 * directly so that they can be run over any x/y/z arrays, including sub
+	 * ranges of a larger container. A view of \c const components is used for
+	 * read-only access.
+	 */
+	template <typename Scalar>
+	struct Vector3Span {
+		typedef typename std::remove_const<Scalar>::type type;
+
+		/**
+		 * \brief Construct an empty \c Vector3Span
+		 */
+		Vector3Span() :
+			x(nullptr), y(nullptr), z(nullptr), count(0)
+		{ }
+		/**
+		 * \brief Construct a \c Vector3Span over the given component arrays
+		 * \arg \c x The array of x components
+		 * \arg \c y The array of y components
+		 * \arg \c z The array of z components
+		 * \arg \c count The number of vectors in each array
+		 */
+		Vector3Span(Scalar *x, Scalar *y, Scalar *z, std::size_t count) :
+			x(x), y(y), z(z), count(count)
+		{ }
+		/**
+		 * \brief Construct a \c Vector3Span viewing the same arrays as the given
+		 * \c Vector3Span, used to convert a mutable view to a \c const one.
+		 * \arg \c source The \c Vector3Span to view
+		 */
+		template <typename Other>
+		Vector3Span(const Vector3Span<Other> &source) :
+			x(source.x), y(source.y), z(source.z), count(source.count)
+		{ }
+
+		/**
+		 * \brief Gather the vector at the given index
+		 * \arg \c i The index of the vector
+		 * \return A \c Vector3 object holding the components at index i
+		 */
+		Vector3<type> operator[](std::size_t i) const {
+			return Vector3<type>(x[i], y[i], z[i]);
+		}
+
+		/**
+		 * \brief Get a view of a sub range of this view
+		 * \arg \c first The index of the first vector in the sub range
+		 * \arg \c n The number of vectors in the sub range
+		 * \return A \c Vector3Span of the n vectors starting at first
+		 */
+		Vector3Span<Scalar> subspan(std::size_t first, std::size_t n) const {
+			return Vector3Span<Scalar>(x + first, y + first, z + first, n);
+		}
+
+		Scalar *x; /**< The array of x components */
+		Scalar *y; /**< The array of y components */
+		Scalar *z; /**< The array of z components */
+		std::size_t count; /**< The number of vectors viewed */
+	};
+
+	/**
+	 * \brief A container of \c Vector3 values stored as three separate
+	 * component arrays.
+	 *
+	 * Keeping each component contiguous lets the batch kernels process several
+	 * vectors per instruction, which is not possible over an array of
+	 * \c Vector3 objects.
+	 */
+	template <typename Scalar>
+	struct Vector3SoA {
+		/**
+		 * \brief Construct an empty \c Vector3SoA
+		 */
+		Vector3SoA() { }
+		/**
+		 * \brief Construct a \c Vector3SoA holding count zero vectors
+		 * \arg \c count The number of vectors to hold
+		 */
+		explicit Vector3SoA(std::size_t count) :
+			x(count), y(count), z(count)
+		{ }
+		/**
+		 * \brief Construct a \c Vector3SoA from an array of \c Vector3 objects.
+		 * \arg \c source The array of vectors to convert from
+		 * \arg \c count The number of vectors in source
+		 */
+		template <typename Other>
+		Vector3SoA(const Vector3<Other> *source, std::size_t count) :
+			x(count), y(count), z(count)
+		{
+			for(std::size_t i = 0; i < count; ++i) {
+				set(i, source[i]);
+			}
+		}
+
+		/**
+		 * \brief Get the number of vectors held
+		 */
+		std::size_t size() const {
+			return x.size();
+		}
+		/**
+		 * \brief Change the number of vectors held, new vectors are zero
+		 * \arg \c count The new number of vectors
+		 */
+		void resize(std::size_t count) {
+			x.resize(count);
+			y.resize(count);
+			z.resize(count);
+		}
+		/**
+		 * \brief Reserve storage for the given number of vectors
+		 * \arg \c count The number of vectors to reserve storage for
+		 */
+		void reserve(std::size_t count) {
+			x.reserve(count);
+			y.reserve(count);
+			z.reserve(count);
+		}
+		/**
+		 * \brief Remove all vectors
+		 */
+		void clear() {
+			x.clear();
+			y.clear();
+			z.clear();
+		}
+		/**
+		 * \brief Append a vector to the end of the container
+		 * \arg \c v The vector to append
+		 */
+		template <typename Other>
+		void push_back(const Vector3<Other> &v) {
+			x.push_back(v.x);
+			y.push_back(v.y);
+			z.push_back(v.z);
+		}
+
+		/**
+		 * \brief Gather the vector at the given index
+		 * \arg \c i The index of the vector
+		 * \return A \c Vector3 object holding the components at index i
+		 */
+		Vector3<Scalar> operator[](std::size_t i) const {
+			return Vector3<Scalar>(x[i], y[i], z[i]);
+		}
+		/**
+		 * \brief Scatter a vector into the given index
+		 * \arg \c i The index to store the vector at
+		 * \arg \c v The vector to store
+		 */
+		template <typename Other>
+		void set(std::size_t i, const Vector3<Other> &v) {
+			x[i] = v.x;
+			y[i] = v.y;
+			z[i] = v.z;
+		}
+
+		/**
+		 * \brief Get a mutable view of all vectors held
+		 */
+		Vector3Span<Scalar> span() {
+			return Vector3Span<Scalar>(x.data(), y.data(), z.data(), size());
+		}
+		/**
+		 * \brief Get a read-only view of all vectors held
+		 */
+		Vector3Span<const Scalar> span() const {
+			return Vector3Span<const Scalar>(x.data(), y.data(), z.data(), size());
+		}
+
+		std::vector<Scalar> x; /**< The x components of the vectors */
+		std::vector<Scalar> y; /**< The y components of the vectors */
+		std::vector<Scalar> z; /**< The z components of the vectors */
+	};
+
+	typedef Vector3SoA<std::int32_t> Vec3SoAi;
+	typedef Vector3SoA<std::uint32_t> Vec3SoAu;
+	typedef Vector3SoA<std::int64_t> Vec3SoAl;
+	typedef Vector3SoA<std::uint64_t> Vec3SoAul;
+	typedef Vector3SoA<float> Vec3SoAf;
+	typedef Vector3SoA<double> Vec3SoAd;
+
+	namespace detail {
+		/*
+		 * Packed kernels process whole packs and return the number of vectors
+		 * handled; the caller finishes the remainder with the scalar functions
+		 * from Vector3.hpp. Each packed kernel evaluates exactly the expression
+		 * of its scalar counterpart, lane by lane, so both produce identical
+		 * results.
+		 */
+		template <typename S, typename O>
+		std::size_t length3(const S *, const S *, const S *, std::size_t, O *) {
+			return 0;
+		}
+		template <typename S, typename O>
+		std::size_t normalize3(const S *, const S *, const S *, std::size_t,
+													 O *, O *, O *)
+		{
+			return 0;
+		}
+		template <typename S, typename O>
+		std::size_t normalizeFast3(const S *, const S *, const S *, std::size_t,
+															 O *, O *, O *)
+		{
+			return 0;
+		}
+#if defined(GEOM_SSE2)
+		template <typename Pack, typename S>
+		std::size_t packedLength3(const S *x, const S *y, const S *z,
+															std::size_t n, S *out)
+		{
+			std::size_t i = 0;
+			for(; i + Pack::width <= n; i += Pack::width) {
+				const Pack vx = Pack::load(x + i);
+				const Pack vy = Pack::load(y + i);
+				const Pack vz = Pack::load(z + i);
+				simd::sqrt(vx * vx + vy * vy + vz * vz).store(out + i);
+			}
+			return i;
+		}
+
+		template <typename Pack, typename S>
+		std::size_t packedNormalize3(const S *x, const S *y, const S *z,
+																 std::size_t n, S *ox, S *oy, S *oz)
+		{
+			std::size_t i = 0;
+			for(; i + Pack::width <= n; i += Pack::width) {
+				const Pack vx = Pack::load(x + i);
+				const Pack vy = Pack::load(y + i);
+				const Pack vz = Pack::load(z + i);
+				const Pack len = simd::sqrt(vx * vx + vy * vy + vz * vz);
+				(vx / len).store(ox + i);
+				(vy / len).store(oy + i);
+				(vz / len).store(oz + i);
+			}
+			return i;
+		}
+
+		/* Same estimate and refinement as the scalar normalizeFast */
+		template <typename Pack>
+		std::size_t packedNormalizeFast3(const float *x, const float *y,
+																		 const float *z, std::size_t n,
+																		 float *ox, float *oy, float *oz)
+		{
+			const Pack half = Pack::set1(0.5f), threeHalves = Pack::set1(1.5f);
+			std::size_t i = 0;
+			for(; i + Pack::width <= n; i += Pack::width) {
+				const Pack vx = Pack::load(x + i);
+				const Pack vy = Pack::load(y + i);
+				const Pack vz = Pack::load(z + i);
+				const Pack d = vx * vx + vy * vy + vz * vz;
+				const Pack r = simd::rsqrt(d);
+				const Pack s = r * (threeHalves - half * d * r * r);
+				(vx * s).store(ox + i);
+				(vy * s).store(oy + i);
+				(vz * s).store(oz + i);
+			}
+			return i;
+		}
+
+		inline std::size_t length3(const float *x, const float *y, const float *z,
+															 std::size_t n, float *out)
+		{
+			return packedLength3<simd::Pack<float>::type>(x, y, z, n, out);
+		}
+		inline std::size_t length3(const double *x, const double *y,
+															 const double *z, std::size_t n, double *out)
+		{
+			return packedLength3<simd::Pack<double>::type>(x, y, z, n, out);
+		}
+		inline std::size_t normalize3(const float *x, const float *y,
+																	const float *z, std::size_t n,
+																	float *ox, float *oy, float *oz)
+		{
+			return packedNormalize3<simd::Pack<float>::type>(x, y, z, n,
+																											 ox, oy, oz);
+		}
+		inline std::size_t normalize3(const double *x, const double *y,
+																	const double *z, std::size_t n,
+																	double *ox, double *oy, double *oz)
+		{
+			return packedNormalize3<simd::Pack<double>::type>(x, y, z, n,
+																												ox, oy, oz);
+		}
+		inline std::size_t normalizeFast3(const float *x, const float *y,
+																			const float *z, std::size_t n,
+																			float *ox, float *oy, float *oz)
+		{
+			return packedNormalizeFast3<simd::Pack<float>::type>(x, y, z, n,
+																													 ox, oy, oz);
+		}
+#endif
+	}
+
+	/*
+	 * Batch kernels.
+	 *
+	 * Each kernel applies the scalar function of the same name from
+	 * Vector3.hpp to every vector of its input views and writes the results to
+	 * the output. All views must hold at least as many vectors as the first
+	 * input view. Outputs may alias the inputs.
+	 *
+	 * The results are identical to calling the scalar functions one vector at
+	 * a time, under the conditions given in Simd.hpp.
+	 */
+
+	/**
+	 * \brief Calculate the dot products of two arrays of vectors.
+	 * \arg \c lhs The vectors on the left side of the dot operation.
+	 * \arg \c rhs The vectors on the right side of the dot operation.
+	 * \arg \c out The array receiving one dot product per vector.
+	 */
+	template <typename LType, typename RType, typename OType>
+	void dot(Vector3Span<LType> lhs, Vector3Span<RType> rhs, OType *out) {
+		for(std::size_t i = 0; i < lhs.count; ++i) {
+			out[i] = lhs.x[i] * rhs.x[i] + lhs.y[i] * rhs.y[i] + lhs.z[i] * rhs.z[i];
+		}
+	}
+
+	/**
+	 * \brief Calculate the cross products of two arrays of vectors.
+	 * \arg \c lhs The vectors on the left side of the cross product.
+	 * \arg \c rhs The vectors on the right side of the cross product.
+	 * \arg \c out The vectors receiving the results.
+	 */
+	template <typename LType, typename RType, typename OType>
+	void cross(Vector3Span<LType> lhs, Vector3Span<RType> rhs,
+						 Vector3Span<OType> out)
+	{
+		for(std::size_t i = 0; i < lhs.count; ++i) {
+			const LType lx = lhs.x[i], ly = lhs.y[i], lz = lhs.z[i];
+			const RType rx = rhs.x[i], ry = rhs.y[i], rz = rhs.z[i];
+			out.x[i] = ly * rz - lz * ry;
+			out.y[i] = lz * rx - lx * rz;
+			out.z[i] = lx * ry - ly * rx;
+		}
+	}
+
+	/**
+	 * \brief Calculate the lengths of an array of vectors.
+	 *
+	 * As with the scalar \c length, results are float for float vectors and
+	 * double for any other vector type.
+	 *
+	 * \arg \c v The vectors to get the length of.
+	 * \arg \c out The array receiving one length per vector.
+	 */
+	template <typename Scalar, typename OType>
+	void length(Vector3Span<Scalar> v, OType *out) {
+		typedef typename Vector3Span<Scalar>::type S;
+		const S *x = v.x, *y = v.y, *z = v.z;
+		std::size_t i = detail::length3(x, y, z, v.count, out);
+		for(; i < v.count; ++i) {
+			out[i] = length(Vector3<S>(x[i], y[i], z[i]));
+		}
+	}
+
+	/**
+	 * \brief Normalize an array of vectors.
+	 * \arg \c v The vectors to normalize.
+	 * \arg \c out The vectors receiving the normalized results.
+	 */
+	template <typename Scalar, typename OType>
+	void normalize(Vector3Span<Scalar> v, Vector3Span<OType> out) {
+		typedef typename Vector3Span<Scalar>::type S;
+		const S *x = v.x, *y = v.y, *z = v.z;
+		std::size_t i = detail::normalize3(x, y, z, v.count, out.x, out.y, out.z);
+		for(; i < v.count; ++i) {
+			const Vector3<OType> r(normalize(Vector3<S>(x[i], y[i], z[i])));
+			out.x[i] = r.x;
+			out.y[i] = r.y;
+			out.z[i] = r.z;
+		}
+	}
+
+	/**
+	 * \brief Normalize an array of float vectors using a reciprocal square root
+	 * estimate.
+	 *
+	 * Unlike the other batch kernels the results are not identical to
+	 * \c normalize; they follow the precision contract of the scalar
+	 * \c normalizeFast instead.
+	 *
+	 * \arg \c v The vectors to normalize.
+	 * \arg \c out The vectors receiving the normalized results.
+	 */
+	inline void normalizeFast(Vector3Span<const float> v,
+														Vector3Span<float> out)
+	{
+		const float *x = v.x, *y = v.y, *z = v.z;
+		std::size_t i = detail::normalizeFast3(x, y, z, v.count,
+																					 out.x, out.y, out.z);
+		for(; i < v.count; ++i) {
+			const Vector3<float> r(normalizeFast(Vector3<float>(x[i], y[i], z[i])));
+			out.x[i] = r.x;
+			out.y[i] = r.y;
+			out.z[i] = r.z;
+		}
+	}
+
+	/**
+	 * \brief Reflect an array of vectors around an array of normals.
+	 *
+	 * The normals are expected to be normalized, see the scalar \c reflect.
+	 *
+	 * \arg \c v The vectors to reflect.
+	 * \arg \c normal The normals to reflect each vector around.
+	 * \arg \c out The vectors receiving the reflections.
+	 */
+	template <typename LType, typename RType, typename OType>
+	void reflect(Vector3Span<LType> v, Vector3Span<RType> normal,
+							 Vector3Span<OType> out)
+	{
+		for(std::size_t i = 0; i < v.count; ++i) {
+			const LType vx = v.x[i], vy = v.y[i], vz = v.z[i];
+			const RType nx = normal.x[i], ny = normal.y[i], nz = normal.z[i];
+			const auto d2 = 2 * (vx * nx + vy * ny + vz * nz);
+			out.x[i] = vx - d2 * nx;
+			out.y[i] = vy - d2 * ny;
+			out.z[i] = vz - d2 * nz;
+		}
+	}
+
+	/**
+	 * \brief Refract an array of vectors through surfaces with an array of
+	 * normals and a common index of refraction.
+	 *
+	 * Vectors which are totally internally reflected produce a zero vector,
+	 * see the scalar \c refract.
+	 *
+	 * \arg \c i The incident vectors.
+	 * \arg \c n The normals of the refracting surfaces.
+	 * \arg \c eta The index of refraction of the refracting surfaces.
+	 * \arg \c out The vectors receiving the refracted results.
+	 */
+	template <typename VType1, typename VType2, typename FType, typename OType>
+	void refract(Vector3Span<VType1> i, Vector3Span<VType2> n, const FType &eta,
+							 Vector3Span<OType> out)
+	{
+		static_assert(std::is_floating_point<FType>::value,
+									"The type of a refraction index must be floating point");
+		typedef typename std::common_type<FType,
+																			typename Vector3Span<VType1>::type,
+																			typename Vector3Span<VType2>::type>::type
+			R;
+
+		for(std::size_t j = 0; j < i.count; ++j) {
+			const Vector3<R> r(refract(i[j], n[j], eta));
+			out.x[j] = r.x;
+			out.y[j] = r.y;
+			out.z[j] = r.z;
+		}
+	}
+}
+
+#endif
@@ -30,13 +30,24 @@
 #define GEOM_VECTOR_4_HPP
 
 #include <cstdint>
+#include <cmath>
+
+#include "Simd.hpp"
+#include "VectorTraits.hpp"
 
 namespace geom {
   /**
    * \brief A templated 4 dimensional vector structure
+   *
+   * Vectors of four 4 byte components, such as \c Vec4f, are 16 byte aligned
+   * so that they can be loaded into a single SSE register. The arithmetic of
+   * \c Vec4f and \c Vec4d is implemented with SSE/AVX instructions when those
+   * are available, see Simd.hpp.
    */
   template <typename Scalar>
-  struct Vector4 {
+  struct alignas(sizeof(Scalar) * 4 == 16 ? 16 : alignof(Scalar)) Vector4 {
+		typedef Scalar type;
+		
     /**
      * \brief Construct a \c Vector4 object with 0 length
      */
@@ -98,14 +109,53 @@ namespace geom {
       return *this;
     }
     
+		/**
+		 * \brief Vector negation
+		 * \return A new \c Vector4 object which is the negation of this \c Vector4
+		 */
+		Vector4<Scalar> operator-() const {
+			return Vector4<Scalar>(-x, -y, -z, -w);
+		}
+		
     /**
      * \brief Assign the result of adding two vectors.
      * \arg \c rhs The vector to add to this \c Vector4 object
      * \return A reference to the \c Vector4 object being assigned to
      */
-    Vector4<Scalar> & operator+=(const Vector4<Scalar> &rhs) {
+		template <typename RhsType>
+    Vector4<Scalar> & operator+=(const Vector4<RhsType> &rhs) {
       return *this = *this + rhs;
     }
+		
+		/**
+		 * \brief Assign the result of subtracting two vectors.
+		 * \arg \c rhs The vector to subtract from this \c Vector4 object
+		 * \return A reference to the \c Vector4 object being assigned to
+		 */
+		template <typename RhsType>
+		Vector4<Scalar> & operator-=(const Vector4<RhsType> &rhs) {
+			return *this = *this - rhs;
+		}
+		
+		/**
+		 * \brief Assign the result of scalar multiplication
+		 * \arg \c rhs The scalar to multiply this vector by.
+		 * \return A reference to the \c Vector4 object being assigned to
+		 */
+		template <typename RhsType>
+		Vector4<Scalar> & operator*=(const RhsType &rhs) {
+			return *this = *this * rhs;
+		}
+		
+		/**
+		 * \brief Assign the result of scalar division
+		 * \arg \c rhs The scalar to divide this vector by
+		 * \return A reference to the \c Vector4 object being assigned to
+		 */
+		template <typename RhsType>
+		Vector4<Scalar> & operator/=(const RhsType &rhs) {
+			return *this = *this / rhs;
+		}
     
     Scalar x; /**< The x component of the \c Vector4 object */
     Scalar y; /**< The y component of the \c Vector4 object */
@@ -119,6 +169,266 @@ namespace geom {
   typedef Vector4<std::uint64_t> Vec4ul;
   typedef Vector4<float> Vec4f;
   typedef Vector4<double> Vec4d;
+	
+	template <typename T>
+	struct IsVector<Vector4<T>> : public std::true_type { };
+	template <typename T>
+	struct IsVector4<Vector4<T>> : public std::true_type { };
+	
+	template <typename T>
+	struct VectorType<Vector4<T>> {
+		typedef T type;
+	};
+	
+	namespace detail {
+		/*
+		 * The component-wise work of the Vector4 operators is done by the
+		 * functions below on vectors of a single type. The operators convert
+		 * their operands to the result type first, so mixed type expressions
+		 * such as Vec4i + Vec4f also take the packed path.
+		 *
+		 * Types with a Vector4Register specialization have all four components
+		 * loaded into SIMD registers, everything else uses the scalar code.
+		 */
+		template <typename Scalar>
+		struct HasVector4Register : public std::false_type { };
+		
+#if defined(GEOM_SSE2)
+		template <>
+		struct HasVector4Register<float> : public std::true_type { };
+		template <>
+		struct HasVector4Register<double> : public std::true_type { };
+		
+		inline simd::Float4 load4(const Vector4<float> &v) {
+			return _mm_load_ps(&v.x);
+		}
+		inline void store4(const simd::Float4 &r, Vector4<float> &v) {
+			_mm_store_ps(&v.x, r.v);
+		}
+		inline float hsum4(const simd::Float4 &r) {
+			const __m128 pairs = _mm_add_ps(r.v, _mm_movehl_ps(r.v, r.v));
+			return _mm_cvtss_f32(_mm_add_ss(pairs,
+																			_mm_shuffle_ps(pairs, pairs, 1)));
+		}
+		
+#  if defined(GEOM_AVX)
+		typedef simd::Double4 Double4Register;
+		
+		inline Double4Register load4(const Vector4<double> &v) {
+			return _mm256_loadu_pd(&v.x);
+		}
+		inline void store4(const Double4Register &r, Vector4<double> &v) {
+			_mm256_storeu_pd(&v.x, r.v);
+		}
+		inline double hsum4(const Double4Register &r) {
+			const __m128d pairs = _mm_add_pd(_mm256_castpd256_pd128(r.v),
+																			 _mm256_extractf128_pd(r.v, 1));
+			return _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+		}
+#  else
+		/* Without AVX the four doubles of a Vec4d are held in two registers */
+		struct Double4Register {
+			Double4Register() { }
+			Double4Register(const simd::Double2 &lo, const simd::Double2 &hi) :
+				lo(lo), hi(hi)
+			{ }
+			
+			static Double4Register set1(double s) {
+				return Double4Register(simd::Double2::set1(s),
+															 simd::Double2::set1(s));
+			}
+			
+			simd::Double2 lo, hi;
+		};
+		
+		inline Double4Register operator+(const Double4Register &a,
+																		 const Double4Register &b)
+		{
+			return Double4Register(a.lo + b.lo, a.hi + b.hi);
+		}
+		inline Double4Register operator-(const Double4Register &a,
+																		 const Double4Register &b)
+		{
+			return Double4Register(a.lo - b.lo, a.hi - b.hi);
+		}
+		inline Double4Register operator*(const Double4Register &a,
+																		 const Double4Register &b)
+		{
+			return Double4Register(a.lo * b.lo, a.hi * b.hi);
+		}
+		inline Double4Register operator/(const Double4Register &a,
+																		 const Double4Register &b)
+		{
+			return Double4Register(a.lo / b.lo, a.hi / b.hi);
+		}
+		inline Double4Register min(const Double4Register &a,
+															 const Double4Register &b)
+		{
+			return Double4Register(simd::min(a.lo, b.lo), simd::min(a.hi, b.hi));
+		}
+		inline Double4Register max(const Double4Register &a,
+															 const Double4Register &b)
+		{
+			return Double4Register(simd::max(a.lo, b.lo), simd::max(a.hi, b.hi));
+		}
+		
+		inline Double4Register load4(const Vector4<double> &v) {
+			return Double4Register(_mm_loadu_pd(&v.x), _mm_loadu_pd(&v.z));
+		}
+		inline void store4(const Double4Register &r, Vector4<double> &v) {
+			_mm_storeu_pd(&v.x, r.lo.v);
+			_mm_storeu_pd(&v.z, r.hi.v);
+		}
+		inline double hsum4(const Double4Register &r) {
+			const __m128d pairs = _mm_add_pd(r.lo.v, r.hi.v);
+			return _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+		}
+#  endif
+		
+		/* The register type holding all components of a Vector4<Scalar> */
+		template <typename Scalar>
+		struct Vector4Register { };
+		template <>
+		struct Vector4Register<float> {
+			typedef simd::Float4 type;
+		};
+		template <>
+		struct Vector4Register<double> {
+			typedef Double4Register type;
+		};
+		
+		using simd::min;
+		using simd::max;
+#endif
+		
+		template <typename Scalar, typename Result = Vector4<Scalar>>
+		using Scalar4 =
+			typename std::enable_if<!HasVector4Register<Scalar>::value,
+															Result>::type;
+		template <typename Scalar, typename Result = Vector4<Scalar>>
+		using Packed4 =
+			typename std::enable_if<HasVector4Register<Scalar>::value,
+															Result>::type;
+		
+		template <typename S>
+		Scalar4<S> add4(const Vector4<S> &a, const Vector4<S> &b) {
+			return Vector4<S>(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+		}
+		template <typename S>
+		Scalar4<S> sub4(const Vector4<S> &a, const Vector4<S> &b) {
+			return Vector4<S>(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+		}
+		template <typename S>
+		Scalar4<S> mul4(const Vector4<S> &a, const Vector4<S> &b) {
+			return Vector4<S>(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
+		}
+		template <typename S>
+		Scalar4<S> div4(const Vector4<S> &a, const Vector4<S> &b) {
+			return Vector4<S>(a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w);
+		}
+		template <typename S>
+		Scalar4<S> scale4(const Vector4<S> &a, const S &s) {
+			return Vector4<S>(a.x * s, a.y * s, a.z * s, a.w * s);
+		}
+		template <typename S>
+		Scalar4<S> divScalar4(const Vector4<S> &a, const S &s) {
+			return Vector4<S>(a.x / s, a.y / s, a.z / s, a.w / s);
+		}
+		template <typename S>
+		Scalar4<S,S> dot4(const Vector4<S> &a, const Vector4<S> &b) {
+			return (a.x * b.x + a.y * b.y) + (a.z * b.z + a.w * b.w);
+		}
+		template <typename S>
+		Scalar4<S> min4(const Vector4<S> &a, const Vector4<S> &b) {
+			return Vector4<S>(a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y,
+												a.z < b.z ? a.z : b.z, a.w < b.w ? a.w : b.w);
+		}
+		template <typename S>
+		Scalar4<S> max4(const Vector4<S> &a, const Vector4<S> &b) {
+			return Vector4<S>(a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y,
+												a.z > b.z ? a.z : b.z, a.w > b.w ? a.w : b.w);
+		}
+		
+#if defined(GEOM_SSE2)
+		template <typename S>
+		Packed4<S> add4(const Vector4<S> &a, const Vector4<S> &b) {
+			Vector4<S> r;
+			store4(load4(a) + load4(b), r);
+			return r;
+		}
+		template <typename S>
+		Packed4<S> sub4(const Vector4<S> &a, const Vector4<S> &b) {
+			Vector4<S> r;
+			store4(load4(a) - load4(b), r);
+			return r;
+		}
+		template <typename S>
+		Packed4<S> mul4(const Vector4<S> &a, const Vector4<S> &b) {
+			Vector4<S> r;
+			store4(load4(a) * load4(b), r);
+			return r;
+		}
+		template <typename S>
+		Packed4<S> div4(const Vector4<S> &a, const Vector4<S> &b) {
+			Vector4<S> r;
+			store4(load4(a) / load4(b), r);
+			return r;
+		}
+		template <typename S>
+		Packed4<S> scale4(const Vector4<S> &a, const S &s) {
+			typedef typename Vector4Register<S>::type Register;
+			Vector4<S> r;
+			store4(load4(a) * Register::set1(s), r);
+			return r;
+		}
+		template <typename S>
+		Packed4<S> divScalar4(const Vector4<S> &a, const S &s) {
+			typedef typename Vector4Register<S>::type Register;
+			Vector4<S> r;
+			store4(load4(a) / Register::set1(s), r);
+			return r;
+		}
+		template <typename S>
+		Packed4<S,S> dot4(const Vector4<S> &a, const Vector4<S> &b) {
+			return hsum4(load4(a) * load4(b));
+		}
+		template <typename S>
+		Packed4<S> min4(const Vector4<S> &a, const Vector4<S> &b) {
+			Vector4<S> r;
+			store4(min(load4(a), load4(b)), r);
+			return r;
+		}
+		template <typename S>
+		Packed4<S> max4(const Vector4<S> &a, const Vector4<S> &b) {
+			Vector4<S> r;
+			store4(max(load4(a), load4(b)), r);
+			return r;
+		}
+#endif
+	}
+	
+	/**
+	 * \brief Test vectors component-wise for equality.
+	 * \arg \c lhs The vector on the left of the equality operator.
+	 * \arg \c rhs The vector on the right of the equality operator.
+	 * \return True if all elements are equal, false otherwise.
+	 */
+	template <typename LType, typename RType>
+	bool operator==(const Vector4<LType> &lhs, const Vector4<RType> &rhs) {
+		return (lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z &&
+						lhs.w == rhs.w);
+	}
+	
+	/**
+	 * \brief Test if two vectors are not equal.
+	 * \arg \c lhs The vector on the left of the inequality operator.
+	 * \arg \c rhs The vector on the right of the inequality operator.
+	 * \return True if any element is different, False otherwise.
+	 */
+	template <typename LType, typename RType>
+	bool operator!=(const Vector4<LType> &lhs, const Vector4<RType> &rhs) {
+		return !(lhs == rhs);
+	}
   
   /**
    * \brief Add two \c Vector4 objects together and return the result.
@@ -128,14 +438,189 @@ namespace geom {
    * rhs
    */
   template <typename RhsType, typename LhsType,
-	    typename Result = typename std::common_type<RhsType,LhsType>::type>
+						typename Result = typename VectorOpResult<RhsType,LhsType>::type>
   Vector4<Result> operator+(const Vector4<LhsType> &lhs,
 			    const Vector4<RhsType> &rhs)
   {
-    return Vector4<Result>(lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z,
-			   lhs.w + rhs.w);
+		return detail::add4(Vector4<Result>(lhs), Vector4<Result>(rhs));
   }
-
+	
+	/**
+	 * \brief Subtract two \c Vector4 objects and return the result.
+	 * \arg \c lhs The operand on the left hand side of the expression
+	 * \arg \c rhs The operand on the right hand side of the expression
+	 * \return A new \c Vector4 object that contains the result of subtracting
+	 * rhs from lhs
+	 */
+	template <typename RhsType, typename LhsType,
+						typename Result = typename VectorOpResult<RhsType,LhsType>::type>
+	Vector4<Result> operator-(const Vector4<LhsType> &lhs,
+														const Vector4<RhsType> &rhs)
+	{
+		return detail::sub4(Vector4<Result>(lhs), Vector4<Result>(rhs));
+	}
+	
+	/**
+	 * \brief Multiply two \c Vector4 objects component-wise and return the
+	 * result.
+	 * \arg \c lhs The operand on the left hand side of the expression
+	 * \arg \c rhs The operand on the right hand side of the expression
+	 * \return A new \c Vector4 object that contains the result of multiplying
+	 * lhs and rhs
+	 */
+	template <typename RhsType, typename LhsType,
+						typename Result = typename VectorOpResult<RhsType,LhsType>::type>
+	Vector4<Result> operator*(const Vector4<LhsType> &lhs,
+														const Vector4<RhsType> &rhs)
+	{
+		return detail::mul4(Vector4<Result>(lhs), Vector4<Result>(rhs));
+	}
+	
+	/**
+	 * \brief Multiply a \c Vector4 object by a scalar.
+	 * \arg \c lhs The \c Vector4 object to multiply
+	 * \arg \c rhs The scalar to multiply the \c Vector4 object by
+	 * \return A new \c Vector4 object that contains the result of multiplying
+	 * lhs by rhs
+	 */
+	template <typename RhsType, typename LhsType,
+						typename Result = typename VectorOpResult<RhsType,LhsType>::type>
+	Vector4<Result> operator*(const Vector4<LhsType> &lhs, const RhsType &rhs)
+	{
+		static_assert(!IsVector<RhsType>::value,
+									"Multiplication is not defined for the given types");
+		return detail::scale4(Vector4<Result>(lhs), static_cast<Result>(rhs));
+	}
+	
+	/**
+	 * \brief Multiply a \c Vector4 object by a scalar.
+	 * \arg \c lhs The scalar to multiply the \c Vector4 object by
+	 * \arg \c rhs The \c Vector4 object to multiply
+	 * \return A new \c Vector4 object that contains the result of multiplying
+	 * lhs by rhs
+	 */
+	template <typename RhsType, typename LhsType,
+						typename Result = typename VectorOpResult<RhsType,LhsType>::type>
+	Vector4<Result> operator*(const LhsType &lhs, const Vector4<RhsType> &rhs)
+	{
+		static_assert(!IsVector<LhsType>::value,
+									"Multiplication is not defined for the given types");
+		return detail::scale4(Vector4<Result>(rhs), static_cast<Result>(lhs));
+	}
+	
+	/**
+	 * \brief Divide two \c Vector4 objects component-wise and return the
+	 * result.
+	 * \arg \c lhs The operand on the left hand side of the expression
+	 * \arg \c rhs The operand on the right hand side of the expression
+	 * \return A new \c Vector4 object that contains the result of dividing lhs
+	 * by rhs
+	 */
+	template <typename RhsType, typename LhsType,
+						typename Result = typename VectorOpResult<RhsType,LhsType>::type>
+	Vector4<Result> operator/(const Vector4<LhsType> &lhs,
+														const Vector4<RhsType> &rhs)
+	{
+		return detail::div4(Vector4<Result>(lhs), Vector4<Result>(rhs));
+	}
+	
+	/**
+	 * \brief Divide a \c Vector4 object by a scalar.
+	 * \arg \c lhs The \c Vector4 object to divide
+	 * \arg \c rhs The scalar to divide the \c Vector4 object by
+	 * \return A new \c Vector4 object that contains the result of dividing lhs
+	 * by rhs
+	 */
+	template <typename RhsType, typename LhsType,
+						typename Result = typename VectorOpResult<RhsType,LhsType>::type>
+	Vector4<Result> operator/(const Vector4<LhsType> &lhs, const RhsType &rhs)
+	{
+		static_assert(!IsVector<RhsType>::value,
+									"Division is not defined for the given types");
+		return detail::divScalar4(Vector4<Result>(lhs), static_cast<Result>(rhs));
+	}
+	
+	/**
+	 * \brief Calculate the dot product between two vectors.
+	 *
+	 * The products are summed pairwise, (x + y) + (z + w), which is the order
+	 * a horizontal add of a SIMD register produces.
+	 *
+	 * \arg \c lhs The \c Vector4 object on the left side of the dot operation.
+	 * \arg \c rhs The \c Vector4 object on the right side of the dot operation.
+	 * \return The result of the dot product of the two \c Vector4 objects.
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Result dot(const Vector4<LType> &lhs, const Vector4<RType> &rhs) {
+		return detail::dot4(Vector4<Result>(lhs), Vector4<Result>(rhs));
+	}
+	
+	/**
+	 * \brief Get the length of the vector.
+	 * 
+	 * Any type vector which isn't a float or double vector is first converted to
+	 * a double vector.
+	 * 
+	 * \arg \c v The vector to get the length of.
+	 * \return The length of the vector.
+	 */
+	template <typename Scalar>
+	double length(const Vector4<Scalar> &v) {
+		return std::sqrt(dot(Vector4<double>(v), Vector4<double>(v)));
+	}
+	inline float length(const Vector4<float> &f) {
+		return std::sqrt(dot(f, f));
+	}
+	
+	/**
+	 * \brief Normalize the \c Vector4 object.
+	 * 
+	 * The resulting vector defaults to type double unless the type of the input
+	 * vector is a float.
+	 * 
+	 * \arg \c source The \c Vector4 object to normalize.
+	 * \return A new \c Vector4 object which is normalized.
+	 */
+	template <typename IntegralType, typename RType = double>
+	Vector4<RType> normalize(const Vector4<IntegralType> &source) {
+		return Vector4<RType>(source) / length(source);
+	}
+	inline Vector4<float> normalize(const Vector4<float> &source) {
+		return source / length(source);
+	}
+	
+	/**
+	 * \brief Component-wise minimum of two vectors.
+	 *
+	 * Each component is lhs where lhs is less than rhs and rhs otherwise,
+	 * matching the SSE min instructions for NaN and signed zero operands.
+	 *
+	 * \arg \c lhs The first \c Vector4 object to compare.
+	 * \arg \c rhs The second \c Vector4 object to compare.
+	 * \return A new \c Vector4 object holding the smaller of each component.
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Vector4<Result> min(const Vector4<LType> &lhs, const Vector4<RType> &rhs) {
+		return detail::min4(Vector4<Result>(lhs), Vector4<Result>(rhs));
+	}
+	
+	/**
+	 * \brief Component-wise maximum of two vectors.
+	 *
+	 * Each component is lhs where lhs is greater than rhs and rhs otherwise,
+	 * matching the SSE max instructions for NaN and signed zero operands.
+	 *
+	 * \arg \c lhs The first \c Vector4 object to compare.
+	 * \arg \c rhs The second \c Vector4 object to compare.
+	 * \return A new \c Vector4 object holding the larger of each component.
+	 */
+	template <typename RType, typename LType,
+						typename Result = typename VectorOpResult<LType,RType>::type>
+	Vector4<Result> max(const Vector4<LType> &lhs, const Vector4<RType> &rhs) {
+		return detail::max4(Vector4<Result>(lhs), Vector4<Result>(rhs));
+	}
 }
 
 #endif
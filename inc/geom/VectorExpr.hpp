@@ -0,0 +1,472 @@
+/**
+ * \file VectorExpr.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Expression templates fusing Vector2/Vector3 arithmetic over arrays
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_VECTOR_EXPR_HPP
+#define GEOM_VECTOR_EXPR_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+#include "Vector3SoA.hpp"
+
+namespace geom {
+	/**
+	 * \brief Opt-in expression templates for whole-array vector arithmetic.
+	 *
+	 * Wrapping operands with \c expr::lazy makes the arithmetic operators
+	 * build an expression tree instead of computing intermediate vectors. The
+	 * tree is evaluated by \c expr::assign in a single loop over the elements,
+	 * each element computed from its operands in registers:
+	 *
+	 * \code
+	 * using namespace geom;
+	 * expr::assign(pos, expr::lazy(pos) + expr::lazy(vel) * dt +
+	 *                   expr::lazy(acc) * (0.5f * dt * dt));
+	 * \endcode
+	 *
+	 * Operands may be arrays of \c Vector2 or \c Vector3 objects
+	 * (\c std::vector or pointer and count), \c Vector3Span / \c Vector3SoA
+	 * component arrays, single vectors (applied to every element) and plain
+	 * scalars. Every intermediate value is converted to the type given by
+	 * \c VectorOpResult, exactly as the eager operators do, so a fused
+	 * expression produces the same values as the same expression written with
+	 * \c Vector2 / \c Vector3 temporaries.
+	 *
+	 * All array operands of an expression must hold the same number of
+	 * elements. The destination may also be an operand of the expression since
+	 * each element only depends on the operands at the same index; a resizable
+	 * destination used that way must already have the expression's size.
+	 */
+	namespace expr {
+		/**
+		 * \brief Tag selecting a vector component, 0 for x, 1 for y and 2 for z
+		 */
+		template <unsigned C>
+		struct Axis { };
+
+		template <typename T>
+		const T & component(const Vector2<T> &v, Axis<0>) { return v.x; }
+		template <typename T>
+		const T & component(const Vector2<T> &v, Axis<1>) { return v.y; }
+		template <typename T>
+		const T & component(const Vector3<T> &v, Axis<0>) { return v.x; }
+		template <typename T>
+		const T & component(const Vector3<T> &v, Axis<1>) { return v.y; }
+		template <typename T>
+		const T & component(const Vector3<T> &v, Axis<2>) { return v.z; }
+
+		/**
+		 * \brief The vector type with the given number of components
+		 */
+		template <unsigned Dimension, typename T>
+		struct VectorOf { };
+		template <typename T>
+		struct VectorOf<2,T> {
+			typedef Vector2<T> type;
+		};
+		template <typename T>
+		struct VectorOf<3,T> {
+			typedef Vector3<T> type;
+		};
+
+		/**
+		 * \brief Base of all expression nodes.
+		 *
+		 * A node \c E provides
+		 *  - \c E::type, the scalar type of its components,
+		 *  - \c E::dimension, its number of components, 0 for a scalar,
+		 *  - \c size(), its number of elements, 0 if it has the same value for
+		 *    every element,
+		 *  - \c get(i, Axis<C>()), component C of element i.
+		 */
+		template <typename Derived>
+		struct Expression {
+			const Derived & self() const {
+				return static_cast<const Derived &>(*this);
+			}
+		};
+
+		/**
+		 * \brief An array of \c Vector2 or \c Vector3 objects
+		 */
+		template <typename Vector>
+		struct Array : public Expression<Array<Vector>> {
+			typedef typename Vector::type type;
+			static const unsigned dimension = IsVector2<Vector>::value ? 2 : 3;
+
+			Array(const Vector *data, std::size_t count) :
+				data(data), count(count)
+			{ }
+
+			std::size_t size() const { return count; }
+			template <unsigned C>
+			type get(std::size_t i, Axis<C> axis) const {
+				return component(data[i], axis);
+			}
+
+			const Vector *data;
+			std::size_t count;
+		};
+
+		/**
+		 * \brief Vectors held as component arrays
+		 */
+		template <typename Scalar>
+		struct Components : public Expression<Components<Scalar>> {
+			typedef typename std::remove_const<Scalar>::type type;
+			static const unsigned dimension = 3;
+
+			Components(const Vector3Span<Scalar> &span) :
+				span(span)
+			{ }
+
+			std::size_t size() const { return span.count; }
+			type get(std::size_t i, Axis<0>) const { return span.x[i]; }
+			type get(std::size_t i, Axis<1>) const { return span.y[i]; }
+			type get(std::size_t i, Axis<2>) const { return span.z[i]; }
+
+			Vector3Span<Scalar> span;
+		};
+
+		/**
+		 * \brief A single vector used for every element
+		 */
+		template <typename Vector>
+		struct Broadcast : public Expression<Broadcast<Vector>> {
+			typedef typename Vector::type type;
+			static const unsigned dimension = IsVector2<Vector>::value ? 2 : 3;
+
+			Broadcast(const Vector &value) :
+				value(value)
+			{ }
+
+			std::size_t size() const { return 0; }
+			template <unsigned C>
+			type get(std::size_t, Axis<C> axis) const {
+				return component(value, axis);
+			}
+
+			Vector value;
+		};
+
+		/**
+		 * \brief A scalar used for every component of every element
+		 */
+		template <typename Scalar>
+		struct Constant : public Expression<Constant<Scalar>> {
+			typedef Scalar type;
+			static const unsigned dimension = 0;
+
+			Constant(const Scalar &value) :
+				value(value)
+			{ }
+
+			std::size_t size() const { return 0; }
+			template <unsigned C>
+			type get(std::size_t, Axis<C>) const { return value; }
+
+			Scalar value;
+		};
+
+		struct Add {
+			template <typename L, typename R>
+			static auto apply(const L &l, const R &r) -> decltype(l + r) {
+				return l + r;
+			}
+		};
+		struct Subtract {
+			template <typename L, typename R>
+			static auto apply(const L &l, const R &r) -> decltype(l - r) {
+				return l - r;
+			}
+		};
+		struct Multiply {
+			template <typename L, typename R>
+			static auto apply(const L &l, const R &r) -> decltype(l * r) {
+				return l * r;
+			}
+		};
+		struct Divide {
+			template <typename L, typename R>
+			static auto apply(const L &l, const R &r) -> decltype(l / r) {
+				return l / r;
+			}
+		};
+
+		/**
+		 * \brief A component-wise operation between two expressions
+		 */
+		template <typename Op, typename L, typename R>
+		struct Binary : public Expression<Binary<Op,L,R>> {
+			typedef typename VectorOpResult<typename L::type,
+																			typename R::type>::type type;
+			static const unsigned dimension =
+				L::dimension > R::dimension ? L::dimension : R::dimension;
+			static_assert(L::dimension == R::dimension || L::dimension == 0 ||
+										R::dimension == 0,
+										"Operands of a vector expression must have the same "
+										"number of components");
+
+			Binary(const L &lhs, const R &rhs) :
+				lhs(lhs), rhs(rhs)
+			{ }
+
+			std::size_t size() const {
+				return lhs.size() > rhs.size() ? lhs.size() : rhs.size();
+			}
+			template <unsigned C>
+			type get(std::size_t i, Axis<C> axis) const {
+				return Op::apply(lhs.get(i, axis), rhs.get(i, axis));
+			}
+
+			L lhs;
+			R rhs;
+		};
+
+		/**
+		 * \brief Component-wise negation of an expression
+		 */
+		template <typename E>
+		struct Negate : public Expression<Negate<E>> {
+			typedef typename E::type type;
+			static const unsigned dimension = E::dimension;
+
+			Negate(const E &operand) :
+				operand(operand)
+			{ }
+
+			std::size_t size() const { return operand.size(); }
+			template <unsigned C>
+			type get(std::size_t i, Axis<C> axis) const {
+				return -operand.get(i, axis);
+			}
+
+			E operand;
+		};
+
+		/**
+		 * \brief Wrap an array of vectors for use in an expression
+		 * \arg \c data The vectors
+		 * \arg \c count The number of vectors
+		 */
+		template <typename T>
+		Array<Vector2<T>> lazy(const Vector2<T> *data, std::size_t count) {
+			return Array<Vector2<T>>(data, count);
+		}
+		template <typename T>
+		Array<Vector3<T>> lazy(const Vector3<T> *data, std::size_t count) {
+			return Array<Vector3<T>>(data, count);
+		}
+		/**
+		 * \brief Wrap a \c std::vector of vectors for use in an expression
+		 */
+		template <typename T, typename A>
+		Array<Vector2<T>> lazy(const std::vector<Vector2<T>,A> &v) {
+			return Array<Vector2<T>>(v.data(), v.size());
+		}
+		template <typename T, typename A>
+		Array<Vector3<T>> lazy(const std::vector<Vector3<T>,A> &v) {
+			return Array<Vector3<T>>(v.data(), v.size());
+		}
+		/**
+		 * \brief Wrap vectors held as component arrays for use in an expression
+		 */
+		template <typename T>
+		Components<T> lazy(const Vector3Span<T> &span) {
+			return Components<T>(span);
+		}
+		template <typename T>
+		Components<const T> lazy(const Vector3SoA<T> &soa) {
+			return Components<const T>(soa.span());
+		}
+		/**
+		 * \brief Wrap a single vector to be used for every element
+		 */
+		template <typename T>
+		Broadcast<Vector2<T>> lazy(const Vector2<T> &v) {
+			return Broadcast<Vector2<T>>(v);
+		}
+		template <typename T>
+		Broadcast<Vector3<T>> lazy(const Vector3<T> &v) {
+			return Broadcast<Vector3<T>>(v);
+		}
+
+		template <typename L, typename R>
+		Binary<Add,L,R> operator+(const Expression<L> &lhs,
+															const Expression<R> &rhs)
+		{
+			return Binary<Add,L,R>(lhs.self(), rhs.self());
+		}
+		template <typename L, typename R>
+		Binary<Subtract,L,R> operator-(const Expression<L> &lhs,
+																	 const Expression<R> &rhs)
+		{
+			return Binary<Subtract,L,R>(lhs.self(), rhs.self());
+		}
+		template <typename L, typename R>
+		Binary<Multiply,L,R> operator*(const Expression<L> &lhs,
+																	 const Expression<R> &rhs)
+		{
+			return Binary<Multiply,L,R>(lhs.self(), rhs.self());
+		}
+		template <typename L, typename R>
+		Binary<Divide,L,R> operator/(const Expression<L> &lhs,
+																 const Expression<R> &rhs)
+		{
+			return Binary<Divide,L,R>(lhs.self(), rhs.self());
+		}
+		template <typename E>
+		Negate<E> operator-(const Expression<E> &operand) {
+			return Negate<E>(operand.self());
+		}
+
+		template <typename L, typename S>
+		typename std::enable_if<std::is_arithmetic<S>::value,
+														Binary<Multiply,L,Constant<S>>>::type
+		operator*(const Expression<L> &lhs, const S &rhs) {
+			return Binary<Multiply,L,Constant<S>>(lhs.self(), Constant<S>(rhs));
+		}
+		template <typename S, typename R>
+		typename std::enable_if<std::is_arithmetic<S>::value,
+														Binary<Multiply,Constant<S>,R>>::type
+		operator*(const S &lhs, const Expression<R> &rhs) {
+			return Binary<Multiply,Constant<S>,R>(Constant<S>(lhs), rhs.self());
+		}
+		template <typename L, typename S>
+		typename std::enable_if<std::is_arithmetic<S>::value,
+														Binary<Divide,L,Constant<S>>>::type
+		operator/(const Expression<L> &lhs, const S &rhs) {
+			return Binary<Divide,L,Constant<S>>(lhs.self(), Constant<S>(rhs));
+		}
+
+		/* Gather element i of an expression into a vector */
+		template <typename E>
+		Vector2<typename E::type> element(const E &e, std::size_t i, Axis<2>) {
+			return Vector2<typename E::type>(e.get(i, Axis<0>()),
+																			 e.get(i, Axis<1>()));
+		}
+		template <typename E>
+		Vector3<typename E::type> element(const E &e, std::size_t i, Axis<3>) {
+			return Vector3<typename E::type>(e.get(i, Axis<0>()),
+																			 e.get(i, Axis<1>()),
+																			 e.get(i, Axis<2>()));
+		}
+
+		/**
+		 * \brief Evaluate an expression that does not involve any arrays
+		 * \arg \c e The expression to evaluate
+		 * \return The resulting \c Vector2 or \c Vector3 object
+		 */
+		template <typename E>
+		typename VectorOf<E::dimension, typename E::type>::type
+		eval(const Expression<E> &e) {
+			return element(e.self(), 0, Axis<E::dimension>());
+		}
+
+		/**
+		 * \brief Evaluate an expression into an array of vectors.
+		 *
+		 * One vector is written per element of the expression; \c out must
+		 * have room for them.
+		 *
+		 * \arg \c out The array receiving the results
+		 * \arg \c e The expression to evaluate
+		 */
+		template <typename T, typename E>
+		void assign(Vector2<T> *out, const Expression<E> &e) {
+			static_assert(E::dimension == 2, "Expression is not two dimensional");
+			const E &x = e.self();
+			const std::size_t n = x.size();
+			for(std::size_t i = 0; i < n; ++i) {
+				out[i] = Vector2<T>(x.get(i, Axis<0>()), x.get(i, Axis<1>()));
+			}
+		}
+		template <typename T, typename E>
+		void assign(Vector3<T> *out, const Expression<E> &e) {
+			static_assert(E::dimension == 3, "Expression is not three dimensional");
+			const E &x = e.self();
+			const std::size_t n = x.size();
+			for(std::size_t i = 0; i < n; ++i) {
+				out[i] = Vector3<T>(x.get(i, Axis<0>()), x.get(i, Axis<1>()),
+														x.get(i, Axis<2>()));
+			}
+		}
+		/**
+		 * \brief Evaluate an expression into a \c std::vector, which is resized
+		 * to the number of elements of the expression.
+		 */
+		template <typename T, typename A, typename E>
+		void assign(std::vector<Vector2<T>,A> &out, const Expression<E> &e) {
+			out.resize(e.self().size());
+			assign(out.data(), e);
+		}
+		template <typename T, typename A, typename E>
+		void assign(std::vector<Vector3<T>,A> &out, const Expression<E> &e) {
+			out.resize(e.self().size());
+			assign(out.data(), e);
+		}
+		/**
+		 * \brief Evaluate an expression into component arrays.
+		 *
+		 * Elements are computed in blocks into local arrays and then copied to
+		 * the destination. The local arrays cannot alias any operand, which
+		 * lets the compiler vectorize the evaluation loop without having to
+		 * check every operand array against every destination array.
+		 */
+		template <typename T, typename E>
+		void assign(const Vector3Span<T> &out, const Expression<E> &e) {
+			static_assert(E::dimension == 3, "Expression is not three dimensional");
+			const std::size_t Block = 64;
+			const E &x = e.self();
+			const std::size_t n = x.size();
+			T bx[Block], by[Block], bz[Block];
+			for(std::size_t first = 0; first < n; first += Block) {
+				const std::size_t m = n - first < Block ? n - first : Block;
+				for(std::size_t j = 0; j < m; ++j) {
+					bx[j] = x.get(first + j, Axis<0>());
+					by[j] = x.get(first + j, Axis<1>());
+					bz[j] = x.get(first + j, Axis<2>());
+				}
+				for(std::size_t j = 0; j < m; ++j) {
+					out.x[first + j] = bx[j];
+					out.y[first + j] = by[j];
+					out.z[first + j] = bz[j];
+				}
+			}
+		}
+		template <typename T, typename E>
+		void assign(Vector3SoA<T> &out, const Expression<E> &e) {
+			out.resize(e.self().size());
+			assign(out.span(), e);
+		}
+	}
+}
+
+#endif
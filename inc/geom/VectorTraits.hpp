@@ -15,12 +15,17 @@ namespace geom {
 		typedef T type;
 	};
 	
+	/*
+	 * Derives from common_type so that \c type is simply missing, rather than
+	 * an error, for operands without a common type. Operator templates taking
+	 * a generic scalar operand then drop out of overload resolution for
+	 * operands such as matrices instead of failing to compile.
+	 */
 	template <typename LType, typename RType>
-	struct VectorOpResult {
-		typedef typename std::common_type<typename VectorType<LType>::type,
-																			typename VectorType<RType>::type>::type
-		type;
-	};
+	struct VectorOpResult :
+		public std::common_type<typename VectorType<LType>::type,
+														typename VectorType<RType>::type>
+	{ };
 }
 
 #endif
@@ -0,0 +1,367 @@
+/**
+ * \file Voronoi.hpp
+ * \author Troy Varney <troy.a.varney@gmail.com>
+ * \brief Voronoi diagrams of sets of points clipped to a rectangle
+ */
+
+/* Copyright (C) 2014 Troy Varney
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef GEOM_VORONOI_HPP
+#define GEOM_VORONOI_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ConvexHull.hpp"
+#include "Delaunay.hpp"
+#include "Point2.hpp"
+#include "Predicates.hpp"
+#include "Rectangle2.hpp"
+
+namespace geom {
+	/**
+	 * \brief The cells of a Voronoi diagram in compact form.
+	 *
+	 * The cell of site i is the convex polygon of vertices offsets[i] to
+	 * offsets[i + 1] - 1, counterclockwise, so that all cells share one
+	 * vertex array. A cell is empty if it lies outside the clipping
+	 * rectangle, or if its site is repeated and another copy has the cell.
+	 */
+	template <typename Scalar>
+	struct Voronoi2 {
+		void clear() {
+			offsets.clear();
+			vertices.clear();
+		}
+		
+		/** The first vertex of each cell, and the vertex count at the end */
+		std::vector<std::uint32_t> offsets;
+		/** The vertices of the cells */
+		std::vector<Point2<Scalar>> vertices;
+	};
+	
+	namespace detail {
+		/*
+		 * Clip the convex polygon in to the half-plane a x + b y <= c by the
+		 * Sutherland-Hodgman algorithm, writing the result to out.
+		 */
+		inline void clipHalfPlane(const std::vector<Point2d> &in, double a,
+															double b, double c, std::vector<Point2d> &out)
+		{
+			out.clear();
+			const std::size_t n = in.size();
+			for(std::size_t i = 0, j = n - 1; i < n; j = i++) {
+				const Point2d &p = in[j], &q = in[i];
+				const double dp = a * p.x + b * p.y - c;
+				const double dq = a * q.x + b * q.y - c;
+				if((dp < 0 && dq > 0) || (dp > 0 && dq < 0)) {
+					const double t = dp / (dp - dq);
+					out.push_back(Point2d(p.x + t * (q.x - p.x),
+																p.y + t * (q.y - p.y)));
+				}
+				if(dq <= 0) {
+					out.push_back(q);
+				}
+			}
+		}
+		
+		/*
+		 * Builds the cells in the order of the triangles, whose neighbors are
+		 * near in memory, rather than in the order of the sites. A pass over
+		 * the triangles finds their circumcenters and the number around each
+		 * vertex, and marks the vertices on the hull or with a circumcenter
+		 * outside the rectangle, whose cells are clipped into a side buffer.
+		 * The other cells are just the circumcenters around their vertex,
+		 * and are written straight into place by a walk around each. Clipping
+		 * uses two scratch polygons, which grow to the largest cell.
+		 */
+		template <typename S>
+		class VoronoiBuilder {
+		public:
+			VoronoiBuilder(const Point2<S> *sites, std::size_t count,
+										 const Rectangle2<S> &bounds) :
+				sites(sites), x0(bounds.origin.x), y0(bounds.origin.y),
+				x1(x0 + double(bounds.dim.width)),
+				y1(y0 + double(bounds.dim.height)), sizes(count, 0),
+				marked(count, false)
+			{ }
+			
+			/* Size the cells of the vertices of a triangulation of the sites */
+			void build(const Triangulation2 &t) {
+				const std::size_t n = t.triangles.size();
+				centers.resize(n / 3);
+				std::vector<std::uint32_t> spoke(sizes.size()), pending;
+				for(std::size_t e = 0; e < n; e += 3) {
+					const Point2d c = circumcenter(sites[t.triangles[e]],
+																				 sites[t.triangles[e + 1]],
+																				 sites[t.triangles[e + 2]]);
+					centers[e / 3] = c;
+					const bool inside = x0 <= c.x && c.x <= x1 && y0 <= c.y &&
+						c.y <= y1;
+					for(std::size_t f = e; f < e + 3; ++f) {
+						const std::uint32_t v = t.triangles[f];
+						const bool hull = t.halfedges[f] == Triangulation2::None;
+						++sizes[v];
+						if(inside && !hull) {
+							continue;
+						}
+						/* A hull vertex starts from its half-edge along the hull */
+						if(!marked[v] || hull) {
+							spoke[v] = std::uint32_t(f);
+						}
+						if(!marked[v]) {
+							marked[v] = true;
+							pending.push_back(v);
+						}
+					}
+				}
+				for(std::size_t i = 0; i < pending.size(); ++i) {
+					cell(t, pending[i], spoke[pending[i]]);
+				}
+			}
+			
+			/*
+			 * Size the cells of collinear sites, which are slabs between the
+			 * bisectors of consecutive distinct sites.
+			 */
+			void buildCollinear() {
+				const std::size_t count = sizes.size();
+				std::vector<std::uint32_t> order(count);
+				for(std::size_t i = 0; i < count; ++i) {
+					order[i] = std::uint32_t(i);
+				}
+				const Point2<S> *p = sites;
+				std::stable_sort(order.begin(), order.end(),
+												 [p](std::uint32_t a, std::uint32_t b) {
+													 return lexicographicLess(p[a], p[b]);
+												 });
+				std::vector<std::uint32_t> first;
+				for(std::size_t i = 0; i < count; ++i) {
+					if(i == 0 || !samePoint(p[order[i - 1]], p[order[i]])) {
+						first.push_back(order[i]);
+					}
+				}
+				for(std::size_t i = 0; i < first.size(); ++i) {
+					const Point2<S> &v = sites[first[i]];
+					rectangle();
+					if(i > 0) {
+						bisect(v, sites[first[i - 1]]);
+					}
+					if(i + 1 < first.size()) {
+						bisect(v, sites[first[i + 1]]);
+					}
+					store(first[i]);
+				}
+			}
+			
+			/*
+			 * Write the cells to the output, given the triangulation the
+			 * cells were sized from.
+			 */
+			void gather(const Triangulation2 &t, Voronoi2<S> &out) {
+				const std::size_t count = sizes.size();
+				out.offsets.resize(count + 1);
+				std::uint32_t offset = 0;
+				for(std::size_t i = 0; i < count; ++i) {
+					out.offsets[i] = offset;
+					offset += sizes[i];
+				}
+				out.offsets[count] = offset;
+				out.vertices.resize(offset);
+				
+				for(std::size_t i = 0; i < records.size(); ++i) {
+					const Record &r = records[i];
+					std::copy(buffer.begin() + r.begin,
+										buffer.begin() + r.begin + sizes[r.site],
+										out.vertices.begin() + out.offsets[r.site]);
+				}
+				for(std::size_t e = 0; e < t.triangles.size(); ++e) {
+					const std::uint32_t v = t.triangles[e];
+					if(marked[v]) {
+						continue;
+					}
+					marked[v] = true;
+					Point2<S> *vertex = &out.vertices[out.offsets[v]];
+					std::uint32_t f = std::uint32_t(e);
+					do {
+						const Point2d &c = centers[f / 3];
+						*vertex++ = Point2<S>(S(c.x), S(c.y));
+						f = t.halfedges[prev(f)];
+					} while(f != e);
+				}
+			}
+			
+		private:
+			/* A cell in the side buffer */
+			struct Record {
+				std::uint32_t site, begin;
+			};
+			
+			/*
+			 * The circumcenter of a counterclockwise triangle, relative to a
+			 * and with the exact sign of the determinant, so that it is finite
+			 * for any triangle of a triangulation.
+			 */
+			static Point2d circumcenter(const Point2<S> &a, const Point2<S> &b,
+																	const Point2<S> &c)
+			{
+				const double bx = double(b.x) - a.x, by = double(b.y) - a.y;
+				const double cx = double(c.x) - a.x, cy = double(c.y) - a.y;
+				const double bl = bx * bx + by * by, cl = cx * cx + cy * cy;
+				const double d = 0.5 / orient2d(a, b, c);
+				return Point2d(a.x + (cy * bl - by * cl) * d,
+											 a.y + (bx * cl - cx * bl) * d);
+			}
+			
+			static std::uint32_t next(std::uint32_t e) {
+				return e % 3 == 2 ? e - 2 : e + 1;
+			}
+			
+			static std::uint32_t prev(std::uint32_t e) {
+				return e % 3 == 0 ? e + 2 : e - 1;
+			}
+			
+			/* Start the scratch polygon at the clipping rectangle */
+			void rectangle() {
+				polygon.clear();
+				if(x0 < x1 && y0 < y1) {
+					polygon.push_back(Point2d(x0, y0));
+					polygon.push_back(Point2d(x1, y0));
+					polygon.push_back(Point2d(x1, y1));
+					polygon.push_back(Point2d(x0, y1));
+				}
+			}
+			
+			/* Keep the part of the polygon closer to v than to w */
+			void bisect(const Point2<S> &v, const Point2<S> &w) {
+				const double a = double(w.x) - v.x, b = double(w.y) - v.y;
+				const double mx = 0.5 * (double(v.x) + w.x);
+				const double my = 0.5 * (double(v.y) + w.y);
+				clipHalfPlane(polygon, a, b, a * mx + b * my, scratch);
+				polygon.swap(scratch);
+			}
+			
+			/* Store the polygon as the cell of site v, empty without an area */
+			void store(std::size_t v) {
+				if(polygon.size() < 3) {
+					sizes[v] = 0;
+					return;
+				}
+				const Record r = { std::uint32_t(v), std::uint32_t(buffer.size()) };
+				records.push_back(r);
+				sizes[v] = std::uint32_t(polygon.size());
+				for(std::size_t i = 0; i < polygon.size(); ++i) {
+					buffer.push_back(Point2<S>(S(polygon[i].x), S(polygon[i].y)));
+				}
+			}
+			
+			/*
+			 * The cell of vertex v clipped to the rectangle, from its
+			 * half-edge e: the rectangle clipped by the bisectors to each
+			 * neighbor. Clipping the polygon of the circumcenters instead
+			 * fails when some are far away, as they are around nearly
+			 * collinear sites, while the bisectors are always well
+			 * conditioned. A vertex with a half-edge on the hull has an
+			 * unbounded cell, and e starts from its half-edge along the hull.
+			 */
+			void cell(const Triangulation2 &t, std::size_t v, std::uint32_t e) {
+				const Point2<S> &site = sites[v];
+				const std::uint32_t start = e;
+				rectangle();
+				do {
+					bisect(site, sites[t.triangles[next(e)]]);
+					const std::uint32_t p = prev(e);
+					if(t.halfedges[p] == Triangulation2::None) {
+						bisect(site, sites[t.triangles[p]]);
+						break;
+					}
+					e = t.halfedges[p];
+				} while(e != start);
+				store(v);
+			}
+			
+			const Point2<S> *sites;
+			const double x0, y0, x1, y1;
+			std::vector<Point2d> centers, polygon, scratch;
+			std::vector<std::uint32_t> sizes;
+			/* The vertices whose cells are clipped, then those written */
+			std::vector<bool> marked;
+			std::vector<Point2<S>> buffer;
+			std::vector<Record> records;
+		};
+	}
+	
+	/**
+	 * \brief Compute the Voronoi diagram of a set of sites from their
+	 * Delaunay triangulation, with every cell clipped to a rectangle.
+	 *
+	 * Each cell is the polygon of the circumcenters of the triangles around
+	 * its site, so that neighboring cells share their vertices exactly,
+	 * unless it crosses the rectangle; those cells, and the unbounded cells
+	 * of hull sites, are cut from the rectangle by the bisectors to their
+	 * neighbors.
+	 * The rectangle is taken as closed. Vertices are computed in double
+	 * precision and rounded to Scalar, which should be a floating point
+	 * type. If the triangulation has no triangles the sites are taken to be
+	 * collinear, and their cells are slabs across the rectangle. Nothing is
+	 * allocated for each cell, and the storage of out is reused.
+	 *
+	 * \arg \c sites The sites
+	 * \arg \c count The number of sites
+	 * \arg \c triangulation The Delaunay triangulation of the sites
+	 * \arg \c bounds The rectangle to clip the cells to
+	 * \arg \c out Receives the cells, one for each site
+	 * \see delaunay
+	 */
+	template <typename Scalar>
+	void voronoi(const Point2<Scalar> *sites, std::size_t count,
+							 const Triangulation2 &triangulation,
+							 const Rectangle2<Scalar> &bounds, Voronoi2<Scalar> &out)
+	{
+		detail::VoronoiBuilder<Scalar> builder(sites, count, bounds);
+		if(triangulation.triangles.empty()) {
+			builder.buildCollinear();
+		} else {
+			builder.build(triangulation);
+		}
+		builder.gather(triangulation, out);
+	}
+	
+	/**
+	 * \brief Compute the Voronoi diagram of a set of sites, with every cell
+	 * clipped to a rectangle.
+	 * \see voronoi(const Point2<Scalar>*, std::size_t, const Triangulation2&,
+	 * const Rectangle2<Scalar>&, Voronoi2<Scalar>&)
+	 */
+	template <typename Scalar>
+	void voronoi(const Point2<Scalar> *sites, std::size_t count,
+							 const Rectangle2<Scalar> &bounds, Voronoi2<Scalar> &out)
+	{
+		Triangulation2 triangulation;
+		delaunay(sites, count, triangulation);
+		voronoi(sites, count, triangulation, bounds, out);
+	}
+}
+
+#endif
@@ -0,0 +1,97 @@
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "geom/Affine3.hpp"
+
+namespace {
+	/* Integer valued transformations make every product exact in any type */
+	const geom::Affine3i A(1, 2, 3, 4,
+												 5, 6, 7, 8,
+												 9, 10, 11, 12);
+	const geom::Affine3i B(-2, 1, 0, 3,
+												 4, -1, 2, 0,
+												 1, 5, -3, 2);
+	
+	void ExpectNear(const geom::Affine3d &a, const geom::Affine3d &b) {
+		for(int i = 0; i < 12; ++i) {
+			EXPECT_NEAR(a.values[i], b.values[i], 1e-12);
+		}
+	}
+}
+
+TEST(Affine3, Construction) {
+	geom::Affine3i null;
+	for(int i = 0; i < 12; ++i) {
+		EXPECT_EQ(null.values[i], 0);
+	}
+	const int columnMajor[] = { 1,5,9, 2,6,10, 3,7,11, 4,8,12 };
+	for(int i = 0; i < 12; ++i) {
+		EXPECT_EQ(A.values[i], columnMajor[i]);
+	}
+	EXPECT_EQ(A(1,3), 8);
+	EXPECT_EQ(A(2,0), 9);
+	
+	geom::Affine3d d(A);
+	EXPECT_EQ(d, A);
+	geom::Affine3f f;
+	f = B;
+	EXPECT_EQ(f, B);
+	EXPECT_NE(f, A);
+	
+	EXPECT_EQ(geom::Affine3i(A.linear(), A.translation()), A);
+	EXPECT_EQ(A.linear(), geom::Matrix3i(1,2,3,5,6,7,9,10,11));
+	EXPECT_EQ(A.translation(), geom::Vec3i(4,8,12));
+}
+
+TEST(Affine3, Matrix4) {
+	const geom::Matrix4i m = A.toMatrix4();
+	EXPECT_EQ(m, geom::Matrix4i(1,2,3,4,5,6,7,8,9,10,11,12,0,0,0,1));
+	EXPECT_EQ(geom::Affine3i(m), A);
+	
+	EXPECT_EQ(geom::Affine3d::translate(geom::Vec3d(1,2,3)).toMatrix4(),
+						geom::Matrix4d::translate(geom::Vec3d(1,2,3)));
+	EXPECT_EQ(geom::Affine3d::scale(geom::Vec3d(1,2,3)).toMatrix4(),
+						geom::Matrix4d::scale(geom::Vec3d(1,2,3)));
+	EXPECT_EQ(geom::Affine3f::rotate(0.3f, geom::Vec3f(1,2,3)).toMatrix4(),
+						geom::Matrix4f::rotate(0.3f, geom::Vec3f(1,2,3)));
+	EXPECT_EQ(geom::Affine3i::identity().toMatrix4(),
+						geom::Matrix4i::identity());
+}
+
+TEST(Affine3, Products) {
+	EXPECT_EQ(A * B, geom::Affine3i(9, 14, -5, 13,
+																	21, 34, -9, 37,
+																	33, 54, -13, 61));
+	EXPECT_EQ((A * B).toMatrix4(), A.toMatrix4() * B.toMatrix4());
+	EXPECT_EQ(A * geom::Affine3i::identity(), A);
+	geom::Affine3i c(A);
+	c *= B;
+	EXPECT_EQ(c, A * B);
+	
+	const geom::Point3i p = A * geom::Point3i(1, -1, 2);
+	EXPECT_EQ(p.x, 9);
+	EXPECT_EQ(p.y, 21);
+	EXPECT_EQ(p.z, 33);
+	EXPECT_EQ(A * geom::Vec3i(1, -1, 2), geom::Vec3i(5, 13, 21));
+	EXPECT_EQ(A * geom::Vec3d(1, -1, 2), A.toMatrix4() * geom::Vec3d(1, -1, 2));
+}
+
+TEST(Affine3, Inverse) {
+	const geom::Affine3d m = geom::Affine3d::translate(geom::Vec3d(1,-2,3)) *
+		geom::Affine3d::rotate(0.7, geom::Vec3d(1,1,0)) *
+		geom::Affine3d::scale(geom::Vec3d(2,3,0.5));
+	ExpectNear(inverse(m) * m, geom::Affine3d::identity());
+	ExpectNear(m * inverse(m), geom::Affine3d::identity());
+	
+	const geom::Affine3d s(2, 1, 0, 1,
+												 0, 3, 1, 2,
+												 1, 0, 1, 3);
+	ExpectNear(inverse(s) * s, geom::Affine3d::identity());
+	
+	const geom::Affine3d r = geom::Affine3d::translate(geom::Vec3d(5,0,-1)) *
+		geom::Affine3d::rotate(-1.2, geom::Vec3d(0,2,1));
+	ExpectNear(inverseRigid(r), inverse(r));
+	ExpectNear(inverseRigid(r) * r, geom::Affine3d::identity());
+}
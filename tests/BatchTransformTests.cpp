@@ -0,0 +1,254 @@
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "geom/BatchTransform.hpp"
+
+using namespace geom;
+
+namespace {
+	/* 203 elements exercises every pack width and the scalar remainder */
+	const std::size_t Count = 203;
+	
+	template <typename Scalar>
+	Matrix4<Scalar> RandomMatrix4(unsigned seed) {
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(-2, 2);
+		Matrix4<Scalar> m;
+		for(int i = 0; i < 16; ++i) {
+			m.values[i] = dist(gen);
+		}
+		return m;
+	}
+	
+	template <typename Scalar>
+	Matrix3<Scalar> RandomMatrix3(unsigned seed) {
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(-2, 2);
+		Matrix3<Scalar> m;
+		for(int i = 0; i < 9; ++i) {
+			m.values[i] = dist(gen);
+		}
+		return m;
+	}
+	
+	template <typename Scalar>
+	std::vector<Point3<Scalar>> RandomPoints(std::size_t count, unsigned seed) {
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(-100, 100);
+		std::vector<Point3<Scalar>> p;
+		for(std::size_t i = 0; i < count; ++i) {
+			p.push_back(Point3<Scalar>(dist(gen), dist(gen), dist(gen)));
+		}
+		return p;
+	}
+	
+	template <typename Scalar>
+	std::vector<Vector3<Scalar>> RandomVectors(std::size_t count, unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(-100, 100);
+		std::vector<Vector3<Scalar>> v;
+		for(std::size_t i = 0; i < count; ++i) {
+			v.push_back(Vector3<Scalar>(dist(gen), dist(gen), dist(gen)));
+		}
+		return v;
+	}
+	
+	/* Compare component-wise, Point3 has no equality operator */
+	template <typename Scalar>
+	void ExpectPoint(const Point3<Scalar> &actual,
+									 const Point3<Scalar> &expected)
+	{
+		EXPECT_EQ(actual.x, expected.x);
+		EXPECT_EQ(actual.y, expected.y);
+		EXPECT_EQ(actual.z, expected.z);
+	}
+	
+	template <typename Scalar>
+	void TestPoints(unsigned seed) {
+		const Matrix4<Scalar> m = RandomMatrix4<Scalar>(seed);
+		const std::vector<Point3<Scalar>> in = RandomPoints<Scalar>(Count,
+																																seed + 1);
+		std::vector<Point3<Scalar>> out(Count);
+		transformPoints(m, in.data(), Count, out.data());
+		for(std::size_t i = 0; i < Count; ++i) {
+			ExpectPoint(out[i], m * in[i]);
+		}
+		
+		Point3SoA<Scalar> soa(in.data(), Count), soaOut(Count);
+		transformPoints(m, soa.span(), soaOut.span());
+		for(std::size_t i = 0; i < Count; ++i) {
+			const Point3<Scalar> e = m * in[i];
+			EXPECT_EQ(soaOut.x[i], e.x);
+			EXPECT_EQ(soaOut.y[i], e.y);
+			EXPECT_EQ(soaOut.z[i], e.z);
+		}
+		
+		/* Transforming in place */
+		std::vector<Point3<Scalar>> inPlace(in);
+		transformPoints(m, inPlace.data(), Count, inPlace.data());
+		Point3SoA<Scalar> soaInPlace(soa);
+		transformPoints(m, soaInPlace.span(), soaInPlace.span());
+		for(std::size_t i = 0; i < Count; ++i) {
+			ExpectPoint(inPlace[i], out[i]);
+			EXPECT_EQ(soaInPlace.x[i], soaOut.x[i]);
+			EXPECT_EQ(soaInPlace.y[i], soaOut.y[i]);
+			EXPECT_EQ(soaInPlace.z[i], soaOut.z[i]);
+		}
+	}
+	
+	template <typename Scalar>
+	void TestVectors(unsigned seed) {
+		const Matrix3<Scalar> m = RandomMatrix3<Scalar>(seed);
+		const std::vector<Vector3<Scalar>> in = RandomVectors<Scalar>(Count,
+																																	seed + 1);
+		std::vector<Vector3<Scalar>> out(Count);
+		transformVectors(m, in.data(), Count, out.data());
+		for(std::size_t i = 0; i < Count; ++i) {
+			EXPECT_EQ(out[i], m * in[i]);
+		}
+		
+		Vector3SoA<Scalar> soa(in.data(), Count), soaOut(Count);
+		transformVectors(m, soa.span(), soaOut.span());
+		for(std::size_t i = 0; i < Count; ++i) {
+			EXPECT_EQ(soaOut[i], m * in[i]);
+		}
+		
+		/* Transforming in place */
+		transformVectors(m, soa.span(), soa.span());
+		for(std::size_t i = 0; i < Count; ++i) {
+			EXPECT_EQ(soa[i], soaOut[i]);
+		}
+	}
+}
+
+TEST(BatchTransform, Points) {
+	TestPoints<float>(1);
+	TestPoints<double>(3);
+	
+	const Matrix4i m = Matrix4i::translate(Vec3i(1,2,3));
+	Point3i p[] = { Point3i(1,1,1), Point3i(-1,0,5) };
+	transformPoints(m, p, 2, p);
+	ExpectPoint(p[0], Point3i(2,3,4));
+	ExpectPoint(p[1], Point3i(0,2,8));
+}
+
+TEST(BatchTransform, Affine3) {
+	const Affine3d m(RandomMatrix4<double>(15));
+	const std::vector<Point3d> in = RandomPoints<double>(Count, 16);
+	std::vector<Point3d> out(Count);
+	transformPoints(m, in.data(), Count, out.data());
+	Point3SoAd soa(in.data(), Count);
+	transformPoints(m, soa.span(), soa.span());
+	for(std::size_t i = 0; i < Count; ++i) {
+		const Point3d e = m * in[i];
+		ExpectPoint(out[i], e);
+		EXPECT_EQ(soa.x[i], e.x);
+		EXPECT_EQ(soa.y[i], e.y);
+		EXPECT_EQ(soa.z[i], e.z);
+	}
+	
+	const Affine3f f(RandomMatrix4<float>(17));
+	const std::vector<Point3f> fin = RandomPoints<float>(Count, 18);
+	Point3SoAf fsoa(fin.data(), Count), fout(Count);
+	transformPoints(f, fsoa.span(), fout.span(), Parallel(4, 0));
+	for(std::size_t i = 0; i < Count; ++i) {
+		const Point3f e = f * fin[i];
+		EXPECT_EQ(fout.x[i], e.x);
+		EXPECT_EQ(fout.y[i], e.y);
+		EXPECT_EQ(fout.z[i], e.z);
+	}
+}
+
+TEST(BatchTransform, Vector4) {
+	const Matrix4f m = RandomMatrix4<float>(5);
+	std::mt19937 gen(6);
+	std::uniform_real_distribution<float> dist(-100, 100);
+	std::vector<Vec4f> in;
+	for(std::size_t i = 0; i < Count; ++i) {
+		in.push_back(Vec4f(dist(gen), dist(gen), dist(gen), dist(gen)));
+	}
+	std::vector<Vec4f> out(Count);
+	transformVectors(m, in.data(), Count, out.data());
+	for(std::size_t i = 0; i < Count; ++i) {
+		EXPECT_EQ(out[i], m * in[i]);
+	}
+	
+	const Matrix4d md(m);
+	std::vector<Vec4d> ind(in.begin(), in.end()), outd(Count);
+	transformVectors(md, ind.data(), Count, outd.data());
+	for(std::size_t i = 0; i < Count; ++i) {
+		EXPECT_EQ(outd[i], md * ind[i]);
+	}
+}
+
+TEST(BatchTransform, Vector3) {
+	TestVectors<float>(7);
+	TestVectors<double>(9);
+	
+	Vec3SoAi v;
+	v.push_back(Vec3i(1,2,3));
+	const Matrix3i m(0,-1,0, 1,0,0, 0,0,2);
+	transformVectors(m, v.span(), v.span());
+	EXPECT_EQ(v[0], Vec3i(-2,1,6));
+}
+
+TEST(BatchTransform, Parallel) {
+	/* A low threshold forces the work onto several threads */
+	const Parallel parallel(4, 0);
+	const std::size_t count = 10007;
+	const Matrix4f m = RandomMatrix4<float>(11);
+	const std::vector<Point3f> in = RandomPoints<float>(count, 12);
+	std::vector<Point3f> serial(count), threaded(count);
+	transformPoints(m, in.data(), count, serial.data());
+	transformPoints(m, in.data(), count, threaded.data(), parallel);
+	Point3SoAf soa(in.data(), count);
+	transformPoints(m, soa.span(), soa.span(), parallel);
+	for(std::size_t i = 0; i < count; ++i) {
+		ExpectPoint(threaded[i], serial[i]);
+		EXPECT_EQ(soa.x[i], serial[i].x);
+		EXPECT_EQ(soa.y[i], serial[i].y);
+		EXPECT_EQ(soa.z[i], serial[i].z);
+	}
+	
+	const Matrix3d r = RandomMatrix3<double>(13);
+	const std::vector<Vec3d> vin = RandomVectors<double>(count, 14);
+	std::vector<Vec3d> vout(count);
+	transformVectors(r, vin.data(), count, vout.data(), parallel);
+	Vec3SoAd vsoa(vin.data(), count), vsoaOut(count);
+	transformVectors(r, vsoa.span(), vsoaOut.span(), parallel);
+	for(std::size_t i = 0; i < count; ++i) {
+		EXPECT_EQ(vout[i], r * vin[i]);
+		EXPECT_EQ(vsoaOut[i], r * vin[i]);
+	}
+}
+
+TEST(BatchTransform, Inverse) {
+	std::vector<Matrix4d> m;
+	for(unsigned i = 0; i < 37; ++i) {
+		m.push_back(Matrix4d::translate(Vec3d(i, 1, -2.5)) *
+								Matrix4d::rotate(0.1 * i, Vec3d(1, 2, i)));
+	}
+	std::vector<Matrix4d> general(m.size()), rigid(m.size());
+	inverse(m.data(), m.size(), general.data());
+	inverse(m.data(), m.size(), rigid.data(), MatrixKind::Rigid);
+	for(std::size_t i = 0; i < m.size(); ++i) {
+		EXPECT_EQ(general[i], inverse(m[i]));
+		EXPECT_EQ(rigid[i], inverseRigid(m[i]));
+	}
+	
+	/* Inverting in place on several threads */
+	const std::size_t count = 1000;
+	std::vector<Matrix4f> f(count);
+	for(std::size_t i = 0; i < count; ++i) {
+		f[i] = RandomMatrix4<float>(unsigned(i));
+	}
+	std::vector<Matrix4f> g(f);
+	inverse(g.data(), count, g.data(), MatrixKind::General, Parallel(4, 0));
+	for(std::size_t i = 0; i < count; ++i) {
+		EXPECT_EQ(g[i], inverse(f[i]));
+	}
+}
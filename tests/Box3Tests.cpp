@@ -0,0 +1,185 @@
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "geom/Box3.hpp"
+
+using namespace geom;
+
+namespace {
+	/* Random boxes around the origin and rays aimed roughly at them */
+	template <typename Scalar>
+	std::vector<Box3<Scalar>> RandomBoxes(std::size_t count, unsigned seed) {
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> center(-3, 1), size(0, 4);
+		std::vector<Box3<Scalar>> boxes;
+		for(std::size_t i = 0; i < count; ++i) {
+			const Point3<Scalar> o(center(gen), center(gen), center(gen));
+			boxes.push_back(Box3<Scalar>(
+				o, Dimensions3<Scalar>(size(gen), size(gen), size(gen))));
+		}
+		return boxes;
+	}
+	template <typename Scalar>
+	std::vector<Ray3<Scalar>> RandomRays(std::size_t count, unsigned seed) {
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(-1, 1);
+		std::vector<Ray3<Scalar>> rays;
+		for(std::size_t i = 0; i < count; ++i) {
+			const Point3<Scalar> o(8 * dist(gen), 8 * dist(gen), 8 * dist(gen));
+			/* Some rays are parallel to an axis */
+			const Vector3<Scalar> d(i % 5 == 0 ? 0 : dist(gen) - o.x / 8,
+															i % 7 == 0 ? 0 : dist(gen) - o.y / 8,
+															dist(gen) - o.z / 8);
+			rays.push_back(Ray3<Scalar>(o, d));
+		}
+		return rays;
+	}
+	
+	bool Bit(const std::vector<std::uint32_t> &mask, std::size_t i) {
+		return (mask[i / 32] >> (i % 32)) & 1;
+	}
+	
+	/* 45 pairs exercises every pack width as well as the scalar remainder */
+	template <typename Scalar>
+	void CheckBatches() {
+		const std::size_t count = 45;
+		const std::vector<Box3<Scalar>> boxes = RandomBoxes<Scalar>(count, 1);
+		const std::vector<Ray3<Scalar>> rays = RandomRays<Scalar>(count, 2);
+		Point3SoA<Scalar> mins, maxs, origins;
+		Vector3SoA<Scalar> directions;
+		std::vector<Scalar> tMax(count);
+		for(std::size_t i = 0; i < count; ++i) {
+			mins.push_back(boxes[i].min);
+			maxs.push_back(boxes[i].max);
+			origins.push_back(rays[i].origin);
+			directions.push_back(rays[i].direction);
+			tMax[i] = Scalar(i % 3 == 0 ? 8 : 100);
+		}
+		
+		std::size_t hitCount = 0;
+		for(std::size_t r = 0; r < count; ++r) {
+			std::vector<Scalar> t(count), ts(count);
+			std::vector<std::uint32_t> hits(2, ~0u), hitsSoA(2, ~0u);
+			intersect(rays[r], boxes.data(), count, tMax[r], t.data(),
+								hits.data());
+			intersect(rays[r], mins.span(), maxs.span(), tMax[r], ts.data(),
+								hitsSoA.data());
+			EXPECT_EQ(hits, hitsSoA);
+			EXPECT_EQ(hits[1] >> (count - 32), 0u);
+			for(std::size_t i = 0; i < count; ++i) {
+				Scalar expected;
+				const bool hit = intersect(rays[r], boxes[i], expected, tMax[r]);
+				EXPECT_EQ(Bit(hits, i), hit);
+				EXPECT_EQ(t[i], expected);
+				EXPECT_EQ(ts[i], expected);
+				hitCount += hit;
+			}
+			
+			/* The packet of every ray against box r */
+			std::vector<Scalar> tp(count);
+			std::vector<std::uint32_t> packet(2, ~0u);
+			intersect(origins.span(), directions.span(), boxes[r], tMax.data(),
+								tp.data(), packet.data());
+			for(std::size_t i = 0; i < count; ++i) {
+				Scalar expected;
+				EXPECT_EQ(Bit(packet, i),
+									intersect(rays[i], boxes[r], expected, tMax[i]));
+				EXPECT_EQ(tp[i], expected);
+			}
+		}
+		/* Both hits and misses are tested */
+		EXPECT_GT(hitCount, count / 2);
+		EXPECT_LT(hitCount, count * count / 2);
+	}
+}
+
+TEST(Box3, Construction) {
+	const Box3i empty;
+	EXPECT_TRUE(geom::empty(empty));
+	const Box3i b(Point3i(1, 2, 3), Dimensions3i(2, 3, 4));
+	EXPECT_EQ(b, Box3i(Point3i(1, 2, 3), Point3i(3, 5, 7)));
+	EXPECT_NE(b, empty);
+	EXPECT_FALSE(geom::empty(b));
+	EXPECT_EQ(Box3d(b).max.z, 7.0);
+	EXPECT_FALSE(geom::empty(Box3f(Point3f(1, 1, 1), Point3f(1, 1, 1))));
+}
+
+TEST(Box3, Operations) {
+	const Box3i a(Point3i(0, 0, 0), Point3i(2, 2, 2));
+	const Box3i b(Point3i(1, -1, 1), Point3i(3, 1, 4));
+	EXPECT_EQ(join(a, b), Box3i(Point3i(0, -1, 0), Point3i(3, 2, 4)));
+	EXPECT_EQ(intersection(a, b), Box3i(Point3i(1, 0, 1), Point3i(2, 1, 2)));
+	EXPECT_TRUE(overlaps(a, b));
+	EXPECT_EQ(join(Box3i(), a), a);
+	EXPECT_EQ(join(join(Box3i(), Point3i(1, 2, 3)), Point3i(0, 5, 3)),
+						Box3i(Point3i(0, 2, 3), Point3i(1, 5, 3)));
+	
+	/* Boxes touching at a face overlap, since they are closed */
+	const Box3i c(Point3i(2, 0, 0), Point3i(4, 2, 2));
+	EXPECT_TRUE(overlaps(a, c));
+	EXPECT_FALSE(overlaps(a, Box3i(Point3i(3, 0, 0), Point3i(4, 2, 2))));
+	EXPECT_TRUE(empty(intersection(a, Box3i(Point3i(0, 3, 0),
+																					Point3i(2, 4, 2)))));
+	
+	EXPECT_TRUE(contains(a, Point3i(2, 0, 1)));
+	EXPECT_FALSE(contains(a, Point3i(2, 0, 3)));
+	EXPECT_TRUE(contains(a, intersection(a, b)));
+	EXPECT_FALSE(contains(a, b));
+	EXPECT_TRUE(contains(a, Box3i()));
+	EXPECT_FALSE(contains(Box3i(), a));
+	
+	EXPECT_EQ(surfaceArea(b), 2 * (2 * 2 + 2 * 3 + 3 * 2));
+	EXPECT_EQ(volume(b), 12);
+	EXPECT_EQ(surfaceArea(Box3i()), 0);
+	EXPECT_EQ(volume(Box3f()), 0.0f);
+	EXPECT_EQ(dimensions(b).depth, 3);
+}
+
+TEST(Box3, Ray) {
+	const Box3d box(Point3d(1, 1, 1), Point3d(3, 2, 4));
+	double t;
+	EXPECT_TRUE(intersect(Ray3d(Point3d(0, 0, 0), Vec3d(1, 1, 1)), box, t));
+	EXPECT_EQ(t, 1.0);
+	EXPECT_EQ(Ray3d(Point3d(0, 0, 0), Vec3d(1, 1, 1)).at(t).x, 1.0);
+	EXPECT_TRUE(intersect(Ray3d(Point3d(5, 1.5, 2), Vec3d(-2, 0, 0)), box, t));
+	EXPECT_EQ(t, 1.0);
+	
+	/* Origins inside the box hit at zero */
+	EXPECT_TRUE(intersect(Ray3d(Point3d(2, 1.5, 2), Vec3d(0, 0, -1)), box, t));
+	EXPECT_EQ(t, 0.0);
+	
+	/* Misses, boxes behind the ray and beyond tMax */
+	const double inf = std::numeric_limits<double>::infinity();
+	EXPECT_FALSE(intersect(Ray3d(Point3d(0, 0, 0), Vec3d(1, 0, 0)), box, t));
+	EXPECT_EQ(t, inf);
+	EXPECT_FALSE(intersect(Ray3d(Point3d(5, 1.5, 2), Vec3d(1, 0, 0)), box, t));
+	EXPECT_FALSE(intersect(Ray3d(Point3d(5, 1.5, 2), Vec3d(-1, 0, 0)), box, t,
+												 1.5));
+	EXPECT_TRUE(intersect(Ray3d(Point3d(5, 1.5, 2), Vec3d(-1, 0, 0)), box, t,
+												2.0));
+	EXPECT_FALSE(intersect(Ray3d(Point3d(0, 5, 0), Vec3d(1, 0, 1)), box, t));
+	
+	/* A ray in the plane of a face is decided the same way in both passes */
+	Box3f boxes[4] = {
+		Box3f(box), Box3f(box), Box3f(box), Box3f(box)
+	};
+	const Ray3f ray(Point3f(0, 1, 2), Vec3f(1, 0, 0));
+	float ts[4];
+	std::uint32_t hits;
+	intersect(ray, boxes, 4, std::numeric_limits<float>::infinity(), ts,
+						&hits);
+	float single;
+	EXPECT_EQ(hits & 1, std::uint32_t(intersect(ray, boxes[0], single)));
+	EXPECT_EQ(ts[0], single);
+	EXPECT_EQ(hits, (hits & 1) * 15);
+}
+
+TEST(Box3, Batch) {
+	CheckBatches<float>();
+	CheckBatches<double>();
+}
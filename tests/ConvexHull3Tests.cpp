@@ -0,0 +1,355 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "geom/ConvexHull3.hpp"
+
+using namespace geom;
+
+namespace {
+	typedef std::array<std::uint32_t, 3> Triple;
+	
+	/*
+	 * The hull is a closed triangle mesh with consistent half-edges, whose
+	 * vertices are the input points they index, and which has every vertex,
+	 * and if it is complete every input point, on or below each face.
+	 */
+	template <typename Scalar>
+	void ExpectHull(const std::vector<Point3<Scalar>> &points,
+									const ConvexHull3<Scalar> &hull, bool complete = true)
+	{
+		const std::size_t v = hull.vertices.size(), e = hull.edges.size();
+		const std::size_t f = hull.faces.size();
+		ASSERT_GE(v, 4u);
+		ASSERT_EQ(e, 3 * f);
+		ASSERT_EQ(hull.indices.size(), v);
+		EXPECT_EQ(v + f, e / 2 + 2);
+		for(std::size_t i = 0; i < e; ++i) {
+			const HalfEdge &h = hull.edges[i];
+			ASSERT_LT(h.twin, e);
+			ASSERT_LT(h.next, e);
+			EXPECT_EQ(hull.edges[h.twin].twin, i);
+			EXPECT_EQ(hull.edges[h.twin].vertex, hull.edges[h.next].vertex);
+			EXPECT_EQ(hull.edges[h.next].face, h.face);
+			EXPECT_EQ(hull.edges[hull.edges[h.next].next].next, i);
+		}
+		for(std::size_t i = 0; i < v; ++i) {
+			const Point3<Scalar> &p = points[hull.indices[i]];
+			EXPECT_EQ(hull.vertices[i].x, p.x);
+			EXPECT_EQ(hull.vertices[i].y, p.y);
+			EXPECT_EQ(hull.vertices[i].z, p.z);
+		}
+		
+		std::size_t above = 0;
+		for(std::size_t i = 0; i < f; ++i) {
+			const HalfEdge &h = hull.edges[hull.faces[i]];
+			EXPECT_EQ(h.face, i);
+			const Point3<Scalar> &a = hull.vertices[h.vertex];
+			const Point3<Scalar> &b = hull.vertices[hull.edges[h.next].vertex];
+			const Point3<Scalar> &c =
+				hull.vertices[hull.edges[hull.edges[h.next].next].vertex];
+			for(std::size_t j = 0; j < v; ++j) {
+				above += orient3d(a, b, c, hull.vertices[j]) < 0;
+			}
+			for(std::size_t j = 0; complete && j < points.size(); ++j) {
+				above += orient3d(a, b, c, points[j]) < 0;
+			}
+		}
+		EXPECT_EQ(above, 0u);
+	}
+	
+	/* The faces as sorted triples of input indices */
+	template <typename Scalar>
+	std::vector<Triple> Faces(const ConvexHull3<Scalar> &hull) {
+		std::vector<Triple> faces;
+		for(std::size_t i = 0; i < hull.faces.size(); ++i) {
+			Triple t;
+			std::uint32_t e = hull.faces[i];
+			for(int k = 0; k < 3; ++k, e = hull.edges[e].next) {
+				t[k] = hull.indices[hull.edges[e].vertex];
+			}
+			std::sort(t.begin(), t.end());
+			faces.push_back(t);
+		}
+		std::sort(faces.begin(), faces.end());
+		return faces;
+	}
+	
+	/* The faces of points in general position, testing every triple */
+	template <typename Scalar>
+	std::vector<Triple> BruteForce(const std::vector<Point3<Scalar>> &points) {
+		std::vector<Triple> faces;
+		const std::uint32_t n = std::uint32_t(points.size());
+		for(std::uint32_t i = 0; i < n; ++i) {
+			for(std::uint32_t j = i + 1; j < n; ++j) {
+				for(std::uint32_t k = j + 1; k < n; ++k) {
+					int below = 0, above = 0;
+					for(std::uint32_t l = 0; l < n; ++l) {
+						const double o = orient3d(points[i], points[j], points[k],
+																			points[l]);
+						below += o > 0;
+						above += o < 0;
+					}
+					if(below == 0 || above == 0) {
+						const Triple t = {{ i, j, k }};
+						faces.push_back(t);
+					}
+				}
+			}
+		}
+		return faces;
+	}
+	
+	std::vector<std::uint32_t> Sorted(std::vector<std::uint32_t> indices) {
+		std::sort(indices.begin(), indices.end());
+		return indices;
+	}
+	
+	/* The farthest any point lies outside the planes of the hull faces */
+	double Outside(const std::vector<Point3d> &points,
+								 const ConvexHull3<double> &hull)
+	{
+		double outside = 0;
+		for(std::size_t i = 0; i < hull.faces.size(); ++i) {
+			const HalfEdge &h = hull.edges[hull.faces[i]];
+			const Point3d &a = hull.vertices[h.vertex];
+			const Point3d &b = hull.vertices[hull.edges[h.next].vertex];
+			const Point3d &c =
+				hull.vertices[hull.edges[hull.edges[h.next].next].vertex];
+			const double ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+			const double vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+			const double nx = uy * vz - uz * vy, ny = uz * vx - ux * vz;
+			const double nz = ux * vy - uy * vx;
+			const double length = std::sqrt(nx * nx + ny * ny + nz * nz);
+			for(std::size_t j = 0; j < points.size(); ++j) {
+				const Point3d &p = points[j];
+				const double d = ((p.x - a.x) * nx + (p.y - a.y) * ny +
+													(p.z - a.z) * nz) / length;
+				outside = std::max(outside, d);
+			}
+		}
+		return outside;
+	}
+	
+	template <typename Scalar>
+	std::vector<Point3<Scalar>> Ball(std::size_t count, double radius,
+																	 unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<double> dist(-1, 1);
+		std::vector<Point3<Scalar>> points;
+		while(points.size() < count) {
+			const double x = dist(gen), y = dist(gen), z = dist(gen);
+			if(x * x + y * y + z * z <= 1) {
+				points.push_back(Point3<Scalar>(Scalar(radius * x),
+																				Scalar(radius * y),
+																				Scalar(radius * z)));
+			}
+		}
+		return points;
+	}
+}
+
+TEST(ConvexHull3, Small) {
+	/* A tetrahedron with a point inside */
+	std::vector<Point3d> points;
+	points.push_back(Point3d(0, 0, 0));
+	points.push_back(Point3d(0, 1, 0));
+	points.push_back(Point3d(1, 0, 0));
+	points.push_back(Point3d(0.25, 0.25, 0.25));
+	points.push_back(Point3d(0, 0, 1));
+	ConvexHull3<double> hull;
+	ASSERT_TRUE(convexHull(points.data(), points.size(), hull));
+	ExpectHull(points, hull);
+	EXPECT_EQ(hull.faces.size(), 4u);
+	const std::uint32_t expected[] = { 0, 1, 2, 4 };
+	EXPECT_EQ(Sorted(hull.indices),
+						std::vector<std::uint32_t>(expected, expected + 4));
+	
+	/* A grid of 5^3 points, whose hull is the cube of its corners */
+	std::vector<Point3i> grid;
+	for(int x = 0; x <= 4; ++x) {
+		for(int y = 0; y <= 4; ++y) {
+			for(int z = 0; z <= 4; ++z) {
+				grid.push_back(Point3i(x, y, z));
+			}
+		}
+	}
+	grid.insert(grid.end(), grid.begin(), grid.end());
+	ConvexHull3<int> cube;
+	ASSERT_TRUE(convexHull(grid.data(), grid.size(), cube));
+	ExpectHull(grid, cube);
+	double volume = 0;
+	for(std::size_t i = 0; i < cube.faces.size(); ++i) {
+		const HalfEdge &h = cube.edges[cube.faces[i]];
+		const std::uint32_t n = h.next, nn = cube.edges[n].next;
+		volume += orient3d(cube.vertices[h.vertex],
+											 cube.vertices[cube.edges[n].vertex],
+											 cube.vertices[cube.edges[nn].vertex], Point3i(2, 2, 2));
+	}
+	EXPECT_EQ(volume, 6 * 64);
+	for(std::size_t i = 0; i < cube.vertices.size(); ++i) {
+		const Point3i &p = cube.vertices[i];
+		EXPECT_TRUE(p.x % 4 == 0 || p.y % 4 == 0 || p.z % 4 == 0);
+	}
+}
+
+TEST(ConvexHull3, Degenerate) {
+	ConvexHull3<double> hull;
+	hull.faces.push_back(0);
+	std::vector<Point3d> points;
+	EXPECT_FALSE(convexHull(points.data(), 0, hull));
+	EXPECT_TRUE(hull.faces.empty());
+	
+	/* Equal, collinear and coplanar points */
+	points.assign(10, Point3d(1, 2, 3));
+	EXPECT_FALSE(convexHull(points.data(), points.size(), hull));
+	for(int i = 0; i < 10; ++i) {
+		points.push_back(Point3d(1 + i, 2 + 2 * i, 3 - i));
+	}
+	EXPECT_FALSE(convexHull(points.data(), points.size(), hull));
+	for(int i = 0; i < 10; ++i) {
+		points.push_back(Point3d(1 + i + i * i, 2 + 2 * i, 3 - i + i * i));
+	}
+	EXPECT_FALSE(convexHull(points.data(), points.size(), hull));
+	EXPECT_TRUE(hull.vertices.empty());
+	
+	/* One point off the plane makes a pyramid */
+	points.push_back(Point3d(3, 1, 0));
+	ASSERT_TRUE(convexHull(points.data(), points.size(), hull));
+	ExpectHull(points, hull);
+	EXPECT_NE(std::find(hull.indices.begin(), hull.indices.end(),
+										points.size() - 1), hull.indices.end());
+}
+
+TEST(ConvexHull3, NearlyCoplanar) {
+	/*
+	 * Points on the plane x + y + z = 1, rounded, so that orientations of
+	 * nearby points are decided exactly, and points one ulp off it.
+	 */
+	std::mt19937 gen(5);
+	std::uniform_real_distribution<double> dist(0, 1);
+	std::vector<Point3d> points;
+	for(int i = 0; i < 300; ++i) {
+		const double x = dist(gen), y = dist(gen) * (1 - x);
+		double z = 1 - x - y;
+		if(i % 10 == 0) {
+			z = std::nextafter(z, 2.0);
+		}
+		points.push_back(Point3d(x, y, z));
+	}
+	points.push_back(Point3d(0.2, 0.2, 0.2));
+	ConvexHull3<double> hull;
+	ASSERT_TRUE(convexHull(points.data(), points.size(), hull));
+	ExpectHull(points, hull);
+	
+	std::vector<Point3f> f;
+	for(int i = 0; i < 300; ++i) {
+		const float x = float(dist(gen)), y = float(dist(gen));
+		f.push_back(Point3f(x, y, std::nextafter(x + y, 0.0f)));
+		f.push_back(Point3f(x, y, x + y));
+	}
+	f.push_back(Point3f(0, 1, 0));
+	ConvexHull3<float> flat;
+	ASSERT_TRUE(convexHull(f.data(), f.size(), flat));
+	ExpectHull(f, flat);
+}
+
+TEST(ConvexHull3, Random) {
+	/* Points in general position have the faces found by brute force */
+	std::vector<Point3d> small = Ball<double>(40, 1, 1);
+	ConvexHull3<double> hull;
+	ASSERT_TRUE(convexHull(small.data(), small.size(), hull));
+	ExpectHull(small, hull);
+	EXPECT_EQ(Faces(hull), BruteForce(small));
+	
+	const std::vector<Point3d> ball = Ball<double>(2000, 10, 2);
+	ASSERT_TRUE(convexHull(ball.data(), ball.size(), hull));
+	ExpectHull(ball, hull);
+	
+	/* Points on a sphere are almost all vertices */
+	std::vector<Point3f> sphere = Ball<float>(2000, 1, 3);
+	for(std::size_t i = 0; i < sphere.size(); ++i) {
+		Point3f &p = sphere[i];
+		const float r = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+		p = Point3f(p.x / r, p.y / r, p.z / r);
+	}
+	ConvexHull3<float> round;
+	ASSERT_TRUE(convexHull(sphere.data(), sphere.size(), round));
+	ExpectHull(sphere, round);
+	EXPECT_GT(round.vertices.size(), 1900u);
+}
+
+TEST(ConvexHull3, Simplified) {
+	const std::vector<Point3d> ball = Ball<double>(5000, 1, 4);
+	ConvexHull3<double> full, simple;
+	ASSERT_TRUE(convexHull(ball.data(), ball.size(), full));
+	ASSERT_TRUE(convexHull(ball.data(), ball.size(), simple, 32));
+	ExpectHull(ball, simple, false);
+	EXPECT_EQ(simple.vertices.size(), 32u);
+	
+	/* Its vertices are vertices of the full hull */
+	const std::vector<std::uint32_t> vertices = Sorted(full.indices);
+	for(std::size_t i = 0; i < simple.indices.size(); ++i) {
+		EXPECT_TRUE(std::binary_search(vertices.begin(), vertices.end(),
+																	 simple.indices[i]));
+	}
+	
+	/* A budget above the size of the hull gives the full hull */
+	ASSERT_TRUE(convexHull(ball.data(), ball.size(), simple, 100000));
+	EXPECT_EQ(Faces(simple), Faces(full));
+	ASSERT_TRUE(convexHull(ball.data(), ball.size(), simple, 1));
+	EXPECT_EQ(simple.vertices.size(), 4u);
+}
+
+TEST(ConvexHull3, SimplifiedShape) {
+	std::mt19937 gen(6);
+	std::normal_distribution<double> dist;
+	std::vector<Point3d> sphere;
+	while(sphere.size() < 20000) {
+		const double x = dist(gen), y = dist(gen), z = dist(gen);
+		const double r = std::sqrt(x * x + y * y + z * z);
+		if(r > 0) {
+			sphere.push_back(Point3d(x / r, y / r, z / r));
+		}
+	}
+	
+	/* The vertices kept spread out, so no point is left far outside */
+	double last = std::numeric_limits<double>::infinity();
+	const std::size_t budgets[] = { 16, 64, 256 };
+	for(std::size_t b = 0; b < 3; ++b) {
+		ConvexHull3<double> simple;
+		ASSERT_TRUE(convexHull(sphere.data(), sphere.size(), simple,
+													 budgets[b]));
+		EXPECT_EQ(simple.vertices.size(), budgets[b]);
+		const double outside = Outside(sphere, simple);
+		EXPECT_LT(outside, last);
+		last = outside;
+	}
+	EXPECT_LT(last, 0.05);
+}
+
+TEST(ConvexHull3, Parallel) {
+	const std::vector<Point3f> ball = Ball<float>(20000, 1, 5);
+	ConvexHull3<float> serial, threaded;
+	ASSERT_TRUE(convexHull(ball.data(), ball.size(), serial));
+	ASSERT_TRUE(convexHull(ball.data(), ball.size(), threaded, 0,
+												 Parallel(4, 1000)));
+	ExpectHull(ball, threaded);
+	EXPECT_EQ(Faces(threaded), Faces(serial));
+	
+	/* A range may be coplanar */
+	std::vector<Point3f> slab(5000, Point3f(0, 0, 0));
+	for(std::size_t i = 0; i < slab.size(); ++i) {
+		slab[i] = Point3f(float(i % 71), float(i % 13), i < 4000 ? 0 : 1);
+	}
+	ASSERT_TRUE(convexHull(slab.data(), slab.size(), threaded, 0,
+												 Parallel(4, 1000)));
+	ExpectHull(slab, threaded);
+}
@@ -0,0 +1,194 @@
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "geom/ConvexHull.hpp"
+
+using namespace geom;
+
+namespace {
+	/* The orientation of three integer points computed in 128 bits */
+	int Orientation(const Point2l &a, const Point2l &b, const Point2l &c) {
+		const __int128 d = __int128(a.x - c.x) * (b.y - c.y) -
+			__int128(a.y - c.y) * (b.x - c.x);
+		return d > 0 ? 1 : (d < 0 ? -1 : 0);
+	}
+	
+	template <typename Scalar>
+	void ExpectEqual(const std::vector<Point2<Scalar>> &actual,
+									 const std::vector<Point2<Scalar>> &expected)
+	{
+		ASSERT_EQ(actual.size(), expected.size());
+		for(std::size_t i = 0; i < actual.size(); ++i) {
+			EXPECT_EQ(actual[i].x, expected[i].x);
+			EXPECT_EQ(actual[i].y, expected[i].y);
+		}
+	}
+	
+	/*
+	 * The hull is strictly convex, counterclockwise from its least point and
+	 * has every point inside or on it, and the same vertices as the monotone
+	 * chain over all points, without the filter or threads.
+	 */
+	template <typename Scalar>
+	void ExpectHull(const std::vector<Point2<Scalar>> &points,
+									const Parallel &parallel = Parallel::serial())
+	{
+		std::vector<Point2<Scalar>> hull;
+		convexHull(points.data(), points.size(), hull, parallel);
+		ASSERT_GE(hull.size(), 3u);
+		for(std::size_t i = 1; i < hull.size(); ++i) {
+			EXPECT_TRUE(detail::lexicographicLess(hull[0], hull[i]));
+		}
+		for(std::size_t i = 0; i < hull.size(); ++i) {
+			const Point2<Scalar> &a = hull[i], &b = hull[(i + 1) % hull.size()];
+			EXPECT_GT(orient2d(a, b, hull[(i + 2) % hull.size()]), 0);
+			for(std::size_t j = 0; j < points.size(); j += 7) {
+				EXPECT_GE(orient2d(a, b, points[j]), 0);
+			}
+		}
+		
+		std::vector<Point2<Scalar>> all(points), expected;
+		detail::monotoneChain(all, expected);
+		ExpectEqual(hull, expected);
+	}
+	
+	template <typename Scalar>
+	std::vector<Point2<Scalar>> Disc(std::size_t count, Scalar radius,
+																	 unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<double> dist(-1, 1);
+		std::vector<Point2<Scalar>> points;
+		while(points.size() < count) {
+			const double x = dist(gen), y = dist(gen);
+			if(x * x + y * y <= 1) {
+				points.push_back(Point2<Scalar>(Scalar(radius * x),
+																				Scalar(radius * y)));
+			}
+		}
+		return points;
+	}
+}
+
+TEST(ConvexHull, Small) {
+	/* A square with points inside, on its edges and repeated */
+	std::vector<Point2i> points;
+	for(int x = 0; x <= 4; ++x) {
+		for(int y = 0; y <= 4; ++y) {
+			points.push_back(Point2i(4 - x, y));
+			points.push_back(Point2i(x, 4 - y));
+		}
+	}
+	std::vector<Point2i> hull;
+	convexHull(points.data(), points.size(), hull);
+	std::vector<Point2i> expected;
+	expected.push_back(Point2i(0, 0));
+	expected.push_back(Point2i(4, 0));
+	expected.push_back(Point2i(4, 4));
+	expected.push_back(Point2i(0, 4));
+	ExpectEqual(hull, expected);
+	
+	/* An octagon, which is the polygon of the filter itself */
+	std::vector<Point2d> octagon;
+	const double c[8][2] = {
+		{ -2, 1 }, { -2, -1 }, { -1, -2 }, { 1, -2 }, { 2, -1 }, { 2, 1 },
+		{ 1, 2 }, { -1, 2 }
+	};
+	for(int i = 0; i < 8; ++i) {
+		octagon.push_back(Point2d(c[i][0], c[i][1]));
+		octagon.push_back(Point2d(c[i][0] / 2, c[i][1] / 2));
+	}
+	ExpectHull(octagon);
+	std::vector<Point2d> h;
+	convexHull(octagon.data(), octagon.size(), h);
+	EXPECT_EQ(h.size(), 8u);
+}
+
+TEST(ConvexHull, Degenerate) {
+	std::vector<Point2f> points, hull(3);
+	convexHull(points.data(), 0, hull);
+	EXPECT_TRUE(hull.empty());
+	
+	points.assign(100, Point2f(1.5f, -2));
+	convexHull(points.data(), points.size(), hull);
+	ASSERT_EQ(hull.size(), 1u);
+	EXPECT_EQ(hull[0].x, 1.5f);
+	
+	/* Collinear points give the end points */
+	for(int i = 0; i < 100; ++i) {
+		points[i] = Point2f(float(i % 37), float(2 * (i % 37)));
+	}
+	convexHull(points.data(), points.size(), hull);
+	ASSERT_EQ(hull.size(), 2u);
+	EXPECT_EQ(hull[0].x, 0);
+	EXPECT_EQ(hull[1].x, 36);
+	EXPECT_EQ(hull[1].y, 72);
+	
+	/* A collinear set and one point off the line */
+	points.push_back(Point2f(10, 0));
+	convexHull(points.data(), points.size(), hull);
+	EXPECT_EQ(hull.size(), 3u);
+}
+
+TEST(ConvexHull, Random) {
+	ExpectHull(Disc<double>(20000, 1, 1));
+	ExpectHull(Disc<float>(20000, 100, 2));
+	ExpectHull(Disc<std::int32_t>(20000, 1 << 30, 3));
+	ExpectHull(Disc<std::int64_t>(5000, std::int64_t(1) << 61, 4));
+	
+	/* Points on a circle are nearly all on the hull */
+	std::vector<Point2d> circle;
+	for(int i = 0; i < 1000; ++i) {
+		circle.push_back(Point2d(std::cos(i * 0.00628), std::sin(i * 0.00628)));
+	}
+	ExpectHull(circle);
+}
+
+TEST(ConvexHull, NearlyCollinear) {
+	/*
+	 * Points within a few units in the last place of a line, where the
+	 * orientations computed in floating point have the wrong sign.
+	 */
+	std::mt19937 gen(5);
+	std::uniform_real_distribution<double> dist(0, 1);
+	std::vector<Point2d> points;
+	for(int i = 0; i < 2000; ++i) {
+		const double x = 0.5 + dist(gen);
+		double y = x;
+		for(int k = int(dist(gen) * 6); k > 0; --k) {
+			y = std::nextafter(y, i % 2 ? 0.0 : 2.0);
+		}
+		points.push_back(Point2d(x, y));
+	}
+	ExpectHull(points);
+	
+	/* Integer points beyond the precision of doubles, checked in 128 bits */
+	const std::int64_t b = std::int64_t(1) << 60;
+	std::vector<Point2l> wide;
+	for(std::int64_t i = 0; i < 1000; ++i) {
+		wide.push_back(Point2l(i * 1000003, b + i * 1000003 + (i * 7 % 3) - 1));
+	}
+	std::vector<Point2l> hull;
+	convexHull(wide.data(), wide.size(), hull);
+	ASSERT_GE(hull.size(), 3u);
+	for(std::size_t i = 0; i < hull.size(); ++i) {
+		const Point2l &a = hull[i], &c = hull[(i + 1) % hull.size()];
+		EXPECT_EQ(Orientation(a, c, hull[(i + 2) % hull.size()]), 1);
+		for(std::size_t j = 0; j < wide.size(); ++j) {
+			EXPECT_GE(Orientation(a, c, wide[j]), 0);
+		}
+	}
+}
+
+TEST(ConvexHull, Parallel) {
+	const Parallel parallel(4, 1000);
+	ExpectHull(Disc<double>(100000, 1, 6), parallel);
+	ExpectHull(Disc<float>(100000, 1, 7), parallel);
+	ExpectHull(Disc<std::int32_t>(100000, 1000, 8), parallel);
+	ExpectHull(Disc<std::int64_t>(10000, 1000, 9), parallel);
+}
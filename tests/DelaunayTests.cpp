@@ -0,0 +1,241 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "geom/ConvexHull.hpp"
+#include "geom/Delaunay.hpp"
+
+using namespace geom;
+
+namespace {
+	template <typename Scalar>
+	std::vector<Point2<Scalar>> Square(std::size_t count, double size,
+																		 unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<double> dist(0, size);
+		std::vector<Point2<Scalar>> points;
+		for(std::size_t i = 0; i < count; ++i) {
+			points.push_back(Point2<Scalar>(Scalar(dist(gen)), Scalar(dist(gen))));
+		}
+		return points;
+	}
+	
+	/*
+	 * The half-edges pair up consistently, every triangle is counterclockwise,
+	 * the hull edges are those without a twin in hull order and agree with
+	 * the convex hull, Euler's formula holds over the distinct points and,
+	 * when empty is set, no point lies inside the circumcircle of a triangle.
+	 */
+	template <typename Scalar>
+	void ExpectDelaunay(const std::vector<Point2<Scalar>> &points,
+											bool empty = true)
+	{
+		Triangulation2 t;
+		ASSERT_TRUE(delaunay(points.data(), points.size(), t));
+		const std::size_t n = t.triangles.size();
+		ASSERT_EQ(n % 3, 0u);
+		ASSERT_EQ(t.halfedges.size(), n);
+		std::size_t open = 0;
+		for(std::size_t e = 0; e < n; ++e) {
+			const std::size_t next = e % 3 == 2 ? e - 2 : e + 1;
+			const std::uint32_t o = t.halfedges[e];
+			if(o == Triangulation2::None) {
+				++open;
+				continue;
+			}
+			ASSERT_LT(o, n);
+			EXPECT_EQ(t.halfedges[o], e);
+			EXPECT_EQ(t.triangles[o], t.triangles[next]);
+		}
+		for(std::size_t e = 0; e < n; e += 3) {
+			EXPECT_GT(orient2d(points[t.triangles[e]], points[t.triangles[e + 1]],
+												 points[t.triangles[e + 2]]), 0);
+		}
+		
+		/* Hull edges are the open ones, and the vertices of the hull */
+		EXPECT_EQ(open, t.hull.size());
+		std::set<std::pair<std::uint32_t, std::uint32_t>> edges;
+		for(std::size_t e = 0; e < n; ++e) {
+			if(t.halfedges[e] == Triangulation2::None) {
+				edges.insert(std::make_pair(t.triangles[e], t.triangles[
+					e % 3 == 2 ? e - 2 : e + 1]));
+			}
+		}
+		for(std::size_t i = 0; i < t.hull.size(); ++i) {
+			EXPECT_EQ(edges.count(std::make_pair(
+				t.hull[i], t.hull[(i + 1) % t.hull.size()])), 1u);
+		}
+		std::vector<Point2<Scalar>> hull;
+		convexHull(points.data(), points.size(), hull);
+		std::size_t corners = 0;
+		for(std::size_t i = 0; i < t.hull.size(); ++i) {
+			const std::size_t m = t.hull.size();
+			corners += orient2d(points[t.hull[(i + m - 1) % m]], points[t.hull[i]],
+													points[t.hull[(i + 1) % m]]) != 0;
+		}
+		EXPECT_EQ(corners, hull.size());
+		
+		/* Euler: every distinct point is a vertex, T = 2V - H - 2 */
+		std::set<std::pair<Scalar, Scalar>> distinct;
+		for(std::size_t i = 0; i < points.size(); ++i) {
+			distinct.insert(std::make_pair(points[i].x, points[i].y));
+		}
+		std::set<std::uint32_t> vertices(t.triangles.begin(), t.triangles.end());
+		EXPECT_EQ(vertices.size(), distinct.size());
+		EXPECT_EQ(n / 3, 2 * distinct.size() - t.hull.size() - 2);
+		
+		if(empty) {
+			for(std::size_t e = 0; e < n; e += 3) {
+				const Point2<Scalar> &a = points[t.triangles[e]];
+				const Point2<Scalar> &b = points[t.triangles[e + 1]];
+				const Point2<Scalar> &c = points[t.triangles[e + 2]];
+				for(std::size_t i = 0; i < points.size(); ++i) {
+					ASSERT_LE(incircle(a, b, c, points[i]), 0);
+				}
+			}
+		}
+	}
+}
+
+TEST(Delaunay, Small) {
+	/* A square with its center gives four triangles around the center */
+	std::vector<Point2d> points;
+	points.push_back(Point2d(0, 0));
+	points.push_back(Point2d(2, 0));
+	points.push_back(Point2d(2, 2));
+	points.push_back(Point2d(0, 2));
+	points.push_back(Point2d(1, 1));
+	Triangulation2 t;
+	ASSERT_TRUE(delaunay(points.data(), points.size(), t));
+	EXPECT_EQ(t.triangles.size(), 12u);
+	EXPECT_EQ(std::count(t.triangles.begin(), t.triangles.end(), 4u), 4);
+	ASSERT_EQ(t.hull.size(), 4u);
+	const std::size_t first =
+		std::find(t.hull.begin(), t.hull.end(), 0u) - t.hull.begin();
+	for(std::size_t i = 0; i < 4; ++i) {
+		EXPECT_EQ(t.hull[(first + i) % 4], i);
+	}
+	ExpectDelaunay(points);
+	
+	/* A single triangle, given clockwise */
+	points.resize(3);
+	std::swap(points[1], points[2]);
+	ASSERT_TRUE(delaunay(points.data(), points.size(), t));
+	ASSERT_EQ(t.triangles.size(), 3u);
+	EXPECT_EQ(t.halfedges[0], Triangulation2::None);
+	EXPECT_GT(orient2d(points[t.triangles[0]], points[t.triangles[1]],
+										 points[t.triangles[2]]), 0);
+}
+
+TEST(Delaunay, Degenerate) {
+	Triangulation2 t;
+	std::vector<Point2f> points;
+	EXPECT_FALSE(delaunay(points.data(), 0, t));
+	EXPECT_TRUE(t.triangles.empty());
+	
+	/* Repeated and collinear points have no triangles */
+	points.assign(50, Point2f(1, 2));
+	EXPECT_FALSE(delaunay(points.data(), points.size(), t));
+	for(int i = 0; i < 50; ++i) {
+		points[i] = Point2f(float(i % 7), float(3 * (i % 7)));
+	}
+	EXPECT_FALSE(delaunay(points.data(), points.size(), t));
+	
+	/* One point off the line fans to every point on it */
+	points.push_back(Point2f(-1, 5));
+	ExpectDelaunay(points);
+	ASSERT_TRUE(delaunay(points.data(), points.size(), t));
+	EXPECT_EQ(t.triangles.size(), 18u);
+	EXPECT_EQ(t.hull.size(), 8u);
+	
+	/* Duplicates of random points */
+	std::vector<Point2d> twice = Square<double>(500, 1, 1);
+	twice.insert(twice.end(), twice.begin(), twice.end());
+	ExpectDelaunay(twice);
+}
+
+TEST(Delaunay, Cocircular) {
+	/* A grid, where every cell is cocircular, in integer coordinates */
+	std::vector<Point2i> grid;
+	for(int x = 0; x < 30; ++x) {
+		for(int y = 0; y < 30; ++y) {
+			grid.push_back(Point2i(x * 1000, y * 1000));
+		}
+	}
+	ExpectDelaunay(grid);
+	
+	/* Points on a circle and its center, and a circle of floats */
+	std::vector<Point2d> circle;
+	for(int i = 0; i < 8; ++i) {
+		const double c[8][2] = {
+			{ 5, 0 }, { 4, 3 }, { 3, 4 }, { 0, 5 }, { -3, 4 }, { -4, -3 },
+			{ 0, -5 }, { 3, -4 }
+		};
+		circle.push_back(Point2d(c[i][0], c[i][1]));
+	}
+	ExpectDelaunay(circle);
+	circle.push_back(Point2d(0, 0));
+	ExpectDelaunay(circle);
+	std::vector<Point2f> ring;
+	for(int i = 0; i < 300; ++i) {
+		ring.push_back(Point2f(std::cos(i * 0.0209f), std::sin(i * 0.0209f)));
+	}
+	ExpectDelaunay(ring);
+}
+
+TEST(Delaunay, Random) {
+	ExpectDelaunay(Square<double>(2000, 1, 2));
+	ExpectDelaunay(Square<float>(2000, 100, 3));
+	ExpectDelaunay(Square<std::int32_t>(2000, 1 << 20, 4));
+	
+	/*
+	 * Points within a few units in the last place of a parabola, nearly
+	 * cocircular in fours, and many points without the brute force check.
+	 */
+	std::mt19937 gen(5);
+	std::uniform_real_distribution<double> dist(0, 1);
+	std::vector<Point2d> parabola;
+	for(int i = 0; i < 500; ++i) {
+		const double x = dist(gen);
+		double y = x * x;
+		for(int k = int(dist(gen) * 4); k > 0; --k) {
+			y = std::nextafter(y, i % 2 ? 0.0 : 2.0);
+		}
+		parabola.push_back(Point2d(x, y));
+	}
+	ExpectDelaunay(parabola);
+	ExpectDelaunay(Square<double>(100000, 1, 6), false);
+}
+
+TEST(Delaunay, Order) {
+	/* Every point is in the order once, and the Hilbert curve is a bijection */
+	const std::vector<Point2d> points = Square<double>(10000, 1, 7);
+	std::vector<std::uint32_t> order;
+	detail::insertionOrder(points.data(), points.size(), order);
+	ASSERT_EQ(order.size(), points.size());
+	std::vector<std::uint32_t> sorted(order);
+	std::sort(sorted.begin(), sorted.end());
+	for(std::size_t i = 0; i < sorted.size(); ++i) {
+		EXPECT_EQ(sorted[i], i);
+	}
+	std::vector<std::uint32_t> cells;
+	for(std::uint32_t x = 0; x < 16; ++x) {
+		for(std::uint32_t y = 0; y < 16; ++y) {
+			cells.push_back(detail::hilbertIndex(x, y, 4));
+		}
+	}
+	std::sort(cells.begin(), cells.end());
+	for(std::size_t i = 0; i < cells.size(); ++i) {
+		EXPECT_EQ(cells[i], i);
+	}
+	EXPECT_EQ(detail::hilbertIndex(0, 0, 4), 0u);
+	EXPECT_EQ(detail::hilbertIndex(15, 0, 4), 255u);
+}
@@ -0,0 +1,203 @@
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "geom/DualQuaternion.hpp"
+
+using namespace geom;
+
+namespace {
+	template <typename Scalar>
+	std::vector<DualQuaternion<Scalar> > RandomPalette(std::size_t count,
+																										 unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(-1, 1);
+		std::vector<DualQuaternion<Scalar> > palette;
+		for(std::size_t i = 0; i < count; ++i) {
+			const Quaternion<Scalar> r(normalize(Quaternion<Scalar>(
+				dist(gen), dist(gen), dist(gen), dist(gen))));
+			const Vector3<Scalar> t(dist(gen) * 5, dist(gen) * 5, dist(gen) * 5);
+			palette.push_back(DualQuaternion<Scalar>(r, t));
+		}
+		return palette;
+	}
+	
+	/* Up to 4 influences per vertex, some with unused zero weights */
+	template <typename Scalar>
+	void RandomInfluences(std::size_t count, std::uint32_t joints,
+												unsigned seed, std::vector<Vec4u> &indices,
+												std::vector<Vector4<Scalar> > &weights)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(0, 1);
+		for(std::size_t i = 0; i < count; ++i) {
+			indices.push_back(Vec4u(gen() % joints, gen() % joints, gen() % joints,
+															gen() % joints));
+			Vector4<Scalar> w(dist(gen), dist(gen), i % 2 ? dist(gen) : 0,
+												i % 3 ? dist(gen) : 0);
+			const Scalar sum = w.x + w.y + w.z + w.w;
+			weights.push_back(Vector4<Scalar>(w.x / sum, w.y / sum, w.z / sum,
+																				w.w / sum));
+		}
+	}
+	
+	template <typename Scalar>
+	Point3SoA<Scalar> RandomPoints(std::size_t count, unsigned seed) {
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(-10, 10);
+		Point3SoA<Scalar> p;
+		for(std::size_t i = 0; i < count; ++i) {
+			p.push_back(Point3<Scalar>(dist(gen), dist(gen), dist(gen)));
+		}
+		return p;
+	}
+	
+	void ExpectNear(const Matrix4d &a, const Matrix4d &b, double tol) {
+		for(int i = 0; i < 16; ++i) {
+			EXPECT_NEAR(a.values[i], b.values[i], tol);
+		}
+	}
+	
+	void ExpectNear(const Point3d &a, const Point3d &b, double tol) {
+		EXPECT_NEAR(a.x, b.x, tol);
+		EXPECT_NEAR(a.y, b.y, tol);
+		EXPECT_NEAR(a.z, b.z, tol);
+	}
+}
+
+TEST(DualQuaternion, Construction) {
+	DualQuaterniond zero;
+	EXPECT_EQ(zero.real, Quaterniond(0,0,0,0));
+	EXPECT_EQ(zero.dual, Quaterniond(0,0,0,0));
+	EXPECT_EQ(DualQuaterniond::identity().real, Quaterniond::identity());
+	EXPECT_EQ(sizeof(DualQuaternionf), 8 * sizeof(float));
+	
+	const Quaterniond r = Quaterniond::rotate(0.7, Vec3d(1,2,-1));
+	const DualQuaterniond q(r, Vec3d(3,-4,5));
+	EXPECT_EQ(q.rotation(), r);
+	const Vec3d t = q.translation();
+	EXPECT_NEAR(t.x, 3, 1e-14);
+	EXPECT_NEAR(t.y, -4, 1e-14);
+	EXPECT_NEAR(t.z, 5, 1e-14);
+	ExpectNear(q.toMatrix4(), Matrix4d::translate(Vec3d(3,-4,5)) *
+						 Matrix4d::rotate(0.7, Vec3d(1,2,-1)), 1e-14);
+	
+	/* Round trips through the matrix types */
+	const DualQuaterniond m(q.toMatrix4());
+	ExpectNear(m.toMatrix4(), q.toMatrix4(), 1e-14);
+	const DualQuaterniond a(q.toAffine3());
+	ExpectNear(a.toMatrix4(), q.toMatrix4(), 1e-14);
+	
+	EXPECT_EQ(DualQuaterniond(DualQuaternionf(q)), DualQuaterniond(
+		DualQuaternionf(q).real, DualQuaternionf(q).dual));
+	EXPECT_NE(q, DualQuaterniond::identity());
+}
+
+TEST(DualQuaternion, Transform) {
+	const std::vector<DualQuaterniond> palette = RandomPalette<double>(8, 1);
+	const Point3d p(1,-2,3);
+	const Vec3d v(-3,1,2);
+	for(std::size_t i = 0; i < palette.size(); ++i) {
+		const Matrix4d m = palette[i].toMatrix4();
+		ExpectNear(palette[i] * p, m * p, 1e-13);
+		const Vec3d r = palette[i] * v;
+		const Vec3d e = palette[i].real * v;
+		EXPECT_NEAR(r.x, e.x, 1e-14);
+		EXPECT_NEAR(r.y, e.y, 1e-14);
+		EXPECT_NEAR(r.z, e.z, 1e-14);
+		
+		/* Products compose like matrices and the conjugate inverts */
+		const DualQuaterniond q = palette[i] * palette[(i + 1) % 8];
+		ExpectNear(q.toMatrix4(), m * palette[(i + 1) % 8].toMatrix4(), 1e-13);
+		ExpectNear(conjugate(palette[i]) * (palette[i] * p), p, 1e-13);
+	}
+	
+	const DualQuaterniond q(Quaterniond(0,0,0,2), Quaterniond(2,0,0,0));
+	EXPECT_EQ(normalize(q),
+						DualQuaterniond(Quaterniond(0,0,0,1), Quaterniond(1,0,0,0)));
+}
+
+TEST(DualQuaternion, Blend) {
+	const std::vector<DualQuaterniond> palette = RandomPalette<double>(4, 2);
+	
+	/* A single influence reproduces its palette entry */
+	const DualQuaterniond one = blend(palette.data(), Vec4u(2,0,0,0),
+																		Vec4d(1,0,0,0));
+	ExpectNear(one.toMatrix4(), palette[2].toMatrix4(), 1e-14);
+	
+	/* Blending follows the shortest path, so q and -q blend to q */
+	std::vector<DualQuaterniond> flipped(palette);
+	flipped[1] = DualQuaterniond(-palette[0].real, -palette[0].dual);
+	flipped[2] = palette[0];
+	const DualQuaterniond same = blend(flipped.data(), Vec4u(2,1,2,1),
+																		 Vec4d(.25,.25,.25,.25));
+	ExpectNear(same.toMatrix4(), palette[0].toMatrix4(), 1e-14);
+	
+	/* Blending rotations about one axis interpolates the angle */
+	std::vector<DualQuaterniond> rotations;
+	rotations.push_back(DualQuaterniond(Quaterniond::rotate(0.2, Vec3d(0,0,1)),
+																			Vec3d(0,0,0)));
+	rotations.push_back(DualQuaterniond(Quaterniond::rotate(1.0, Vec3d(0,0,1)),
+																			Vec3d(0,0,0)));
+	const DualQuaterniond half = blend(rotations.data(), Vec4u(0,1,0,0),
+																		 Vec4d(.5,.5,0,0));
+	ExpectNear(half.toMatrix4(), Matrix4d::rotate(0.6, Vec3d(0,0,1)), 1e-14);
+}
+
+TEST(DualQuaternion, Skin) {
+	const std::size_t count = 37;
+	const std::vector<DualQuaternionf> palette = RandomPalette<float>(16, 3);
+	std::vector<Vec4u> joints;
+	std::vector<Vec4f> weights;
+	RandomInfluences<float>(count, 16, 4, joints, weights);
+	const Point3SoAf positions = RandomPoints<float>(count, 5);
+	Vec3SoAf normals(count);
+	for(std::size_t i = 0; i < count; ++i) {
+		normals.set(i, normalize(Vec3f(positions.x[i], positions.y[i], 1)));
+	}
+	
+	Point3SoAf out(count);
+	Vec3SoAf outNormals(count);
+	skin(palette.data(), joints.data(), weights.data(), positions.span(),
+			 normals.span(), out.span(), outNormals.span());
+	for(std::size_t i = 0; i < count; ++i) {
+		const DualQuaternionf q = blend(palette.data(), joints[i], weights[i]);
+		const Point3f p = q * Point3f(positions.x[i], positions.y[i],
+																	positions.z[i]);
+		EXPECT_EQ(out.x[i], p.x);
+		EXPECT_EQ(out.y[i], p.y);
+		EXPECT_EQ(out.z[i], p.z);
+		EXPECT_EQ(outNormals[i], q * normals[i]);
+	}
+	
+	/* Positions only, and in parallel */
+	Point3SoAf only(count);
+	skin(palette.data(), joints.data(), weights.data(), positions.span(),
+			 only.span(), Parallel(4, 0));
+	for(std::size_t i = 0; i < count; ++i) {
+		EXPECT_EQ(only.x[i], out.x[i]);
+		EXPECT_EQ(only.y[i], out.y[i]);
+		EXPECT_EQ(only.z[i], out.z[i]);
+	}
+	
+	const std::vector<DualQuaterniond> dpalette = RandomPalette<double>(16, 6);
+	std::vector<Vec4d> dweights;
+	joints.clear();
+	RandomInfluences<double>(count, 16, 7, joints, dweights);
+	const Point3SoAd dpositions = RandomPoints<double>(count, 8);
+	Point3SoAd dout(count);
+	skin(dpalette.data(), joints.data(), dweights.data(), dpositions.span(),
+			 dout.span());
+	for(std::size_t i = 0; i < count; ++i) {
+		const DualQuaterniond q = blend(dpalette.data(), joints[i], dweights[i]);
+		const Point3d p = q * Point3d(dpositions.x[i], dpositions.y[i],
+																	dpositions.z[i]);
+		EXPECT_EQ(dout.x[i], p.x);
+		EXPECT_EQ(dout.y[i], p.y);
+		EXPECT_EQ(dout.z[i], p.z);
+	}
+}
@@ -0,0 +1,179 @@
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "geom/Frustum.hpp"
+
+using namespace geom;
+
+namespace {
+	/* An OpenGL perspective projection, as glFrustum */
+	template <typename Scalar>
+	Matrix4<Scalar> Perspective(Scalar l, Scalar r, Scalar b, Scalar t,
+															Scalar n, Scalar f)
+	{
+		return Matrix4<Scalar>(2 * n / (r - l), 0, (r + l) / (r - l), 0,
+													 0, 2 * n / (t - b), (t + b) / (t - b), 0,
+													 0, 0, -(f + n) / (f - n), -2 * f * n / (f - n),
+													 0, 0, -1, 0);
+	}
+	
+	/* A camera at (0, 0, 5) looking down -z with a 90 degree field of view */
+	template <typename Scalar>
+	Frustum<Scalar> Camera() {
+		return Frustum<Scalar>(Perspective<Scalar>(-1, 1, -1, 1, 1, 100) *
+													 Matrix4<Scalar>::translate(Vector3<Scalar>(0, 0, -5)));
+	}
+	
+	bool Bit(const std::vector<std::uint32_t> &mask, std::size_t i) {
+		return (mask[i / 32] >> (i % 32)) & 1;
+	}
+	
+	/* Random volumes around the frustum, many of them partly inside */
+	template <typename Scalar>
+	void ExpectBatch(std::size_t count, const Parallel &parallel) {
+		std::mt19937 gen(static_cast<unsigned>(count));
+		std::uniform_real_distribution<Scalar> position(-120, 20);
+		std::uniform_real_distribution<Scalar> size(0, 10);
+		const Frustum<Scalar> f = Camera<Scalar>();
+		Point3SoA<Scalar> centers;
+		Vector3SoA<Scalar> extents;
+		std::vector<Point3<Scalar>> origins(count);
+		std::vector<Dimensions3<Scalar>> dims(count);
+		std::vector<Scalar> radii(count);
+		for(std::size_t i = 0; i < count; ++i) {
+			const Point3<Scalar> c(position(gen) / 2 + 50, position(gen) / 2 + 50,
+														 position(gen));
+			const Dimensions3<Scalar> d(size(gen), size(gen), size(gen));
+			origins[i] = Point3<Scalar>(c.x - d.width / 2, c.y - d.height / 2,
+																	c.z - d.depth / 2);
+			dims[i] = d;
+			/* Half extents computed as by the kernels so that both agree */
+			const Vector3<Scalar> e(d.width * Scalar(0.5), d.height * Scalar(0.5),
+															d.depth * Scalar(0.5));
+			centers.push_back(Point3<Scalar>(origins[i].x + e.x, origins[i].y + e.y,
+																			 origins[i].z + e.z));
+			extents.push_back(e);
+			radii[i] = d.width;
+		}
+		
+		const std::size_t words = (count + 31) / 32;
+		std::vector<std::uint32_t> boxes(words, ~0u), boxSpans(words, ~0u);
+		std::vector<std::uint32_t> spheres(words, ~0u), sphereSpans(words, ~0u);
+		cullBoxes(f, origins.data(), dims.data(), count, boxes.data(), parallel);
+		cullBoxes(f, centers.span(), extents.span(), boxSpans.data(), parallel);
+		cullSpheres(f, origins.data(), radii.data(), count, spheres.data(),
+								parallel);
+		cullSpheres(f, Point3Span<const Scalar>(centers.span()).subspan(0, count),
+								radii.data(), sphereSpans.data(), parallel);
+		std::size_t seen = 0;
+		for(std::size_t i = 0; i < count; ++i) {
+			EXPECT_EQ(Bit(boxes, i), visible(f, origins[i], dims[i]));
+			EXPECT_EQ(Bit(boxSpans, i), Bit(boxes, i));
+			EXPECT_EQ(Bit(spheres, i), visible(f, origins[i], radii[i]));
+			seen += Bit(boxes, i);
+		}
+		for(std::size_t i = 0; i < count; ++i) {
+			EXPECT_EQ(Bit(sphereSpans, i), visible(f, centers[i], radii[i]));
+		}
+		if(count % 32) {
+			EXPECT_EQ(boxes.back() >> (count % 32), 0u);
+			EXPECT_EQ(spheres.back() >> (count % 32), 0u);
+		}
+		/* The volumes are neither all visible nor all culled */
+		EXPECT_GT(seen, 0u);
+		EXPECT_LT(seen, count);
+	}
+}
+
+TEST(Frustum, Planes) {
+	const Frustumd f = Camera<double>();
+	/* The near plane faces -z at z = 4, the far one +z at z = -95 */
+	EXPECT_NEAR(f.z[Frustumd::Near], -1, 1e-12);
+	EXPECT_NEAR(f.w[Frustumd::Near], 4, 1e-12);
+	EXPECT_NEAR(f.z[Frustumd::Far], 1, 1e-12);
+	EXPECT_NEAR(f.w[Frustumd::Far], 95, 1e-12);
+	/* The side planes are at 45 degrees through the camera */
+	const Vec4d left = f.plane(Frustumd::Left);
+	EXPECT_NEAR(left.x, std::sqrt(0.5), 1e-12);
+	EXPECT_NEAR(left.z, -std::sqrt(0.5), 1e-12);
+	EXPECT_NEAR(left.x * 0 + left.z * 5 + left.w, 0, 1e-12);
+	
+	/* The same projection to a depth of [0, 1], in view space */
+	Matrix4d zeroToOne = Perspective<double>(-1, 1, -1, 1, 1, 100);
+	for(int k = 0; k < 4; ++k) {
+		zeroToOne(2, k) = (zeroToOne(2, k) + zeroToOne(3, k)) / 2;
+	}
+	const Frustumd g(zeroToOne, ClipDepth::ZeroToOne);
+	EXPECT_NEAR(g.z[Frustumd::Near], -1, 1e-12);
+	EXPECT_NEAR(g.w[Frustumd::Near], -1, 1e-12);
+	EXPECT_NEAR(g.z[Frustumd::Far], 1, 1e-12);
+	EXPECT_NEAR(g.w[Frustumd::Far], 100, 1e-9);
+}
+
+TEST(Frustum, Visible) {
+	const Frustumf f = Camera<float>();
+	EXPECT_TRUE(visible(f, Point3f(-1, -1, -20), Dimensions3f(2, 2, 2)));
+	EXPECT_TRUE(visible(f, Point3f(0, 0, 0), 1.0f));
+	/* Behind the camera, beyond the far plane and to either side */
+	EXPECT_FALSE(visible(f, Point3f(-1, -1, 6), Dimensions3f(2, 2, 2)));
+	EXPECT_FALSE(visible(f, Point3f(0, 0, -200), 50.0f));
+	EXPECT_FALSE(visible(f, Point3f(30, 0, -20), Dimensions3f(1, 1, 1)));
+	EXPECT_FALSE(visible(f, Point3f(-30, 0, -20), 3.0f));
+	/* Straddling a plane */
+	EXPECT_TRUE(visible(f, Point3f(20, 0, -20), Dimensions3f(10, 1, 1)));
+	EXPECT_TRUE(visible(f, Point3f(0, 0, 5), 1.5f));
+}
+
+TEST(Frustum, Infinite) {
+	/* The limit of Perspective as f goes to infinity */
+	const Matrix4d infinite(1, 0, 0, 0,
+													0, 1, 0, 0,
+													0, 0, -1, -2,
+													0, 0, -1, 0);
+	/* Reversed z to a depth of [0, 1], mapping the near plane to 1 */
+	const Matrix4d reversed(1, 0, 0, 0,
+													0, 1, 0, 0,
+													0, 0, 0, 1,
+													0, 0, -1, 0);
+	const Frustumd frusta[] = {
+		Frustumd(infinite), Frustumd(reversed, ClipDepth::ZeroToOne)
+	};
+	for(int i = 0; i < 2; ++i) {
+		const Frustumd &f = frusta[i];
+		const Vec4d plane = f.plane(i == 0 ? Frustumd::Far : Frustumd::Near);
+		EXPECT_EQ(plane.x, 0);
+		EXPECT_EQ(plane.y, 0);
+		EXPECT_EQ(plane.z, 0);
+		EXPECT_EQ(plane.w, 1);
+		
+		const Point3d centers[] = {
+			Point3d(0, 0, -5), Point3d(0, 0, -1e6), Point3d(0, 0, 5)
+		};
+		const double radii[] = { 1, 1, 1 };
+		EXPECT_TRUE(visible(f, centers[0], 1.0));
+		EXPECT_TRUE(visible(f, centers[1], 1.0));
+		EXPECT_FALSE(visible(f, centers[2], 1.0));
+		EXPECT_TRUE(visible(f, Point3d(-1, -1, -6), Dimensions3d(2, 2, 2)));
+		std::uint32_t mask = ~0u;
+		cullSpheres(f, centers, radii, 3, &mask);
+		EXPECT_EQ(mask, 3u);
+		const Dimensions3d dims[] = {
+			Dimensions3d(2, 2, 2), Dimensions3d(2, 2, 2), Dimensions3d(2, 2, 2)
+		};
+		cullBoxes(f, centers, dims, 3, &mask);
+		EXPECT_EQ(mask, 3u);
+	}
+}
+
+TEST(Frustum, Cull) {
+	ExpectBatch<float>(1000, Parallel::serial());
+	ExpectBatch<double>(1000, Parallel::serial());
+	ExpectBatch<float>(13, Parallel::serial());
+	ExpectBatch<float>(1 << 12, Parallel(4, 0));
+	ExpectBatch<double>(1 << 12, Parallel(3, 0));
+}
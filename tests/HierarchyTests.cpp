@@ -0,0 +1,117 @@
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "geom/Hierarchy.hpp"
+
+using namespace geom;
+
+namespace {
+	/* A random forest sorted parents first, with a root every 97 nodes */
+	std::vector<std::int32_t> RandomParents(std::size_t count, unsigned seed) {
+		std::mt19937 gen(seed);
+		std::vector<std::int32_t> parents(count);
+		for(std::size_t i = 0; i < count; ++i) {
+			if(i % 97 == 0) {
+				parents[i] = -1;
+			} else {
+				std::uniform_int_distribution<std::size_t> dist(i < 8 ? 0 : i - 8,
+																												i - 1);
+				parents[i] = static_cast<std::int32_t>(dist(gen));
+			}
+		}
+		return parents;
+	}
+	
+	template <typename Scalar>
+	std::vector<Matrix4<Scalar>> RandomTransforms(std::size_t count,
+																								unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(-1, 1);
+		std::vector<Matrix4<Scalar>> m(count);
+		for(std::size_t i = 0; i < count; ++i) {
+			const Vector3<Scalar> axis(dist(gen), dist(gen), dist(gen) + 2);
+			m[i] = Matrix4<Scalar>::translate(Vector3<Scalar>(dist(gen), dist(gen),
+																												dist(gen))) *
+				Matrix4<Scalar>::rotate(dist(gen), axis);
+		}
+		return m;
+	}
+	
+	template <typename Scalar>
+	void ExpectFlattened(std::size_t count, unsigned seed) {
+		const std::vector<std::int32_t> parents = RandomParents(count, seed);
+		const std::vector<Matrix4<Scalar>> local =
+			RandomTransforms<Scalar>(count, seed);
+		std::vector<Matrix4<Scalar>> world(count);
+		flattenHierarchy(parents.data(), local.data(), count, world.data());
+		for(std::size_t i = 0; i < count; ++i) {
+			if(parents[i] < 0) {
+				EXPECT_EQ(world[i], local[i]);
+			} else {
+				EXPECT_EQ(world[i], world[parents[i]] * local[i]);
+			}
+		}
+		
+		/* Flattening by level gives identical results on any thread count */
+		const HierarchyLevels levels(parents.data(), count);
+		for(unsigned threads = 1; threads <= 4; threads += 3) {
+			std::vector<Matrix4<Scalar>> byLevel(count);
+			flattenHierarchy(levels, local.data(), byLevel.data(),
+											 Parallel(threads, 0));
+			EXPECT_TRUE(byLevel == world);
+		}
+	}
+}
+
+TEST(Hierarchy, Flatten) {
+	/* A chain and a sibling under one root, and a second root */
+	const std::int32_t parents[] = { -1, 0, 1, 0, -1 };
+	const Matrix4d local[] = {
+		Matrix4d::translate(Vec3d(1, 0, 0)),
+		Matrix4d::scale(2),
+		Matrix4d::translate(Vec3d(0, 1, 0)),
+		Matrix4d::rotate(1, Vec3d(0, 0, 1)),
+		Matrix4d::translate(Vec3d(0, 0, 1))
+	};
+	Matrix4d world[5];
+	flattenHierarchy(parents, local, 5, world);
+	EXPECT_EQ(world[0], local[0]);
+	EXPECT_EQ(world[1], local[0] * local[1]);
+	EXPECT_EQ(world[2], local[0] * local[1] * local[2]);
+	EXPECT_EQ(world[3], local[0] * local[3]);
+	EXPECT_EQ(world[4], local[4]);
+	
+	const Point3d p = world[2] * Point3d(0, 0, 0);
+	EXPECT_EQ(p.x, 1.0);
+	EXPECT_EQ(p.y, 2.0);
+	EXPECT_EQ(p.z, 0.0);
+}
+
+TEST(Hierarchy, Levels) {
+	const std::int32_t parents[] = { -1, 0, 1, 0, -1, 4, 2 };
+	const HierarchyLevels levels(parents, 7);
+	EXPECT_EQ(levels.levels(), 4u);
+	const std::size_t offsets[] = { 0, 2, 5, 6, 7 };
+	const std::uint32_t nodes[] = { 0, 4, 1, 3, 5, 2, 6 };
+	EXPECT_EQ(levels.offsets, std::vector<std::size_t>(offsets, offsets + 5));
+	EXPECT_EQ(levels.nodes, std::vector<std::uint32_t>(nodes, nodes + 7));
+	EXPECT_EQ(levels.parents[3], 0);
+	EXPECT_EQ(levels.parents[6], 2);
+	
+	EXPECT_EQ(HierarchyLevels().levels(), 0u);
+	EXPECT_EQ(HierarchyLevels(parents, 0).levels(), 0u);
+	const Matrix4f local;
+	Matrix4f world = Matrix4f::identity();
+	flattenHierarchy(HierarchyLevels(), &local, &world);
+	EXPECT_EQ(world, Matrix4f::identity());
+}
+
+TEST(Hierarchy, Random) {
+	ExpectFlattened<float>(1000, 1);
+	ExpectFlattened<double>(1000, 2);
+}
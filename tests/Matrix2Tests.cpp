@@ -0,0 +1,30 @@
+
+#include <gtest/gtest.h>
+
+#include "geom/Matrix2.hpp"
+
+TEST(Matrix2, Construction) {
+	geom::Matrix2i m(1,2,3,4);
+	EXPECT_EQ(m.values[0], 1);
+	EXPECT_EQ(m.values[1], 3);
+	EXPECT_EQ(m.values[2], 2);
+	EXPECT_EQ(m.values[3], 4);
+	EXPECT_EQ(m(0,1), 2);
+	EXPECT_EQ(m(1,0), 3);
+	m(1,1) = 5;
+	EXPECT_EQ(m.values[3], 5);
+	EXPECT_EQ(geom::Matrix2d(m), m);
+	EXPECT_NE(m, geom::Matrix2i::identity());
+}
+TEST(Matrix2, Product) {
+	geom::Matrix2i a(1,2,3,4);
+	geom::Matrix2i b(0,1,-1,2);
+	EXPECT_EQ(a * b, geom::Matrix2i(-2,5,-4,11));
+	EXPECT_EQ(a * geom::Matrix2i::identity(), a);
+}
+TEST(Matrix2, Inverse) {
+	geom::Matrix2d a(1,2,3,4);
+	EXPECT_EQ(determinant(a), -2.0);
+	EXPECT_EQ(inverse(a), geom::Matrix2d(-2,1,1.5,-0.5));
+	EXPECT_EQ(a * inverse(a), geom::Matrix2d::identity());
+}
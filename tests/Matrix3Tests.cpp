@@ -108,3 +108,35 @@ TEST(Matrix3, ConvertAssignment2) {
   EXPECT_EQ(mat2.values[7], static_cast<int>(mat1.values[7]));
   EXPECT_EQ(mat2.values[8], static_cast<int>(mat1.values[8])); 
 }
+TEST(Matrix3, Access) {
+	geom::Matrix3i m(1,2,3,4,5,6,7,8,9);
+	EXPECT_EQ(m(0,0), 1);
+	EXPECT_EQ(m(0,2), 3);
+	EXPECT_EQ(m(2,1), 8);
+	m(1,2) = 10;
+	EXPECT_EQ(m.values[7], 10);
+	EXPECT_EQ(geom::Matrix3i::identity(), geom::Matrix3i(1,0,0,0,1,0,0,0,1));
+}
+TEST(Matrix3, Products) {
+	geom::Matrix3i a(1,2,3,4,5,6,7,8,9);
+	geom::Matrix3i b(2,0,1,1,3,0,0,1,4);
+	EXPECT_EQ(a * b, geom::Matrix3i(4,9,13,13,21,28,22,33,43));
+	EXPECT_EQ(a * geom::Matrix3i::identity(), a);
+	EXPECT_EQ(a * geom::Vec3i(1,2,3), geom::Vec3i(14,32,50));
+	EXPECT_EQ(geom::Matrix3d(a) * geom::Vec3f(1,2,3), geom::Vec3d(14,32,50));
+	EXPECT_EQ(transpose(a), geom::Matrix3i(1,4,7,2,5,8,3,6,9));
+	EXPECT_NE(a, b);
+}
+TEST(Matrix3, Inverse) {
+	geom::Matrix3d a(2,0,1, 1,3,0, 0,1,4);
+	EXPECT_EQ(determinant(a), 25.0);
+	EXPECT_EQ(determinant(geom::Matrix3i(1,2,3,4,5,6,7,8,9)), 0);
+	const geom::Matrix3d inv = inverse(a);
+	const geom::Matrix3d id = a * inv;
+	for(int i = 0; i < 9; ++i) {
+		EXPECT_NEAR(id.values[i], geom::Matrix3d::identity().values[i], 1e-15);
+	}
+	EXPECT_NEAR(inv(0,0), 12.0 / 25, 1e-15);
+	EXPECT_NEAR(inv(0,2), -3.0 / 25, 1e-15);
+	EXPECT_NEAR(inv(2,0), 1.0 / 25, 1e-15);
+}
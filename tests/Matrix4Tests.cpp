@@ -0,0 +1,232 @@
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "geom/Matrix4.hpp"
+
+namespace {
+	/* Integer valued matrices make every product exact in any type */
+	const geom::Matrix4i A(1, 2, 3, 4,
+												 5, 6, 7, 8,
+												 9, 10, 11, 12,
+												 13, 14, 15, 16);
+	const geom::Matrix4i B(-2, 1, 0, 3,
+												 4, -1, 2, 0,
+												 1, 5, -3, 2,
+												 0, 2, 1, -1);
+}
+
+TEST(Matrix4, DefaultConstructor) {
+	geom::Matrix4i mat;
+	for(int i = 0; i < 16; ++i) {
+		EXPECT_EQ(mat.values[i], 0);
+	}
+}
+TEST(Matrix4, ScalarConstructor) {
+	geom::Matrix4i mat(1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16);
+	const int columnMajor[] = { 1,5,9,13, 2,6,10,14, 3,7,11,15, 4,8,12,16 };
+	for(int i = 0; i < 16; ++i) {
+		EXPECT_EQ(mat.values[i], columnMajor[i]);
+	}
+	EXPECT_EQ(mat(0,3), 4);
+	EXPECT_EQ(mat(3,0), 13);
+	mat(1,2) = 42;
+	EXPECT_EQ(mat.values[9], 42);
+}
+TEST(Matrix4, CopyConstructor) {
+	geom::Matrix4i mat(A);
+	for(int i = 0; i < 16; ++i) {
+		EXPECT_EQ(mat.values[i], A.values[i]);
+	}
+}
+TEST(Matrix4, ConvertConstructor) {
+	geom::Matrix4d mat1(A);
+	for(int i = 0; i < 16; ++i) {
+		EXPECT_EQ(mat1.values[i], static_cast<double>(A.values[i]));
+	}
+	geom::Matrix4d mat2(1.5,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16.5);
+	geom::Matrix4i mat3(mat2);
+	EXPECT_EQ(mat3.values[0], 1);
+	EXPECT_EQ(mat3.values[15], 16);
+}
+TEST(Matrix4, Assignment) {
+	geom::Matrix4i mat1;
+	mat1 = A;
+	EXPECT_EQ(mat1, A);
+	geom::Matrix4f mat2;
+	mat2 = A;
+	EXPECT_EQ(mat2, A);
+	EXPECT_NE(mat2, B);
+}
+
+TEST(Matrix4, Multiply) {
+	const geom::Matrix4i expected(9, 22, -1, 5,
+																21, 50, -1, 21,
+																33, 78, -1, 37,
+																45, 106, -1, 53);
+	EXPECT_EQ(A * B, expected);
+	EXPECT_EQ(geom::Matrix4f(A) * geom::Matrix4f(B), expected);
+	EXPECT_EQ(geom::Matrix4d(A) * geom::Matrix4d(B), expected);
+	EXPECT_EQ(geom::Matrix4f(B) * geom::Matrix4f(A), B * A);
+	EXPECT_EQ(geom::Matrix4f(A) * geom::Matrix4f::identity(), A);
+	EXPECT_EQ(geom::Matrix4d::identity() * geom::Matrix4d(A), A);
+	
+	::testing::StaticAssertTypeEq<decltype(A * geom::Matrix4f()),
+																geom::Matrix4f>();
+	::testing::StaticAssertTypeEq<decltype(geom::Matrix4f() * geom::Matrix4d()),
+																geom::Matrix4d>();
+	
+	geom::Matrix4f mat(A);
+	mat *= B;
+	EXPECT_EQ(mat, expected);
+}
+
+TEST(Matrix4, Arithmetic) {
+	EXPECT_EQ(A + B, geom::Matrix4i(-1, 3, 3, 7,
+																	9, 5, 9, 8,
+																	10, 15, 8, 14,
+																	13, 16, 16, 15));
+	EXPECT_EQ(A - A, geom::Matrix4i());
+	EXPECT_EQ(A * 2, A + A);
+	EXPECT_EQ(0.5f * geom::Matrix4f(A + A), A);
+}
+
+TEST(Matrix4, TransformVector4) {
+	const geom::Vec4i v(1, -2, 3, 2);
+	const geom::Vec4i expected(14, 30, 46, 62);
+	EXPECT_EQ(A * v, expected);
+	EXPECT_EQ(geom::Matrix4f(A) * geom::Vec4f(v), expected);
+	EXPECT_EQ(geom::Matrix4d(B) * geom::Vec4d(v), B * v);
+	::testing::StaticAssertTypeEq<decltype(A * geom::Vec4f()), geom::Vec4f>();
+}
+
+TEST(Matrix4, TransformPoint3) {
+	const geom::Matrix4f m = geom::Matrix4f::translate(geom::Vec3f(1, 2, 3)) *
+		geom::Matrix4f::scale(2);
+	const geom::Point3f p = m * geom::Point3f(1, 1, 1);
+	EXPECT_EQ(p.x, 3);
+	EXPECT_EQ(p.y, 4);
+	EXPECT_EQ(p.z, 5);
+	
+	/* Vectors are not translated */
+	EXPECT_EQ(m * geom::Vec3f(1, 1, 1), geom::Vec3f(2, 2, 2));
+	
+	/* w = z, so projecting divides by the depth */
+	const geom::Matrix4d perspective(1, 0, 0, 0,
+																	 0, 1, 0, 0,
+																	 0, 0, 1, 0,
+																	 0, 0, 1, 0);
+	const geom::Point3d q = geom::project(perspective, geom::Point3d(2, 4, 4));
+	EXPECT_EQ(q.x, 0.5);
+	EXPECT_EQ(q.y, 1);
+	EXPECT_EQ(q.z, 1);
+}
+
+TEST(Matrix4, Transpose) {
+	const geom::Matrix4i expected(1, 5, 9, 13,
+																2, 6, 10, 14,
+																3, 7, 11, 15,
+																4, 8, 12, 16);
+	EXPECT_EQ(geom::transpose(A), expected);
+	EXPECT_EQ(geom::transpose(geom::Matrix4f(A)), expected);
+	EXPECT_EQ(geom::transpose(geom::Matrix4d(A)), expected);
+	EXPECT_EQ(geom::transpose(geom::transpose(geom::Matrix4d(B))), B);
+}
+
+TEST(Matrix4, Builders) {
+	EXPECT_EQ(geom::Matrix4i::identity(), geom::Matrix4i(1, 0, 0, 0,
+																											 0, 1, 0, 0,
+																											 0, 0, 1, 0,
+																											 0, 0, 0, 1));
+	EXPECT_EQ(geom::Matrix4i::scale(geom::Vec3i(2, 3, 4)) * geom::Vec4i(1,1,1,1),
+						geom::Vec4i(2, 3, 4, 1));
+	
+	/* A quarter turn about z takes x to y */
+	const geom::Matrix4d r = geom::Matrix4d::rotate(M_PI / 2,
+																									geom::Vec3d(0, 0, 2));
+	const geom::Vec3d v = r * geom::Vec3d(1, 0, 0);
+	EXPECT_NEAR(v.x, 0, 1e-15);
+	EXPECT_NEAR(v.y, 1, 1e-15);
+	EXPECT_NEAR(v.z, 0, 1e-15);
+	
+	/* The rotation axis is left in place and the rotation is orthonormal */
+	const geom::Vec3f axis(1, 2, 3);
+	const geom::Matrix4f s = geom::Matrix4f::rotate(0.7f, axis);
+	const geom::Vec3f a = s * axis;
+	EXPECT_NEAR(a.x, 1, 1e-5);
+	EXPECT_NEAR(a.y, 2, 1e-5);
+	EXPECT_NEAR(a.z, 3, 1e-5);
+	const geom::Matrix4f i = s * geom::transpose(s);
+	for(int k = 0; k < 16; ++k) {
+		EXPECT_NEAR(i.values[k], geom::Matrix4f::identity().values[k], 1e-6);
+	}
+}
+namespace {
+	/* A well conditioned matrix with no special structure */
+	const geom::Matrix4d G(4, 1, -2, 3,
+												 0, 5, 1, -1,
+												 2, -1, 6, 0,
+												 1, 2, 0, 3);
+	
+	template <typename Scalar>
+	void ExpectIdentity(const geom::Matrix4<Scalar> &m, Scalar tolerance) {
+		const geom::Matrix4<Scalar> id = geom::Matrix4<Scalar>::identity();
+		for(int i = 0; i < 16; ++i) {
+			EXPECT_NEAR(m.values[i], id.values[i], tolerance);
+		}
+	}
+}
+TEST(Matrix4, Determinant) {
+	EXPECT_EQ(determinant(A), 0);
+	EXPECT_EQ(determinant(geom::Matrix4i::identity()), 1);
+	EXPECT_EQ(determinant(B), -187);
+	EXPECT_DOUBLE_EQ(determinant(G), 385.0);
+	EXPECT_EQ(determinant(geom::Matrix4d::scale(geom::Vec3d(2,3,4))), 24.0);
+}
+TEST(Matrix4, Inverse) {
+	ExpectIdentity(G * inverse(G), 1e-14);
+	ExpectIdentity(inverse(G) * G, 1e-14);
+	
+	/* The SSE float inverse agrees with the double one */
+	const geom::Matrix4f f(G);
+	const geom::Matrix4f fi = inverse(f);
+	const geom::Matrix4d di = inverse(G);
+	for(int i = 0; i < 16; ++i) {
+		EXPECT_NEAR(fi.values[i], di.values[i], 1e-6);
+	}
+	ExpectIdentity(f * fi, 1e-6f);
+	
+	const geom::Matrix4d p(1.5, 0, 0, 0,
+												 0, 2, 0, 0,
+												 0, 0, -1.2, -2.2,
+												 0, 0, -1, 0);
+	ExpectIdentity(p * inverse(p), 1e-15);
+	ExpectIdentity(geom::Matrix4f(p) * inverse(geom::Matrix4f(p)), 1e-6f);
+}
+TEST(Matrix4, InverseAffine) {
+	const geom::Matrix4d m = geom::Matrix4d::translate(geom::Vec3d(1,-2,3)) *
+		geom::Matrix4d::rotate(0.7, geom::Vec3d(1,1,0)) *
+		geom::Matrix4d::scale(geom::Vec3d(2,3,0.5));
+	EXPECT_EQ(classify(m), geom::MatrixKind::Affine);
+	ExpectIdentity(m * inverseAffine(m), 1e-14);
+	ExpectIdentity(m * inverse(m, geom::MatrixKind::Affine), 1e-14);
+	
+	const geom::Matrix4d r = geom::Matrix4d::translate(geom::Vec3d(5,0,-1)) *
+		geom::Matrix4d::rotate(-1.2, geom::Vec3d(0,2,1));
+	EXPECT_EQ(classify(r), geom::MatrixKind::Rigid);
+	ExpectIdentity(r * inverseRigid(r), 1e-14);
+	const geom::Matrix4d ri = inverse(r, classify(r));
+	const geom::Matrix4d gi = inverse(r);
+	for(int i = 0; i < 16; ++i) {
+		EXPECT_NEAR(ri.values[i], gi.values[i], 1e-14);
+	}
+	
+	const geom::Matrix4f rf(r);
+	EXPECT_EQ(classify(rf), geom::MatrixKind::Rigid);
+	ExpectIdentity(rf * inverseRigid(rf), 1e-6f);
+	EXPECT_EQ(classify(G), geom::MatrixKind::General);
+	EXPECT_EQ(classify(geom::Matrix4d::scale(1.01)), geom::MatrixKind::Affine);
+	EXPECT_EQ(classify(geom::Matrix4d::scale(1.01), 0.1),
+						geom::MatrixKind::Rigid);
+}
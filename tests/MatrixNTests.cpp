@@ -0,0 +1,166 @@
+
+#include <gtest/gtest.h>
+
+#include "geom/Matrix4.hpp"
+#include "geom/MatrixN.hpp"
+
+using namespace geom;
+
+namespace {
+	/* Integer valued matrices make every product exact in any type */
+	constexpr Matrix<2, 3, int> A(1, 2, 3,
+																4, 5, 6);
+	constexpr Matrix<3, 4, int> B(1, 0, -1, 2,
+																2, 1, 0, -3,
+																0, 4, 1, 1);
+
+	/* Everything can be evaluated at compile time */
+	static_assert((A * B).values[7] == -1, "constexpr product");
+	static_assert(transpose(A).values[5] == 6, "constexpr transpose");
+	static_assert(Matrix3i::identity() * transpose(A) * A ==
+								transpose(A) * A, "constexpr identity");
+	static_assert((Matrix4i::translate(Vec3i(1, 2, 3)) *
+								 Point3i(1, 1, 1)).z == 4, "constexpr transform");
+	static_assert((A + A - 2 * A) == Matrix<2, 3, int>(), "constexpr arithmetic");
+	static_assert(A * transposeView(A) == A * transpose(A), "constexpr view");
+	
+	/* A 4x4 matrix whose products have no repeated values */
+	template <typename Scalar>
+	Matrix4<Scalar> Sequence(int first) {
+		Matrix4<Scalar> m;
+		for(int i = 0; i < 16; ++i) {
+			m.values[i] = static_cast<Scalar>((first + i * 7) % 23 - 11) / 4;
+		}
+		return m;
+	}
+	
+	typedef Matrix<3, 2, int> Matrix3x2i;
+	typedef Matrix<3, 4, int, RowMajor> RowMatrix3x4i;
+	typedef Matrix<4, 4, float, RowMajor> RowMatrix4f;
+	typedef Matrix<4, 4, double, RowMajor> RowMatrix4d;
+}
+
+TEST(Matrix, Construction) {
+	EXPECT_EQ(A.values[0], 1);
+	EXPECT_EQ(A.values[1], 4);
+	EXPECT_EQ(A.values[2], 2);
+	EXPECT_EQ(A.values[5], 6);
+	EXPECT_EQ(A(0, 2), 3);
+	EXPECT_EQ(A(1, 0), 4);
+	EXPECT_EQ(Matrix2x3f(), Matrix2x3f(0, 0, 0, 0, 0, 0));
+
+	Matrix2x3d m(A);
+	EXPECT_EQ(m, A);
+	m(1, 1) = 7;
+	EXPECT_EQ(m.values[3], 7.0);
+	EXPECT_NE(m, A);
+	m = A;
+	EXPECT_EQ(m, A);
+
+	EXPECT_EQ(alignof(Matrix3x4d), alignof(double));
+	EXPECT_EQ(alignof(Matrix4x3f), 16u);
+	EXPECT_EQ(sizeof(Matrix3x4f), 12 * sizeof(float));
+}
+
+TEST(Matrix, Product) {
+	const Matrix<2, 4, int> expected(5, 14, 2, -1,
+																	 14, 29, 2, -1);
+	EXPECT_EQ(A * B, expected);
+	EXPECT_EQ(Matrix2x3f(A) * Matrix3x4d(B), expected);
+	::testing::StaticAssertTypeEq<decltype(Matrix2x3f(A) * B),
+																Matrix<2, 4, float>>();
+
+	/* (AB)^T = B^T A^T */
+	EXPECT_EQ(transpose(A * B), transpose(B) * transpose(A));
+	EXPECT_EQ(transpose(transpose(B)), B);
+
+	Matrix3x4d c(B);
+	c *= Matrix4d::identity();
+	EXPECT_EQ(c, B);
+	c *= 2 * Matrix4d::identity();
+	EXPECT_EQ(c, 2 * B);
+}
+
+TEST(Matrix, Transform) {
+	/* A 2D affine transformation */
+	const Point2i p = A * Point2i(1, -1);
+	EXPECT_EQ(p.x, 2);
+	EXPECT_EQ(p.y, 5);
+	EXPECT_EQ(A * Vec2i(1, -1), Vec2i(-1, -1));
+	EXPECT_EQ(A * Vec3i(1, -1, 1), Vec2i(2, 5));
+
+	/* A 3D affine transformation agrees with its 4x4 form */
+	const Matrix4d full(1, 0, -1, 2,
+											2, 1, 0, -3,
+											0, 4, 1, 1,
+											0, 0, 0, 1);
+	const Point3d q = Matrix3x4d(B) * Point3d(1, 2, 3);
+	const Point3d r = full * Point3d(1, 2, 3);
+	EXPECT_EQ(q.x, r.x);
+	EXPECT_EQ(q.y, r.y);
+	EXPECT_EQ(q.z, r.z);
+	EXPECT_EQ(B * Vec3i(1, 2, 3), Vec3i(-2, 4, 11));
+	EXPECT_EQ(B * Vec4i(1, 2, 3, 1), Vec3i(0, 1, 12));
+	EXPECT_EQ(transpose(B) * Vec3i(1, 1, 1), Vec4i(3, 5, 0, 0));
+}
+
+TEST(Matrix, RowMajor) {
+	const Matrix<2, 3, int, RowMajor> r(1, 2, 3,
+																			4, 5, 6);
+	EXPECT_EQ(r.values[1], 2);
+	EXPECT_EQ(r.values[3], 4);
+	EXPECT_EQ(r(1, 0), 4);
+	EXPECT_EQ(r, A);
+	EXPECT_EQ(A, r);
+	EXPECT_EQ(alignof(Matrix<4, 3, float, RowMajor>), alignof(float));
+	EXPECT_EQ(alignof(Matrix<3, 4, float, RowMajor>), 16u);
+	
+	/* Conversions and operations across orders keep the elements */
+	const Matrix<2, 3, double> c(r);
+	EXPECT_EQ(c.values[1], 4.0);
+	Matrix<2, 3, double, RowMajor> d;
+	d = A;
+	EXPECT_EQ(d.values[1], 2.0);
+	EXPECT_EQ(r + A, 2 * A);
+	::testing::StaticAssertTypeEq<decltype(r - A),
+																Matrix<2, 3, int, RowMajor>>();
+	
+	const RowMatrix3x4i s(B);
+	EXPECT_EQ(r * s, A * B);
+	EXPECT_EQ(r * B, A * B);
+	EXPECT_EQ(A * s, A * B);
+	EXPECT_EQ(transpose(r), transpose(A));
+	EXPECT_EQ(Matrix3i(Matrix<3, 3, int, RowMajor>::identity()),
+						Matrix3i::identity());
+	EXPECT_EQ(s * Vec4i(1, 2, 3, 1), Vec3i(0, 1, 12));
+	
+	/* The SIMD products of row major matrices match the column major ones */
+	const Matrix4f a = Sequence<float>(3), b = Sequence<float>(5);
+	EXPECT_EQ(RowMatrix4f(a) * RowMatrix4f(b), a * b);
+	EXPECT_EQ(RowMatrix4d(a) * RowMatrix4d(b), Matrix4d(a) * Matrix4d(b));
+}
+
+TEST(Matrix, TransposeView) {
+	const MatrixView<3, 2, int, RowMajor> t = transposeView(A);
+	EXPECT_EQ(t(2, 1), 6);
+	EXPECT_EQ(t(0, 1), 4);
+	EXPECT_EQ(t.values, A.values);
+	EXPECT_EQ(Matrix3x2i(t), transpose(A));
+	EXPECT_EQ(transposeView(t).values, A.values);
+	
+	/* Products with a view equal those with the transposed copy */
+	EXPECT_EQ(A * transposeView(A), A * transpose(A));
+	EXPECT_EQ(transposeView(A) * A, transpose(A) * A);
+	EXPECT_EQ(transposeView(B) * transposeView(A), transpose(A * B));
+	const Matrix<2, 3, int, RowMajor> r(A);
+	EXPECT_EQ(r * transposeView(r), A * transpose(A));
+	::testing::StaticAssertTypeEq<decltype(transposeView(A) * r),
+																Matrix<3, 3, int, RowMajor>>();
+	
+	/* The SIMD products give identical results */
+	const Matrix4f af = Sequence<float>(3), bf = Sequence<float>(5);
+	EXPECT_EQ(af * transposeView(bf), af * transpose(bf));
+	const Matrix4d ad = Sequence<double>(3), bd = Sequence<double>(5);
+	EXPECT_EQ(ad * transposeView(bd), ad * transpose(bd));
+	EXPECT_EQ(transposeView(bd) * ad, transpose(bd) * ad);
+}
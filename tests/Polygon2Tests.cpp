@@ -0,0 +1,286 @@
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "geom/Polygon2.hpp"
+
+using namespace geom;
+
+namespace {
+	/* A star-shaped outline around c, counterclockwise */
+	template <typename Scalar>
+	std::vector<Point2<Scalar>> Star(std::size_t count, double x, double y,
+																	 double radius, unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<double> dist(0.3, 1);
+		std::vector<Point2<Scalar>> points;
+		for(std::size_t i = 0; i < count; ++i) {
+			const double a = 2 * M_PI * double(i) / double(count);
+			const double r = radius * dist(gen);
+			points.push_back(Point2<Scalar>(Scalar(x + r * std::cos(a)),
+																			Scalar(y + r * std::sin(a))));
+		}
+		return points;
+	}
+	
+	/* Whether p is inside the polygon, by the crossing number of a ray */
+	template <typename Scalar>
+	bool Inside(const Polygon2<Scalar> &polygon, double x, double y) {
+		bool inside = false;
+		for(std::size_t r = 0; r < polygon.rings(); ++r) {
+			const std::uint32_t first = polygon.offsets[r];
+			const std::uint32_t n = polygon.offsets[r + 1] - first;
+			for(std::uint32_t i = 0, j = n - 1; i < n; j = i++) {
+				const Point2<Scalar> &a = polygon.vertices[first + i];
+				const Point2<Scalar> &b = polygon.vertices[first + j];
+				if((a.y > y) != (b.y > y) &&
+					 x < double(a.x) + (y - a.y) * (double(b.x) - a.x) /
+					 (double(b.y) - a.y))
+				{
+					inside = !inside;
+				}
+			}
+		}
+		return inside;
+	}
+	
+	/*
+	 * The triangles are counterclockwise, inside the polygon and cover its
+	 * area, and without collinear vertices there are n - 2 + 2h of them.
+	 */
+	template <typename Scalar>
+	void ExpectTriangles(const Polygon2<Scalar> &polygon,
+											 const std::vector<std::uint32_t> &triangles,
+											 bool exact = true)
+	{
+		ASSERT_EQ(triangles.size() % 3, 0u);
+		double sum = 0;
+		for(std::size_t k = 0; k < triangles.size(); k += 3) {
+			ASSERT_LT(triangles[k + 2], polygon.vertices.size());
+			const Point2<Scalar> &a = polygon.vertices[triangles[k]];
+			const Point2<Scalar> &b = polygon.vertices[triangles[k + 1]];
+			const Point2<Scalar> &c = polygon.vertices[triangles[k + 2]];
+			const double o = orient2d(a, b, c);
+			EXPECT_GT(o, 0);
+			sum += o / 2;
+			EXPECT_TRUE(Inside(polygon, (double(a.x) + b.x + c.x) / 3,
+												 (double(a.y) + b.y + c.y) / 3));
+		}
+		EXPECT_NEAR(sum, area(polygon), 1e-9 * std::fabs(area(polygon)));
+		if(exact) {
+			EXPECT_EQ(triangles.size() / 3,
+								polygon.vertices.size() - 2 + 2 * polygon.holes());
+		}
+	}
+	
+	/* Both the dispatching triangulation and the monotone decomposition */
+	template <typename Scalar>
+	void ExpectTriangulation(const Polygon2<Scalar> &polygon,
+													 bool exact = true)
+	{
+		std::vector<std::uint32_t> triangles;
+		EXPECT_TRUE(triangulate(polygon, triangles));
+		ExpectTriangles(polygon, triangles, exact);
+		detail::MonotoneTriangulator<Scalar> monotone(polygon.vertices.data(),
+																									polygon.offsets.data(),
+																									polygon.rings());
+		triangles.clear();
+		EXPECT_TRUE(monotone.run(triangles));
+		ExpectTriangles(polygon, triangles, exact);
+	}
+}
+
+TEST(Polygon2, Properties) {
+	const Point2d square[] = {
+		Point2d(0, 0), Point2d(4, 0), Point2d(4, 4), Point2d(0, 4)
+	};
+	const Point2d hole[] = {
+		Point2d(1, 1), Point2d(1, 2), Point2d(2, 2), Point2d(2, 1)
+	};
+	Polygon2d p(square, 4);
+	EXPECT_EQ(p.rings(), 1u);
+	EXPECT_EQ(p.holes(), 0u);
+	EXPECT_EQ(winding(p), 1);
+	EXPECT_EQ(area(p), 16);
+	EXPECT_EQ(centroid(p).x, 2);
+	EXPECT_EQ(centroid(p).y, 2);
+	
+	/* A hole takes its area and moves the centroid away */
+	p.addHole(hole, 4);
+	EXPECT_EQ(p.holes(), 1u);
+	EXPECT_EQ(area(p), 15);
+	EXPECT_NEAR(centroid(p).x, (16 * 2 - 1.5) / 15, 1e-12);
+	EXPECT_NEAR(centroid(p).y, (16 * 2 - 1.5) / 15, 1e-12);
+	
+	/* The same clockwise, and far from the origin */
+	std::vector<Point2d> reversed(square, square + 4);
+	std::reverse(reversed.begin(), reversed.end());
+	for(std::size_t i = 0; i < 4; ++i) {
+		reversed[i].x += 1e7;
+	}
+	p.assign(reversed.data(), 4);
+	EXPECT_EQ(p.holes(), 0u);
+	EXPECT_EQ(winding(p), -1);
+	EXPECT_EQ(area(p), 16);
+	EXPECT_EQ(centroid(p).x, 1e7 + 2);
+	
+	/* An L of two squares, in integers */
+	const Point2i l[] = {
+		Point2i(0, 0), Point2i(2, 0), Point2i(2, 1), Point2i(1, 1), Point2i(1, 2),
+		Point2i(0, 2)
+	};
+	const Polygon2i li(l, 6);
+	EXPECT_EQ(area(li), 3);
+	EXPECT_NEAR(centroid(li).x, 5.0 / 6, 1e-12);
+	EXPECT_NEAR(centroid(li).y, 5.0 / 6, 1e-12);
+	EXPECT_EQ(winding(Polygon2i()), 0);
+	EXPECT_EQ(area(Polygon2i()), 0);
+}
+
+TEST(Polygon2, Small) {
+	const Point2i l[] = {
+		Point2i(0, 0), Point2i(2, 0), Point2i(2, 1), Point2i(1, 1), Point2i(1, 2),
+		Point2i(0, 2)
+	};
+	ExpectTriangulation(Polygon2i(l, 6));
+	std::vector<Point2i> reversed(l, l + 6);
+	std::reverse(reversed.begin(), reversed.end());
+	ExpectTriangulation(Polygon2i(reversed.data(), 6));
+	for(unsigned seed = 0; seed < 50; ++seed) {
+		ExpectTriangulation(Polygon2d(Star<double>(4 + seed % 29, 0, 0, 1, seed)
+																	.data(), 4 + seed % 29));
+		ExpectTriangulation(Polygon2f(Star<float>(5 + seed % 11, 3, 1, 2, seed)
+																	.data(), 5 + seed % 11));
+	}
+	
+	/* The raw array overload and a single triangle */
+	const std::vector<Point2d> star = Star<double>(12, 0, 0, 1, 99);
+	std::vector<std::uint32_t> triangles;
+	EXPECT_TRUE(triangulate(star.data(), star.size(), triangles));
+	EXPECT_EQ(triangles.size(), 30u);
+	EXPECT_TRUE(triangulate(star.data(), 3, triangles));
+	EXPECT_EQ(triangles.size(), 3u);
+}
+
+TEST(Polygon2, Degenerate) {
+	/* A square with a vertex in the middle of each side */
+	const Point2d square[] = {
+		Point2d(0, 0), Point2d(1, 0), Point2d(2, 0), Point2d(2, 1), Point2d(2, 2),
+		Point2d(1, 2), Point2d(0, 2), Point2d(0, 1)
+	};
+	ExpectTriangulation(Polygon2d(square, 8), false);
+	
+	/* Polygons of no area */
+	std::vector<std::uint32_t> triangles;
+	const Point2d line[] = { Point2d(0, 0), Point2d(1, 1), Point2d(2, 2) };
+	EXPECT_TRUE(triangulate(line, 3, triangles));
+	EXPECT_TRUE(triangles.empty());
+	EXPECT_TRUE(triangulate(line, 0, triangles));
+	EXPECT_TRUE(triangles.empty());
+	
+	/* Vertices on one horizontal, where ties in y are broken by x */
+	const Point2d comb[] = {
+		Point2d(0, 0), Point2d(1, 1), Point2d(2, 0), Point2d(3, 1), Point2d(4, 0),
+		Point2d(5, 1), Point2d(6, 0), Point2d(6, 2), Point2d(5, 3), Point2d(4, 2),
+		Point2d(3, 3), Point2d(2, 2), Point2d(1, 3), Point2d(0, 2)
+	};
+	ExpectTriangulation(Polygon2d(comb, 14));
+}
+
+TEST(Polygon2, Large) {
+	/* Beyond the ear clipper, and combs full of split and merge vertices */
+	ExpectTriangulation(Polygon2d(Star<double>(1000, 0, 0, 1, 1).data(), 1000));
+	std::vector<Point2d> comb;
+	for(int i = 0; i < 200; ++i) {
+		comb.push_back(Point2d(2 * i, (i % 2) * 10 + i % 3));
+	}
+	for(int i = 199; i >= 0; --i) {
+		comb.push_back(Point2d(2 * i + 1, 20 - (i % 2) * 10 + i % 5));
+	}
+	ExpectTriangulation(Polygon2d(comb.data(), comb.size()));
+	
+	/* A spiral, whose monotone pieces wind around it */
+	std::vector<Point2d> spiral;
+	for(int i = 0; i < 300; ++i) {
+		const double a = i * 0.1, r = 1 + a;
+		spiral.push_back(Point2d(r * std::cos(a), r * std::sin(a)));
+	}
+	for(int i = 299; i >= 0; --i) {
+		const double a = i * 0.1, r = 1.5 + a;
+		spiral.push_back(Point2d(r * std::cos(a), r * std::sin(a)));
+	}
+	ExpectTriangulation(Polygon2d(spiral.data(), spiral.size()));
+}
+
+TEST(Polygon2, Holes) {
+	/* A square with a grid of square holes, given either way around */
+	const Point2d square[] = {
+		Point2d(0, 0), Point2d(10, 0), Point2d(10, 10), Point2d(0, 10)
+	};
+	Polygon2d p(square, 4);
+	for(int x = 0; x < 4; ++x) {
+		for(int y = 0; y < 4; ++y) {
+			Point2d hole[] = {
+				Point2d(1 + 2 * x, 1 + 2 * y), Point2d(2 + 2 * x, 1 + 2 * y),
+				Point2d(2 + 2 * x, 1.5 + 2 * y), Point2d(1 + 2 * x, 2 + 2 * y)
+			};
+			if((x + y) % 2) {
+				std::reverse(hole, hole + 4);
+			}
+			p.addHole(hole, 4);
+		}
+	}
+	ExpectTriangulation(p);
+	EXPECT_NEAR(area(p), 100 - 16 * 0.75, 1e-12);
+	
+	/* Random stars with star holes, all off the same horizontals */
+	for(unsigned seed = 0; seed < 10; ++seed) {
+		Polygon2d q(Star<double>(40, 0, 0, 20, seed).data(), 40);
+		const std::vector<Point2d> a = Star<double>(12, -2.5, 0.1, 2, seed + 1);
+		const std::vector<Point2d> b = Star<double>(9, 2, -0.3, 1.5, seed + 2);
+		q.addHole(a.data(), a.size());
+		q.addHole(b.data(), b.size());
+		ExpectTriangulation(q);
+	}
+}
+
+TEST(Polygon2, Contains) {
+	const Point2i square[] = {
+		Point2i(0, 0), Point2i(4, 0), Point2i(4, 4), Point2i(0, 4)
+	};
+	const Point2i hole[] = {
+		Point2i(1, 1), Point2i(1, 3), Point2i(3, 3), Point2i(3, 1)
+	};
+	Polygon2i p(square, 4);
+	p.addHole(hole, 4);
+	EXPECT_TRUE(contains(p, Point2i(0, 2)));
+	EXPECT_FALSE(contains(p, Point2i(2, 2)));
+	EXPECT_FALSE(contains(p, Point2i(5, 2)));
+	EXPECT_FALSE(contains(p, Point2i(-1, 0)));
+	
+	/* A boundary point counts as moved right and then up */
+	EXPECT_TRUE(contains(p, Point2i(0, 0)));
+	EXPECT_TRUE(contains(p, Point2i(2, 0)));
+	EXPECT_FALSE(contains(p, Point2i(4, 2)));
+	EXPECT_FALSE(contains(p, Point2i(2, 4)));
+	EXPECT_FALSE(contains(p, Point2i(4, 0)));
+	EXPECT_FALSE(contains(p, Point2i(1, 2)));
+	EXPECT_TRUE(contains(p, Point2i(3, 2)));
+	EXPECT_FALSE(contains(p, Point2i(2, 1)));
+	EXPECT_TRUE(contains(p, Point2i(2, 3)));
+	
+	/* Of polygons sharing an edge, exactly one has each point of it */
+	const Point2d a[] = { Point2d(0, 0), Point2d(2, 1), Point2d(0, 3) };
+	const Point2d b[] = { Point2d(2, 1), Point2d(3, 4), Point2d(0, 3) };
+	const Polygon2d pa(a, 3), pb(b, 3);
+	for(int i = 0; i <= 8; ++i) {
+		const Point2d q(i * 0.25, 1 + i * 0.25);
+		EXPECT_NE(contains(pa, q), contains(pb, q));
+	}
+	EXPECT_FALSE(contains(Polygon2d(), Point2d(0, 0)));
+}
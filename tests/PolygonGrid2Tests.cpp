@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "geom/PolygonGrid2.hpp"
+#include "geom/Voronoi.hpp"
+
+using namespace geom;
+
+namespace {
+	/* A star-shaped ring around (x, y), counterclockwise */
+	template <typename Scalar>
+	std::vector<Point2<Scalar>> Star(std::mt19937 &gen, std::size_t count,
+																	 double x, double y, double radius)
+	{
+		std::uniform_real_distribution<double> dist(0.4, 1);
+		std::vector<Point2<Scalar>> points;
+		for(std::size_t i = 0; i < count; ++i) {
+			const double a = 2 * M_PI * double(i) / double(count);
+			const double r = radius * dist(gen);
+			points.push_back(Point2<Scalar>(Scalar(x + r * std::cos(a)),
+																			Scalar(y + r * std::sin(a))));
+		}
+		return points;
+	}
+	
+	/* The lowest id of the polygons containing p, by testing each */
+	template <typename Scalar>
+	std::uint32_t Naive(const std::vector<Polygon2<Scalar>> &polygons,
+											const Point2<Scalar> &p)
+	{
+		for(std::size_t i = 0; i < polygons.size(); ++i) {
+			if(contains(polygons[i], p)) {
+				return std::uint32_t(i);
+			}
+		}
+		return PolygonGrid2<Scalar>::None;
+	}
+	
+	/* The grid agrees with the naive test, one point at a time and batched */
+	template <typename Scalar>
+	void ExpectLocate(const std::vector<Polygon2<Scalar>> &polygons,
+										const std::vector<Point2<Scalar>> &points,
+										std::size_t cells = 0)
+	{
+		PolygonGrid2<Scalar> grid;
+		polygonGrid(polygons.data(), polygons.size(), grid, cells);
+		std::vector<std::uint32_t> ids(points.size());
+		locate(grid, points.data(), points.size(), ids.data(), Parallel(4, 1));
+		for(std::size_t i = 0; i < points.size(); ++i) {
+			const std::uint32_t id = Naive(polygons, points[i]);
+			ASSERT_EQ(locate(grid, points[i]), id) << points[i].x << ", "
+																						 << points[i].y;
+			ASSERT_EQ(ids[i], id);
+		}
+	}
+	
+	/* Random points in the square, and every vertex and edge midpoint */
+	template <typename Scalar>
+	std::vector<Point2<Scalar>> Queries(
+		const std::vector<Polygon2<Scalar>> &polygons, std::size_t count,
+		double lo, double hi, unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<double> dist(lo, hi);
+		std::vector<Point2<Scalar>> points;
+		for(std::size_t i = 0; i < count; ++i) {
+			const double x = dist(gen);
+			points.push_back(Point2<Scalar>(Scalar(x), Scalar(dist(gen))));
+		}
+		for(std::size_t i = 0; i < polygons.size(); ++i) {
+			const std::vector<Point2<Scalar>> &v = polygons[i].vertices;
+			for(std::size_t k = 0; k < v.size(); ++k) {
+				const Point2<Scalar> &n = v[k + 1 < v.size() ? k + 1 : 0];
+				points.push_back(v[k]);
+				points.push_back(Point2<Scalar>((v[k].x + n.x) / 2,
+																				(v[k].y + n.y) / 2));
+			}
+		}
+		return points;
+	}
+}
+
+TEST(PolygonGrid2, Small) {
+	/* A square with a hole, a square in the hole and one sharing a side */
+	const Point2i square[] = {
+		Point2i(0, 0), Point2i(8, 0), Point2i(8, 8), Point2i(0, 8)
+	};
+	const Point2i hole[] = {
+		Point2i(2, 2), Point2i(2, 6), Point2i(6, 6), Point2i(6, 2)
+	};
+	const Point2i inner[] = {
+		Point2i(3, 3), Point2i(5, 3), Point2i(4, 5)
+	};
+	const Point2i side[] = {
+		Point2i(8, 0), Point2i(12, 4), Point2i(8, 8)
+	};
+	std::vector<Polygon2i> polygons(3);
+	polygons[0].assign(square, 4);
+	polygons[0].addHole(hole, 4);
+	polygons[1].assign(inner, 3);
+	polygons[2].assign(side, 3);
+	
+	/* Every lattice point, many on boundaries, with grids of any size */
+	std::vector<Point2i> points;
+	for(int x = -1; x <= 13; ++x) {
+		for(int y = -1; y <= 9; ++y) {
+			points.push_back(Point2i(x, y));
+		}
+	}
+	ExpectLocate(polygons, points);
+	ExpectLocate(polygons, points, 1);
+	ExpectLocate(polygons, points, 1000);
+	
+	PolygonGrid2i grid;
+	polygonGrid(polygons.data(), polygons.size(), grid);
+	EXPECT_EQ(locate(grid, Point2i(1, 1)), 0u);
+	EXPECT_EQ(locate(grid, Point2i(4, 4)), 1u);
+	EXPECT_EQ(locate(grid, Point2i(5, 5)), PolygonGrid2i::None);
+	EXPECT_EQ(locate(grid, Point2i(8, 4)), 2u);
+	EXPECT_EQ(locate(grid, Point2i(12, 4)), PolygonGrid2i::None);
+}
+
+TEST(PolygonGrid2, Degenerate) {
+	/* No polygons, and polygons without area */
+	PolygonGrid2d grid;
+	polygonGrid(static_cast<const Polygon2d*>(0), 0, grid);
+	EXPECT_EQ(locate(grid, Point2d(0, 0)), PolygonGrid2d::None);
+	std::vector<Point2d> points(1, Point2d(0, 0));
+	std::vector<std::uint32_t> ids(1);
+	locate(grid, points.data(), 1, ids.data());
+	EXPECT_EQ(ids[0], PolygonGrid2d::None);
+	
+	const Point2d line[] = { Point2d(0, 0), Point2d(1, 1), Point2d(2, 2) };
+	const Point2d flat[] = { Point2d(0, 1), Point2d(3, 1), Point2d(1, 1) };
+	const Point2d same[] = { Point2d(2, 0), Point2d(2, 0), Point2d(2, 0) };
+	std::vector<Polygon2d> polygons(3);
+	polygons[0].assign(line, 3);
+	polygons[1].assign(flat, 3);
+	polygons[2].assign(same, 3);
+	ExpectLocate(polygons, Queries(polygons, 100, -1, 3, 1));
+	polygonGrid(polygons.data(), 3, grid);
+	EXPECT_EQ(grid.columns * grid.rows, grid.cells.size() - 1);
+	
+	/* Repeated vertices and collinear edges, touching another polygon */
+	const Point2d a[] = {
+		Point2d(0, 0), Point2d(1, 0), Point2d(1, 0), Point2d(2, 0), Point2d(2, 2),
+		Point2d(0, 2), Point2d(0, 1)
+	};
+	const Point2d b[] = {
+		Point2d(2, 0), Point2d(3, 1), Point2d(2, 1), Point2d(2, 2)
+	};
+	polygons.resize(2);
+	polygons[0].assign(a, 7);
+	polygons[1].assign(b, 4);
+	ExpectLocate(polygons, Queries(polygons, 1000, -1, 4, 2));
+	ExpectLocate(polygons, Queries(polygons, 1000, -1, 4, 2), 7);
+}
+
+TEST(PolygonGrid2, Random) {
+	/* Overlapping stars with holes, some clockwise */
+	std::mt19937 gen(3);
+	std::uniform_real_distribution<double> dist(0, 100);
+	std::vector<Polygon2d> polygons(40);
+	for(std::size_t i = 0; i < polygons.size(); ++i) {
+		const double x = dist(gen), y = dist(gen);
+		std::vector<Point2d> ring = Star<double>(gen, 5 + i * 3, x, y, 20);
+		if(i % 3 == 0) {
+			std::reverse(ring.begin(), ring.end());
+		}
+		polygons[i].assign(ring.data(), ring.size());
+		const std::vector<Point2d> hole = Star<double>(gen, 12, x, y, 7);
+		polygons[i].addHole(hole.data(), hole.size());
+	}
+	const std::vector<Point2d> points = Queries(polygons, 5000, -30, 130, 4);
+	ExpectLocate(polygons, points);
+	ExpectLocate(polygons, points, 1);
+	ExpectLocate(polygons, points, 100000);
+	
+	/* In float, far from the origin */
+	std::vector<Polygon2f> floats(polygons.size());
+	for(std::size_t i = 0; i < polygons.size(); ++i) {
+		for(std::size_t r = 0; r < polygons[i].rings(); ++r) {
+			std::vector<Point2f> ring;
+			for(std::uint32_t k = polygons[i].offsets[r];
+					k < polygons[i].offsets[r + 1]; ++k)
+			{
+				const Point2d &p = polygons[i].vertices[k];
+				ring.push_back(Point2f(float(p.x + 1e4), float(p.y + 1e4)));
+			}
+			if(r == 0) {
+				floats[i].assign(ring.data(), ring.size());
+			} else {
+				floats[i].addHole(ring.data(), ring.size());
+			}
+		}
+	}
+	ExpectLocate(floats, Queries(floats, 5000, 1e4 - 30, 1e4 + 130, 5));
+}
+
+TEST(PolygonGrid2, FloatOffset) {
+	/*
+	 * Stars spanning a few units in float around a million, where an ulp
+	 * is a sixteenth and rounding the reference points moves them by more
+	 * than a fraction of a cell.
+	 */
+	for(unsigned seed = 0; seed < 10; ++seed) {
+		for(int span = 1; span <= 3; span += 2) {
+			std::mt19937 gen(seed);
+			std::uniform_real_distribution<double> dist(1e6, 1e6 + span);
+			std::vector<Polygon2f> polygons(8);
+			for(std::size_t i = 0; i < polygons.size(); ++i) {
+				const std::vector<Point2f> ring =
+					Star<float>(gen, 30, dist(gen), dist(gen), 0.3 * span);
+				polygons[i].assign(ring.data(), ring.size());
+			}
+			const std::vector<Point2f> points =
+				Queries(polygons, 2000, 1e6 - span, 1e6 + 2 * span, seed);
+			ExpectLocate(polygons, points);
+			ExpectLocate(polygons, points, 1000);
+		}
+	}
+}
+
+TEST(PolygonGrid2, Partition) {
+	/* Voronoi cells tile the rectangle, sharing their vertices exactly */
+	std::mt19937 gen(6);
+	std::uniform_real_distribution<double> dist(0, 1);
+	std::vector<Point2d> sites;
+	for(int i = 0; i < 500; ++i) {
+		const double x = dist(gen);
+		sites.push_back(Point2d(x, dist(gen)));
+	}
+	Voronoi2<double> v;
+	voronoi(sites.data(), sites.size(), Rectangle2d(0, 0, 1, 1), v);
+	std::vector<Polygon2d> cells(sites.size());
+	for(std::size_t i = 0; i < sites.size(); ++i) {
+		cells[i].assign(&v.vertices[v.offsets[i]],
+										v.offsets[i + 1] - v.offsets[i]);
+	}
+	const std::vector<Point2d> points = Queries(cells, 20000, 0, 1, 7);
+	ExpectLocate(cells, points);
+	
+	PolygonGrid2d grid;
+	polygonGrid(cells.data(), cells.size(), grid);
+	std::size_t found = 0;
+	for(std::size_t i = 0; i < 20000; ++i) {
+		found += locate(grid, points[i]) != PolygonGrid2d::None;
+	}
+	EXPECT_EQ(found, 20000u);
+}
@@ -0,0 +1,239 @@
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+#include "geom/Predicates.hpp"
+
+using namespace geom;
+
+namespace {
+	int Sign(double v) {
+		return v > 0 ? 1 : (v < 0 ? -1 : 0);
+	}
+
+	/* Coordinates k * 2^-53 for k in [2^52, 2^53), all with the same ulp */
+	double Dyadic(std::mt19937_64 &gen) {
+		const std::uint64_t k = (gen() >> 11) | (std::uint64_t(1) << 52);
+		return std::ldexp(double(k), -53);
+	}
+	std::int64_t Numerator(double v) {
+		return std::int64_t(std::ldexp(v, 53));
+	}
+
+	/* Points on the circle and the sphere of radius 65 and 9 */
+	const int Circle[][2] = {
+		{ 65, 0 }, { 63, 16 }, { 60, 25 }, { 56, 33 }, { 52, 39 }, { 39, 52 },
+		{ 33, 56 }, { 25, 60 }, { 16, 63 }, { 0, 65 }, { -16, 63 }, { -33, 56 },
+		{ -52, 39 }, { -60, 25 }, { -65, 0 }, { -56, -33 }, { -39, -52 },
+		{ 0, -65 }, { 25, -60 }, { 52, -39 }, { 63, -16 }
+	};
+	const int Sphere[][3] = {
+		{ 1, 4, 8 }, { 4, 4, 7 }, { 0, 0, 9 }, { 3, 6, 6 }, { -8, 1, 4 },
+		{ 7, -4, -4 }, { 9, 0, 0 }, { -6, -3, 6 }, { 4, -7, 4 }, { 0, -9, 0 },
+		{ -1, -4, -8 }, { -4, 8, -1 }, { 6, 6, -3 }, { -9, 0, 0 }
+	};
+}
+
+TEST(Predicates, Orient2d) {
+	EXPECT_GT(orient2d(Point2d(0, 0), Point2d(1, 0), Point2d(0, 1)), 0);
+	EXPECT_LT(orient2d(Point2d(0, 0), Point2d(0, 1), Point2d(1, 0)), 0);
+	EXPECT_EQ(orient2d(Point2d(0, 0), Point2d(1, 1), Point2d(3, 3)), 0);
+	EXPECT_EQ(orient2d(Point2f(0, 0), Point2f(2, 0), Point2f(0, 2)), 4);
+	EXPECT_EQ(orient2d(Point2i(1, 1), Point2i(2, 2), Point2i(3, 4)), 1);
+
+	/*
+	 * Points rounded onto the line through two others, where the naive
+	 * determinant is mostly rounding error. Every coordinate is a multiple
+	 * of 2^-53 below 1, so the exact determinant fits in 128 bits.
+	 */
+	std::mt19937_64 gen(1);
+	std::uniform_real_distribution<double> t(0, 1);
+	int wrong = 0;
+	for(int i = 0; i < 2000; ++i) {
+		const Point2d a(Dyadic(gen), Dyadic(gen)), b(Dyadic(gen), Dyadic(gen));
+		const double s = t(gen);
+		const Point2d c(a.x + s * (b.x - a.x), a.y + s * (b.y - a.y));
+		const __int128 exact =
+			__int128(Numerator(a.x) - Numerator(c.x)) *
+			(Numerator(b.y) - Numerator(c.y)) -
+			__int128(Numerator(a.y) - Numerator(c.y)) *
+			(Numerator(b.x) - Numerator(c.x));
+		ASSERT_EQ(Sign(orient2d(a, b, c)), exact > 0 ? 1 : (exact < 0 ? -1 : 0));
+		const double naive = (a.x - c.x) * (b.y - c.y) - (a.y - c.y) * (b.x - c.x);
+		wrong += Sign(naive) != Sign(orient2d(a, b, c));
+
+		/* Permutations agree */
+		ASSERT_EQ(Sign(orient2d(b, c, a)), Sign(orient2d(a, b, c)));
+		ASSERT_EQ(Sign(orient2d(b, a, c)), -Sign(orient2d(a, b, c)));
+	}
+	EXPECT_GT(wrong, 0);
+
+	/* Coordinates whose differences are inexact */
+	const double tiny = std::ldexp(1.0, -60), huge = std::ldexp(1.0, 60);
+	const Point2d p(tiny, tiny), q(huge, huge);
+	EXPECT_EQ(orient2d(p, Point2d(1, 1), q), 0);
+	EXPECT_GT(orient2d(p, q, Point2d(1, 1 + std::ldexp(1.0, -52))), 0);
+	EXPECT_LT(orient2d(p, q, Point2d(1, 1 - std::ldexp(1.0, -53))), 0);
+
+	/* 64 bit integers, which round when converted to double */
+	const std::int64_t b = std::int64_t(1) << 62;
+	const Point2l l0(-b, -b), l1(b, b - 3);
+	for(std::int64_t i = -20; i <= 20; ++i) {
+		const Point2l r(i * 4, i * 4 + (i % 3));
+		const __int128 exact = __int128(l0.x - r.x) * (l1.y - r.y) -
+			__int128(l0.y - r.y) * (l1.x - r.x);
+		ASSERT_EQ(Sign(orient2d(l0, l1, r)),
+							exact > 0 ? 1 : (exact < 0 ? -1 : 0));
+	}
+	EXPECT_EQ(orient2d(Point2l(0, 0), Point2l(b, b), Point2l(b / 2, b / 2)), 0);
+	EXPECT_GT(orient2d(Point2ul(1, 0), Point2ul(1, 1), Point2ul(0, 1)), 0);
+}
+
+TEST(Predicates, Orient3d) {
+	const Point3d a(0, 0, 0), b(1, 0, 0), c(0, 1, 0);
+	EXPECT_GT(orient3d(a, b, c, Point3d(0, 0, -1)), 0);
+	EXPECT_LT(orient3d(a, b, c, Point3d(0, 0, 1)), 0);
+	EXPECT_EQ(orient3d(a, b, c, Point3d(5, 7, 0)), 0);
+	EXPECT_EQ(orient3d(Point3f(0, 0, 0), Point3f(1, 0, 0), Point3f(0, 1, 0),
+										 Point3f(0, 0, -2)), 2);
+
+	/*
+	 * Integer points on a common plane, then moved off it by a tiny step
+	 * along x, so the sign is that of the step times the 2D orientation of
+	 * a, b and c in the yz plane.
+	 */
+	std::mt19937 gen(2);
+	std::uniform_int_distribution<int> coordinate(-(1 << 12), 1 << 12);
+	std::uniform_int_distribution<int> weight(-4, 4);
+	for(int i = 0; i < 2000; ++i) {
+		Point3d p[3];
+		for(int j = 0; j < 3; ++j) {
+			p[j] = Point3d(coordinate(gen), coordinate(gen), coordinate(gen));
+		}
+		const int u = weight(gen), v = weight(gen);
+		const double step = std::ldexp(1.0, -28 - int(gen() % 8)) *
+			(gen() % 2 ? 1 : -1);
+		Point3d d(p[0].x + u * (p[1].x - p[0].x) + v * (p[2].x - p[0].x),
+							p[0].y + u * (p[1].y - p[0].y) + v * (p[2].y - p[0].y),
+							p[0].z + u * (p[1].z - p[0].z) + v * (p[2].z - p[0].z));
+		ASSERT_EQ(orient3d(p[0], p[1], p[2], d), 0);
+		d.x += step;
+		const double yz = (p[1].y - p[0].y) * (p[2].z - p[0].z) -
+			(p[1].z - p[0].z) * (p[2].y - p[0].y);
+		ASSERT_EQ(Sign(orient3d(p[0], p[1], p[2], d)), -Sign(step * yz));
+		ASSERT_EQ(Sign(orient3d(p[1], p[0], p[2], d)), Sign(step * yz));
+	}
+
+	/* Coordinates whose differences are inexact, around the plane z = y */
+	const double tiny = std::ldexp(1.0, -60), huge = std::ldexp(1.0, 60);
+	const Point3d p(tiny, tiny, tiny), q(huge, 0, 0), r(0, huge, huge);
+	const double up = orient3d(p, q, r, Point3d(1, 1, 1 + std::ldexp(1.0, -52)));
+	EXPECT_EQ(orient3d(p, q, r, Point3d(1, 1, 1)), 0);
+	EXPECT_NE(up, 0);
+	EXPECT_EQ(Sign(orient3d(p, q, r, Point3d(1, 1, 1 - std::ldexp(1.0, -53)))),
+						-Sign(up));
+}
+
+TEST(Predicates, Incircle) {
+	const Point2d a(4, 3), b(3, 4), c(-3, 4);
+	EXPECT_GT(incircle(a, b, c, Point2d(0, 0)), 0);
+	EXPECT_LT(incircle(a, b, c, Point2d(6, 0)), 0);
+	EXPECT_EQ(incircle(a, b, c, Point2d(0, -5)), 0);
+
+	/* Off the circle by less than the rounding error of the naive test */
+	EXPECT_LT(incircle(a, b, c, Point2d(5, 1e-20)), 0);
+	EXPECT_GT(incircle(a, b, c, Point2d(std::nextafter(5.0, 0.0), 0)), 0);
+	EXPECT_LT(incircle(a, b, c, Point2d(std::nextafter(5.0, 6.0), 0)), 0);
+
+	/*
+	 * Cocircular integer points far from the origin, with the fourth moved
+	 * by a tiny step along x: it ends up inside when the step points to the
+	 * center.
+	 */
+	const int n = sizeof(Circle) / sizeof(Circle[0]);
+	std::mt19937 gen(3);
+	for(int i = 0; i < 2000; ++i) {
+		const double cx = double(gen() % (1 << 20)), cy = double(gen() % 1024);
+		int k[4];
+		for(int j = 0; j < 4; ++j) {
+			k[j] = int(gen() % n);
+		}
+		if(k[0] == k[1] || k[1] == k[2] || k[0] == k[2] || Circle[k[3]][0] == 0) {
+			continue;
+		}
+		Point2d p[4];
+		for(int j = 0; j < 4; ++j) {
+			p[j] = Point2d(cx + Circle[k[j]][0], cy + Circle[k[j]][1]);
+		}
+		if(orient2d(p[0], p[1], p[2]) < 0) {
+			std::swap(p[0], p[1]);
+		}
+		if(k[3] != k[0] && k[3] != k[1] && k[3] != k[2]) {
+			ASSERT_EQ(incircle(p[0], p[1], p[2], p[3]), 0);
+		}
+		const double step = std::ldexp(1.0, -20 - int(gen() % 8)) *
+			(gen() % 2 ? 1 : -1);
+		p[3].x += step;
+		const int inward = (p[3].x - cx) * step < 0 ? 1 : -1;
+		ASSERT_EQ(Sign(incircle(p[0], p[1], p[2], p[3])), inward);
+	}
+
+	/* Coordinates whose differences are inexact */
+	const double tiny = std::ldexp(1.0, -60);
+	const Point2d u(1, 0), v(0, 1), w(-1, 0);
+	EXPECT_LT(incircle(u, v, w, Point2d(tiny, 1)), 0);
+	EXPECT_GT(incircle(u, v, w, Point2d(tiny, 1 - std::ldexp(1.0, -53))), 0);
+
+	EXPECT_GT(incircle(Point2f(1, 0), Point2f(0, 1), Point2f(-1, 0),
+										 Point2f(0, 0.5f)), 0);
+}
+
+TEST(Predicates, Insphere) {
+	const Point3d a(9, 0, 0), b(0, 9, 0), c(0, 0, 9), d(-9, 0, 0);
+	const double o = orient3d(a, b, c, d);
+	EXPECT_NE(o, 0);
+	EXPECT_EQ(Sign(insphere(a, b, c, d, Point3d(0, 0, 0))), Sign(o));
+	EXPECT_EQ(Sign(insphere(a, b, c, d, Point3d(10, 0, 0))), -Sign(o));
+	EXPECT_EQ(insphere(a, b, c, d, Point3d(0, -9, 0)), 0);
+
+	/* Coordinates whose differences are inexact */
+	const double tiny = std::ldexp(1.0, -60);
+	const Point3d u(1, 0, 0), v(0, 1, 0), w(0, 0, 1), x(-1, 0, 0);
+	const int s = Sign(orient3d(u, v, w, x));
+	EXPECT_EQ(Sign(insphere(u, v, w, x, Point3d(tiny, tiny, -1))), -s);
+	EXPECT_EQ(Sign(insphere(u, v, w, x, Point3d(tiny, tiny,
+																							 std::ldexp(1.0, -53) - 1))), s);
+
+	/* Cospherical integer points moved by a tiny step as for incircle */
+	const int n = sizeof(Sphere) / sizeof(Sphere[0]);
+	std::mt19937 gen(4);
+	int tested = 0;
+	for(int i = 0; i < 4000; ++i) {
+		const double cx = double(gen() % (1 << 20)), cy = double(gen() % 1024);
+		const double cz = double(gen() % 1024);
+		Point3d p[5];
+		int k[5];
+		for(int j = 0; j < 5; ++j) {
+			k[j] = int(gen() % n);
+			p[j] = Point3d(cx + Sphere[k[j]][0], cy + Sphere[k[j]][1],
+										 cz + Sphere[k[j]][2]);
+		}
+		if(Sphere[k[4]][0] == 0 || orient3d(p[0], p[1], p[2], p[3]) == 0) {
+			continue;
+		}
+		if(orient3d(p[0], p[1], p[2], p[3]) < 0) {
+			std::swap(p[0], p[1]);
+		}
+		ASSERT_EQ(insphere(p[0], p[1], p[2], p[3], p[4]), 0);
+		const double step = std::ldexp(1.0, -20 - int(gen() % 8)) *
+			(gen() % 2 ? 1 : -1);
+		p[4].x += step;
+		const int inward = (p[4].x - cx) * step < 0 ? 1 : -1;
+		ASSERT_EQ(Sign(insphere(p[0], p[1], p[2], p[3], p[4])), inward);
+		++tested;
+	}
+	EXPECT_GT(tested, 1000);
+}
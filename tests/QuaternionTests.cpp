@@ -0,0 +1,209 @@
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "geom/Quaternion.hpp"
+
+using namespace geom;
+
+namespace {
+	template <typename Scalar>
+	std::vector<Quaternion<Scalar> > RandomRotations(std::size_t count,
+																									 unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(-1, 1);
+		std::vector<Quaternion<Scalar> > q;
+		for(std::size_t i = 0; i < count; ++i) {
+			q.push_back(normalize(Quaternion<Scalar>(dist(gen), dist(gen),
+																							 dist(gen), dist(gen))));
+		}
+		return q;
+	}
+	
+	template <typename Scalar>
+	void ExpectNear(const Quaternion<Scalar> &a, const Quaternion<Scalar> &b,
+									Scalar tol)
+	{
+		EXPECT_NEAR(a.x, b.x, tol);
+		EXPECT_NEAR(a.y, b.y, tol);
+		EXPECT_NEAR(a.z, b.z, tol);
+		EXPECT_NEAR(a.w, b.w, tol);
+	}
+	
+	template <typename Matrix>
+	void ExpectMatrixNear(const Matrix &a, const Matrix &b, double tol) {
+		for(std::size_t i = 0; i < sizeof(a.values) / sizeof(a.values[0]); ++i) {
+			EXPECT_NEAR(a.values[i], b.values[i], tol);
+		}
+	}
+}
+
+TEST(Quaternion, Construction) {
+	Quaternionf zero;
+	EXPECT_EQ(zero, Quaternionf(0,0,0,0));
+	EXPECT_EQ(Quaternionf::identity(), Quaternionf(0,0,0,1));
+	EXPECT_EQ(Quaterniond(Vec3d(1,2,3), 4), Quaterniond(1,2,3,4));
+	EXPECT_EQ(Quaterniond(Quaternionf(1,2,3,4)), Quaterniond(1,2,3,4));
+	EXPECT_EQ(Quaterniond(1,2,3,4).vector(), Vec3d(1,2,3));
+	EXPECT_NE(Quaterniond(1,2,3,4), Quaterniond(1,2,3,5));
+	EXPECT_EQ(sizeof(Quaternionf), 16u);
+	EXPECT_EQ(alignof(Quaternionf), 16u);
+}
+
+TEST(Quaternion, Arithmetic) {
+	Quaterniond a(1,2,3,4), b(5,6,7,8);
+	EXPECT_EQ(a + b, Quaterniond(6,8,10,12));
+	EXPECT_EQ(b - a, Quaterniond(4,4,4,4));
+	EXPECT_EQ(-a, Quaterniond(-1,-2,-3,-4));
+	EXPECT_EQ(a * 2.0, Quaterniond(2,4,6,8));
+	EXPECT_EQ(2.0 * a, Quaterniond(2,4,6,8));
+	EXPECT_EQ(dot(a, b), 70.0);
+	EXPECT_EQ(length(Quaterniond(1,1,1,1)), 2.0);
+	EXPECT_EQ(normalize(Quaterniond(1,1,1,1)), Quaterniond(.5,.5,.5,.5));
+	EXPECT_EQ(conjugate(a), Quaterniond(-1,-2,-3,4));
+}
+
+TEST(Quaternion, Multiply) {
+	/* i*j = k, j*k = i, k*i = j and i*i = -1 */
+	Quaterniond i(1,0,0,0), j(0,1,0,0), k(0,0,1,0);
+	EXPECT_EQ(i * j, k);
+	EXPECT_EQ(j * k, i);
+	EXPECT_EQ(k * i, j);
+	EXPECT_EQ(j * i, -k);
+	EXPECT_EQ(i * i, Quaterniond(0,0,0,-1));
+	EXPECT_EQ(Quaterniond(1,2,3,4) * Quaterniond(5,6,7,8),
+						Quaterniond(24,48,48,-6));
+	
+	Quaterniond a(1,2,3,4);
+	ExpectNear(a * inverse(a), Quaterniond::identity(), 1e-15);
+	
+	/* The product composes rotations like the matrix product */
+	Quaterniond r = Quaterniond::rotate(0.3, Vec3d(1,2,3));
+	Quaterniond s = Quaterniond::rotate(-1.1, Vec3d(0,1,-1));
+	ExpectMatrixNear((r * s).toMatrix4(), r.toMatrix4() * s.toMatrix4(), 1e-15);
+}
+
+TEST(Quaternion, Rotate) {
+	Quaterniond q = Quaterniond::rotate(M_PI / 2, Vec3d(0,0,1));
+	Vec3d v = q * Vec3d(1,0,0);
+	EXPECT_NEAR(v.x, 0, 1e-15);
+	EXPECT_NEAR(v.y, 1, 1e-15);
+	EXPECT_NEAR(v.z, 0, 1e-15);
+	
+	std::mt19937 gen(1);
+	std::uniform_real_distribution<double> dist(-10, 10);
+	for(int i = 0; i < 20; ++i) {
+		const double angle = dist(gen);
+		const Vec3d axis(dist(gen), dist(gen), dist(gen));
+		const Vec3d u(dist(gen), dist(gen), dist(gen));
+		const Matrix3d m = Quaterniond::rotate(angle, axis).toMatrix3();
+		ExpectMatrixNear(Quaterniond::rotate(angle, axis).toMatrix4(),
+										 Matrix4d::rotate(angle, axis), 1e-14);
+		const Vec3d a = Quaterniond::rotate(angle, axis) * u;
+		const Vec3d b = m * u;
+		EXPECT_NEAR(a.x, b.x, 1e-13);
+		EXPECT_NEAR(a.y, b.y, 1e-13);
+		EXPECT_NEAR(a.z, b.z, 1e-13);
+		
+		/* The conjugate undoes the rotation */
+		const Vec3d c = conjugate(Quaterniond::rotate(angle, axis)) * a;
+		EXPECT_NEAR(c.x, u.x, 1e-13);
+		EXPECT_NEAR(c.y, u.y, 1e-13);
+		EXPECT_NEAR(c.z, u.z, 1e-13);
+	}
+}
+
+TEST(Quaternion, FromMatrix) {
+	/* Cover each branch of the conversion, including half turns */
+	std::vector<Quaterniond> q = RandomRotations<double>(40, 2);
+	q.push_back(Quaterniond(1,0,0,0));
+	q.push_back(Quaterniond(0,1,0,0));
+	q.push_back(Quaterniond(0,0,1,0));
+	q.push_back(Quaterniond::identity());
+	for(std::size_t i = 0; i < q.size(); ++i) {
+		const Quaterniond expected = q[i].w < 0 ? -q[i] : q[i];
+		ExpectNear(Quaterniond(q[i].toMatrix3()), expected, 1e-14);
+		ExpectNear(Quaterniond(q[i].toMatrix4()), expected, 1e-14);
+	}
+	
+	const Matrix4f m = Matrix4f::rotate(2.5f, Vec3f(1,-1,2));
+	ExpectMatrixNear(Quaternionf(m).toMatrix4(), m, 1e-6);
+}
+
+TEST(Quaternion, Interpolate) {
+	Quaterniond a = Quaterniond::rotate(0.2, Vec3d(1,0,0));
+	Quaterniond b = Quaterniond::rotate(1.4, Vec3d(1,0,0));
+	Quaterniond mid = Quaterniond::rotate(0.8, Vec3d(1,0,0));
+	ExpectNear(slerp(a, b, 0.0), a, 1e-15);
+	ExpectNear(slerp(a, b, 1.0), b, 1e-15);
+	ExpectNear(slerp(a, b, 0.5), mid, 1e-15);
+	ExpectNear(slerp(a, b, 0.25), Quaterniond::rotate(0.5, Vec3d(1,0,0)),
+						 1e-15);
+	ExpectNear(nlerp(a, b, 0.5), mid, 1e-15);
+	
+	/* Both take the shorter arc when the ends are in opposite hemispheres */
+	ExpectNear(slerp(a, -b, 0.5), mid, 1e-15);
+	ExpectNear(nlerp(a, -b, 0.5), mid, 1e-15);
+	
+	/* Nearly equal rotations */
+	Quaterniond c = Quaterniond::rotate(0.2 + 1e-9, Vec3d(1,0,0));
+	ExpectNear(slerp(a, c, 0.5), a, 1e-9);
+}
+
+TEST(Quaternion, SlerpFast) {
+	std::vector<Quaterniond> a = RandomRotations<double>(200, 3);
+	std::vector<Quaterniond> b = RandomRotations<double>(200, 4);
+	for(std::size_t i = 0; i < a.size(); ++i) {
+		for(int j = 0; j <= 10; ++j) {
+			const double t = j / 10.0;
+			ExpectNear(slerpFast(a[i], b[i], t), slerp(a[i], b[i], t), 4e-5);
+		}
+	}
+	ExpectNear(slerpFast(a[0], a[0], 0.3), a[0], 1e-15);
+	ExpectNear(slerpFast(a[0], -a[0], 0.3), a[0], 1e-15);
+}
+
+TEST(Quaternion, Batch) {
+	std::vector<Quaternionf> af = RandomRotations<float>(37, 5);
+	std::vector<Quaternionf> bf = RandomRotations<float>(37, 6);
+	std::vector<float> tf;
+	for(std::size_t i = 0; i < af.size(); ++i) {
+		tf.push_back(i / 36.0f);
+	}
+	std::vector<Quaternionf> of(af.size());
+	slerpFast(af.data(), bf.data(), 0.3f, af.size(), of.data());
+	for(std::size_t i = 0; i < af.size(); ++i) {
+		EXPECT_EQ(of[i], slerpFast(af[i], bf[i], 0.3f));
+	}
+	slerpFast(af.data(), bf.data(), tf.data(), af.size(), of.data());
+	for(std::size_t i = 0; i < af.size(); ++i) {
+		EXPECT_EQ(of[i], slerpFast(af[i], bf[i], tf[i]));
+	}
+	nlerp(af.data(), bf.data(), tf.data(), af.size(), of.data());
+	for(std::size_t i = 0; i < af.size(); ++i) {
+		EXPECT_EQ(of[i], nlerp(af[i], bf[i], tf[i]));
+	}
+	
+	std::vector<Quaterniond> ad = RandomRotations<double>(37, 7);
+	std::vector<Quaterniond> bd = RandomRotations<double>(37, 8);
+	std::vector<Quaterniond> od(ad.size());
+	slerpFast(ad.data(), bd.data(), 0.6, ad.size(), od.data());
+	for(std::size_t i = 0; i < ad.size(); ++i) {
+		EXPECT_EQ(od[i], slerpFast(ad[i], bd[i], 0.6));
+	}
+	nlerp(ad.data(), bd.data(), 0.6, ad.size(), od.data());
+	for(std::size_t i = 0; i < ad.size(); ++i) {
+		EXPECT_EQ(od[i], nlerp(ad[i], bd[i], 0.6));
+	}
+	
+	/* Blending in place */
+	std::vector<Quaterniond> cd(ad);
+	slerpFast(cd.data(), bd.data(), 0.6, cd.size(), cd.data());
+	for(std::size_t i = 0; i < ad.size(); ++i) {
+		EXPECT_EQ(cd[i], slerpFast(ad[i], bd[i], 0.6));
+	}
+}
@@ -0,0 +1,164 @@
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "geom/Rectangle2.hpp"
+#include "geom/Rectangle2SoA.hpp"
+
+using namespace geom;
+
+namespace {
+	/* Rectangles on a small grid so that edges often coincide */
+	template <typename Scalar>
+	Rectangle2SoA<Scalar> RandomRectangles(std::size_t count, unsigned seed) {
+		std::mt19937 gen(seed);
+		std::uniform_int_distribution<int> position(0, 20), size(0, 8);
+		Rectangle2SoA<Scalar> rects;
+		for(std::size_t i = 0; i < count; ++i) {
+			rects.push_back(Rectangle2<Scalar>(
+				Scalar(position(gen)), Scalar(position(gen)),
+				Scalar(size(gen)), Scalar(size(gen))));
+		}
+		return rects;
+	}
+	
+	bool Bit(const std::vector<std::uint32_t> &mask, std::size_t i) {
+		return (mask[i / 32] >> (i % 32)) & 1;
+	}
+	
+	/* 45 rectangles exercises every pack width as well as the remainder */
+	template <typename Scalar>
+	void CheckBatches() {
+		const std::size_t count = 45;
+		const Rectangle2SoA<Scalar> rects = RandomRectangles<Scalar>(count, 1);
+		const Rectangle2SoA<Scalar> probes = RandomRectangles<Scalar>(16, 2);
+		std::size_t overlapCount = 0, containCount = 0;
+		for(std::size_t j = 0; j < probes.size(); ++j) {
+			const Rectangle2<Scalar> r = probes[j];
+			const Point2<Scalar> p(r.origin.x, r.origin.y);
+			
+			std::vector<std::uint32_t> mask(2, ~0u), pointMask(2, ~0u);
+			std::vector<std::uint32_t> indices(count), pointIndices(count);
+			overlaps(r, rects.span(), mask.data());
+			contains(rects.span(), p, pointMask.data());
+			const std::size_t n = overlapping(r, rects.span(), indices.data());
+			const std::size_t m = containing(rects.span(), p,
+																			 pointIndices.data());
+			EXPECT_EQ(mask[1] >> (count - 32), 0u);
+			EXPECT_EQ(pointMask[1] >> (count - 32), 0u);
+			
+			Rectangle2SoA<Scalar> clipped(count);
+			std::vector<Scalar> areas(count);
+			intersection(r, rects.span(), clipped.span());
+			overlapArea(r, rects.span(), areas.data());
+			
+			std::size_t k = 0, l = 0;
+			for(std::size_t i = 0; i < count; ++i) {
+				const bool overlap = overlaps(r, rects[i]);
+				const bool contain = contains(rects[i], p);
+				EXPECT_EQ(Bit(mask, i), overlap);
+				EXPECT_EQ(Bit(pointMask, i), contain);
+				if(overlap) {
+					ASSERT_LT(k, n);
+					EXPECT_EQ(indices[k++], i);
+				}
+				if(contain) {
+					ASSERT_LT(l, m);
+					EXPECT_EQ(pointIndices[l++], i);
+				}
+				EXPECT_EQ(clipped[i], intersection(r, rects[i]));
+				EXPECT_EQ(areas[i], overlapArea(r, rects[i]));
+			}
+			EXPECT_EQ(k, n);
+			EXPECT_EQ(l, m);
+			overlapCount += n;
+			containCount += m;
+		}
+		/* Both outcomes of each test are exercised */
+		EXPECT_GT(overlapCount, 16u);
+		EXPECT_LT(overlapCount, 16 * count / 2);
+		EXPECT_GT(containCount, 4u);
+		
+		/* The union of all the rectangles */
+		Rectangle2<Scalar> bounds(0, 0, 0, 0);
+		for(std::size_t i = 0; i < count; ++i) {
+			bounds = join(bounds, rects[i]);
+		}
+		EXPECT_EQ(join(rects.span()), bounds);
+		EXPECT_TRUE(empty(join(Rectangle2SoA<Scalar>(count).span())));
+		
+		/* Clipping in place */
+		Rectangle2SoA<Scalar> inPlace(rects);
+		intersection(probes[0], inPlace.span(), inPlace.span());
+		for(std::size_t i = 0; i < count; ++i) {
+			EXPECT_EQ(inPlace[i], intersection(probes[0], rects[i]));
+		}
+	}
+}
+
+TEST(Rectangle2, Operations) {
+	const Rectangle2i a(0, 0, 4, 3);
+	const Rectangle2i b(2, 1, 4, 4);
+	EXPECT_EQ(a, Rectangle2i(Point2i(0, 0), Dimensions2i(4, 3)));
+	EXPECT_NE(a, b);
+	EXPECT_EQ(area(a), 12);
+	EXPECT_EQ(intersection(a, b), Rectangle2i(2, 1, 2, 2));
+	EXPECT_EQ(join(a, b), Rectangle2i(0, 0, 6, 5));
+	EXPECT_TRUE(overlaps(a, b));
+	EXPECT_EQ(overlapArea(a, b), 4);
+	
+	/* Rectangles sharing an edge do not overlap */
+	const Rectangle2i c(4, 0, 2, 3);
+	EXPECT_FALSE(overlaps(a, c));
+	EXPECT_EQ(overlapArea(a, c), 0);
+	EXPECT_TRUE(empty(intersection(a, c)));
+	EXPECT_EQ(intersection(a, Rectangle2i(10, 10, 1, 1)).dim.width, 0);
+	
+	/* Empty rectangles overlap nothing and are ignored by join */
+	const Rectangle2i e(1, 1, 0, 5);
+	EXPECT_TRUE(empty(e));
+	EXPECT_TRUE(empty(Rectangle2i(1, 1, 2, -1)));
+	EXPECT_FALSE(overlaps(a, e));
+	EXPECT_EQ(area(e), 0);
+	EXPECT_EQ(join(a, e), a);
+	EXPECT_EQ(join(e, b), b);
+	
+	EXPECT_TRUE(contains(a, Point2i(0, 0)));
+	EXPECT_TRUE(contains(a, Point2i(3, 2)));
+	EXPECT_FALSE(contains(a, Point2i(4, 2)));
+	EXPECT_FALSE(contains(a, Point2i(3, 3)));
+	EXPECT_TRUE(contains(a, intersection(a, b)));
+	EXPECT_FALSE(contains(a, b));
+	EXPECT_TRUE(contains(a, e));
+	
+	/* Unsigned rectangles which do not overlap clip to a zero size */
+	const Rectangle2u u(5, 5, 2, 2);
+	EXPECT_EQ(intersection(u, Rectangle2u(0, 0, 3, 3)),
+						Rectangle2u(5, 5, 0, 0));
+	EXPECT_EQ(overlapArea(Rectangle2u(0, 0, 6, 6), u), 1u);
+	EXPECT_EQ(area(Rectangle2f(0.5f, 0, 1.5f, 2)), 3.0f);
+}
+
+TEST(Rectangle2SoA, Container) {
+	Rectangle2SoAi r;
+	r.push_back(Rectangle2i(1, 2, 3, 4));
+	r.push_back(Rectangle2i(5, 6, 7, 8));
+	EXPECT_EQ(r.size(), 2u);
+	EXPECT_EQ(r[1], Rectangle2i(5, 6, 7, 8));
+	r.set(0, Rectangle2d(0, 1, 2, 3));
+	EXPECT_EQ(r.width[0], 2);
+	
+	const Rectangle2Span<const int> s = r.span();
+	EXPECT_EQ(s.subspan(1, 1)[0], r[1]);
+	const Rectangle2f aos[] = { Rectangle2f(1, 1, 2, 2) };
+	EXPECT_EQ(Rectangle2SoAd(aos, 1)[0], Rectangle2d(1, 1, 2, 2));
+}
+
+TEST(Rectangle2SoA, Batch) {
+	CheckBatches<float>();
+	CheckBatches<double>();
+	CheckBatches<std::int32_t>();
+	CheckBatches<std::uint32_t>();
+}
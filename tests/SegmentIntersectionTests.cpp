@@ -0,0 +1,216 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "geom/SegmentIntersection.hpp"
+
+using namespace geom;
+
+namespace {
+	typedef std::pair<std::uint32_t, std::uint32_t> Pair;
+	typedef SegmentIntersection<std::int32_t> Intersectioni;
+
+	/* The intersecting pairs found by testing every pair */
+	template <typename Scalar>
+	std::vector<SegmentIntersection<Scalar>> BruteForce(
+		const std::vector<Line2<Scalar>> &segments)
+	{
+		std::vector<SegmentIntersection<Scalar>> out;
+		for(std::uint32_t i = 0; i < segments.size(); ++i) {
+			for(std::uint32_t j = i + 1; j < segments.size(); ++j) {
+				SegmentIntersection<Scalar> r;
+				if(intersect(segments[i], segments[j], r.point)) {
+					r.first = i;
+					r.second = j;
+					out.push_back(r);
+				}
+			}
+		}
+		return out;
+	}
+
+	template <typename Scalar>
+	std::vector<Pair> Pairs(const std::vector<SegmentIntersection<Scalar>> &r) {
+		std::vector<Pair> pairs;
+		for(std::size_t i = 0; i < r.size(); ++i) {
+			pairs.push_back(Pair(r[i].first, r[i].second));
+		}
+		std::sort(pairs.begin(), pairs.end());
+		return pairs;
+	}
+
+	/*
+	 * The sweep finds the same pairs and points as testing every pair, where
+	 * points of proper crossings may differ by rounding.
+	 */
+	template <typename Scalar>
+	void ExpectBruteForce(const std::vector<Line2<Scalar>> &segments,
+												double tolerance)
+	{
+		std::vector<SegmentIntersection<Scalar>> sweep;
+		segmentIntersections(segments.data(), segments.size(), sweep);
+		std::vector<SegmentIntersection<Scalar>> brute = BruteForce(segments);
+		ASSERT_EQ(Pairs(sweep), Pairs(brute));
+
+		const auto less = [](const SegmentIntersection<Scalar> &a,
+												 const SegmentIntersection<Scalar> &b) {
+			return Pair(a.first, a.second) < Pair(b.first, b.second);
+		};
+		std::sort(sweep.begin(), sweep.end(), less);
+		std::sort(brute.begin(), brute.end(), less);
+		for(std::size_t i = 0; i < sweep.size(); ++i) {
+			EXPECT_NEAR(sweep[i].point.x, brute[i].point.x, tolerance);
+			EXPECT_NEAR(sweep[i].point.y, brute[i].point.y, tolerance);
+		}
+	}
+
+	template <typename Scalar>
+	void ExpectPoint(const Point2<Scalar> &p, double x, double y) {
+		EXPECT_EQ(p.x, x);
+		EXPECT_EQ(p.y, y);
+	}
+
+	/* Segments on a small grid have every degeneracy many times over */
+	std::vector<Line2i> GridSegments(std::size_t count, int size,
+																		 unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_int_distribution<int> dist(0, size);
+		std::vector<Line2i> segments;
+		for(std::size_t i = 0; i < count; ++i) {
+			segments.push_back(Line2i(dist(gen), dist(gen), dist(gen), dist(gen)));
+		}
+		return segments;
+	}
+}
+
+TEST(SegmentIntersection, Pair) {
+	Point2d p;
+	EXPECT_TRUE(intersect(Line2i(0, 0, 4, 4), Line2i(0, 4, 4, 0), p));
+	ExpectPoint(p, 2, 2);
+	EXPECT_TRUE(intersect(Line2i(0, 0, 3, 1), Line2i(0, 1, 3, 0), p));
+	ExpectPoint(p, 1.5, 0.5);
+
+	/* Touching at an endpoint */
+	EXPECT_TRUE(intersect(Line2i(0, 0, 4, 0), Line2i(2, 3, 2, 0), p));
+	ExpectPoint(p, 2, 0);
+	EXPECT_TRUE(intersect(Line2i(0, 0, 4, 0), Line2i(4, 0, 5, 5), p));
+	ExpectPoint(p, 4, 0);
+
+	/* Collinear segments meet at the start of their overlap */
+	EXPECT_TRUE(intersect(Line2i(0, 0, 4, 2), Line2i(6, 3, 2, 1), p));
+	ExpectPoint(p, 2, 1);
+	EXPECT_FALSE(intersect(Line2i(0, 0, 4, 2), Line2i(6, 3, 8, 4), p));
+	EXPECT_FALSE(intersect(Line2i(0, 0, 4, 2), Line2i(0, 1, 4, 3), p));
+	EXPECT_FALSE(intersect(Line2i(0, 0, 4, 0), Line2i(2, 1, 2, 3), p));
+
+	/* Zero length segments */
+	EXPECT_TRUE(intersect(Line2i(0, 0, 4, 2), Line2i(2, 1, 2, 1), p));
+	ExpectPoint(p, 2, 1);
+	EXPECT_FALSE(intersect(Line2i(0, 0, 4, 2), Line2i(2, 2, 2, 2), p));
+
+	Point2f q;
+	EXPECT_TRUE(intersect(Line2f(0, 0, 1, 1), Line2f(0, 1, 1, 0), q));
+	ExpectPoint(q, 0.5, 0.5);
+}
+
+TEST(SegmentIntersection, Degenerate) {
+	/* Shared endpoints, overlaps, vertical and zero length segments */
+	ExpectBruteForce(GridSegments(300, 6, 1), 1e-12);
+	ExpectBruteForce(GridSegments(300, 12, 2), 1e-12);
+	ExpectBruteForce(GridSegments(500, 40, 3), 1e-12);
+
+	std::vector<Line2i> empty;
+	std::vector<Intersectioni> out(1);
+	segmentIntersections(empty.data(), 0, out);
+	EXPECT_TRUE(out.empty());
+}
+
+TEST(SegmentIntersection, Floating) {
+	std::mt19937 gen(4);
+	std::uniform_real_distribution<double> dist(-1, 1);
+	std::vector<Line2d> segments;
+	for(std::size_t i = 0; i < 1000; ++i) {
+		const double x = dist(gen), y = dist(gen);
+		segments.push_back(Line2d(x, y, x + 0.2 * dist(gen), y + 0.2 * dist(gen)));
+	}
+	ExpectBruteForce(segments, 1e-12);
+
+	/* Segments through the crossings of others */
+	std::vector<Line2f> f;
+	for(std::size_t i = 0; i < segments.size(); ++i) {
+		f.push_back(Line2f(segments[i]));
+	}
+	std::vector<SegmentIntersection<float>> out;
+	segmentIntersections(f.data(), 300, out);
+	for(std::size_t i = 0; i < out.size() && i < 50; ++i) {
+		const Point2f &p = out[i].point;
+		f.push_back(Line2f(p.x, p.y, p.x + 0.1f, p.y + 0.05f));
+	}
+	ExpectBruteForce(f, 1e-6);
+}
+
+TEST(SegmentIntersection, Adversarial) {
+	/* Every segment through one point */
+	std::vector<Line2i> star;
+	for(int i = -20; i <= 20; ++i) {
+		star.push_back(Line2i(-i, -20, i, 20));
+		if(i != -20 && i != 20) {
+			star.push_back(Line2i(-20, i, 20, -i));
+		}
+	}
+	std::vector<Intersectioni> out;
+	segmentIntersections(star.data(), star.size(), out);
+	EXPECT_EQ(out.size(), star.size() * (star.size() - 1) / 2);
+	for(std::size_t i = 0; i < out.size(); ++i) {
+		ExpectPoint(out[i].point, 0, 0);
+	}
+	ExpectBruteForce(star, 0);
+
+	/* A grid crossing at every vertex */
+	std::vector<Line2i> grid;
+	for(int i = 0; i < 30; ++i) {
+		grid.push_back(Line2i(0, i, 29, i));
+		grid.push_back(Line2i(i, 0, i, 29));
+	}
+	segmentIntersections(grid.data(), grid.size(), out);
+	EXPECT_EQ(out.size(), 30u * 30u);
+	ExpectBruteForce(grid, 0);
+
+	/* Chains of segments sharing endpoints and stacked collinear copies */
+	std::vector<Line2i> chains;
+	for(int i = 0; i < 20; ++i) {
+		chains.push_back(Line2i(i, i % 3, i + 1, (i + 1) % 3));
+		chains.push_back(Line2i(0, 1, 20, 1));
+		chains.push_back(Line2i(i, 1, i + 2, 1));
+	}
+	ExpectBruteForce(chains, 0);
+}
+
+TEST(SegmentIntersection, Wide) {
+	/*
+	 * Coordinates beyond 2^53, where a point one unit above a segment rounds
+	 * onto it in double precision.
+	 */
+	const std::int64_t b = std::int64_t(1) << 61;
+	std::vector<Line2l> segments;
+	segments.push_back(Line2l(0, 0, 2 * b, 2 * b + 2));
+	segments.push_back(Line2l(b, b + 1, b, 2 * b));
+	segments.push_back(Line2l(b, b + 2, b, 2 * b));
+	segments.push_back(Line2l(b, 0, b, b));
+	segments.push_back(Line2l(b - 1, b + 1, b + 1, b + 1));
+	std::vector<SegmentIntersection<std::int64_t>> out;
+	segmentIntersections(segments.data(), segments.size(), out);
+	std::vector<Pair> expected;
+	expected.push_back(Pair(0, 1));
+	expected.push_back(Pair(0, 4));
+	expected.push_back(Pair(1, 2));
+	expected.push_back(Pair(1, 4));
+	EXPECT_EQ(Pairs(out), expected);
+	EXPECT_EQ(Pairs(BruteForce(segments)), expected);
+}
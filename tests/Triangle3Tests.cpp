@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "geom/Triangle3.hpp"
+
+using namespace geom;
+
+namespace {
+	/* A soup of small random triangles and rays from outside aimed at it */
+	template <typename Scalar>
+	std::vector<Triangle3<Scalar>> RandomTriangles(std::size_t count,
+																								 unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> center(-4, 4), offset(-1, 1);
+		std::vector<Triangle3<Scalar>> triangles;
+		for(std::size_t i = 0; i < count; ++i) {
+			const Scalar x = center(gen), y = center(gen), z = center(gen);
+			triangles.push_back(Triangle3<Scalar>(
+				Point3<Scalar>(x + offset(gen), y + offset(gen), z + offset(gen)),
+				Point3<Scalar>(x + offset(gen), y + offset(gen), z + offset(gen)),
+				Point3<Scalar>(x + offset(gen), y + offset(gen), z + offset(gen))));
+		}
+		return triangles;
+	}
+	template <typename Scalar>
+	std::vector<Ray3<Scalar>> RandomRays(std::size_t count, unsigned seed) {
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(-1, 1);
+		std::vector<Ray3<Scalar>> rays;
+		for(std::size_t i = 0; i < count; ++i) {
+			const Point3<Scalar> o(8 * dist(gen), 8 * dist(gen), 8 * dist(gen));
+			rays.push_back(Ray3<Scalar>(
+				o, Vector3<Scalar>(dist(gen) - o.x / 8, dist(gen) - o.y / 8,
+													 dist(gen) - o.z / 8)));
+		}
+		return rays;
+	}
+	
+	template <typename Scalar>
+	void ExpectHit(const TriangleHit<Scalar> &actual,
+								 const TriangleHit<Scalar> &expected)
+	{
+		EXPECT_EQ(actual.index, expected.index);
+		EXPECT_EQ(actual.t, expected.t);
+		EXPECT_EQ(actual.u, expected.u);
+		EXPECT_EQ(actual.v, expected.v);
+	}
+	
+	/*
+	 * The batch kernels find the same nearest hits, bit for bit, as testing
+	 * the triangles one at a time.
+	 */
+	template <typename Scalar>
+	void ExpectBatch() {
+		/* Not a multiple of any pack width, to test the remainders */
+		const std::vector<Triangle3<Scalar>> triangles =
+			RandomTriangles<Scalar>(1013, 1);
+		const Triangle3SoA<Scalar> soa(triangles.data(), triangles.size());
+		const std::vector<Ray3<Scalar>> rays = RandomRays<Scalar>(200, 2);
+		const Scalar tMax = 2;
+		std::size_t hits = 0;
+		for(std::size_t r = 0; r < rays.size(); ++r) {
+			TriangleHit<Scalar> expected = { tMax, 0, 0, triangles.size() };
+			for(std::size_t i = 0; i < triangles.size(); ++i) {
+				TriangleHit<Scalar> h;
+				if(intersect(rays[r], triangles[i], h, tMax) && h.t < expected.t) {
+					expected = h;
+					expected.index = i;
+				}
+			}
+			hits += expected.index != triangles.size();
+			
+			TriangleHit<Scalar> objects, arrays;
+			EXPECT_EQ(intersect(rays[r], triangles.data(), triangles.size(), tMax,
+													objects), expected.index != triangles.size());
+			ExpectHit(objects, expected);
+			EXPECT_EQ(intersect(rays[r], soa, tMax, arrays),
+								expected.index != triangles.size());
+			ExpectHit(arrays, expected);
+		}
+		EXPECT_GT(hits, 20u);
+		EXPECT_LT(hits, 190u);
+	}
+}
+
+TEST(Triangle3, Construction) {
+	const Triangle3i t(Point3i(1, 2, 3), Point3i(4, 5, 6), Point3i(7, 8, 9));
+	EXPECT_EQ(t.b.y, 5);
+	EXPECT_EQ(Triangle3d(t), t);
+	EXPECT_NE(Triangle3d(), t);
+	
+	const Vec3i n = normal(Triangle3i(Point3i(1, 1, 0), Point3i(3, 1, 0),
+																			 Point3i(1, 4, 0)));
+	EXPECT_EQ(n, Vec3i(0, 0, 6));
+	
+	Triangle3SoAf soa;
+	soa.push_back(t);
+	soa.push_back(Triangle3f());
+	ASSERT_EQ(soa.size(), 2u);
+	EXPECT_EQ(soa[0], t);
+	soa.set(1, t);
+	EXPECT_EQ(soa[1], t);
+	soa.clear();
+	EXPECT_EQ(soa.size(), 0u);
+}
+
+TEST(Triangle3, Ray) {
+	const Triangle3d tri(Point3d(0, 0, 2), Point3d(4, 0, 2), Point3d(0, 4, 2));
+	TriangleHit<double> hit;
+	
+	ASSERT_TRUE(intersect(Ray3d(Point3d(1, 2, 0), Vec3d(0, 0, 1)), tri, hit));
+	EXPECT_EQ(hit.t, 2);
+	EXPECT_EQ(hit.u, 0.25);
+	EXPECT_EQ(hit.v, 0.5);
+	EXPECT_EQ(hit.index, 0u);
+	
+	/* From the back side, with a direction which is not normalized */
+	ASSERT_TRUE(intersect(Ray3d(Point3d(2, 1, 6), Vec3d(0, 0, -2)), tri, hit));
+	EXPECT_EQ(hit.t, 2);
+	EXPECT_EQ(hit.u, 0.5);
+	EXPECT_EQ(hit.v, 0.25);
+	
+	/* Beside the triangle, behind the ray, beyond tMax and in its plane */
+	EXPECT_FALSE(intersect(Ray3d(Point3d(3, 3, 0), Vec3d(0, 0, 1)), tri, hit));
+	EXPECT_FALSE(intersect(Ray3d(Point3d(1, 1, 3), Vec3d(0, 0, 1)), tri, hit));
+	EXPECT_FALSE(intersect(Ray3d(Point3d(1, 1, 0), Vec3d(0, 0, 1)), tri, hit,
+												 2.0));
+	EXPECT_TRUE(intersect(Ray3d(Point3d(1, 1, 0), Vec3d(0, 0, 1)), tri, hit,
+												2.5));
+	EXPECT_FALSE(intersect(Ray3d(Point3d(-1, 1, 2), Vec3d(1, 0, 0)), tri,
+												 hit));
+	
+	/* A degenerate triangle */
+	const Triangle3f line(Point3f(0, 0, 2), Point3f(4, 0, 2), Point3f(2, 0, 2));
+	TriangleHit<float> h;
+	EXPECT_FALSE(intersect(Ray3f(Point3f(1, 0, 0), Vec3f(0, 0, 1)), line, h));
+}
+
+TEST(Triangle3, Batch) {
+	ExpectBatch<float>();
+	ExpectBatch<double>();
+	
+	/* The first of equally near triangles wins, here the one at index 20 */
+	std::vector<Triangle3f> triangles(40, Triangle3f(
+		Point3f(10, 10, 10), Point3f(11, 10, 10), Point3f(10, 11, 10)));
+	for(std::size_t i = 20; i < triangles.size(); ++i) {
+		triangles[i] = Triangle3f(Point3f(0, 0, 1), Point3f(2, 0, 1),
+															Point3f(0, 2, 1));
+	}
+	triangles[35].a.z = triangles[35].b.z = triangles[35].c.z = 3;
+	const Ray3f ray(Point3f(0.5f, 0.5f, 0), Vec3f(0, 0, 1));
+	TriangleHit<float> hit;
+	ASSERT_TRUE(intersect(ray, triangles.data(), triangles.size(),
+												std::numeric_limits<float>::infinity(), hit));
+	EXPECT_EQ(hit.index, 20u);
+	EXPECT_EQ(hit.t, 1);
+	const Triangle3SoAf soa(triangles.data(), triangles.size());
+	ASSERT_TRUE(intersect(ray, soa, 5.0f, hit));
+	EXPECT_EQ(hit.index, 20u);
+	
+	/* Nothing to hit */
+	EXPECT_FALSE(intersect(ray, triangles.data(), 20, 5.0f, hit));
+	EXPECT_EQ(hit.index, 20u);
+	EXPECT_EQ(hit.t, 5);
+	EXPECT_FALSE(intersect(ray, triangles.data(), 0, 5.0f, hit));
+	EXPECT_EQ(hit.index, 0u);
+}
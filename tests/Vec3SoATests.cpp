@@ -0,0 +1,213 @@
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "geom/Vector3SoA.hpp"
+#include "geom/Point3SoA.hpp"
+
+using namespace geom;
+
+namespace {
+	/* 37 vectors exercises every pack width as well as the scalar remainder */
+	template <typename Scalar>
+	Vector3SoA<Scalar> RandomVectors(std::size_t count, unsigned seed) {
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<Scalar> dist(-10, 10);
+		Vector3SoA<Scalar> v;
+		for(std::size_t i = 0; i < count; ++i) {
+			v.push_back(Vector3<Scalar>(dist(gen), dist(gen), dist(gen)));
+		}
+		return v;
+	}
+}
+
+TEST(Vector3SoA, Construction) {
+	Vec3SoAf empty;
+	EXPECT_EQ(empty.size(), 0u);
+
+	Vec3SoAf zeros(3);
+	EXPECT_EQ(zeros.size(), 3u);
+	EXPECT_EQ(zeros[2], Vec3f(0,0,0));
+
+	Vec3i aos[] = { Vec3i(1,2,3), Vec3i(4,5,6) };
+	Vec3SoAd v(aos, 2);
+	EXPECT_EQ(v.size(), 2u);
+	EXPECT_EQ(v[0], Vec3d(1,2,3));
+	EXPECT_EQ(v[1], Vec3d(4,5,6));
+	EXPECT_EQ(v.x[1], 4.0);
+	EXPECT_EQ(v.y[1], 5.0);
+	EXPECT_EQ(v.z[1], 6.0);
+}
+
+TEST(Vector3SoA, Modification) {
+	Vec3SoAi v;
+	v.push_back(Vec3i(1,2,3));
+	v.push_back(Vec3i(4,5,6));
+	v.set(0, Vec3i(7,8,9));
+	EXPECT_EQ(v[0], Vec3i(7,8,9));
+	v.resize(3);
+	EXPECT_EQ(v[2], Vec3i(0,0,0));
+	v.clear();
+	EXPECT_EQ(v.size(), 0u);
+}
+
+TEST(Vector3SoA, Span) {
+	Vec3SoAi v;
+	v.push_back(Vec3i(1,2,3));
+	v.push_back(Vec3i(4,5,6));
+	v.push_back(Vec3i(7,8,9));
+
+	Vector3Span<int> s = v.span();
+	EXPECT_EQ(s.count, 3u);
+	EXPECT_EQ(s[1], Vec3i(4,5,6));
+
+	Vector3Span<const int> c = s;
+	EXPECT_EQ(c.subspan(1, 2).count, 2u);
+	EXPECT_EQ(c.subspan(1, 2)[1], Vec3i(7,8,9));
+}
+
+TEST(Vector3SoA, Dot) {
+	Vec3SoAf a = RandomVectors<float>(37, 1);
+	Vec3SoAf b = RandomVectors<float>(37, 2);
+	std::vector<float> out(a.size());
+	dot(a.span(), b.span(), out.data());
+	for(std::size_t i = 0; i < a.size(); ++i) {
+		EXPECT_EQ(out[i], dot(a[i], b[i]));
+	}
+
+	Vec3SoAi ai, bi;
+	ai.push_back(Vec3i(1,1,1));
+	bi.push_back(Vec3i(2,3,4));
+	int r;
+	dot(ai.span(), bi.span(), &r);
+	EXPECT_EQ(r, 9);
+}
+
+TEST(Vector3SoA, Cross) {
+	Vec3SoAd a = RandomVectors<double>(37, 3);
+	Vec3SoAd b = RandomVectors<double>(37, 4);
+	Vec3SoAd out(a.size());
+	cross(a.span(), b.span(), out.span());
+	for(std::size_t i = 0; i < a.size(); ++i) {
+		EXPECT_EQ(out[i], cross(a[i], b[i]));
+	}
+
+	/* The output may alias the input */
+	Vec3SoAd c(a);
+	cross(c.span(), b.span(), c.span());
+	for(std::size_t i = 0; i < a.size(); ++i) {
+		EXPECT_EQ(c[i], cross(a[i], b[i]));
+	}
+}
+
+TEST(Vector3SoA, Length) {
+	Vec3SoAf f = RandomVectors<float>(37, 5);
+	std::vector<float> fout(f.size());
+	length(f.span(), fout.data());
+	for(std::size_t i = 0; i < f.size(); ++i) {
+		EXPECT_EQ(fout[i], length(f[i]));
+	}
+
+	Vec3SoAd d = RandomVectors<double>(37, 6);
+	std::vector<double> dout(d.size());
+	length(d.span(), dout.data());
+	for(std::size_t i = 0; i < d.size(); ++i) {
+		EXPECT_EQ(dout[i], length(d[i]));
+	}
+
+	Vec3SoAi v;
+	v.push_back(Vec3i(1,10,0));
+	double r;
+	length(v.span(), &r);
+	EXPECT_EQ(r, length(Vec3i(1,10,0)));
+}
+
+TEST(Vector3SoA, Normalize) {
+	Vec3SoAf f = RandomVectors<float>(37, 7);
+	Vec3SoAf fout(f.size());
+	normalize(f.span(), fout.span());
+	for(std::size_t i = 0; i < f.size(); ++i) {
+		EXPECT_EQ(fout[i], normalize(f[i]));
+	}
+
+	Vec3SoAd d = RandomVectors<double>(37, 8);
+	Vec3SoAd dout(d.size());
+	normalize(d.span(), dout.span());
+	for(std::size_t i = 0; i < d.size(); ++i) {
+		EXPECT_EQ(dout[i], normalize(d[i]));
+	}
+
+	/* Normalizing in place */
+	Vec3SoAf g(f);
+	normalize(g.span(), g.span());
+	for(std::size_t i = 0; i < f.size(); ++i) {
+		EXPECT_EQ(g[i], normalize(f[i]));
+	}
+}
+
+TEST(Vector3SoA, NormalizeFast) {
+	Vec3SoAf f = RandomVectors<float>(37, 13);
+	Vec3SoAf out(f.size());
+	normalizeFast(f.span(), out.span());
+	for(std::size_t i = 0; i < f.size(); ++i) {
+		const Vec3f exact = normalize(f[i]);
+		EXPECT_NEAR(out.x[i], exact.x, 1e-6f);
+		EXPECT_NEAR(out.y[i], exact.y, 1e-6f);
+		EXPECT_NEAR(out.z[i], exact.z, 1e-6f);
+	}
+
+	/* Normalizing in place */
+	Vec3SoAf g(f);
+	normalizeFast(g.span(), g.span());
+	for(std::size_t i = 0; i < f.size(); ++i) {
+		EXPECT_EQ(g[i], out[i]);
+	}
+}
+
+TEST(Vector3SoA, Reflect) {
+	Vec3SoAf v = RandomVectors<float>(37, 9);
+	Vec3SoAf n = RandomVectors<float>(37, 10);
+	normalize(n.span(), n.span());
+	Vec3SoAf out(v.size());
+	reflect(v.span(), n.span(), out.span());
+	for(std::size_t i = 0; i < v.size(); ++i) {
+		EXPECT_EQ(out[i], reflect(v[i], n[i]));
+	}
+}
+
+TEST(Vector3SoA, Refract) {
+	Vec3SoAf v = RandomVectors<float>(37, 11);
+	Vec3SoAf n = RandomVectors<float>(37, 12);
+	normalize(v.span(), v.span());
+	normalize(n.span(), n.span());
+	Vec3SoAf out(v.size());
+	refract(v.span(), n.span(), 0.66f, out.span());
+	for(std::size_t i = 0; i < v.size(); ++i) {
+		EXPECT_EQ(out[i], refract(v[i], n[i], 0.66f));
+	}
+
+	/* Total internal reflection gives a zero vector */
+	Vec3SoAd i, m;
+	i.push_back(Vec3d(1,0,0));
+	m.push_back(Vec3d(0,1,0));
+	Vec3SoAd r(1);
+	refract(i.span(), m.span(), 1.5, r.span());
+	EXPECT_EQ(r[0], Vec3d(0,0,0));
+}
+
+TEST(Point3SoA, Construction) {
+	Point3i aos[] = { Point3i(1,2,3), Point3i(4,5,6) };
+	Point3SoAf p(aos, 2);
+	EXPECT_EQ(p.size(), 2u);
+	EXPECT_EQ(p.x[1], 4.0f);
+	EXPECT_EQ(p.y[1], 5.0f);
+	EXPECT_EQ(p.z[1], 6.0f);
+
+	p.push_back(Point3f(7,8,9));
+	Point3Span<const float> s = p.span();
+	EXPECT_EQ(s.count, 3u);
+	EXPECT_EQ(s[2].x, 7.0f);
+	EXPECT_EQ(s.subspan(2, 1)[0].z, 9.0f);
+}
@@ -1,6 +1,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <random>
+
 #include "geom/Vector3.hpp"
 
 using namespace geom;
@@ -236,6 +239,29 @@ TEST(Vector3, Normalize) {
 	EXPECT_EQ(normalize(Vec3f(1,1,1)), Vec3f(SQRT3,SQRT3,SQRT3));
 }
 
+TEST(Vector3, NormalizeFast) {
+	/* Random directions over the whole documented range of magnitudes */
+	std::mt19937 gen(42);
+	std::uniform_real_distribution<float> dir(-1, 1);
+	std::uniform_real_distribution<float> scale(-18, 18);
+	float worst = 0;
+	for(int i = 0; i < 100000; ++i) {
+		const float s = std::pow(10.0f, scale(gen));
+		const Vec3f v(dir(gen) * s, dir(gen) * s, dir(gen) * s);
+		if(length(v) < 1e-18f) {
+			continue;
+		}
+		const Vec3f exact = normalize(v), fast = normalizeFast(v);
+		worst = std::max(worst, std::fabs(fast.x - exact.x));
+		worst = std::max(worst, std::fabs(fast.y - exact.y));
+		worst = std::max(worst, std::fabs(fast.z - exact.z));
+	}
+	EXPECT_LE(worst, 1e-6f);
+
+	EXPECT_NEAR(normalizeFast(Vec3f(0,3,0)).y, 1.0f, 1e-6f);
+	EXPECT_NEAR(normalizeFast(Vec3f(1,1,1)).x, SQRT3, 1e-6f);
+}
+
 TEST(Vector3, Refract) {
 	::testing::StaticAssertTypeEq<decltype(refract(Vec3i(),Vec3i(),0.5f)),
 																Vector3<float>>();
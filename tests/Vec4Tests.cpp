@@ -109,3 +109,107 @@ TEST(Vector4, AdditionAssignment) {
   EXPECT_EQ(v1.w, 3);
 }
 
+TEST(Vector4, Alignment) {
+	EXPECT_EQ(alignof(geom::Vec4f), 16u);
+	EXPECT_EQ(alignof(geom::Vec4i), 16u);
+	EXPECT_EQ(alignof(geom::Vec4d), alignof(double));
+}
+
+TEST(Vector4, Negation) {
+	EXPECT_EQ(-geom::Vec4i(1,-2,3,-4), geom::Vec4i(-1,2,-3,4));
+	EXPECT_EQ(-geom::Vec4f(1,-2,3,-4), geom::Vec4f(-1,2,-3,4));
+}
+
+TEST(Vector4, Equality) {
+	EXPECT_TRUE(geom::Vec4i(1,2,3,4) == geom::Vec4i(1,2,3,4));
+	EXPECT_FALSE(geom::Vec4i(1,2,3,4) == geom::Vec4i(1,2,3,5));
+	EXPECT_FALSE(geom::Vec4i(1,2,3,4) == geom::Vec4i(0,2,3,4));
+	EXPECT_TRUE(geom::Vec4i(1,2,3,4) != geom::Vec4i(1,2,0,4));
+	EXPECT_TRUE(geom::Vec4i(1,2,3,4) == geom::Vec4d(1,2,3,4));
+}
+
+TEST(Vector4, Subtraction) {
+	EXPECT_EQ(geom::Vec4i(1,2,3,4) - geom::Vec4i(4,3,2,1),
+						geom::Vec4i(-3,-1,1,3));
+	EXPECT_EQ(geom::Vec4f(1,2,3,4) - geom::Vec4f(0.5,0.5,0.5,0.5),
+						geom::Vec4f(0.5,1.5,2.5,3.5));
+	EXPECT_EQ(geom::Vec4d(1,2,3,4) - geom::Vec4d(4,3,2,1),
+						geom::Vec4d(-3,-1,1,3));
+	
+	geom::Vec4f v(1,2,3,4);
+	v -= geom::Vec4f(1,1,1,1);
+	EXPECT_EQ(v, geom::Vec4f(0,1,2,3));
+}
+
+TEST(Vector4, Multiplication) {
+	EXPECT_EQ(geom::Vec4i(1,2,3,4) * geom::Vec4i(2,3,4,5),
+						geom::Vec4i(2,6,12,20));
+	EXPECT_EQ(geom::Vec4f(1,2,3,4) * geom::Vec4f(2,3,4,5),
+						geom::Vec4f(2,6,12,20));
+	EXPECT_EQ(geom::Vec4d(1,2,3,4) * geom::Vec4d(2,3,4,5),
+						geom::Vec4d(2,6,12,20));
+	EXPECT_EQ(geom::Vec4f(1,2,3,4) * 2.0f, geom::Vec4f(2,4,6,8));
+	EXPECT_EQ(0.5 * geom::Vec4d(2,4,6,8), geom::Vec4d(1,2,3,4));
+	EXPECT_EQ(geom::Vec4i(1,2,3,4) * 3, geom::Vec4i(3,6,9,12));
+	
+	geom::Vec4d v(1,2,3,4);
+	v *= 2.0;
+	EXPECT_EQ(v, geom::Vec4d(2,4,6,8));
+	
+	::testing::StaticAssertTypeEq<decltype(geom::Vec4i()*geom::Vec4f()),
+																geom::Vector4<float>>();
+	::testing::StaticAssertTypeEq<decltype(geom::Vec4f()*2.0),
+																geom::Vector4<double>>();
+	::testing::StaticAssertTypeEq<decltype(geom::Vec4f()*2),
+																geom::Vector4<float>>();
+}
+
+TEST(Vector4, Division) {
+	EXPECT_EQ(geom::Vec4i(2,6,12,20) / geom::Vec4i(2,3,4,5),
+						geom::Vec4i(1,2,3,4));
+	EXPECT_EQ(geom::Vec4f(2,6,12,20) / geom::Vec4f(2,3,4,5),
+						geom::Vec4f(1,2,3,4));
+	EXPECT_EQ(geom::Vec4d(2,4,6,8) / 2.0, geom::Vec4d(1,2,3,4));
+	EXPECT_EQ(geom::Vec4f(2,4,6,8) / 2.0f, geom::Vec4f(1,2,3,4));
+	
+	geom::Vec4f v(2,4,6,8);
+	v /= 2.0f;
+	EXPECT_EQ(v, geom::Vec4f(1,2,3,4));
+}
+
+TEST(Vector4, Dot) {
+	EXPECT_EQ(geom::dot(geom::Vec4i(1,2,3,4), geom::Vec4i(1,1,1,1)), 10);
+	EXPECT_EQ(geom::dot(geom::Vec4f(1,2,3,4), geom::Vec4f(2,2,2,2)), 20.0f);
+	EXPECT_EQ(geom::dot(geom::Vec4d(1,2,3,4), geom::Vec4d(-1,0,1,0)), 2.0);
+	::testing::StaticAssertTypeEq<decltype(geom::dot(geom::Vec4f(),
+																									 geom::Vec4f())), float>();
+}
+
+TEST(Vector4, Length) {
+	EXPECT_EQ(geom::length(geom::Vec4i(1,1,1,1)), 2.0);
+	EXPECT_EQ(geom::length(geom::Vec4f(2,2,2,2)), 4.0f);
+	EXPECT_EQ(geom::length(geom::Vec4d(0,3,0,4)), 5.0);
+	::testing::StaticAssertTypeEq<decltype(geom::length(geom::Vec4i())),
+																double>();
+	::testing::StaticAssertTypeEq<decltype(geom::length(geom::Vec4f())),
+																float>();
+}
+
+TEST(Vector4, Normalize) {
+	EXPECT_EQ(geom::normalize(geom::Vec4f(0,0,2,0)), geom::Vec4f(0,0,1,0));
+	EXPECT_EQ(geom::normalize(geom::Vec4i(1,1,1,1)),
+						geom::Vec4d(0.5,0.5,0.5,0.5));
+	EXPECT_FLOAT_EQ(geom::length(geom::normalize(geom::Vec4f(1,2,3,4))), 1.0f);
+	EXPECT_DOUBLE_EQ(geom::length(geom::normalize(geom::Vec4d(1,2,3,4))), 1.0);
+}
+
+TEST(Vector4, MinMax) {
+	EXPECT_EQ(geom::min(geom::Vec4i(1,5,3,7), geom::Vec4i(4,2,6,0)),
+						geom::Vec4i(1,2,3,0));
+	EXPECT_EQ(geom::max(geom::Vec4i(1,5,3,7), geom::Vec4i(4,2,6,0)),
+						geom::Vec4i(4,5,6,7));
+	EXPECT_EQ(geom::min(geom::Vec4f(1,5,3,7), geom::Vec4f(4,2,6,0)),
+						geom::Vec4f(1,2,3,0));
+	EXPECT_EQ(geom::max(geom::Vec4d(1,5,3,7), geom::Vec4d(4,2,6,0)),
+						geom::Vec4d(4,5,6,7));
+}
@@ -0,0 +1,101 @@
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "geom/VectorExpr.hpp"
+
+using namespace geom;
+
+TEST(VectorExpr, Eval) {
+	Vec3f a(1,2,3), b(4,5,6);
+	EXPECT_EQ(expr::eval(expr::lazy(a) + expr::lazy(b)), a + b);
+	EXPECT_EQ(expr::eval(expr::lazy(a) * 2.0f - expr::lazy(b) / 4.0f),
+						a * 2.0f - b / 4.0f);
+	EXPECT_EQ(expr::eval(-expr::lazy(a) * expr::lazy(b)), Vec3f(-4,-10,-18));
+	
+	Vec2d c(1,2), d(3,4);
+	EXPECT_EQ(expr::eval(0.5 * expr::lazy(c) + expr::lazy(d)), 0.5 * c + d);
+}
+
+TEST(VectorExpr, TypePromotion) {
+	::testing::StaticAssertTypeEq<
+		decltype(expr::eval(expr::lazy(Vec3i()) + expr::lazy(Vec3f()))),
+		Vector3<float>>();
+	::testing::StaticAssertTypeEq<
+		decltype(expr::eval(expr::lazy(Vec3f()) * 2.0)),
+		Vector3<double>>();
+	::testing::StaticAssertTypeEq<
+		decltype(expr::eval(expr::lazy(Vec2i()) * 2)),
+		Vector2<int>>();
+	
+	/* Integer division is performed before the promotion to float */
+	EXPECT_EQ(expr::eval(expr::lazy(Vec3i(3,5,7)) / 2 + expr::lazy(Vec3f())),
+						Vec3i(3,5,7) / 2 + Vec3f());
+}
+
+TEST(VectorExpr, Arrays) {
+	std::vector<Vec3f> p, v, a;
+	for(int i = 0; i < 19; ++i) {
+		p.push_back(Vec3f(i, i * 0.5f, -i));
+		v.push_back(Vec3f(1.0f / (i + 1), 2, 3));
+		a.push_back(Vec3f(0, -9.81f, i * 0.1f));
+	}
+	const float dt = 0.016f;
+	
+	std::vector<Vec3f> expected;
+	for(std::size_t i = 0; i < p.size(); ++i) {
+		expected.push_back(p[i] + v[i] * dt + a[i] * (0.5f * dt * dt));
+	}
+	
+	std::vector<Vec3f> out;
+	expr::assign(out, expr::lazy(p) + expr::lazy(v) * dt +
+							 expr::lazy(a) * (0.5f * dt * dt));
+	ASSERT_EQ(out.size(), p.size());
+	for(std::size_t i = 0; i < p.size(); ++i) {
+		EXPECT_EQ(out[i], expected[i]);
+	}
+	
+	/* Assigning in place over an operand */
+	expr::assign(p, expr::lazy(p) + expr::lazy(v) * dt +
+							 expr::lazy(a) * (0.5f * dt * dt));
+	for(std::size_t i = 0; i < p.size(); ++i) {
+		EXPECT_EQ(p[i], expected[i]);
+	}
+}
+
+TEST(VectorExpr, Broadcast) {
+	std::vector<Vec2i> v;
+	v.push_back(Vec2i(1,2));
+	v.push_back(Vec2i(3,4));
+	Vec2i out[2];
+	expr::assign(out, expr::lazy(v) - expr::lazy(Vec2i(1,1)));
+	EXPECT_EQ(out[0], Vec2i(0,1));
+	EXPECT_EQ(out[1], Vec2i(2,3));
+	
+	expr::assign(out, expr::lazy(v.data(), 1) * 3);
+	EXPECT_EQ(out[0], Vec2i(3,6));
+	EXPECT_EQ(out[1], Vec2i(2,3));
+}
+
+TEST(VectorExpr, Components) {
+	Vec3SoAd p, v;
+	std::vector<Vec3d> aos;
+	for(int i = 0; i < 7; ++i) {
+		p.push_back(Vec3d(i, 2 * i, 3 * i));
+		v.push_back(Vec3d(1, 0.5, 0.25));
+		aos.push_back(Vec3d(-1, -1, -1));
+	}
+	
+	Vec3SoAd out;
+	expr::assign(out, expr::lazy(p) + expr::lazy(v) * 2.0 + expr::lazy(aos));
+	ASSERT_EQ(out.size(), 7u);
+	for(std::size_t i = 0; i < out.size(); ++i) {
+		EXPECT_EQ(out[i], p[i] + v[i] * 2.0 + aos[i]);
+	}
+	
+	expr::assign(p.span(), expr::lazy(p.span()) - expr::lazy(v));
+	for(std::size_t i = 0; i < p.size(); ++i) {
+		EXPECT_EQ(p[i], Vec3d(i, 2 * i, 3 * i) - v[i]);
+	}
+}
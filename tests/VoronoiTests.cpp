@@ -0,0 +1,235 @@
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "geom/Voronoi.hpp"
+
+using namespace geom;
+
+namespace {
+	template <typename Scalar>
+	std::vector<Point2<Scalar>> Square(std::size_t count, double lo, double hi,
+																		 unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<double> dist(lo, hi);
+		std::vector<Point2<Scalar>> points;
+		for(std::size_t i = 0; i < count; ++i) {
+			const double x = dist(gen);
+			points.push_back(Point2<Scalar>(Scalar(x), Scalar(dist(gen))));
+		}
+		return points;
+	}
+	
+	template <typename Scalar>
+	double Cross(const Point2<Scalar> &a, const Point2<Scalar> &b,
+							 const Point2<Scalar> &c)
+	{
+		return (double(b.x) - a.x) * (double(c.y) - a.y) -
+			(double(b.y) - a.y) * (double(c.x) - a.x);
+	}
+	
+	/*
+	 * The cells are convex and counterclockwise within the rectangle, their
+	 * areas sum to its area, and random points of the rectangle lie in the
+	 * cell of a nearest site.
+	 */
+	template <typename Scalar>
+	void ExpectVoronoi(const std::vector<Point2<Scalar>> &sites,
+										 const Rectangle2<Scalar> &bounds, double tolerance)
+	{
+		Voronoi2<Scalar> v;
+		voronoi(sites.data(), sites.size(), bounds, v);
+		ASSERT_EQ(v.offsets.size(), sites.size() + 1);
+		EXPECT_EQ(v.offsets[0], 0u);
+		EXPECT_EQ(v.offsets.back(), v.vertices.size());
+		const double x0 = bounds.origin.x, x1 = x0 + bounds.dim.width;
+		const double y0 = bounds.origin.y, y1 = y0 + bounds.dim.height;
+		double area = 0;
+		for(std::size_t i = 0; i < sites.size(); ++i) {
+			const std::size_t first = v.offsets[i], n = v.offsets[i + 1] - first;
+			ASSERT_TRUE(n == 0 || n >= 3);
+			for(std::size_t k = 0; k < n; ++k) {
+				const Point2<Scalar> &p = v.vertices[first + k];
+				const Point2<Scalar> &q = v.vertices[first + (k + 1) % n];
+				EXPECT_GE(Cross(p, q, v.vertices[first + (k + 2) % n]), -tolerance);
+				EXPECT_GE(p.x, x0 - tolerance);
+				EXPECT_LE(p.x, x1 + tolerance);
+				EXPECT_GE(p.y, y0 - tolerance);
+				EXPECT_LE(p.y, y1 + tolerance);
+				area += (double(p.x) * q.y - double(q.x) * p.y) / 2;
+			}
+		}
+		EXPECT_NEAR(area, (x1 - x0) * (y1 - y0), tolerance);
+		
+		std::mt19937 gen(9);
+		std::uniform_real_distribution<double> ux(x0, x1), uy(y0, y1);
+		for(int k = 0; k < 200; ++k) {
+			const Point2<Scalar> q(Scalar(ux(gen)), Scalar(uy(gen)));
+			double best = INFINITY;
+			for(std::size_t i = 0; i < sites.size(); ++i) {
+				const double dx = double(sites[i].x) - q.x;
+				const double dy = double(sites[i].y) - q.y;
+				best = std::min(best, dx * dx + dy * dy);
+			}
+			bool found = false;
+			for(std::size_t i = 0; i < sites.size() && !found; ++i) {
+				const double dx = double(sites[i].x) - q.x;
+				const double dy = double(sites[i].y) - q.y;
+				const std::size_t first = v.offsets[i];
+				const std::size_t n = v.offsets[i + 1] - first;
+				if(dx * dx + dy * dy > best || n == 0) {
+					continue;
+				}
+				found = true;
+				for(std::size_t j = 0; j < n; ++j) {
+					found = found && Cross(v.vertices[first + j],
+																 v.vertices[first + (j + 1) % n], q) >=
+						-tolerance;
+				}
+			}
+			EXPECT_TRUE(found);
+		}
+	}
+}
+
+TEST(Voronoi, Small) {
+	/* A square with its center, whose cell is a diamond */
+	std::vector<Point2d> sites;
+	sites.push_back(Point2d(0, 0));
+	sites.push_back(Point2d(2, 0));
+	sites.push_back(Point2d(2, 2));
+	sites.push_back(Point2d(0, 2));
+	sites.push_back(Point2d(1, 1));
+	const Rectangle2d bounds(-1, -1, 4, 4);
+	Voronoi2<double> v;
+	voronoi(sites.data(), sites.size(), bounds, v);
+	ASSERT_EQ(v.offsets.size(), 6u);
+	ASSERT_EQ(v.offsets[5] - v.offsets[4], 4u);
+	for(std::uint32_t i = v.offsets[4]; i < v.offsets[5]; ++i) {
+		const Point2d &p = v.vertices[i];
+		EXPECT_NEAR(std::fabs(p.x - 1) + std::fabs(p.y - 1), 1, 1e-12);
+	}
+	ExpectVoronoi(sites, bounds, 1e-9);
+	
+	/* A single site has the whole rectangle, and an empty one gives nothing */
+	sites.resize(1);
+	voronoi(sites.data(), sites.size(), bounds, v);
+	ASSERT_EQ(v.offsets.size(), 2u);
+	EXPECT_EQ(v.offsets[1], 4u);
+	ExpectVoronoi(sites, bounds, 1e-9);
+	voronoi(sites.data(), sites.size(), Rectangle2d(0, 0, 0, 1), v);
+	EXPECT_EQ(v.offsets[1], 0u);
+}
+
+TEST(Voronoi, Degenerate) {
+	/* Collinear and repeated sites are slabs, one for each distinct site */
+	std::vector<Point2f> sites;
+	for(int i = 0; i < 20; ++i) {
+		sites.push_back(Point2f(float(i % 7), float(i % 7)));
+	}
+	const Rectangle2f bounds(-10, -10, 30, 30);
+	ExpectVoronoi(sites, bounds, 1e-3);
+	Voronoi2<float> v;
+	voronoi(sites.data(), sites.size(), bounds, v);
+	for(std::size_t i = 0; i < sites.size(); ++i) {
+		EXPECT_EQ(v.offsets[i + 1] > v.offsets[i], i < 7);
+	}
+	
+	/* A grid, with four triangles to each circumcenter, and repeats */
+	std::vector<Point2d> grid;
+	for(int k = 0; k < 2; ++k) {
+		for(int x = 0; x < 10; ++x) {
+			for(int y = 0; y < 10; ++y) {
+				grid.push_back(Point2d(x, y));
+			}
+		}
+	}
+	ExpectVoronoi(grid, Rectangle2d(-0.5, -0.5, 10, 10), 1e-9);
+	ExpectVoronoi(grid, Rectangle2d(2, 3, 4.5, 1), 1e-9);
+}
+
+TEST(Voronoi, NearlyCollinear) {
+	/*
+	 * Sites just off a line, whose triangles are slivers with circumcenters
+	 * far outside the rectangle.
+	 */
+	std::vector<Point2d> sites;
+	for(int i = 0; i < 6; ++i) {
+		const double x = 1.73 * i;
+		sites.push_back(Point2d(x, 0.3 * x + 0.1));
+	}
+	ExpectVoronoi(sites, Rectangle2d(-5, -5, 20, 20), 1e-9);
+	
+	for(unsigned seed = 0; seed < 20; ++seed) {
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<double> dist(-1, 1);
+		const double slope = dist(gen);
+		sites.clear();
+		for(int i = 0; i < 8; ++i) {
+			const double x = 4 * dist(gen);
+			sites.push_back(Point2d(x, slope * x + 1e-9 * dist(gen)));
+		}
+		ExpectVoronoi(sites, Rectangle2d(-10, -10, 20, 20), 1e-9);
+	}
+}
+
+TEST(Voronoi, Random) {
+	ExpectVoronoi(Square<double>(2000, 0, 1, 1), Rectangle2d(0, 0, 1, 1),
+								1e-9);
+	ExpectVoronoi(Square<float>(2000, 0, 100, 2), Rectangle2f(0, 0, 100, 100),
+								1e-1);
+	
+	/* Sites around a smaller rectangle, some of whose cells miss it */
+	ExpectVoronoi(Square<double>(1000, -1, 2, 3),
+								Rectangle2d(0.25, 0, 0.5, 1), 1e-9);
+	
+	/* Sites on a circle, whose cells all reach the rectangle sides */
+	std::vector<Point2d> circle;
+	for(int i = 0; i < 100; ++i) {
+		circle.push_back(Point2d(std::cos(i * 0.0628), std::sin(i * 0.0628)));
+	}
+	ExpectVoronoi(circle, Rectangle2d(-2, -2, 4, 4), 1e-9);
+}
+
+TEST(Voronoi, Triangulation) {
+	/*
+	 * Cells of sites inside the hull share the circumcenters of the
+	 * triangles on both sides of their common edge.
+	 */
+	const std::vector<Point2d> sites = Square<double>(500, 0, 1, 4);
+	Triangulation2 t;
+	ASSERT_TRUE(delaunay(sites.data(), sites.size(), t));
+	Voronoi2<double> v;
+	voronoi(sites.data(), sites.size(), t, Rectangle2d(-100, -100, 200, 200),
+					v);
+	std::vector<bool> hull(sites.size(), false);
+	for(std::size_t i = 0; i < t.hull.size(); ++i) {
+		hull[t.hull[i]] = true;
+	}
+	std::size_t edges = 0;
+	for(std::size_t e = 0; e < t.triangles.size(); ++e) {
+		const std::uint32_t o = t.halfedges[e];
+		if(o == Triangulation2::None) {
+			continue;
+		}
+		const std::uint32_t a = t.triangles[e], b = t.triangles[o];
+		if(hull[a] || hull[b]) {
+			continue;
+		}
+		std::size_t shared = 0;
+		for(std::uint32_t i = v.offsets[a]; i < v.offsets[a + 1]; ++i) {
+			for(std::uint32_t j = v.offsets[b]; j < v.offsets[b + 1]; ++j) {
+				shared += v.vertices[i].x == v.vertices[j].x &&
+					v.vertices[i].y == v.vertices[j].y;
+			}
+		}
+		EXPECT_EQ(shared, 2u);
+		++edges;
+	}
+	EXPECT_GT(edges, 2000u);
+}